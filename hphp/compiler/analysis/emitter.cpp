@@ -405,7 +405,7 @@ void emitAllHHBC(AnalysisResultPtr&& ar) {
         if (!commitTime) {
           commitTime.emplace(Timer::WallTime, "committing units to repo");
         }
-        if (repoBuilder) repoBuilder->add(*encoded);
+        if (repoBuilder) repoBuilder->add(std::move(*encoded));
         if (Option::GenerateTextHHBC || Option::GenerateHhasHHBC) {
           if (auto ue = ueq.popUnitEmitter()) {
             ues_to_print.emplace_back(std::move(ue));
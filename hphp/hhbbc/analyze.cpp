@@ -324,8 +324,16 @@ FuncAnalysis do_analyze_collect(const Index& index,
    */
   auto totalVisits = std::vector<uint32_t>(ctx.func.blocks().size());
 
-  // For debugging, count how many times basic blocks get interpreted.
+  // For debugging, count how many times basic blocks get interpreted,
+  // and how many of those were re-interpretations. Note that a
+  // memoization cache keyed on the incoming state would never fire
+  // here: a block is only re-queued when a merge actually changed its
+  // stateIn (and likewise the class- and program-level worklists only
+  // reschedule on changed dependencies), so every visit past the first
+  // runs with a strictly refined input. These counters exist so that
+  // claim stays checkable against real code.
   auto interp_counter = uint32_t{0};
+  auto revisit_counter = uint32_t{0};
 
   hphp_fast_map<BlockId, BlockUpdateInfo> blockUpdates;
 
@@ -347,6 +355,7 @@ FuncAnalysis do_analyze_collect(const Index& index,
              state_string(*ctx.func, ai.bdata[bid].stateIn, collect),
              property_state_string(collect.props));
       ++interp_counter;
+      if (totalVisits[bid] > 1) ++revisit_counter;
 
       auto propagate = [&] (BlockId target, const State* st) {
         if (!st) {
@@ -436,10 +445,11 @@ FuncAnalysis do_analyze_collect(const Index& index,
     auto const bsep = std::string(60, '=') + "\n";
     auto const sep = std::string(60, '-') + "\n";
     auto ret = folly::format(
-      "{}function {} ({} block interps):\n{}",
+      "{}function {} ({} block interps, {} revisits):\n{}",
       bsep,
       show(ctx),
       interp_counter,
+      revisit_counter,
       bsep
     ).str();
     for (auto& bd : ai.bdata) {
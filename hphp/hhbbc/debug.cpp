@@ -15,6 +15,7 @@
 */
 #include "hphp/hhbbc/debug.h"
 
+#include <set>
 #include <string>
 #include <utility>
 #include <cstdlib>
@@ -222,6 +223,37 @@ void dump_index(const std::string& dir,
   );
 }
 
+void dump_unit_dependencies(const Index& index) {
+  auto const dir = debug_dump_to();
+  if (dir.empty()) return;
+
+  trace_time tracer("debug dump: unit dependencies");
+
+  // Collect the edges into an ordered set keyed on filenames, so the
+  // output is deduplicated and stable across runs.
+  std::set<std::pair<std::string,std::string>> edges;
+  index.for_each_unit_dependency(
+    [&] (const php::Unit* dependent, const php::Unit* source) {
+      // The native systemlibs: for now just skip.
+      if (!*dependent->filename->data() || !*source->filename->data()) return;
+      edges.emplace(dependent->filename->toCppString(),
+                    source->filename->toCppString());
+    }
+  );
+
+  auto const file = fs::path{dir} / "unit-deps";
+  fs::ofstream out(file);
+  if (!out.is_open()) {
+    throw std::runtime_error(std::string("failed to open file ") +
+      file.string());
+  }
+  for (auto const& edge : edges) {
+    out << edge.first << " -> " << edge.second << '\n';
+  }
+
+  Trace::ftraceRelease("dumped {} unit dependency edges\n", edges.size());
+}
+
 void debug_dump_program(const Index& index, const php::Program& program) {
   auto const dir = debug_dump_to();
   if (dir.empty()) return;
@@ -35,6 +35,15 @@ std::string debug_dump_to();
 void dump_representation(const std::string& dir, const php::Unit*);
 void dump_index(const std::string&, const Index&, const php::Unit*);
 
+/*
+ * If the hhbbc_dump trace module is on, dump the unit-level dependency
+ * graph observed during analysis to `unit-deps' in the dump directory,
+ * one `dependent -> source' edge per line.  Incremental rebuild tooling
+ * can consume this to compute the transitive closure of units affected
+ * by a change.
+ */
+void dump_unit_dependencies(const Index&);
+
 /*
  * Utilities for printing the state of the program after various
  * transformations.
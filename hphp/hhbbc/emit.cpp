@@ -1179,11 +1179,56 @@ void emit_init_func(FuncEmitter& fe, const php::Func& func) {
   );
 }
 
+/*
+ * Whether a memoize wrapper's values may be shared across requests
+ * (AttrPersistentMemoize). The wrapper must be a static, non-LSB,
+ * non-interceptable wrapper of a non-async, non-generator implementation, and
+ * the implementation must compute its value from its arguments alone: it must
+ * be effect-free, and since effect-freedom doesn't rule out *reading*
+ * request-local state, its (post-optimization) bytecode must not touch
+ * globals or static properties or make any calls. Memoize keys are limited to
+ * ints and strings, so the arguments themselves can't smuggle in
+ * request-local data.
+ */
+bool is_persistent_memoize_wrapper(const EmitUnitState& state,
+                                   const php::Func& f) {
+  if (!f.isMemoizeWrapper || f.isMemoizeWrapperLSB || f.cls) return false;
+  if (f.attrs & AttrInterceptable) return false;
+  auto const implName = memoize_impl_name(&f);
+  for (auto const& other : state.unit->funcs) {
+    if (other->name != implName) continue;
+    auto const& impl = *other;
+    if (impl.isAsync || impl.isGenerator) return false;
+    if (!state.index.is_effect_free(&impl)) return false;
+    auto const wf = php::WideFunc::cns(&impl);
+    for (auto const bid : wf.blockRange()) {
+      for (auto const& bc : wf.blocks()[bid]->hhbcs) {
+        if (isFCall(bc.op)) return false;
+        switch (bc.op) {
+          case Op::CGetG:   case Op::IssetG:  case Op::SetG:
+          case Op::BaseGC:  case Op::BaseGL:
+          case Op::CGetS:   case Op::SetS:    case Op::SetOpS:
+          case Op::IncDecS: case Op::IssetS:  case Op::BaseSC:
+          case Op::NativeImpl:
+            return false;
+          default:
+            break;
+        }
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
 void emit_func(EmitUnitState& state, UnitEmitter& ue,
                FuncEmitter& fe, php::Func& f) {
   FTRACE(2,  "    func {}\n", f.name->data());
   assertx(f.attrs & AttrUnique);
   assertx(f.attrs & AttrPersistent);
+  if (is_persistent_memoize_wrapper(state, f)) {
+    f.attrs |= AttrPersistentMemoize;
+  }
   renumber_locals(f);
   emit_init_func(fe, f);
   auto func = php::WideFunc::mut(&f);
@@ -192,11 +192,19 @@ bool has_dep(Dep m, Dep t) {
 /*
  * Maps functions to contexts that depend on information about that
  * function, with information about the type of dependency.
+ *
+ * The dependents of an entity used to be stored in a std::map keyed on
+ * DependencyContext; on large programs the per-node allocation overhead
+ * of those maps dominated the Index's peak memory.  Store them as a
+ * vector kept sorted on DependencyContext instead -- insertions are
+ * rarer than lookups and sets are typically small, and the flat storage
+ * is a fraction of the size.
  */
+using DepSet = CompactVector<std::pair<DependencyContext,Dep>>;
 using DepMap =
   tbb::concurrent_hash_map<
     DependencyContext,
-    std::map<DependencyContext,Dep,DependencyContextLess>,
+    DepSet,
     DependencyContextHashCompare
   >;
 
@@ -1318,8 +1326,18 @@ void add_dependency(IndexData& data,
   auto d = dep_context(data, dst);
   DepMap::accessor acc;
   data.dependencyMap.insert(acc, make_dep(src));
-  auto& current = acc->second[d];
-  current = current | newMask;
+  auto& deps = acc->second;
+  auto const it = std::lower_bound(
+    deps.begin(), deps.end(), d,
+    [] (const std::pair<DependencyContext,Dep>& a, const DependencyContext& b) {
+      return DependencyContextLess{}(a.first, b);
+    }
+  );
+  if (it != deps.end() && DependencyContextEquals{}(it->first, d)) {
+    it->second = it->second | newMask;
+  } else {
+    deps.insert(it, std::make_pair(d, newMask));
+  }
 }
 
 std::mutex func_info_mutex;
@@ -6840,6 +6858,49 @@ DependencyContext Index::dependency_context(const Context& ctx) const {
   return dep_context(*m_data, ctx);
 }
 
+namespace {
+
+const php::Unit* unit_for_dep(const DependencyContext& dep) {
+  switch (dep.tag()) {
+    case DependencyContextType::Func:
+      return static_cast<const php::Func*>(dep.ptr())->unit;
+    case DependencyContextType::Class:
+      return static_cast<const php::Class*>(dep.ptr())->unit;
+    case DependencyContextType::Prop:
+    case DependencyContextType::FuncFamily:
+      // Public static properties and func families aren't owned by a
+      // single unit.
+      return nullptr;
+  }
+  not_reached();
+}
+
+}
+
+void Index::for_each_unit_dependency(
+    const std::function<void(const php::Unit*, const php::Unit*)>& f) const {
+  for (auto const& kv : m_data->dependencyMap) {
+    auto const emitEdges = [&] (const php::Unit* source) {
+      if (!source) return;
+      for (auto const& dep : kv.second) {
+        // Dependent contexts are always funcs or classes, so they
+        // always have a unit.
+        auto const dependent = unit_for_dep(dep.first);
+        assertx(dependent);
+        if (dependent != source) f(dependent, source);
+      }
+    };
+    if (kv.first.tag() == DependencyContextType::FuncFamily) {
+      auto const ff = static_cast<const FuncFamily*>(kv.first.ptr());
+      for (auto const mte : ff->possibleFuncs()) {
+        emitEdges(mte->second.func->unit);
+      }
+    } else {
+      emitEdges(unit_for_dep(kv.first));
+    }
+  }
+}
+
 void Index::use_class_dependencies(bool f) {
   if (f != m_data->useClassDependencies) {
     m_data->dependencyMap.clear();
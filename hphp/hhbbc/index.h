@@ -975,6 +975,25 @@ struct Index {
    */
   DependencyContext dependency_context(const Context& ctx) const;
 
+  /*
+   * Walk the dependency map and invoke `f' once for every cross-unit
+   * dependency edge, passing the unit of the dependent context and the
+   * unit of the context it depends on.  Func family sources are
+   * expanded to their member methods' units.  Public static property
+   * sources carry no unit and are skipped, so consumers must treat
+   * units touching public statics conservatively.
+   *
+   * This is the unit-level projection of the dependency information
+   * used for work scheduling during analysis; it is what an
+   * incremental rebuild needs in order to compute the transitive
+   * closure of units to re-analyze when some units change.
+   *
+   * Must be called in single-threaded context, after analysis and
+   * before cleanup_for_final() clears the dependency map.
+   */
+  void for_each_unit_dependency(
+    const std::function<void(const php::Unit*, const php::Unit*)>& f) const;
+
   /*
    * Determine whether to use class-at-a-time, or function-at-a-time
    * dependencies.
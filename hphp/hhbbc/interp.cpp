@@ -2673,7 +2673,28 @@ void isTypeCImpl(ISS& env, const Op& op) {
   }
 }
 
-void in(ISS& env, const bc::IsTypeC& op) { isTypeCImpl(env, op); }
+void in(ISS& env, const bc::IsTypeC& op) {
+  // Fuse a load of a local directly followed by the type test into
+  // IsTypeL: one dispatch instead of two, a smaller encoding, and no
+  // value materialized on the stack. CGetL and IsTypeL raise the same
+  // undefined-local notice, so that pair can be fused
+  // unconditionally; CGetQuietL never raises, so it can only be fused
+  // when the local is known to be initialized.
+  if (auto const last = last_op(env)) {
+    if (last->op == Op::CGetL) {
+      auto const loc = last->CGetL.nloc1;
+      rewind(env, 1);
+      return reduce(env, bc::IsTypeL { loc, op.subop1 });
+    }
+    if (last->op == Op::CGetQuietL &&
+        !locCouldBeUninit(env, last->CGetQuietL.loc1)) {
+      auto const loc = NamedLocal { kInvalidLocalName, last->CGetQuietL.loc1 };
+      rewind(env, 1);
+      return reduce(env, bc::IsTypeL { loc, op.subop1 });
+    }
+  }
+  isTypeCImpl(env, op);
+}
 void in(ISS& env, const bc::IsTypeL& op) { isTypeLImpl(env, op); }
 
 void in(ISS& env, const bc::InstanceOfD& op) {
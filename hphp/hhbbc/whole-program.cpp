@@ -599,6 +599,9 @@ void whole_program(php::ProgramPtr program,
     index.preinit_bad_initial_prop_values();
     index.use_class_dependencies(options.HardPrivatePropInference);
     analyze_iteratively(index, *program, AnalyzeMode::NormalPass);
+    // The dependency map is cleared by cleanup_for_final, so dump the
+    // unit-level dependency graph before kicking that off.
+    dump_unit_dependencies(index);
     cleanup_pre = std::thread([&] { index.cleanup_for_final(); });
     index.join_iface_vtable_thread();
     parallel::num_threads = parallel::final_threads;
@@ -15,7 +15,13 @@
 */
 #include "hphp/runtime/base/apc-array.h"
 
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
 #include <folly/Bits.h>
+#include <folly/Optional.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 
 #include "hphp/runtime/base/apc-handle.h"
 #include "hphp/runtime/base/apc-handle-defs.h"
@@ -24,6 +30,7 @@
 #include "hphp/runtime/base/apc-typed-value.h"
 #include "hphp/runtime/base/array-iterator.h"
 #include "hphp/runtime/base/data-walker.h"
+#include "hphp/runtime/base/program-functions.h"
 #include "hphp/runtime/base/tv-uncounted.h"
 #include "hphp/runtime/ext/apc/ext_apc.h"
 
@@ -40,6 +47,122 @@ size_t getMemSize(DataWalker::PointerMap* seenArrs) {
   return total;
 }
 
+// Pool size and minimum number of array children for the parallel
+// uncounted path; fewer children than this can't amortize the handoff.
+constexpr size_t kParallelUncountedThreads = 4;
+constexpr size_t kParallelUncountedMinChildren = 8;
+
+folly::CPUThreadPoolExecutor& getUncountedExecutor() {
+  // Executor compatible thread factory which sets up the HPHP thread
+  // state, as uncounted conversion touches static strings and APC stats.
+  struct UncountedThreadFactory : folly::NamedThreadFactory {
+    using folly::NamedThreadFactory::NamedThreadFactory;
+
+    std::thread newThread(folly::Func&& func) override {
+      return folly::NamedThreadFactory::newThread(
+        [func = std::move(func)] () mutable {
+          hphp_thread_init();
+          SCOPE_EXIT { hphp_thread_exit(); };
+          func();
+        }
+      );
+    }
+  };
+  static folly::CPUThreadPoolExecutor e{
+    kParallelUncountedThreads,
+    std::make_shared<UncountedThreadFactory>("ApcUncountedPool")
+  };
+  return e;
+}
+
+/*
+ * Size-triggered parallel construction of the uncounted representation.
+ *
+ * Converting a multi-MB nested array on the request thread monopolizes a
+ * worker for tens of milliseconds. When the source array is big enough
+ * (Server.APC.ParallelUncountedMinBytes), convert its distinct top-level
+ * array children on a small pool, then build the parent here with the
+ * results stitched in via MakeUncountedEnv::precomputed.
+ *
+ * Returns folly::none when the array is too small or any child
+ * conversion fails, in which case the caller runs the serial path. The
+ * source array is request-local but frozen while we block on the pool,
+ * so the workers' reads of it race with nothing.
+ */
+folly::Optional<APCHandle::Pair> MaybeMakeUncountedParallel(ArrayData* arr) {
+  auto const minBytes = apcExtension::ParallelUncountedMinBytes;
+  if (LIKELY(minBytes <= 0)) return folly::none;
+  if (!arr->isVecType() && !arr->isDictType()) return folly::none;
+
+  // Distinct refcounted array children; a child appearing several times is
+  // converted once and stitched in everywhere it appears.
+  DataWalker::PointerMap precomputed;
+  std::vector<ArrayData*> kids;
+  IterateV(arr, [&](TypedValue v) {
+    if (!tvIsArrayLike(v)) return false;
+    auto const ad = v.val().parr;
+    if (!ad->isRefCounted() || ad->empty()) return false;
+    if (precomputed.emplace(ad, nullptr).second) kids.push_back(ad);
+    return false;
+  });
+  if (kids.size() < kParallelUncountedMinChildren) return folly::none;
+
+  auto const memSize = ::HPHP::getMemSize(arr, true);
+  if (memSize < size_t(minBytes)) return folly::none;
+
+  struct Batch {
+    std::mutex lock;
+    std::condition_variable done;
+    size_t pending;
+    bool failed{false};
+  };
+  Batch batch;
+  std::vector<ArrayData*> out(kids.size(), nullptr);
+
+  auto const threads = std::min(kParallelUncountedThreads, kids.size());
+  batch.pending = threads;
+  auto& exec = getUncountedExecutor();
+  for (size_t t = 0; t < threads; ++t) {
+    // The tasks only touch locals we block on below, so plain references
+    // are safe to capture.
+    exec.add([&, t] {
+      auto ok = true;
+      for (auto i = t; i < kids.size() && ok; i += threads) {
+        try {
+          auto const env = MakeUncountedEnv { nullptr, nullptr };
+          out[i] = ::HPHP::MakeUncountedArray(kids[i], env, false);
+        } catch (...) {
+          ok = false;
+        }
+      }
+      std::lock_guard<std::mutex> g(batch.lock);
+      if (!ok) batch.failed = true;
+      if (--batch.pending == 0) batch.done.notify_one();
+    });
+  }
+  {
+    std::unique_lock<std::mutex> g(batch.lock);
+    batch.done.wait(g, [&] { return batch.pending == 0; });
+  }
+
+  // Drop the construction reference on each child when we're done; the
+  // parent build takes its own reference on every stitched occurrence.
+  SCOPE_EXIT {
+    for (auto const ad : out) {
+      if (ad) DecRefUncountedArray(ad);
+    }
+  };
+  if (batch.failed) return folly::none;
+
+  for (size_t i = 0; i < kids.size(); ++i) {
+    precomputed[kids[i]] = out[i];
+  }
+  auto const env = MakeUncountedEnv { nullptr, &precomputed };
+  auto const data = ::HPHP::MakeUncountedArray(arr, env, true);
+  auto const handle = APCTypedValue::ForArray(data)->getHandle();
+  return APCHandle::Pair { handle, memSize + sizeof(APCTypedValue) };
+}
+
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -63,6 +186,11 @@ APCArray::MakeSharedImpl(ArrayData* arr, APCHandleLevel level,
     }
 
     if (apcExtension::UseUncounted && !features.hasNonPersistable) {
+      // Sharing needs the request-local seen map threaded through every
+      // conversion, which isn't thread-safe; only go parallel without it.
+      if (!seenArrs) {
+        if (auto const pair = MaybeMakeUncountedParallel(arr)) return *pair;
+      }
       auto const base_size = use_jemalloc ?
         tl_heap->getAllocated() - tl_heap->getDeallocated() :
         seenArrs.get() ? getMemSize(seenArrs.get()) :
@@ -256,6 +256,38 @@ ArrayData* implAPCBespoke(APCBespokeEnv& env, ArrayData* ain,
 ArrayData* makeAPCBespoke(APCBespokeEnv& env, ArrayData* ain, bool hasApcTv) {
   assertx(ain->isStatic() || ain->isUncounted());
 
+  // Fast path: in Bespoke mode, an input that is already a concrete bespoke
+  // array (e.g. a StructDict) with no subarrays often already has its target
+  // layout. Detect that case directly, so storing such an array doesn't pay
+  // for a vanilla materialization just to coerce back to the same layout.
+  // The hash must match the commutative key hash implAPCBespoke computes.
+  if (env.mode == APCBespokeMode::Bespoke && !ain->isVanilla() &&
+      (ain->isVecType() || ain->isDictType())) {
+    auto const incoming = ArrayLayout::FromArray(ain);
+    if (!incoming.logging() && incoming.bespokeLayout()->isConcrete()) {
+      auto hash = ain->isVecType() ? kVecHashSeed : kDictHashSeed;
+      auto flat = true;
+      IterateKV(ain, [&](TypedValue key, TypedValue val) {
+        if (tvIsString(key)) hash += key.val().pstr->hash();
+        if (tvIsArrayLike(val)) {
+          flat = false;
+          return true;
+        }
+        return false;
+      });
+      if (flat) {
+        auto const profile = arrayTypeCouldBeBespoke(ain->toDataType())
+          ? getLoggingProfile(APCKey{hash}) : nullptr;
+        auto const target = profile ? profile->getLayout() : incoming;
+        if (target == incoming) {
+          FTRACE(2, "  {} already has its target layout {}.\n",
+                 ain, incoming.describe());
+          return nullptr;
+        }
+      }
+    }
+  }
+
   // Escalate bespoke inputs to vanilla. Don't log it as an escalation for the
   // input, though - doing so would pessimize all sources going into APC.
   auto const vin = [&]{
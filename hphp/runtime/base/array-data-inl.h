@@ -122,6 +122,10 @@ inline bool ArrayData::bothVanilla(const ArrayData* ad1, const ArrayData* ad2) {
 
 inline bool ArrayData::hasApcTv() const { return m_aux16 & kHasApcTv; }
 
+inline bool ArrayData::hasCoallocStrings() const {
+  return m_aux16 & kUncountedCoalloc;
+}
+
 inline bool ArrayData::isLegacyArray() const { return m_aux16 & kLegacyArray; }
 
 inline bool ArrayData::hasStrKeyTable() const {
@@ -137,6 +137,14 @@ struct ArrayData : MaybeCountable {
    */
   static auto constexpr kSampledArray = 8;
 
+  /*
+   * For uncounted vanilla dicts and vecs, indicates that flat strings were
+   * co-allocated into this array's block, after the elements. Such strings
+   * hold a reference on the array rather than owning their memory, so the
+   * block must be freed unsized on release.
+   */
+  static auto constexpr kUncountedCoalloc = 16;
+
   /*
    * See notes on the m_layout_index field for constraints on this value.
    */
@@ -238,6 +246,12 @@ public:
    */
   bool hasApcTv() const;
 
+  /*
+   * Only used for uncounted arrays. Indicates that flat strings were
+   * co-allocated into this array's block. See kUncountedCoalloc.
+   */
+  bool hasCoallocStrings() const;
+
   /*
    * Whether the array has legacy behaviors enabled. This method can only be
    * called for dvarrays, vecs and dicts.
@@ -18,6 +18,8 @@
 #include "hphp/runtime/base/array-iterator.h"
 #include "hphp/runtime/base/execution-context.h"
 #include "hphp/runtime/base/packed-sort.h"
+#include "hphp/runtime/base/pdq-sort.h"
+#include "hphp/runtime/base/runtime-option.h"
 #include "hphp/runtime/base/sort-helpers.h"
 #include "hphp/runtime/base/tv-mutate.h"
 #include "hphp/runtime/base/tv-variant.h"
@@ -27,9 +29,14 @@
 #include "hphp/runtime/base/vanilla-vec-defs.h"
 #include "hphp/runtime/vm/jit/translator-inline.h"
 #include "hphp/runtime/vm/coeffects.h"
+#include "hphp/util/process.h"
 
 #include <folly/ScopeGuard.h>
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -249,6 +256,87 @@ void VanillaKeyset::Ksort(ArrayData* ad, int sort_flags, bool ascending) {
 
 #undef SORT_BODY
 
+namespace {
+
+/*
+ * Flat path for VanillaVec::Sort: when every element is an int and the
+ * comparator is a plain value comparison, copy the values into a flat
+ * scratch buffer and run pdq::sort on it instead of dragging a generic
+ * comparator through the array layout. Vecs of at least
+ * VecParallelSortThreshold elements sort chunks of the buffer on worker
+ * threads and merge the results; the workers touch only the buffer, never
+ * the array or any request-local state. Returns false if the input doesn't
+ * qualify; the caller runs the generic sort instead.
+ */
+bool trySortIntVecFlat(ArrayData* ad, int sort_flags, bool ascending) {
+  if (sort_flags != SORT_REGULAR && sort_flags != SORT_NUMERIC) return false;
+  auto const size = static_cast<int64_t>(ad->size());
+  if (size < 16) return false;  // not worth the copy out and back
+  auto const threshold = RuntimeOption::EvalVecParallelSortThreshold;
+  auto const parallel =
+    threshold != 0 && size >= static_cast<int64_t>(threshold);
+  auto const workers = parallel
+    ? std::max(int64_t{1},
+               std::min(static_cast<int64_t>(Process::GetCPUCount()),
+                        int64_t{8}))
+    : int64_t{1};
+
+  auto const buf = std::make_unique<int64_t[]>(size);
+  for (int64_t i = 0; i < size; i++) {
+    buf[i] = VanillaVec::LvalUncheckedInt(ad, i).val().num;
+  }
+
+  auto const sortChunk = [&](int64_t begin, int64_t end) {
+    if (ascending) {
+      pdq::sort(buf.get() + begin, buf.get() + end);
+    } else {
+      pdq::sort(buf.get() + begin, buf.get() + end, std::greater<int64_t>{});
+    }
+  };
+
+  std::vector<int64_t> bounds;
+  bounds.reserve(workers + 1);
+  for (int64_t i = 0; i < workers; i++) bounds.push_back(size * i / workers);
+  bounds.push_back(size);
+
+  std::vector<std::thread> threads;
+  threads.reserve(workers - 1);
+  for (int64_t i = 1; i < workers; i++) {
+    threads.emplace_back(sortChunk, bounds[i], bounds[i + 1]);
+  }
+  sortChunk(bounds[0], bounds[1]);
+  for (auto& t : threads) t.join();
+
+  // Merge pairs of sorted runs until one run covers the whole buffer. The
+  // merges are serial, but the O(n log n) chunk sorts dominate.
+  while (bounds.size() > 2) {
+    std::vector<int64_t> merged;
+    merged.push_back(bounds[0]);
+    size_t i = 0;
+    while (i + 2 < bounds.size()) {
+      auto const lo = buf.get() + bounds[i];
+      auto const mid = buf.get() + bounds[i + 1];
+      auto const hi = buf.get() + bounds[i + 2];
+      if (ascending) {
+        std::inplace_merge(lo, mid, hi);
+      } else {
+        std::inplace_merge(lo, mid, hi, std::greater<int64_t>{});
+      }
+      merged.push_back(bounds[i + 2]);
+      i += 2;
+    }
+    if (i + 1 < bounds.size()) merged.push_back(bounds.back());
+    bounds = std::move(merged);
+  }
+
+  for (int64_t i = 0; i < size; i++) {
+    VanillaVec::LvalUncheckedInt(ad, i).val().num = buf[i];
+  }
+  return true;
+}
+
+}
+
 void VanillaVec::Sort(ArrayData* ad, int sort_flags, bool ascending) {
   assertx(checkInvariants(ad));
   if (ad->m_size <= 1) {
@@ -257,6 +345,10 @@ void VanillaVec::Sort(ArrayData* ad, int sort_flags, bool ascending) {
   assertx(!ad->hasMultipleRefs());
   auto a = ad;
   SortFlavor flav = preSort(ad);
+  if (flav == IntegerSort &&
+      trySortIntVecFlat(ad, sort_flags, ascending)) {
+    return;
+  }
   if constexpr (stores_typed_values) {
     auto const data_begin = VanillaVec::entries(ad);
     auto const data_end = data_begin + a->m_size;
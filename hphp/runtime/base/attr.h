@@ -124,6 +124,11 @@ enum Attr {
   // Indicates that the function returns readonly value
   AttrReadonlyReturn       = (1u << 15), //       |          |    X    //
                                          //       |          |         //
+  // Set by HHBBC on static, non-LSB memoize wrappers whose implementation
+  // provably computes its result from its arguments alone, so memoized
+  // values may be shared across requests.          |         //
+  AttrPersistentMemoize    = (1u << 16), //       |          |    X    //
+                                         //       |          |         //
   // Indicates that the function, class or static property can be loaded
   // once and then persisted across all requests. |          |         //
   AttrPersistent           = (1u << 18), //    X  |    X     |    X    //
@@ -179,24 +179,51 @@ std::pair<LayoutWeightVector::const_iterator, Optional<ColorMap>>
   }
   assertx(lo_idx + 1 == hi_idx);
 
+  // The weight order is not a colorability order: one wide layout can end
+  // the colorable prefix while later, lighter layouts would still color
+  // fine. Salvage what we can by retrying each discarded layout against the
+  // accepted set, keeping it if the combined set still colors. We bound the
+  // number of retries since each one recolors from scratch; the layouts are
+  // in descending weight order, so we try the most valuable ones.
+  auto accepted_end = hi_idx;
+  if (performColoring(layouts.begin(), layouts.begin() + hi_idx)) {
+    auto constexpr kMaxSalvageAttempts = size_t{64};
+    auto const limit =
+      std::min(layouts.size(), accepted_end + kMaxSalvageAttempts);
+    for (auto idx = accepted_end; idx < limit; idx++) {
+      std::swap(layouts[accepted_end], layouts[idx]);
+      auto const result = performColoring(
+        layouts.begin(),
+        layouts.begin() + accepted_end + 1
+      );
+      if (result) {
+        accepted_end++;
+      } else {
+        std::swap(layouts[accepted_end], layouts[idx]);
+      }
+    }
+    FTRACE(3, "Salvaged {} layouts past the colorable prefix.\n",
+           accepted_end - hi_idx);
+  }
+
   // Record the discarded and accepted layouts.
   std::copy(
-    layouts.begin(), layouts.begin() + hi_idx,
+    layouts.begin(), layouts.begin() + accepted_end,
     std::back_inserter(s_metadata.coloringAcceptedLayouts)
   );
   std::copy(
-    layouts.begin() + hi_idx, layouts.end(),
+    layouts.begin() + accepted_end, layouts.end(),
     std::back_inserter(s_metadata.coloringDiscardedLayouts)
   );
   auto const coloring = performColoring(
     layouts.begin(),
-    layouts.begin() + hi_idx
+    layouts.begin() + accepted_end
   );
   s_metadata.coloring = coloring;
 
-  FTRACE(3, "Final coloring: {} layouts.\n", hi_idx);
+  FTRACE(3, "Final coloring: {} layouts.\n", accepted_end);
 
-  return {layouts.begin() + hi_idx, coloring};
+  return {layouts.begin() + accepted_end, coloring};
 }
 
 void applyColoring(const ColorMap& coloring) {
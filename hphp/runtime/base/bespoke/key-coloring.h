@@ -34,8 +34,15 @@ using ColorMap = folly::F14FastMap<const StringData*, Color>;
 // prefix, and a set of layouts that could not be colored. The return value is
 // an iterator pointing to the first element of the uncolorable suffix.
 //
-// The current implementation sorts the layouts by weight and finds a colorable
-// prefix of the resulting order.
+// The current implementation sorts the layouts by weight, finds a colorable
+// prefix of the resulting order, and then retries each layout just past the
+// prefix against the accepted set, so one uncolorable wide layout doesn't
+// discard every lighter layout behind it.
+//
+// Note: layouts this still can't color fall back to generic dispatch. Giving
+// them a second-tier perfect-hash scheme (e.g. hash-displacement) would need
+// new lookup codegen: the color-indexed PerfectHashTable shape is baked into
+// cgStructDictGetWithColor for both known and unknown layouts.
 std::pair<LayoutWeightVector::const_iterator, Optional<ColorMap>>
   findKeyColoring(LayoutWeightVector& layouts);
 
@@ -774,6 +774,28 @@ SinkLayout layoutForSink(const jit::TransIDSet& ids, SrcKey sk) {
   return result;
 }
 
+/*
+ * Layout selection is a one-shot decision. It would be nice to keep a
+ * low-rate profile running after retranslateAll and re-specialize sources
+ * whose traffic shifts post-deploy, but three things stand in the way:
+ *
+ *  1. Decisions are burned into optimized translations: sources allocate
+ *     their chosen layout directly and sinks guard on it. Re-binding a
+ *     source means re-JITing every translation that observed its layout,
+ *     and this runtime only runs retranslateAll once.
+ *
+ *  2. FinalizeHierarchy() freezes the layout lattice. Struct layout
+ *     indices and the perfect-hash key coloring are assigned globally at
+ *     that point, so we can't mint new StructLayouts for a re-selection.
+ *
+ *  3. Logging arrays are only allocated by profiling translations, and we
+ *     free all profile data right after selection, so there's no
+ *     collection substrate left to re-run selection against.
+ *
+ * Until one of those changes, the live signal for stale decisions is the
+ * sampled escalation log (see escalation-logging.cpp): sources stuck on a
+ * bad layout show up there as guard failures and vanilla escalations.
+ */
 void selectBespokeLayouts() {
   // On successfully deserializing layout decisions, a jumpstart consumer
   // will take care of finalizing the layout hierarchy.
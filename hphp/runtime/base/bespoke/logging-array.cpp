@@ -165,7 +165,12 @@ ArrayData* maybeMakeLoggingArray(ArrayData* ad, LoggingProfile* profile) {
   if (!shouldEmitBespoke) {
     FTRACE(5, "Emit vanilla at {}\n", profile->key.toString());
     auto const cached = profile->data->staticSampledArray;
-    return cached ? cached : makeSampledArray(ad);
+    if (cached) return cached;
+    if (auto const promoted = profile->observeConstantConstruction(ad)) {
+      FTRACE(5, "Promote constant array at {}\n", profile->key.toString());
+      return promoted;
+    }
+    return makeSampledArray(ad);
   }
 
   FTRACE(5, "Emit bespoke at {}\n", profile->key.toString());
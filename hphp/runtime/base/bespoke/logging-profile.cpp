@@ -17,6 +17,7 @@
 
 #include "hphp/runtime/base/bespoke/logging-profile.h"
 
+#include "hphp/runtime/base/array-iterator.h"
 #include "hphp/runtime/base/backtrace.h"
 #include "hphp/runtime/base/bespoke/key-coloring.h"
 #include "hphp/runtime/base/bespoke/logging-array.h"
@@ -24,11 +25,14 @@
 #include "hphp/runtime/base/bespoke/struct-dict.h"
 #include "hphp/runtime/base/memory-manager-defs.h"
 #include "hphp/runtime/base/runtime-option.h"
+#include "hphp/runtime/base/tv-refcount.h"
 #include "hphp/runtime/server/memory-stats.h"
 #include "hphp/runtime/vm/jit/mcgen-translate.h"
 #include "hphp/runtime/vm/vm-regs.h"
 #include "hphp/util/hash-map.h"
+#include "hphp/util/optional.h"
 
+#include <folly/Hash.h>
 #include <folly/SharedMutex.h>
 #include <folly/String.h>
 
@@ -341,8 +345,24 @@ void LoggingProfile::logEventImpl(const EventKey& key) {
 
   assertx(data);
 
+  // Cap the number of distinct events per profile. Once a profile is full,
+  // fold new events into their key-despecialized entries - the same
+  // coarsening the exporter applies when deduping events - so counts are
+  // preserved but memory stays bounded. (The despecialized key space is a
+  // small finite set, so the map can only exceed the cap by that much.)
+  // The size check races with concurrent inserts, but the race only shifts
+  // the exact point at which we start folding.
+  auto event = key.toUInt64();
+  if (auto const cap = RO::EvalBespokeMaxProfileEvents) {
+    folly::SharedMutex::ReadHolder mapLock{data->mapLock};
+    if (data->events.size() >= cap &&
+        data->events.find(event) == data->events.end()) {
+      event = key.dropKeySpecialization().toUInt64();
+    }
+  }
+
   DEBUG_ONLY auto const count =
-    incrementCounter(data->events, data->mapLock, key.toUInt64());
+    incrementCounter(data->events, data->mapLock, event);
   DEBUG_ONLY auto const op = key.getOp();
   DEBUG_ONLY auto const has_sink =
     op != ArrayOp::Release && op != ArrayOp::ReleaseUncounted;
@@ -375,6 +395,110 @@ void LoggingProfile::logKeyOrders(const KeyOrder& ko) {
   incrementCounter(data->keyOrders, data->mapLock, ko);
 }
 
+namespace {
+
+void freeStaticArray(ArrayData* ad);
+
+// Order-sensitive content hash of a vanilla array whose keys and values are
+// all scalars. Returns std::nullopt for any other array, which disqualifies
+// the source from constant promotion.
+Optional<uint64_t> hashScalarArrayContents(const ArrayData* ad) {
+  auto const hashTV = [](TypedValue tv) -> Optional<uint64_t> {
+    auto const piece = [&]() -> Optional<uint64_t> {
+      if (tvIsNull(tv)) return 0;
+      if (tvIsBool(tv) || tvIsInt(tv)) {
+        return folly::hash::twang_mix64(val(tv).num);
+      }
+      if (tvIsDouble(tv)) {
+        uint64_t bits;
+        memcpy(&bits, &val(tv).dbl, sizeof(bits));
+        return folly::hash::twang_mix64(bits);
+      }
+      if (tvIsString(tv)) return val(tv).pstr->hash();
+      return std::nullopt;
+    }();
+    if (!piece) return std::nullopt;
+    auto const dt = dt_modulo_persistence(type(tv));
+    return folly::hash::hash_combine(uint8_t(dt), *piece);
+  };
+
+  auto hash = folly::hash::hash_combine(
+      uint8_t(ad->kind()), ad->isLegacyArray(), ad->size());
+  auto ok = true;
+  IterateKV(ad, [&](TypedValue k, TypedValue v) {
+    auto const kh = hashTV(k);
+    auto const vh = hashTV(v);
+    if (!kh || !vh) {
+      ok = false;
+      return true;
+    }
+    hash = folly::hash::hash_combine(hash, *kh, *vh);
+    return false;
+  });
+  if (!ok) return std::nullopt;
+  return hash;
+}
+
+}
+
+ArrayData* LoggingProfile::observeConstantConstruction(ArrayData* ad) {
+  auto const threshold = RO::EvalBespokeConstantArrayPromotionThreshold;
+  if (threshold == 0 || !ad->isRefCounted()) return nullptr;
+  assertx(data);
+  assertx(ad->isVanilla());
+
+  if (auto const cached =
+      data->staticConstantArray.load(std::memory_order_acquire)) {
+    // Full comparison, not just a hash check: we must never substitute an
+    // array that differs from the one this request just built.
+    if (cached->isLegacyArray() == ad->isLegacyArray() && cached->same(ad)) {
+      decRefArr(ad);
+      return cached;
+    }
+    return nullptr;
+  }
+
+  if (!data->constantCandidate.load(std::memory_order_acquire)) return nullptr;
+  auto const hash = hashScalarArrayContents(ad);
+  if (!hash) {
+    data->constantCandidate.store(false, std::memory_order_release);
+    return nullptr;
+  }
+
+  // The hash and streak updates race benignly: a lost update can only delay
+  // or suppress a promotion, never cause an incorrect one.
+  auto const streak = data->constantStreak.load(std::memory_order_acquire);
+  if (streak == 0) {
+    data->constantHash.store(*hash, std::memory_order_release);
+    data->constantStreak.store(1, std::memory_order_release);
+    return nullptr;
+  }
+  if (data->constantHash.load(std::memory_order_acquire) != *hash) {
+    data->constantCandidate.store(false, std::memory_order_release);
+    return nullptr;
+  }
+  if (streak + 1 < threshold) {
+    data->constantStreak.store(streak + 1, std::memory_order_release);
+    return nullptr;
+  }
+
+  // Promote: staticify this array's strings in place, then publish a static
+  // sampled copy. The shared instance stays correct under mutation via CoW,
+  // like the staticSampledArray we make for literal sources.
+  ad->onSetEvalScalar();
+  auto const sad = ad->copyStatic();
+  sad->setSampledArrayInPlace();
+  ArrayData* expected = nullptr;
+  if (!data->staticConstantArray.compare_exchange_strong(
+        expected, sad, std::memory_order_acq_rel)) {
+    freeStaticArray(sad);
+    return nullptr;
+  }
+  MemoryStats::LogAlloc(AllocKind::StaticArray, allocSize(sad));
+  decRefArr(ad);
+  return sad;
+}
+
 BespokeArray* LoggingProfile::getStaticBespokeArray() const {
   return staticBespokeArray;
 }
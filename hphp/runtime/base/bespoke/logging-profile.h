@@ -219,7 +219,9 @@ struct LoggingProfileKey {
 // We'll store a LoggingProfile for each array construction site SrcKey.
 // It tracks the operations that happen on arrays coming from that site.
 struct LoggingProfile {
-  // Values in the event map are sampled event counts.
+  // Values in the event map are sampled event counts. The number of distinct
+  // entries is bounded by EvalBespokeMaxProfileEvents (when set); overflow
+  // events are folded into key-despecialized entries.
   using EventMap = folly::F14FastMap<uint64_t, CopyAtomic<size_t>>;
 
   // The first element of the key is the EntryTypes before the operation;
@@ -243,6 +245,15 @@ struct LoggingProfile {
     EventMap events;
     EntryTypesMap entryTypes;
     KeyOrderMap keyOrders;
+
+    // Constant-construction detection (see observeConstantConstruction):
+    // the content hash of the first sampled construction, the length of the
+    // streak of identical constructions, whether this source is still a
+    // promotion candidate, and the promoted static array (if any).
+    std::atomic<uint64_t> constantHash{0};
+    std::atomic<uint32_t> constantStreak{0};
+    std::atomic<bool> constantCandidate{true};
+    std::atomic<ArrayData*> staticConstantArray{nullptr};
   };
 
   explicit LoggingProfile(LoggingProfileKey key);
@@ -266,6 +277,13 @@ struct LoggingProfile {
   void logEntryTypes(EntryTypes before, EntryTypes after);
   void logKeyOrders(const KeyOrder&);
 
+  // Profile-driven promotion of constant construction sites: observe one
+  // sampled construction of the refcounted vanilla array `ad` at this
+  // source. If enough identical scalar arrays have been built here, returns
+  // a shared static instance and consumes a reference to `ad`; otherwise
+  // returns nullptr and the caller keeps `ad`.
+  ArrayData* observeConstantConstruction(ArrayData* ad);
+
   // TODO(kshaunak): Refactor this class so that we automatically construct
   // this cached array when we set the layout. (We should make layout.apply
   // a LayoutFunction - MakeFromVanilla - to do so as cleanly as possible.)
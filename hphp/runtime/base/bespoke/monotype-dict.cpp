@@ -548,7 +548,7 @@ bool MonotypeDict<Key>::checkInvariants() const {
   static_assert(kElmSize == sizeof(Elm));
   static_assert(kIndexSize == sizeof(Index));
 
-#ifdef USE_X86_STRING_HELPERS
+#if defined(USE_X86_STRING_HELPERS) || defined(USE_ARM_STRING_HELPERS)
   static_assert(HeapObject::aux_offset() + 1 == MD_SIZE_CLASS_OFFSET);
   static_assert(sizeof(StringDict) == MD_DATA);
   static_assert(kMinSizeIndex == MD_MIN_SIZE_CLASS);
@@ -632,7 +632,7 @@ MonotypeDict<Key>::findForGet(Key key, strhash_t hash) const {
   return mad->template find<Get>(key, hash).elm;
 }
 
-#ifdef USE_X86_STRING_HELPERS
+#if defined(USE_X86_STRING_HELPERS) || defined(USE_ARM_STRING_HELPERS)
 template <>
 TypedValue MonotypeDict<StringData*>::getImpl(StringData* key) const;
 #endif
@@ -30,6 +30,10 @@
 
 #include "hphp/util/word-mem.h"
 
+#ifdef __x86_64__
+#include <emmintrin.h>
+#endif
+
 namespace HPHP { namespace bespoke {
 
 namespace {
@@ -898,6 +902,93 @@ LayoutIndex MonotypeVecLayout::Index(DataType type) {
   return getLayoutIndex(type);
 }
 
+namespace {
+
+// Returns `ad` as a non-empty MonotypeVec, or nullptr if it isn't one.
+const MonotypeVec* asMonotypeVecOrNull(const ArrayData* ad) {
+  if (ad->isVanilla()) return nullptr;
+  auto const index = BespokeArray::asBespoke(ad)->layoutIndex();
+  if (index.byte() != kMonotypeVecLayoutByte) return nullptr;
+  return MonotypeVec::As(ad);
+}
+
+}
+
+Optional<TypedValue> MonotypeVec::Sum(const ArrayData* ad) {
+  auto const mad = asMonotypeVecOrNull(ad);
+  if (!mad) return std::nullopt;
+  auto const size = mad->size();
+  auto const data = mad->rawData();
+  if (mad->type() == KindOfInt64) {
+    int64_t sum = 0;
+    uint32_t i = 0;
+#ifdef __x86_64__
+    // Integer addition is associative, so we can accumulate two lanes at a
+    // time and fold them at the end. Wrapping matches the scalar loop.
+    auto acc = _mm_setzero_si128();
+    for (; i + 2 <= size; i += 2) {
+      acc = _mm_add_epi64(
+          acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+    }
+    sum = _mm_cvtsi128_si64(acc) +
+          _mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc));
+#endif
+    for (; i < size; i++) sum += data[i].num;
+    return make_tv<KindOfInt64>(sum);
+  }
+  if (mad->type() == KindOfDouble) {
+    // Stay scalar and in-order for doubles: reassociating the adds would
+    // change rounding relative to the generic loop.
+    double sum = 0.0;
+    for (uint32_t i = 0; i < size; i++) sum += data[i].dbl;
+    return make_tv<KindOfDouble>(sum);
+  }
+  return std::nullopt;
+}
+
+Optional<TypedValue> MonotypeVec::Product(const ArrayData* ad) {
+  auto const mad = asMonotypeVecOrNull(ad);
+  if (!mad) return std::nullopt;
+  auto const size = mad->size();
+  auto const data = mad->rawData();
+  if (mad->type() == KindOfInt64) {
+    // No packed 64-bit multiply in SSE2; the flat loop still skips all of
+    // the generic dispatch and type tests.
+    int64_t prod = 1;
+    for (uint32_t i = 0; i < size; i++) prod *= data[i].num;
+    return make_tv<KindOfInt64>(prod);
+  }
+  if (mad->type() == KindOfDouble) {
+    double prod = 1.0;
+    for (uint32_t i = 0; i < size; i++) prod *= data[i].dbl;
+    return make_tv<KindOfDouble>(prod);
+  }
+  return std::nullopt;
+}
+
+Optional<bool> MonotypeVec::ContainsInt(const ArrayData* ad, int64_t needle) {
+  auto const mad = asMonotypeVecOrNull(ad);
+  if (!mad || mad->type() != KindOfInt64) return std::nullopt;
+  auto const size = mad->size();
+  auto const data = mad->rawData();
+  uint32_t i = 0;
+#ifdef __x86_64__
+  // SSE2 has no 64-bit equality, so compare 32-bit halves and require both
+  // halves of a lane to match.
+  auto const pattern = _mm_set1_epi64x(needle);
+  for (; i + 2 <= size; i += 2) {
+    auto const eq = _mm_cmpeq_epi32(
+        pattern, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+    auto const mask = _mm_movemask_epi8(eq);
+    if ((mask & 0x00ff) == 0x00ff || (mask & 0xff00) == 0xff00) return true;
+  }
+#endif
+  for (; i < size; i++) {
+    if (data[i].num == needle) return true;
+  }
+  return false;
+}
+
 bool isMonotypeVecLayout(LayoutIndex index) {
   auto const byte = index.byte();
   return byte == kMonotypeVecLayoutByte || byte == kEmptyMonotypeVecLayoutByte;
@@ -20,6 +20,7 @@
 #include "hphp/runtime/base/array-data.h"
 #include "hphp/runtime/base/bespoke-array.h"
 #include "hphp/runtime/base/bespoke/layout.h"
+#include "hphp/util/optional.h"
 
 namespace HPHP { namespace bespoke {
 
@@ -49,6 +50,16 @@ struct MonotypeVec : public BespokeArray {
   static MonotypeVec* As(ArrayData* ad);
   static const MonotypeVec* As(const ArrayData* ad);
 
+  /**
+   * Bulk kernels over the flat value array, used by the array builtins.
+   * Each returns std::nullopt unless `ad` is a MonotypeVec whose element
+   * type the kernel handles; callers fall back to generic iteration in that
+   * case. The results match what the generic loops would produce.
+   */
+  static Optional<TypedValue> Sum(const ArrayData* ad);
+  static Optional<TypedValue> Product(const ArrayData* ad);
+  static Optional<bool> ContainsInt(const ArrayData* ad, int64_t needle);
+
   static uint64_t entriesOffset() { return sizeof(MonotypeVec); }
   static uint64_t typeOffset() {
     static_assert(folly::kIsLittleEndian);
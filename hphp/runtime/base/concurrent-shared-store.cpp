@@ -27,8 +27,11 @@
 #include "hphp/util/logger.h"
 #include "hphp/util/timer.h"
 #include "hphp/util/trace.h"
+#include "hphp/util/zstd.h"
 
 #include <atomic>
+#include <fstream>
+#include <limits>
 #include <mutex>
 #include <set>
 #include <string>
@@ -408,14 +411,14 @@ bool ConcurrentTableSharedStore::eraseImpl(const char* key,
     if (expiry) {
       s_hotCache.clearValue(storeVal);
 
-      // If we got an expAcc it means that we are iterating over m_expQueue and
-      // expiring things. But if the item is not expired yet we need to put it back
-      // into the queue with the correct expire time. It happens if expire time was
-      // updated either by apc_extend_ttl or by setting a new value with a TTL on
-      // an existing key.
+      // If we got an expAcc it means that we are iterating over an expiry
+      // queue and expiring things. But if the item is not expired yet we need
+      // to put it back into its queue with the correct expire time. It happens
+      // if expire time was updated either by apc_extend_ttl or by setting a
+      // new value with a TTL on an existing key.
       if (expAcc) {
         auto ikey = intptr_t(acc->first);
-        m_expQueue.push({ ikey, expiry });
+        m_expQueues[expShard(ikey)].push({ ikey, expiry });
       }
     }
     return false;
@@ -471,6 +474,8 @@ bool ConcurrentTableSharedStore::eraseImpl(const char* key,
    * converted to a char* will be a valid c-string.
    */
   m_vars.erase(acc);
+  m_coldSet.erase(intptr_t(vpkey));
+  m_accessTimes.erase(intptr_t(vpkey));
   if (expAcc) {
     m_expSet.erase(*expAcc);
   } else {
@@ -491,21 +496,29 @@ bool ConcurrentTableSharedStore::eraseImpl(const char* key,
 
 // Should be called outside m_lock
 void ConcurrentTableSharedStore::purgeExpired() {
-  auto last = m_lastPurgeTime.load(std::memory_order_acquire);
+  // Purge one shard per call, round-robin, so a TTL wave across the whole
+  // store never makes a single request drain every due entry. Each shard
+  // runs on its own PurgeInterval clock.
+  auto const shard =
+    m_nextPurgeShard.fetch_add(1, std::memory_order_relaxed) %
+    kNumExpQueueShards;
+  auto& lastPurgeTime = m_lastPurgeTimes[shard];
+  auto last = lastPurgeTime.load(std::memory_order_acquire);
   time_t now = time(nullptr);
   if (now < last + apcExtension::PurgeInterval) return;
-  if (!m_lastPurgeTime.compare_exchange_strong(last, now,
-                                               std::memory_order_acq_rel)) {
+  if (!lastPurgeTime.compare_exchange_strong(last, now,
+                                             std::memory_order_acq_rel)) {
     return;                             // someone beat us
   }
   int64_t oldestLive = apcExtension::UseUncounted ?
       HPHP::Treadmill::getOldestStartTime() : 0;
+  auto& expQueue = m_expQueues[shard];
   ExpirationPair tmp;
   int i = 0;
   int j = 0;
-  while (m_expQueue.try_pop(tmp)) {
+  while (expQueue.try_pop(tmp)) {
     if (tmp.second > now) {
-      m_expQueue.push(tmp);
+      expQueue.push(tmp);
       break;
     }
     ExpSet::accessor acc;
@@ -520,7 +533,7 @@ void ConcurrentTableSharedStore::purgeExpired() {
     }
     ++j;
   }
-  FTRACE(1, "Expired {} entries and ignored {}\n", i, j);
+  FTRACE(1, "Expired {} entries and ignored {} in shard {}\n", i, j, shard);
 }
 
 void ConcurrentTableSharedStore::purgeDeferred(req::vector<StringData*>&& keys) {
@@ -532,6 +545,146 @@ void ConcurrentTableSharedStore::purgeDeferred(req::vector<StringData*>&& keys)
   keys.clear();
 }
 
+namespace {
+// Cold-tier tuning: values smaller than this aren't worth compressing,
+// reads are sampled 1-in-N for recency tracking, and blobs are written at
+// this zstd level.
+constexpr int32_t kColdCompressMinSize = 256;
+constexpr uint64_t kColdAccessSampleRate = 64;
+constexpr int kColdCompressLevel = 3;
+}
+
+void ConcurrentTableSharedStore::sampleAccess(intptr_t ikey) {
+  // Sampled recency: most reads just bump a counter, so hot keys pay almost
+  // nothing for tracking. A genuinely hot key is sampled quickly; a rarely
+  // read key that slips through gets compressed once and re-recorded by the
+  // decompressing read.
+  auto const n =
+    m_accessSampleCounter.fetch_add(1, std::memory_order_relaxed);
+  if (n % kColdAccessSampleRate != 0) return;
+  AccessMap::accessor acc;
+  m_accessTimes.insert(acc, ikey);
+  acc->second = static_cast<uint32_t>(time(nullptr));
+}
+
+void ConcurrentTableSharedStore::maybeUncompress(intptr_t ikey,
+                                                 const StoreValue* csval) {
+  ExpSet::accessor cacc;
+  if (!m_coldSet.find(cacc, ikey)) return;
+  // Holding the exclusive m_coldSet accessor makes us the only reader
+  // restoring this entry; concurrent readers of the same key block on the
+  // find above and see the restored handle once we erase the marker.
+  // Mutating the entry is safe: writers hold an exclusive Map accessor,
+  // which excludes the const accessor our caller holds.
+  auto const sval = const_cast<StoreValue*>(csval);
+  auto const blobHandle = sval->data();
+  auto const blob = blobHandle->toLocal().toString();
+  auto const contentSize = ZSTD_getFrameContentSize(blob.data(), blob.size());
+
+  Variant value;
+  auto ok = false;
+  if (contentSize != ZSTD_CONTENTSIZE_ERROR &&
+      contentSize != ZSTD_CONTENTSIZE_UNKNOWN &&
+      contentSize <= std::numeric_limits<int32_t>::max()) {
+    String serialized(contentSize, ReserveString);
+    auto const got = ZSTD_decompress(serialized.mutableData(), contentSize,
+                                     blob.data(), blob.size());
+    if (!ZSTD_isError(got)) {
+      serialized.setSize(static_cast<int64_t>(got));
+      try {
+        value = apc_unserialize(serialized.data(), got);
+        ok = value.isInitialized();
+      } catch (...) {}
+    }
+  }
+  if (!ok) {
+    // Shouldn't happen: we wrote the blob ourselves, and the marker is
+    // dropped whenever the entry is overwritten or erased. Drop it here too
+    // so we don't retry on every read.
+    Logger::Error("Failed to restore compressed apc entry");
+    m_coldSet.erase(cacc);
+    return;
+  }
+
+  auto const pair = APCHandle::Create(value, APCHandleLevel::Outer, false);
+  APCStats::getAPCStats().updateAPCValue(
+    pair.handle, pair.size, blobHandle, sval->dataSize,
+    sval->rawExpire() == 0, false);
+  blobHandle->unreferenceRoot(sval->dataSize);
+  sval->setHandle(pair.handle);
+  sval->dataSize = pair.size;
+  {
+    AccessMap::accessor aacc;
+    m_accessTimes.insert(aacc, ikey);
+    aacc->second = static_cast<uint32_t>(time(nullptr));
+  }
+  m_coldSet.erase(cacc);
+}
+
+// Should be called outside m_lock
+void ConcurrentTableSharedStore::compressCold() {
+  auto const age = apcExtension::ColdCompressionAgeSeconds;
+  if (age <= 0) return;
+  auto last = m_lastColdScan.load(std::memory_order_acquire);
+  time_t now = time(nullptr);
+  if (now < last + age) return;
+  if (!m_lastColdScan.compare_exchange_strong(last, now,
+                                              std::memory_order_acq_rel)) {
+    return;                             // someone beat us
+  }
+
+  ZstdCompressor compressor(kColdCompressLevel);
+  size_t numCompressed = 0;
+  SharedMutex::WriteHolder l(m_lock);
+  for (auto iter = m_vars.begin(); iter != m_vars.end(); ++iter) {
+    auto& sval = iter->second;
+    if (sval.expired()) continue;
+    if (sval.dataSize < kColdCompressMinSize) continue;
+    auto const ikey = intptr_t(iter->first);
+    if (m_coldSet.count(ikey)) continue;
+    auto lastAccess = sval.c_time;
+    {
+      AccessMap::const_accessor aacc;
+      if (m_accessTimes.find(aacc, ikey)) {
+        lastAccess = std::max(lastAccess, aacc->second);
+      }
+    }
+    if (!lastAccess || now - lastAccess < age) continue;
+
+    String serialized;
+    try {
+      serialized = apc_serialize(sval.toLocal());
+    } catch (...) {
+      continue;                         // not serializable; leave it be
+    }
+    size_t len = serialized.size();
+    StringHolder blob;
+    try {
+      blob = compressor.compress(serialized.data(), len, true);
+    } catch (...) {
+      continue;
+    }
+    // dataSize includes handle overhead, so demand a real win. The blob
+    // value carries overhead of its own.
+    if (!blob.data() || len + 64 >= size_t(sval.dataSize)) continue;
+
+    auto const value = Variant{String(blob.data(), len, CopyString)};
+    auto const pair = APCHandle::Create(value, APCHandleLevel::Outer, false);
+    // The old handle goes away, so any HotCache entry must go with it.
+    s_hotCache.clearValue(sval);
+    auto const old = sval.data();
+    APCStats::getAPCStats().updateAPCValue(
+      pair.handle, pair.size, old, sval.dataSize,
+      sval.rawExpire() == 0, false);
+    old->unreferenceRoot(sval.dataSize);
+    sval.setHandle(pair.handle);
+    sval.dataSize = pair.size;
+    m_coldSet.insert({ ikey, ExpNil{} });
+    ++numCompressed;
+  }
+  FTRACE(1, "Compressed {} cold apc entries\n", numCompressed);
+}
+
 bool ConcurrentTableSharedStore::handlePromoteObj(const String& key,
                                                   APCHandle* svar,
                                                   const Variant& value) {
@@ -653,6 +806,11 @@ bool ConcurrentTableSharedStore::get(const String& keyStr, Variant& value) {
       return false;
     }
     sval = &acc->second;
+    if (UNLIKELY(apcExtension::ColdCompressionAgeSeconds > 0)) {
+      auto const ikey = intptr_t(acc->first);
+      maybeUncompress(ikey, sval);
+      sampleAccess(ikey);
+    }
     svar = sval->data();
     APCKind kind = sval->getKind();
     if (apcExtension::AllowObj &&
@@ -691,6 +849,83 @@ bool ConcurrentTableSharedStore::get(const String& keyStr, Variant& value) {
   return true;
 }
 
+size_t ConcurrentTableSharedStore::getMulti(
+    const req::vector<String>& keys,
+    req::vector<std::pair<bool,Variant>>& out) {
+  FTRACE(3, "GetMulti {} keys\n", keys.size());
+  out.clear();
+  out.reserve(keys.size());
+
+  // Handles whose conversion may reenter the VM; converted in bulk after
+  // the lock is dropped.  Each holds a non-root reference.
+  struct DeferredLocal {
+    size_t index;
+    APCHandle* handle;
+    bool promoteObj;
+  };
+  req::vector<DeferredLocal> deferred;
+
+  size_t hits = 0;
+  {
+    SharedMutex::ReadHolder l(m_lock);
+    for (auto const& keyStr : keys) {
+      Variant value;
+      HotCache::Idx hotIdx;
+      if (s_hotCache.get(keyStr.get(), value, hotIdx)) {
+        ++hits;
+        out.emplace_back(true, std::move(value));
+        continue;
+      }
+      Map::const_accessor acc;
+      if (checkExpire(keyStr, acc)) {
+        out.emplace_back(false, Variant{});
+        continue;
+      }
+      auto const sval = &acc->second;
+      if (UNLIKELY(apcExtension::ColdCompressionAgeSeconds > 0)) {
+        auto const ikey = intptr_t(acc->first);
+        maybeUncompress(ikey, sval);
+        sampleAccess(ikey);
+      }
+      auto const svar = sval->data();
+      auto const kind = sval->getKind();
+      bool promoteObj = false;
+      if (apcExtension::AllowObj &&
+          (kind == APCKind::SerializedObject ||
+           kind == APCKind::SharedObject ||
+           kind == APCKind::SharedCollection) &&
+          !svar->objAttempted()) {
+        svar->referenceNonRoot();
+        promoteObj = true;
+        out.emplace_back(true, Variant{});
+      } else if (svar->isTypedValue()) {
+        out.emplace_back(true, svar->toLocal());
+      } else {
+        svar->referenceNonRoot();
+        out.emplace_back(true, Variant{});
+      }
+      if (promoteObj) {
+        deferred.push_back({out.size() - 1, svar, true});
+      } else {
+        s_hotCache.store(hotIdx, keyStr.get(), svar, sval);
+        if (!svar->isTypedValue()) {
+          deferred.push_back({out.size() - 1, svar, false});
+        }
+      }
+      ++hits;
+    }
+  }
+
+  for (auto const& d : deferred) {
+    SCOPE_EXIT { d.handle->unreferenceNonRoot(); };
+    auto& value = out[d.index].second;
+    value = d.handle->toLocal();
+    if (d.promoteObj) handlePromoteObj(keys[d.index], d.handle, value);
+  }
+
+  return hits;
+}
+
 int64_t ConcurrentTableSharedStore::inc(const String& key, int64_t step,
                                         bool& found) {
   found = false;
@@ -911,6 +1146,8 @@ bool ConcurrentTableSharedStore::storeImpl(const String& key,
           sval->rawExpire() == 0, sval->expired());
       }
       current->unreferenceRoot(sval->dataSize);
+      // The replacement handle is not a compressed blob.
+      m_coldSet.erase(intptr_t(acc->first));
     } else {
       APCStats::getAPCStats().addAPCValue(svar.handle, svar.size, present);
     }
@@ -921,7 +1158,7 @@ bool ConcurrentTableSharedStore::storeImpl(const String& key,
     if (expiry) {
       auto ikey = intptr_t(acc->first);
       if (m_expSet.insert({ ikey, ExpNil{} })) {
-        m_expQueue.push({ ikey, expiry });
+        m_expQueues[expShard(ikey)].push({ ikey, expiry });
       }
     }
   }
@@ -1018,6 +1255,128 @@ static void dumpEntriesInfo(std::vector<EntryInfo> entries, std::ostream& out) {
   }
 }
 
+namespace {
+
+// The trailing byte doubles as a format version.
+constexpr char kSnapshotMagic[8] = {'A','P','C','S','N','A','P','1'};
+
+template <class T>
+void writePod(std::ofstream& out, T v) {
+  out.write(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+template <class T>
+bool readPod(std::ifstream& in, T& v) {
+  in.read(reinterpret_cast<char*>(&v), sizeof(v));
+  return in.gcount() == sizeof(v);
+}
+
+}
+
+bool ConcurrentTableSharedStore::saveSnapshot(const std::string& path) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    Logger::Error("Failed to open apc snapshot file %s", path.c_str());
+    return false;
+  }
+  out.write(kSnapshotMagic, sizeof(kSnapshotMagic));
+
+  SharedMutex::WriteHolder l(m_lock);
+  auto const now = time(nullptr);
+  size_t entries = 0;
+  for (auto iter = m_vars.begin(); iter != m_vars.end(); ++iter) {
+    auto const& sval = iter->second;
+    if (sval.expired()) continue;
+    auto const expire = sval.rawExpire();
+    if (expire && expire <= now) continue;
+    String val;
+    try {
+      val = apc_serialize(sval.toLocal());
+    } catch (...) {
+      // Skip entries whose values refuse to serialize.
+      continue;
+    }
+    auto const keyLen = static_cast<uint32_t>(strlen(iter->first));
+    writePod(out, keyLen);
+    writePod(out, int64_t{expire ? expire - now : 0});
+    writePod(out, static_cast<uint32_t>(val.size()));
+    out.write(iter->first, keyLen);
+    out.write(val.data(), val.size());
+    ++entries;
+  }
+  out.flush();
+  Logger::Info("Saved %lu apc entries to snapshot %s",
+               entries, path.c_str());
+  return out.good();
+}
+
+int64_t ConcurrentTableSharedStore::loadSnapshot(const std::string& path,
+                                                 uint64_t offset,
+                                                 uint64_t size) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in.is_open()) return -1;
+  if (offset) in.seekg(offset);
+  char magic[sizeof(kSnapshotMagic)];
+  in.read(magic, sizeof(magic));
+  if (in.gcount() != sizeof(magic) ||
+      memcmp(magic, kSnapshotMagic, sizeof(magic)) != 0) {
+    Logger::Error("Invalid apc snapshot file %s", path.c_str());
+    return -1;
+  }
+
+  // With an explicit size (snapshot embedded in a larger file), the end of
+  // the snapshot is the end of the window rather than the end of the file.
+  auto remaining = size ? size - sizeof(kSnapshotMagic)
+                        : std::numeric_limits<uint64_t>::max();
+  constexpr uint64_t kEntryHeader =
+    sizeof(uint32_t) + sizeof(int64_t) + sizeof(uint32_t);
+
+  int64_t restored = 0;
+  std::vector<char> buf;
+  while (true) {
+    if (remaining == 0) break;          // clean end of window
+    if (remaining != std::numeric_limits<uint64_t>::max() &&
+        remaining < kEntryHeader) {
+      Logger::Error("Truncated apc snapshot file %s", path.c_str());
+      break;
+    }
+    uint32_t keyLen;
+    if (!readPod(in, keyLen)) break;    // clean end of file
+    int64_t ttl;
+    uint32_t valLen;
+    if (!readPod(in, ttl) || !readPod(in, valLen)) {
+      Logger::Error("Truncated apc snapshot file %s", path.c_str());
+      break;
+    }
+    if (remaining != std::numeric_limits<uint64_t>::max()) {
+      if (remaining - kEntryHeader < size_t{keyLen} + size_t{valLen}) {
+        Logger::Error("Truncated apc snapshot file %s", path.c_str());
+        break;
+      }
+      remaining -= kEntryHeader + size_t{keyLen} + size_t{valLen};
+    }
+    buf.resize(size_t{keyLen} + size_t{valLen});
+    in.read(buf.data(), buf.size());
+    if (in.gcount() != static_cast<std::streamsize>(buf.size())) {
+      Logger::Error("Truncated apc snapshot file %s", path.c_str());
+      break;
+    }
+    auto const key = String(buf.data(), keyLen, CopyString);
+    try {
+      auto const val = apc_unserialize(buf.data() + keyLen, valLen);
+      if (!val.isInitialized()) continue;
+      // add() skips keys that are already live, so a snapshot never
+      // clobbers entries stored before it was loaded.
+      if (add(key, val, ttl, 0)) ++restored;
+    } catch (...) {
+      continue;
+    }
+  }
+  Logger::Info("Restored %lld apc entries from snapshot %s",
+               (long long)restored, path.c_str());
+  return restored;
+}
+
 void ConcurrentTableSharedStore::dumpKeyAndValue(std::ostream & out) {
   SharedMutex::WriteHolder l(m_lock);
   out << "Total " << m_vars.size() << std::endl;
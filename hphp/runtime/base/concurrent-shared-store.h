@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <utility>
 #include <vector>
@@ -196,6 +197,18 @@ struct ConcurrentTableSharedStore {
    */
   bool get(const String& key, Variant& value);
 
+  /*
+   * Batched form of get().  Looks up every key in `keys', holding the
+   * global read lock once for the whole batch and deferring
+   * handle-to-local conversions that may reenter the VM until after the
+   * lock is dropped.  For each key, out[i].first says whether the key was
+   * found, and out[i].second holds its value if so.
+   *
+   * Returns: the number of keys found.
+   */
+  size_t getMulti(const req::vector<String>& keys,
+                  req::vector<std::pair<bool,Variant>>& out);
+
   /*
    * Add a value to the store if no (unexpired) value with this key is already
    * present.
@@ -265,6 +278,14 @@ struct ConcurrentTableSharedStore {
   void purgeExpired();
   void purgeDeferred(req::vector<StringData*>&&);
 
+  /*
+   * Compress values that have not been read recently (see
+   * Server.APC.ColdCompressionAgeSeconds), replacing their handles with
+   * zstd-compressed serialized blobs. Cold reads decompress transparently
+   * in get(). Called periodically, like purgeExpired.
+   */
+  void compressCold();
+
   /*
    * Clear the entire APC table.
    */
@@ -275,6 +296,26 @@ struct ConcurrentTableSharedStore {
    */
   void init();
 
+  /*
+   * Warm-restart snapshots.
+   *
+   * saveSnapshot writes every live, serializable entry (key, remaining
+   * TTL, and value in apc-serialized form) to `path`. loadSnapshot reads
+   * such a file back and primes the store, skipping keys that are already
+   * present, so a restarted server comes up with a hot cache instead of
+   * rebuilding it from its backends.
+   *
+   * saveSnapshot returns true if the file was written; loadSnapshot
+   * returns the number of entries restored, or -1 if the file could not
+   * be read.  A non-zero offset/size reads the snapshot from that window
+   * of the file, for snapshots embedded in a container such as a
+   * jumpstart bundle.
+   */
+  bool saveSnapshot(const std::string& path);
+  int64_t loadSnapshot(const std::string& path,
+                       uint64_t offset = 0,
+                       uint64_t size = 0);
+
   /*
    * Debugging.  Dump information about the table to an output stream.
    *
@@ -387,6 +428,8 @@ private:
 private:
   bool checkExpire(const String& keyStr, Map::const_accessor& acc);
   bool eraseImpl(const char*, bool, int64_t, ExpSet::accessor* expAcc);
+  void sampleAccess(intptr_t ikey);
+  void maybeUncompress(intptr_t ikey, const StoreValue* sval);
   bool storeImpl(const String&, const Variant&, int64_t, int64_t, bool);
   bool handlePromoteObj(const String&, APCHandle*, const Variant&);
   void dumpKeyAndValue(std::ostream&);
@@ -396,17 +439,22 @@ private:
   Map m_vars;
   folly::SharedMutex m_lock;
   /*
-   * m_expQueue is a queue of keys to be expired. We purge items from
-   * it every n (configurable) apc_stores.
+   * m_expQueues is a sharded set of queues of keys to be expired. We
+   * purge items from it every n (configurable) apc_stores.
+   *
+   * Keys are spread over the shards by their address, and each purge
+   * drains at most one shard, so no single request pays for a global
+   * sweep when a TTL wave comes due; the shards are purged round-robin
+   * by successive purge calls, each on its own PurgeInterval clock.
    *
-   * We can't (easily) remove items from m_expQueue, so if we add a
-   * new entry every time an item is updated we could end up with a
+   * We can't (easily) remove items from an expiry queue, so if we add
+   * a new entry every time an item is updated we could end up with a
    * lot of copies of the same key in the queue. To avoid that, we use
    * m_expSet, and only add an entry to the queue if there isn't one
    * already.
    *
    * In the current implementation, that means that if an element is
-   * updated before it expires, when its entry in m_expQueue is
+   * updated before it expires, when its entry in its expiry queue is
    * processed, it does nothing; except being put back into the queue
    * again with the new expiry time.
    *
@@ -414,19 +462,39 @@ private:
    * m_expSet, and as the identifier in ExpirationPair. We ensure that
    * the m_expSet entry is removed before the apc key is freed, and
    * guarantee that the key is valid as a char* if it exists in
-   * m_expSet. If the entry subsequently pops off m_expQueue, we check
-   * to see if its in m_expSet, and only try to purge it from apc if
-   * its found.
+   * m_expSet. If the entry subsequently pops off its expiry queue, we
+   * check to see if its in m_expSet, and only try to purge it from apc
+   * if its found.
    *
    * Note that its possible that the apc key was freed and
-   * reallocated, and the entry in m_expQueue doesn't correspond to
-   * the new key; but thats fine - if the key really has expired, it
+   * reallocated, and the entry in the expiry queue doesn't correspond
+   * to the new key; but thats fine - if the key really has expired, it
    * will be purged, and if not, nothing will happen.
    */
-  tbb::concurrent_priority_queue<ExpirationPair,
-                                 ExpirationCompare> m_expQueue;
+  static constexpr size_t kNumExpQueueShards = 16;
+  using ExpQueue = tbb::concurrent_priority_queue<ExpirationPair,
+                                                  ExpirationCompare>;
+  static size_t expShard(intptr_t ikey) {
+    // Keys are malloc'd; shift past allocator alignment before sharding.
+    return (uintptr_t(ikey) >> 6) % kNumExpQueueShards;
+  }
+  std::array<ExpQueue, kNumExpQueueShards> m_expQueues;
+  std::array<std::atomic<time_t>, kNumExpQueueShards> m_lastPurgeTimes{};
+  std::atomic<size_t> m_nextPurgeShard{0};
   ExpSet m_expSet;
-  std::atomic<time_t> m_lastPurgeTime{0};
+
+  /*
+   * Cold-value compression tier. m_accessTimes holds sampled last-read
+   * timestamps keyed by the apc key's address (like m_expSet); m_coldSet
+   * marks entries whose handle currently holds a compressed blob. Both are
+   * cleaned up when their entry is erased or overwritten, and m_coldSet is
+   * the arbiter of which reader performs the decompressing swap.
+   */
+  using AccessMap = tbb::concurrent_hash_map<intptr_t,uint32_t>;
+  AccessMap m_accessTimes;
+  ExpSet m_coldSet;
+  std::atomic<time_t> m_lastColdScan{0};
+  std::atomic<uint64_t> m_accessSampleCounter{0};
 };
 
 //////////////////////////////////////////////////////////////////////
@@ -16,14 +16,23 @@
 
 #include "hphp/runtime/base/config.h"
 
+#include <climits>
+#include <cstdlib>
 #include <fstream>
 #include <sstream>
 
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/erase.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/filesystem.hpp>
 
+#include <folly/Conv.h>
+#include <folly/Optional.h>
+#include <folly/String.h>
+
 #include "hphp/runtime/base/ini-setting.h"
 #include "hphp/runtime/base/array-iterator.h"
 #include "hphp/runtime/base/preg.h"
@@ -173,8 +182,197 @@ void Config::ReplaceIncludesWithIni(const std::string& original_ini_filename,
   }
 }
 
+namespace {
+
+/*
+ * Pre-parsed HDF config cache.
+ *
+ * Parsing an HDF file walks its #include graph and builds the neo tree node
+ * by node, which shows up on the boot profile of short-lived (CLI) processes
+ * that all read the same config. When HHVM_HDF_CACHE_DIR is set we keep a
+ * per-config cache file holding (a) stamps of the config file and every file
+ * it transitively includes and (b) the fully-expanded dump of the parsed
+ * tree. On a warm launch with matching stamps we skip the include traversal
+ * entirely and rehydrate the tree from the single flattened dump. Any
+ * mismatch or I/O hiccup silently falls back to the normal text parse, which
+ * also rewrites the cache.
+ *
+ * The neo HDF tree is a malloc'd pointer graph, so the dump is stored as
+ * parseable HDF text rather than an mmap-able image; the win is collapsing
+ * many file reads and the include resolution into one read.
+ */
+
+struct HdfSourceStamp {
+  std::string path;
+  int64_t mtime;   // -1 if the file does not exist
+  int64_t size;
+};
+
+void stampHdfSource(const std::string& path, HdfSourceStamp& stamp) {
+  stamp.path = path;
+  struct stat s;
+  if (::stat(path.c_str(), &s) == 0) {
+    stamp.mtime = static_cast<int64_t>(s.st_mtime);
+    stamp.size = static_cast<int64_t>(s.st_size);
+  } else {
+    stamp.mtime = -1;
+    stamp.size = -1;
+  }
+}
+
+/*
+ * Collect stamps for `filename` and everything it transitively includes.
+ * This mirrors neo's directive handling: both `#include file` and the
+ * optional `-include file` are followed, the name may be bare or
+ * surrounded by double quotes (neos_strip semantics), and relative paths
+ * are resolved against the directory of the including file (or the cwd
+ * when the including path has no directory component). Files that do not
+ * exist are stamped too, so a config that later gains an optional include
+ * invalidates the cache. Returns false if any include line cannot be
+ * resolved; a cache written from an incomplete stamp list would never be
+ * invalidated by edits to the files it missed.
+ */
+bool collectHdfSources(const std::string& filename, int depth,
+                       std::vector<HdfSourceStamp>& out) {
+  out.emplace_back();
+  stampHdfSource(filename, out.back());
+  if (out.back().mtime == -1) {
+    return true;
+  }
+  if (depth > 50) {
+    return false;
+  }
+  std::ifstream ifs(filename);
+  std::string line;
+  while (std::getline(ifs, line)) {
+    auto pos = line.find_first_not_of(" \t");
+    if (pos == std::string::npos ||
+        (line.compare(pos, strlen("#include "), "#include ") != 0 &&
+         line.compare(pos, strlen("-include "), "-include ") != 0)) {
+      continue;
+    }
+    pos += strlen("#include ");
+    auto start = line.find_first_not_of(" \t", pos);
+    auto end = line.find_last_not_of(" \t\r");
+    if (start == std::string::npos || end < start) {
+      return false;
+    }
+    std::string file = line.substr(start, end - start + 1);
+    if (file.size() >= 2 && file.front() == '"' && file.back() == '"') {
+      file = file.substr(1, file.size() - 2);
+    }
+    if (file.empty()) {
+      return false;
+    }
+    if (file[0] != '/') {
+      auto slash = filename.rfind('/');
+      if (slash == std::string::npos) {
+        char pwd[PATH_MAX];
+        if (::getcwd(pwd, sizeof(pwd)) == nullptr) return false;
+        file = std::string(pwd) + "/" + file;
+      } else {
+        file = filename.substr(0, slash + 1) + file;
+      }
+    }
+    if (!collectHdfSources(file, depth + 1, out)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string hdfCachePath(const char* cacheDir, const std::string& filename) {
+  auto abs = boost::filesystem::absolute(filename).string();
+  return std::string(cacheDir) + "/" +
+    folly::to<std::string>(std::hash<std::string>{}(abs)) + ".hdfc";
+}
+
+const char* const kHdfCacheMagic = "hhvm.hdf.cache.1";
+
+/*
+ * Return the flattened HDF dump stored in `cachePath` if its recorded
+ * source stamps still match the filesystem, folly::none otherwise.
+ */
+folly::Optional<std::string> readHdfCache(const std::string& cachePath) {
+  std::ifstream ifs(cachePath);
+  if (!ifs) return folly::none;
+  std::string line;
+  if (!std::getline(ifs, line) || line != kHdfCacheMagic) return folly::none;
+  if (!std::getline(ifs, line)) return folly::none;
+  int64_t nsources;
+  try {
+    nsources = folly::to<int64_t>(line);
+  } catch (const std::range_error&) {
+    return folly::none;
+  }
+  for (int64_t i = 0; i < nsources; ++i) {
+    if (!std::getline(ifs, line)) return folly::none;
+    int64_t mtime, size;
+    folly::StringPiece path;
+    if (!folly::split('\t', line, mtime, size, path)) return folly::none;
+    HdfSourceStamp now;
+    stampHdfSource(path.str(), now);
+    if (now.mtime != mtime || now.size != size) return folly::none;
+  }
+  std::string payload((std::istreambuf_iterator<char>(ifs)),
+                      std::istreambuf_iterator<char>());
+  return payload;
+}
+
+void writeHdfCache(const std::string& cachePath, const std::string& filename,
+                   const std::string& dump) {
+  std::vector<HdfSourceStamp> sources;
+  if (!collectHdfSources(filename, 0, sources)) {
+    // Better no cache than one that can go stale: without a complete stamp
+    // list, edits to an unresolved include would never invalidate it.
+    Logger::Warning("not caching hdf %s: unresolvable include",
+                    filename.c_str());
+    return;
+  }
+  std::string out = kHdfCacheMagic;
+  out += "\n";
+  out += folly::to<std::string>(sources.size());
+  out += "\n";
+  for (auto const& s : sources) {
+    folly::toAppend(s.mtime, '\t', s.size, '\t', s.path, '\n', &out);
+  }
+  out += dump;
+  // Write-then-rename so a concurrent launch never sees a torn cache.
+  auto const tmp =
+    cachePath + ".tmp." + folly::to<std::string>(::getpid());
+  std::ofstream ofs(tmp, std::ios::trunc);
+  ofs << out;
+  ofs.close();
+  if (!ofs || ::rename(tmp.c_str(), cachePath.c_str()) != 0) {
+    Logger::Warning("failed to write hdf cache %s", cachePath.c_str());
+    ::unlink(tmp.c_str());
+  }
+}
+
+}
+
 void Config::ParseHdfFile(const std::string &filename, Hdf &hdf) {
-  hdf.append(filename);
+  auto const cacheDir = ::getenv("HHVM_HDF_CACHE_DIR");
+  if (cacheDir == nullptr || *cacheDir == '\0') {
+    hdf.append(filename);
+    return;
+  }
+  auto const cachePath = hdfCachePath(cacheDir, filename);
+  if (auto const payload = readHdfCache(cachePath)) {
+    try {
+      hdf.fromString(payload->c_str());
+      return;
+    } catch (const HdfException&) {
+      Logger::Warning("corrupt hdf cache %s; reparsing", cachePath.c_str());
+    }
+  }
+  // Parse into a scratch tree so the cached dump only covers this file's
+  // contents even when `hdf` already holds earlier config.
+  Hdf fresh;
+  fresh.append(filename);
+  std::string dump = fresh.toString();
+  hdf.fromString(dump.c_str());
+  writeHdfCache(cachePath, filename, dump);
 }
 
 void Config::SetParsedIni(IniSettingMap &ini, const std::string confStr,
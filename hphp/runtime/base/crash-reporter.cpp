@@ -55,6 +55,7 @@ std::atomic<pid_t> CrashingThread{};
 
 enum class CrashReportStage {
   DumpRingBuffer,
+  DumpFlightRecorder,
   SpinOnCrash,
   CheckFD,
   CreateCppStack,
@@ -123,12 +124,20 @@ static void bt_handler(int sigin, siginfo_t* info, void* args) {
 
   switch (s_crash_report_stage) {
     case CrashReportStage::DumpRingBuffer:
-      s_crash_report_stage = CrashReportStage::SpinOnCrash;
+      s_crash_report_stage = CrashReportStage::DumpFlightRecorder;
 
       if (RuntimeOption::EvalDumpRingBufferOnCrash) {
         Trace::dumpRingBuffer(RuntimeOption::EvalDumpRingBufferOnCrash, 0);
       }
       // fall through
+    case CrashReportStage::DumpFlightRecorder:
+      s_crash_report_stage = CrashReportStage::SpinOnCrash;
+
+      if (RuntimeOption::EvalDumpFlightRecorderOnCrash) {
+        Trace::dumpFlightRecorder(
+          RuntimeOption::EvalDumpFlightRecorderOnCrash);
+      }
+      // fall through
     case CrashReportStage::SpinOnCrash:
       s_crash_report_stage = CrashReportStage::CheckFD;
       if (RuntimeOption::EvalSpinOnCrash) {
@@ -324,6 +333,13 @@ void install_crash_reporter() {
   // bt_handler.  Don't install our handler when running with tsan.
   if (use_tsan) return;
 
+  // Start mirroring ringbuffer writes into per-thread flight recorders, so
+  // bt_handler can dump every thread's recent history, not just whatever
+  // survives in the shared ring.
+  if (RuntimeOption::EvalDumpFlightRecorderOnCrash) {
+    Trace::enableFlightRecorder(true);
+  }
+
 #ifdef _MSC_VER
   signal(SIGILL,  bt_handler);
   signal(SIGFPE,  bt_handler);
@@ -318,9 +318,10 @@ void throwable_init(ObjectData* throwable) {
 
   auto const trace_lval = throwable->propLvalAtOffset(s_traceSlot);
   auto const opts = exception_get_trace_options();
-  auto trace = HHVM_FN(debug_backtrace)(opts);
-  auto tv = make_array_like_tv(trace.detach());
-  tvMove(tv, trace_lval);
+  // When the options permit a compact capture this stores a CompactTrace
+  // resource; it is only symbolized into an array when the trace is
+  // inspected (getTrace() et al. go through __SystemLib\extract_trace).
+  tvMove(debug_backtrace_jit(opts), trace_lval);
 
   VMRegAnchor _;
   auto const fp = vmfp();
@@ -40,6 +40,7 @@
 #include "hphp/runtime/base/builtin-functions.h"
 #include "hphp/runtime/base/comparisons.h"
 #include "hphp/runtime/base/program-functions.h"
+#include "hphp/runtime/base/request-tracing.h"
 #include "hphp/runtime/base/runtime-option.h"
 #include "hphp/runtime/base/tv-refcount.h"
 #include "hphp/runtime/base/tv-type.h"
@@ -1491,6 +1492,14 @@ void ExecutionContext::requestExit() {
 
   if (Logger::UseRequestLog) Logger::SetThreadHook(nullptr);
   if (m_requestTrace) record_trace(std::move(*m_requestTrace));
+  if (rqtrace::ring::enabled()) {
+    uint64_t wallMicro = 0;
+    if (auto const transport = getTransport()) {
+      wallMicro = rqtrace::detail::CurrentMicroTime() -
+        rqtrace::detail::to_micros(transport->getWallTime());
+    }
+    rqtrace::ring::requestExit(wallMicro);
+  }
   if (!RO::RepoAuthoritative) m_requestStartForTearing.reset();
 }
 
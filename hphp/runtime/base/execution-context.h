@@ -632,6 +632,11 @@ private:
   Array m_debuggerEnv; // variables read/written in the REPL
 public:
   req::vector<ImplicitContext*> m_implicitContexts;
+  // Memoizes (base context, key, value) transitions so repeated sets of the
+  // same data reuse the immutable context version already built instead of
+  // allocating a new one
+  req::fast_map<const StringData*, ImplicitContext*,
+                string_data_hash, string_data_same> m_implicitContextTransitions;
 
   VMParserFrame* m_parserFrame{nullptr};
 
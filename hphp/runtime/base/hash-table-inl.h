@@ -219,8 +219,9 @@ TypedValue HashTable<ArrayType, ElmType>::NvGetInt(const ArrayData* ad,
   return LIKELY(validPos(i)) ? *a->data()[i].datatv() : make_tv<KindOfUninit>();
 }
 
-#ifndef USE_X86_STRING_HELPERS
-// This function is implemented directly in ASM in hash-table-x64.S otherwise.
+#if !defined(USE_X86_STRING_HELPERS) && !defined(USE_ARM_STRING_HELPERS)
+// This function is implemented directly in ASM in hash-table-x64.S or
+// hash-table-arm.S otherwise.
 template<typename ArrayType, typename ElmType>
 TypedValue HashTable<ArrayType, ElmType>::NvGetStr(const ArrayData* ad,
                                                    const StringData* k) {
@@ -229,7 +230,7 @@ TypedValue HashTable<ArrayType, ElmType>::NvGetStr(const ArrayData* ad,
   return LIKELY(validPos(i)) ? *a->data()[i].datatv() : make_tv<KindOfUninit>();
 }
 #else
-  // hash-table-x64.S depends on StringData and ArrayType layout.
+  // The NvGetStr kernels depend on StringData and ArrayType layout.
   // If these fail, update the constants
   static_assert(sizeof(StringData) == SD_DATA, "");
   static_assert(StringData::sizeOff() == SD_LEN, "");
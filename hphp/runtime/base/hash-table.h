@@ -20,11 +20,12 @@
 #include "hphp/runtime/base/string-data.h"
 #include "hphp/runtime/base/tv-uncounted.h"
 
-// NvGetStr is implemented in assembly in hash-table-x64.S, additional macros
-// are defined for various offsets in hash-table-x64.h
+// NvGetStr is implemented in assembly in hash-table-x64.S (and its AArch64
+// port hash-table-arm.S), additional macros are defined for various offsets
+// in hash-table-x64.h
 // Types inheriting from HashTable should add this macro to statically verify
 // the offsets are correct.
-#ifdef USE_X86_STRING_HELPERS
+#if defined(USE_X86_STRING_HELPERS) || defined(USE_ARM_STRING_HELPERS)
 
 #define HASH_TABLE_CHECK_OFFSETS(ArrayType, ElmType) \
   static_assert(ArrayType::dataOff() == ArrayType ## _DATA, ""); \
@@ -59,6 +60,16 @@ struct HashTableCommon {
   static constexpr uint32_t LoadScale = 4;
 
   // Element index, with special values < 0 used for hash tables.
+  //
+  // Note on the probe scheme: each slot is a bare int32_t element index;
+  // the hash "tag" a probe is filtered on lives in the Elm itself (every
+  // probe compares the full 31-bit cached hash before touching the key, in
+  // both findImpl() and hash-table-x64.S). A SwissTable-style SIMD group
+  // probe would need tags stored alongside the slots, i.e. a different
+  // table layout -- one that is currently baked into HashSize()/Mask(),
+  // the assembly NvGetStr kernels, and the JIT's inlined array-access
+  // paths. Any alternate small-table layout has to change all three
+  // together; don't try to bolt group probing onto this one.
   static constexpr int32_t Empty      = -1;
   static constexpr int32_t Tombstone  = -2;
 
@@ -218,8 +229,9 @@ struct HashTable : HashTableCommon {
   }
 
   static ALWAYS_INLINE
-  ArrayType* uncountedAlloc(uint32_t scale, size_t extra = 0) {
-    auto const size = computeAllocBytes(scale) + extra;
+  ArrayType* uncountedAlloc(uint32_t scale, size_t extra = 0,
+                            size_t trailing = 0) {
+    auto const size = computeAllocBytes(scale) + extra + trailing;
     auto const mem = AllocUncounted(size);
     return reinterpret_cast<ArrayType*>(reinterpret_cast<char*>(mem) + extra);
   }
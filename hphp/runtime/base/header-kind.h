@@ -232,6 +232,13 @@ public:
   HeaderKind kind() const { return m_kind; }
   GCBits marks() const { return m_marks; }
   void setmarks(GCBits m) const { m_marks = m; }
+  // Atomically set the mark bits, returning true if this call changed them,
+  // i.e. the caller claimed the object. Used by the parallel marker, where
+  // several threads may race to mark the same object.
+  bool casmarks(GCBits m) const {
+    auto const bits = reinterpret_cast<std::atomic<uint8_t>*>(&m_marks);
+    return bits->exchange(uint8_t(m), std::memory_order_relaxed) != uint8_t(m);
+  }
 };
 static_assert(sizeof(HeapObject) == sizeof(uint64_t),
               "HeapObject is expected to be 8 bytes.");
@@ -34,6 +34,8 @@
 #include <folly/portability/Unistd.h>
 #include <folly/Range.h>
 #include <iterator>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 namespace HPHP {
@@ -89,6 +91,11 @@ constexpr auto MaxMark = GCBits(3);
  *
  * Eval.TwoPhaseGC - perform tracing in two phases, the second of which
  * must only encounter exactly-scanned pointers, to enable object copying.
+ *
+ * Eval.GCParallelMark - If true, the one-phase marker drains its worklists
+ * with Eval.GCParallelMarkWorkers work-stealing threads, once the heap has
+ * grown past Eval.GCParallelMarkMinHeap bytes. Roots are still scanned on
+ * the collecting thread.
  */
 
 /*
@@ -115,6 +122,16 @@ struct Collector {
   void exactEnqueue(const void* p);
   HeapObject* find(const void*);
 
+  // Warm the cache lines find(ptr) will touch; used to overlap the misses
+  // of a batch of candidate pointers during conservative scanning.
+  void prefetchFind(const void* ptr) {
+    if (uintptr_t(ptr) - uintptr_t(slabs_range_.ptr) < slabs_range_.size) {
+      __builtin_prefetch(Slab::fromPtr(ptr));
+    } else {
+      ptrs_.prefetch(ptr);
+    }
+  }
+
   size_t slab_index(const void* h) {
     assertx((char*)h >= (char*)slabs_range_.ptr &&
            (char*)h < (char*)slabs_range_.ptr + slabs_range_.size);
@@ -252,15 +269,24 @@ void Collector::exactEnqueue(const void* p) {
 void FOLLY_DISABLE_ADDRESS_SANITIZER
 Collector::conservativeScan(const void* start, size_t len) {
   constexpr uintptr_t M{7}; // word size - 1
+  // Mask off the upper 16-bits to handle things like
+  // DiscriminatedPtr which stores things up there.
+  constexpr uintptr_t PtrMask{-1ULL >> 16};
   auto s = (char**)((uintptr_t(start) + M) & ~M); // round up
   auto e = (char**)((uintptr_t(start) + len) & ~M); // round down
   cscanned_ += uintptr_t(e) - uintptr_t(s);
-  for (; s < e; s++) {
-    checkedEnqueue(
-      // Mask off the upper 16-bits to handle things like
-      // DiscriminatedPtr which stores things up there.
-      (void*)(uintptr_t(*s) & (-1ULL >> 16))
-    );
+  // Classify candidates a batch at a time: issue the lookup prefetches for
+  // the whole batch first so the enqueue pass overlaps their cache misses.
+  constexpr ptrdiff_t kBatch = 8;
+  while (s < e) {
+    auto const n = std::min(e - s, kBatch);
+    for (ptrdiff_t i = 0; i < n; ++i) {
+      prefetchFind((void*)(uintptr_t(s[i]) & PtrMask));
+    }
+    for (ptrdiff_t i = 0; i < n; ++i) {
+      checkedEnqueue((void*)(uintptr_t(s[i]) & PtrMask));
+    }
+    s += n;
   }
 }
 
@@ -311,6 +337,197 @@ NEVER_INLINE void Collector::init() {
   ptrs_.prepare();
 }
 
+/*
+ * Work-stealing parallel drain of the mark queues, used by traceAll() on
+ * large heaps. Roots have already been scanned single-threaded; each worker
+ * claims objects via an atomic exchange on the mark byte, scans them with a
+ * private type_scan::Scanner, and rebalances through a shared overflow queue
+ * guarded by a mutex. Weak refs and counters are merged back into the
+ * collector once all workers finish.
+ */
+struct ParallelMarker {
+  explicit ParallelMarker(Collector& c) : c_(c) {}
+
+  void run() {
+    nworkers_ = std::max(1u, std::min(
+      RuntimeOption::EvalGCParallelMarkWorkers,
+      std::thread::hardware_concurrency()));
+    std::vector<Worker> workers(nworkers_);
+    // Seed workers round-robin from the sequential root-scan queues.
+    distribute(c_.cwork_, workers, &Worker::cwork);
+    distribute(c_.xwork_, workers, &Worker::xwork);
+    std::vector<std::thread> threads;
+    threads.reserve(nworkers_ - 1);
+    for (auto i = 1u; i < nworkers_; ++i) {
+      threads.emplace_back([this, &workers, i] { workerMain(workers[i]); });
+    }
+    workerMain(workers[0]); // the collecting thread participates
+    for (auto& t : threads) t.join();
+    for (auto& w : workers) {
+      c_.marked_ += w.marked;
+      c_.cscanned_.count += w.cscanned.count;
+      c_.cscanned_.bytes += w.cscanned.bytes;
+      c_.xscanned_.count += w.xscanned.count;
+      c_.xscanned_.bytes += w.xscanned.bytes;
+      // Weak refs accumulate until sweep(), like in the serial marker.
+      auto& weak = c_.type_scanner_.m_weak;
+      weak.insert(weak.end(), w.scanner.m_weak.begin(), w.scanner.m_weak.end());
+      w.scanner.m_weak.clear();
+    }
+  }
+
+ private:
+  static constexpr size_t kShareBatch = 64;
+
+  struct Worker {
+    std::vector<const HeapObject*> cwork, xwork;
+    type_scan::Scanner scanner;
+    size_t marked{0};
+    Counter cscanned, xscanned;
+  };
+
+  static void distribute(std::vector<const HeapObject*>& from,
+                         std::vector<Worker>& workers,
+                         std::vector<const HeapObject*> Worker::*queue) {
+    size_t i = 0;
+    for (auto h : from) {
+      (workers[i++ % workers.size()].*queue).push_back(h);
+    }
+    from.clear();
+  }
+
+  void enqueue(Worker& w, const void* p) {
+    if (auto h = c_.find(p)) {
+      if (h->casmarks(c_.mark_version_)) {
+        ++w.marked;
+        auto& work = willScanConservative(h) ? w.cwork : w.xwork;
+        work.push_back(h);
+        assertx(checkEnqueuedKind(h));
+      }
+    }
+  }
+
+  void FOLLY_DISABLE_ADDRESS_SANITIZER
+  conservativeScan(Worker& w, const void* start, size_t len) {
+    constexpr uintptr_t M{7}; // word size - 1
+    // Mask off the upper 16-bits; see Collector::conservativeScan().
+    constexpr uintptr_t PtrMask{-1ULL >> 16};
+    auto s = (char**)((uintptr_t(start) + M) & ~M); // round up
+    auto e = (char**)((uintptr_t(start) + len) & ~M); // round down
+    w.cscanned += uintptr_t(e) - uintptr_t(s);
+    constexpr ptrdiff_t kBatch = 8;
+    while (s < e) {
+      auto const n = std::min(e - s, kBatch);
+      for (ptrdiff_t i = 0; i < n; ++i) {
+        c_.prefetchFind((void*)(uintptr_t(s[i]) & PtrMask));
+      }
+      for (ptrdiff_t i = 0; i < n; ++i) {
+        enqueue(w, (void*)(uintptr_t(s[i]) & PtrMask));
+      }
+      s += n;
+    }
+  }
+
+  void drainScanner(Worker& w) {
+    for (auto r : w.scanner.m_conservative) {
+      conservativeScan(w, r.first, r.second);
+    }
+    w.scanner.m_conservative.clear();
+    for (auto addr : w.scanner.m_addrs) {
+      w.xscanned += sizeof(*addr);
+      enqueue(w, *addr);
+    }
+    w.scanner.m_addrs.clear();
+  }
+
+  static void moveBatch(std::vector<const HeapObject*>& from,
+                        std::vector<const HeapObject*>& to) {
+    auto const n = std::min(from.size(), kShareBatch);
+    to.insert(to.end(), from.end() - n, from.end());
+    from.resize(from.size() - n);
+  }
+
+  bool hasShared() const {
+    return shared_size_.load(std::memory_order_acquire) != 0;
+  }
+
+  bool takeShared(Worker& w) {
+    std::lock_guard<std::mutex> g(lock_);
+    if (shared_c_.empty() && shared_x_.empty()) return false;
+    moveBatch(shared_c_, w.cwork);
+    moveBatch(shared_x_, w.xwork);
+    shared_size_.store(shared_c_.size() + shared_x_.size(),
+                       std::memory_order_release);
+    return true;
+  }
+
+  // Donate the older half of the larger local queue when other workers may
+  // be starving.
+  void maybeShare(Worker& w) {
+    if (w.cwork.size() + w.xwork.size() < 2 * kShareBatch) return;
+    if (shared_size_.load(std::memory_order_acquire) >= kShareBatch) return;
+    if (!lock_.try_lock()) return;
+    auto const useC = w.cwork.size() >= w.xwork.size();
+    auto& from = useC ? w.cwork : w.xwork;
+    auto& to = useC ? shared_c_ : shared_x_;
+    auto const n = from.size() / 2;
+    to.insert(to.end(), from.begin(), from.begin() + n);
+    from.erase(from.begin(), from.begin() + n);
+    shared_size_.store(shared_c_.size() + shared_x_.size(),
+                       std::memory_order_release);
+    lock_.unlock();
+  }
+
+  // Called with empty local queues. Return true once work was stolen, or
+  // false when every worker is idle and the shared queue is empty, which
+  // terminates marking: donations only come from non-idle workers.
+  bool waitForWork(Worker& w) {
+    for (;;) {
+      auto const idle = idle_.fetch_add(1, std::memory_order_acq_rel) + 1;
+      if (idle == nworkers_) {
+        std::lock_guard<std::mutex> g(lock_);
+        if (shared_c_.empty() && shared_x_.empty()) {
+          done_.store(true, std::memory_order_release);
+        }
+      }
+      while (!done_.load(std::memory_order_acquire) && !hasShared()) {
+        std::this_thread::yield();
+      }
+      if (done_.load(std::memory_order_acquire)) return false;
+      idle_.fetch_sub(1, std::memory_order_acq_rel);
+      if (takeShared(w)) return true;
+      // Raced with another worker for the shared queue; go idle again.
+    }
+  }
+
+  void workerMain(Worker& w) {
+    do {
+      while (!w.cwork.empty() || !w.xwork.empty()) {
+        auto& work = !w.cwork.empty() ? w.cwork : w.xwork;
+        auto const h = work.back();
+        work.pop_back();
+        scanHeapObject(h, w.scanner);
+        drainScanner(w);
+        maybeShare(w);
+      }
+    } while (takeShared(w) || waitForWork(w));
+  }
+
+  Collector& c_;
+  std::mutex lock_;
+  std::vector<const HeapObject*> shared_c_, shared_x_;
+  std::atomic<size_t> shared_size_{0};
+  std::atomic<uint32_t> idle_{0};
+  std::atomic<bool> done_{false};
+  uint32_t nworkers_{1};
+};
+
+bool shouldMarkParallel() {
+  return RuntimeOption::EvalGCParallelMark &&
+         RuntimeOption::EvalGCParallelMarkWorkers > 1 &&
+         tl_heap->currentUsage() >= RuntimeOption::EvalGCParallelMarkMinHeap;
+}
+
 // Collect the heap using mark/sweep.
 //
 // Init: prepare object-start bitmaps, and mark/enqueue unknown allocations.
@@ -437,12 +654,16 @@ NEVER_INLINE void Collector::traceAll() {
   roots_ns_ += t1 - t0;
   cscanned_roots_ = cscanned_;
   xscanned_roots_ = xscanned_;
-  while (!cwork_.empty() || !xwork_.empty()) {
-    auto& work = !cwork_.empty() ? cwork_ : xwork_;
-    auto h = work.back();
-    work.pop_back();
-    scanHeapObject(h, type_scanner_);
-    finish();
+  if (shouldMarkParallel()) {
+    ParallelMarker{*this}.run();
+  } else {
+    while (!cwork_.empty() || !xwork_.empty()) {
+      auto& work = !cwork_.empty() ? cwork_ : xwork_;
+      auto h = work.back();
+      work.pop_back();
+      scanHeapObject(h, type_scanner_);
+      finish();
+    }
   }
   mark_ns_ += cpu_ns() - t1;
   pinned_ = marked_;
@@ -22,6 +22,16 @@
 #include "hphp/runtime/server/server-note.h"
 #include "hphp/util/logger.h"
 
+#include "hphp/util/hash-map.h"
+
+#include <folly/Random.h>
+#include <folly/hash/Hash.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+
 namespace HPHP {
 
 RDS_LOCAL(AllocSamples, s_samples);
@@ -47,7 +57,7 @@ void MemoryManager::checkSampling(size_t bytes) {
   }
   assertx(RuntimeOption::EvalHeapAllocSampleBytes > 0);
   do {
-    m_nextSample += RuntimeOption::EvalHeapAllocSampleBytes;
+    m_nextSample += alloc_sample_gap();
   } while (m_nextSample < allocated);
   // Gather PHP stack later.
   setSurpriseFlag(SurpriseFlag::HeapSamplingFlag);
@@ -102,6 +112,119 @@ void AllocSamples::logSamples() {
   clear();
 }
 
+namespace {
+
+/*
+ * Cross-request leak monitor.
+ *
+ * Requests feed their sampled allocations here at shutdown. Samples are
+ * keyed by allocation site (a hash of the sampled PHP stack) and summed
+ * into fixed-length epochs of Eval.HeapLeakMonitorEpochSecs. Once a site
+ * has a full window of Eval.HeapLeakMonitorWindow epochs, a strictly
+ * increasing sequence of per-epoch totals flags it as a suspected leak via
+ * StructuredLog; sites quiet for a whole window are retired. Sampled bytes
+ * stand in for retained size: per-request heaps are torn down at request
+ * end, so retention can't be measured across requests, but a site whose
+ * sampled allocation volume only ever grows is the request-correlated
+ * signature of fleet RSS creep.
+ */
+struct LeakMonitor {
+  void feed(const AllocSamples& samples) {
+    auto const window =
+      std::max(RuntimeOption::EvalHeapLeakMonitorWindow, 2u);
+    std::lock_guard<std::mutex> g(m_lock);
+    maybeRollEpoch(window);
+    for (auto const& sample : samples) {
+      if (!sample.phpStack) continue;
+      uint64_t hash = 0;
+      for (auto const& frame : sample.phpStack->frames()) {
+        hash = folly::hash::hash_128_to_64(hash,
+                                           frame.func->fullName()->hash());
+      }
+      auto& site = m_sites[hash];
+      if (site.frames.empty()) {
+        unsigned depth = 0;
+        for (auto const& frame : sample.phpStack->frames()) {
+          site.frames.emplace_back(frame.func->fullName()->data());
+          if (++depth >= kMaxFrames) break;
+        }
+      }
+      site.currBytes += sample.size;
+    }
+  }
+
+private:
+  static constexpr unsigned kMaxFrames = 32;
+
+  struct Site {
+    std::vector<std::string> frames; // representative stack for logging
+    std::vector<size_t> epochBytes;  // per-epoch sampled bytes, oldest first
+    size_t currBytes{0};
+  };
+
+  void maybeRollEpoch(unsigned window) {
+    auto const now = std::chrono::steady_clock::now();
+    auto const len =
+      std::chrono::seconds(RuntimeOption::EvalHeapLeakMonitorEpochSecs);
+    if (now < m_epochStart + len) return;
+    m_epochStart = now;
+    for (auto it = m_sites.begin(); it != m_sites.end();) {
+      auto& site = it->second;
+      site.epochBytes.push_back(site.currBytes);
+      site.currBytes = 0;
+      if (site.epochBytes.size() > window) {
+        site.epochBytes.erase(site.epochBytes.begin());
+      }
+      if (site.epochBytes.size() == window) {
+        if (isMonotonicGrower(site.epochBytes)) {
+          logGrower(it->first, site);
+        } else if (std::all_of(site.epochBytes.begin(), site.epochBytes.end(),
+                               [] (size_t b) { return b == 0; })) {
+          it = m_sites.erase(it);
+          continue;
+        }
+      }
+      ++it;
+    }
+  }
+
+  static bool isMonotonicGrower(const std::vector<size_t>& bytes) {
+    for (size_t i = 1; i < bytes.size(); ++i) {
+      if (bytes[i] <= bytes[i - 1]) return false;
+    }
+    return true;
+  }
+
+  void logGrower(uint64_t site_id, const Site& site) {
+    StructuredLogEntry entry;
+    entry.setInt("site", site_id);
+    entry.setInt("epoch_secs", RuntimeOption::EvalHeapLeakMonitorEpochSecs);
+    entry.setInt("window", site.epochBytes.size());
+    entry.setInt("first_epoch_bytes", site.epochBytes.front());
+    entry.setInt("last_epoch_bytes", site.epochBytes.back());
+    std::vector<folly::StringPiece> stack;
+    stack.reserve(site.frames.size());
+    for (auto const& frame : site.frames) stack.emplace_back(frame);
+    entry.setVec("php_stack", stack);
+    StructuredLog::log("hhvm_heap_leak_monitor", entry);
+  }
+
+  std::mutex m_lock;
+  hphp_fast_map<uint64_t, Site> m_sites;
+  std::chrono::steady_clock::time_point m_epochStart{
+    std::chrono::steady_clock::now()};
+};
+
+LeakMonitor s_leakMonitor;
+
+}
+
+void feed_leak_monitor(const AllocSamples& samples) {
+  if (!RuntimeOption::EvalHeapLeakMonitor) return;
+  if (!StructuredLog::enabled()) return;
+  s_leakMonitor.feed(samples);
+}
+
 void gather_alloc_stack(bool skipTop) {
   s_samples->addStack(skipTop);
   clearSurpriseFlag(HeapSamplingFlag);
@@ -111,4 +234,13 @@ void reset_alloc_sampling() {
   s_samples->requestShutdown();
 }
 
+int64_t alloc_sample_gap() {
+  auto const mean = RuntimeOption::EvalHeapAllocSampleBytes;
+  if (!RuntimeOption::EvalHeapAllocPoissonSampling) return mean;
+  // Inverse-CDF draw from the exponential distribution; clamp u away from 0
+  // so log() stays finite.
+  auto const u = std::max(folly::Random::randDouble01(), 1e-20);
+  return std::max<int64_t>(1, int64_t(-std::log(u) * mean));
+}
+
 }
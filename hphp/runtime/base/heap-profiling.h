@@ -33,12 +33,23 @@ struct HeapAllocSample {
   StackTrace nativeStack{false};
 };
 
+struct AllocSamples;
+
+/*
+ * Feed a request's samples into the cross-request leak monitor, which
+ * aggregates sampled bytes by allocation site into fixed-length epochs and
+ * flags sites whose per-epoch totals grow monotonically across the whole
+ * window via StructuredLog. No-op unless Eval.HeapLeakMonitor is set.
+ */
+void feed_leak_monitor(const AllocSamples& samples);
+
 struct AllocSamples : public std::vector<HeapAllocSample,
                                          LocalAllocator<HeapAllocSample>> {
   TYPE_SCAN_IGNORE_ALL;
 
   void requestShutdown() {
     if (empty()) return;
+    feed_leak_monitor(*this);
     logSamples();
     clear();
   }
@@ -51,5 +62,13 @@ struct AllocSamples : public std::vector<HeapAllocSample,
   void logSamples();
 };
 
+/*
+ * Distance, in allocated bytes, to the next sampled allocation. With
+ * Eval.HeapAllocPoissonSampling the gaps are exponentially distributed with
+ * mean Eval.HeapAllocSampleBytes, so sampling is unbiased even for strongly
+ * periodic allocation patterns; otherwise this is the legacy fixed stride.
+ */
+int64_t alloc_sample_gap();
+
 }
 
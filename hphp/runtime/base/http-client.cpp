@@ -19,6 +19,7 @@
 #include "hphp/runtime/server/server-stats.h"
 #include "hphp/runtime/base/curl-tls-workarounds.h"
 #include "hphp/runtime/base/execution-context.h"
+#include "hphp/runtime/ext/curl/curl-connection-pool.h"
 #include "hphp/util/timer.h"
 #include <curl/easy.h>
 #include <vector>
@@ -145,6 +146,7 @@ int HttpClient::request(const char* verb,
   curl_easy_setopt(cp, CURLOPT_NOSIGNAL,          1);
   curl_easy_setopt(cp, CURLOPT_DNS_USE_GLOBAL_CACHE, 0); // for thread-safe
   curl_easy_setopt(cp, CURLOPT_DNS_CACHE_TIMEOUT, 120);
+  CurlConnectionPool::Attach(cp);
   curl_easy_setopt(cp, CURLOPT_NOSIGNAL, 1); // for multithreading mode
   curl_easy_setopt(cp, CURLOPT_SSL_VERIFYPEER,    1);
   // For libcurl the VERIFYHOST "true"/enabled value is '2', NOT '1'!
@@ -297,6 +299,7 @@ int HttpClient::request(const char* verb,
   }
 
   set_curl_statuses(cp, url);
+  CurlConnectionPool::LogReuse(cp);
 
   if (slist) {
     curl_slist_free_all(slist);
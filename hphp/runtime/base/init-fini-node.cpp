@@ -17,11 +17,19 @@
 #include "hphp/runtime/base/init-fini-node.h"
 #include "hphp/util/timer.h"
 
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
 
 InitFiniNode *InitFiniNode::s_nodes[NumNodes];
 InitFiniNode::IFDispatcher* InitFiniNode::s_dispatcher[NumNodes];
+std::vector<std::vector<const InitFiniNode*>>
+  InitFiniNode::s_waves[NumNodes];
+uint32_t InitFiniNode::s_nextWave[NumNodes];
+uint32_t InitFiniNode::s_maxWorkers[NumNodes];
 
 void InitFiniNode::iterate(InitFiniNode *node) {
   while (node) {
@@ -35,26 +43,85 @@ void InitFiniNode::IFWorker::doJob(std::shared_ptr<IFJob> job) {
   job->node.func();
 }
 
-void InitFiniNode::concurrentStart(uint32_t maxWorkers, When when) {
-  if (maxWorkers == 0) {
-    iterate(when);
-    return;
+std::vector<std::vector<const InitFiniNode*>>
+InitFiniNode::dependencyWaves(const InitFiniNode* head) {
+  std::vector<const InitFiniNode*> nodes;
+  for (auto n = head; n; n = n->next) nodes.push_back(n);
+
+  std::unordered_map<std::string, uint32_t> byName;
+  for (uint32_t i = 0; i < nodes.size(); ++i) {
+    if (nodes[i]->name) byName.emplace(nodes[i]->name, i);
+  }
+  // Relax levels until fixed point: level(n) = 1 + max(level(deps)). The
+  // graphs are tiny, so quadratic passes beat building an explicit DAG. A
+  // legitimate DAG converges within nodes.size() passes; more means a cycle.
+  std::vector<uint32_t> level(nodes.size(), 0);
+  uint32_t maxLevel = 0;
+  for (bool changed = true; changed; ) {
+    changed = false;
+    for (uint32_t i = 0; i < nodes.size(); ++i) {
+      for (auto dep : nodes[i]->deps) {
+        auto const it = byName.find(dep);
+        if (it == byName.end() || it->second == i) continue;
+        if (level[i] <= level[it->second]) {
+          level[i] = level[it->second] + 1;
+          always_assert_flog(level[i] <= nodes.size(),
+                             "cycle in InitFiniNode dependencies near {}",
+                             nodes[i]->name ? nodes[i]->name : "(unnamed)");
+          maxLevel = std::max(maxLevel, level[i]);
+          changed = true;
+        }
+      }
+    }
   }
+  std::vector<std::vector<const InitFiniNode*>> waves(
+    nodes.empty() ? 0 : maxLevel + 1);
+  for (uint32_t i = 0; i < nodes.size(); ++i) {
+    waves[level[i]].push_back(nodes[i]);
+  }
+  return waves;
+}
+
+void InitFiniNode::startWave(When when, uint32_t maxWorkers,
+                             const std::vector<const InitFiniNode*>& wave) {
   std::vector<std::shared_ptr<IFJob> > jobs;
-  for (const auto* n = node(when); n; n = n->next) {
+  for (auto n : wave) {
     jobs.push_back(std::make_shared<IFJob>(*n));
   }
   dispatcher(when) = new IFDispatcher(std::move(jobs), maxWorkers);
   dispatcher(when)->start();
 }
 
+void InitFiniNode::concurrentStart(uint32_t maxWorkers, When when) {
+  auto waves = dependencyWaves(node(when));
+  if (maxWorkers == 0) {
+    // Run synchronously on the current thread, still honoring declared
+    // dependencies.
+    for (auto const& wave : waves) {
+      for (auto n : wave) n->func();
+    }
+    return;
+  }
+  if (waves.empty()) return;
+  auto const idx = static_cast<unsigned>(when);
+  startWave(when, maxWorkers, waves[0]);
+  s_waves[idx] = std::move(waves);
+  s_nextWave[idx] = 1;
+  s_maxWorkers[idx] = maxWorkers;
+}
+
 void InitFiniNode::concurrentWaitForEnd(When when) {
   auto& d = dispatcher(when);
-  if (d) {
+  auto const idx = static_cast<unsigned>(when);
+  while (d) {
     d->waitForEnd();
     delete d;
     d = nullptr;
+    if (s_nextWave[idx] < s_waves[idx].size()) {
+      startWave(when, s_maxWorkers[idx], s_waves[idx][s_nextWave[idx]++]);
+    }
   }
+  s_waves[idx].clear();
 }
 
 void InitFiniNode::ProcessInitConcurrentStart(uint32_t maxWorkers) {
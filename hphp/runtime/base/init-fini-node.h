@@ -20,6 +20,9 @@
 #include "hphp/util/assertions.h"
 #include "hphp/util/async-job.h"
 
+#include <initializer_list>
+#include <vector>
+
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -55,7 +58,17 @@ struct InitFiniNode {
 
   const static unsigned NumNodes = static_cast<unsigned>(When::Sentinel);
 
-  InitFiniNode(void(*f)(), When when, const char* what = nullptr) {
+  /*
+   * `dependsOn` names nodes (the `what` of other InitFiniNodes) that must
+   * finish before this one starts. Dependencies are only honored within the
+   * same concurrent phase (ProcessInitConcurrent, WarmupConcurrent), where
+   * the runner partitions nodes into waves so that independent subgraphs
+   * still execute in parallel; names that don't match a node in the phase
+   * are ignored. Serial phases run in registration order as before.
+   */
+  InitFiniNode(void(*f)(), When when, const char* what = nullptr,
+               std::initializer_list<const char*> dependsOn = {})
+    : deps(dependsOn) {
     InitFiniNode*& n = node(when);
     func = f;
     next = n;
@@ -103,14 +116,24 @@ struct InitFiniNode {
   void (*func)();
   InitFiniNode* next;
   const char* name;
+  std::vector<const char*> deps;
 
   static void iterate(When when) { iterate(node(when)); }
   static void iterate(InitFiniNode* node);
   static void concurrentStart(uint32_t maxWorkers, When when);
   static void concurrentWaitForEnd(When when);
+  // Partition a phase's nodes into dependency waves: every node lands in the
+  // wave after the latest wave containing one of its dependencies.
+  static std::vector<std::vector<const InitFiniNode*>>
+  dependencyWaves(const InitFiniNode* head);
+  static void startWave(When when, uint32_t maxWorkers,
+                        const std::vector<const InitFiniNode*>& wave);
 
   static InitFiniNode* s_nodes[NumNodes];
   static IFDispatcher* s_dispatcher[NumNodes];
+  static std::vector<std::vector<const InitFiniNode*>> s_waves[NumNodes];
+  static uint32_t s_nextWave[NumNodes];
+  static uint32_t s_maxWorkers[NumNodes];
 };
 
 ///////////////////////////////////////////////////////////////////////////////
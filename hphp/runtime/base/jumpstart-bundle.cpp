@@ -0,0 +1,234 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010-present Facebook, Inc. (http://www.facebook.com)  |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include "hphp/runtime/base/jumpstart-bundle.h"
+
+#include "hphp/util/assertions.h"
+
+#include <folly/Conv.h>
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <folly/portability/Fcntl.h>
+#include <folly/portability/SysStat.h>
+#include <folly/portability/Unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+
+namespace HPHP {
+
+namespace {
+
+constexpr std::array<char, 4> kMagic{ 'H', 'J', 'S', 'B' };
+constexpr uint32_t kCurrentVersion = 1;
+constexpr uint64_t kSectionAlign = 4096;
+constexpr uint32_t kMaxSections = 64;
+
+struct Header {
+  std::array<char, 4> magic;
+  uint32_t version;
+  uint32_t count;
+  uint32_t reserved;
+};
+
+struct TableEntry {
+  uint32_t section;
+  uint32_t reserved;
+  uint64_t offset;
+  uint64_t size;
+};
+
+uint64_t alignUp(uint64_t v) {
+  return (v + kSectionAlign - 1) & ~(kSectionAlign - 1);
+}
+
+struct AutoFD {
+  explicit AutoFD(int fd) : fd{fd} {}
+  ~AutoFD() { if (fd >= 0) ::close(fd); }
+  int fd;
+};
+
+bool fail(std::string& error, std::string msg) {
+  error = std::move(msg);
+  return false;
+}
+
+}
+
+bool JumpstartBundle::pack(
+    const std::string& path,
+    const std::vector<std::pair<Section, std::string>>& parts,
+    std::string& error) {
+  if (parts.empty() || parts.size() > kMaxSections) {
+    return fail(error, "invalid number of bundle sections");
+  }
+
+  std::vector<TableEntry> table;
+  table.reserve(parts.size());
+  auto offset = alignUp(sizeof(Header) + parts.size() * sizeof(TableEntry));
+  for (auto const& part : parts) {
+    struct stat st;
+    if (::stat(part.second.c_str(), &st) != 0) {
+      return fail(error, folly::to<std::string>(
+        "unable to stat ", part.second, ": ", folly::errnoStr(errno)));
+    }
+    table.push_back(TableEntry{
+      static_cast<uint32_t>(part.first), 0,
+      offset, static_cast<uint64_t>(st.st_size)
+    });
+    offset = alignUp(offset + st.st_size);
+  }
+
+  AutoFD out{::open(path.c_str(),
+                    O_CLOEXEC | O_WRONLY | O_CREAT | O_TRUNC, 0644)};
+  if (out.fd < 0) {
+    return fail(error, folly::to<std::string>(
+      "unable to create ", path, ": ", folly::errnoStr(errno)));
+  }
+
+  auto const write = [&] (const void* data, size_t size, uint64_t at) {
+    return folly::pwriteFull(out.fd, data, size, at) ==
+      static_cast<ssize_t>(size);
+  };
+
+  Header header{kMagic, kCurrentVersion,
+                static_cast<uint32_t>(parts.size()), 0};
+  if (!write(&header, sizeof(header), 0) ||
+      !write(table.data(), table.size() * sizeof(TableEntry),
+             sizeof(header))) {
+    return fail(error, folly::to<std::string>(
+      "failed writing bundle header to ", path));
+  }
+
+  constexpr size_t kCopyChunk = 1 << 20;
+  auto const buf = std::make_unique<char[]>(kCopyChunk);
+  for (size_t i = 0; i < parts.size(); ++i) {
+    AutoFD in{::open(parts[i].second.c_str(), O_CLOEXEC | O_RDONLY)};
+    if (in.fd < 0) {
+      return fail(error, folly::to<std::string>(
+        "unable to open ", parts[i].second, ": ", folly::errnoStr(errno)));
+    }
+    uint64_t copied = 0;
+    while (copied < table[i].size) {
+      auto const want =
+        std::min<uint64_t>(kCopyChunk, table[i].size - copied);
+      if (folly::preadFull(in.fd, buf.get(), want, copied) !=
+            static_cast<ssize_t>(want) ||
+          !write(buf.get(), want, table[i].offset + copied)) {
+        return fail(error, folly::to<std::string>(
+          "failed copying ", parts[i].second, " into ", path));
+      }
+      copied += want;
+    }
+  }
+
+  if (::fsync(out.fd) != 0) {
+    return fail(error, folly::to<std::string>(
+      "failed syncing ", path, ": ", folly::errnoStr(errno)));
+  }
+  return true;
+}
+
+bool JumpstartBundle::open(const std::string& path,
+                           JumpstartBundle& bundle,
+                           std::string& error) {
+  AutoFD in{::open(path.c_str(), O_CLOEXEC | O_RDONLY)};
+  if (in.fd < 0) {
+    return fail(error, folly::to<std::string>(
+      "unable to open ", path, ": ", folly::errnoStr(errno)));
+  }
+  auto const fileSize = ::lseek(in.fd, 0, SEEK_END);
+  if (fileSize < 0) {
+    return fail(error, folly::to<std::string>("unable to size ", path));
+  }
+
+  Header header;
+  if (folly::preadFull(in.fd, &header, sizeof(header), 0) !=
+        sizeof(header) ||
+      header.magic != kMagic) {
+    return fail(error, folly::to<std::string>(
+      path, " is not a jumpstart bundle"));
+  }
+  if (header.version != kCurrentVersion) {
+    return fail(error, folly::to<std::string>(
+      "unsupported bundle version ", header.version, " in ", path));
+  }
+  if (header.count == 0 || header.count > kMaxSections) {
+    return fail(error, folly::to<std::string>(
+      "invalid section count ", header.count, " in ", path));
+  }
+
+  std::vector<TableEntry> table(header.count);
+  auto const tableBytes = table.size() * sizeof(TableEntry);
+  if (folly::preadFull(in.fd, table.data(), tableBytes, sizeof(header)) !=
+        static_cast<ssize_t>(tableBytes)) {
+    return fail(error, folly::to<std::string>(
+      "truncated section table in ", path));
+  }
+
+  bundle.m_path = path;
+  bundle.m_entries.clear();
+  for (auto const& te : table) {
+    if (te.offset > static_cast<uint64_t>(fileSize) ||
+        te.size > static_cast<uint64_t>(fileSize) - te.offset) {
+      return fail(error, folly::to<std::string>(
+        "section ", te.section, " extends past the end of ", path));
+    }
+    bundle.m_entries.push_back(
+      Entry{static_cast<Section>(te.section), te.offset, te.size});
+  }
+  return true;
+}
+
+const JumpstartBundle::Entry* JumpstartBundle::find(Section section) const {
+  for (auto const& entry : m_entries) {
+    if (entry.section == section) return &entry;
+  }
+  return nullptr;
+}
+
+bool JumpstartBundle::read(const Entry& entry, std::string& out) const {
+  AutoFD in{::open(m_path.c_str(), O_CLOEXEC | O_RDONLY)};
+  if (in.fd < 0) return false;
+  out.resize(entry.size);
+  return folly::preadFull(in.fd, out.data(), entry.size, entry.offset) ==
+    static_cast<ssize_t>(entry.size);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+std::unique_ptr<JumpstartBundle> s_activeBundle;
+}
+
+void setActiveJumpstartBundle(JumpstartBundle bundle) {
+  assertx(!s_activeBundle);
+  s_activeBundle = std::make_unique<JumpstartBundle>(std::move(bundle));
+}
+
+const JumpstartBundle* activeJumpstartBundle() {
+  return s_activeBundle.get();
+}
+
+const JumpstartBundle::Entry* jumpstartSection(
+    JumpstartBundle::Section section) {
+  if (!s_activeBundle) return nullptr;
+  return s_activeBundle->find(section);
+}
+
+}
@@ -0,0 +1,97 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010-present Facebook, Inc. (http://www.facebook.com)  |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace HPHP {
+
+/*
+ * A jumpstart bundle packages the artifacts needed to bring a box to full
+ * performance -- the repo file, a serialized JIT profile, an APC snapshot,
+ * and a warmup-request manifest -- into a single container that deploy
+ * tooling can ship, verify, and read ahead as one unit.
+ *
+ * Layout: a fixed header (magic, version, section count) followed by a
+ * section table of (section id, offset, size) triples. Section payloads are
+ * page-aligned, byte-exact copies of the standalone artifact files, so each
+ * artifact's existing loader can consume its section in place given (path,
+ * offset, size). Opening a bundle only parses the section table; the boot
+ * path routes each section to the loader that already owns that artifact.
+ */
+struct JumpstartBundle {
+  enum class Section : uint32_t {
+    Repo = 1,
+    JitProfile = 2,
+    ApcSnapshot = 3,
+    WarmupManifest = 4,
+  };
+
+  struct Entry {
+    Section section;
+    uint64_t offset;
+    uint64_t size;
+  };
+
+  /*
+   * Pack the given artifact files into a bundle at `path'. Returns false
+   * and sets `error' on failure.
+   */
+  static bool pack(const std::string& path,
+                   const std::vector<std::pair<Section, std::string>>& parts,
+                   std::string& error);
+
+  /*
+   * Open and validate the bundle at `path'. Returns false and sets `error'
+   * if the file is missing or malformed.
+   */
+  static bool open(const std::string& path,
+                   JumpstartBundle& bundle,
+                   std::string& error);
+
+  const std::string& path() const { return m_path; }
+  const std::vector<Entry>& entries() const { return m_entries; }
+  const Entry* find(Section section) const;
+
+  /*
+   * Read the full payload of `entry' into `out'. Only intended for small
+   * sections, like the warmup manifest.
+   */
+  bool read(const Entry& entry, std::string& out) const;
+
+private:
+  std::string m_path;
+  std::vector<Entry> m_entries;
+};
+
+/*
+ * The bundle this process booted from, if any. Set at most once, early in
+ * server startup, before any of the section consumers run.
+ */
+void setActiveJumpstartBundle(JumpstartBundle bundle);
+const JumpstartBundle* activeJumpstartBundle();
+
+/*
+ * Convenience lookup into the active bundle. Returns nullptr when no bundle
+ * is active or the active bundle lacks the section.
+ */
+const JumpstartBundle::Entry* jumpstartSection(JumpstartBundle::Section);
+
+}
@@ -594,5 +594,30 @@ template<class Fn> void MemoryManager::forEachObject(Fn fn) {
   }
 }
 
+template<class Fn>
+size_t MemoryManager::forEachObjectSlice(size_t start, size_t limit, Fn fn) {
+  if (debug) checkHeap("MemoryManager::forEachObjectSlice");
+  auto const end = limit ? start + limit : ~size_t(0);
+  size_t pos = 0;
+  bool more = false;
+  std::vector<const ObjectData*> ptrs;
+  forEachHeapObject([&](HeapObject* h, size_t) {
+    if (auto obj = innerObj(h)) {
+      if (obj->hasUninitProps()) return;
+      auto const i = pos++;
+      if (i < start) return;
+      if (i >= end) {
+        more = true;
+        return;
+      }
+      ptrs.push_back(obj);
+    }
+  });
+  for (auto ptr : ptrs) {
+    fn(ptr);
+  }
+  return more ? end : 0;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 }
@@ -29,6 +29,7 @@
 #include "hphp/runtime/base/request-info.h"
 #include "hphp/runtime/base/req-root.h"
 #include "hphp/runtime/base/heap-graph.h"
+#include "hphp/runtime/base/heap-profiling.h"
 #include "hphp/runtime/server/http-server.h"
 
 #include "hphp/util/alloc.h"
@@ -364,6 +365,34 @@ void MemoryManager::sweep() {
 void MemoryManager::resetAllocator() {
   assertx(m_natives.empty() && m_sweepables.empty() && tl_sweeping);
 
+  if (UNLIKELY(m_checkpoint.valid)) {
+    // Rewind to the checkpointed state instead of freeing the whole heap.
+    m_heap.resetToCheckpoint();
+    // Free blocks that existed at checkpoint time were retired to holes by
+    // setHeapCheckpoint(), and everything freed since lives in the slabs we
+    // just released, so the rewound heap starts with empty freelists.
+    for (auto& list : m_freelists) list.head = nullptr;
+    m_front = m_checkpoint.front;
+    m_limit = m_checkpoint.limit;
+    tl_sweeping = false;
+    m_exiting = false;
+    resetAllStats();
+    // The retained heap prefix still counts against this request's usage
+    // and capacity; rewind those stats to their checkpoint values.
+    m_stats.mm_udebt = m_checkpoint.stats.mm_udebt;
+    m_stats.mm_uallocated = m_checkpoint.stats.mm_uallocated;
+    m_stats.mm_freed = m_checkpoint.stats.mm_freed;
+    m_stats.malloc_cap = m_checkpoint.stats.malloc_cap;
+    m_stats.mmap_cap = m_checkpoint.stats.mmap_cap;
+    m_stats.mmap_volume = m_checkpoint.stats.mmap_volume;
+    m_stats.peakUsage = m_stats.usage();
+    m_stats.peakCap = m_stats.capacity();
+    setGCEnabled(RuntimeOption::EvalEnableGC);
+    resetGC();
+    if (debug) resetEagerGC();
+    return;
+  }
+
   // free the heap
   m_heap.reset();
 
@@ -378,6 +407,33 @@ void MemoryManager::resetAllocator() {
   if (debug) resetEagerGC();
 }
 
+void MemoryManager::setHeapCheckpoint() {
+  assertx(!m_checkpoint.valid);
+  m_checkpoint.front = m_front;
+  m_checkpoint.limit = m_limit;
+  // The freelists are threaded through the free blocks themselves, so any
+  // chain snapshotted here would be clobbered as soon as a later allocation
+  // pops from it. Retire the current free blocks into holes instead (as
+  // endQuarantine() does); the checkpointed heap starts with empty lists.
+  for (size_t i = 0, n = m_freelists.size(); i < n; ++i) {
+    auto const size = sizeIndex2Size(i);
+    while (auto p = m_freelists[i].likelyPop()) {
+      initHole(p, size);
+    }
+  }
+  refreshStats();
+  m_checkpoint.stats = m_stats;
+  m_heap.setCheckpoint();
+  m_checkpoint.valid = true;
+  FTRACE(1, "heap-id {} setHeapCheckpoint: usage {} capacity {}\n",
+         tl_heap_id, m_stats.usage(), m_stats.capacity());
+}
+
+void MemoryManager::clearHeapCheckpoint() {
+  m_checkpoint.valid = false;
+  m_heap.clearCheckpoint();
+}
+
 void MemoryManager::flush() {
   always_assert(empty());
   m_heap.flush();
@@ -1034,8 +1090,12 @@ void MemoryManager::requestInit() {
   if (RuntimeOption::EvalHeapAllocSampleRequests > 0 &&
       RuntimeOption::EvalHeapAllocSampleBytes > 0) {
     if (!folly::Random::rand32(RuntimeOption::EvalHeapAllocSampleRequests)) {
-      tl_heap->m_nextSample =
-        folly::Random::rand32(RuntimeOption::EvalHeapAllocSampleBytes);
+      // The exponential gap distribution is memoryless, so a fresh draw is
+      // also the right initial offset; the legacy fixed stride keeps its
+      // uniform initial offset.
+      tl_heap->m_nextSample = RuntimeOption::EvalHeapAllocPoissonSampling
+        ? alloc_sample_gap()
+        : folly::Random::rand32(RuntimeOption::EvalHeapAllocSampleBytes);
     }
   }
 
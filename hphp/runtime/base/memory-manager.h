@@ -503,6 +503,18 @@ struct SparseHeap {
    */
   void reset();
 
+  /*
+   * Checkpoint support: remember the current set of slabs and big blocks.
+   * resetToCheckpoint() frees only the blocks allocated afterwards, leaving
+   * the warmed-up portion of the heap mapped. Blocks that existed at
+   * checkpoint time must not be freed or resized while the checkpoint is
+   * set (debug builds assert).
+   */
+  void setCheckpoint();
+  void resetToCheckpoint();
+  void clearCheckpoint();
+  bool hasCheckpoint() const { return m_checkpoint; }
+
   /*
    * Release auxiliary structures to prepare to be idle for a while.
    *
@@ -547,8 +559,15 @@ struct SparseHeap {
     void* ptr;
     uint16_t version{0};                // tag used with SlabManager
   };
+  bool checkpointContains(const void* ptr) const;
+
   std::vector<SlabInfo> m_pooled_slabs;
   RadixMap<HeapObject*,kLgSmallSizeQuantum,8> m_bigs;
+  // Checkpoint state: number of pooled slabs and the sorted set of big
+  // blocks that existed when setCheckpoint() was called.
+  bool m_checkpoint{false};
+  size_t m_checkpointPooledSlabs{0};
+  std::vector<const void*> m_checkpointBigs;
   MemBlock m_slab_range;
   int64_t m_hugeBytes{0};               // compare with RequestHugeMaxBytes
   SlabManager* m_slabManager{nullptr};
@@ -725,6 +744,28 @@ struct MemoryManager {
    */
   void resetRuntimeOptions();
 
+  /*
+   * Checkpoint the current heap state. Endpoints that allocate a near-
+   * identical object graph on every request can warm the graph up once,
+   * call setHeapCheckpoint(), and have resetAllocator() rewind the heap to
+   * this state instead of tearing it down: slabs and big blocks that
+   * existed at the checkpoint stay mapped and the bump-allocation frontier
+   * is restored. Free blocks on the freelists are retired into holes when
+   * the checkpoint is taken (their chains run through the blocks themselves
+   * and would not survive reuse), so the rewound heap starts with empty
+   * freelists. Everything allocated before the checkpoint must stay live
+   * and unfreed for as long as the checkpoint is set (debug builds assert
+   * on violations).
+   */
+  void setHeapCheckpoint();
+
+  /*
+   * Drop the checkpoint; the next resetAllocator() releases everything.
+   */
+  void clearHeapCheckpoint();
+
+  bool hasHeapCheckpoint() const { return m_checkpoint.valid; }
+
   /////////////////////////////////////////////////////////////////////////////
   // Heap introspection.
 
@@ -750,12 +791,21 @@ struct MemoryManager {
    * forEachHeapObject(): Like iterate(), but with an eager initFree().
    * forEachObject(): Iterate just the ObjectDatas, including the kinds with
    *                  prefixes (NativeData, AsyncFuncFrame, and ClosureHdr).
+   * forEachObjectSlice(): Like forEachObject(), but visits at most `limit'
+   *                  objects (0 means all) starting `start' objects into the
+   *                  walk, and returns the position to resume from, or 0 when
+   *                  the walk reached the end of the heap. Positions are only
+   *                  a statistical cursor: the heap may mutate between
+   *                  slices, so a sliced walk can miss objects or visit some
+   *                  twice.
    */
   void initFree();
   void reinitFree();
   template<class Fn> void iterate(Fn fn);
   template<class Fn> void forEachHeapObject(Fn fn);
   template<class Fn> void forEachObject(Fn fn);
+  template<class Fn> size_t forEachObjectSlice(size_t start, size_t limit,
+                                               Fn fn);
 
   /*
    * Iterate over the roots owned by MemoryManager.
@@ -1047,9 +1097,18 @@ private:
   static auto constexpr kNoNextGC = std::numeric_limits<int64_t>::max();
   static auto constexpr kNoNextSample = std::numeric_limits<int64_t>::max();
 
+  // Allocator state snapshotted by setHeapCheckpoint().
+  struct HeapCheckpoint {
+    bool valid{false};
+    void* front{nullptr};
+    void* limit{nullptr};
+    MemoryUsageStats stats;
+  };
+
   void* m_front{nullptr};
   void* m_limit{nullptr};
   FreelistArray m_freelists;
+  HeapCheckpoint m_checkpoint;
   int64_t m_nextGC{kNoNextGC}; // request gc when heap usage reaches this size
   int64_t m_nextSample{kNoNextSample};
   int64_t m_usageLimit; // OOM when m_stats.usage() > m_usageLimit
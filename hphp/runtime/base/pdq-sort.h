@@ -0,0 +1,310 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010-present Facebook, Inc. (http://www.facebook.com)  |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#ifndef incl_HPHP_PDQ_SORT_H_
+#define incl_HPHP_PDQ_SORT_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+namespace HPHP {
+namespace pdq {
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * A pattern-defeating quicksort for flat buffers of trivially-copyable
+ * values, after Orson Peters' pdqsort. Compared to HPHP::Sort::sort, it
+ * detects nearly-sorted inputs (cheap partial insertion sort after a
+ * partition that moved nothing), handles low-cardinality inputs (ranges
+ * equal to the pivot are partitioned out in one pass), partitions in
+ * fixed-size blocks with branch-free offset generation, and falls back to
+ * heapsort when partitions stay unbalanced, so adversarial inputs are still
+ * O(n log n).
+ *
+ * Unlike safesort, this sort requires `lt` to be a consistent strict weak
+ * order: use it for plain value comparisons (ints, doubles), never for
+ * user-supplied PHP comparators.
+ */
+
+namespace detail {
+
+// Ranges below this size are finished with insertion sort.
+constexpr ptrdiff_t kInsertionSortMax = 24;
+// Ranges above this size pick the pivot with a ninther instead of a
+// median-of-3.
+constexpr ptrdiff_t kNintherMin = 128;
+// Number of elements classified per side in one branch-free pass.
+constexpr ptrdiff_t kBlockSize = 64;
+// Give up on an opportunistic insertion sort after this many moves.
+constexpr ptrdiff_t kPartialInsertionLimit = 8;
+
+template <typename T, typename Lt>
+void sort2(T* a, T* b, Lt lt) {
+  if (lt(*b, *a)) std::swap(*a, *b);
+}
+
+template <typename T, typename Lt>
+void sort3(T* a, T* b, T* c, Lt lt) {
+  sort2(a, b, lt);
+  sort2(b, c, lt);
+  sort2(a, b, lt);
+}
+
+template <typename T, typename Lt>
+void insertionSort(T* begin, T* end, Lt lt) {
+  for (T* cur = begin + 1; cur < end; ++cur) {
+    if (lt(*cur, *(cur - 1))) {
+      T tmp = *cur;
+      T* sift = cur;
+      do {
+        *sift = *(sift - 1);
+      } while (--sift != begin && lt(tmp, *(sift - 1)));
+      *sift = tmp;
+    }
+  }
+}
+
+// Insertion sort for ranges where *(begin - 1) is known to be no greater
+// than any element, so the inner loop needs no bounds check.
+template <typename T, typename Lt>
+void unguardedInsertionSort(T* begin, T* end, Lt lt) {
+  for (T* cur = begin + 1; cur < end; ++cur) {
+    if (lt(*cur, *(cur - 1))) {
+      T tmp = *cur;
+      T* sift = cur;
+      do {
+        *sift = *(sift - 1);
+      } while (lt(tmp, *(--sift - 1)));
+      *sift = tmp;
+    }
+  }
+}
+
+// Sorts the range if it is nearly sorted already; bails out and returns
+// false once that takes more than kPartialInsertionLimit moves.
+template <typename T, typename Lt>
+bool partialInsertionSort(T* begin, T* end, Lt lt) {
+  if (begin == end) return true;
+  ptrdiff_t budget = kPartialInsertionLimit;
+  for (T* cur = begin + 1; cur < end; ++cur) {
+    if (lt(*cur, *(cur - 1))) {
+      T tmp = *cur;
+      T* sift = cur;
+      do {
+        *sift = *(sift - 1);
+      } while (--sift != begin && lt(tmp, *(sift - 1)));
+      *sift = tmp;
+      budget -= cur - sift;
+      if (budget < 0) return false;
+    }
+  }
+  return true;
+}
+
+// Partitions [begin, end) around the pivot at *begin so elements less than
+// the pivot come first. Returns the pivot's final position and whether the
+// range was already partitioned. Requires a median-of-3 pivot so that both
+// unguarded scans below have sentinels.
+template <typename T, typename Lt>
+std::pair<T*, bool> partitionRight(T* begin, T* end, Lt lt) {
+  T const pivot = *begin;
+  T* first = begin;
+  T* last = end;
+
+  while (lt(*++first, pivot)) {}
+  if (first - 1 == begin) {
+    while (first < last && !lt(*--last, pivot)) {}
+  } else {
+    while (!lt(*--last, pivot)) {}
+  }
+
+  auto const alreadyPartitioned = first >= last;
+  if (!alreadyPartitioned) {
+    std::swap(*first, *last);
+    ++first;
+
+    // Branch-free block phase: classify a block from each side into offset
+    // buffers, then swap the misplaced pairs. A side only advances once its
+    // buffer drains, so [first, last) always covers every unfinished
+    // element and the scalar loop below can finish the job.
+    unsigned char offsetsL[kBlockSize];
+    unsigned char offsetsR[kBlockSize];
+    size_t numL = 0, numR = 0, startL = 0, startR = 0;
+    while (last - first > 2 * kBlockSize) {
+      if (numL == 0) {
+        startL = 0;
+        for (ptrdiff_t i = 0; i < kBlockSize; ++i) {
+          offsetsL[numL] = static_cast<unsigned char>(i);
+          numL += !lt(first[i], pivot);
+        }
+      }
+      if (numR == 0) {
+        startR = 0;
+        for (ptrdiff_t i = 0; i < kBlockSize; ++i) {
+          offsetsR[numR] = static_cast<unsigned char>(i + 1);
+          numR += lt(*(last - i - 1), pivot);
+        }
+      }
+      auto const num = std::min(numL, numR);
+      for (size_t i = 0; i < num; ++i) {
+        std::swap(first[offsetsL[startL + i]], *(last - offsetsR[startR + i]));
+      }
+      numL -= num;
+      numR -= num;
+      startL += num;
+      startR += num;
+      if (numL == 0) first += kBlockSize;
+      if (numR == 0) last -= kBlockSize;
+    }
+
+    while (first < last) {
+      if (lt(*first, pivot)) {
+        ++first;
+        continue;
+      }
+      do {
+        --last;
+      } while (first < last && !lt(*last, pivot));
+      if (first >= last) break;
+      std::swap(*first, *last);
+      ++first;
+    }
+  }
+
+  T* const pivotPos = first - 1;
+  *begin = *pivotPos;
+  *pivotPos = pivot;
+  return {pivotPos, alreadyPartitioned};
+}
+
+// Partitions [begin, end) around the pivot at *begin so elements equal to
+// the pivot come first. Used when the pivot equals the predecessor range's
+// pivot, which sweeps up duplicate-heavy inputs in one pass. Requires a
+// non-leftmost range, so *(begin - 1) is a sentinel for the right scan.
+template <typename T, typename Lt>
+T* partitionLeft(T* begin, T* end, Lt lt) {
+  T const pivot = *begin;
+  T* first = begin;
+  T* last = end;
+
+  while (lt(pivot, *--last)) {}
+  if (last + 1 == end) {
+    while (first < last && !lt(pivot, *++first)) {}
+  } else {
+    while (!lt(pivot, *++first)) {}
+  }
+
+  while (first < last) {
+    std::swap(*first, *last);
+    while (lt(pivot, *--last)) {}
+    while (!lt(pivot, *++first)) {}
+  }
+
+  T* const pivotPos = last;
+  *begin = *pivotPos;
+  *pivotPos = pivot;
+  return pivotPos;
+}
+
+template <typename T, typename Lt>
+void sortImpl(T* begin, T* end, Lt lt, int badAllowed, bool leftmost) {
+  while (true) {
+    auto const size = end - begin;
+    if (size < kInsertionSortMax) {
+      if (leftmost) {
+        insertionSort(begin, end, lt);
+      } else {
+        unguardedInsertionSort(begin, end, lt);
+      }
+      return;
+    }
+
+    auto const s2 = size / 2;
+    if (size > kNintherMin) {
+      sort3(begin, begin + s2, end - 1, lt);
+      sort3(begin + 1, begin + (s2 - 1), end - 2, lt);
+      sort3(begin + 2, begin + (s2 + 1), end - 3, lt);
+      sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), lt);
+      std::swap(*begin, *(begin + s2));
+    } else {
+      sort3(begin + s2, begin, end - 1, lt);
+    }
+
+    // If the pivot equals the element before this range, every element
+    // equal to the pivot belongs at the front; partition them out and
+    // continue with the strictly-greater remainder.
+    if (!leftmost && !lt(*(begin - 1), *begin)) {
+      begin = partitionLeft(begin, end, lt) + 1;
+      continue;
+    }
+
+    auto const [pivotPos, alreadyPartitioned] = partitionRight(begin, end, lt);
+    auto const leftSize = pivotPos - begin;
+    auto const rightSize = end - (pivotPos + 1);
+
+    if (leftSize < size / 8 || rightSize < size / 8) {
+      // Unbalanced partition: after too many of these, defeat the pattern
+      // (or adversary) by switching to heapsort.
+      if (--badAllowed <= 0) {
+        std::make_heap(begin, end, lt);
+        std::sort_heap(begin, end, lt);
+        return;
+      }
+    } else if (alreadyPartitioned &&
+               partialInsertionSort(begin, pivotPos, lt) &&
+               partialInsertionSort(pivotPos + 1, end, lt)) {
+      // The partition moved nothing and both sides were nearly sorted:
+      // the whole range is now sorted.
+      return;
+    }
+
+    sortImpl(begin, pivotPos, lt, badAllowed, leftmost);
+    begin = pivotPos + 1;
+    leftmost = false;
+  }
+}
+
+inline int log2i(ptrdiff_t n) {
+  int result = 0;
+  while (n > 1) {
+    n >>= 1;
+    ++result;
+  }
+  return result;
+}
+
+}
+
+template <typename T, typename Lt>
+void sort(T* begin, T* end, Lt lt) {
+  if (end - begin < 2) return;
+  detail::sortImpl(begin, end, lt, detail::log2i(end - begin), true);
+}
+
+template <typename T>
+void sort(T* begin, T* end) {
+  sort(begin, end, std::less<T>{});
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}
+}
+
+#endif // incl_HPHP_PDQ_SORT_H_
@@ -35,6 +35,8 @@
 #include "hphp/runtime/vm/jit/mcgen.h"
 #include "hphp/runtime/vm/jit/tc.h"
 #include "hphp/runtime/vm/jit/tc-internal.h"
+#include "hphp/runtime/vm/jit/trans-db.h"
+#include "hphp/runtime/vm/jit/vasm-prof.h"
 
 #include "hphp/util/alloc.h"
 #include "hphp/util/match.h"
@@ -45,6 +47,7 @@
 
 #include <boost/algorithm/string/predicate.hpp>
 
+#include <folly/Format.h>
 #include <folly/ScopeGuard.h>
 #ifdef FACEBOOK
 #include <folly/Demangle.h>
@@ -67,7 +70,7 @@ namespace {
  * Bump this whenever the log format changes, so that it's easy to filter out
  * old, incompatible results.
  */
-constexpr auto kVersion = 3;
+constexpr auto kVersion = 4;
 
 /*
  * Update `record' with the data member that `internal' is in, relative to
@@ -201,6 +204,70 @@ void fill_record(const VanillaDict* arr, const void* addr,
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/*
+ * Resolve `tca' to the translation containing it, and update `record' with
+ * the translation's identity and bytecode context under `prefix'-qualified
+ * keys.
+ *
+ * The IR-instruction mapping is not retained once a translation is
+ * committed, so the TransDB's bytecode mapping is the finest-grained index
+ * available at sample time. We also record the code area and the offset of
+ * `tca' within the translation, which is enough to line a sample up against
+ * a tc-print or printir dump of the same translation and recover the exact
+ * vasm/hhir instruction offline.
+ */
+void record_trans_attribution(TCA tca, const char* prefix,
+                              StructuredLogEntry& record) {
+  auto const rec = transdb::getTransRec(tca);
+  if (!rec || !rec->isValid()) return;
+
+  auto const key = [&] (const char* suffix) {
+    return folly::sformat("{}_{}", prefix, suffix);
+  };
+
+  record.setInt(key("trans_id"), rec->id);
+  record.setStr(key("trans_kind"), show(rec->kind));
+  if (!rec->funcName.empty()) record.setStr(key("func"), rec->funcName);
+
+  enum class Area { Main, Cold, Frozen };
+  Area area;
+  TCA areaStart;
+  if (rec->aStart <= tca && tca < rec->aStart + rec->aLen) {
+    area = Area::Main;
+    areaStart = rec->aStart;
+    record.setStr(key("trans_area"), "main");
+  } else if (rec->acoldStart <= tca && tca < rec->acoldStart + rec->acoldLen) {
+    area = Area::Cold;
+    areaStart = rec->acoldStart;
+    record.setStr(key("trans_area"), "cold");
+  } else if (rec->afrozenStart <= tca &&
+             tca < rec->afrozenStart + rec->afrozenLen) {
+    area = Area::Frozen;
+    areaStart = rec->afrozenStart;
+    record.setStr(key("trans_area"), "frozen");
+  } else {
+    return;
+  }
+  record.setInt(key("trans_off"), tca - areaStart);
+
+  // The closest preceding bytecode mapping in the same area is the bytecode
+  // instruction whose machine code `tca' falls in.
+  const TransBCMapping* best = nullptr;
+  TCA bestStart = nullptr;
+  for (auto const& m : rec->bcMapping) {
+    auto const start = area == Area::Main ? m.aStart :
+                       area == Area::Cold ? m.acoldStart : m.afrozenStart;
+    if (start && start <= tca && (!best || start >= bestStart)) {
+      best = &m;
+      bestStart = start;
+    }
+  }
+  if (best && best->sk.valid()) {
+    record.setStr(key("srckey"), showShort(best->sk));
+    record.setInt(key("line"), best->sk.lineNumber());
+  }
+}
+
 /*
  * Update `record' for `tca', known to point into the TC.
  */
@@ -213,6 +280,8 @@ bool record_tc_mem_event(TCA tca, StructuredLogEntry& record) {
     record.setStr("name", ustub.substr(0, ustub.find('+')));
   }
 
+  record_trans_attribution(tca, "target", record);
+
   return true;
 }
 
@@ -386,18 +455,40 @@ void record_perf_mem_event(PerfEvent kind, const perf_event_sample* sample) {
   perf_event_pause();
   SCOPE_EXIT { perf_event_resume(); };
 
+  // Branch samples ride the same consumption machinery as memory events, but
+  // are aggregated rather than logged individually.
+  if (kind == PerfEvent::Branch) {
+    record_perf_branch_sample(sample);
+    return;
+  }
+
   auto const addr = reinterpret_cast<const void*>(sample->addr);
 
   auto record = StructuredLogEntry{};
   record.setInt("version", kVersion);
   record.setStr("event", [&] {
     switch (kind) {
-      case PerfEvent::Load:  return "load";
-      case PerfEvent::Store: return "store";
+      case PerfEvent::Load:   return "load";
+      case PerfEvent::Store:  return "store";
+      case PerfEvent::Branch: break;  // handled above
     }
     not_reached();
   }());
   record.setInt("addr", uintptr_t(addr));
+  record.setInt("ip", sample->ip);
+
+  // Attribute the sampled instruction itself: when the IP lands in the TC,
+  // resolve it to the translation, bytecode, and source line that issued the
+  // access, independently of where the accessed data lives.
+  auto const ip = reinterpret_cast<TCA>(sample->ip);
+  if (sample->ip &&
+      jit::mcgen::initialized() && jit::tc::code().isValidCodeAddress(ip)) {
+    auto const ustub = tc::ustubs().describe(ip);
+    if (!boost::starts_with(ustub, "0x")) {
+      record.setStr("ip_ustub", ustub.substr(0, ustub.find('+')));
+    }
+    record_trans_attribution(ip, "ip", record);
+  }
 
   auto const data_src = sample->tail()->data_src;
   auto const info = perf_event_data_src(kind, data_src);
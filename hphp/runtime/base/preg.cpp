@@ -16,11 +16,15 @@
 
 #include "hphp/runtime/base/preg.h"
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <deque>
 #include <fstream>
 #include <mutex>
 #include <pcre.h>
 #include <onigposix.h>
+#include <unordered_map>
 #include <utility>
 
 #include <folly/AtomicHashArray.h>
@@ -1337,6 +1341,416 @@ Variant preg_match_all(StringData* pattern, const StringData* subject,
   return preg_match_impl(pattern, subject, matches, flags, offset, true);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Pattern-set matching
+
+namespace {
+
+/*
+ * Aho-Corasick automaton over the literals required by the members of a
+ * pattern set.  A single pass over the subject marks every member whose
+ * required literal occurs; only those members need a full pcre_exec to
+ * confirm.  Goto transitions are flattened into a DFA at build time so the
+ * scan never follows failure links.
+ */
+struct LiteralSetMatcher {
+  explicit LiteralSetMatcher(
+      const std::vector<std::pair<std::string, uint32_t>>& literals) {
+    m_nodes.emplace_back();
+
+    /* Build the trie. */
+    for (auto const& lit : literals) {
+      int32_t cur = 0;
+      for (unsigned char c : lit.first) {
+        if (m_nodes[cur].next[c] < 0) {
+          m_nodes[cur].next[c] = m_nodes.size();
+          m_nodes.emplace_back();
+        }
+        cur = m_nodes[cur].next[c];
+      }
+      m_nodes[cur].members.push_back(lit.second);
+    }
+
+    /* Breadth-first pass: compute failure links, fold each node's failure
+       outputs into its own, and turn missing transitions into the failure
+       target's transition. */
+    std::deque<int32_t> queue;
+    for (auto& t : m_nodes[0].next) {
+      if (t < 0) {
+        t = 0;
+      } else {
+        queue.push_back(t);
+      }
+    }
+    while (!queue.empty()) {
+      auto const cur = queue.front();
+      queue.pop_front();
+      auto const fail = m_nodes[cur].fail;
+      auto const& failMembers = m_nodes[fail].members;
+      m_nodes[cur].members.insert(m_nodes[cur].members.end(),
+                                  failMembers.begin(), failMembers.end());
+      for (int c = 0; c < 256; c++) {
+        auto& t = m_nodes[cur].next[c];
+        if (t < 0) {
+          t = m_nodes[fail].next[c];
+        } else {
+          m_nodes[t].fail = m_nodes[fail].next[c];
+          queue.push_back(t);
+        }
+      }
+    }
+  }
+
+  /* Mark in `hits` every member whose literal occurs in the subject. */
+  void scan(const char* data, size_t size, std::vector<bool>& hits) const {
+    int32_t state = 0;
+    for (size_t i = 0; i < size; i++) {
+      state = m_nodes[state].next[(unsigned char)data[i]];
+      if (UNLIKELY(!m_nodes[state].members.empty())) {
+        for (auto const id : m_nodes[state].members) hits[id] = true;
+      }
+    }
+  }
+
+private:
+  struct Node {
+    Node() { next.fill(-1); }
+    std::array<int32_t, 256> next;
+    int32_t fail{0};
+    std::vector<uint32_t> members;
+  };
+  std::vector<Node> m_nodes;
+};
+
+/*
+ * Extract a substring that every match of the pattern body must contain,
+ * or none.  The walk is deliberately conservative: any construct it does
+ * not fully understand either ends the current literal run or gives up on
+ * the pattern entirely, so a returned literal can never cause the
+ * prefilter to drop a member that would have matched.
+ */
+Optional<std::string> pcre_required_literal(const char* pattern,
+                                            int coptions) {
+  /* Whitespace and comments are insignificant under /x. */
+  if (coptions & PCRE_EXTENDED) return std::nullopt;
+  auto const caseless = (coptions & PCRE_CASELESS) != 0;
+  auto const utf8 = (coptions & PCRE_UTF8) != 0;
+
+  std::string best;
+  std::string run;
+  auto const flush = [&] {
+    /* A caseless literal would need a case-folding scan; only keep runs
+       with no alphabetic characters. */
+    if (caseless &&
+        std::any_of(run.begin(), run.end(),
+                    [](unsigned char c) { return isalpha(c); })) {
+      run.clear();
+    }
+    if (run.size() > best.size()) best = std::move(run);
+    run.clear();
+  };
+  /* A quantifier makes its preceding element optional (or repeatable);
+     drop the last byte of the run and seal what remains. */
+  auto const dropLastAndFlush = [&] {
+    if (!run.empty()) {
+      /* In UTF-8 mode the quantifier applies to a whole character, not the
+         trailing byte; don't reason about multi-byte characters. */
+      if (utf8 && (run.back() & 0x80)) return false;
+      run.pop_back();
+    }
+    flush();
+    return true;
+  };
+
+  for (auto p = pattern; *p; ) {
+    switch (*p) {
+      case '\\':
+        if (!p[1]) return std::nullopt;
+        if (p[1] == 'Q' || p[1] == 'E') {
+          /* \Q...\E quoting is zero-width punctuation, not an atom: a
+             quantifier after \E applies to the last quoted character, so
+             treating \E as a run boundary would promote bytes a later
+             quantifier makes optional. Give up on the pattern instead. */
+          return std::nullopt;
+        }
+        if (isalnum((unsigned char)p[1])) {
+          /* Class escapes (\d, \w, ...), assertions and backreferences:
+             none contribute a known literal byte. */
+          flush();
+        } else {
+          run += p[1];
+        }
+        p += 2;
+        break;
+      case '|':
+        /* Top-level alternation: no single mandatory substring. */
+        return std::nullopt;
+      case '(': {
+        /* Only plain (?: (?= (?! groups can be skipped safely. Every other
+           (?... construct either changes how the rest of the pattern
+           matches -- inline option setting like (?i) or (?x) applies from
+           that point on, so a literal extracted afterwards would be under
+           the wrong rules -- or is not worth modeling here (named groups,
+           lookbehind, conditionals, comments, recursion). */
+        if (p[1] == '?' && p[2] != ':' && p[2] != '=' && p[2] != '!') {
+          return std::nullopt;
+        }
+        /* Skip the whole group; alternation and quantifiers inside it are
+           then irrelevant, and the group contributes no literal. */
+        flush();
+        int depth = 1;
+        bool inClass = false;
+        p++;
+        while (*p && depth > 0) {
+          if (*p == '\\' && p[1]) {
+            p++;
+          } else if (inClass) {
+            if (*p == ']') inClass = false;
+          } else if (*p == '[') {
+            inClass = true;
+          } else if (*p == '(') {
+            depth++;
+          } else if (*p == ')') {
+            depth--;
+          }
+          p++;
+        }
+        if (depth > 0) return std::nullopt;
+        break;
+      }
+      case ')':
+        /* Unbalanced; don't try to reason about this pattern. */
+        return std::nullopt;
+      case '[':
+        flush();
+        p++;
+        if (*p == '^') p++;
+        if (*p == ']') p++;   /* leading ] is a literal member */
+        while (*p && *p != ']') {
+          if (*p == '\\' && p[1]) p++;
+          p++;
+        }
+        if (!*p) return std::nullopt;
+        p++;
+        break;
+      case '*': case '?':
+        if (!dropLastAndFlush()) return std::nullopt;
+        p++;
+        break;
+      case '{':
+        /* Treat counted repetition like '*' instead of parsing the bounds;
+           losing one byte of literal is harmless. */
+        if (!dropLastAndFlush()) return std::nullopt;
+        p++;
+        while (*p && *p != '}') p++;
+        if (!*p) return std::nullopt;
+        p++;
+        break;
+      case '+':
+        /* At least one occurrence is required, so the run up to and
+           including the repeated byte stays mandatory, but nothing may
+           join across the repetition. */
+        flush();
+        p++;
+        break;
+      case '.': case '^': case '$':
+        flush();
+        p++;
+        break;
+      default:
+        run += *p;
+        p++;
+        break;
+    }
+  }
+  flush();
+
+  /* Very short literals let too much through to pay for themselves. */
+  if (best.size() < 2) return std::nullopt;
+  return best;
+}
+
+/*
+ * Strip the delimiters and modifiers off a full regex, leaving the pattern
+ * body and the compile options the prefilter cares about.  The regex has
+ * already been through pcre_get_compiled_regex_cache, so parse failures
+ * here just mean "no prefilter" rather than an error.
+ */
+bool pcre_get_pattern_body(const std::string& regex, std::string* body,
+                           int* coptions) {
+  const char* p = regex.c_str();
+  while (isspace((int)*(unsigned char*)p)) p++;
+  if (*p == 0) return false;
+
+  char delimiter = *p++;
+  if (isalnum((int)*(unsigned char*)&delimiter) || delimiter == '\\') {
+    return false;
+  }
+  char start_delimiter = delimiter;
+  const char* pp = strchr("([{< )]}> )]}>", delimiter);
+  if (pp) delimiter = pp[5];
+  char end_delimiter = delimiter;
+
+  if (start_delimiter == end_delimiter) {
+    pp = p;
+    while (*pp != 0) {
+      if (*pp == '\\' && pp[1] != 0) pp++;
+      else if (*pp == delimiter) break;
+      pp++;
+    }
+  } else {
+    int brackets = 1;
+    pp = p;
+    while (*pp != 0) {
+      if (*pp == '\\' && pp[1] != 0) pp++;
+      else if (*pp == end_delimiter && --brackets <= 0) break;
+      else if (*pp == start_delimiter) brackets++;
+      pp++;
+    }
+  }
+  if (*pp == 0) return false;
+
+  body->assign(p, pp - p);
+
+  *coptions = 0;
+  for (pp++; *pp != 0; pp++) {
+    switch (*pp) {
+      case 'i': *coptions |= PCRE_CASELESS; break;
+      case 'x': *coptions |= PCRE_EXTENDED; break;
+      case 'u': *coptions |= PCRE_UTF8;     break;
+      default:                              break;
+    }
+  }
+  return true;
+}
+
+/*
+ * A set of patterns prepared for matching together against one subject:
+ * the members' required literals compiled into a combined automaton, plus
+ * the list of members that must always be confirmed because no usable
+ * literal could be extracted from them.  The member patterns themselves
+ * live in the regular per-pattern cache.
+ */
+struct pcre_set_entry {
+  std::vector<std::string> patterns;
+  std::unique_ptr<LiteralSetMatcher> prefilter;
+  std::vector<bool> always;
+};
+
+std::mutex s_pcreSetCacheLock;
+std::unordered_map<std::string, std::shared_ptr<const pcre_set_entry>>
+  s_pcreSetCache;
+
+std::shared_ptr<const pcre_set_entry>
+pcre_get_set_entry(const Array& patterns) {
+  /* Key the set on the concatenation of its members. */
+  std::string key;
+  for (ArrayIter iter(patterns); iter; ++iter) {
+    auto const pat = iter.second().toString();
+    key.append(pat.data(), pat.size());
+    key.push_back('\0');
+  }
+  {
+    std::lock_guard<std::mutex> g(s_pcreSetCacheLock);
+    auto const it = s_pcreSetCache.find(key);
+    if (it != s_pcreSetCache.end()) return it->second;
+  }
+
+  auto entry = std::make_shared<pcre_set_entry>();
+  std::vector<std::pair<std::string, uint32_t>> literals;
+  for (ArrayIter iter(patterns); iter; ++iter) {
+    auto const pat = iter.second().toString();
+    /* Validate and warm the per-pattern cache now, so one bad member
+       fails the whole set up front. */
+    PCRECache::Accessor accessor;
+    if (!pcre_get_compiled_regex_cache(accessor, pat.get())) return nullptr;
+
+    auto const id = (uint32_t)entry->patterns.size();
+    entry->patterns.emplace_back(pat.data(), pat.size());
+
+    std::string body;
+    int coptions;
+    Optional<std::string> literal;
+    if (pcre_get_pattern_body(entry->patterns.back(), &body, &coptions)) {
+      literal = pcre_required_literal(body.c_str(), coptions);
+    }
+    if (literal) {
+      ITRACE(2, "Set member {} prefilter literal: {}\n", id, *literal);
+      literals.emplace_back(std::move(*literal), id);
+      entry->always.push_back(false);
+    } else {
+      entry->always.push_back(true);
+    }
+  }
+  if (!literals.empty()) {
+    entry->prefilter = std::make_unique<LiteralSetMatcher>(literals);
+  }
+
+  std::lock_guard<std::mutex> g(s_pcreSetCacheLock);
+  auto const res = s_pcreSetCache.emplace(std::move(key), std::move(entry));
+  return res.first->second;
+}
+
+} // namespace
+
+Variant preg_match_set(const Array& patterns, const String& subject) {
+  if (patterns.empty()) {
+    return preg_return_no_error(Array::CreateVec());
+  }
+  auto const entry = pcre_get_set_entry(patterns);
+  if (!entry) return preg_return_bad_regex_error(false);
+
+  auto const n = entry->patterns.size();
+  auto candidate = entry->always;
+  if (entry->prefilter) {
+    entry->prefilter->scan(subject.data(), subject.size(), candidate);
+  }
+
+  auto ret = Array::CreateVec();
+  for (uint32_t i = 0; i < n; i++) {
+    if (!candidate[i]) continue;
+    String pat(entry->patterns[i]);
+    PCRECache::Accessor accessor;
+    if (!pcre_get_compiled_regex_cache(accessor, pat.get())) {
+      return preg_return_bad_regex_error(false);
+    }
+    const pcre_cache_entry* pce = accessor.get();
+
+    int size_offsets = 0;
+    int* offsets = create_offset_array(pce, size_offsets);
+    if (offsets == nullptr) {
+      return preg_return_internal_error(false);
+    }
+    SmartFreeHelper freer(offsets);
+
+    int count = 0;
+    if (pce->literal_data) {
+      assertx(pce->literal_data->isLiteral());
+      count = pce->literal_data->matches(subject.get(), 0, offsets, 0)
+        ? 1 : PCRE_ERROR_NOMATCH;
+    } else {
+      pcre_extra extra;
+      init_local_extra(&extra, pce->extra);
+      count = pcre_exec(pce->re, &extra, subject.data(), subject.size(),
+                        0, 0, offsets, size_offsets);
+    }
+    if (count == 0) {
+      raise_warning("Matched, but too many substrings");
+      count = pce->num_subpats;
+    } else if (count < 0 && count != PCRE_ERROR_NOMATCH) {
+      if (pcre_need_log_error(count)) {
+        pcre_log_error(__FUNCTION__, __LINE__, count,
+                       pat.data(), pat.size(),
+                       subject.data(), subject.size(),
+                       "", 0);
+      }
+      return preg_return_pcre_error(count, false);
+    }
+    if (count > 0) ret.append((int64_t)i);
+  }
+  return preg_return_no_error(std::move(ret));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static String preg_do_repl_func(const Variant& function, const String& subject,
@@ -138,6 +138,15 @@ Variant preg_match_all(StringData* pattern, const StringData* subject,
                        Variant* matches = nullptr,
                        int flags = 0, int offset = 0);
 
+/*
+ * Match a set of patterns against one subject in a single pass.  Returns a
+ * vec of the indices of the patterns that match, or false if any member of
+ * the set is not a valid pattern.  The set is compiled once (into a
+ * combined literal automaton used to prefilter members) and cached, so
+ * repeated calls with the same patterns only pay for the scan.
+ */
+Variant preg_match_set(const Array& patterns, const String& subject);
+
 Variant preg_replace_impl(const Variant& pattern, const Variant& replacement,
                           const Variant& subject, int limit, int64_t* count,
                           bool is_callable, bool is_filter);
@@ -32,6 +32,7 @@
 #include "hphp/runtime/base/implicit-context.h"
 #include "hphp/runtime/base/ini-setting.h"
 #include "hphp/runtime/base/init-fini-node.h"
+#include "hphp/runtime/base/jumpstart-bundle.h"
 #include "hphp/runtime/base/member-reflection.h"
 #include "hphp/runtime/base/memory-manager.h"
 #include "hphp/runtime/base/perf-mem-event.h"
@@ -69,6 +70,7 @@
 #include "hphp/runtime/server/rpc-request-handler.h"
 #include "hphp/runtime/server/server-note.h"
 #include "hphp/runtime/server/server-stats.h"
+#include "hphp/runtime/server/takeover-agent.h"
 #include "hphp/runtime/server/warmup-request-handler.h"
 #include "hphp/runtime/server/xbox-server.h"
 #include "hphp/runtime/vm/debug/debug.h"
@@ -79,6 +81,7 @@
 #include "hphp/runtime/vm/jit/prof-data.h"
 #include "hphp/runtime/vm/jit/tc.h"
 #include "hphp/runtime/vm/jit/translator.h"
+#include "hphp/runtime/vm/jit/vasm-prof.h"
 #include "hphp/runtime/vm/repo-file.h"
 #include "hphp/runtime/vm/repo-global-data.h"
 #include "hphp/runtime/vm/runtime-compiler.h"
@@ -93,6 +96,7 @@
 #include "hphp/util/compatibility.h"
 #include "hphp/util/embedded-data.h"
 #include "hphp/util/hardware-counter.h"
+#include "hphp/util/hash-set.h"
 #include "hphp/util/kernel-version.h"
 #ifndef _MSC_VER
 #include "hphp/util/light-process.h"
@@ -119,6 +123,7 @@
 #include <folly/Random.h>
 #include <folly/Range.h>
 #include <folly/Singleton.h>
+#include <folly/String.h>
 #include <folly/portability/Fcntl.h>
 #include <folly/portability/Libgen.h>
 #include <folly/portability/Stdlib.h>
@@ -153,7 +158,9 @@
 #include <iterator>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #ifdef _MSC_VER
@@ -1010,8 +1017,50 @@ static bool set_execution_mode(folly::StringPiece mode) {
   return false;
 }
 
+static void init_jumpstart_bundle() {
+  if (RuntimeOption::ServerJumpstartBundle.empty()) return;
+  auto const& path = RuntimeOption::ServerJumpstartBundle;
+  JumpstartBundle bundle;
+  std::string error;
+  if (!JumpstartBundle::open(path, bundle, error)) {
+    Logger::Error("Ignoring jumpstart bundle: %s", error.c_str());
+    return;
+  }
+  setActiveJumpstartBundle(std::move(bundle));
+
+  // Route each section to the loader that owns its artifact. The repo
+  // section is picked up by init_repo_file() and the JIT profile by the
+  // serdes path in hphp_process_init(); the APC snapshot and warmup
+  // manifest feed the existing option-driven loaders directly.
+  if (auto const apc =
+        jumpstartSection(JumpstartBundle::Section::ApcSnapshot)) {
+    apcExtension::SnapshotFile = path;
+    apcExtension::SnapshotOffset = apc->offset;
+    apcExtension::SnapshotSize = apc->size;
+  }
+  if (auto const manifest =
+        jumpstartSection(JumpstartBundle::Section::WarmupManifest)) {
+    std::string contents;
+    if (activeJumpstartBundle()->read(*manifest, contents)) {
+      std::vector<folly::StringPiece> lines;
+      folly::split('\n', contents, lines);
+      for (auto const& line : lines) {
+        if (line.empty() || line[0] == '#') continue;
+        RuntimeOption::ServerWarmupRequests.emplace_back(line.str());
+      }
+    } else {
+      Logger::Error("Failed reading warmup manifest from jumpstart bundle");
+    }
+  }
+  BootStats::mark("init_jumpstart_bundle");
+}
+
 static void init_repo_file() {
   if (!RO::RepoAuthoritative) return;
+  if (auto const repo = jumpstartSection(JumpstartBundle::Section::Repo)) {
+    RepoFile::init(activeJumpstartBundle()->path(), repo->offset, repo->size);
+    return;
+  }
   assertx(!RO::RepoPath.empty());
   RepoFile::init(RO::RepoPath);
 }
@@ -1088,6 +1137,7 @@ static int start_server(const std::string &username, int xhprof) {
   // Include hugetlb pages in core dumps.
   Process::SetCoreDumpHugePages();
 
+  init_jumpstart_bundle();
   init_repo_file();
   BootStats::mark("init_repo_file");
 
@@ -1134,12 +1184,16 @@ static int start_server(const std::string &username, int xhprof) {
 
   if (RO::RepoAuthoritative &&
       RO::RepoLocalReadaheadRate > 0 &&
-      !RO::RepoPath.empty()) {
+      (!RO::RepoPath.empty() || activeJumpstartBundle())) {
     HttpServer::CheckMemAndWait();
     readaheadThread = std::make_unique<std::thread>([&] {
         assertx(RuntimeOption::ServerExecutionMode());
         BootStats::Block timer("Readahead Repo", true);
-        auto path = RuntimeOption::RepoPath.c_str();
+        // With a jumpstart bundle, one sequential pass over the bundle pages
+        // in every boot artifact, not just the repo.
+        auto path = activeJumpstartBundle()
+          ? RuntimeOption::ServerJumpstartBundle.c_str()
+          : RuntimeOption::RepoPath.c_str();
         Logger::Info("readahead %s", path);
 #ifdef __linux__
         // glibc doesn't have a wrapper for ioprio_set(), so we need to use
@@ -1460,6 +1514,87 @@ std::vector<int> get_executable_lines(const Unit* compiled) {
   return lines;
 }
 
+/*
+ * Bytecode verification for "hhvm -m verify". Each given file is
+ * compiled (and therefore verified, since Eval.VerifyOnly is set),
+ * with the work spread across a pool of threads pulling files off a
+ * shared worklist. A verification failure _Exit(1)s the process from
+ * within UnitEmitter::create, so reaching the end of the worklist
+ * means every unit verified cleanly.
+ *
+ * If Eval.VerifyCachePath is set, the SHA1s of successfully verified
+ * units are appended to that file and consulted on subsequent runs, so
+ * unchanged files skip re-verification entirely.
+ */
+static int verify_files(const std::vector<std::string>& files) {
+  hphp_fast_string_set alreadyVerified;
+  if (!RO::EvalVerifyCachePath.empty()) {
+    std::ifstream cache{RO::EvalVerifyCachePath};
+    std::string line;
+    while (std::getline(cache, line)) {
+      if (!line.empty()) alreadyVerified.emplace(std::move(line));
+    }
+  }
+
+  std::atomic<size_t> next{0};
+  std::atomic<size_t> failed{0};
+  std::mutex lock;
+  std::vector<std::string> newlyVerified;
+
+  auto const work = [&] {
+    hphp_thread_init();
+    SCOPE_EXIT { hphp_thread_exit(); };
+    g_context.getCheck();
+
+    while (true) {
+      auto const idx = next.fetch_add(1, std::memory_order_relaxed);
+      if (idx >= files.size()) break;
+      auto const& file = files[idx];
+
+      std::ifstream fs{file};
+      if (!fs) {
+        std::cerr << "Unable to open \"" << file << "\"\n";
+        ++failed;
+        continue;
+      }
+      std::stringstream contents;
+      contents << fs.rdbuf();
+      auto const str = contents.str();
+
+      auto const sha1 = SHA1{
+        mangleUnitSha1(string_sha1(str), file, RepoOptions::defaults())
+      };
+      auto hex = sha1.toString();
+      if (alreadyVerified.count(hex)) continue;
+
+      compile_file(str.c_str(), str.size(), sha1, file.c_str(),
+                   Native::s_noNativeFuncs,
+                   RepoOptions::defaults(), nullptr);
+
+      std::lock_guard<std::mutex> _{lock};
+      newlyVerified.emplace_back(std::move(hex));
+    }
+  };
+
+  auto const numWorkers = std::min(
+    files.size(),
+    (size_t)(RO::EvalVerifyWorkers > 0
+      ? RO::EvalVerifyWorkers
+      : Process::GetCPUCount())
+  );
+  std::vector<std::thread> workers;
+  workers.reserve(numWorkers);
+  for (size_t i = 0; i < numWorkers; ++i) workers.emplace_back(work);
+  for (auto& t : workers) t.join();
+
+  if (!RO::EvalVerifyCachePath.empty() && !newlyVerified.empty()) {
+    std::ofstream cache{RO::EvalVerifyCachePath, std::ios::app};
+    for (auto const& hex : newlyVerified) cache << hex << '\n';
+  }
+
+  return failed.load() ? 1 : 0;
+}
+
 static int execute_program_impl(int argc, char** argv) {
   std::string usage = "Usage:\n\n   ";
   usage += argv[0];
@@ -1801,24 +1936,11 @@ static int execute_program_impl(int argc, char** argv) {
       return 1;
     }
 
-    auto const file = [] (std::string file) -> std::string {
+    auto const makePath = [] (std::string file) -> std::string {
       if (!FileUtil::isAbsolutePath(file)) {
         return SourceRootInfo::GetCurrentSourceRoot() + std::move(file);
       }
       return file;
-    }(po.file.empty() ? po.args[0] : po.file);
-
-    std::fstream fs(file, std::ios::in);
-    if (!fs) {
-      std::cerr << "Unable to open \"" << file << "\"\n";
-      return 1;
-    }
-    std::stringstream contents;
-    contents << fs.rdbuf();
-
-    auto const str = contents.str();
-    auto const sha1 = SHA1{
-      mangleUnitSha1(string_sha1(str), file, RepoOptions::defaults())
     };
 
     if (!registrationComplete) {
@@ -1841,14 +1963,34 @@ static int execute_program_impl(int argc, char** argv) {
     // Ensure write to SystemLib::s_inited is visible by other threads.
     std::atomic_thread_fence(std::memory_order_release);
 
+    if (po.mode == "verify") {
+      // Unlike the other modes, verify accepts any number of files and
+      // verifies them all.
+      std::vector<std::string> files;
+      if (!po.file.empty()) files.emplace_back(makePath(po.file));
+      for (auto const& arg : po.args) files.emplace_back(makePath(arg));
+      return verify_files(files);
+    }
+
+    auto const file = makePath(po.file.empty() ? po.args[0] : po.file);
+
+    std::fstream fs(file, std::ios::in);
+    if (!fs) {
+      std::cerr << "Unable to open \"" << file << "\"\n";
+      return 1;
+    }
+    std::stringstream contents;
+    contents << fs.rdbuf();
+
+    auto const str = contents.str();
+    auto const sha1 = SHA1{
+      mangleUnitSha1(string_sha1(str), file, RepoOptions::defaults())
+    };
+
     auto compiled = compile_file(str.c_str(), str.size(), sha1, file.c_str(),
                                  Native::s_noNativeFuncs,
                                  RepoOptions::defaults(), nullptr);
 
-    if (po.mode == "verify") {
-      return 0;
-    }
-
     // This will dump the hhas for file as EvalDumpHhas was set
     if (!compiled) {
       std::cerr << "Unable to compile \"" << file << "\"\n";
@@ -2534,8 +2676,17 @@ void hphp_process_init() {
   InitFiniNode::ProcessInit();
   BootStats::mark("extra_process_init");
 
+  // A JIT profile may live inside the jumpstart bundle; it is only usable
+  // in plain Deserialize mode, since the delete/takeover/append flows all
+  // need a writable standalone file.
+  auto const bundleProf =
+    jumpstartSection(JumpstartBundle::Section::JitProfile);
+  auto const profFromBundle = [&] {
+    return bundleProf &&
+      RuntimeOption::EvalJitSerdesMode == JitSerdesMode::Deserialize;
+  };
   if (RuntimeOption::RepoAuthoritative &&
-      !RuntimeOption::EvalJitSerdesFile.empty() &&
+      (!RuntimeOption::EvalJitSerdesFile.empty() || profFromBundle()) &&
       jit::mcgen::retranslateAllEnabled()) {
     auto const mode = RuntimeOption::EvalJitSerdesMode;
     auto const numWorkers = RuntimeOption::EvalJitWorkerThreadsForSerdes ?
@@ -2548,11 +2699,7 @@ void hphp_process_init() {
                  std::max(RO::EvalJitWorkerThreads, numWorkers));
       setup_extra_arenas(numArenas);
 #endif
-      return f(
-        RO::EvalJitSerdesFile,
-        RO::EvalJitParallelDeserialize ? numWorkers : 1,
-        false
-      );
+      return f(RO::EvalJitParallelDeserialize ? numWorkers : 1);
     };
 
     auto const rta = [&] (const std::string& mark, bool skipSerialize) {
@@ -2577,7 +2724,10 @@ void hphp_process_init() {
                       RO::EvalJitSerdesFile);
       }
 
-      auto const success = deserialize(jit::tryDeserializePartialProfData);
+      auto const success = deserialize([] (int n) {
+        return jit::tryDeserializePartialProfData(
+          RO::EvalJitSerdesFile, n, false);
+      });
       if (success) {
         if (RO::ServerExecutionMode()) {
           Logger::FInfo("Successfully deserialized partial profile-data file. "
@@ -2591,13 +2741,35 @@ void hphp_process_init() {
       }
     };
 
+    // If an old server is still running, ask it over the takeover socket to
+    // serialize and hand over its current JIT profile, replacing whatever
+    // profile file is on disk before the normal deserialization below.
+    if (RuntimeOption::ServerTakeoverProfileHandoff &&
+        RuntimeOption::ServerExecutionMode() &&
+        !RuntimeOption::TakeoverFilename.empty() &&
+        isJitDeserializing()) {
+      BootStats::Block timer("takeover profile handoff", true);
+      TakeoverAgent::fetchJitProfile(RuntimeOption::TakeoverFilename,
+                                     RuntimeOption::EvalJitSerdesFile,
+                                     std::chrono::seconds(60));
+    }
+
     if (isJitDeserializing()) {
       if (RuntimeOption::ServerExecutionMode()) {
         Logger::FInfo("JitDeserializeFrom: {}",
-                      RuntimeOption::EvalJitSerdesFile);
+                      profFromBundle()
+                        ? activeJumpstartBundle()->path() + " (bundle)"
+                        : RuntimeOption::EvalJitSerdesFile);
       }
 
-      auto const errMsg = deserialize(jit::deserializeProfData);
+      auto const errMsg = deserialize([&] (int n) {
+        if (profFromBundle()) {
+          return jit::deserializeProfData(
+            activeJumpstartBundle()->path(), n, false,
+            bundleProf->offset, bundleProf->size);
+        }
+        return jit::deserializeProfData(RO::EvalJitSerdesFile, n, false);
+      });
 
       if (mode == JitSerdesMode::DeserializeAndDelete) {
         // Delete the serialized profile data when we finish reading
@@ -2803,6 +2975,15 @@ void hphp_session_init(Treadmill::SessionKind session_kind,
       [] (PerfEvent) { setSurpriseFlag(PendingPerfEventFlag); }
     );
   }
+
+  auto const pbe_freq = RuntimeOption::EvalPerfBranchEventRequestFreq;
+  if (pbe_freq > 0 && folly::Random::rand32(pbe_freq) == 0) {
+    // Enable branch sampling for this request.
+    perf_event_enable_branches(
+      RuntimeOption::EvalPerfBranchEventSampleFreq,
+      [] (PerfEvent) { setSurpriseFlag(PendingPerfEventFlag); }
+    );
+  }
 }
 
 bool hphp_invoke_simple(const std::string& filename, bool warmupOnly) {
@@ -2971,6 +3152,11 @@ void hphp_session_exit(Transport* transport) {
   perf_event_consume(record_perf_mem_event);
   perf_event_disable();
 
+  // Flush any branch edges we sampled during the request.
+  if (RuntimeOption::EvalPerfBranchEventRequestFreq > 0) {
+    jit::log_perf_branch_profile();
+  }
+
   // Get some memory-related counters before tearing down the MemoryManager.
   auto entry = transport ? transport->getStructuredLogEntry() : nullptr;
   if (entry) tl_heap->recordStats(*entry);
@@ -37,6 +37,7 @@
 #include "hphp/util/smalllocks.h"
 #include "hphp/util/type-scan.h"
 
+#include "hphp/runtime/base/jumpstart-bundle.h"
 #include "hphp/runtime/base/rds-header.h"
 #include "hphp/runtime/base/rds-symbol.h"
 #include "hphp/runtime/vm/debug/debug.h"
@@ -574,14 +575,23 @@ void processInit() {
   addNewPersistentChunk(allocSize);
 
   // Attempt to load any RDS preassignments from the profiling file.
+  auto const bundleProf =
+    jumpstartSection(JumpstartBundle::Section::JitProfile);
+  auto const profFromBundle = bundleProf &&
+    RO::EvalJitSerdesMode == JitSerdesMode::Deserialize;
   if (RO::RepoAuthoritative &&
       RO::EvalReorderRDS &&
-      !RO::EvalJitSerdesFile.empty() &&
+      (!RO::EvalJitSerdesFile.empty() || profFromBundle) &&
       jit::mcgen::retranslateAllEnabled()) {
     s_settingPreAssignments = true;
     SCOPE_EXIT { s_settingPreAssignments = false; };
     if (isJitDeserializing()) {
-      jit::deserializeProfData(RO::EvalJitSerdesFile, 1, true);
+      if (profFromBundle) {
+        jit::deserializeProfData(activeJumpstartBundle()->path(), 1, true,
+                                 bundleProf->offset, bundleProf->size);
+      } else {
+        jit::deserializeProfData(RO::EvalJitSerdesFile, 1, true);
+      }
     } else if (isJitSerializing() &&
                jit::serializeOptProfEnabled() &&
                RO::EvalJitSerializeOptProfRestart) {
@@ -839,7 +849,7 @@ Ordering profiledOrdering() {
     }
   }
 
-  // Sort the symbols according to their hit count within their
+  // Sort the symbols according to their hit density within their
   // respective sections. The most hit symbols will cluster at the
   // beginning of the section.
   auto const order = [&] (const Map& map) {
@@ -856,6 +866,25 @@ Ordering profiledOrdering() {
     if (ordered.empty()) return ordered;
     assertx(total > 0);
 
+    // Avoid ordering symbols which are hit infrequently. There's
+    // little benefit to doing so.
+    ordered.erase(
+      std::remove_if(
+        ordered.begin(), ordered.end(),
+        [&] (const Ordering::Item& k) {
+          auto const it = map.find(k);
+          assertx(it != map.end());
+          assertx(it->second > 0);
+          return (double)it->second / total < RO::EvalRDSReorderThreshold;
+        }
+      ),
+      ordered.end()
+    );
+
+    // Sort by hits per byte rather than raw hit count. The point of the
+    // reordering is to pack as many accesses as possible into the first
+    // cache lines of the section, and a large symbol with a high raw count
+    // would otherwise push several small, hot symbols off of them.
     std::stable_sort(
       ordered.begin(), ordered.end(),
       [&] (const Ordering::Item& k1, const Ordering::Item& k2) {
@@ -863,24 +892,16 @@ Ordering profiledOrdering() {
         assertx(it1 != map.end());
         auto const it2 = map.find(k2);
         assertx(it2 != map.end());
+        assertx(k1.size > 0 && k2.size > 0);
+        auto const density1 = it1->second * (uint64_t)k2.size;
+        auto const density2 = it2->second * (uint64_t)k1.size;
+        if (density1 != density2) return density1 > density2;
         if (it1->second != it2->second) return it1->second > it2->second;
         if (k1.size != k2.size) return k1.size > k2.size;
         return k1.alignment > k2.alignment;
       }
     );
 
-    // Avoid ordering symbols which are hit infrequently. There's
-    // little benefit to doing so.
-    auto trimIt = ordered.begin();
-    while (trimIt != ordered.end()) {
-      auto const mapIt = map.find(*trimIt);
-      assertx(mapIt != map.end());
-      assertx(mapIt->second > 0);
-      auto const percentage = (double)mapIt->second / total;
-      if (percentage < RO::EvalRDSReorderThreshold) break;
-      ++trimIt;
-    }
-    ordered.erase(trimIt, ordered.end());
     return ordered;
   };
 
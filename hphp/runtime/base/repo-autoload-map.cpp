@@ -20,12 +20,152 @@
 #include "hphp/runtime/vm/repo-file.h"
 #include "hphp/util/assertions.h"
 
+#include <folly/hash/Hash.h>
+
+#include <algorithm>
+#include <numeric>
+
 TRACE_SET_MOD(repo_autoload);
 
 namespace HPHP {
 
 //////////////////////////////////////////////////////////////////////
 
+namespace {
+
+// How many seeds to try before concluding something is deeply wrong
+// with the symbol set (e.g. full 64-bit hash collisions with every
+// seed, which should never happen in practice).
+constexpr uint64_t kMaxBuildAttempts = 32;
+
+constexpr uint64_t kHashBasis = 0xcbf29ce484222325ULL;
+
+}
+
+template <typename Compare>
+uint64_t RepoSymbolMap<Compare>::hashSymbol(const StringData* name,
+                                            uint64_t seed) {
+  constexpr auto caseSensitive =
+    std::is_same<Compare, string_data_same>::value;
+  if (caseSensitive) {
+    return folly::hash::fnv64_buf(name->data(), name->size(),
+                                  kHashBasis ^ seed);
+  }
+  // Case-fold the same way string_data_isame compares (ASCII only),
+  // hashing a chunk at a time to avoid an allocation.
+  auto h = kHashBasis ^ seed;
+  auto data = name->data();
+  auto size = name->size();
+  char buf[256];
+  while (size > 0) {
+    auto const n = std::min<size_t>(size, sizeof(buf));
+    for (size_t i = 0; i < n; ++i) {
+      auto const c = data[i];
+      buf[i] = (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+    }
+    h = folly::hash::fnv64_buf(buf, n, h);
+    data += n;
+    size -= n;
+  }
+  return h;
+}
+
+template <typename Compare>
+Optional<int64_t> RepoSymbolMap<Compare>::find(const StringData* name) const {
+  if (entries.empty()) return std::nullopt;
+  auto const h = hashSymbol(name, seed);
+  auto const f = (uint32_t)h;
+  auto const g = (uint32_t)(h >> 32) | 1;
+  auto const& d = displacements[(h >> 32) % displacements.size()];
+  auto const slot = (f + d.first * g + d.second) % entries.size();
+  auto const& entry = entries[slot];
+  if (Compare{}(entry.first, name)) return entry.second;
+  return std::nullopt;
+}
+
+template <typename Compare>
+RepoSymbolMap<Compare>
+RepoSymbolMap<Compare>::build(std::vector<Entry> source) {
+  RepoSymbolMap map;
+  auto const n = source.size();
+  if (n == 0) return map;
+
+  struct KeyInfo {
+    uint64_t hash;
+    const Entry* entry;
+  };
+
+  for (uint64_t attempt = 0;; ++attempt) {
+    always_assert(attempt < kMaxBuildAttempts);
+    map.seed = attempt * 0x9e3779b97f4a7c15ULL;
+
+    // Bucket the keys on the upper half of their hash. Using as many
+    // buckets as keys keeps the buckets (and hence the displacement
+    // search) small.
+    std::vector<std::vector<KeyInfo>> buckets(n);
+    for (auto const& e : source) {
+      auto const h = hashSymbol(e.first, map.seed);
+      buckets[(h >> 32) % n].emplace_back(KeyInfo{h, &e});
+    }
+
+    // Place the largest buckets first, while the table is mostly
+    // empty. Single-key buckets can always be placed (sweeping the
+    // second displacement reaches every slot), so only multi-key
+    // buckets can fail, and only via full hash collisions.
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(
+      order.begin(), order.end(),
+      [&] (size_t a, size_t b) { return buckets[a].size() > buckets[b].size(); }
+    );
+
+    map.entries.assign(n, Entry{nullptr, -1});
+    map.displacements.assign(n, {0, 0});
+    std::vector<bool> used(n, false);
+    std::vector<uint32_t> slots;
+
+    auto ok = true;
+    for (auto const b : order) {
+      auto const& bucket = buckets[b];
+      if (bucket.empty()) break;
+
+      auto placed = false;
+      for (uint32_t d1 = 0; d1 < n && !placed; ++d1) {
+        for (uint32_t d2 = 0; d2 < n && !placed; ++d2) {
+          slots.clear();
+          for (auto const& k : bucket) {
+            auto const f = (uint32_t)k.hash;
+            auto const g = (uint32_t)(k.hash >> 32) | 1;
+            auto const slot = (f + d1 * g + d2) % n;
+            if (used[slot] ||
+                std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+              break;
+            }
+            slots.emplace_back(slot);
+          }
+          if (slots.size() != bucket.size()) continue;
+          for (size_t i = 0; i < bucket.size(); ++i) {
+            used[slots[i]] = true;
+            map.entries[slots[i]] = *bucket[i].entry;
+          }
+          map.displacements[b] = {d1, d2};
+          placed = true;
+        }
+      }
+      if (!placed) {
+        ok = false;
+        break;
+      }
+    }
+    if (ok) return map;
+  }
+}
+
+template struct RepoSymbolMap<string_data_isame>;
+template struct RepoSymbolMap<string_data_same>;
+
+//////////////////////////////////////////////////////////////////////
+
 using UnitToPathMap = tbb::concurrent_hash_map<int64_t, const StringData*>;
 
 namespace {
@@ -65,12 +205,12 @@ template <typename Compare>
 static Optional<String> getPathFromSymbol(
     const RepoAutoloadMap::Map<Compare>& map,
     const String& name) {
-  auto search = map.find(name.get());
-  if (search == map.end()) {
+  auto const search = map.find(name.get());
+  if (!search) {
     FTRACE(1, "Fail autoload {}\n", name.data());
     return {};
   }
-  auto unitSn = search->second;
+  auto unitSn = *search;
 
   UnitToPathMap::const_accessor acc;
   if (unitToPathMap.find(acc, unitSn)) {
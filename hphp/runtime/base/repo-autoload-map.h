@@ -16,10 +16,12 @@
 
 #pragma once
 
+#include <utility>
 #include <vector>
 
 #include "hphp/runtime/base/array-init.h"
 #include "hphp/runtime/base/autoload-map.h"
+#include "hphp/runtime/base/string-data.h"
 #include "hphp/runtime/base/type-string.h"
 #include "hphp/runtime/base/type-variant.h"
 
@@ -27,6 +29,51 @@ namespace HPHP {
 
 //////////////////////////////////////////////////////////////////////
 
+/**
+ * A minimal perfect hash table over the closed set of symbols in a
+ * repo, built at repo build time by RepoAutoloadMapBuilder.
+ *
+ * A lookup hashes the symbol once, reads the displacement pair for its
+ * bucket, and compares against the single candidate entry at the
+ * resulting slot, so both the hit and the miss path touch exactly one
+ * slot. Since the entries are serialized in slot order, loading the
+ * table is just filling two vectors -- no hashtable is constructed at
+ * process start.
+ *
+ * Compare determines key equality (and whether hashing case-folds):
+ * string_data_isame for types, functions and type-aliases,
+ * string_data_same for constants.
+ */
+template <typename Compare>
+struct RepoSymbolMap {
+  using Entry = std::pair<const StringData*, int64_t>;
+
+  // One entry per symbol, in slot order.
+  std::vector<Entry> entries;
+  // One displacement pair per bucket (there are as many buckets as
+  // entries), resolving collisions on the first-level hash.
+  std::vector<std::pair<uint32_t, uint32_t>> displacements;
+  // Seed for the symbol hash, chosen at build time so the
+  // displacement search succeeds.
+  uint64_t seed = 0;
+
+  // Hash a symbol name, case-folding it unless Compare is
+  // case-sensitive.
+  static uint64_t hashSymbol(const StringData* name, uint64_t seed);
+
+  // Build the table from the given entries (in any order).
+  static RepoSymbolMap build(std::vector<Entry> source);
+
+  // Return the unit-sn the symbol maps to, if any.
+  Optional<int64_t> find(const StringData* name) const;
+
+  size_t size() const { return entries.size(); }
+  auto begin() const { return entries.begin(); }
+  auto end() const { return entries.end(); }
+};
+
+//////////////////////////////////////////////////////////////////////
+
 /**
  * AutoloadMap using the info from the repo
  */
@@ -34,12 +81,7 @@ namespace HPHP {
 struct RepoAutoloadMap final : AutoloadMap {
 
   template <typename Compare>
-  using Map = hphp_fast_map<
-    const StringData*,
-    int64_t,
-    string_data_hash,
-    Compare
-  >;
+  using Map = RepoSymbolMap<Compare>;
 
   using CaseInsensitiveMap = Map<string_data_isame>;
   using CaseSensitiveMap = Map<string_data_same>;
@@ -60,6 +60,13 @@ inline int64_t CurrentMicroTime() {
 ////////////////////////////////////////////////////////////////////////////////
 }
 
+namespace ring {
+namespace detail { extern bool g_enabled; }
+inline bool enabled() { return detail::g_enabled; }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 inline Event::Event(folly::StringPiece name) : m_name(name) {}
 
 inline folly::StringPiece Event::name() const {
@@ -190,7 +197,7 @@ inline EventGuard::EventGuard(
 ) : m_trace(t && t->hasActiveScope() ? t : nullptr)
   , m_event(name)
 {
-  if (m_trace) m_event.begin(ts);
+  if (m_trace || ring::enabled()) m_event.begin(ts);
 }
 
 inline EventGuard::~EventGuard() {
@@ -209,6 +216,9 @@ inline void EventGuard::finish(Optional<timespec> t) {
     m_event.end(t);
     m_trace->appendEvent(std::move(m_event));
     m_trace = nullptr;
+  } else if (m_event.m_startMicro && !m_event.m_stopMicro) {
+    m_event.end(t);
+    ring::record(m_event.name(), m_event.m_startMicro, m_event.m_stopMicro);
   }
 }
 
@@ -220,8 +230,10 @@ inline ScopeGuard::ScopeGuard(
   Optional<timespec> ts
 ) : m_trace(t)
   , m_scope(t ? &t->createScope(name) : nullptr)
+  , m_ringEvent(name)
 {
   if (m_scope) m_scope->begin(ts);
+  else if (ring::enabled()) m_ringEvent.begin(ts);
 }
 
 inline ScopeGuard::~ScopeGuard() {
@@ -246,6 +258,10 @@ inline void ScopeGuard::finish(Optional<timespec> t) {
     m_trace->finishScope();
     m_trace = nullptr;
     m_scope = nullptr;
+  } else if (m_ringEvent.m_startMicro && !m_ringEvent.m_stopMicro) {
+    m_ringEvent.end(t);
+    ring::record(m_ringEvent.name(), m_ringEvent.m_startMicro,
+                 m_ringEvent.m_stopMicro);
   }
 }
 
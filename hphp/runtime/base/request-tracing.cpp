@@ -17,9 +17,20 @@
 #include "hphp/runtime/base/request-tracing.h"
 
 #include "hphp/runtime/base/execution-context.h"
+#include "hphp/runtime/base/init-fini-node.h"
+#include "hphp/runtime/base/runtime-option.h"
 #include "hphp/runtime/base/static-string-table.h"
 #include "hphp/runtime/base/type-string.h"
 
+#include <folly/ScopeGuard.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 namespace HPHP { namespace rqtrace {
 
 namespace detail { AtomicEventMap g_events{128}; }
@@ -72,4 +83,141 @@ DisableTracing::~DisableTracing() {
   if (m_trace) g_context->setRequestTrace(m_trace);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ring {
+
+namespace detail { bool g_enabled = false; }
+
+namespace {
+
+constexpr uint32_t kRingCapacity = 4096;
+
+struct Buffer {
+  Record records[kRingCapacity];
+  // Total records appended this request; slot = count % kRingCapacity, so
+  // once the ring wraps the oldest records are overwritten.
+  uint32_t count{0};
+};
+
+// Leaked per-thread; request threads are long-lived and the buffer is
+// reused (not cleared) across requests.
+__thread Buffer* tl_ring{nullptr};
+
+std::mutex s_lock;
+std::condition_variable s_cv;
+std::deque<RetainedTrace> s_retained;
+std::function<void(const RetainedTrace&)> s_exporter;
+std::thread s_exportThread;
+bool s_exportThreadStarted = false;
+bool s_shutdown = false;
+std::atomic<uint64_t> s_requestCounter{0};
+
+// Without a registered exporter, fold retained records into the
+// process-wide event stats so they remain visible via the admin server.
+// Traced requests never write the ring, so this doesn't double count.
+void defaultExport(const RetainedTrace& trace) {
+  for (auto const& rec : trace.records) {
+    auto const result = rqtrace::detail::g_events.emplace(
+      rec.name, rqtrace::detail::AtomicEventStats::Empty{});
+    auto& stats = result.first->second;
+    stats.total_count++;
+    stats.total_duration += rec.stopMicro - rec.startMicro;
+  }
+}
+
+void exportLoop() {
+  std::unique_lock<std::mutex> guard(s_lock);
+  while (true) {
+    s_cv.wait(guard, [] { return s_shutdown || !s_retained.empty(); });
+    while (!s_retained.empty()) {
+      auto trace = std::move(s_retained.front());
+      s_retained.pop_front();
+      auto const exporter = s_exporter;
+      guard.unlock();
+      if (exporter) exporter(trace);
+      else defaultExport(trace);
+      guard.lock();
+    }
+    if (s_shutdown) return;
+  }
+}
+
+InitFiniNode s_ringShutdown([] { shutdown(); },
+                            InitFiniNode::When::ProcessExit);
+
+InitFiniNode s_ringEnable(
+  [] { detail::g_enabled = RO::EvalRqTraceRingEnabled; },
+  InitFiniNode::When::PostRuntimeOptions
+);
+
+}
+
+void record(folly::StringPiece name, uint64_t startMicro, uint64_t stopMicro) {
+  if (UNLIKELY(!tl_ring)) {
+    if (!enabled()) return;
+    tl_ring = new Buffer();
+  }
+  auto& rec = tl_ring->records[tl_ring->count++ % kRingCapacity];
+  rec.name = makeStaticString(name);
+  rec.startMicro = startMicro;
+  rec.stopMicro = stopMicro;
+}
+
+void requestExit(uint64_t wallTimeMicro) {
+  if (!tl_ring || !tl_ring->count) return;
+  SCOPE_EXIT { tl_ring->count = 0; };
+
+  auto const rate = RO::EvalRqTraceRingSampleRate;
+  auto const sampled = rate &&
+    s_requestCounter.fetch_add(1, std::memory_order_relaxed) % rate == 0;
+  auto const threshold = RO::EvalRqTraceRingRetainThresholdUs;
+  auto const slow = threshold && wallTimeMicro >= threshold;
+  if (!sampled && !slow) return;
+
+  RetainedTrace trace;
+  trace.wallTimeMicro = wallTimeMicro;
+  auto const count = tl_ring->count;
+  trace.records.reserve(std::min(count, kRingCapacity));
+  // Copy in chronological order; when the ring wrapped the oldest surviving
+  // record is at count % kRingCapacity.
+  auto const first = count <= kRingCapacity ? 0 : count % kRingCapacity;
+  auto const n = std::min(count, kRingCapacity);
+  for (uint32_t i = 0; i < n; ++i) {
+    trace.records.push_back(tl_ring->records[(first + i) % kRingCapacity]);
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(s_lock);
+    if (s_shutdown) return;
+    auto const cap = std::max<uint32_t>(RO::EvalRqTraceRingRetainedBuffers, 1);
+    while (s_retained.size() >= cap) {
+      s_retained.pop_front();
+    }
+    s_retained.emplace_back(std::move(trace));
+    if (!s_exportThreadStarted) {
+      s_exportThreadStarted = true;
+      s_exportThread = std::thread(exportLoop);
+    }
+  }
+  s_cv.notify_one();
+}
+
+void register_exporter(std::function<void(const RetainedTrace&)> f) {
+  std::lock_guard<std::mutex> guard(s_lock);
+  s_exporter = std::move(f);
+}
+
+void shutdown() {
+  {
+    std::lock_guard<std::mutex> guard(s_lock);
+    if (s_shutdown) return;
+    s_shutdown = true;
+  }
+  s_cv.notify_one();
+  if (s_exportThreadStarted) s_exportThread.join();
+}
+
+}
+
 }}
@@ -40,6 +40,8 @@
  * additional information to all contained events (which will be accessible via
  * the extensible interface).
  */
+namespace HPHP { struct StringData; }
+
 namespace HPHP { namespace rqtrace {
 
 struct EventStats { uint64_t total_duration; uint64_t total_count; };
@@ -74,6 +76,8 @@ private:
   AnnotationMap m_annot;
 
   friend struct Scope;
+  friend struct EventGuard;
+  friend struct ScopeGuard;
 };
 
 struct Scope : Event {
@@ -173,6 +177,7 @@ struct ScopeGuard final {
 private:
   Trace* m_trace;
   Scope* m_scope;
+  Event m_ringEvent;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -222,6 +227,48 @@ void register_trace_hook(std::function<void(const Trace&)>);
 
 EventStats process_stats_for(folly::StringPiece);
 
+////////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Always-on ring tracing.
+ *
+ * The guards above only capture events for requests that opted into full
+ * tracing, and a Trace allocates strings and maps per event — too expensive
+ * to leave on fleet-wide. When Eval.RqTraceRingEnabled is set, guards in
+ * untraced requests instead append a fixed-size binary record (a static
+ * string name and two timestamps) to a per-thread ring, so the record path
+ * is a name intern plus two stores on top of the clock reads the guard
+ * already performs.
+ *
+ * At request end the ring is retained for one request in
+ * Eval.RqTraceRingSampleRate, and for any request whose wall time exceeds
+ * Eval.RqTraceRingRetainThresholdUs — the outliers worth keeping. Retained
+ * rings are queued (bounded by Eval.RqTraceRingRetainedBuffers, oldest
+ * dropped first) and drained by a background exporter thread, which hands
+ * them to the function installed with register_exporter(); with no exporter
+ * installed the records are folded into the process-wide event stats above.
+ */
+namespace ring {
+
+struct Record {
+  const StringData* name;   // static string, safe to read after the request
+  uint64_t startMicro;
+  uint64_t stopMicro;
+};
+
+struct RetainedTrace {
+  uint64_t wallTimeMicro;
+  std::vector<Record> records;
+};
+
+bool enabled();
+void record(folly::StringPiece name, uint64_t startMicro, uint64_t stopMicro);
+void requestExit(uint64_t wallTimeMicro);
+void register_exporter(std::function<void(const RetainedTrace&)>);
+void shutdown();
+
+}
+
 template<class F>
 void visit_process_stats(F&&);
 
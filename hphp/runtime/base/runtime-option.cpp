@@ -57,6 +57,7 @@
 #include "hphp/util/hardware-counter.h"
 #include "hphp/util/hdf.h"
 #include "hphp/util/light-process.h"
+#include "hphp/util/lock-contention.h"
 #include "hphp/util/log-file-flusher.h"
 #include "hphp/util/logger.h"
 #include "hphp/util/network.h"
@@ -653,11 +654,14 @@ bool RuntimeOption::EvalAuthoritativeMode = false;
 bool RuntimeOption::DumpPreciseProfData = true;
 uint32_t RuntimeOption::EvalInitialStaticStringTableSize =
   kDefaultInitialStaticStringTableSize;
+uint32_t RuntimeOption::EvalStaticStringTableShards = 1;
 uint32_t RuntimeOption::EvalInitialNamedEntityTableSize = 30000;
+uint32_t RuntimeOption::EvalNamedEntityFilterSize = 0;
 JitSerdesMode RuntimeOption::EvalJitSerdesMode{};
 int RuntimeOption::ProfDataTTLHours = 24;
 std::string RuntimeOption::ProfDataTag;
 std::string RuntimeOption::EvalJitSerdesFile;
+std::set<std::string, stdltistr> RuntimeOption::EvalJitInliningHotEndpoints;
 
 std::map<std::string, ErrorLogFileData> RuntimeOption::ErrorLogs = {
   {Logger::DEFAULT, ErrorLogFileData()},
@@ -690,6 +694,7 @@ int64_t RuntimeOption::SerializationSizeLimit = StringData::MaxSize;
 
 std::string RuntimeOption::AccessLogDefaultFormat = "%h %l %u %t \"%r\" %>s %b";
 std::map<std::string, AccessLogFileData> RuntimeOption::AccessLogs;
+int RuntimeOption::AccessLogAsyncWriteQueueSize = 0;
 
 std::string RuntimeOption::AdminLogFormat = "%h %t %s %U";
 std::string RuntimeOption::AdminLogFile;
@@ -719,6 +724,7 @@ int RuntimeOption::ServerWarmupThrottleThreadCount = 0;
 int RuntimeOption::ServerThreadDropCacheTimeoutSeconds = 0;
 int RuntimeOption::ServerThreadJobLIFOSwitchThreshold = INT_MAX;
 int RuntimeOption::ServerThreadJobMaxQueuingMilliSeconds = -1;
+int RuntimeOption::ServerThreadJobAgingMilliSeconds = -1;
 bool RuntimeOption::AlwaysDecodePostDataDefault = true;
 bool RuntimeOption::ServerThreadDropStack = false;
 bool RuntimeOption::ServerHttpSafeMode = false;
@@ -737,10 +743,20 @@ unsigned RuntimeOption::ServerExtendedWarmupRepeat = 1;
 unsigned RuntimeOption::ServerExtendedWarmupDelaySeconds = 60;
 std::vector<std::string> RuntimeOption::ServerWarmupRequests;
 std::vector<std::string> RuntimeOption::ServerExtendedWarmupRequests;
+std::string RuntimeOption::ServerWarmupCorpusDir;
+std::string RuntimeOption::ServerJumpstartBundle;
+int64_t RuntimeOption::ServerRequestRecordSampleRate = 0;
+std::string RuntimeOption::ServerRequestRecordDir;
+bool RuntimeOption::ServerAdmissionControlEnable = false;
+int RuntimeOption::ServerAdmissionTargetQueueDelayMs = 100;
+int RuntimeOption::ServerAdmissionShedQueueDelayMs = 500;
+int RuntimeOption::ServerAdmissionUpdatePeriodMs = 1000;
 std::string RuntimeOption::ServerCleanupRequest;
 int RuntimeOption::ServerInternalWarmupThreads = 0;
 boost::container::flat_set<std::string>
 RuntimeOption::ServerHighPriorityEndPoints;
+std::vector<std::string> RuntimeOption::ServerHighPriorityEndPointPatterns;
+int RuntimeOption::ServerNormalPriorityMaxActiveRequests = 0;
 bool RuntimeOption::ServerExitOnBindFail;
 int RuntimeOption::PageletServerThreadCount = 0;
 int RuntimeOption::PageletServerHugeThreadCount = 0;
@@ -781,6 +797,8 @@ int RuntimeOption::ZstdCompressionEnabled = -1;
 int RuntimeOption::ZstdCompressionLevel = 3;
 int RuntimeOption::ZstdWindowLog = 0;
 int RuntimeOption::ZstdChecksumRate = 0;
+std::string RuntimeOption::ZstdCompressionDictionaryPath;
+std::unordered_map<std::string, int> RuntimeOption::ZstdCompressionLevelUrls;
 int RuntimeOption::GzipCompressionLevel = 3;
 int RuntimeOption::GzipMaxCompressionLevel = 9;
 bool RuntimeOption::EnableKeepAlive = true;
@@ -901,6 +919,7 @@ bool RuntimeOption::UnserializationWhitelistCheckWarningOnly = true;
 int64_t RuntimeOption::UnserializationBigMapThreshold = 1 << 16;
 
 std::string RuntimeOption::TakeoverFilename;
+bool RuntimeOption::ServerTakeoverProfileHandoff = false;
 std::string RuntimeOption::AdminServerIP;
 int RuntimeOption::AdminServerPort = 0;
 int RuntimeOption::AdminThreadCount = 1;
@@ -923,6 +942,7 @@ bool RuntimeOption::AlwaysUseRelativePath = false;
 
 int RuntimeOption::HttpDefaultTimeout = 30;
 int RuntimeOption::HttpSlowQueryThreshold = 5000; // ms
+bool RuntimeOption::HttpCurlConnectionPool = false;
 
 bool RuntimeOption::NativeStackTrace = false;
 bool RuntimeOption::ServerErrorMessage = false;
@@ -1307,6 +1327,7 @@ int RuntimeOption::Fb303ServerPoolThreads = 1;
 double RuntimeOption::XenonPeriodSeconds = 0.0;
 uint32_t RuntimeOption::XenonRequestFreq = 1;
 bool RuntimeOption::XenonForceAlwaysOn = false;
+uint32_t RuntimeOption::XenonStackWalkLimit = 0;
 
 bool RuntimeOption::StrobelightEnabled = false;
 
@@ -1727,6 +1748,8 @@ void RuntimeOption::Load(
                  config, "Log.ForceErrorReportingLevel", 0);
     Config::Bind(AccessLogDefaultFormat, ini, config,
                  "Log.AccessLogDefaultFormat", "%h %l %u %t \"%r\" %>s %b");
+    Config::Bind(AccessLogAsyncWriteQueueSize, ini, config,
+                 "Log.AccessLogAsyncWriteQueueSize", 0);
 
     auto parseLogs = [] (const Hdf &config, const IniSetting::Map& ini,
                          const std::string &name,
@@ -1971,9 +1994,15 @@ void RuntimeOption::Load(
     Config::Bind(EvalInitialNamedEntityTableSize, ini, config,
                  "Eval.InitialNamedEntityTableSize",
                  EvalInitialNamedEntityTableSize);
+    Config::Bind(EvalNamedEntityFilterSize, ini, config,
+                 "Eval.NamedEntityFilterSize",
+                 EvalNamedEntityFilterSize);
     Config::Bind(EvalInitialStaticStringTableSize, ini, config,
                  "Eval.InitialStaticStringTableSize",
                  EvalInitialStaticStringTableSize);
+    Config::Bind(EvalStaticStringTableShards, ini, config,
+                 "Eval.StaticStringTableShards",
+                 EvalStaticStringTableShards);
 
     static std::string jitSerdesMode;
     Config::Bind(jitSerdesMode, ini, config, "Eval.JitSerdesMode", "Off");
@@ -1992,6 +2021,8 @@ void RuntimeOption::Load(
     }();
     Config::Bind(EvalJitSerdesFile, ini, config,
                  "Eval.JitSerdesFile", EvalJitSerdesFile);
+    Config::Bind(EvalJitInliningHotEndpoints, ini, config,
+                 "Eval.JitInliningHotEndpoints", EvalJitInliningHotEndpoints);
     // DumpPreciseProfileData defaults to true only when we can possibly write
     // profile data to disk.  It can be set to false to avoid the performance
     // penalty of only running the interpreter during retranslateAll.  We will
@@ -2036,6 +2067,9 @@ void RuntimeOption::Load(
     g_useTHPUponHugeTLBFailure =
       Config::GetBool(ini, config, "Eval.UseTHPUponHugeTLBFailure",
                       g_useTHPUponHugeTLBFailure);
+    g_lowArenaMergeable =
+      Config::GetBool(ini, config, "Eval.LowArenaMergeable",
+                      g_lowArenaMergeable);
 #endif
     s_enable_static_arena =
       Config::GetBool(ini, config, "Eval.UseTLStaticArena", true);
@@ -2063,6 +2097,7 @@ void RuntimeOption::Load(
                           EvalProfileHWExcludeKernel,
                           EvalProfileHWFastReads,
                           EvalProfileHWExportInterval);
+    LockContention::setSampleRate(EvalLockContentionSampleRate);
 
     Config::Bind(EnableIntrinsicsExtension, ini,
                  config, "Eval.EnableIntrinsicsExtension",
@@ -2249,6 +2284,8 @@ void RuntimeOption::Load(
                  ServerThreadJobLIFOSwitchThreshold);
     Config::Bind(ServerThreadJobMaxQueuingMilliSeconds, ini, config,
                  "Server.ThreadJobMaxQueuingMilliSeconds", -1);
+    Config::Bind(ServerThreadJobAgingMilliSeconds, ini, config,
+                 "Server.ThreadJobAgingMilliSeconds", -1);
     Config::Bind(ServerThreadDropStack, ini, config, "Server.ThreadDropStack");
     Config::Bind(ServerHttpSafeMode, ini, config, "Server.HttpSafeMode");
     Config::Bind(ServerStatCache, ini, config, "Server.StatCache", false);
@@ -2276,11 +2313,31 @@ void RuntimeOption::Load(
     Config::Bind(ServerWarmupRequests, ini, config, "Server.WarmupRequests");
     Config::Bind(ServerExtendedWarmupRequests, ini, config,
                  "Server.ExtendedWarmup.Requests");
+    Config::Bind(ServerWarmupCorpusDir, ini, config,
+                 "Server.WarmupCorpusDir", "");
+    Config::Bind(ServerJumpstartBundle, ini, config,
+                 "Server.JumpstartBundle", "");
+    Config::Bind(ServerRequestRecordSampleRate, ini, config,
+                 "Server.RequestRecordSampleRate", 0);  // 0 = off
+    Config::Bind(ServerRequestRecordDir, ini, config,
+                 "Server.RequestRecordDir", "");
+    Config::Bind(ServerAdmissionControlEnable, ini, config,
+                 "Server.Admission.Enable", false);
+    Config::Bind(ServerAdmissionTargetQueueDelayMs, ini, config,
+                 "Server.Admission.TargetQueueDelayMs", 100);
+    Config::Bind(ServerAdmissionShedQueueDelayMs, ini, config,
+                 "Server.Admission.ShedQueueDelayMs", 500);
+    Config::Bind(ServerAdmissionUpdatePeriodMs, ini, config,
+                 "Server.Admission.UpdatePeriodMs", 1000);
     Config::Bind(ServerCleanupRequest, ini, config, "Server.CleanupRequest");
     Config::Bind(ServerInternalWarmupThreads, ini, config,
                  "Server.InternalWarmupThreads", 0);  // 0 = skip
     Config::Bind(ServerHighPriorityEndPoints, ini, config,
                  "Server.HighPriorityEndPoints");
+    Config::Bind(ServerHighPriorityEndPointPatterns, ini, config,
+                 "Server.HighPriorityEndPointPatterns");
+    Config::Bind(ServerNormalPriorityMaxActiveRequests, ini, config,
+                 "Server.NormalPriorityMaxActiveRequests", 0);
     Config::Bind(ServerExitOnBindFail, ini, config, "Server.ExitOnBindFail",
                  false);
 
@@ -2347,6 +2404,10 @@ void RuntimeOption::Load(
                  "Server.ZstdCompressionLevel", 3);
     Config::Bind(ZstdChecksumRate, ini, config,
                 "Server.ZstdChecksumRate", 0);
+    Config::Bind(ZstdCompressionDictionaryPath, ini, config,
+                 "Server.ZstdCompressionDictionaryPath", "");
+    Config::Bind(ZstdCompressionLevelUrls, ini, config,
+                 "Server.ZstdCompressionLevelUrls");
     Config::Bind(GzipCompressionLevel, ini, config,
                  "Server.GzipCompressionLevel", 3);
     Config::Bind(GzipMaxCompressionLevel, ini, config,
@@ -2373,6 +2434,8 @@ void RuntimeOption::Load(
     Config::Bind(AlwaysPopulateRawPostData, ini, config,
                  "Server.AlwaysPopulateRawPostData", false);
     Config::Bind(TakeoverFilename, ini, config, "Server.TakeoverFilename");
+    Config::Bind(ServerTakeoverProfileHandoff, ini, config,
+                 "Server.TakeoverProfileHandoff", false);
     Config::Bind(ExpiresActive, ini, config, "Server.ExpiresActive", true);
     Config::Bind(ExpiresDefault, ini, config, "Server.ExpiresDefault", 2592000);
     if (ExpiresDefault < 0) ExpiresDefault = 2592000;
@@ -2694,6 +2757,8 @@ void RuntimeOption::Load(
     Config::Bind(HttpDefaultTimeout, ini, config, "Http.DefaultTimeout", 30);
     Config::Bind(HttpSlowQueryThreshold, ini, config, "Http.SlowQueryThreshold",
                  5000);
+    Config::Bind(HttpCurlConnectionPool, ini, config,
+                 "Http.CurlConnectionPool", false);
   }
   {
     // Debug
@@ -2817,6 +2882,7 @@ void RuntimeOption::Load(
     Config::Bind(XenonPeriodSeconds, ini, config, "Xenon.Period", 0.0);
     Config::Bind(XenonRequestFreq, ini, config, "Xenon.RequestFreq", 1);
     Config::Bind(XenonForceAlwaysOn, ini, config, "Xenon.ForceAlwaysOn", false);
+    Config::Bind(XenonStackWalkLimit, ini, config, "Xenon.StackWalkLimit", 0);
   }
   {
     // Strobelight
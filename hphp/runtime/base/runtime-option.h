@@ -276,6 +276,9 @@ struct RuntimeOption {
 
   static std::string AccessLogDefaultFormat;
   static std::map<std::string, AccessLogFileData> AccessLogs;
+  // Lines buffered per access log writer for its background write thread;
+  // 0 writes log lines synchronously on the request thread.
+  static int AccessLogAsyncWriteQueueSize;
 
   static std::string AdminLogFormat;
   static std::string AdminLogFile;
@@ -308,6 +311,7 @@ struct RuntimeOption {
   static int ServerThreadDropCacheTimeoutSeconds;
   static int ServerThreadJobLIFOSwitchThreshold;
   static int ServerThreadJobMaxQueuingMilliSeconds;
+  static int ServerThreadJobAgingMilliSeconds;
   static bool AlwaysDecodePostDataDefault;
   static bool ServerThreadDropStack;
   static bool ServerHttpSafeMode;
@@ -326,9 +330,36 @@ struct RuntimeOption {
   static unsigned ServerExtendedWarmupDelaySeconds;
   static std::vector<std::string> ServerWarmupRequests;
   static std::vector<std::string> ServerExtendedWarmupRequests;
+  // Directory of recorded requests to replay across the worker pool before
+  // the port opens; see ServerRequestRecordSampleRate for capturing one.
+  static std::string ServerWarmupCorpusDir;
+  // Path to a jumpstart bundle: a single container holding the repo file,
+  // serialized JIT profile, APC snapshot, and warmup manifest. See
+  // jumpstart-bundle.h.
+  static std::string ServerJumpstartBundle;
+  // When nonzero, record one in this many requests (as replayable .hdf
+  // files) into ServerRequestRecordDir, to build a warmup corpus from live
+  // traffic.
+  static int64_t ServerRequestRecordSampleRate;
+  static std::string ServerRequestRecordDir;
+  // Adaptive admission control for the page server; see
+  // server/admission-controller.h.
+  static bool ServerAdmissionControlEnable;
+  static int ServerAdmissionTargetQueueDelayMs;
+  static int ServerAdmissionShedQueueDelayMs;
+  static int ServerAdmissionUpdatePeriodMs;
   static std::string ServerCleanupRequest;
   static int ServerInternalWarmupThreads;
   static boost::container::flat_set<std::string> ServerHighPriorityEndPoints;
+  // Shell-style wildcard patterns (fnmatch) matched against the request
+  // path, in addition to the exact matches above. Classification runs on
+  // the IO threads, so these are not pcre patterns.
+  static std::vector<std::string> ServerHighPriorityEndPointPatterns;
+  // When nonzero, at most this many normal-priority requests execute
+  // concurrently, keeping workers available for high-priority endpoints
+  // while slow requests saturate the box. High-priority work may still
+  // use the entire pool.
+  static int ServerNormalPriorityMaxActiveRequests;
   static bool ServerExitOnBindFail;
   static int PageletServerThreadCount;
   static int PageletServerHugeThreadCount;
@@ -382,6 +413,12 @@ struct RuntimeOption {
   static int ZstdCompressionLevel;
   static int ZstdWindowLog;
   static int ZstdChecksumRate;
+  // Path to a trained zstd dictionary shared by all zstd response
+  // compressors; empty disables dictionary compression.
+  static std::string ZstdCompressionDictionaryPath;
+  // URL prefix => zstd compression level, overriding ZstdCompressionLevel
+  // for matching requests (longest matching prefix wins).
+  static std::unordered_map<std::string, int> ZstdCompressionLevelUrls;
   static int GzipCompressionLevel;
   static int GzipMaxCompressionLevel;
   static bool EnableKeepAlive;
@@ -534,6 +571,9 @@ struct RuntimeOption {
   static int64_t UnserializationBigMapThreshold;
 
   static std::string TakeoverFilename;
+  // Hand the serialized JIT profile over the takeover socket during binary
+  // takeover, so the new process boots from the old one's current profile.
+  static bool ServerTakeoverProfileHandoff;
   static std::string AdminServerIP;
   static int AdminServerPort;
   static int AdminThreadCount;
@@ -562,6 +602,9 @@ struct RuntimeOption {
 
   static int  HttpDefaultTimeout;
   static int  HttpSlowQueryThreshold;
+  // Keep curl connections, DNS entries, and TLS sessions alive across
+  // requests via a process-level share; see ext/curl/curl-connection-pool.h.
+  static bool HttpCurlConnectionPool;
 
   static bool NativeStackTrace;
   static bool ServerErrorMessage;
@@ -629,10 +672,17 @@ struct RuntimeOption {
   static bool LookForTypechecker;
   static bool AutoTypecheck;
   static uint32_t EvalInitialStaticStringTableSize;
+  static uint32_t EvalStaticStringTableShards;
   static uint32_t EvalInitialNamedEntityTableSize;
+  // Expected number of named entities; sizes the negative-lookup bloom
+  // filter over the NamedEntity table.  0 disables the filter.
+  static uint32_t EvalNamedEntityFilterSize;
   static JitSerdesMode EvalJitSerdesMode;
   static int ProfDataTTLHours;
   static std::string EvalJitSerdesFile;
+  // Functions whose translations get their inlining budgets scaled by
+  // Eval.HHIRInliningHotEndpointFactor; see inlining-decider.cpp.
+  static std::set<std::string, stdltistr> EvalJitInliningHotEndpoints;
   static std::string ProfDataTag;
   static bool DumpPreciseProfData;
 
@@ -806,6 +856,9 @@ struct RuntimeOption {
   F(bool, JitNoGdb,                    true)                            \
   F(bool, SpinOnCrash,                 false)                           \
   F(uint32_t, DumpRingBufferOnCrash,   0)                               \
+  /* Mirror ringbuffer writes into per-thread flight recorders and dump  \
+   * the last N entries of every thread from the crash handler. */       \
+  F(uint32_t, DumpFlightRecorderOnCrash, 0)                             \
   F(bool, PerfPidMap,                  true)                            \
   F(bool, PerfPidMapIncludeFilePath,   true)                            \
   F(bool, PerfJitDump,                 false)                           \
@@ -824,8 +877,13 @@ struct RuntimeOption {
   F(string, ProfileHWEvents,           std::string(""))                 \
   F(bool, ProfileHWExcludeKernel,      false)                           \
   F(bool, ProfileHWFastReads,          false)                           \
+  F(bool, ProfileHWPerEndpoint,        false)                           \
   F(bool, ProfileHWStructLog,          false)                           \
   F(int32_t, ProfileHWExportInterval,  30)                              \
+  F(bool, ProfileWorkloadPerEndpoint,  false)                           \
+  /* Sample 1/N contended acquisitions of the util mutex wrappers (and   \
+   * the jit write lease) into lock.wait_us.* histograms; 0 disables. */ \
+  F(uint32_t, LockContentionSampleRate, 0)                              \
   F(string, ReorderProps,              reorderPropsDefault())           \
   F(bool, ReorderRDS,                  true)                            \
   F(double, RDSReorderThreshold,       0.0005)                          \
@@ -837,6 +895,12 @@ struct RuntimeOption {
   F(uint32_t, JitTraceletEagerGuardsLimit, 0)                           \
   F(uint32_t, JitTraceletGuardsLimit,  5)                               \
   F(uint64_t, JitGlobalTranslationLimit, -1)                            \
+  /* Maintain a compact, memory-bounded index of translations           \
+   * (srckey and function -> translation summaries) that is safe to     \
+   * enable in production and queryable via the admin port, without     \
+   * requiring the full TransDB (debug builds or TC dumps). */          \
+  F(bool, JitTransIndex,               false)                           \
+  F(uint32_t, JitTransIndexMaxEntries, 1 << 20)                         \
   F(int64_t, JitMaxRequestTranslationTime, -1)                          \
   F(uint32_t, JitMaxRegionInstrs,      3000)                            \
   F(uint32_t, JitMaxLiveRegionInstrs,  50)                              \
@@ -911,6 +975,9 @@ struct RuntimeOption {
   F(double,   HHIRInliningVasmCallerExp, .5)                            \
   F(double,   HHIRInliningVasmCalleeExp, .5)                            \
   F(double,   HHIRInliningDepthExp, 0)                                  \
+  /* Scale the vasm cost budget by this much for translations rooted   \
+   * in one of the Eval.JitInliningHotEndpoints functions. */           \
+  F(double,   HHIRInliningHotEndpointFactor, 1.0)                       \
   F(uint32_t, HHIRInliningMaxReturnDecRefs, 24)                         \
   F(uint32_t, HHIRInliningMaxReturnLocals, 40)                          \
   F(uint32_t, HHIRInliningMaxInitObjProps, 12)                          \
@@ -923,6 +990,13 @@ struct RuntimeOption {
   F(bool, HHIRGlobalValueNumbering,    true)                            \
   F(bool, HHIRPredictionOpts,          true)                            \
   F(bool, HHIRMemoryOpts,              true)                            \
+  /* Peel one iteration off of hot loops in optimized translations. */  \
+  F(bool, HHIRLoopPeeling,             false)                           \
+  /* Only peel loops of at most this many IR instructions. */           \
+  F(uint32_t, HHIRLoopPeelingMaxInsts, 80)                              \
+  /* Only peel loops whose header's profile count is at least this      \
+   * many times the count of the blocks entering the loop. */           \
+  F(uint32_t, HHIRLoopPeelingMinTripCount, 4)                           \
   F(bool, AssemblerFoldDefaultValues,  true)                            \
   F(uint64_t, AssemblerMaxScalarSize,  2147483648) /* 2GB */            \
   F(uint32_t, HHIRLoadElimMaxIters,    10)                              \
@@ -930,6 +1004,10 @@ struct RuntimeOption {
   F(uint32_t, HHIRLoadThrowMaxDecrefs, 64)                              \
   F(bool, HHIRStorePRE,                true)                            \
   F(bool, HHIROutlineGenericIncDecRef, true)                            \
+  /* Lower string switches with at least this many cases to an inline
+   * probe of a collision-free hash table on the subject's cached hash,
+   * falling back to the out-of-line lookup on a miss. 0 disables. */   \
+  F(uint32_t, JitSSwitchTableMinCases, 0)                               \
   /* How many elements to inline for packed- or mixed-array inits. */   \
   F(uint32_t, HHIRMaxInlineInitPackedElements, 8)                       \
   F(uint32_t, HHIRMaxInlineInitMixedElements,  4)                       \
@@ -959,6 +1037,10 @@ struct RuntimeOption {
   F(uint32_t, JitPGOUnlikelyDecRefPersistPercent, 5)                    \
   F(uint32_t, JitPGOUnlikelyDecRefSurvivePercent, 5)                    \
   F(uint32_t, JitPGOUnlikelyDecRefDecrementPercent, 5)                  \
+  /* When a generic DecRef saw exactly one refcounted type during
+   * profiling, release via a direct call to that type's destructor
+   * behind a type check, instead of the indirect table dispatch. */    \
+  F(bool,     JitPGOTypedDecRefDtor,   false)                           \
   F(double,   JitPGODecRefNZReleasePercentCOW,                          \
                                        ServerExecutionMode() ? 0.5 : 0) \
   F(double,   JitPGODecRefNZReleasePercent,                             \
@@ -973,10 +1055,25 @@ struct RuntimeOption {
   F(uint32_t, JitPGORelaxPercent,      100)                             \
   F(double,   JitPGOCalledFuncCheckThreshold, 50)                       \
   F(double,   JitPGOCalledFuncExitThreshold,  99.9)                     \
+  /* Profile the types returned at call sites and, when a stable type   \
+   * was observed, check for it in optimized translations so the        \
+   * refined type flows into the rest of the region. */                 \
+  F(bool,     JitPGOCallReturnTypes,   true)                            \
   F(bool,     JitPGODumpCallGraph,     false)                           \
   F(bool,     JitPGOOptCodeCallGraph,  true)                            \
   F(bool,     JitPGORacyProfiling,     false)                           \
-  F(bool,     JitPGOHFSortPlus,        false)                           \
+  /* Max length of chained exact-class dispatch for polymorphic method  \
+   * call sites; 0 disables the chains. Bounded by                      \
+   * MethProfile::kMaxPolyClasses. */                                   \
+  F(uint32_t, JitPGOPolyMethodChainMax, 0)                              \
+  /* Cluster the retranslateAll function order with hfsort-plus, which \
+   * models iTLB page sharing, instead of plain hfsort. */              \
+  F(bool,     JitPGOHFSortPlus,        true)                            \
+  /* Group the retranslateAll function order by the endpoints that     \
+   * reach each function, so that disjoint traffic classes get         \
+   * page-dense code. Needs Eval.JitPGOOptCodeCallGraph instrumentation\
+   * and endpoints tagged via Eval.ProfileWorkloadPerEndpoint. */      \
+  F(bool,     JitPGOPartitionByEndpoint, false)                        \
   F(uint32_t, JitLiveThreshold,       ServerExecutionMode() ? 1000 : 0) \
   F(uint32_t, JitProfileThreshold,     ServerExecutionMode() ? 200 : 0) \
   F(uint32_t, JitSrcKeyThreshold,      0)                               \
@@ -1009,6 +1106,10 @@ struct RuntimeOption {
   F(bool, FileBackedColdArena,         useFileBackedArenaDefault())     \
   F(string, ColdArenaFileDir,          "/tmp")                          \
   F(uint32_t, MaxHotTextHugePages,     hotTextHugePagesDefault())       \
+  /* After retranslateAll, advise up to this many 2MB pages at the
+   * front of code.main--where optimized code was just laid out in
+   * hotness order--onto transparent huge pages. 0 disables it. */      \
+  F(uint32_t, JitHugifyOptCodePages,   0)                               \
   F(uint32_t, MaxLowMemHugePages,      hugePagesSoundNice() ? 8 : 0)    \
   F(uint32_t, MaxHighArenaHugePages,   0)                               \
   F(uint32_t, Num1GPagesForSlabs,      0)                               \
@@ -1016,15 +1117,32 @@ struct RuntimeOption {
   F(uint32_t, Num1GPagesForReqHeap,    0)                               \
   F(uint32_t, Num2MPagesForReqHeap,    0)                               \
   F(uint32_t, NumReservedSlabs,        0)                               \
+  /* Number of pooled slabs a worker thread may cache locally, to avoid  \
+   * hitting the shared SlabManager on every slab transition. 0 disables \
+   * the per-thread magazine. */                                         \
+  F(uint32_t, SlabMagazineSize,        0)                               \
+  /* Number of slabs to add to a NUMA node's pool, with node-bound       \
+   * memory, when the pool runs dry. 0 falls back to malloc'd slabs. */  \
+  F(uint32_t, SlabPoolRefill,          0)                               \
+  /* Back slab-pool refills with 2M hugetlb pages while available. */    \
+  F(bool, SlabPoolHugePages,           false)                           \
   F(uint32_t, Num1GPagesForA0,         0)                               \
   F(uint32_t, Num2MPagesForA0,         0)                               \
   F(bool, BigAllocUseLocalArena,       true)                            \
   F(bool, JsonParserUseLocalArena,     true)                            \
   F(bool, XmlParserUseLocalArena,      true)                            \
   F(bool, LowStaticArrays,             true)                            \
+  /* Sort int vecs of at least this many elements on multiple threads   \
+   * when the comparator is a plain value comparison. 0 disables the    \
+   * parallel path. */                                                  \
+  F(uint64_t, VecParallelSortThreshold, 0)                              \
   F(bool, RecycleAProf,                true)                            \
   F(int64_t, HeapPurgeWindowSize,      5 * 1000000)                     \
   F(uint64_t, HeapPurgeThreshold,      128 * 1024 * 1024)               \
+  /* Free request-heap big blocks on a background thread at request      \
+   * end, with a bounded backlog; overflow is freed inline. */           \
+  F(bool, BackgroundHeapPurge,         false)                           \
+  F(uint32_t, BackgroundHeapPurgeBacklog, 4096)                         \
   /* GC Options: See heap-collect.cpp for more details */               \
   F(bool, EagerGC,                     eagerGcDefault())                \
   F(bool, FilterGCPoints,              true)                            \
@@ -1034,16 +1152,33 @@ struct RuntimeOption {
   F(uint32_t, GCSampleRate,            0)                               \
   F(uint32_t, HeapAllocSampleRequests, 0)                               \
   F(uint32_t, HeapAllocSampleBytes,    256 * 1024)                      \
+  F(bool, HeapAllocPoissonSampling,    true)                            \
+  /* Aggregate sampled allocations by site across requests and flag    \
+   * sites whose per-epoch totals grow monotonically over the window.  \
+   * See heap-profiling.cpp. */                                        \
+  F(bool, HeapLeakMonitor,             false)                          \
+  F(uint32_t, HeapLeakMonitorEpochSecs, 300)                           \
+  F(uint32_t, HeapLeakMonitorWindow,   4)                              \
   F(uint32_t, SlabAllocAlign,          64)                              \
   F(uint32_t, MemTrackStart,           3500)                            \
   F(uint32_t, MemTrackEnd,             3700)                            \
   F(int64_t, GCMinTrigger,             64L<<20)                         \
   F(double, GCTriggerPct,              0.5)                             \
   F(bool, TwoPhaseGC,                  false)                           \
+  F(bool, GCParallelMark,              false)                           \
+  F(uint32_t, GCParallelMarkWorkers,   4)                               \
+  F(int64_t, GCParallelMarkMinHeap,    256L<<20)                        \
   F(bool, EnableGC,                    enableGcDefault())               \
   /* End of GC Options */                                               \
   F(bool, Verify,                      getenv("HHVM_VERIFY"))           \
   F(bool, VerifyOnly,                  false)                           \
+  /* Number of threads to verify units with in "hhvm -m verify" (0     \
+   * means one per core). */                                           \
+  F(uint32_t, VerifyWorkers,           0)                               \
+  /* If non-empty, "hhvm -m verify" records the SHA1s of successfully  \
+   * verified units in this file and skips re-verifying unchanged      \
+   * units on later runs. */                                           \
+  F(string, VerifyCachePath,           "")                              \
   F(bool, FatalOnVerifyError,          !RepoAuthoritative)              \
   F(bool, AbortBuildOnVerifyError,     true)                            \
   F(bool, AbortBuildOnCompilerError,   true)                            \
@@ -1054,6 +1189,10 @@ struct RuntimeOption {
   F(bool, JitAlignUniqueStubs,         true)                            \
   F(uint32_t, SerDesSampleRate,            0)                           \
   F(bool, JitSerdesModeForceOff,       false)                           \
+  /* Base snapshot for delta-encoded profile dumps. When set, each      \
+   * finalized dump is also written as a delta against this file, and   \
+   * delta dumps are expanded from the mmapped base on load. */         \
+  F(string, JitSerdesDeltaBase,        "")                              \
   F(bool, JitDesUnitPreload,           false)                           \
   F(std::set<std::string>, JitSerdesDebugFunctions, {})                 \
   F(uint32_t, JitSerializeOptProfSeconds, ServerExecutionMode() ? 300 : 0)\
@@ -1075,6 +1214,20 @@ struct RuntimeOption {
   F(std::string, ArtilleryTracePolicy, "")                              \
   /* Opaque tag to add to each trace. Useful for aggregation */         \
   F(std::string, TracingTagId, "")                                      \
+  /* If non-empty, register a tracing backend which writes sampled      \
+   * requests (and their blocks and points) to this file in Chrome      \
+   * Trace Event format, viewable in chrome://tracing or Perfetto.      \
+   * "%{pid}" in the path is replaced with the process id. */           \
+  F(std::string, TracingChromeTraceFile, "")                            \
+  /* Always-on rqtrace ring buffers. When enabled, every request        \
+   * records guard events into a per-thread binary ring; the ring is    \
+   * retained for one request in RqTraceRingSampleRate and for any      \
+   * request slower than RqTraceRingRetainThresholdUs, and retained     \
+   * rings are drained by a background exporter. */                     \
+  F(bool, RqTraceRingEnabled,              false)                       \
+  F(uint32_t, RqTraceRingSampleRate,       1000)                        \
+  F(uint64_t, RqTraceRingRetainThresholdUs, 500000)                     \
+  F(uint32_t, RqTraceRingRetainedBuffers,  64)                          \
   /* Log the sizes and metadata for all translations in the TC broken
    * down by function and inclusive/exclusive size for inlined regions.
    * When set to "" TC size data will be sampled on a per function basis
@@ -1083,11 +1236,21 @@ struct RuntimeOption {
    * the value of this option. */                                       \
   F(string,   JitLogAllInlineRegions,  "")                              \
   F(bool, JitProfileGuardTypes,        false)                           \
+  /* With JitProfileGuardTypes, stop instrumenting guards on a type
+   * once it has passed this many times in the process without a
+   * single failure. 0 keeps every guard instrumented. */               \
+  F(uint64_t, JitProfileGuardTypesSettleCount, 0)                       \
   F(uint32_t, JitFilterLease,          1)                               \
   F(uint32_t, PCRETableSize, kPCREInitialTableSize)                     \
   F(uint64_t, PCREExpireInterval, 2 * 60 * 60)                          \
   F(string, PCRECacheType, std::string("static"))                       \
   F(bool, EnableCompactBacktrace, true)                                 \
+  /* Back the asio event base (socket readiness and sleep timers) with  \
+   * io_uring instead of the default epoll backend, when folly provides \
+   * the backend and the running kernel supports it. */                 \
+  F(bool, AsioEventBaseIoUring, false)                                  \
+  /* Submission/completion ring depth for the io_uring asio backend. */ \
+  F(uint32_t, AsioEventBaseIoUringCapacity, 512)                        \
   F(bool, EnableNuma, (numa_num_nodes > 1) && ServerExecutionMode())    \
   /* Use 1G pages for jemalloc metadata. */                             \
   F(bool, EnableArenaMetadata1GPage, false)                             \
@@ -1101,6 +1264,17 @@ struct RuntimeOption {
   /* Extra bytes added to each area (Hot/Cold/Frozen) of a translation. \
    * If we don't end up using a reusable TC, we'll drop the padding. */ \
   F(uint32_t, ReusableTCPadding, 128)                                   \
+  /* Interval for the background TC fragmentation monitor (only run     \
+   * with the reusable TC). It exports free-list counters, lets stub    \
+   * emission retry after reclamation frees space, and logs a perf      \
+   * warning when free space is badly fragmented. 0 disables it. */     \
+  F(uint64_t, JitTCFragmentationMonitorSecs, 0)                         \
+  /* With the reusable TC, proactively recycle the code of functions    \
+   * with no observed JIT activity (new translations, prologues, bound  \
+   * calls, or retranslate requests) for this many seconds. Recycled    \
+   * functions stay callable and are re-translated on their next call.  \
+   * 0 disables proactive recycling. */                                 \
+  F(uint32_t, JitTCRecycleIdleSecs, 0)                                  \
   F(int64_t,  StressUnitCacheFreq, 0)                                   \
   /* Perf warning sampling rates. The SelectHotCFG warning is noisy. */ \
   F(int64_t, PerfWarningSampleRate, 1)                                  \
@@ -1134,9 +1308,18 @@ struct RuntimeOption {
   /* What is the maximum number of keys to track in key order           \
    * profiles? */                                                       \
   F(uint64_t, BespokeMaxTrackedKeys, 245)                               \
+  /* What is the maximum number of distinct events to track per         \
+   * logging profile? Once a profile hits the cap, further new events   \
+   * are folded into key-despecialized entries, so profiling memory     \
+   * stays bounded on high-cardinality key workloads. 0 means no cap. */\
+  F(uint64_t, BespokeMaxProfileEvents, 0)                               \
   F(bool, EmitAPCBespokeArrays, true)                                   \
   /* Should we use monotypes? */                                        \
   F(bool, EmitBespokeMonotypes, false)                                  \
+  /* After how many identical sampled constructions do we promote a     \
+   * computed array source to a shared static instance? 0 disables      \
+   * the promotion. */                                                  \
+  F(uint32_t, BespokeConstantArrayPromotionThreshold, 0)                \
   F(int64_t, ObjProfMaxNesting, 5000)                                   \
   /* Choice of layout selection algorithms:                             \
    *                                                                    \
@@ -1295,7 +1478,14 @@ struct RuntimeOption {
   F(int32_t, ServerOOMAdj, 0)                                           \
   F(std::string, PreludePath, "")                                       \
   F(uint32_t, NonSharedInstanceMemoCaches, 10)                          \
+  /* Consult the process-wide memo cache tier for memoize wrappers that \
+   * HHBBC marked AttrPersistentMemoize. */                             \
+  F(bool, PersistentMemoCache, true)                                    \
   F(bool, UseGraphColor, true)                                          \
+  /* With PGO, only optimized translations at or above this percentile  \
+   * of profile weight use graph coloring; the rest fall back to the    \
+   * cheaper linear scan. 0 keeps graph coloring for all of them. */    \
+  F(uint32_t, JitGraphColorHotPercentile, 0)                            \
   F(std::vector<std::string>, IniGetHide, std::vector<std::string>())   \
   F(std::string, UseRemoteUnixServer, "no")                             \
   F(std::string, UnixServerPath, "")                                    \
@@ -1327,6 +1517,13 @@ struct RuntimeOption {
    * kept low to avoid the risk of collecting a sample while we're      \
    * processing a previous sample. */                                   \
   F(uint32_t, PerfMemEventSampleFreq, 80)                               \
+  /* Turn on last-branch-record sampling roughly every this many        \
+   * requests.  Sampled branch edges within the TC are aggregated and   \
+   * logged at the end of the request. */                               \
+  F(uint32_t, PerfBranchEventRequestFreq, 0)                            \
+  /* Sample this many branch instructions per second (with the LBR      \
+   * stack attached to each sample). */                                 \
+  F(uint32_t, PerfBranchEventSampleFreq, 1000)                          \
   /* Sampling frequency for TC branch profiling. */                     \
   F(uint32_t, ProfBranchSampleFreq, 0)                                  \
   F(bool, UseXedAssembler, false)                                       \
@@ -1337,6 +1534,11 @@ struct RuntimeOption {
   F(bool, ReuseUnitsByHash, false)                                      \
   /* Arbitrary string to force different unit-cache hashes */           \
   F(std::string, UnitCacheBreaker, "")                                  \
+  /* Use Watchman subscriptions to invalidate unit-cache freshness
+     data, so steady-state unit lookups do not stat() files. Falls
+     back to per-request stat() calls whenever the subscription for a
+     source root is unhealthy. */                                       \
+  F(bool, WatchmanUnitInvalidation, false)                              \
   /* When dynamic_fun is called on a function not marked as
      __DynamicallyCallable:
 
@@ -1360,6 +1562,10 @@ struct RuntimeOption {
   F(uint64_t, DynamicMethCallerLevel, 1)                                \
   F(bool, APCSerializeFuncs, true)                                      \
   F(bool, APCSerializeClsMeth, true)                                    \
+  /* Co-allocate flat strings into the block of the uncounted vanilla
+   * array that references them, saving per-string allocations and
+   * improving locality for APC reads. */                               \
+  F(bool, APCCoallocateStrings, false)                                  \
   /* When set:
    * - `is_array` becomes equivalent to `is_any_array` or
    *  `isTvArrayLike` instead of being a strict PHP array check.
@@ -1370,6 +1576,21 @@ struct RuntimeOption {
   F(uint32_t, UnitPrefetcherMaxThreads, 0)                              \
   F(uint32_t, UnitPrefetcherMinThreads, 0)                              \
   F(uint32_t, UnitPrefetcherIdleThreadTimeoutSecs, 60)                  \
+  /* When set, grow the prefetcher pool to the machine's core count if
+     that exceeds UnitPrefetcherMaxThreads. Batch compilation (eg cold
+     start warmup via HH\prefetch_units) then scales with cores
+     without retuning the thread count per host type. */                \
+  F(bool, UnitPrefetcherScaleToCores, false)                            \
+  /* If non-empty (and prefetching is enabled), profile which units
+     each entry unit transitively loads, persist the profile at this
+     path across restarts, and prefetch the recorded set as soon as a
+     request's entry path is known. */                                  \
+  F(std::string, UnitPrefetchProfilePath, "")                           \
+  /* When set (and prefetching is enabled), prefetch the units
+     defining the parents, interfaces, traits, and included enums of a
+     unit's classes as soon as the unit is loaded, instead of loading
+     them one named-entity miss at a time on first use. */              \
+  F(bool, UnitPrefetchClassHierarchy, false)                            \
   /* Delete any Unit not used in last N seconds */                      \
   F(uint32_t, IdleUnitTimeoutSecs, 0)                                   \
   /* Don't reap total Units below threshold */                          \
@@ -1501,6 +1722,9 @@ public:
   static double XenonPeriodSeconds;
   static uint32_t XenonRequestFreq;
   static bool XenonForceAlwaysOn;
+  // Bounds the number of frames captured per sample, including the walk of
+  // the asio dependency chain for blocked requests. 0 means unlimited.
+  static uint32_t XenonStackWalkLimit;
 
   // Strobelight options
   static bool StrobelightEnabled;
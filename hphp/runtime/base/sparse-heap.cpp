@@ -21,12 +21,142 @@
 #include "hphp/util/trace.h"
 #include <folly/portability/SysMman.h>
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 namespace HPHP {
 
 TRACE_SET_MOD(mm);
 
 std::atomic_bool SparseHeap::s_shutdown = false;
 
+namespace {
+
+/*
+ * Per-thread magazine of pooled slabs. Workers refill from the shared
+ * SlabManager in batches and return request slabs here first, so that
+ * steady-state slab transitions avoid CAS traffic on the shared
+ * tagged-pointer stack. Bounded by Eval.SlabMagazineSize slabs per thread.
+ */
+struct SlabMagazine {
+  TaggedSlabPtr tryAlloc() {
+    if (auto const p = m_list.try_local_pop()) {
+      assertx(m_count > 0);
+      --m_count;
+      return p;
+    }
+    return nullptr;
+  }
+
+  // Take ownership of a slab; returns false when the magazine is full.
+  bool tryStore(void* ptr, uint16_t tag) {
+    if (m_count >= capacity()) return false;
+    m_list.push_front<true>(ptr, tag);
+    ++m_count;
+    return true;
+  }
+
+  // Grab a batch of slabs from the shared manager, filling up to half
+  // capacity so alternating alloc/free near the boundary doesn't thrash.
+  void refill(SlabManager& shared) {
+    auto const target = std::max(1u, capacity() / 2);
+    while (m_count < target) {
+      auto const p = shared.tryAlloc();
+      if (!p) break;
+      m_list.push_front<true>(p.ptr(), p.tag());
+      ++m_count;
+    }
+  }
+
+  // Unmap everything held locally; used when the server is shutting down.
+  void unmapAll() {
+    while (auto const p = m_list.try_local_pop()) {
+      SlabManager::UnmapSlab(p.ptr());
+    }
+    m_count = 0;
+  }
+
+  static uint32_t capacity() {
+    return RuntimeOption::EvalSlabMagazineSize;
+  }
+
+ private:
+  TaggedSlabList m_list;
+  uint32_t m_count{0};
+};
+
+thread_local SlabMagazine tl_slabMagazine;
+
+/*
+ * Background purger: takes ownership of big blocks freed at request end and
+ * releases them off the request thread, so reset() time stops scaling with
+ * peak heap size. The backlog is bounded by Eval.BackgroundHeapPurgeBacklog;
+ * when it is full (or the purger is disabled) blocks are freed inline as
+ * before. The worker thread is started lazily on first use and freeing on
+ * it goes through the same deallocation path, just without a request
+ * thread's local-arena tcache.
+ */
+struct BackgroundPurger {
+  bool tryEnqueue(void* ptr, size_t size) {
+    if (!RuntimeOption::EvalBackgroundHeapPurge) return false;
+    {
+      std::lock_guard<std::mutex> g(m_lock);
+      if (m_backlog.size() >= RuntimeOption::EvalBackgroundHeapPurgeBacklog) {
+        return false;
+      }
+      m_backlog.emplace_back(ptr, size);
+    }
+    std::call_once(m_started, [this] {
+      std::thread([this] { loop(); }).detach();
+    });
+    m_cv.notify_one();
+    return true;
+  }
+
+ private:
+  void loop();
+
+  std::mutex m_lock;
+  std::condition_variable m_cv;
+  std::vector<std::pair<void*, size_t>> m_backlog;
+  std::once_flag m_started;
+};
+
+BackgroundPurger s_bgPurger;
+
+void freeBigBlock(void* ptr, size_t size) {
+  if (RuntimeOption::EvalBigAllocUseLocalArena) {
+    if (size) local_sized_free(ptr, size);
+  } else {
+#ifdef USE_JEMALLOC
+#if JEMALLOC_VERSION_MAJOR >= 4
+    sdallocx(ptr, size, 0);
+#else
+    dallocx(ptr, 0);
+#endif
+#else
+    free(ptr);
+#endif
+  }
+}
+
+void BackgroundPurger::loop() {
+  while (true) {
+    std::vector<std::pair<void*, size_t>> work;
+    {
+      std::unique_lock<std::mutex> g(m_lock);
+      m_cv.wait(g, [this] { return !m_backlog.empty(); });
+      work.swap(m_backlog);
+    }
+    for (auto const& block : work) {
+      freeBigBlock(block.first, block.second);
+    }
+  }
+}
+
+}
+
 void SparseHeap::threadInit() {
 #ifdef USE_JEMALLOC
   m_slabManager = get_local_slab_manager(s_numaNode);
@@ -44,22 +174,7 @@ void SparseHeap::reset() {
     });
   }
 #endif
-  auto const do_free =
-    [this] (void* ptr, size_t size) {
-      if (RuntimeOption::EvalBigAllocUseLocalArena) {
-        if (size) local_sized_free(ptr, size);
-      } else {
-#ifdef USE_JEMALLOC
-#if JEMALLOC_VERSION_MAJOR >= 4
-        sdallocx(ptr, size, 0);
-#else
-        dallocx(ptr, 0);
-#endif
-#else
-        free(ptr);
-#endif
-      }
-  };
+  if (m_checkpoint) clearCheckpoint();
   TaggedSlabList pooledSlabs;
   void* pooledSlabTail = nullptr;
   auto const UNUSED isShuttingDown = s_shutdown.load(std::memory_order_acquire);
@@ -73,21 +188,88 @@ void SparseHeap::reset() {
       if (SlabManager::UnmapSlab(slab.ptr)) continue;
     }
 #endif
+    // Keep slabs in the per-thread magazine when there is room; only the
+    // overflow goes back to the shared SlabManager.
+    if (!isShuttingDown && tl_slabMagazine.tryStore(slab.ptr, slab.version)) {
+      continue;
+    }
     if (!pooledSlabTail) pooledSlabTail = slab.ptr;
     pooledSlabs.push_front<true>(slab.ptr, slab.version);
   }
   if (pooledSlabTail) {
     m_slabManager->merge(std::move(pooledSlabs), pooledSlabTail);
   }
+  if (isShuttingDown) tl_slabMagazine.unmapAll();
+#ifdef USE_JEMALLOC
+  // Job-queue workers can be re-bound to a different NUMA node after
+  // threadInit(); refresh between requests so the next request's slabs come
+  // from (and return to) the node-local pool.
+  m_slabManager = get_local_slab_manager(s_numaNode);
+#endif
   m_pooled_slabs.clear();
   m_hugeBytes = 0;
   m_bigs.iterate([&](HeapObject* h, size_t size) {
-    do_free(h, size);
+    if (!s_bgPurger.tryEnqueue(h, size)) freeBigBlock(h, size);
   });
   m_bigs.clear();
   m_slab_range = {nullptr, 0};
 }
 
+void SparseHeap::setCheckpoint() {
+  m_checkpointPooledSlabs = m_pooled_slabs.size();
+  m_checkpointBigs.clear();
+  m_bigs.iterate([&](HeapObject* h, size_t) {
+    m_checkpointBigs.push_back(h);
+  });
+  std::sort(m_checkpointBigs.begin(), m_checkpointBigs.end());
+  m_checkpoint = true;
+}
+
+void SparseHeap::clearCheckpoint() {
+  m_checkpoint = false;
+  m_checkpointPooledSlabs = 0;
+  m_checkpointBigs = std::vector<const void*>{};
+}
+
+bool SparseHeap::checkpointContains(const void* ptr) const {
+  return std::binary_search(m_checkpointBigs.begin(), m_checkpointBigs.end(),
+                            ptr);
+}
+
+void SparseHeap::resetToCheckpoint() {
+  assertx(m_checkpoint);
+  TRACE(1, "heap-id %lu SparseHeap-resetToCheckpoint: pooled_slabs %lu/%lu "
+        "bigs %lu\n", tl_heap_id, m_checkpointPooledSlabs,
+        m_pooled_slabs.size(), m_bigs.countBlocks());
+  // Return pooled slabs acquired after the checkpoint, preferring the
+  // per-thread magazine like reset() does.
+  TaggedSlabList pooledSlabs;
+  void* pooledSlabTail = nullptr;
+  for (auto i = m_checkpointPooledSlabs; i < m_pooled_slabs.size(); ++i) {
+    auto& slab = m_pooled_slabs[i];
+    m_bigs.erase(slab.ptr);
+    m_hugeBytes -= kSlabSize;
+    if (tl_slabMagazine.tryStore(slab.ptr, slab.version)) continue;
+    if (!pooledSlabTail) pooledSlabTail = slab.ptr;
+    pooledSlabs.push_front<true>(slab.ptr, slab.version);
+  }
+  if (pooledSlabTail) {
+    m_slabManager->merge(std::move(pooledSlabs), pooledSlabTail);
+  }
+  m_pooled_slabs.resize(m_checkpointPooledSlabs);
+  // Free malloc'd slabs and big blocks that aren't in the checkpointed set.
+  std::vector<std::pair<void*, size_t>> garbage;
+  m_bigs.iterate([&](HeapObject* h, size_t size) {
+    if (!checkpointContains(h)) garbage.emplace_back(h, size);
+  });
+  for (auto& g : garbage) {
+    m_bigs.erase(g.first);
+    if (!s_bgPurger.tryEnqueue(g.first, g.second)) {
+      freeBigBlock(g.first, g.second);
+    }
+  }
+}
+
 void SparseHeap::flush() {
   assertx(empty());
   m_pooled_slabs = std::vector<SlabInfo>{};
@@ -110,7 +292,20 @@ HeapObject* SparseHeap::allocSlab(MemoryUsageStats& stats) {
   };
 
   if (m_slabManager && m_hugeBytes < RuntimeOption::RequestHugeMaxBytes) {
-    if (auto slab = m_slabManager->tryAlloc()) {
+    auto slab = tl_slabMagazine.tryAlloc();
+    if (!slab && SlabMagazine::capacity() > 0) {
+      tl_slabMagazine.refill(*m_slabManager);
+      slab = tl_slabMagazine.tryAlloc();
+    }
+    if (!slab) slab = m_slabManager->tryAlloc();
+#ifdef USE_JEMALLOC
+    if (!slab && RuntimeOption::EvalSlabPoolRefill > 0 &&
+        grow_local_slab_pool(s_numaNode, RuntimeOption::EvalSlabPoolRefill,
+                             RuntimeOption::EvalSlabPoolHugePages)) {
+      slab = m_slabManager->tryAlloc();
+    }
+#endif
+    if (slab) {
       stats.mmap_volume += kSlabSize;
       stats.mmap_cap += kSlabSize;
       stats.peakCap = std::max(stats.peakCap, stats.capacity());
@@ -167,6 +362,9 @@ bool SparseHeap::contains(const void* ptr) const {
 }
 
 void SparseHeap::freeBig(void* ptr, MemoryUsageStats& stats) {
+  // Blocks in the checkpointed heap prefix must stay live while the
+  // checkpoint is set; see setCheckpoint().
+  assertx(!m_checkpoint || !checkpointContains(ptr));
   // Since we account for these direct allocations in our usage and adjust for
   // them on allocation, we also need to adjust for them negatively on free.
   auto cap = m_bigs.erase(ptr);
@@ -191,6 +389,7 @@ void SparseHeap::freeBig(void* ptr, MemoryUsageStats& stats) {
 
 void* SparseHeap::resizeBig(void* ptr, size_t new_size,
                             MemoryUsageStats& stats) {
+  assertx(!m_checkpoint || !checkpointContains(ptr));
   auto old = static_cast<HeapObject*>(ptr);
   auto old_cap = m_bigs.get(old);
 #ifdef USE_JEMALLOC
@@ -28,7 +28,9 @@
 #include "hphp/util/low-ptr.h"
 
 #include <folly/AtomicHashMap.h>
+#include <folly/lang/Bits.h>
 
+#include <algorithm>
 #include <type_traits>
 
 namespace HPHP {
@@ -139,14 +141,46 @@ struct EmbeddedStringMap {
   bool inited;
 };
 
-EmbeddedStringMap s_stringDataMap;
+/*
+ * The table is sharded by string hash, so concurrent interning spreads over
+ * independent AtomicHashMaps and a growth stall in one shard no longer
+ * serializes every thread. The shard count is a power of two, fixed when the
+ * table is (re)created from Eval.StaticStringTableShards.
+ */
+constexpr size_t kMaxStaticStringTableShards = 64;
+
+EmbeddedStringMap s_stringDataShards[kMaxStaticStringTableShards];
+size_t s_shardMask = 0;
+
+size_t numStringShards() { return s_shardMask + 1; }
+
+size_t configuredStringShards() {
+  auto const wanted = std::max<size_t>(
+    RuntimeOption::EvalStaticStringTableShards, 1);
+  return folly::prevPowTwo(
+    std::min<size_t>(wanted, kMaxStaticStringTableShards));
+}
+
+StringDataMap& shardFor(size_t hash) {
+  // AtomicHashMap derives its probe index from the low hash bits; pick the
+  // shard from higher bits so the two stay independent.
+  return *s_stringDataShards[(hash >> 16) & s_shardMask];
+}
+
+template<typename Key>
+StringDataMap& shardForKey(const Key& key) {
+  return shardFor(strintern_hash{}(key));
+}
+
+bool tableInited() { return static_cast<bool>(s_stringDataShards[0]); }
 
 // If a string is static it better be the one in the table.
 DEBUG_ONLY bool checkStaticStr(const StringData* s) {
   assertx(s->isStatic());
-  assertx(s_stringDataMap);
-  auto DEBUG_ONLY const it = s_stringDataMap->find(s);
-  assertx(it != s_stringDataMap->end());
+  assertx(tableInited());
+  auto& map = shardForKey(s);
+  auto DEBUG_ONLY const it = map.find(s);
+  assertx(it != map.end());
   assertx(to_sdata(it->first) == s);
   return true;
 }
@@ -165,7 +199,8 @@ StringData** precompute_chars() {
 StringData* insertStaticString(StringData* sd,
                                void (*deleter)(StringData*)) {
   assertx(sd->isStatic());
-  auto pair = s_stringDataMap->insert(
+  auto& map = shardForKey(sd);
+  auto pair = map.insert(
     safe_cast<StrInternKey>(reinterpret_cast<uintptr_t>(sd)),
     rds::Link<TypedValue, rds::Mode::NonLocal>{}
   );
@@ -185,7 +220,7 @@ StringData* insertStaticString(StringData* sd,
       data_map::register_start(sd);
     }
     static std::atomic<bool> signaled{false};
-    checkAHMSubMaps(*s_stringDataMap, "static string table", signaled);
+    checkAHMSubMaps(map, "static string table", signaled);
   }
   assertx(to_sdata(pair.first->first) != nullptr);
 
@@ -193,14 +228,18 @@ StringData* insertStaticString(StringData* sd,
 }
 
 void create_string_data_map() {
-  always_assert(!s_stringDataMap);
+  always_assert(!tableInited());
   StringDataMap::Config config;
   config.growthFactor = 1;
   config.entryCountThreadCacheSize = 10;
   MemoryStats::ResetStaticStringSize();
 
-  s_stringDataMap.emplace(RuntimeOption::EvalInitialStaticStringTableSize,
-                          config);
+  s_shardMask = configuredStringShards() - 1;
+  auto const sizePerShard = std::max<uint32_t>(
+    RuntimeOption::EvalInitialStaticStringTableSize / numStringShards(), 1024);
+  for (size_t i = 0; i < numStringShards(); ++i) {
+    s_stringDataShards[i].emplace(sizePerShard, config);
+  }
   insertStaticString(StringData::MakeEmpty());
   if (!precomputed_chars) {
     precomputed_chars = precompute_chars();
@@ -210,8 +249,12 @@ void create_string_data_map() {
 //////////////////////////////////////////////////////////////////////
 
 size_t makeStaticStringCount() {
-  if (!s_stringDataMap) return 0;
-  return s_stringDataMap->size();
+  if (!tableInited()) return 0;
+  size_t count = 0;
+  for (size_t i = 0; i < numStringShards(); ++i) {
+    count += s_stringDataShards[i]->size();
+  }
+  return count;
 }
 
 StringData* makeStaticString(const StringData* str) {
@@ -219,33 +262,37 @@ StringData* makeStaticString(const StringData* str) {
     assertx(checkStaticStr(str));
     return const_cast<StringData*>(str);
   }
-  auto const it = s_stringDataMap->find(str);
-  if (it != s_stringDataMap->end()) {
+  auto& map = shardForKey(str);
+  auto const it = map.find(str);
+  if (it != map.end()) {
     return const_cast<StringData*>(to_sdata(it->first));
   }
   return insertStaticString(StringData::MakeStatic(str->slice()));
 }
 
 StringData* makeStaticString(folly::StringPiece slice) {
-  auto const it = s_stringDataMap->find(slice);
-  if (it != s_stringDataMap->end()) {
+  auto& map = shardForKey(slice);
+  auto const it = map.find(slice);
+  if (it != map.end()) {
     return const_cast<StringData*>(to_sdata(it->first));
   }
   return insertStaticString(StringData::MakeStatic(slice));
 }
 
 StringData* lookupStaticString(const StringData *str) {
-  assertx(s_stringDataMap && !str->isStatic());
-  auto const it = s_stringDataMap->find(str);
-  if (it != s_stringDataMap->end()) {
+  assertx(tableInited() && !str->isStatic());
+  auto& map = shardForKey(str);
+  auto const it = map.find(str);
+  if (it != map.end()) {
     return const_cast<StringData*>(to_sdata(it->first));
   }
   return nullptr;
 }
 
 StringData* lookupStaticString(folly::StringPiece slice) {
-  auto const it = s_stringDataMap->find(slice);
-  if (it != s_stringDataMap->end()) {
+  auto& map = shardForKey(slice);
+  auto const it = map.find(slice);
+  if (it != map.end()) {
     return const_cast<StringData*>(to_sdata(it->first));
   }
   return nullptr;
@@ -277,9 +324,10 @@ StringData* makeStaticString(char c) {
 
 
 bool bindPersistentCns(const StringData* cnsName, const TypedValue& value) {
-  assertx(s_stringDataMap);
-  auto const it = s_stringDataMap->find(cnsName);
-  assertx(it != s_stringDataMap->end());
+  assertx(tableInited());
+  auto& map = shardForKey(cnsName);
+  auto const it = map.find(cnsName);
+  assertx(it != map.end());
   it->second.bind<kTVSimdAlign>(
     rds::Mode::Persistent,
     rds::LinkName{"Cns", cnsName},
@@ -289,9 +337,10 @@ bool bindPersistentCns(const StringData* cnsName, const TypedValue& value) {
 }
 
 rds::Handle lookupCnsHandle(const StringData* cnsName) {
-  assertx(s_stringDataMap);
-  auto const it = s_stringDataMap->find(cnsName);
-  if (it != s_stringDataMap->end()) {
+  assertx(tableInited());
+  auto& map = shardForKey(cnsName);
+  auto const it = map.find(cnsName);
+  if (it != map.end()) {
     return it->second.maybeHandle();
   }
   return rds::kUninitHandle;
@@ -301,8 +350,9 @@ rds::Handle makeCnsHandle(const StringData* cnsName) {
   assertx(cnsName->isStatic());
   auto const val = lookupCnsHandle(cnsName);
   if (rds::isHandleBound(val)) return val;
-  auto const it = s_stringDataMap->find(cnsName);
-  assertx(it != s_stringDataMap->end());
+  auto& map = shardForKey(cnsName);
+  auto const it = map.find(cnsName);
+  assertx(it != map.end());
   if (!it->second.bound()) {
     it->second.bind<kTVSimdAlign>(
       rds::Mode::Normal,
@@ -313,12 +363,14 @@ rds::Handle makeCnsHandle(const StringData* cnsName) {
 }
 
 std::vector<StringData*> lookupDefinedStaticStrings() {
-  assertx(s_stringDataMap);
+  assertx(tableInited());
   std::vector<StringData*> ret;
-  ret.reserve(s_stringDataMap->size());
+  ret.reserve(makeStaticStringCount());
 
-  for (auto const& it : *s_stringDataMap) {
-    ret.push_back(const_cast<StringData*>(to_sdata(it.first)));
+  for (size_t i = 0; i < numStringShards(); ++i) {
+    for (auto const& it : *s_stringDataShards[i]) {
+      ret.push_back(const_cast<StringData*>(to_sdata(it.first)));
+    }
   }
 
   return ret;
@@ -329,11 +381,12 @@ const StaticString s_user("user");
 const StaticString s_Core("Core");
 
 Array lookupDefinedConstants(bool categorize /*= false */) {
-  assertx(s_stringDataMap);
+  assertx(tableInited());
   auto usr = Array::CreateDict();
   auto sys = categorize ? Array::CreateDict() : Array();
 
-  for (auto const& it : *s_stringDataMap) {
+  for (size_t i = 0; i < numStringShards(); ++i) {
+   for (auto const& it : *s_stringDataShards[i]) {
     auto const& rval = it.second;
     if (!rval.bound() || !rval.isInit()) continue;
 
@@ -350,6 +403,7 @@ Array lookupDefinedConstants(bool categorize /*= false */) {
       assertx(cns.isAllowedAsConstantValue() == Variant::AllowedAsConstantValue::Allowed);
       tbl->set(key, cns, true);
     }
+   }
   }
 
   if (categorize) {
@@ -363,32 +417,41 @@ Array lookupDefinedConstants(bool categorize /*= false */) {
 }
 
 size_t countStaticStringConstants() {
-  if (!s_stringDataMap) return 0;
+  if (!tableInited()) return 0;
   size_t count = 0;
 
-  for (auto const& it : *s_stringDataMap) {
-    if (it.second.bound()) {
-      ++count;
+  for (size_t i = 0; i < numStringShards(); ++i) {
+    for (auto const& it : *s_stringDataShards[i]) {
+      if (it.second.bound()) {
+        ++count;
+      }
     }
   }
   return count;
 }
 
 void refineStaticStringTableSize() {
+  if (!tableInited()) return;
   if (RuntimeOption::EvalInitialStaticStringTableSize ==
-      kDefaultInitialStaticStringTableSize ||
-      !s_stringDataMap) {
+      kDefaultInitialStaticStringTableSize &&
+      configuredStringShards() == numStringShards()) {
     return;
   }
 
-  std::vector<StringDataMap::value_type>
-    oldStringTable(s_stringDataMap->begin(), s_stringDataMap->end());
+  std::vector<StringDataMap::value_type> oldStringTable;
+  oldStringTable.reserve(makeStaticStringCount());
+  auto const oldShards = numStringShards();
+  for (size_t i = 0; i < oldShards; ++i) {
+    oldStringTable.insert(oldStringTable.end(),
+                          s_stringDataShards[i]->begin(),
+                          s_stringDataShards[i]->end());
+    s_stringDataShards[i].clear();
+  }
 
-  s_stringDataMap.clear();
   create_string_data_map();
 
   for (auto& kv : oldStringTable) {
-    s_stringDataMap->insert(kv.first, kv.second);
+    shardForKey(kv.first).insert(kv.first, kv.second);
   }
 }
 
@@ -28,6 +28,7 @@
 
 #include "hphp/util/alloc.h"
 #include "hphp/util/conv-10.h"
+#include "hphp/util/word-mem.h"
 
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
@@ -201,6 +202,27 @@ void StringBuffer::append(const Variant& v) {
   }
 }
 
+void StringBuffer::append(folly::Range<const folly::StringPiece*> slices) {
+  size_t total = 0;
+  for (auto const& s : slices) total += s.size();
+  if (total == 0) return;
+
+  // `memcpy8()' could overrun the destination by at most 7 bytes, so make
+  // sure there's room for that past the end of the data.
+  auto const needed = total + 7;
+  if (UNLIKELY(needed > m_maxBytes)) {
+    throw StringBufferLimitException(m_maxBytes, detach());
+  }
+  if (!valid()) makeValid(needed);
+  if (needed > m_cap - m_len) growBy(needed);
+
+  auto p = m_str->mutableData() + m_len;
+  for (auto const& s : slices) {
+    p = memcpy8(p, s.data(), s.size());
+  }
+  m_len += total;
+}
+
 void StringBuffer::appendHelper(char ch) {
   if (!valid()) makeValid(1);
   if (m_len == m_cap) {
@@ -184,6 +184,17 @@ struct StringBuffer {
   void append(int n);
   void append(int64_t n);
 
+  /*
+   * Append several string slices with a single capacity check.
+   *
+   * Equivalent to appending each slice in order, but the buffer grows at
+   * most once and the copies chain through the wide memcpy8 kernel. As with
+   * StringData::Make(s1, s2), each slice must have at least 7 readable
+   * bytes past its end (true for StringData buffers and for fragments in
+   * stack or static storage).
+   */
+  void append(folly::Range<const folly::StringPiece*> slices);
+
   /*
    * Take ownership of the string being built by buf.
    *
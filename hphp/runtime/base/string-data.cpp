@@ -201,6 +201,32 @@ StringData* StringData::MakeUncounted(folly::StringPiece sl) {
   return MakeSharedAt<false>(sl, AllocateShared<false>(sl));
 }
 
+StringData* StringData::MakeUncountedAt(folly::StringPiece sl, MemBlock range,
+                                        ArrayData* root) {
+  assertx(range.size >=
+          sizeof(UncountedRootPrefix) + sl.size() + kStringOverhead);
+  auto const prefix = static_cast<UncountedRootPrefix*>(range.ptr);
+  prefix->root = root;
+  auto const sd = MakeSharedAt<false>(
+    sl, MemBlock{prefix + 1, range.size - sizeof(UncountedRootPrefix)});
+  sd->m_aux16 |= uint16_t{kIsCoallocMask} << 8;
+  assertx(sd->isUncountedCoalloc() && sd->uncountedCoallocRoot() == root);
+  return sd;
+}
+
+bool StringData::isUncountedCoalloc() const {
+  return (m_aux16 >> 8) & kIsCoallocMask;
+}
+
+ArrayData* StringData::uncountedCoallocRoot() const {
+  assertx(isUncounted() && isUncountedCoalloc());
+  return (reinterpret_cast<const UncountedRootPrefix*>(this) - 1)->root;
+}
+
+bool StringData::coallocatedWith(const ArrayData* ad) const {
+  return UNLIKELY(isUncountedCoalloc()) && uncountedCoallocRoot() == ad;
+}
+
 StringData* StringData::MakeEmpty() {
   return MakeStaticAt(folly::StringPiece{""},
                       MemBlock{&s_theEmptyString, sizeof(s_theEmptyString)});
@@ -219,6 +245,12 @@ void StringData::destructStatic() {
 void StringData::ReleaseUncounted(StringData* str) {
   assertx(str->checkSane());
   assertx(!str->uncountedCowCheck());
+  if (UNLIKELY(str->isUncountedCoalloc())) {
+    // The string is internal to its root array's block and is never shared
+    // outside it (see MakeUncountedString); its memory is freed along with
+    // the block, so there's nothing to do here.
+    return;
+  }
   FreeUncounted(str, str->size() + kStringOverhead);
 }
 
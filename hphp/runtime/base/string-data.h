@@ -35,6 +35,7 @@ namespace HPHP {
 
 struct APCString;
 struct Array;
+struct ArrayData;
 struct String;
 struct APCHandle;
 struct NamedEntity;
@@ -148,6 +149,16 @@ struct StringData final : MaybeCountable,
    */
   static StringData* MakeUncounted(folly::StringPiece);
 
+  /*
+   * Same as MakeUncounted, but initializes the string in the given range,
+   * which lives inside the uncounted array `root`'s allocation and starts
+   * with an UncountedRootPrefix. The string doesn't own its memory: it is
+   * internal to the array's block and is freed along with it. It must never
+   * be shared into a structure that can outlive `root`.
+   */
+  static StringData* MakeUncountedAt(folly::StringPiece, MemBlock,
+                                     ArrayData* root);
+
   /*
    * Same as MakeStatic but initializes the empty string in aligned storage.
    * This should be called by the static string table initialization code.
@@ -399,6 +410,18 @@ struct StringData final : MaybeCountable,
   bool isSymbol() const;
   static void markSymbolsLoaded();
 
+  /*
+   * Uncounted strings created with MakeUncountedAt live inside an uncounted
+   * array's block and have an UncountedRootPrefix right in front pointing
+   * back at that array.
+   *
+   * uncountedCoallocRoot: Pre: isUncountedCoalloc()
+   */
+  bool isUncountedCoalloc() const;
+  ArrayData* uncountedCoallocRoot() const;
+  bool coallocatedWith(const ArrayData*) const;
+  constexpr static uint8_t kIsCoallocMask = 0x40;
+
   /*
    * A static string may be assigned a "color" which to be used as the hash key
    * in implementations of perfect hashing for bespoke arrays. The color is
@@ -538,6 +561,18 @@ struct SymbolPrefix {
 
 static_assert(sizeof(SymbolPrefix) % alignof(StringData) == 0, "");
 
+/*
+ * Uncounted strings co-allocated into an uncounted array's block have an
+ * UncountedRootPrefix right in front, pointing back at the owning array.
+ * Padded to 16 bytes so co-allocated strings stay 16-byte aligned.
+ */
+struct UncountedRootPrefix {
+  ArrayData* root;
+  uint64_t padding;
+};
+
+static_assert(sizeof(UncountedRootPrefix) % 16 == 0, "");
+
 //////////////////////////////////////////////////////////////////////
 
 /*
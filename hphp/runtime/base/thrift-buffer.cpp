@@ -16,6 +16,9 @@
 
 #include "hphp/runtime/base/thrift-buffer.h"
 
+#include "hphp/runtime/base/array-init.h"
+#include "hphp/runtime/base/bespoke-array.h"
+#include "hphp/runtime/base/bespoke/struct-dict.h"
 #include "hphp/runtime/base/builtin-functions.h"
 #include "hphp/runtime/base/variable-unserializer.h"
 
@@ -184,6 +187,109 @@ void ThriftBuffer::skip(int8_t type) {
   throwError(errbuf, INVALID_DATA);
 }
 
+ThriftStructSpec::ThriftStructSpec(std::vector<Field> fields)
+  : m_fields(std::move(fields)), m_layout(nullptr) {
+  if (!allowBespokeArrayLikes()) return;
+  bespoke::StructLayout::FieldVector fv;
+  fv.reserve(m_fields.size());
+  for (auto const& field : m_fields) {
+    assertx(field.key->isStatic());
+    fv.push_back({field.key});
+  }
+  m_layout = bespoke::StructLayout::GetLayout(fv, true);
+}
+
+const ThriftStructSpec::Field* ThriftStructSpec::fieldForId(int16_t id) const {
+  // Structs are small; a linear scan beats a hash lookup here.
+  for (auto const& field : m_fields) {
+    if (field.id == id) return &field;
+  }
+  return nullptr;
+}
+
+Array ThriftBuffer::readStruct(const ThriftStructSpec& spec) {
+  auto const layout = spec.layout();
+  auto ret = layout
+    ? Array::attach(bespoke::StructDict::MakeEmpty(layout))
+    : Array::CreateDict();
+  while (true) {
+    int8_t type; read(type);
+    if (type == T_STOP) break;
+    int16_t id; read(id);
+    auto const field = spec.fieldForId(id);
+    if (!field || field->type != type) {
+      skip(type);
+      continue;
+    }
+    auto value = readWireValue(type, field->nested);
+    if (layout) {
+      auto const slot = layout->keySlot(field->key);
+      assertx(slot != kInvalidSlot);
+      // The value's reference is donated to the slot.
+      bespoke::StructDict::SetStrInSlotInPlace(
+        bespoke::StructDict::As(ret.get()), slot, value.detach());
+    } else {
+      ret.set(String(const_cast<StringData*>(field->key.get())), value);
+    }
+  }
+  return ret;
+}
+
+Variant ThriftBuffer::readWireValue(int8_t type, const ThriftStructSpec* nested) {
+  switch (type) {
+    case T_BOOL:   { bool value;    read(value); return value; }
+    case T_BYTE:   { int8_t value;  read(value); return (int64_t)value; }
+    case T_I16:    { int16_t value; read(value); return (int64_t)value; }
+    case T_I32:    { int32_t value; read(value); return (int64_t)value; }
+    case T_U64:
+    case T_I64:    { int64_t value; read(value); return value; }
+    case T_DOUBLE: { double value;  read(value); return value; }
+    //case T_UTF7: // aliases T_STRING
+    case T_UTF8:
+    case T_UTF16:
+    case T_STRING: { String value;  read(value); return value; }
+    case T_STRUCT: {
+      if (!nested) break;
+      return readStruct(*nested);
+    }
+    case T_LIST:
+    case T_SET: {
+      int8_t valtype; read(valtype);
+      int32_t size; read(size);
+      if (size < 0) break;
+      VecInit init(size);
+      for (int32_t i = 0; i < size; ++i) {
+        init.append(readWireValue(valtype, nested));
+      }
+      return init.toVariant();
+    }
+    case T_MAP: {
+      int8_t keytype; read(keytype);
+      int8_t valtype; read(valtype);
+      int32_t size; read(size);
+      if (size < 0) break;
+      DictInit init(size);
+      for (int32_t i = 0; i < size; ++i) {
+        auto const key = readWireValue(keytype, nullptr);
+        auto const value = readWireValue(valtype, nested);
+        if (key.isInteger()) {
+          init.set(key.toInt64(), value);
+        } else if (key.isString()) {
+          init.set(key.asCStrRef(), value);
+        } else {
+          throwError("invalid map key type", INVALID_DATA);
+        }
+      }
+      return init.toVariant();
+    }
+  }
+
+  char errbuf[128];
+  sprintf(errbuf, "no schema for field type: %d", (int)type);
+  throwError(errbuf, INVALID_DATA);
+  not_reached();
+}
+
 void ThriftBuffer::throwOutOfMemory() {
   throwError("out of memory", 0);
 }
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "hphp/runtime/base/type-string.h"
+#include "hphp/runtime/base/types.h"
 #include "hphp/runtime/base/variable-serializer.h"
 #include "hphp/util/htonll.h"
 
@@ -27,6 +28,10 @@ struct Array;
 struct Object;
 struct Variant;
 
+namespace bespoke { struct StructLayout; }
+
+struct ThriftStructSpec;
+
 /**
  * Efficient thrift input/output preparation. Used by automatically generated
  * separable extension code created by running thrift compiler, for example,
@@ -249,6 +254,15 @@ public:
   void write(const Object& data);
   void write(const Variant& data);
 
+  /**
+   * Read a T_STRUCT payload (a sequence of typed fields terminated by
+   * T_STOP) directly into an array shaped by spec. When the spec carries a
+   * bespoke StructLayout, the result is a pre-sized StructDict filled in
+   * place; otherwise a vanilla dict is built. Wire fields that are absent
+   * from the spec, or whose type disagrees with it, are skipped.
+   */
+  Array readStruct(const ThriftStructSpec& spec);
+
   void skip(int8_t type);
 
 protected:
@@ -278,10 +292,42 @@ ThriftBuffer& operator=(const ThriftBuffer& /*sb*/) {
   void flush(const String& data);
   void read(char *data, int len);
 
+  Variant readWireValue(int8_t type, const ThriftStructSpec* nested);
+
   void throwOutOfMemory();
   void throwInvalidStringSize(int size);
 };
 
+/**
+ * Wire schema for a thrift struct whose field set is known at
+ * deserialization time.
+ *
+ * Constructing a spec registers a bespoke StructLayout for the field names
+ * (when bespoke array-likes are enabled), so ThriftBuffer::readStruct() can
+ * deserialize straight into a pre-sized StructDict instead of building a
+ * vanilla dict and re-specializing it later. Specs are meant to be created
+ * once per schema, typically during process initialization, and reused.
+ */
+struct ThriftStructSpec {
+  struct Field {
+    int16_t id;        // thrift field id
+    int8_t type;       // one of ThriftBuffer::TType
+    LowStringPtr key;  // field name; must be a static string
+    // Schema for T_STRUCT fields, and for struct elements of
+    // T_LIST/T_SET/T_MAP fields.
+    const ThriftStructSpec* nested{nullptr};
+  };
+
+  explicit ThriftStructSpec(std::vector<Field> fields);
+
+  const Field* fieldForId(int16_t id) const;
+  const bespoke::StructLayout* layout() const { return m_layout; }
+
+private:
+  std::vector<Field> m_fields;
+  const bespoke::StructLayout* m_layout;  // null when bespokes are disabled
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 }
 
@@ -0,0 +1,202 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010-present Facebook, Inc. (http://www.facebook.com)  |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include "hphp/runtime/base/tracing.h"
+
+#include "hphp/runtime/base/init-fini-node.h"
+#include "hphp/runtime/base/runtime-option.h"
+
+#include "hphp/util/logger.h"
+#include "hphp/util/process.h"
+
+#include <folly/Conv.h>
+#include <folly/Format.h>
+#include <folly/Random.h>
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+#include <unistd.h>
+
+/*
+ * Chrome Trace Event backend for the request tracing facility.
+ *
+ * When Eval.TracingChromeTraceFile is set, sampled requests (see the
+ * Eval.Tracing* sample rates) have their blocks and points written as
+ * duration ("B"/"E") and instant ("i") events in Chrome Trace Event JSON,
+ * which chrome://tracing and Perfetto open directly.  Since the existing
+ * tracing hooks already wrap retranslateAll phases, unit loads, tc
+ * publishing, and the other long-running runtime phases, this turns a
+ * warmup into a browsable timeline with no extra instrumentation.
+ *
+ * The file is a JSON array which is never closed; the trace viewers accept
+ * truncated arrays, so a crash mid-run still yields a loadable trace.
+ */
+
+namespace HPHP {
+namespace tracing {
+
+namespace {
+
+std::mutex s_lock;
+FILE* s_out{nullptr};
+bool s_first{true};
+
+std::string jsonEscape(folly::StringPiece s) {
+  std::string out;
+  out.reserve(s.size());
+  for (auto const c : s) {
+    switch (c) {
+      case '"':  out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n";  break;
+      case '\t': out += "\\t";  break;
+      case '\r': out += "\\r";  break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          out += folly::sformat("\\u{:04x}", c);
+        } else {
+          out += c;
+        }
+    }
+  }
+  return out;
+}
+
+std::string argsJson(const Props& props) {
+  if (props.m_props.empty()) return "";
+  std::string out = ",\"args\":{";
+  auto first = true;
+  for (auto const& kv : props.m_props) {
+    if (!first) out += ",";
+    first = false;
+    out += "\"" + jsonEscape(kv.first) + "\":\"" + jsonEscape(kv.second) + "\"";
+  }
+  out += "}";
+  return out;
+}
+
+void writeEvent(char ph, folly::StringPiece name, const std::string& args) {
+  auto const ts = std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+  auto const tid = Process::GetThreadPid();
+
+  std::lock_guard<std::mutex> guard(s_lock);
+  if (!s_out) return;
+  fprintf(
+    s_out,
+    "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%" PRId64
+    ",\"pid\":%d,\"tid\":%d%s%s}",
+    s_first ? "" : ",",
+    jsonEscape(name).c_str(),
+    ph,
+    static_cast<int64_t>(ts),
+    static_cast<int>(getpid()),
+    static_cast<int>(tid),
+    ph == 'i' ? ",\"s\":\"t\"" : "",
+    args.c_str()
+  );
+  s_first = false;
+}
+
+struct ChromeBlock final : BlockImpl {
+  ChromeBlock(folly::StringPiece name, const Props& props)
+    : m_name(name.toString())
+  {
+    writeEvent('B', m_name, argsJson(props));
+  }
+  ~ChromeBlock() override {
+    writeEvent('E', m_name, "");
+  }
+
+  void addPoint(folly::StringPiece name, const Props& props) override {
+    writeEvent('i', name, argsJson(props));
+  }
+  void annotate(const Props& props) override {
+    writeEvent('i', m_name, argsJson(props));
+  }
+
+private:
+  std::string m_name;
+};
+
+struct ChromeRequest final : RequestImpl {
+  ChromeRequest()
+    : m_id(folly::to<std::string>(folly::Random::rand64()))
+  {}
+
+  std::string getID() override { return m_id; }
+
+  void annotate(const Props& props) override {
+    writeEvent('i', "request", argsJson(props));
+  }
+
+  std::unique_ptr<BlockImpl> startBlock(folly::StringPiece name,
+                                        const Props& props,
+                                        bool /*initial*/) override {
+    return std::make_unique<ChromeBlock>(name, props);
+  }
+
+private:
+  std::string m_id;
+};
+
+struct ChromeFactory final : RequestImplFactory {
+  std::unique_ptr<RequestImpl> start(folly::StringPiece /*name*/) override {
+    return std::make_unique<ChromeRequest>();
+  }
+};
+
+InitFiniNode s_chromeInit(
+  [] {
+    auto path = RuntimeOption::EvalTracingChromeTraceFile;
+    if (path.empty()) return;
+    auto const marker = path.find("%{pid}");
+    if (marker != std::string::npos) {
+      path.replace(marker, 6, folly::to<std::string>(getpid()));
+    }
+    auto const out = fopen(path.c_str(), "w");
+    if (!out) {
+      Logger::Error("Unable to open chrome trace file %s", path.c_str());
+      return;
+    }
+    fprintf(out, "[");
+    {
+      std::lock_guard<std::mutex> guard(s_lock);
+      s_out = out;
+    }
+    setFactory(std::make_unique<ChromeFactory>());
+  },
+  InitFiniNode::When::PostRuntimeOptions
+);
+
+InitFiniNode s_chromeExit(
+  [] {
+    std::lock_guard<std::mutex> guard(s_lock);
+    if (!s_out) return;
+    fprintf(s_out, "\n]\n");
+    fclose(s_out);
+    s_out = nullptr;
+  },
+  InitFiniNode::When::ProcessExit
+);
+
+}
+
+}}
@@ -54,6 +54,71 @@ void FreeUncounted(void* ptr, size_t bytes) {
 
 //////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+// The active co-allocation region, if any. See UncountedCoallocScope.
+struct CoallocRegion {
+  ArrayData* root{nullptr};
+  char* cursor{nullptr};
+  char* end{nullptr};
+};
+thread_local CoallocRegion tl_coallocRegion;
+
+size_t coallocStringBytes(size_t len) {
+  return (sizeof(UncountedRootPrefix) + len + kStringOverhead + 15) & ~15ull;
+}
+
+StringData* tryCoallocString(StringData* in) {
+  auto& region = tl_coallocRegion;
+  if (!region.root) return nullptr;
+  auto const sl = in->slice();
+  auto const need = coallocStringBytes(sl.size());
+  if (region.cursor + need > region.end) return nullptr;
+  auto const sd = StringData::MakeUncountedAt(
+    sl, MemBlock{region.cursor, need}, region.root);
+  region.cursor += need;
+  return sd;
+}
+
+}
+
+size_t UncountedStringExtra(const ArrayData* in) {
+  if (!RO::EvalAPCCoallocateStrings) return 0;
+  size_t extra = 0;
+  auto const account = [&] (TypedValue tv) {
+    if (!tvIsString(tv)) return;
+    auto const str = val(tv).pstr;
+    if (str->isRefCounted() && !str->empty()) {
+      extra += coallocStringBytes(str->size());
+    }
+  };
+  IterateKV(in, [&] (TypedValue k, TypedValue v) {
+    account(k);
+    account(v);
+  });
+  return extra;
+}
+
+UncountedCoallocScope::UncountedCoallocScope(
+    ArrayData* root, void* mem, size_t bytes)
+  : m_savedRoot(tl_coallocRegion.root)
+  , m_savedCursor(tl_coallocRegion.cursor)
+  , m_savedEnd(tl_coallocRegion.end)
+{
+  // Align the cursor up to 16 bytes; the region start isn't guaranteed to be
+  // aligned (e.g. after a dict's hash table). Any slack this consumes just
+  // pushes the last string onto the separate-allocation fallback.
+  auto const raw = reinterpret_cast<uintptr_t>(mem);
+  auto const cursor = reinterpret_cast<char*>((raw + 15) & ~15ull);
+  tl_coallocRegion = {root, cursor, static_cast<char*>(mem) + bytes};
+}
+
+UncountedCoallocScope::~UncountedCoallocScope() {
+  tl_coallocRegion = {m_savedRoot, m_savedCursor, m_savedEnd};
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void ConvertTvToUncounted(tv_lval source, const MakeUncountedEnv& env) {
   auto& data = source.val();
   auto& type = source.type();
@@ -137,6 +202,15 @@ ArrayData* MakeUncountedArray(
     }
   }
 
+  if (env.precomputed) {
+    auto const it = env.precomputed->find(in);
+    if (it != env.precomputed->end()) {
+      auto const arr = static_cast<ArrayData*>(it->second);
+      arr->uncountedIncRef();
+      return arr;
+    }
+  }
+
   HeapObject** seenArr = nullptr;
   if (env.seen && in->hasMultipleRefs()) {
     seenArr = &(*env.seen)[in];
@@ -146,6 +220,10 @@ ArrayData* MakeUncountedArray(
     }
   }
 
+  // Suspend any active co-allocation region: a nested array gets its own
+  // block (and opens its own scope), and its strings must not end up owned
+  // by an outer array with a different lifetime.
+  UncountedCoallocScope suspend{nullptr, nullptr, 0};
   auto const result = in->makeUncounted(env, hasApcTv);
   // NOTE: We may have mutated env.seen in makeUncounted, so we must redo
   // the hash table lookup here. We only use seenArr to test for presence.
@@ -154,6 +232,13 @@ ArrayData* MakeUncountedArray(
 }
 
 StringData* MakeUncountedString(StringData* in, const MakeUncountedEnv& env) {
+  if (UNLIKELY(in->isUncounted() && in->isUncountedCoalloc())) {
+    // A string co-allocated into some array's block dies with that array, so
+    // we can't share it into a structure with a different lifetime. Make an
+    // independent uncounted copy instead.
+    if (auto const st = lookupStaticString(in)) return st;
+    return StringData::MakeUncounted(in->slice());
+  }
   if (in->persistentIncRef()) return in;
   if (in->empty()) return staticEmptyString();
   if (auto const st = lookupStaticString(in)) return st;
@@ -167,8 +252,13 @@ StringData* MakeUncountedString(StringData* in, const MakeUncountedEnv& env) {
     }
   }
 
-  auto const st = StringData::MakeUncounted(in->slice());
-  if (seenStr) *seenStr = st;
+  auto const st = [&] {
+    if (auto const sd = tryCoallocString(in)) return sd;
+    return StringData::MakeUncounted(in->slice());
+  }();
+  // Never de-dupe through a co-allocated string: a later hit would leak it
+  // into a sibling structure that may outlive its block.
+  if (seenStr && !st->isUncountedCoalloc()) *seenStr = st;
   return st;
 }
 
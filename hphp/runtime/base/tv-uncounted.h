@@ -25,11 +25,15 @@ namespace HPHP {
 //////////////////////////////////////////////////////////////////////////////
 
 /*
- * Global parameters for ConvertTvToUncounted and friends. Only one for now.
+ * Global parameters for ConvertTvToUncounted and friends.
  * If `seen` is provided, we'll use it to de-dupe new uncounted arrays.
+ * If `precomputed` is provided, it maps arrays to uncounted conversions
+ * made ahead of time (see APCArray's parallel construction); hits take an
+ * uncountedIncRef on the existing conversion instead of making a new one.
  */
 struct MakeUncountedEnv {
   DataWalker::PointerMap* seen;
+  DataWalker::PointerMap* precomputed = nullptr;
 };
 
 /*
@@ -58,6 +62,33 @@ ArrayData* MakeUncountedArray(ArrayData* in, const MakeUncountedEnv& env,
                               bool hasApcTv = false);
 StringData* MakeUncountedString(StringData* in, const MakeUncountedEnv& env);
 
+/*
+ * Support for co-allocating flat strings into the block of the uncounted
+ * array that references them (Eval.APCCoallocateStrings).
+ *
+ * UncountedStringExtra returns an upper bound on the extra bytes to reserve
+ * after `in`'s uncounted block for its string keys and values; strings that
+ * end up static or de-duped at conversion time just leave their slot unused.
+ * Returns 0 when the option is off.
+ *
+ * While an UncountedCoallocScope is in scope, MakeUncountedString lays
+ * eligible strings out in [mem, mem + bytes). Such strings are internal to
+ * `root`'s block — they're skipped by its release walk, excluded from
+ * de-duping, and freed along with the block. Scopes nest: a nested array's
+ * scope suspends its parent's, so strings never land in the wrong block.
+ */
+size_t UncountedStringExtra(const ArrayData* in);
+
+struct UncountedCoallocScope {
+  UncountedCoallocScope(ArrayData* root, void* mem, size_t bytes);
+  ~UncountedCoallocScope();
+
+ private:
+  ArrayData* m_savedRoot;
+  char* m_savedCursor;
+  char* m_savedEnd;
+};
+
 /*
  * The analogue of decRefAndRelease for an uncounted value. These helpers all
  * handle both static and uncounted values correctly. It's safe to call them
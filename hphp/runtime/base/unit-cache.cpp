@@ -32,10 +32,12 @@
 #include "hphp/runtime/base/string-util.h"
 #include "hphp/runtime/base/system-profiler.h"
 #include "hphp/runtime/base/vm-worker.h"
+#include "hphp/runtime/base/watchman-connection.h"
 #include "hphp/runtime/base/zend-string.h"
 #include "hphp/runtime/server/cli-server.h"
 #include "hphp/runtime/server/source-root-info.h"
 #include "hphp/runtime/vm/debugger-hook.h"
+#include "hphp/runtime/vm/preclass.h"
 #include "hphp/runtime/vm/repo-file.h"
 #include "hphp/runtime/vm/runtime-compiler.h"
 #include "hphp/runtime/vm/treadmill.h"
@@ -44,6 +46,7 @@
 
 #include "hphp/util/assertions.h"
 #include "hphp/util/build-info.h"
+#include "hphp/util/logger.h"
 #include "hphp/util/mutex.h"
 #include "hphp/util/process.h"
 #include "hphp/util/rank.h"
@@ -57,6 +60,8 @@
 
 #include <folly/AtomicHashMap.h>
 #include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <folly/concurrency/ConcurrentHashMap.h>
 #include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/executors/task_queue/PriorityUnboundedBlockingQueue.h>
 #include <folly/portability/Fcntl.h>
@@ -882,17 +887,26 @@ folly::CPUThreadPoolExecutor& getPrefetchExecutor() {
   };
 
   // This will maintain a thread pool containing between
-  // EvalUnitPrefetcherMinThreads and EvalUnitPrefetcherMaxThreads
-  // threads. New threads are spun up to the max as long as there's
-  // available work. Idle threads for longer than
+  // EvalUnitPrefetcherMinThreads and maxThreads() threads. New
+  // threads are spun up to the max as long as there's available
+  // work. Idle threads for longer than
   // EvalUnitPrefetcherIdleThreadTimeoutSecs will be reaped. The work
   // queue is unbounded, so it will always accept new work.
   struct PrefetcherExecutor : folly::CPUThreadPoolExecutor {
+    // This pool is where all runtime hackc compilation not done
+    // inline by a request happens, so batch warmup throughput is
+    // bounded by its size. EvalUnitPrefetcherScaleToCores lets it
+    // grow to the core count without per-host tuning.
+    static uint32_t maxThreads() {
+      auto const n = RO::EvalUnitPrefetcherMaxThreads;
+      if (!RO::EvalUnitPrefetcherScaleToCores) return n;
+      return std::max<uint32_t>(n, Process::GetCPUCount());
+    }
+
     PrefetcherExecutor()
       : folly::CPUThreadPoolExecutor(
-          {RO::EvalUnitPrefetcherMaxThreads,
-           std::min(RO::EvalUnitPrefetcherMinThreads,
-                    RO::EvalUnitPrefetcherMaxThreads)},
+          {maxThreads(),
+           std::min(RO::EvalUnitPrefetcherMinThreads, maxThreads())},
           std::make_unique<
             folly::PriorityUnboundedBlockingQueue<
               folly::CPUThreadPoolExecutor::CPUTask
@@ -961,6 +975,183 @@ void prefetchSymbolRefs(SymbolRefs symbols, const Unit* loadingUnit) {
   for (auto const& p : paths) prefetchUnit(p, nullptr, loadingUnit);
 }
 
+// Prefetch the units defining the parents, interfaces, used traits,
+// and included enums of the given unit's classes
+// (Eval.UnitPrefetchClassHierarchy). The PreClasses already carry
+// those names, so the expected hierarchy starts loading when the unit
+// does, instead of one named-entity miss at a time when its classes
+// are first used.
+void prefetchClassHierarchy(const Unit& unit) {
+  assertx(!RO::RepoAuthoritative);
+
+  // Without an autoloader we can't map names to paths.
+  if (!AutoloadHandler::s_instance->getAutoloadMap()) return;
+
+  tracing::BlockNoTrace _{"prefetch-class-hierarchy"};
+
+  // Names defined by this unit resolve locally; skip them. All of
+  // these names are static strings, so pointer identity works.
+  hphp_fast_set<const StringData*> defined;
+  for (auto const& pc : unit.preclasses()) defined.insert(pc->name());
+
+  hphp_fast_set<const StringData*> names;
+  auto const add = [&] (const StringData* name) {
+    if (name && !name->empty() && !defined.count(name)) names.insert(name);
+  };
+  for (auto const& pc : unit.preclasses()) {
+    add(pc->parent());
+    for (auto const iface : pc->interfaces()) add(iface.get());
+    for (auto const trait : pc->usedTraits()) add(trait.get());
+    for (auto const e : pc->includedEnums()) add(e.get());
+  }
+
+  hphp_fast_set<StringData*> paths;
+  for (auto const name : names) {
+    if (auto const path = AutoloadHandler::s_instance->getFile(
+          StrNR{name}, AutoloadMap::KindOf::Type)) {
+      paths.insert(makeStaticString(*path));
+    }
+  }
+
+  for (auto const& p : paths) prefetchUnit(p, nullptr, &unit);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Predictive prefetching (Eval.UnitPrefetchProfilePath)
+
+// Profile of the units each entry unit transitively caused to load,
+// persisted across restarts. When a request's entry path is known we
+// immediately enqueue prefetches for everything that entry loaded the
+// last time it ran, overlapping unit I/O and compilation with the
+// entry unit's own processing instead of discovering the set one
+// require at a time. The profile is only advisory: a wrong or stale
+// prediction just causes prefetches which will be dropped or wasted.
+
+constexpr size_t kUnitProfileMaxEntries = 25000;
+constexpr size_t kUnitProfileMaxDeps = 1000;
+
+using UnitProfileMap = tbb::concurrent_hash_map<
+  const StringData*,
+  std::vector<const StringData*>,
+  StaticStringCompare
+>;
+UnitProfileMap s_unitLoadProfile;
+
+bool predictivePrefetchingEnabled() {
+  return !RO::RepoAuthoritative &&
+         unitPrefetchingEnabled() &&
+         !RO::EvalUnitPrefetchProfilePath.empty();
+}
+
+// Kick off prefetches for everything the profile says this entry path
+// loaded before. Called on the request thread as soon as the entry
+// path has been resolved.
+void prefetchProfiledUnits(const StringData* entry) {
+  assertx(entry->isStatic());
+  auto const deps = [&]() -> std::vector<const StringData*> {
+    UnitProfileMap::const_accessor acc;
+    if (!s_unitLoadProfile.find(acc, entry)) return {};
+    return acc->second;
+  }();
+  for (auto const dep : deps) {
+    prefetchUnit(const_cast<StringData*>(dep), nullptr, nullptr);
+  }
+}
+
+// Record this request's transitive unit loads against its entry
+// unit. Runs at request end; the most recent observation for an entry
+// wins, so the profile tracks endpoint behavior as code changes.
+void recordUnitProfileForRequest() {
+  auto const& order = g_context->m_evaledFilesOrder;
+  if (order.size() < 2) return;
+
+  // All of these paths are Unit filepaths, so they're static.
+  auto const entry = order.front();
+  std::vector<const StringData*> deps;
+  deps.reserve(std::min(order.size() - 1, kUnitProfileMaxDeps));
+  for (size_t i = 1; i < order.size(); ++i) {
+    if (deps.size() >= kUnitProfileMaxDeps) break;
+    deps.emplace_back(order[i]);
+  }
+
+  UnitProfileMap::accessor acc;
+  if (!s_unitLoadProfile.find(acc, entry)) {
+    if (s_unitLoadProfile.size() >= kUnitProfileMaxEntries) return;
+    s_unitLoadProfile.insert(acc, entry);
+  }
+  acc->second = std::move(deps);
+}
+
+InitFiniNode s_unitProfileRecord(
+  [] {
+    if (predictivePrefetchingEnabled()) recordUnitProfileForRequest();
+  },
+  InitFiniNode::When::RequestFini
+);
+
+// On-disk format: one line per entry unit; tab-separated absolute
+// paths, the entry first. Loaded once at process init; written back
+// out when the prefetcher shuts down.
+void loadUnitProfile() {
+  assertx(predictivePrefetchingEnabled());
+
+  std::string contents;
+  if (!folly::readFile(RO::EvalUnitPrefetchProfilePath.c_str(), contents)) {
+    // First run, or the profile was cleaned up. Not an error.
+    return;
+  }
+
+  std::vector<folly::StringPiece> lines;
+  folly::split('\n', contents, lines);
+  for (auto const& line : lines) {
+    if (line.empty()) continue;
+    if (s_unitLoadProfile.size() >= kUnitProfileMaxEntries) break;
+
+    std::vector<folly::StringPiece> paths;
+    folly::split('\t', line, paths);
+    if (paths.size() < 2) continue;
+
+    std::vector<const StringData*> deps;
+    deps.reserve(paths.size() - 1);
+    for (size_t i = 1; i < paths.size(); ++i) {
+      if (deps.size() >= kUnitProfileMaxDeps) break;
+      deps.emplace_back(makeStaticString(paths[i].str()));
+    }
+
+    UnitProfileMap::accessor acc;
+    s_unitLoadProfile.insert(acc, makeStaticString(paths[0].str()));
+    acc->second = std::move(deps);
+  }
+}
+
+void saveUnitProfile() {
+  assertx(predictivePrefetchingEnabled());
+
+  std::string contents;
+  for (auto const& kv : s_unitLoadProfile) {
+    contents.append(kv.first->data(), kv.first->size());
+    for (auto const dep : kv.second) {
+      contents.push_back('\t');
+      contents.append(dep->data(), dep->size());
+    }
+    contents.push_back('\n');
+  }
+
+  try {
+    folly::writeFileAtomically(RO::EvalUnitPrefetchProfilePath, contents);
+  } catch (const std::exception& ex) {
+    Logger::Warning("Unable to save unit prefetch profile to %s: %s",
+                    RO::EvalUnitPrefetchProfilePath.c_str(), ex.what());
+  }
+}
+
+InitFiniNode s_unitProfileLoad(
+  [] {
+    if (predictivePrefetchingEnabled()) loadUnitProfile();
+  },
+  InitFiniNode::When::ProcessInit
+);
+
 //////////////////////////////////////////////////////////////////////
 
 void logTearing(const CachedFilePtr& ptr) {
@@ -1165,11 +1356,172 @@ CachedUnit lookupUnitNonRepoAuth(StringData* requestedPath,
     if (auto symbols = cu.unit->claimSymbolRefsForPrefetch()) {
       prefetchSymbolRefs(std::move(*symbols), cu.unit);
     }
+
+    // Likewise (and also just once per unit), warm up the class
+    // hierarchy its PreClasses reference.
+    if (RO::EvalUnitPrefetchClassHierarchy &&
+        unitPrefetchingEnabled() &&
+        cu.unit->claimHierarchyPrefetch()) {
+      prefetchClassHierarchy(*cu.unit);
+    }
   }
 
   return cu;
 }
 
+//////////////////////////////////////////////////////////////////////
+// Watchman-driven freshness (Eval.WatchmanUnitInvalidation)
+
+// Steady-state unit lookups stat() every unique path once per request
+// to decide whether the cached unit is still fresh. On big sandboxes
+// those syscalls dominate request setup. When
+// Eval.WatchmanUnitInvalidation is set, we instead keep a
+// per-source-root cache of stat() results which is invalidated by a
+// Watchman subscription: the first lookup of a path does a real
+// stat(), and subsequent lookups do no syscalls at all until Watchman
+// reports the path changed. Until the subscription delivers its first
+// result, or whenever it reports an error, the root is "unhealthy"
+// and lookups fall back to the normal StatCache path.
+struct WatchedSourceRoot {
+  explicit WatchedSourceRoot(std::string root) : m_root{std::move(root)} {}
+
+  WatchedSourceRoot(const WatchedSourceRoot&) = delete;
+  WatchedSourceRoot& operator=(const WatchedSourceRoot&) = delete;
+
+  // Set up the Watchman subscription. Called exactly once, after this
+  // watcher has won the race to be inserted into the root map. The
+  // subscription callback captures `this`, so a watcher must never be
+  // destroyed once start() has run (the root map is leaked to
+  // guarantee this).
+  void start() {
+    // Watch every file under the root. Units aren't restricted to any
+    // particular extension, so we cannot filter by suffix. We don't
+    // need the initial full listing; a fresh instance just means
+    // "anything may have changed", which an empty cache already
+    // encodes.
+    folly::dynamic query = folly::dynamic::object
+      ("fields", folly::dynamic::array("name"))
+      ("empty_on_fresh_instance", true);
+    get_watchman_client(m_root).subscribe(
+      query,
+      [this] (folly::Try<folly::dynamic>&& results) {
+        process(std::move(results));
+      }
+    );
+  }
+
+  // Attempt to serve a stat() for the given path from the cache,
+  // returning std::nullopt if the path isn't under this root or the
+  // subscription isn't (yet) healthy. The caller should stat normally
+  // in that case.
+  Optional<int> stat(const char* path, struct stat* buf) {
+    if (strncmp(path, m_root.data(), m_root.size()) != 0 ||
+        path[m_root.size()] != '/') {
+      return std::nullopt;
+    }
+    if (!m_healthy.load(std::memory_order_acquire)) return std::nullopt;
+
+    if (auto const it = m_cache.find(path); it != m_cache.cend()) {
+      *buf = it->second.buf;
+      return it->second.ret;
+    }
+
+    // Miss: do the real stat and remember the result. Failures are
+    // cached too; the subscription will tell us when the file gets
+    // created. If a notification batch lands while we're in the
+    // syscall we can't tell whether it raced with this particular
+    // path, so drop the result and re-stat on the next lookup.
+    auto const gen = m_gen.load(std::memory_order_acquire);
+    Entry e;
+    e.ret = StatCache::stat(path, &e.buf);
+    if (m_gen.load(std::memory_order_acquire) == gen) {
+      m_cache.insert(path, e);
+    }
+    *buf = e.buf;
+    return e.ret;
+  }
+
+private:
+  struct Entry {
+    struct stat buf;
+    int ret;
+  };
+
+  // Runs on the Watchman client thread, concurrently with stat().
+  void process(folly::Try<folly::dynamic>&& results) {
+    m_gen.fetch_add(1, std::memory_order_acq_rel);
+    if (results.hasException()) {
+      // Degrade to the normal stat() path until the subscription
+      // recovers.
+      m_healthy.store(false, std::memory_order_release);
+      m_cache.clear();
+      return;
+    }
+    auto const& res = results.value();
+    auto const fresh = res.get_ptr("is_fresh_instance");
+    if (fresh && fresh->isBool() && fresh->asBool()) {
+      // (Re)connected; anything may have changed while we were away.
+      m_cache.clear();
+    } else if (auto const files = res.get_ptr("files")) {
+      if (files->isArray()) {
+        for (auto const& file : *files) {
+          auto const name = file.isObject() ? file.get_ptr("name") : &file;
+          if (name && name->isString()) {
+            m_cache.erase(
+              folly::to<std::string>(m_root, '/', name->getString())
+            );
+          }
+        }
+      }
+    }
+    m_healthy.store(true, std::memory_order_release);
+  }
+
+  std::string m_root; // No trailing slash
+  std::atomic<bool> m_healthy{false};
+  std::atomic<uint64_t> m_gen{0};
+  folly::ConcurrentHashMap<std::string, Entry> m_cache;
+};
+
+using WatchedSourceRootMap =
+  folly::ConcurrentHashMap<std::string, std::shared_ptr<WatchedSourceRoot>>;
+
+WatchedSourceRootMap& watchedSourceRoots() {
+  // Deliberately leaked; see WatchedSourceRoot::start().
+  static auto& map = *new WatchedSourceRootMap();
+  return map;
+}
+
+// Serve the stat() for a unit path from a watched source root, if one
+// covers it. There's typically a small handful of roots (one per
+// sandbox), so the scan is cheap.
+Optional<int> statViaWatchman(const char* path, struct stat* buf) {
+  assertx(RuntimeOption::EvalWatchmanUnitInvalidation);
+  for (auto const& kv : watchedSourceRoots()) {
+    if (auto const ret = kv.second->stat(path, buf)) return ret;
+  }
+  return std::nullopt;
+}
+
+// Start watching the current request's source root if we aren't
+// already. Called at the start of each request-context unit lookup;
+// lookups from other contexts (eg prefetching) just reuse whatever
+// roots requests have already registered.
+void watchSourceRootForUnits() {
+  assertx(RuntimeOption::EvalWatchmanUnitInvalidation);
+  assertx(!RuntimeOption::RepoAuthoritative);
+  auto root = SourceRootInfo::GetCurrentSourceRoot();
+  if (root.empty() || !FileUtil::isAbsolutePath(root)) return;
+  while (root.size() > 1 && FileUtil::isDirSeparator(root.back())) {
+    root.pop_back();
+  }
+  auto& map = watchedSourceRoots();
+  if (map.find(root) != map.cend()) return;
+  auto watcher = std::make_shared<WatchedSourceRoot>(root);
+  auto const res = map.insert(std::move(root), std::move(watcher));
+  if (res.second) res.first->second->start();
+}
+
 //////////////////////////////////////////////////////////////////////
 // resolveVmInclude callbacks
 
@@ -1191,7 +1543,13 @@ bool findFile(const StringData* path, struct stat* s, bool allow_dir,
     return lookupUnitRepoAuth(path, nativeFuncs).unit != nullptr;
   }
 
-  if (StatCache::stat(path->data(), s) == 0) {
+  auto const statRet = [&] {
+    if (RuntimeOption::EvalWatchmanUnitInvalidation) {
+      if (auto const ret = statViaWatchman(path->data(), s)) return *ret;
+    }
+    return StatCache::stat(path->data(), s);
+  }();
+  if (statRet == 0) {
     // The call explicitly populates the struct for dirs, but returns
     // false for them because it is geared toward file includes.
     return allow_dir || !S_ISDIR(s->st_mode);
@@ -1508,12 +1866,24 @@ Unit* lookupUnit(StringData* path, const char* currentDir, bool* initial_opt,
    * in RepoAuthoritative mode, but currently isn't.
    */
 
+  if (RuntimeOption::EvalWatchmanUnitInvalidation &&
+      !RuntimeOption::RepoAuthoritative) {
+    watchSourceRootForUnits();
+  }
+
   struct stat s;
   auto const spath = resolveVmInclude(path, currentDir, &s, nativeFuncs);
   if (spath.isNull()) return nullptr;
 
   auto const eContext = g_context.getNoCheck();
 
+  // If this is the first unit of the request, its path identifies the
+  // endpoint. Warm everything the profile says it's going to load.
+  if (!forPrefetch && predictivePrefetchingEnabled() &&
+      eContext->m_evaledFilesOrder.empty()) {
+    prefetchProfiledUnits(makeStaticString(spath.get()));
+  }
+
   // Check if this file has already been included.
   if (!forPrefetch) {
     auto it = eContext->m_evaledFiles.find(spath.get());
@@ -2201,6 +2571,7 @@ void clearUnitCacheForExit() {
 
 void shutdownUnitPrefetcher() {
   if (RO::RepoAuthoritative || !unitPrefetchingEnabled()) return;
+  if (predictivePrefetchingEnabled()) saveUnitProfile();
   getPrefetchExecutor().join();
 }
 
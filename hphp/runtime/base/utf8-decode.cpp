@@ -20,10 +20,38 @@
 #include "hphp/runtime/base/utf8-decode.h"
 #include "hphp/util/assertions.h"
 
+#include <cstring>
+
+#ifdef __x86_64__
+#include <emmintrin.h>
+#endif
+
 namespace HPHP {
 
 #define CHECK_LEN(pos, chars_need) ((m_strlen - (pos)) >= (chars_need))
 
+int skipAscii(const char* str, int pos, int len) {
+#ifdef __x86_64__
+  while (pos + 16 <= len) {
+    auto const chunk =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + pos));
+    auto const mask = _mm_movemask_epi8(chunk);
+    if (mask) return pos + __builtin_ctz(mask);
+    pos += 16;
+  }
+#else
+  while (pos + 8 <= len) {
+    uint64_t word;
+    memcpy(&word, str + pos, 8);
+    auto const high = word & 0x8080808080808080ULL;
+    if (high) return pos + (__builtin_ctzll(high) >> 3);
+    pos += 8;
+  }
+#endif
+  while (pos < len && !(str[pos] & 0x80)) pos++;
+  return pos;
+}
+
 /* valid as single byte character or leading byte */
 static bool utf8_lead(unsigned char c) {
   return c < 0x80 || (c >= 0xC2 && c <= 0xF4);
@@ -138,10 +166,15 @@ int UTF8To16Decoder::decodeTail() {
 
 int UTF8To16Decoder::decodeAsUTF8() {
   if (m_index == m_cursor) {
-    // validate the next char
-    int c = getNext();
-    if (c < 0) {
-      return c;
+    // Validate ahead of the read position: an ASCII run is accepted in bulk,
+    // anything else goes through the state machine one character at a time.
+    if (m_cursor < m_strlen && !(m_str[m_cursor] & 0x80)) {
+      m_cursor = skipAscii(m_str, m_cursor, m_strlen);
+    } else {
+      int c = getNext();
+      if (c < 0) {
+        return c;
+      }
     }
   }
   return m_str[m_index++] & 0xFF;
@@ -26,6 +26,15 @@
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
 
+/*
+ * Return the end of the run of ASCII bytes starting at `pos', scanning a
+ * vector (or word) at a time.  ASCII needs no validation beyond the high bit
+ * being clear, so pure-ASCII input -- the common case for the strings that
+ * reach the decoders and the mbstring entry points -- can be classified in
+ * bulk instead of byte by byte.
+ */
+int skipAscii(const char* str, int pos, int len);
+
 struct UTF8To16Decoder {
   UTF8To16Decoder(const char *utf8, int length, bool loose)
     : m_str(utf8), m_strlen(length), m_cursor(0), m_loose(loose),
@@ -407,7 +407,8 @@ ArrayData* VanillaDict::MakeUncounted(
   assertx(a->isRefCounted());
 
   auto const extra = uncountedAllocExtra(array, hasApcTv);
-  auto const ad = uncountedAlloc(a->scale(), extra);
+  auto const strExtra = UncountedStringExtra(array);
+  auto const ad = uncountedAlloc(a->scale(), extra, strExtra);
   auto const used = a->m_used;
 
   // Do a raw copy first, without worrying about counted types or refcount
@@ -423,21 +424,28 @@ ArrayData* VanillaDict::MakeUncounted(
   } else {
     ad->m_aux16 &= ~kHasApcTv;
   }
+  if (strExtra) ad->m_aux16 |= kUncountedCoalloc;
   assertx(ad->keyTypes() == a->keyTypes());
   CopyHash(ad->hashTab(), a->hashTab(), a->scale());
   ad->mutableKeyTypes()->makeStatic();
 
-  // Need to make sure keys and values are all uncounted.
-  auto dstElem = ad->data();
-  for (uint32_t i = 0; i < used; ++i) {
-    auto& te = dstElem[i];
-    auto const type = te.data.m_type;
-    if (UNLIKELY(isTombstone(type))) continue;
-    if (te.hasStrKey()) {
-      te.skey = MakeUncountedString(te.skey, env);
-      if (!te.skey->isStatic()) ad->mutableKeyTypes()->recordNonStaticStr();
+  // Need to make sure keys and values are all uncounted. Flat strings may
+  // be co-allocated into the tail of this block.
+  {
+    UncountedCoallocScope coalloc{
+      ad, reinterpret_cast<char*>(ad) + computeAllocBytes(a->scale()), strExtra
+    };
+    auto dstElem = ad->data();
+    for (uint32_t i = 0; i < used; ++i) {
+      auto& te = dstElem[i];
+      auto const type = te.data.m_type;
+      if (UNLIKELY(isTombstone(type))) continue;
+      if (te.hasStrKey()) {
+        te.skey = MakeUncountedString(te.skey, env);
+        if (!te.skey->isStatic()) ad->mutableKeyTypes()->recordNonStaticStr();
+      }
+      ConvertTvToUncounted(&te.data, env);
     }
-    ConvertTvToUncounted(&te.data, env);
   }
 
   assertx(ad->checkInvariants());
@@ -518,11 +526,22 @@ void VanillaDict::ReleaseUncounted(ArrayData* in) {
 
     for (auto ptr = data; ptr != stop; ++ptr) {
       if (isTombstone(ptr->data.m_type)) continue;
-      if (ptr->hasStrKey()) DecRefUncountedString(ptr->skey);
-      DecRefUncounted(ptr->data);
+      // Strings co-allocated into this block are internal to it and are
+      // freed along with it below; they have no independent release.
+      if (ptr->hasStrKey() && !ptr->skey->coallocatedWith(ad)) {
+        DecRefUncountedString(ptr->skey);
+      }
+      auto const tv = ptr->data;
+      if (tvIsString(tv) && val(tv).pstr->coallocatedWith(ad)) continue;
+      DecRefUncounted(tv);
     }
   }
   auto const extra = uncountedAllocExtra(ad, ad->hasApcTv());
+  if (UNLIKELY(ad->hasCoallocStrings())) {
+    // The exact size of the co-allocated string tail isn't recoverable here,
+    // so free the block unsized.
+    return FreeUncounted(reinterpret_cast<char*>(ad) - extra);
+  }
   FreeUncounted(reinterpret_cast<char*>(ad) - extra,
                 computeAllocBytes(ad->scale()) + extra);
 }
@@ -400,12 +400,37 @@ public:
     return a;
   }
 
+  // Software-prefetch tuning for iteration over large dicts. The Elm array
+  // is sequential, so hardware prefetch covers it, but refcounted pointees
+  // are scattered; touching their headers a few elements ahead hides DRAM
+  // stalls once the dict is too big to be cache-resident.
+  static constexpr uint32_t kIterPrefetchDistance = 8;
+  static constexpr uint32_t kIterPrefetchMinUsed = 4096;
+
+  static void prefetchElmData(const Elm* elm) {
+    if (!elm->isTombstone() && isRefcountedType(elm->data.m_type)) {
+      __builtin_prefetch(elm->data.m_data.pcnt, 0, 2); // HINT_T1 on x64
+    }
+  }
+
   // Fast iteration
   template <class F>
   static void IterateV(const VanillaDict* arr, F fn) {
     assertx(arr->isVanillaDict());
     auto elm = arr->data();
-    for (auto i = arr->m_used; i--; elm++) {
+    auto const used = arr->m_used;
+    if (UNLIKELY(used >= kIterPrefetchMinUsed)) {
+      for (uint32_t i = 0; i < used; i++, elm++) {
+        if (i + kIterPrefetchDistance < used) {
+          prefetchElmData(elm + kIterPrefetchDistance);
+        }
+        if (LIKELY(!elm->isTombstone())) {
+          if (ArrayData::call_helper(fn, elm->data)) break;
+        }
+      }
+      return;
+    }
+    for (auto i = used; i--; elm++) {
       if (LIKELY(!elm->isTombstone())) {
         if (ArrayData::call_helper(fn, elm->data)) break;
       }
@@ -415,7 +440,22 @@ public:
   static void IterateKV(const VanillaDict* arr, F fn) {
     assertx(arr->isVanillaDict());
     auto elm = arr->data();
-    for (auto i = arr->m_used; i--; elm++) {
+    auto const used = arr->m_used;
+    if (UNLIKELY(used >= kIterPrefetchMinUsed)) {
+      for (uint32_t i = 0; i < used; i++, elm++) {
+        if (i + kIterPrefetchDistance < used) {
+          prefetchElmData(elm + kIterPrefetchDistance);
+        }
+        if (LIKELY(!elm->isTombstone())) {
+          TypedValue key;
+          key.m_data.num = elm->ikey;
+          key.m_type = elm->hasIntKey() ? KindOfInt64 : KindOfString;
+          if (ArrayData::call_helper(fn, key, elm->data)) break;
+        }
+      }
+      return;
+    }
+    for (auto i = used; i--; elm++) {
       if (LIKELY(!elm->isTombstone())) {
         TypedValue key;
         key.m_data.num = elm->ikey;
@@ -272,10 +272,33 @@ void VanillaVec::CopyPackedHelper(const ArrayData* adIn, ArrayData* ad) {
   auto const size = adIn->m_size;
   memcpy16_inline(ad, adIn, VanillaVec::capacityToSizeBytes(size));
 
-  // Copy counted types correctly
-  for (uint32_t i = 0; i < size; ++i) {
-    auto const elm = LvalUncheckedInt(ad, i);
-    tvIncRefGen(*elm);
+  // Bump refcounts on the contents. The packed-block layout keeps the type
+  // bytes of 8 entries in a single word, so classify a block at a time and
+  // skip blocks with no refcounted values, like Release() does.
+  if constexpr (stores_typed_values) {
+    for (uint32_t i = 0; i < size; ++i) {
+      auto const elm = LvalUncheckedInt(ad, i);
+      tvIncRefGen(*elm);
+    }
+  } else {
+    auto constexpr n = PackedBlock::kNumItems;
+    auto block = PackedBlock::BlockAt(ad, 0);
+    auto remainder = size_t{size};
+    while (remainder >= n) {
+      if (!block.AllTypesAreUncounted(n)) {
+        for (auto i = 0; i < n; i++) {
+          tvIncRefGen(*block[i]);
+        }
+      }
+      ++block;
+      remainder -= n;
+    }
+    if (remainder && !block.AllTypesAreUncounted(remainder)) {
+      auto i = 0;
+      do {
+        tvIncRefGen(*block[i++]);
+      } while (i < remainder);
+    }
   }
 }
 
@@ -458,10 +481,19 @@ void VanillaVec::ReleaseUncounted(ArrayData* ad) {
   assertx(!ad->uncountedCowCheck());
 
   for (uint32_t i = 0; i < ad->m_size; ++i) {
-    DecRefUncounted(*LvalUncheckedInt(ad, i));
+    auto const tv = *LvalUncheckedInt(ad, i);
+    // Strings co-allocated into this block are internal to it and are freed
+    // along with it below; they have no independent release.
+    if (tvIsString(tv) && val(tv).pstr->coallocatedWith(ad)) continue;
+    DecRefUncounted(tv);
   }
 
   auto const extra = uncountedAllocExtra(ad, ad->hasApcTv());
+  if (UNLIKELY(ad->hasCoallocStrings())) {
+    // The exact size of the co-allocated string tail isn't recoverable here,
+    // so free the block unsized.
+    return FreeUncounted(reinterpret_cast<char*>(ad) - extra);
+  }
   auto const bytes = VanillaVec::capacityToSizeBytes(ad->m_size);
   FreeUncounted(reinterpret_cast<char*>(ad) - extra, extra + bytes);
 }
@@ -735,24 +767,30 @@ ArrayData* VanillaVec::MakeUncounted(
   auto const bytes = VanillaVec::capacityToSizeBytes(size);
   auto const sizeIndex = MemoryManager::size2Index(bytes);
   assertx(sizeIndex <= VanillaVec::MaxSizeIndex);
+  auto const strExtra = UncountedStringExtra(array);
 
-  auto const mem = static_cast<char*>(AllocUncounted(bytes + extra));
+  auto const mem = static_cast<char*>(AllocUncounted(bytes + extra + strExtra));
   auto ad = reinterpret_cast<ArrayData*>(mem + extra);
   ad->initHeader_16(
     array->m_kind,
     UncountedValue,
     packSizeIndexAndAuxBits(sizeIndex, array->auxBits()) |
-    (hasApcTv ? ArrayData::kHasApcTv : 0)
+    (hasApcTv ? ArrayData::kHasApcTv : 0) |
+    (strExtra ? ArrayData::kUncountedCoalloc : 0)
   );
   ad->m_size = array->m_size;
   ad->m_layout_index = array->m_layout_index;
 
 
   // Do a raw copy without worrying about refcounts. Then, traverse the
-  // array and convert refcounted objects to their uncounted types.
+  // array and convert refcounted objects to their uncounted types. Flat
+  // strings may be co-allocated into the tail of this block.
   memcpy16_inline(ad + 1, array + 1, bytes - sizeof(ArrayData));
-  for (uint32_t i = 0; i < size; i++) {
-    ConvertTvToUncounted(LvalUncheckedInt(ad, i), env);
+  {
+    UncountedCoallocScope coalloc{ad, mem + extra + bytes, strExtra};
+    for (uint32_t i = 0; i < size; i++) {
+      ConvertTvToUncounted(LvalUncheckedInt(ad, i), env);
+    }
   }
 
   assertx(ad->kind() == array->kind());
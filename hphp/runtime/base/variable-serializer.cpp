@@ -41,6 +41,7 @@
 #include "hphp/runtime/vm/native-data.h"
 #include "hphp/runtime/vm/class-meth-data-ref.h"
 
+#include "hphp/util/conv-10.h"
 #include "hphp/util/exception.h"
 #include "hphp/util/rds-local.h"
 
@@ -578,13 +579,15 @@ void VariableSerializer::write(const char *v, int len /* = -1 */,
   case Type::Serialize:
   case Type::Internal:
   case Type::APCSerialize:
-  case Type::DebuggerSerialize:
-    m_buf->append("s:");
-    m_buf->append(len);
-    m_buf->append(":\"");
-    m_buf->append(v, len);
-    m_buf->append("\";");
+  case Type::DebuggerSerialize: {
+    char lenbuf[12];
+    auto const lenstr = conv_10(len, lenbuf + sizeof(lenbuf));
+    folly::StringPiece const slices[] = {
+      "s:", lenstr, ":\"", {v, static_cast<size_t>(len)}, "\";"
+    };
+    m_buf->append(folly::range(slices));
     break;
+  }
   case Type::JSON: {
     if ((m_option & k_JSON_NUMERIC_CHECK) && !isArrayKey) {
       int64_t lval; double dval;
@@ -22,6 +22,10 @@
 #include <folly/lang/CString.h>
 #include <folly/portability/String.h>
 
+#ifdef __x86_64__
+#include <emmintrin.h>
+#endif
+
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -297,6 +301,76 @@ static int php_htoi(char *s) {
 
 static unsigned char hexchars[] = "0123456789ABCDEF";
 
+/*
+ * Length of the prefix of [from, from + len) made up entirely of bytes
+ * url_encode() passes through unescaped ([0-9A-Za-z._-]). Lets the encode
+ * loop bulk-copy clean runs, which dominate typical query strings, instead
+ * of classifying a byte at a time.
+ */
+static size_t url_clean_span(const unsigned char* from, size_t len) {
+  size_t i = 0;
+#ifdef __x86_64__
+  while (i + 16 <= len) {
+    auto const chunk =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i));
+    // Signed compares treat bytes >= 0x80 as negative, so they fall outside
+    // every range below and get escaped, as they should be.
+    auto const range = [&] (char lo, char hi) {
+      return _mm_and_si128(
+        _mm_cmpgt_epi8(chunk, _mm_set1_epi8(lo - 1)),
+        _mm_cmpgt_epi8(_mm_set1_epi8(hi + 1), chunk)
+      );
+    };
+    auto const is = [&] (char c) {
+      return _mm_cmpeq_epi8(chunk, _mm_set1_epi8(c));
+    };
+    auto const clean = _mm_or_si128(
+      _mm_or_si128(range('0', '9'), range('A', 'Z')),
+      _mm_or_si128(
+        range('a', 'z'),
+        _mm_or_si128(is('-'), _mm_or_si128(is('.'), is('_')))
+      )
+    );
+    auto const dirty = ~_mm_movemask_epi8(clean) & 0xffff;
+    if (dirty) return i + __builtin_ctz(dirty);
+    i += 16;
+  }
+#endif
+  for (; i < len; ++i) {
+    auto const c = from[i];
+    if ((c < '0' && c != '-' && c != '.') ||
+        (c < 'A' && c > '9') ||
+        (c > 'Z' && c < 'a' && c != '_') ||
+        (c > 'z')) {
+      break;
+    }
+  }
+  return i;
+}
+
+/*
+ * Length of the prefix of [from, from + len) containing neither '+' nor '%',
+ * i.e. bytes url_decode() copies through untouched.
+ */
+static size_t url_plain_span(const char* from, size_t len) {
+  size_t i = 0;
+#ifdef __x86_64__
+  while (i + 16 <= len) {
+    auto const chunk =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i));
+    auto const special = _mm_or_si128(
+      _mm_cmpeq_epi8(chunk, _mm_set1_epi8('+')),
+      _mm_cmpeq_epi8(chunk, _mm_set1_epi8('%'))
+    );
+    auto const mask = _mm_movemask_epi8(special);
+    if (mask) return i + __builtin_ctz(mask);
+    i += 16;
+  }
+#endif
+  while (i < len && from[i] != '+' && from[i] != '%') ++i;
+  return i;
+}
+
 String url_encode(const char *s, size_t len) {
   String retString(safe_address(len, 3, 1), ReserveString);
   register unsigned char c;
@@ -308,20 +382,23 @@ String url_encode(const char *s, size_t len) {
   start = to = (unsigned char *)retString.mutableData();
 
   while (from < end) {
-    c = *from++;
+    auto const span = url_clean_span(from, end - from);
+    if (span) {
+      memcpy(to, from, span);
+      to += span;
+      from += span;
+      if (from == end) break;
+    }
 
+    // The byte that stopped the span always needs translation.
+    c = *from++;
     if (c == ' ') {
       *to++ = '+';
-    } else if ((c < '0' && c != '-' && c != '.') ||
-           (c < 'A' && c > '9') ||
-           (c > 'Z' && c < 'a' && c != '_') ||
-           (c > 'z')) {
+    } else {
       to[0] = '%';
       to[1] = hexchars[c >> 4];
       to[2] = hexchars[c & 15];
       to += 3;
-    } else {
-      *to++ = c;
     }
   }
   retString.setSize(to - start);
@@ -334,20 +411,30 @@ String url_decode(const char *s, size_t len) {
   char *dest = str;
   char *data = str;
 
-  while (len--) {
-    if (*data == '+') {
-      *dest = ' ';
+  while (len) {
+    auto const span = url_plain_span(data, len);
+    if (span) {
+      // dest trails data in the same buffer, so the regions may overlap.
+      memmove(dest, data, span);
+      dest += span;
+      data += span;
+      len -= span;
+      if (!len) break;
     }
-    else if (*data == '%' && len >= 2 && isxdigit((int) *(data + 1))
-         && isxdigit((int) *(data + 2))) {
-      *dest = (char) php_htoi(data + 1);
-      data += 2;
-      len -= 2;
+
+    if (*data == '+') {
+      *dest++ = ' ';
+      data++;
+      len--;
+    } else if (len >= 3 && isxdigit((int) *(data + 1))
+               && isxdigit((int) *(data + 2))) {
+      *dest++ = (char) php_htoi(data + 1);
+      data += 3;
+      len -= 3;
     } else {
-      *dest = *data;
+      *dest++ = *data++;
+      len--;
     }
-    data++;
-    dest++;
   }
   retString.setSize(dest - str);
   return retString;
@@ -0,0 +1,135 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010-present Facebook, Inc. (http://www.facebook.com)  |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include "hphp/runtime/bench/bench-harness.h"
+
+#include "hphp/runtime/base/array-init.h"
+#include "hphp/runtime/base/array-iterator.h"
+#include "hphp/runtime/base/static-string-table.h"
+#include "hphp/runtime/base/type-array.h"
+
+#include <folly/Format.h>
+
+#include <vector>
+
+namespace HPHP {
+namespace {
+
+constexpr int64_t kArraySize = 1024;
+
+HPHP_BENCHMARK(array, vec_append) {
+  for (size_t i = 0; i < iters; i++) {
+    auto arr = Array::CreateVec();
+    for (int64_t j = 0; j < kArraySize; j++) {
+      arr.append(j);
+    }
+    bench::doNotOptimizeAway(arr.get());
+  }
+}
+
+HPHP_BENCHMARK(array, dict_set_int_keys) {
+  for (size_t i = 0; i < iters; i++) {
+    auto arr = Array::CreateDict();
+    for (int64_t j = 0; j < kArraySize; j++) {
+      arr.set(j, j * 2);
+    }
+    bench::doNotOptimizeAway(arr.get());
+  }
+}
+
+HPHP_BENCHMARK(array, dict_set_string_keys) {
+  std::vector<String> keys;
+  for (int64_t j = 0; j < kArraySize; j++) {
+    keys.emplace_back(makeStaticString(folly::sformat("key{}", j)));
+  }
+  for (size_t i = 0; i < iters; i++) {
+    auto arr = Array::CreateDict();
+    for (auto const& key : keys) {
+      arr.set(key, 42);
+    }
+    bench::doNotOptimizeAway(arr.get());
+  }
+}
+
+HPHP_BENCHMARK(array, dict_get_int_keys) {
+  auto arr = Array::CreateDict();
+  for (int64_t j = 0; j < kArraySize; j++) {
+    arr.set(j, j * 2);
+  }
+  for (size_t i = 0; i < iters; i++) {
+    int64_t sum = 0;
+    for (int64_t j = 0; j < kArraySize; j++) {
+      sum += arr[j].toInt64();
+    }
+    bench::doNotOptimizeAway(sum);
+  }
+}
+
+HPHP_BENCHMARK(array, dict_get_string_keys) {
+  std::vector<String> keys;
+  auto arr = Array::CreateDict();
+  for (int64_t j = 0; j < kArraySize; j++) {
+    keys.emplace_back(makeStaticString(folly::sformat("key{}", j)));
+    arr.set(keys.back(), j);
+  }
+  for (size_t i = 0; i < iters; i++) {
+    int64_t sum = 0;
+    for (auto const& key : keys) {
+      sum += arr[key].toInt64();
+    }
+    bench::doNotOptimizeAway(sum);
+  }
+}
+
+HPHP_BENCHMARK(array, keyset_add) {
+  for (size_t i = 0; i < iters; i++) {
+    auto arr = Array::CreateKeyset();
+    for (int64_t j = 0; j < kArraySize; j++) {
+      arr.append(j);
+    }
+    bench::doNotOptimizeAway(arr.get());
+  }
+}
+
+HPHP_BENCHMARK(array, dict_iterate) {
+  auto arr = Array::CreateDict();
+  for (int64_t j = 0; j < kArraySize; j++) {
+    arr.set(j, j * 2);
+  }
+  for (size_t i = 0; i < iters; i++) {
+    int64_t sum = 0;
+    for (ArrayIter iter(arr); iter; ++iter) {
+      sum += iter.second().toInt64();
+    }
+    bench::doNotOptimizeAway(sum);
+  }
+}
+
+// Measure COW: copying a vec and mutating one element forces the clone path.
+HPHP_BENCHMARK(array, vec_cow_clone) {
+  auto arr = Array::CreateVec();
+  for (int64_t j = 0; j < kArraySize; j++) {
+    arr.append(j);
+  }
+  for (size_t i = 0; i < iters; i++) {
+    Array copy = arr;
+    copy.set(0, static_cast<int64_t>(i));
+    bench::doNotOptimizeAway(copy.get());
+  }
+}
+
+}
+}
@@ -0,0 +1,114 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010-present Facebook, Inc. (http://www.facebook.com)  |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include "hphp/runtime/bench/bench-harness.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace HPHP { namespace bench {
+
+namespace {
+
+struct Benchmark {
+  const char* group;
+  const char* name;
+  BenchFn fn;
+};
+
+// Registration happens from static constructors, so use a leaked vector to
+// dodge initialization order problems.
+std::vector<Benchmark>& benchmarks() {
+  static auto& v = *new std::vector<Benchmark>();
+  return v;
+}
+
+uint64_t timeIters(BenchFn fn, size_t iters) {
+  auto const start = std::chrono::steady_clock::now();
+  fn(iters);
+  auto const end = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    end - start).count();
+}
+
+// Grow the iteration count until a run takes at least kMinRunNanos, then
+// report the best of kNumTrials runs at that count to damp scheduling noise.
+constexpr uint64_t kMinRunNanos = 100 * 1000 * 1000;
+constexpr int kNumTrials = 3;
+
+double measure(BenchFn fn, size_t& itersOut) {
+  size_t iters = 1;
+  uint64_t nanos;
+  for (;;) {
+    nanos = timeIters(fn, iters);
+    if (nanos >= kMinRunNanos || iters >= (1ull << 40)) break;
+    auto const target = nanos ? iters * kMinRunNanos / nanos : iters * 1000;
+    iters = std::max(iters + 1, target + target / 4);
+  }
+  for (auto trial = 1; trial < kNumTrials; trial++) {
+    nanos = std::min(nanos, timeIters(fn, iters));
+  }
+  itersOut = iters;
+  return double(nanos) / iters;
+}
+
+}
+
+Registrar::Registrar(const char* group, const char* name, BenchFn fn) {
+  benchmarks().push_back(Benchmark{group, name, fn});
+}
+
+int runBenchmarks(int argc, char** argv) {
+  bool json = false;
+  std::string filter;
+  for (auto i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--json")) {
+      json = true;
+    } else if (!strncmp(argv[i], "--filter=", 9)) {
+      filter = argv[i] + 9;
+    } else {
+      fprintf(stderr,
+              "usage: %s [--json] [--filter=SUBSTRING]\n"
+              "  --json    emit one JSON object per benchmark on stdout\n"
+              "  --filter  run only benchmarks whose group/name contains "
+              "SUBSTRING\n",
+              argv[0]);
+      return 1;
+    }
+  }
+
+  fprintf(stderr, "%-50s %15s %12s\n", "benchmark", "ns/iter", "iters");
+  for (auto const& bm : benchmarks()) {
+    auto const full = std::string(bm.group) + "/" + bm.name;
+    if (!filter.empty() && full.find(filter) == std::string::npos) continue;
+
+    size_t iters;
+    auto const nsPerIter = measure(bm.fn, iters);
+    fprintf(stderr, "%-50s %15.2f %12zu\n", full.c_str(), nsPerIter, iters);
+    if (json) {
+      printf("{\"benchmark\":\"%s\",\"ns_per_iter\":%.2f,\"iters\":%zu}\n",
+             full.c_str(), nsPerIter, iters);
+    }
+  }
+  return 0;
+}
+
+}}
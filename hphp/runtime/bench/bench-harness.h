@@ -0,0 +1,64 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010-present Facebook, Inc. (http://www.facebook.com)  |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace HPHP { namespace bench {
+
+/*
+ * Minimal microbenchmark harness for hphp_runtime_bench.
+ *
+ * Benchmark bodies are registered with HPHP_BENCHMARK and receive an
+ * iteration count; the harness calibrates the count so each measurement runs
+ * long enough to be stable, then reports nanoseconds per iteration.  Output
+ * is a human-readable table on stderr and, with --json, one JSON object per
+ * benchmark on stdout so results can be archived and diffed per commit.
+ *
+ * We deliberately don't use folly::Benchmark here: the bundled folly only
+ * builds the core library, not follybenchmark.  The registration macro and
+ * doNotOptimizeAway mirror its interface so bodies could be ported verbatim
+ * if that ever changes.
+ */
+
+using BenchFn = void (*)(size_t iters);
+
+/*
+ * Filter is a substring match on "group/name"; empty matches everything.
+ * Returns a process exit code.
+ */
+int runBenchmarks(int argc, char** argv);
+
+struct Registrar {
+  Registrar(const char* group, const char* name, BenchFn fn);
+};
+
+/*
+ * Keep `v' alive and opaque to the optimizer without emitting any code.
+ */
+template <typename T>
+inline void doNotOptimizeAway(const T& v) {
+  asm volatile("" : : "r,m"(v) : "memory");
+}
+
+}}
+
+#define HPHP_BENCHMARK(group, name)                                     \
+  static void hhvm_bench_##group##_##name(size_t iters);                \
+  static ::HPHP::bench::Registrar s_bench_reg_##group##_##name{         \
+    #group, #name, hhvm_bench_##group##_##name};                        \
+  static void hhvm_bench_##group##_##name(size_t iters)
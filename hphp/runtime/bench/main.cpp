@@ -0,0 +1,30 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010-present Facebook, Inc. (http://www.facebook.com)  |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include "hphp/runtime/bench/bench-harness.h"
+
+#include "hphp/hhvm/process-init.h"
+#include "hphp/runtime/base/rds-local.h"
+
+#include <folly/ScopeGuard.h>
+
+int main(int argc, char** argv) {
+  HPHP::rds::local::init();
+  SCOPE_EXIT { HPHP::rds::local::fini(); };
+  HPHP::init_for_unit_test();
+  SCOPE_EXIT { HPHP::hphp_process_exit(); };
+  return HPHP::bench::runBenchmarks(argc, argv);
+}
@@ -0,0 +1,119 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010-present Facebook, Inc. (http://www.facebook.com)  |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include "hphp/runtime/bench/bench-harness.h"
+
+#include "hphp/runtime/base/array-init.h"
+#include "hphp/runtime/base/string-data.h"
+#include "hphp/runtime/base/tv-conversions.h"
+#include "hphp/runtime/base/type-variant.h"
+#include "hphp/runtime/base/variable-serializer.h"
+#include "hphp/runtime/vm/memo-cache.h"
+
+namespace HPHP {
+namespace {
+
+HPHP_BENCHMARK(refcount, string_copy) {
+  const Variant str(String("a refcounted, non-static string"));
+  for (size_t i = 0; i < iters; i++) {
+    Variant copy = str;
+    bench::doNotOptimizeAway(copy.getRefCount());
+  }
+}
+
+HPHP_BENCHMARK(refcount, array_copy) {
+  auto arr = Array::CreateVec();
+  for (int64_t j = 0; j < 64; j++) arr.append(j);
+  const Variant var(arr);
+  for (size_t i = 0; i < iters; i++) {
+    Variant copy = var;
+    bench::doNotOptimizeAway(copy.getRefCount());
+  }
+}
+
+HPHP_BENCHMARK(tv, cast_string_to_int) {
+  const String str("12345678");
+  for (size_t i = 0; i < iters; i++) {
+    bench::doNotOptimizeAway(
+      tvCastToInt64(make_tv<KindOfString>(str.get())));
+  }
+}
+
+HPHP_BENCHMARK(tv, cast_int_to_string) {
+  for (size_t i = 0; i < iters; i++) {
+    auto sd = tvCastToStringData(
+      make_tv<KindOfInt64>(static_cast<int64_t>(i)));
+    bench::doNotOptimizeAway(sd);
+    decRefStr(sd);
+  }
+}
+
+HPHP_BENCHMARK(serialize, mixed_dict) {
+  auto arr = Array::CreateDict();
+  for (int64_t j = 0; j < 128; j++) {
+    arr.set(j, j % 3 ? Variant(j) : Variant(String("some string value")));
+  }
+  const Variant var(arr);
+  for (size_t i = 0; i < iters; i++) {
+    auto out = internal_serialize(var);
+    bench::doNotOptimizeAway(out.get());
+  }
+}
+
+HPHP_BENCHMARK(serialize, nested_vec) {
+  auto inner = Array::CreateVec();
+  for (int64_t j = 0; j < 16; j++) inner.append(j);
+  auto arr = Array::CreateVec();
+  for (int64_t j = 0; j < 32; j++) arr.append(inner);
+  const Variant var(arr);
+  for (size_t i = 0; i < iters; i++) {
+    auto out = internal_serialize(var);
+    bench::doNotOptimizeAway(out.get());
+  }
+}
+
+// Exercise the specialized single-int-key memo cache: one miss+set per key,
+// then hits dominate, which is the steady-state <<__Memoize>> profile.
+HPHP_BENCHMARK(memo_cache, int_key_get_hit) {
+  auto const get = memoCacheGetForKeyCount(1);
+  auto const set = memoCacheSetForKeyCount(1);
+  MemoCacheBase* cache = nullptr;
+  constexpr int64_t kKeys = 256;
+  for (int64_t j = 0; j < kKeys; j++) {
+    auto const key = make_tv<KindOfInt64>(j);
+    set(cache, &key, make_tv<KindOfInt64>(j * 2));
+  }
+  for (size_t i = 0; i < iters; i++) {
+    auto const key = make_tv<KindOfInt64>(static_cast<int64_t>(i % kKeys));
+    bench::doNotOptimizeAway(get(cache, &key));
+  }
+  delete cache;
+}
+
+HPHP_BENCHMARK(memo_cache, string_key_set) {
+  auto const set = memoCacheSetForKeyCount(1);
+  const String key("memo key string");
+  for (size_t i = 0; i < iters; i++) {
+    MemoCacheBase* cache = nullptr;
+    auto const k = make_tv<KindOfString>(key.get());
+    set(cache, &k, make_tv<KindOfInt64>(42));
+    bench::doNotOptimizeAway(cache);
+    delete cache;
+  }
+}
+
+}
+}
@@ -0,0 +1,79 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010-present Facebook, Inc. (http://www.facebook.com)  |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include "hphp/runtime/bench/bench-harness.h"
+
+#include "hphp/runtime/base/string-data.h"
+#include "hphp/runtime/base/type-string.h"
+
+#include "hphp/util/hash.h"
+
+#include <string>
+
+namespace HPHP {
+namespace {
+
+HPHP_BENCHMARK(string, concat_accumulate) {
+  const String piece("twelve chars");
+  for (size_t i = 0; i < iters; i++) {
+    String acc;
+    for (auto j = 0; j < 64; j++) {
+      acc += piece;
+    }
+    bench::doNotOptimizeAway(acc.get());
+  }
+}
+
+HPHP_BENCHMARK(string, concat_pairwise) {
+  const String lhs("the quick brown fox");
+  const String rhs(" jumps over the lazy dog");
+  for (size_t i = 0; i < iters; i++) {
+    auto out = lhs + rhs;
+    bench::doNotOptimizeAway(out.get());
+  }
+}
+
+HPHP_BENCHMARK(string, hash_short) {
+  const std::string key("id:1234567");
+  for (size_t i = 0; i < iters; i++) {
+    bench::doNotOptimizeAway(hash_string_cs(key.data(), key.size()));
+  }
+}
+
+HPHP_BENCHMARK(string, hash_long) {
+  const std::string key(4096, 'x');
+  for (size_t i = 0; i < iters; i++) {
+    bench::doNotOptimizeAway(hash_string_cs(key.data(), key.size()));
+  }
+}
+
+HPHP_BENCHMARK(string, hash_case_insensitive) {
+  const std::string key("SomeClassName\\WithNamespace");
+  for (size_t i = 0; i < iters; i++) {
+    bench::doNotOptimizeAway(hash_string_i(key.data(), key.size()));
+  }
+}
+
+HPHP_BENCHMARK(string, make_release) {
+  for (size_t i = 0; i < iters; i++) {
+    auto sd = StringData::Make("a reasonably sized string", CopyString);
+    bench::doNotOptimizeAway(sd);
+    decRefStr(sd);
+  }
+}
+
+}
+}
@@ -150,6 +150,11 @@ void apcExtension::moduleLoad(const IniSetting::Map& ini, Hdf config) {
   if (!UseUncounted && ShareUncounted) ShareUncounted = false;
 
   Config::Bind(SizedSampleBytes, ini, config, "Server.APC.SizedSampleBytes", 0);
+  Config::Bind(SnapshotFile, ini, config, "Server.APC.SnapshotFile", "");
+  Config::Bind(ColdCompressionAgeSeconds, ini, config,
+               "Server.APC.ColdCompressionAgeSeconds", 0);
+  Config::Bind(ParallelUncountedMinBytes, ini, config,
+               "Server.APC.ParallelUncountedMinBytes", 0);
 
   IniSetting::Bind(this, IniSetting::PHP_INI_SYSTEM, "apc.enabled", &Enable);
   IniSetting::Bind(this, IniSetting::PHP_INI_SYSTEM, "apc.stat",
@@ -164,6 +169,9 @@ void apcExtension::moduleInit() {
     UseUncounted = true;
   }
   apc_store().init();
+  if (!SnapshotFile.empty()) {
+    apc_store().loadSnapshot(SnapshotFile, SnapshotOffset, SnapshotSize);
+  }
 
   HHVM_RC_INT(APC_ITER_TYPE, 0x1);
   HHVM_RC_INT(APC_ITER_KEY, 0x2);
@@ -201,10 +209,15 @@ void apcExtension::moduleInit() {
 }
 
 void apcExtension::moduleShutdown() {
+  // A bundle-resident snapshot is read-only; don't try to overwrite it.
+  if (Enable && !SnapshotFile.empty() && SnapshotSize == 0) {
+    apc_store().saveSnapshot(SnapshotFile);
+  }
 }
 
 void apcExtension::requestShutdown() {
   apc_store().purgeExpired();
+  apc_store().compressCold();
 }
 
 std::string apcExtension::serialize() {
@@ -244,6 +257,11 @@ bool apcExtension::Stat = true;
 bool apcExtension::EnableCLI = true;
 bool apcExtension::DeferredExpiration = true;
 uint32_t apcExtension::SizedSampleBytes = 0;
+std::string apcExtension::SnapshotFile;
+uint64_t apcExtension::SnapshotOffset = 0;
+uint64_t apcExtension::SnapshotSize = 0;
+int apcExtension::ColdCompressionAgeSeconds = 0;
+int64_t apcExtension::ParallelUncountedMinBytes = 0;
 
 static apcExtension s_apc_extension;
 
@@ -373,25 +391,29 @@ TypedValue HHVM_FUNCTION(apc_fetch, const Variant& key, bool& success) {
   Variant v;
 
   if (key.isArray()) {
-    bool tmp = false;
     auto keys = key.asCArrRef();
-    DictInit init(keys.size());
+    req::vector<String> strKeys;
+    strKeys.reserve(keys.size());
     for (ArrayIter iter(keys); iter; ++iter) {
       Variant k = iter.second();
       if (!k.isString()) {
         raise_invalid_argument_warning("apc key: (not a string)");
         return make_tv<KindOfBoolean>(false);
       }
-      auto strKey = k.asCStrRef();
-      if (apc_store().get(strKey, v)) {
-        if (RuntimeOption::EnableAPCStats) {
-          ServerStats::Log("apc.hit", 1);
-        }
-        tmp = true;
-        init.set(strKey, v);
-      }
+      strKeys.emplace_back(k.asCStrRef());
+    }
+    // Fetch the whole batch in one pass over the store rather than paying
+    // for the global lock and hot-cache probe per key.
+    req::vector<std::pair<bool,Variant>> results;
+    auto const hits = apc_store().getMulti(strKeys, results);
+    if (RuntimeOption::EnableAPCStats && hits > 0) {
+      ServerStats::Log("apc.hit", hits);
+    }
+    DictInit init(strKeys.size());
+    for (size_t i = 0; i < strKeys.size(); ++i) {
+      if (results[i].first) init.set(strKeys[i], results[i].second);
     }
-    success = tmp;
+    success = hits > 0;
     return tvReturn(init.toVariant());
   }
 
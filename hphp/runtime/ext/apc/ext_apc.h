@@ -47,6 +47,22 @@ struct apcExtension final : Extension {
   static bool EnableCLI;
   static bool DeferredExpiration;
   static uint32_t SizedSampleBytes;
+  // If nonempty, load a warm-restart snapshot from this path at boot and
+  // write one back at shutdown. See ConcurrentTableSharedStore::saveSnapshot.
+  static std::string SnapshotFile;
+  // Window of SnapshotFile holding the snapshot, when it is embedded in a
+  // jumpstart bundle.  Zero means the whole file; a non-zero size also
+  // suppresses writing a snapshot at shutdown, since the bundle is
+  // read-only.  Set by the bundle loader, not bound to a config.
+  static uint64_t SnapshotOffset;
+  static uint64_t SnapshotSize;
+  // Compress values not read within this many seconds, decompressing
+  // transparently on the next read. 0 disables the cold tier.
+  static int ColdCompressionAgeSeconds;
+  // Build uncounted representations of arrays at least this big (source
+  // bytes) with a small thread pool instead of on the request thread.
+  // 0 disables parallel construction.
+  static int64_t ParallelUncountedMinBytes;
 
   void moduleLoad(const IniSetting::Map& ini, Hdf config) override;
   void moduleInit() override;
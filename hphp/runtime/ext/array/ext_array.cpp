@@ -21,6 +21,7 @@
 #include "hphp/runtime/base/array-init.h"
 #include "hphp/runtime/base/array-provenance.h"
 #include "hphp/runtime/base/bespoke-array.h"
+#include "hphp/runtime/base/bespoke/monotype-vec.h"
 #include "hphp/runtime/base/builtin-functions.h"
 #include "hphp/runtime/base/collections.h"
 #include "hphp/runtime/base/comparisons.h"
@@ -760,6 +761,14 @@ TypedValue HHVM_FUNCTION(array_product,
     return make_tv<KindOfNull>();
   }
 
+  // Int and double MonotypeVecs can be multiplied with a flat loop.
+  if (tvIsVec(*input.asTypedValue())) {
+    if (auto const prod =
+        bespoke::MonotypeVec::Product(val(*input.asTypedValue()).parr)) {
+      return *prod;
+    }
+  }
+
   int64_t i = 1;
   ArrayIter iter(input);
   for (; iter; ++iter) {
@@ -1037,6 +1046,13 @@ TypedValue HHVM_FUNCTION(array_sum,
     return make_tv<KindOfNull>();
   }
 
+  // Int and double MonotypeVecs can be summed with a flat loop.
+  if (tvIsVec(*input.asTypedValue())) {
+    if (auto const sum = bespoke::MonotypeVec::Sum(val(*input.asTypedValue()).parr)) {
+      return *sum;
+    }
+  }
+
   int64_t i = 0;
   ArrayIter iter(input);
   for (; iter; ++iter) {
@@ -1307,6 +1323,14 @@ bool HHVM_FUNCTION(in_array,
                    const Variant& needle,
                    const Variant& haystack,
                    bool strict /* = false */) {
+  // An int needle in an int MonotypeVec reduces to an equality scan; strict
+  // and loose comparison agree when the types already match.
+  if (tvIsInt(*needle.asTypedValue()) && tvIsVec(*haystack.asTypedValue())) {
+    auto const found = bespoke::MonotypeVec::ContainsInt(
+        val(*haystack.asTypedValue()).parr, val(*needle.asTypedValue()).num);
+    if (found) return *found;
+  }
+
   bool ret = false;
   auto ok = strict ?
     IterateV(*haystack.asTypedValue(),
@@ -2407,7 +2431,7 @@ struct Collator final : RequestEventHandler {
     }
     m_errcode.clearError();
     UErrorCode error = U_ZERO_ERROR;
-    m_ucoll = ucol_open(locale.data(), &error);
+    m_ucoll = Intl::cloneCachedCollator(locale.data(), error);
     if (m_ucoll == NULL) {
       raise_warning("failed to load %s locale from icu data", locale.data());
       return false;
@@ -2464,7 +2488,7 @@ struct Collator final : RequestEventHandler {
     m_locale = String(uloc_getDefault(), CopyString);
     m_errcode.clearError();
     UErrorCode error = U_ZERO_ERROR;
-    m_ucoll = ucol_open(m_locale.data(), &error);
+    m_ucoll = Intl::cloneCachedCollator(m_locale.data(), error);
     if (U_FAILURE(error)) {
       m_errcode.setError(error);
     }
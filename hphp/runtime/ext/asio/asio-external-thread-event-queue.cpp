@@ -31,7 +31,28 @@ AsioExternalThreadEventQueue::AsioExternalThreadEventQueue()
 }
 
 /**
- * Process all received finished events.
+ * Reverse a batch of events grabbed from the queue.
+ *
+ * send() pushes onto an intrusive LIFO stack, so a drained batch arrives in
+ * reverse send order. Reversing it once per batch lets processAllReceived()
+ * and abandonAllReceived() run in the order the external threads finished,
+ * at O(1) per event.
+ */
+c_ExternalThreadEventWaitHandle*
+AsioExternalThreadEventQueue::reverseReceived(
+    c_ExternalThreadEventWaitHandle* received) {
+  c_ExternalThreadEventWaitHandle* prev = nullptr;
+  while (received) {
+    auto const next = received->getNextToProcess();
+    received->setNextToProcess(prev);
+    prev = received;
+    received = next;
+  }
+  return prev;
+}
+
+/**
+ * Process all received finished events in the order they were sent.
  *
  * May throw C++ exception that may leave some events unprocessed.
  */
@@ -70,6 +91,7 @@ bool AsioExternalThreadEventQueue::tryReceiveSome() {
   assertx(!m_received);
   m_received = m_queue.exchange(nullptr);
   assertx(m_received != K_CONSUMER_WAITING);
+  m_received = reverseReceived(m_received);
   return m_received;
 }
 
@@ -88,6 +110,7 @@ bool AsioExternalThreadEventQueue::receiveSomeUntil(
   m_received = m_queue.exchange(nullptr);
   if (m_received) {
     assertx(m_received != K_CONSUMER_WAITING);
+    m_received = reverseReceived(m_received);
     return true;
   }
 
@@ -113,6 +136,7 @@ bool AsioExternalThreadEventQueue::receiveSomeUntil(
           m_received = nullptr;
           return false;
         } else {
+          m_received = reverseReceived(m_received);
           return true;
         }
       }
@@ -124,6 +148,7 @@ bool AsioExternalThreadEventQueue::receiveSomeUntil(
   m_received = m_queue.exchange(nullptr);
   assertx(m_received);
   assertx(m_received != K_CONSUMER_WAITING);
+  m_received = reverseReceived(m_received);
 
   return true;
 }
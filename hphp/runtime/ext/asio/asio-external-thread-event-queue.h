@@ -50,6 +50,9 @@ struct AsioExternalThreadEventQueue final {
   void send(c_ExternalThreadEventWaitHandle* wait_handle);
 
 private:
+  static c_ExternalThreadEventWaitHandle* reverseReceived(
+      c_ExternalThreadEventWaitHandle* received);
+
   c_ExternalThreadEventWaitHandle* m_received;
   std::atomic<c_ExternalThreadEventWaitHandle*> m_queue;
   std::mutex m_queueMutex;
@@ -357,6 +357,9 @@ bool AsioSession::processSleepEvents() {
     }
     if (wh->process()) {
       woken = true;
+    } else if (m_cancelledSleepEvents > 0) {
+      // Popped a cancelled event that lazy compaction hadn't reached yet.
+      --m_cancelledSleepEvents;
     }
     decRefObj(wh);
     std::pop_heap(m_sleepEvents.begin(), m_sleepEvents.end(), sleep_compare);
@@ -366,13 +369,49 @@ bool AsioSession::processSleepEvents() {
   return woken;
 }
 
+void AsioSession::markSleepEventCancelled() {
+  // Cancelled sleep events are removed from the queue lazily, but once they
+  // make up more than half of it, compact it so that memory usage and the
+  // cost of heap pushes stay proportional to the number of live sleepers.
+  // This amortizes to O(1) per cancellation.
+  if (++m_cancelledSleepEvents <= m_sleepEvents.size() / 2) return;
+
+  m_sleepEvents.erase(
+    std::remove_if(
+      m_sleepEvents.begin(), m_sleepEvents.end(),
+      [] (c_SleepWaitHandle* wh) {
+        if (!wh->isFailed()) return false;
+        decRefObj(wh);
+        return true;
+      }
+    ),
+    m_sleepEvents.end()
+  );
+  std::make_heap(m_sleepEvents.begin(), m_sleepEvents.end(), sleep_compare);
+  m_cancelledSleepEvents = 0;
+}
+
+void AsioSession::skipCancelledSleepEvents() {
+  // Drop cancelled events from the front of the queue, so we never report,
+  // or schedule a wakeup for, a deadline that was already abandoned.
+  while (!m_sleepEvents.empty() && m_sleepEvents.front()->isFailed()) {
+    auto const wh = m_sleepEvents.front();
+    std::pop_heap(m_sleepEvents.begin(), m_sleepEvents.end(), sleep_compare);
+    m_sleepEvents.pop_back();
+    decRefObj(wh);
+    if (m_cancelledSleepEvents > 0) --m_cancelledSleepEvents;
+  }
+}
+
 AsioSession::TimePoint AsioSession::sleepWakeTime() {
+  skipCancelledSleepEvents();
   auto const timeout = getLatestWakeTime();
   return m_sleepEvents.empty() ? timeout :
          min(timeout, m_sleepEvents.front()->getWakeTime());
 }
 
 c_SleepWaitHandle* AsioSession::nextSleepEvent() {
+  skipCancelledSleepEvents();
   if (m_sleepEvents.empty()) {
     return nullptr;
   }
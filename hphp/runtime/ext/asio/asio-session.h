@@ -32,6 +32,7 @@ struct c_Awaitable;
 struct c_AwaitAllWaitHandle;
 struct c_ConditionWaitHandle;
 struct c_ResumableWaitHandle;
+struct c_StaticWaitHandle;
 
 struct AsioSession final {
   static void Init();
@@ -85,12 +86,31 @@ struct AsioSession final {
   // Sleep event management.
   void enqueueSleepEvent(c_SleepWaitHandle* h);
   bool processSleepEvents();
-  // Wakeup time of next sleep wait handle or request timeout time.
-  // The returned timestamp may correspond to canceled wait handle.
+  // Note that a sleep event was cancelled; cancelled events are removed
+  // lazily, compacting the queue if dead entries start to dominate it.
+  void markSleepEventCancelled();
+  // Wakeup time of next live sleep wait handle or request timeout time.
   TimePoint sleepWakeTime();
-  // The next wait handle to wake up. The wait handle may be cancled
+  // The next live wait handle to wake up.
   c_SleepWaitHandle* nextSleepEvent();
 
+  // Recycling of StaticWaitHandle slots. Released handles are kept by the
+  // session as null-succeeded handles, up to a fixed cap, and handed back
+  // out by c_StaticWaitHandle::Create*() instead of hitting the allocator.
+  bool recycleStaticWaitHandle(c_StaticWaitHandle* wh) {
+    if (m_staticWaitHandles.size() >= kMaxRecycledStaticWaitHandles) {
+      return false;
+    }
+    m_staticWaitHandles.push_back(wh);
+    return true;
+  }
+  c_StaticWaitHandle* reclaimStaticWaitHandle() {
+    if (m_staticWaitHandles.empty()) return nullptr;
+    auto wh = m_staticWaitHandles.back();
+    m_staticWaitHandles.pop_back();
+    return wh;
+  }
+
   // Abrupt interrupt exception.
   ObjectData* getAbruptInterruptException() {
     return m_abruptInterruptException.get();
@@ -159,10 +179,16 @@ private:
   AsioSession();
   friend AsioSession* req::make_raw<AsioSession>();
 
+  void skipCancelledSleepEvents();
+
 private:
   static RDS_LOCAL_NO_CHECK(AsioSession*, s_current);
   req::vector<AsioContext*> m_contexts;
+  static constexpr size_t kMaxRecycledStaticWaitHandles = 64;
+
   req::vector<c_SleepWaitHandle*> m_sleepEvents;
+  uint32_t m_cancelledSleepEvents{0};
+  req::vector<c_StaticWaitHandle*> m_staticWaitHandles;
   AsioExternalThreadEventQueue m_externalThreadEventQueue;
 
   Object m_abruptInterruptException;
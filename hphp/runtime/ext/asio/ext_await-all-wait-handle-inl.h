@@ -25,9 +25,8 @@ namespace HPHP {
 template<typename T>
 void c_AwaitAllWaitHandle::forEachChild(T fn) {
   for (uint32_t idx = 0; idx < m_cap; ++idx) {
-    auto const child = m_children[idx].m_child;
-    if (child->isFinished()) continue;
-    fn(child);
+    if (m_children[idx].isFinished()) continue;
+    fn(m_children[idx].m_child);
   }
 }
 
@@ -290,11 +290,17 @@ void c_AwaitAllWaitHandle::onUnblocked(uint32_t idx) {
   assertx(idx <= m_unfinished);
   assertx(getState() == STATE_BLOCKED);
 
+  m_children[idx].markFinished();
+
   if (idx == m_unfinished) {
+    // Every finished child has delivered its notification by now (finishing
+    // drains the parent chain synchronously), so the node tags are exact and
+    // this scan stays within our own contiguous allocation.
     for (uint32_t next = idx - 1; next < idx; --next) {
-      auto const child = m_children[next].m_child;
-      if (!child->isFinished()) {
+      if (!m_children[next].isFinished()) {
         // Found the next unfinished child.
+        auto const child = m_children[next].m_child;
+        assertx(!child->isFinished());
         m_unfinished = next;
 
         // Make sure there's no cyclic dependencies.
@@ -321,11 +327,11 @@ void c_AwaitAllWaitHandle::markAsFinished() {
 
 void c_AwaitAllWaitHandle::markAsFailed(const Object& exception) {
   for (uint32_t idx = 0; idx < m_cap; idx++) {
-    auto const child = m_children[idx].m_child;
-    if (!child->isFinished()) {
-      // Remove the current AAWH from the parent chain of all children.
-      child->getParentChain().removeFromChain(&m_children[idx].m_blockable);
-    }
+    if (m_children[idx].isFinished()) continue;
+    // Remove the current AAWH from the parent chain of all unfinished
+    // children.
+    m_children[idx].m_child->getParentChain().removeFromChain(
+      &m_children[idx].m_blockable);
   }
 
   auto parentChain = getParentChain();
@@ -70,8 +70,24 @@ struct c_AwaitAllWaitHandle final : c_WaitableWaitHandle {
       return offsetof(Node, m_blockable);
     }
 
+    /*
+     * Finished children are tagged in the high bit of m_index when their
+     * unblock notification is delivered, so scans for the next unfinished
+     * child walk this wait handle's own contiguous nodes instead of
+     * dereferencing every child's state.
+     */
+    static constexpr uint32_t kFinishedBit = 1u << 31;
+
     uint32_t getChildIdx() {
-      return m_index;
+      return m_index & ~kFinishedBit;
+    }
+
+    bool isFinished() const {
+      return m_index & kFinishedBit;
+    }
+
+    void markFinished() {
+      m_index |= kFinishedBit;
     }
 
     inline c_AwaitAllWaitHandle* getWaitHandle() {
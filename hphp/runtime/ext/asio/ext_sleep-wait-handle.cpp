@@ -87,8 +87,10 @@ bool c_SleepWaitHandle::cancel(const Object& exception) {
   tvWriteObject(exception.get(), &m_resultOrException);
   parentChain.unblock();
 
-  // this is technically a lie, since sleep failed
   auto session = AsioSession::Get();
+  session->markSleepEventCancelled();
+
+  // this is technically a lie, since sleep failed
   if (UNLIKELY(session->hasOnSleepSuccess())) {
     session->onSleepSuccess(
       this,
@@ -18,6 +18,8 @@
 #include "hphp/runtime/ext/asio/ext_static-wait-handle.h"
 
 #include "hphp/runtime/base/init-fini-node.h"
+#include "hphp/runtime/base/tv-mutate.h"
+#include "hphp/runtime/ext/asio/asio-session.h"
 #include "hphp/runtime/ext/asio/ext_asio.h"
 #include "hphp/system/systemlib.h"
 
@@ -29,12 +31,36 @@ rds::Link<Object, rds::Mode::Normal> c_StaticWaitHandle::TrueHandle;
 rds::Link<Object, rds::Mode::Normal> c_StaticWaitHandle::FalseHandle;
 
 c_StaticWaitHandle* c_StaticWaitHandle::CreateSucceededImpl(const TypedValue result) {
+  if (auto const wh = AsioSession::Get()->reclaimStaticWaitHandle()) {
+    assertx(wh->hasExactlyOneRef());
+    wh->setState(STATE_SUCCEEDED);
+    tvCopy(result, wh->m_resultOrException);
+    return wh;
+  }
   auto waitHandle = req::make<c_StaticWaitHandle>();
   waitHandle->setState(STATE_SUCCEEDED);
   tvCopy(result, waitHandle->m_resultOrException);
   return waitHandle.detach();
 }
 
+/**
+ * Release a StaticWaitHandle object. Instead of freeing the slot, recycle it
+ * through the session, up to a fixed cap. The cached slot is reinitialized as
+ * a null-succeeded handle with a single reference owned by the session, so
+ * heap scans see a normal object.
+ */
+void c_StaticWaitHandle::instanceDtor(ObjectData* obj, const Class*) {
+  auto wh = wait_handle<c_StaticWaitHandle>(obj);
+  wh->~c_StaticWaitHandle();
+  if (AsioSession::Get()->recycleStaticWaitHandle(wh)) {
+    new (wh) c_StaticWaitHandle();
+    wh->setState(STATE_SUCCEEDED);
+    tvWriteNull(wh->m_resultOrException);
+    return;
+  }
+  tl_heap->objFree(obj, sizeof(c_StaticWaitHandle));
+}
+
 /**
  * Create succeeded StaticWaitHandle object.
  *
@@ -66,6 +92,12 @@ c_StaticWaitHandle* c_StaticWaitHandle::CreateFailed(ObjectData* exception) {
   assertx(exception);
   assertx(exception->instanceof(SystemLib::s_ThrowableClass));
 
+  if (auto const wh = AsioSession::Get()->reclaimStaticWaitHandle()) {
+    assertx(wh->hasExactlyOneRef());
+    wh->setState(STATE_FAILED);
+    tvCopy(make_tv<KindOfObject>(exception), wh->m_resultOrException);
+    return wh;
+  }
   auto waitHandle = req::make<c_StaticWaitHandle>();
   waitHandle->setState(STATE_FAILED);
   tvCopy(make_tv<KindOfObject>(exception), waitHandle->m_resultOrException);
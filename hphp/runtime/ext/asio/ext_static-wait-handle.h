@@ -34,7 +34,7 @@ namespace HPHP {
  */
 struct c_StaticWaitHandle final : c_Awaitable {
   WAITHANDLE_CLASSOF(StaticWaitHandle);
-  WAITHANDLE_DTOR(StaticWaitHandle);
+  static void instanceDtor(ObjectData* obj, const Class*);
 
   explicit c_StaticWaitHandle()
     : c_Awaitable(c_StaticWaitHandle::classof(),
@@ -166,7 +166,16 @@ MySSLContextProvider* getSSLContextProvider(const Object& ctx) {
 }
 
 static std::shared_ptr<am::AsyncMysqlClient> getClient() {
-  return folly::Singleton<AsyncMysqlClientPool>::try_get()->getClient();
+  // Pin each worker thread to a single client shard. Repeated acquisitions
+  // skip the singleton and client-pool locks, and every connection pool a
+  // thread creates stays on one IO thread, so pooled connections are sharded
+  // per-thread instead of scattered across shards.
+  static thread_local std::shared_ptr<am::AsyncMysqlClient> s_cachedClient;
+  if (!s_cachedClient) {
+    s_cachedClient =
+        folly::Singleton<AsyncMysqlClientPool>::try_get()->getClient();
+  }
+  return s_cachedClient;
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -1432,19 +1441,18 @@ Variant buildTypedValue(const am::RowFields* row_fields,
     return init_null();
   }
 
-  // The underlying library may return zero length null ptr's to
-  // indicate an empty string (since the isNull check above would tell
-  // if it were actually NULL).
-  String string_value =
-      (row[field_num].data() == nullptr && row[field_num].size() == 0)
-          ? empty_string()
-          : String(row[field_num].data(), row[field_num].size(), CopyString);
-
-  if (!typed_values) {
-    return string_value;
+  // mysql_makevalue_slice parses numeric fields straight out of the row
+  // block without allocating a String for them, and treats the zero length
+  // null ptr the underlying library uses for an empty string (the isNull
+  // check above would tell if it were actually NULL) as empty.
+  if (typed_values) {
+    return mysql_makevalue_slice(row[field_num],
+                                 row_fields->getFieldType(field_num));
   }
 
-  return mysql_makevalue(string_value, row_fields->getFieldType(field_num));
+  return (row[field_num].data() == nullptr && row[field_num].size() == 0)
+      ? empty_string()
+      : String(row[field_num].data(), row[field_num].size(), CopyString);
 }
 }
 
@@ -86,8 +86,14 @@ void BaseVector::addAllImpl(const Variant& t) {
     [&, this](ArrayData* adata) {
       if (adata->empty()) return true;
       if (m_size) {
-        reserve(m_size + adata->size());
-        return false;
+        auto const size = adata->size();
+        reserve(m_size + size);
+        if (!adata->isVanillaVec()) return false;
+        // Bulk-append the whole slice: one capacity check and one
+        // refcount pass, instead of a per-element addRaw loop.
+        copySlice(adata, arrayData(), 0, m_size, size);
+        setSize(m_size + size);
+        return true;
       }
       // The ArrayData backing a Vector must be a vanilla, unmarked vec.
       // Do all three escalations here. Dec-ref any intermediate values we
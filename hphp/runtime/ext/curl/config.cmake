@@ -1,11 +1,13 @@
 HHVM_DEFINE_EXTENSION("curl"
   SOURCES
+    curl-connection-pool.cpp
     curl-multi-await.cpp
     curl-multi-resource.cpp
     curl-resource.cpp
     ext_curl.cpp
     curl-share-resource.cpp
   HEADERS
+    curl-connection-pool.h
     curl-multi-await.h
     curl-multi-resource.h
     curl-resource.h
@@ -0,0 +1,88 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010-present Facebook, Inc. (http://www.facebook.com)  |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include "hphp/runtime/ext/curl/curl-connection-pool.h"
+
+#include "hphp/runtime/base/runtime-option.h"
+#include "hphp/runtime/server/server-stats.h"
+
+#include <mutex>
+
+namespace HPHP {
+/////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/* libcurl serializes access to each kind of shared data through these
+ * callbacks; it never locks the same kind twice from one thread, so plain
+ * mutexes suffice. */
+std::mutex s_shareLocks[CURL_LOCK_DATA_LAST];
+
+void pool_lock(CURL* /*cp*/, curl_lock_data data,
+               curl_lock_access /*access*/, void* /*userp*/) {
+  s_shareLocks[data].lock();
+}
+
+void pool_unlock(CURL* /*cp*/, curl_lock_data data, void* /*userp*/) {
+  s_shareLocks[data].unlock();
+}
+
+/* Built once on first use and retained for the life of the process; easy
+ * handles only borrow it, so there is nothing to tear down. */
+CURLSH* getShare() {
+  static CURLSH* share = [] {
+    auto sh = curl_share_init();
+    if (!sh) return static_cast<CURLSH*>(nullptr);
+    curl_share_setopt(sh, CURLSHOPT_LOCKFUNC, pool_lock);
+    curl_share_setopt(sh, CURLSHOPT_UNLOCKFUNC, pool_unlock);
+    curl_share_setopt(sh, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(sh, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#if LIBCURL_VERSION_NUM >= 0x073900 /* 7.57.0: shared connection cache */
+    curl_share_setopt(sh, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
+    return sh;
+  }();
+  return share;
+}
+
+} // namespace
+
+bool CurlConnectionPool::Enabled() {
+  return RuntimeOption::HttpCurlConnectionPool;
+}
+
+void CurlConnectionPool::Attach(CURL* cp) {
+  if (!Enabled()) return;
+  auto share = getShare();
+  if (!share) return;
+  curl_easy_setopt(cp, CURLOPT_SHARE, share);
+}
+
+void CurlConnectionPool::LogReuse(CURL* cp) {
+  if (!Enabled()) return;
+  long connects = 0;
+  if (curl_easy_getinfo(cp, CURLINFO_NUM_CONNECTS, &connects) != CURLE_OK) {
+    return;
+  }
+  if (connects == 0) {
+    ServerStats::Log("curl.pool.reuse", 1);
+  } else {
+    ServerStats::Log("curl.pool.new_conn", connects);
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+}
@@ -0,0 +1,50 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010-present Facebook, Inc. (http://www.facebook.com)  |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#pragma once
+
+#include <curl/curl.h>
+
+namespace HPHP {
+/////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Process-level curl connection pool.
+ *
+ * One CURLSH share handle owned by the process shares connections, DNS
+ * resolutions, and TLS sessions between every easy handle attached to it,
+ * so a connection to a destination outlives the request that opened it and
+ * the next request skips TCP and TLS setup.  libcurl keys the shared cache
+ * by destination (scheme, host, port, proxy), so an attached handle only
+ * ever reuses a connection to the same place.
+ *
+ * Disabled unless Http.CurlConnectionPool is set.  Handles are attached
+ * when created and re-attached after curl_easy_reset; per-transfer reuse is
+ * reported through ServerStats as curl.pool.reuse / curl.pool.new_conn.
+ */
+struct CurlConnectionPool {
+  /* Attach `cp' to the process share; no-op when pooling is disabled. */
+  static void Attach(CURL* cp);
+
+  /* Log whether the transfer that just finished on `cp' reused a pooled
+   * connection; call after curl_easy_perform. */
+  static void LogReuse(CURL* cp);
+
+  static bool Enabled();
+};
+
+/////////////////////////////////////////////////////////////////////////////
+}
@@ -1,4 +1,5 @@
 #include "hphp/runtime/ext/curl/curl-resource.h"
+#include "hphp/runtime/ext/curl/curl-connection-pool.h"
 #include "hphp/runtime/ext/curl/curl-multi-resource.h"
 #include "hphp/runtime/ext/curl/curl-share-resource.h"
 #include "hphp/runtime/ext/curl/ext_curl.h"
@@ -149,6 +150,8 @@ void CurlResource::setDefaultOptions() {
                    minTimeout(RuntimeOption::HttpDefaultTimeout));
   curl_easy_setopt(m_cp, CURLOPT_CONNECTTIMEOUT,
                    minTimeout(RuntimeOption::HttpDefaultTimeout));
+  /* A user share set later via curl_share_setopt simply overrides this. */
+  CurlConnectionPool::Attach(m_cp);
   reseat();
 }
 
@@ -186,6 +189,7 @@ Variant CurlResource::execute() {
     check_exception();
   }
   set_curl_statuses(m_cp, m_url.data());
+  CurlConnectionPool::LogReuse(m_cp);
 
   /* CURLE_PARTIAL_FILE is returned by HEAD requests */
   if (m_error_no != CURLE_OK && m_error_no != CURLE_PARTIAL_FILE) {
@@ -2698,13 +2698,7 @@ static Variant domattr_specified_read(const Object& /*obj*/) {
 
 static Variant domattr_value_read(const Object& obj) {
   CHECK_ATTR(attrp);
-  xmlChar *content = xmlNodeGetContent((xmlNodePtr) attrp);
-  if (content) {
-    String ret((const char*)content, CopyString);
-    xmlFree(content);
-    return ret;
-  }
-  return empty_string_variant();
+  return libxml_node_list_text(attrp->doc, attrp->children, true);
 }
 
 static void domattr_value_write(const Object& obj, const Variant& value) {
@@ -4164,8 +4158,7 @@ String HHVM_METHOD(DOMElement, getAttribute,
   if (attr) {
     switch (attr->type) {
     case XML_ATTRIBUTE_NODE:
-      value = xmlNodeListGetString(attr->doc, attr->children, 1);
-      break;
+      return libxml_node_list_text(attr->doc, attr->children, true);
     case XML_NAMESPACE_DECL:
       value = xmlStrdup(((xmlNsPtr)attr)->href);
       break;
@@ -1053,6 +1053,16 @@ void SymbolMap::update(
     wlock->removePath(db, txn, Path{path});
   }
 
+  if (!alteredPaths.empty() || !deletedPaths.empty()) {
+    // Invalidate the lock-free symbol-path caches. Bump the generation
+    // first so queries resolved against pre-update data can't sneak
+    // stale results back in after the clear.
+    m_pathCacheGen.fetch_add(1, std::memory_order_acq_rel);
+    m_typePathCache.clear();
+    m_functionPathCache.clear();
+    m_constantPathCache.clear();
+  }
+
   wlock->m_clock = clock;
 
   if (m_dbMode == SQLite::OpenMode::ReadWrite) {
@@ -1391,6 +1401,25 @@ Ret SymbolMap::readOrUpdate(
 }
 
 template <SymKind k> Path SymbolMap::getSymbolPath(Symbol<k> symbol) {
+  auto& pathCache = [this]() -> auto& {
+    if constexpr (k == SymKind::Type) {
+      return m_typePathCache;
+    } else if constexpr (k == SymKind::Function) {
+      return m_functionPathCache;
+    } else {
+      return m_constantPathCache;
+    }
+  }
+  ();
+
+  // Steady-state autoload path: no locks taken on a cache hit.
+  // Negative results (Path{nullptr}) are cached too; update()
+  // invalidates them along with everything else.
+  if (auto const it = pathCache.find(symbol); it != pathCache.cend()) {
+    return it->second;
+  }
+  auto const cacheGen = m_pathCacheGen.load(std::memory_order_acquire);
+
   auto symbolPath = [this](auto const& paths) -> Path {
     if (UNLIKELY(paths.empty()) ||
         UNLIKELY(m_enforceOneDefinition && paths.size() > 1)) {
@@ -1400,7 +1429,7 @@ template <SymKind k> Path SymbolMap::getSymbolPath(Symbol<k> symbol) {
     }
   };
 
-  return readOrUpdate<Path>(
+  auto const path = readOrUpdate<Path>(
       [&](const Data& data) -> Optional<Path> {
         auto paths = getPathSymMap<k>(data).getSymbolPaths(symbol);
         if (paths) {
@@ -1434,6 +1463,13 @@ template <SymKind k> Path SymbolMap::getSymbolPath(Symbol<k> symbol) {
         return symbolPath(getPathSymMap<k>(data).getSymbolPaths(
             symbol, std::move(pathsFromDB)));
       });
+
+  // Only repopulate the cache if no update invalidated it while we
+  // were resolving; otherwise this result may already be stale.
+  if (m_pathCacheGen.load(std::memory_order_acquire) == cacheGen) {
+    pathCache.insert(symbol, path);
+  }
+  return path;
 }
 
 template <SymKind k>
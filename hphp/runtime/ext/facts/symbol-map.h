@@ -26,6 +26,7 @@
 #include <folly/Executor.h>
 #include <folly/SharedMutex.h>
 #include <folly/Synchronized.h>
+#include <folly/concurrency/ConcurrentHashMap.h>
 #include <folly/experimental/io/FsUtil.h>
 #include <folly/futures/Future.h>
 #include <folly/futures/FutureSplitter.h>
@@ -606,6 +607,19 @@ private:
 
   folly::Synchronized<Data, folly::SharedMutexWritePriority> m_syncedData;
 
+  // Lock-free memoization of symbol-to-path lookups for the
+  // steady-state autoload path. Queries that hit one of these caches
+  // don't touch m_syncedData or the DB at all. update() bumps the
+  // generation and clears the caches wholesale, so an in-flight query
+  // that resolved against pre-update data can't repopulate them with a
+  // stale path.
+  std::atomic<uint64_t> m_pathCacheGen{0};
+  folly::ConcurrentHashMap<Symbol<SymKind::Type>, Path> m_typePathCache;
+  folly::ConcurrentHashMap<Symbol<SymKind::Function>, Path>
+      m_functionPathCache;
+  folly::ConcurrentHashMap<Symbol<SymKind::Constant>, Path>
+      m_constantPathCache;
+
   const folly::fs::path m_root;
   const std::string m_schemaHash;
   const DBData m_dbData;
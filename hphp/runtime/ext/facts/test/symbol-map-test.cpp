@@ -404,6 +404,50 @@ TEST_P(SymbolMapTest, addPaths) {
       ElementsAre("SomeClass"));
 }
 
+TEST_P(SymbolMapTest, cachedPathsInvalidatedByUpdate) {
+  auto& m = make("/var/www");
+
+  FileFacts ff{
+      .m_types = {{.m_name = "SomeClass", .m_kind = TypeKind::Class}},
+      .m_functions = {"some_fn"},
+      .m_constants = {"SOME_CONSTANT"},
+      .m_sha1hex = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"};
+
+  folly::fs::path path1 = {"some/path1.php"};
+  update(m, "", "1:2:3", {path1}, {}, {ff});
+
+  // Ask for symbols which don't exist yet; the negative answers get
+  // memoized on the lock-free fast path.
+  EXPECT_EQ(m.getTypeFile("LaterClass"), nullptr);
+  EXPECT_EQ(m.getTypeFile("LaterClass"), nullptr);
+  EXPECT_EQ(m.getFunctionFile("later_fn"), nullptr);
+  EXPECT_EQ(m.getConstantFile("LATER_CONSTANT"), nullptr);
+
+  // Defining them must kick the memoized negatives out.
+  FileFacts ff2{
+      .m_types = {{.m_name = "LaterClass", .m_kind = TypeKind::Class}},
+      .m_functions = {"later_fn"},
+      .m_constants = {"LATER_CONSTANT"},
+      .m_sha1hex = "bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb"};
+
+  folly::fs::path path2 = {"some/path2.php"};
+  update(m, "1:2:3", "1:2:4", {path2}, {}, {ff2});
+
+  EXPECT_EQ(m.getTypeFile("LaterClass"), path2.native());
+  EXPECT_EQ(m.getFunctionFile("later_fn"), path2.native());
+  EXPECT_EQ(m.getConstantFile("LATER_CONSTANT"), path2.native());
+
+  // And repeated (now cached) positive answers survive re-queries ...
+  EXPECT_EQ(m.getTypeFile("SomeClass"), path1.native());
+  EXPECT_EQ(m.getTypeFile("SomeClass"), path1.native());
+
+  // ... until the defining path is deleted.
+  update(m, "1:2:4", "1:2:5", {}, {path1}, {});
+  EXPECT_EQ(m.getTypeFile("SomeClass"), nullptr);
+  EXPECT_EQ(m.getFunctionFile("some_fn"), nullptr);
+  EXPECT_EQ(m.getConstantFile("SOME_CONSTANT"), nullptr);
+}
+
 TEST_P(SymbolMapTest, duplicateSymbols) {
   auto& m = make("/var/www");
 
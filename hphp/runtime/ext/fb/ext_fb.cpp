@@ -28,6 +28,7 @@
 #include <folly/String.h>
 #include <folly/portability/Sockets.h>
 
+#include "hphp/util/hash-map.h"
 #include "hphp/util/htonll.h"
 #include "hphp/util/logger.h"
 #include "hphp/runtime/base/array-init.h"
@@ -359,40 +360,53 @@ static void fb_compact_serialize_code(StringBuffer& sb,
   sb.append(reinterpret_cast<char*>(&v), 1);
 }
 
-static void fb_compact_serialize_int64(StringBuffer& sb, int64_t val) {
+// Encode `val' into `buf' (at least 9 bytes, code byte included) and return
+// the encoded length.  Building the whole varint locally lets callers hand it
+// to the StringBuffer in a single append instead of one append per fragment.
+static size_t fb_compact_encode_int64(uint8_t* buf, int64_t val) {
   if (val >= 0 && (uint64_t)val <= kInt7Mask) {
-    uint8_t nval = val;
-    sb.append(reinterpret_cast<char*>(&nval), 1);
-
-  } else if (val >= 0 && (uint64_t)val <= kInt13Mask) {
+    buf[0] = val;
+    return 1;
+  }
+  if (val >= 0 && (uint64_t)val <= kInt13Mask) {
     uint16_t nval = htons(kInt13Prefix | val);
-    sb.append(reinterpret_cast<char*>(&nval), 2);
-
-  } else if (val == (int64_t)(int16_t)val) {
-    fb_compact_serialize_code(sb, FB_CS_INT16);
+    memcpy(buf, &nval, 2);
+    return 2;
+  }
+  if (val == (int64_t)(int16_t)val) {
+    buf[0] = kCodePrefix | FB_CS_INT16;
     uint16_t nval = htons(val);
-    sb.append(reinterpret_cast<char*>(&nval), 2);
-
-  } else if (val >= 0 && (uint64_t)val <= kInt20Mask) {
+    memcpy(buf + 1, &nval, 2);
+    return 3;
+  }
+  if (val >= 0 && (uint64_t)val <= kInt20Mask) {
     uint32_t nval = htonl(kInt20Prefix | val);
     // Skip most significant byte
-    sb.append(reinterpret_cast<char*>(&nval) + 1, 3);
-
-  } else if (val == (int64_t)(int32_t)val) {
-    fb_compact_serialize_code(sb, FB_CS_INT32);
+    memcpy(buf, reinterpret_cast<char*>(&nval) + 1, 3);
+    return 3;
+  }
+  if (val == (int64_t)(int32_t)val) {
+    buf[0] = kCodePrefix | FB_CS_INT32;
     uint32_t nval = htonl(val);
-    sb.append(reinterpret_cast<char*>(&nval), 4);
-
-  } else if (val >= 0 && (uint64_t)val <= kInt54Mask) {
+    memcpy(buf + 1, &nval, 4);
+    return 5;
+  }
+  if (val >= 0 && (uint64_t)val <= kInt54Mask) {
     uint64_t nval = htonll(kInt54Prefix | val);
     // Skip most significant byte
-    sb.append(reinterpret_cast<char*>(&nval) + 1, 7);
-
-  } else {
-    fb_compact_serialize_code(sb, FB_CS_INT64);
-    uint64_t nval = htonll(val);
-    sb.append(reinterpret_cast<char*>(&nval), 8);
+    memcpy(buf, reinterpret_cast<char*>(&nval) + 1, 7);
+    return 7;
   }
+  buf[0] = kCodePrefix | FB_CS_INT64;
+  uint64_t nval = htonll(val);
+  memcpy(buf + 1, &nval, 8);
+  return 9;
+}
+
+static void fb_compact_serialize_int64(StringBuffer& sb, int64_t val) {
+  uint8_t buf[9];
+  auto const len = fb_compact_encode_int64(buf, val);
+  sb.append(reinterpret_cast<char*>(buf), len);
 }
 
 static void fb_compact_serialize_string(StringBuffer& sb, const String& str) {
@@ -400,12 +414,17 @@ static void fb_compact_serialize_string(StringBuffer& sb, const String& str) {
   if (len == 0) {
     fb_compact_serialize_code(sb, FB_CS_STRING_0);
   } else {
+    // Write the code byte and the length varint as one header append, then
+    // the payload as a second; the payload copy is already a bulk memcpy.
+    uint8_t header[10];
+    size_t hlen = 1;
     if (len == 1) {
-      fb_compact_serialize_code(sb, FB_CS_STRING_1);
+      header[0] = kCodePrefix | FB_CS_STRING_1;
     } else {
-      fb_compact_serialize_code(sb, FB_CS_STRING_N);
-      fb_compact_serialize_int64(sb, len);
+      header[0] = kCodePrefix | FB_CS_STRING_N;
+      hlen += fb_compact_encode_int64(header + 1, len);
     }
+    sb.append(reinterpret_cast<char*>(header), hlen);
     sb.append(str.data(), len);
   }
 }
@@ -532,9 +551,11 @@ static int fb_compact_serialize_variant(
       return 0;
 
     case KindOfDouble: {
-      fb_compact_serialize_code(sb, FB_CS_DOUBLE);
+      uint8_t buf[9];
+      buf[0] = kCodePrefix | FB_CS_DOUBLE;
       double d = var.toDouble();
-      sb.append(reinterpret_cast<char*>(&d), 8);
+      memcpy(buf + 1, &d, 8);
+      sb.append(reinterpret_cast<char*>(buf), 9);
       return 0;
     }
 
@@ -720,8 +741,134 @@ int fb_compact_unserialize_int64_from_buffer(
 
 const StaticString s_empty("");
 
+namespace {
+
+/*
+ * Element counts for the containers in a compact-serialized buffer, keyed by
+ * the byte offset of each container's code byte.  Built in one linear scan
+ * over the input so the decoder can allocate exactly-sized dicts and vecs up
+ * front instead of growing (and rehashing) them element by element.
+ */
+using CompactSizeIndex = hphp_fast_map<int, uint32_t>;
+
+// Buffers smaller than this decode quickly enough off the unsized path that
+// the extra scan isn't worth it.
+constexpr int kCompactSizeIndexMinLen = 256;
+
+/*
+ * Walk the buffer once with an explicit stack, counting the direct entries of
+ * every container.  On malformed input the walk just stops: containers that
+ * were already closed keep their (still exact) counts, and anything left open
+ * is absent from the index, so the decoder falls back to the growing path for
+ * it and reports the error itself.
+ */
+void fb_compact_build_size_index(const char* buf, int n, int start,
+                                 CompactSizeIndex& index) {
+  struct OpenContainer {
+    int offset;
+    uint32_t count;
+  };
+  std::vector<OpenContainer> stack;
+  int p = start;
+  while (p < n) {
+    int code = (unsigned char)buf[p];
+    if ((code & ~kCodeMask) != kCodePrefix ||
+        (code & kCodeMask) == FB_CS_INT16 ||
+        (code & kCodeMask) == FB_CS_INT32 ||
+        (code & kCodeMask) == FB_CS_INT64) {
+      int64_t val;
+      if (fb_compact_unserialize_int64_from_buffer(val, buf, n, p)) return;
+      if (!stack.empty()) ++stack.back().count;
+      continue;
+    }
+    switch (code & kCodeMask) {
+      case FB_CS_NULL:
+      case FB_CS_TRUE:
+      case FB_CS_FALSE:
+      case FB_CS_STRING_0:
+      case FB_CS_SKIP:
+        p += 1;
+        if (!stack.empty()) ++stack.back().count;
+        break;
+
+      case FB_CS_DOUBLE:
+        if (n - p < 9) return;
+        p += 9;
+        if (!stack.empty()) ++stack.back().count;
+        break;
+
+      case FB_CS_STRING_1:
+      case FB_CS_STRING_N:
+      {
+        int64_t len = 1;
+        p += 1;
+        if ((code & kCodeMask) == FB_CS_STRING_N &&
+            fb_compact_unserialize_int64_from_buffer(len, buf, n, p)) {
+          return;
+        }
+        if (len < 0 || len > n - p) return;
+        p += len;
+        if (!stack.empty()) ++stack.back().count;
+        break;
+      }
+
+      case FB_CS_LIST_MAP:
+      case FB_CS_MAP:
+      case FB_CS_VECTOR:
+        if (!stack.empty()) ++stack.back().count;
+        stack.push_back(OpenContainer{p, 0});
+        p += 1;
+        break;
+
+      case FB_CS_STOP:
+      {
+        if (stack.empty()) return;
+        auto const& top = stack.back();
+        index[top.offset] = top.count;
+        stack.pop_back();
+        p += 1;
+        break;
+      }
+
+      default:
+        return;
+    }
+  }
+}
+
+// DictInit flavor of mapSetConvertStatic (VariantController.h): intish-cast
+// the key and prefer an existing static string for it.
+void dictInitSetConvertStatic(DictInit& init, StringData* str, Variant&& v) {
+  int64_t i;
+  if (str->isStrictlyInteger(i)) {
+    init.set(i, *v.asTypedValue());
+  } else if (auto sstr = str->isStatic() ? str : lookupStaticString(str)) {
+    init.set(String::attach(sstr), *v.asTypedValue());
+  } else {
+    init.set(String(str), *v.asTypedValue());
+  }
+}
+
+int fb_compact_unserialize_from_buffer_impl(
+    Variant& out, const char* buf, int n, int& p, size_t depth,
+    const CompactSizeIndex& index);
+
+} // namespace
+
 int fb_compact_unserialize_from_buffer(
     Variant& out, const char* buf, int n, int& p, size_t depth) {
+  CompactSizeIndex index;
+  if (n - p >= kCompactSizeIndexMinLen) {
+    fb_compact_build_size_index(buf, n, p, index);
+  }
+  return fb_compact_unserialize_from_buffer_impl(out, buf, n, p, depth, index);
+}
+
+namespace {
+
+int fb_compact_unserialize_from_buffer_impl(
+    Variant& out, const char* buf, int n, int& p, size_t depth,
+    const CompactSizeIndex& index) {
   if (UNLIKELY(depth > 1024)) {
     return FB_UNSERIALIZE_MAX_DEPTH_EXCEEDED;
   }
@@ -790,11 +937,34 @@ int fb_compact_unserialize_from_buffer(
 
     case FB_CS_VECTOR:
     {
+      auto const sized = index.find(p - 1);
+      if (sized != index.end()) {
+        // The size index counted this vec's entries, so fill a
+        // reserved-capacity allocation instead of growing one.
+        VecInit init(sized->second);
+        while (p < n && buf[p] != (char)(kCodePrefix | FB_CS_STOP)) {
+          Variant value;
+          int err = fb_compact_unserialize_from_buffer_impl(
+            value, buf, n, p, depth + 1, index);
+          if (err) {
+            return err;
+          }
+          init.append(value);
+        }
+
+        // Consume STOP
+        CHECK_ENOUGH(1, p, n);
+        p += 1;
+
+        out = init.toVariant();
+        break;
+      }
+
       Array arr = Array::CreateVec();
       while (p < n && buf[p] != (char)(kCodePrefix | FB_CS_STOP)) {
         Variant value;
-        int err =
-          fb_compact_unserialize_from_buffer(value, buf, n, p, depth + 1);
+        int err = fb_compact_unserialize_from_buffer_impl(
+          value, buf, n, p, depth + 1, index);
         if (err) {
           return err;
         }
@@ -811,6 +981,35 @@ int fb_compact_unserialize_from_buffer(
 
     case FB_CS_LIST_MAP:
     {
+      auto const sized = index.find(p - 1);
+      if (sized != index.end()) {
+        // The index counts SKIPs too, so this may slightly over-reserve;
+        // that's fine, DictInit only requires the capacity to be enough.
+        DictInit init(sized->second);
+        int64_t i = 0;
+        while (p < n && buf[p] != (char)(kCodePrefix | FB_CS_STOP)) {
+          if (buf[p] == (char)(kCodePrefix | FB_CS_SKIP)) {
+            ++i;
+            ++p;
+          } else {
+            Variant value;
+            int err = fb_compact_unserialize_from_buffer_impl(
+              value, buf, n, p, depth + 1, index);
+            if (err) {
+              return err;
+            }
+            init.set(i++, value);
+          }
+        }
+
+        // Consume STOP
+        CHECK_ENOUGH(1, p, n);
+        p += 1;
+
+        out = init.toVariant();
+        break;
+      }
+
       Array arr = Array::CreateDict();
       int64_t i = 0;
       while (p < n && buf[p] != (char)(kCodePrefix | FB_CS_STOP)) {
@@ -819,8 +1018,8 @@ int fb_compact_unserialize_from_buffer(
           ++p;
         } else {
           Variant value;
-          int err =
-            fb_compact_unserialize_from_buffer(value, buf, n, p, depth + 1);
+          int err = fb_compact_unserialize_from_buffer_impl(
+            value, buf, n, p, depth + 1, index);
           if (err) {
             return err;
           }
@@ -838,15 +1037,54 @@ int fb_compact_unserialize_from_buffer(
 
     case FB_CS_MAP:
     {
+      auto const sized = index.find(p - 1);
+      if (sized != index.end()) {
+        // The index counted keys and values individually; reserve one slot
+        // per pair (rounding up so a trailing key can't under-reserve).
+        DictInit init((sized->second + 1) / 2);
+        while (p < n && buf[p] != (char)(kCodePrefix | FB_CS_STOP)) {
+          Variant key;
+          int err = fb_compact_unserialize_from_buffer_impl(
+            key, buf, n, p, depth + 1, index);
+          if (err) {
+            return err;
+          }
+          Variant value;
+          err = fb_compact_unserialize_from_buffer_impl(
+            value, buf, n, p, depth + 1, index);
+          if (err) {
+            return err;
+          }
+          if (key.getType() == KindOfInt64) {
+            init.set(key.toInt64(), value);
+          } else if (key.getType() == KindOfString ||
+                     key.getType() == KindOfPersistentString) {
+            dictInitSetConvertStatic(
+              init, key.asStrRef().get(), std::move(value));
+          } else {
+            return FB_UNSERIALIZE_UNEXPECTED_ARRAY_KEY_TYPE;
+          }
+        }
+
+        // Consume STOP
+        CHECK_ENOUGH(1, p, n);
+        p += 1;
+
+        out = init.toVariant();
+        break;
+      }
+
       Array arr = Array::CreateDict();
       while (p < n && buf[p] != (char)(kCodePrefix | FB_CS_STOP)) {
         Variant key;
-        int err = fb_compact_unserialize_from_buffer(key, buf, n, p, depth + 1);
+        int err = fb_compact_unserialize_from_buffer_impl(
+          key, buf, n, p, depth + 1, index);
         if (err) {
           return err;
         }
         Variant value;
-        err = fb_compact_unserialize_from_buffer(value, buf, n, p, depth + 1);
+        err = fb_compact_unserialize_from_buffer_impl(
+          value, buf, n, p, depth + 1, index);
         if (err) {
           return err;
         }
@@ -876,6 +1114,8 @@ int fb_compact_unserialize_from_buffer(
   return 0;
 }
 
+} // namespace
+
 Variant fb_compact_unserialize(const char* str, int len,
                                bool& success,
                                Variant& errcode) {
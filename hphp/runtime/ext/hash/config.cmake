@@ -14,6 +14,7 @@ HHVM_DEFINE_EXTENSION("hash"
     hash_ripemd.cpp
     hash_salsa.cpp
     hash_sha.cpp
+    hash_sha_ni.cpp
     hash_snefru.cpp
     hash_tiger.cpp
     hash_whirlpool.cpp
@@ -33,6 +34,7 @@ HHVM_DEFINE_EXTENSION("hash"
     hash_ripemd.h
     hash_salsa.h
     hash_sha.h
+    hash_sha_ni.h
     hash_snefru.h
     hash_tiger.h
     hash_whirlpool.h
@@ -16,6 +16,7 @@
 */
 
 #include "hphp/runtime/ext/hash/hash_sha.h"
+#include "hphp/runtime/ext/hash/hash_sha_ni.h"
 
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
@@ -269,6 +270,21 @@ static void SHA1Transform(unsigned int state[5],
   memset((unsigned char*) x, 0, sizeof(x));
 }
 
+/*
+  Transforms `nblocks` consecutive 64-byte blocks, using the SHA-NI
+  implementation when the CPU has it.
+*/
+static void SHA1TransformBlocks(unsigned int state[5],
+                                const unsigned char *input, size_t nblocks) {
+  if (sha_ni_supported()) {
+    SHA1TransformBlocksNI(state, input, nblocks);
+    return;
+  }
+  for (size_t b = 0; b < nblocks; b++) {
+    SHA1Transform(state, &input[b * 64]);
+  }
+}
+
 /*
    SHA1 block update operation. Continues an SHA1 message-digest
    operation, processing another message block, and updating the
@@ -298,8 +314,11 @@ void hash_sha1::hash_update(void *context_, const unsigned char *input,
            partLen);
     SHA1Transform(context->state, context->buffer);
 
-    for (i = partLen; i + 63 < inputLen; i += 64)
-      SHA1Transform(context->state, &input[i]);
+    auto const blocks = (size_t)(inputLen - partLen) >> 6;
+    if (blocks) {
+      SHA1TransformBlocks(context->state, &input[partLen], blocks);
+    }
+    i = partLen + blocks * 64;
 
     index = 0;
   } else
@@ -433,6 +452,21 @@ static void SHA256Transform(unsigned int state[8],
   memset((unsigned char*) x, 0, sizeof(x));
 }
 
+/*
+  Transforms `nblocks` consecutive 64-byte blocks, using the SHA-NI
+  implementation when the CPU has it.
+*/
+static void SHA256TransformBlocks(unsigned int state[8],
+                                  const unsigned char *input, size_t nblocks) {
+  if (sha_ni_supported()) {
+    SHA256TransformBlocksNI(state, input, nblocks);
+    return;
+  }
+  for (size_t b = 0; b < nblocks; b++) {
+    SHA256Transform(state, &input[b * 64]);
+  }
+}
+
 /*
   SHA256 block update operation. Continues an SHA256 message-digest
   operation, processing another message block, and updating the
@@ -462,9 +496,11 @@ void hash_sha256::hash_update(void *context_, const unsigned char *input,
            (unsigned char*) input, partLen);
     SHA256Transform(context->state, context->buffer);
 
-    for (i = partLen; i + 63 < inputLen; i += 64) {
-      SHA256Transform(context->state, &input[i]);
+    auto const blocks = (size_t)(inputLen - partLen) >> 6;
+    if (blocks) {
+      SHA256TransformBlocks(context->state, &input[partLen], blocks);
     }
+    i = partLen + blocks * 64;
 
     index = 0;
   } else {
@@ -0,0 +1,204 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010-present Facebook, Inc. (http://www.facebook.com)  |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include "hphp/runtime/ext/hash/hash_sha_ni.h"
+
+#include "hphp/util/assertions.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define HPHP_HASH_USE_SHA_NI 1
+#include <immintrin.h>
+#include <folly/CpuId.h>
+#endif
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef HPHP_HASH_USE_SHA_NI
+
+bool sha_ni_supported() {
+  // The sha1/sha256 round instructions also use pshufb/pblendw, so require
+  // SSE4.1 alongside the SHA extensions.
+  static const bool supported = [] {
+    folly::CpuId cpu;
+    return cpu.sha() && cpu.sse41();
+  }();
+  return supported;
+}
+
+/*
+ * SHA-1 compression using the sha1rnds4/sha1nexte/sha1msg1/sha1msg2
+ * instructions.  The working state lives as ABCD in one register (word
+ * reversed, hence the full byte-reversing load mask) with E kept in the
+ * top lane of a second register.  The 80 rounds run as 20 groups of four;
+ * message blocks W[4i..4i+3] are kept in a 4-register ring and extended in
+ * place one group before they are needed.
+ */
+__attribute__((target("sha,sse4.1")))
+void SHA1TransformBlocksNI(unsigned int state[5],
+                           const unsigned char* data, size_t nblocks) {
+  const __m128i MASK =
+    _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+  __m128i abcd = _mm_loadu_si128((const __m128i*)state);
+  abcd = _mm_shuffle_epi32(abcd, 0x1B);
+  __m128i e = _mm_set_epi32(state[4], 0, 0, 0);
+
+  while (nblocks-- > 0) {
+    const __m128i abcd_save = abcd;
+    const __m128i e_save = e;
+
+    __m128i msg[4];
+    for (int i = 0; i < 4; i++) {
+      msg[i] = _mm_shuffle_epi8(
+        _mm_loadu_si128((const __m128i*)(data + i * 16)), MASK);
+    }
+
+    __m128i e_prev = abcd;
+    for (int i = 0; i < 20; i++) {
+      if (i >= 4) {
+        /* W[4i..] = sha1msg2(sha1msg1(W[4i-16..], W[4i-12..]) ^ W[4i-8..],
+                              W[4i-4..]) */
+        msg[i & 3] = _mm_sha1msg2_epu32(
+          _mm_xor_si128(_mm_sha1msg1_epu32(msg[i & 3], msg[(i + 1) & 3]),
+                        msg[(i + 2) & 3]),
+          msg[(i + 3) & 3]);
+      }
+      __m128i er = (i == 0)
+        ? _mm_add_epi32(e, msg[0])
+        : _mm_sha1nexte_epu32(e_prev, msg[i & 3]);
+      e_prev = abcd;
+      /* The round-function selector must be an immediate. */
+      switch (i / 5) {
+        case 0:  abcd = _mm_sha1rnds4_epu32(abcd, er, 0); break;
+        case 1:  abcd = _mm_sha1rnds4_epu32(abcd, er, 1); break;
+        case 2:  abcd = _mm_sha1rnds4_epu32(abcd, er, 2); break;
+        default: abcd = _mm_sha1rnds4_epu32(abcd, er, 3); break;
+      }
+    }
+
+    e = _mm_sha1nexte_epu32(e_prev, e_save);
+    abcd = _mm_add_epi32(abcd, abcd_save);
+    data += 64;
+  }
+
+  abcd = _mm_shuffle_epi32(abcd, 0x1B);
+  _mm_storeu_si128((__m128i*)state, abcd);
+  state[4] = _mm_extract_epi32(e, 3);
+}
+
+static const unsigned int SHA256_NI_K[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+  0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+  0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+  0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+  0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+  0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/*
+ * SHA-256 compression using sha256rnds2/sha256msg1/sha256msg2.  The eight
+ * state words are rearranged into the ABEF/CDGH form the round
+ * instruction expects; each sha256rnds2 performs two rounds, so the 64
+ * rounds run as 16 groups of four with the message schedule extended in a
+ * 4-register ring.
+ */
+__attribute__((target("sha,sse4.1")))
+void SHA256TransformBlocksNI(unsigned int state[8],
+                             const unsigned char* data, size_t nblocks) {
+  const __m128i MASK =
+    _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+  __m128i tmp = _mm_loadu_si128((const __m128i*)&state[0]);
+  __m128i state1 = _mm_loadu_si128((const __m128i*)&state[4]);
+  tmp = _mm_shuffle_epi32(tmp, 0xB1);         /* CDAB */
+  state1 = _mm_shuffle_epi32(state1, 0x1B);   /* EFGH */
+  __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);   /* ABEF */
+  state1 = _mm_blend_epi16(state1, tmp, 0xF0);        /* CDGH */
+
+  while (nblocks-- > 0) {
+    const __m128i abef_save = state0;
+    const __m128i cdgh_save = state1;
+
+    __m128i msg[4];
+    for (int i = 0; i < 4; i++) {
+      msg[i] = _mm_shuffle_epi8(
+        _mm_loadu_si128((const __m128i*)(data + i * 16)), MASK);
+    }
+
+    for (int i = 0; i < 16; i++) {
+      __m128i mk = _mm_add_epi32(
+        msg[i & 3],
+        _mm_loadu_si128((const __m128i*)&SHA256_NI_K[i * 4]));
+      state1 = _mm_sha256rnds2_epu32(state1, state0, mk);
+      mk = _mm_shuffle_epi32(mk, 0x0E);
+      state0 = _mm_sha256rnds2_epu32(state0, state1, mk);
+      if (i < 12) {
+        /* W[4i+16..] = sha256msg2(sha256msg1(W[4i..], W[4i+4..]) +
+                                   (W[4i+9..4i+12] via alignr), W[4i+12..]) */
+        msg[i & 3] = _mm_sha256msg2_epu32(
+          _mm_add_epi32(
+            _mm_sha256msg1_epu32(msg[i & 3], msg[(i + 1) & 3]),
+            _mm_alignr_epi8(msg[(i + 3) & 3], msg[(i + 2) & 3], 4)),
+          msg[(i + 3) & 3]);
+      }
+    }
+
+    state0 = _mm_add_epi32(state0, abef_save);
+    state1 = _mm_add_epi32(state1, cdgh_save);
+    data += 64;
+  }
+
+  tmp = _mm_shuffle_epi32(state0, 0x1B);      /* FEBA */
+  state1 = _mm_shuffle_epi32(state1, 0xB1);   /* DCHG */
+  state0 = _mm_blend_epi16(tmp, state1, 0xF0);/* DCBA */
+  state1 = _mm_alignr_epi8(state1, tmp, 8);   /* HGFE */
+  _mm_storeu_si128((__m128i*)&state[0], state0);
+  _mm_storeu_si128((__m128i*)&state[4], state1);
+}
+
+#else // HPHP_HASH_USE_SHA_NI
+
+bool sha_ni_supported() {
+  return false;
+}
+
+void SHA1TransformBlocksNI(unsigned int* /*state*/,
+                           const unsigned char* /*data*/,
+                           size_t /*nblocks*/) {
+  always_assert(false);
+}
+
+void SHA256TransformBlocksNI(unsigned int* /*state*/,
+                             const unsigned char* /*data*/,
+                             size_t /*nblocks*/) {
+  always_assert(false);
+}
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+}
@@ -0,0 +1,40 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010-present Facebook, Inc. (http://www.facebook.com)  |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Block transforms for SHA-1 and SHA-256 using the x86 SHA extensions
+ * (SHA-NI).  Both process `nblocks` consecutive 64-byte blocks, so the
+ * per-call dispatch and state load/store cost is amortized over a whole
+ * buffer.  They must only be called when sha_ni_supported() returns true;
+ * it is false on non-x86 builds and on CPUs without the extensions.
+ */
+bool sha_ni_supported();
+
+void SHA1TransformBlocksNI(unsigned int state[5],
+                           const unsigned char* data, size_t nblocks);
+
+void SHA256TransformBlocksNI(unsigned int state[8],
+                             const unsigned char* data, size_t nblocks);
+
+///////////////////////////////////////////////////////////////////////////////
+}
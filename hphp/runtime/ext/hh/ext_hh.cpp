@@ -1102,13 +1102,32 @@ int64_t HHVM_FUNCTION(set_implicit_context, StringArg keyarg,
       "Implicit context keys cannot be empty or start with _");
   }
   auto const prev = *ImplicitContext::activeCtx;
+  auto const prev_index = prev ? prev->m_index : ImplicitContext::kEmptyIndex;
+  auto const memokey = HHVM_FN(serialize_memoize_param)(data);
+
+  // Contexts are immutable versions: setting the same key/value pair on the
+  // same base context always yields the same context, so memoize the
+  // transition and reinstall the version we already built instead of copying
+  // the map and re-serializing the memo key. Installing a context is then a
+  // word store into the RDS slot, same as the suspend/resume path.
+  StringBuffer tb;
+  tb.append(prev_index);
+  tb.append(';');
+  serialize_memoize_string_data(tb, key);
+  serialize_memoize_tv(tb, 0, memokey);
+  auto const transition = tb.detach().detach();
+  auto const cached = g_context->m_implicitContextTransitions.find(transition);
+  if (cached != g_context->m_implicitContextTransitions.end()) {
+    *ImplicitContext::activeCtx = cached->second;
+    return prev_index;
+  }
+
   auto const context = req::make_raw<ImplicitContext>();
   assertx(context);
   if (prev) context->m_map = prev->m_map;
   // Leak `data`, `key` and `memokey` to the end of the request
   if (isRefcountedType(data.m_type)) tvIncRefCountable(data);
   key->incRefCount();
-  auto const memokey = HHVM_FN(serialize_memoize_param)(data);
   auto entry = std::make_pair(data, memokey);
   auto const it = context->m_map.insert({key, entry});
   // If the insertion failed, overwrite
@@ -1131,7 +1150,8 @@ int64_t HHVM_FUNCTION(set_implicit_context, StringArg keyarg,
   context->m_index = g_context->m_implicitContexts.size();
   *ImplicitContext::activeCtx = context;
   g_context->m_implicitContexts.push_back(context);
-  return prev ? prev->m_index : ImplicitContext::kEmptyIndex;
+  g_context->m_implicitContextTransitions.emplace(transition, context);
+  return prev_index;
 }
 
 int64_t HHVM_FUNCTION(set_implicit_context_by_index, int64_t index) {
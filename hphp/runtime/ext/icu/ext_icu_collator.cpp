@@ -27,7 +27,7 @@ static void HHVM_METHOD(Collator, __construct, const String& locale) {
   data->clearError();
   if (!locale.empty()) {
     UErrorCode error = U_ZERO_ERROR;
-    data->setCollator(ucol_open(locale.c_str(), &error));
+    data->setCollator(cloneCachedCollator(locale.c_str(), error));
     if (U_SUCCESS(error)) {
       return;
     }
@@ -35,7 +35,7 @@ static void HHVM_METHOD(Collator, __construct, const String& locale) {
   }
   data->setError(U_USING_FALLBACK_WARNING);
   UErrorCode error = U_ZERO_ERROR;
-  data->setCollator(ucol_open(uloc_getDefault(), &error));
+  data->setCollator(cloneCachedCollator(uloc_getDefault(), error));
   if (U_FAILURE(error)) {
     data->setError(error, "collator_create: unable to open ICU collator");
     data->setCollator(nullptr);
@@ -40,12 +40,21 @@ inline bool is_ascii(const String& str) {
 }
 
 inline UBreakIterator* get_break_iterator(const UChar* str, int32_t len) {
+  /* Clone the cached character iterator rather than paying for ubrk_open on
+   * every call. */
   UErrorCode error = U_ZERO_ERROR;
-  UBreakIterator *bi = ubrk_open(UBRK_CHARACTER, nullptr, str, len, &error);
+  UBreakIterator *bi = cloneCachedCharacterBreakIterator(error);
   if (U_FAILURE(error)) {
     s_intl_error->setError(error, "Failed to instantiate break iterator");
     return nullptr;
   }
+  error = U_ZERO_ERROR;
+  ubrk_setText(bi, str, len, &error);
+  if (U_FAILURE(error)) {
+    ubrk_close(bi);
+    s_intl_error->setError(error, "Failed to instantiate break iterator");
+    return nullptr;
+  }
   return bi;
 }
 
@@ -52,10 +52,7 @@ void NumberFormatter::setNumberFormatter(const String& locale,
   const String loc(localeOrDefault(locale));
 
   error = U_ZERO_ERROR;
-  m_formatter = unum_open((UNumberFormatStyle)style,
-                          pat.getBuffer(), pat.length(),
-                          locale.c_str(),
-                          nullptr, &error);
+  m_formatter = cloneCachedNumberFormat(style, pattern, locale.c_str(), error);
   if (U_FAILURE(error)) {
     s_intl_error->setError(error,
         "numfmt_create: number formatter creation failed");
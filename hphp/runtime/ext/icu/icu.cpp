@@ -17,6 +17,9 @@
 #include "hphp/runtime/ext/icu/icu.h"
 #include "hphp/runtime/base/builtin-functions.h"
 #include "hphp/runtime/base/ini-setting.h"
+#include "hphp/runtime/base/string-functors.h"
+#include <tbb/concurrent_hash_map.h>
+#include <folly/Conv.h>
 #include "hphp/util/rds-local.h"
 #include "hphp/runtime/base/request-event-handler.h"
 #include "hphp/util/string-vsnprintf.h"
@@ -93,6 +96,99 @@ bool SetDefaultLocale(const String& locale) {
   return true;
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// Process-level cache of master ICU objects
+
+namespace {
+
+typedef tbb::concurrent_hash_map<const StringData*, void*,
+                                StringDataHashCompare> IcuObjectMap;
+
+IcuObjectMap s_collatorCache;
+IcuObjectMap s_numberFormatCache;
+IcuObjectMap s_breakIteratorCache;
+
+/* Look up the master for `key', building it with `open' on first use.  The
+ * universe of keys is bounded by the locales and formats a site actually
+ * uses, so masters are retained for the life of the process; the loser of a
+ * concurrent first build discards its copy with `close'. */
+template <typename T, typename Open, typename Close>
+T* getCachedMaster(IcuObjectMap& cache, const String& key,
+                   UErrorCode& error, Open open, Close close) {
+  {
+    IcuObjectMap::const_accessor accessor;
+    if (cache.find(accessor, key.get())) {
+      return static_cast<T*>(accessor->second);
+    }
+  }
+
+  T* master = open(error);
+  if (U_FAILURE(error)) {
+    return nullptr;
+  }
+
+  IcuObjectMap::accessor accessor;
+  if (cache.insert(accessor, makeStaticString(key.get()))) {
+    accessor->second = master;
+  } else {
+    close(master);
+    master = static_cast<T*>(accessor->second);
+  }
+  return master;
+}
+
+} // namespace
+
+UCollator* cloneCachedCollator(const char* locale, UErrorCode& error) {
+  error = U_ZERO_ERROR;
+  auto master = getCachedMaster<UCollator>(
+    s_collatorCache, String("col:") + locale, error,
+    [&] (UErrorCode& err) { return ucol_open(locale, &err); },
+    [] (UCollator* coll) { ucol_close(coll); });
+  if (!master) {
+    return nullptr;
+  }
+  return ucol_safeClone(master, nullptr, nullptr, &error);
+}
+
+UNumberFormat* cloneCachedNumberFormat(int64_t style, const String& pattern,
+                                       const char* locale,
+                                       UErrorCode& error) {
+  error = U_ZERO_ERROR;
+  auto const key = folly::to<std::string>("num:", style, ":", locale, ":",
+                                          pattern.toCppString());
+  auto master = getCachedMaster<UNumberFormat>(
+    s_numberFormatCache, String(key), error,
+    [&] (UErrorCode& err) -> UNumberFormat* {
+      icu::UnicodeString pat(u16(pattern, err));
+      if (U_FAILURE(err)) {
+        return nullptr;
+      }
+      return unum_open((UNumberFormatStyle)style,
+                       pat.getBuffer(), pat.length(),
+                       locale, nullptr, &err);
+    },
+    [] (UNumberFormat* fmt) { unum_close(fmt); });
+  if (!master) {
+    return nullptr;
+  }
+  return unum_clone(master, &error);
+}
+
+UBreakIterator* cloneCachedCharacterBreakIterator(UErrorCode& error) {
+  error = U_ZERO_ERROR;
+  auto master = getCachedMaster<UBreakIterator>(
+    s_breakIteratorCache, String("brk:char"), error,
+    [] (UErrorCode& err) {
+      return ubrk_open(UBRK_CHARACTER, nullptr, nullptr, 0, &err);
+    },
+    [] (UBreakIterator* bi) { ubrk_close(bi); });
+  if (!master) {
+    return nullptr;
+  }
+  return ubrk_safeClone(master, nullptr, nullptr, &error);
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // Common extension init
 
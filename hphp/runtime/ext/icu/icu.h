@@ -19,8 +19,11 @@
 #include "hphp/runtime/ext/extension.h"
 #include "hphp/runtime/vm/native-data.h"
 #include <unicode/utypes.h>
+#include <unicode/ubrk.h>
 #include <unicode/ucnv.h>
+#include <unicode/ucol.h>
 #include <unicode/unistr.h>
+#include <unicode/unum.h>
 #include <unicode/ustring.h>
 #include "hphp/runtime/base/execution-context.h"
 #include "hphp/runtime/base/request-event-handler.h"
@@ -112,6 +115,19 @@ inline String u8(const icu::UnicodeString& u16, UErrorCode& error) {
   return u8(u16.getBuffer(), u16.length(), error);
 }
 
+/* Process-level cache of master ICU objects.
+ *
+ * Constructing collators, number formatters, and break iterators walks ICU
+ * resource bundles and is far more expensive than cloning an existing
+ * instance.  Each function below keeps one immutable master per key (locale
+ * and construction options) for the life of the process and hands back a
+ * private clone, which the caller owns and may mutate freely.
+ */
+UCollator* cloneCachedCollator(const char* locale, UErrorCode& error);
+UNumberFormat* cloneCachedNumberFormat(int64_t style, const String& pattern,
+                                       const char* locale, UErrorCode& error);
+UBreakIterator* cloneCachedCharacterBreakIterator(UErrorCode& error);
+
 struct IntlExtension final : Extension {
   IntlExtension() : Extension("intl", "1.1.0") {}
 
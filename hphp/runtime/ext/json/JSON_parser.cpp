@@ -48,6 +48,10 @@ SOFTWARE.
 #include "hphp/util/fast_strtoll_base10.h"
 #include "hphp/zend/zend-strtod.h"
 
+#ifdef __x86_64__
+#include <emmintrin.h>
+#endif
+
 #define MAX_LENGTH_OF_LONG 20
 static const char long_min_digits[] = "9223372036854775808";
 
@@ -369,6 +373,7 @@ struct SimpleParser {
   SimpleParser(const char* input, int length, TypedValue* buffer,
                JSONContainerType container_type, bool is_tsimplejson)
     : p(input)
+    , end(input + length)
     , top(buffer)
     , array_depth(-kMaxArrayDepth) /* Start negative to simplify check. */
     , container_type(container_type)
@@ -499,7 +504,39 @@ struct SimpleParser {
     assertx(p[-1] == '"'); // SimpleParser only handles "-quoted strings
     *len = 0;
     auto const charTop = reinterpret_cast<signed char*>(top);
-    for (signed char ch = *p++; ch != '\"'; ch = *p++) {
+    for (;;) {
+#ifdef __x86_64__
+      // Bulk-copy runs containing no quote, backslash, control or non-ASCII
+      // byte (everything the scalar loop below treats specially). The scan
+      // stays within the input so it can't read past the sentinel's page; it
+      // never writes more than the scalar loop would.
+      while (p + 16 <= end) {
+        auto const chunk =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        auto const special = _mm_or_si128(
+          _mm_or_si128(
+            _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\"')),
+            _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))
+          ),
+          // Signed compare: bytes >= 0x80 are negative, so non-ASCII stops
+          // the scan along with control characters.
+          _mm_cmplt_epi8(chunk, _mm_set1_epi8(' '))
+        );
+        auto const mask = _mm_movemask_epi8(special);
+        if (mask) {
+          auto const run = __builtin_ctz(mask);
+          memcpy(charTop + *len, p, run);
+          *len += run;
+          p += run;
+          break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(charTop + *len), chunk);
+        *len += 16;
+        p += 16;
+      }
+#endif
+      signed char ch = *p++;
+      if (ch == '\"') return true;
       charTop[(*len)++] = ch; // overwritten later if `ch == '\\'`
       if (ch < ' ') {
         // `ch < ' '` catches null and also non-ASCII (since signed char)
@@ -508,7 +545,6 @@ struct SimpleParser {
         if (!handleBackslash(charTop[*len - 1])) return false;
       }
     }
-    return true;
   }
 
   bool parseString() {
@@ -687,6 +723,7 @@ struct SimpleParser {
   }
 
   const char* p;
+  const char* end;
   TypedValue* top;
   int array_depth;
   JSONContainerType container_type;
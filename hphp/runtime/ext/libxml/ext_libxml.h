@@ -229,6 +229,32 @@ inline XMLNode libxml_register_node(xmlDocPtr p) {
   return libxml_register_node((xmlNodePtr)p);
 }
 
+/*
+ * Materialize the text content of a node list as a request-local String.
+ *
+ * Nearly every text value read out of a parsed document — element text,
+ * attribute values — is a single text child, which xmlNodeListGetString
+ * copies into a temporary libxml buffer that we then copy again into a
+ * StringData. Build the StringData straight from the node's content buffer
+ * in that case, and only fall back to xmlNodeListGetString for the rare
+ * shapes it exists for (entity references, unmerged text runs).
+ */
+inline String libxml_node_list_text(xmlDocPtr doc, xmlNodePtr list,
+                                    bool inLine = true) {
+  if (!list) return empty_string();
+  if (inLine && !list->next &&
+      (list->type == XML_TEXT_NODE || list->type == XML_CDATA_SECTION_NODE)) {
+    auto const content = reinterpret_cast<const char*>(list->content);
+    if (!content || !*content) return empty_string();
+    return String(content, CopyString);
+  }
+  xmlChar* tmp = xmlNodeListGetString(doc, list, inLine);
+  if (!tmp) return empty_string();
+  String ret{(char*)tmp, CopyString};
+  xmlFree(tmp);
+  return ret;
+}
+
 
 inline XMLNodeData::XMLNodeData(xmlNodePtr p) : m_cache(nullptr), m_node(p) {
   assertx(p && !p->_private);
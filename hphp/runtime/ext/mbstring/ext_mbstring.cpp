@@ -23,6 +23,7 @@
 #include "hphp/runtime/base/ini-setting.h"
 #include "hphp/runtime/base/request-event-handler.h"
 #include "hphp/runtime/base/string-buffer.h"
+#include "hphp/runtime/base/utf8-decode.h"
 #include "hphp/runtime/base/zend-string.h"
 #include "hphp/runtime/base/zend-url.h"
 #include "hphp/runtime/ext/mbstring/php_unicode.h"
@@ -2303,6 +2304,27 @@ Variant HHVM_FUNCTION(mb_preferred_mime_name,
   return String(preferred_name, CopyString);
 }
 
+const StaticString s_utf_8("utf-8");
+
+/**
+ * Fast check for the most common form of the UTF-8 encoding identifier.
+ */
+ALWAYS_INLINE
+static bool isUtf8(const Variant& encoding) {
+  return encoding.getStringDataOrNull() == s_utf_8.get();
+}
+
+/**
+ * Whether a byte sequence is entirely ASCII, classified a vector at a time
+ * by the scanner shared with the utf8 decoder.  For such strings character
+ * and byte positions coincide, so the mbfl state machines can be bypassed
+ * in favor of byte-oriented kernels.
+ */
+ALWAYS_INLINE
+static bool isPureAscii(folly::StringPiece s) {
+  return skipAscii(s.data(), 0, s.size()) == (int)s.size();
+}
+
 static Variant php_mb_substr(const String& str, int from,
                              const Variant& vlen,
                              const String& encoding, bool substr) {
@@ -2382,6 +2404,24 @@ Variant HHVM_FUNCTION(mb_substr,
                       int start,
                       const Variant& length /*= uninit_null() */,
                       const Variant& opt_encoding) {
+  if (LIKELY(isUtf8(opt_encoding)) && isPureAscii(str.slice())) {
+    /* Character positions coincide with byte positions, so the mbfl_substr
+     * semantics reduce to byte arithmetic. */
+    auto const size = str.size();
+    int len = length.toInt64();
+    if (length.isNull() || len == 0x7FFFFFFF) {
+      len = size;
+    }
+    if (start < 0) {
+      start = size + start;
+      if (start < 0) start = 0;
+    }
+    if (len < 0) {
+      len = (size - start) + len;
+      if (len < 0) len = 0;
+    }
+    return str.substr(start, len);
+  }
   const String encoding = convertArg(opt_encoding);
   return php_mb_substr(str, start, length, encoding, true);
 }
@@ -2559,6 +2599,10 @@ Variant HHVM_FUNCTION(mb_stristr,
 Variant HHVM_FUNCTION(mb_strlen,
                       const String& str,
                       const Variant& opt_encoding) {
+  /* Fast-case for ASCII: every byte is one character. */
+  if (LIKELY(isUtf8(opt_encoding)) && isPureAscii(str.slice())) {
+    return str.size();
+  }
   const String encoding = convertArg(opt_encoding);
 
   mbfl_string string;
@@ -2589,6 +2633,17 @@ Variant HHVM_FUNCTION(mb_strpos,
                       const String& needle,
                       int offset /* = 0 */,
                       const Variant& opt_encoding) {
+  /* Fast-case for ASCII haystack and needle: character positions are byte
+   * positions, so this is a plain byte search.  The error cases (empty
+   * needle, offset out of range) fall through so the warnings below stay in
+   * one place. */
+  if (LIKELY(isUtf8(opt_encoding)) &&
+      !needle.empty() && offset >= 0 && offset <= haystack.size() &&
+      isPureAscii(haystack.slice()) && isPureAscii(needle.slice())) {
+    auto const pos = haystack.find(needle, offset);
+    if (pos >= 0) return pos;
+    return false;
+  }
   const String encoding = convertArg(opt_encoding);
 
   mbfl_string mbs_haystack;
@@ -2890,16 +2945,6 @@ Variant HHVM_FUNCTION(mb_strstr,
   return false;
 }
 
-const StaticString s_utf_8("utf-8");
-
-/**
- * Fast check for the most common form of the UTF-8 encoding identifier.
- */
-ALWAYS_INLINE
-static bool isUtf8(const Variant& encoding) {
-  return encoding.getStringDataOrNull() == s_utf_8.get();
-}
-
 /**
  * Given a byte sequence, return
  *    0 if it contains bytes >= 128 (thus non-ASCII), else
@@ -2908,17 +2953,12 @@ static bool isUtf8(const Variant& encoding) {
  */
 ALWAYS_INLINE
 static int isUtf8AsciiLower(folly::StringPiece s) {
-  const auto bytelen = s.size();
-  bool caseOK = true;
-  for (uint32_t i = 0; i < bytelen; ++i) {
+  if (!isPureAscii(s)) return 0;
+  for (uint32_t i = 0; i < s.size(); ++i) {
     uint8_t byte = s[i];
-    if (byte >= 128) {
-      return 0;
-    } else if (byte <= 'Z' && byte >= 'A') {
-      caseOK = false;
-    }
+    if (byte <= 'Z' && byte >= 'A') return -1;
   }
-  return caseOK ? 1 : -1;
+  return 1;
 }
 
 /**
@@ -2942,17 +2982,12 @@ static StringData* asciiToLower(const StringData* s) {
 /* Like isUtf8AsciiLower, but with upper/lower swapped. */
 ALWAYS_INLINE
 static int isUtf8AsciiUpper(folly::StringPiece s) {
-  const auto bytelen = s.size();
-  bool caseOK = true;
-  for (uint32_t i = 0; i < bytelen; ++i) {
+  if (!isPureAscii(s)) return 0;
+  for (uint32_t i = 0; i < s.size(); ++i) {
     uint8_t byte = s[i];
-    if (byte >= 128) {
-      return 0;
-    } else if (byte >= 'a' && byte <= 'z') {
-      caseOK = false;
-    }
+    if (byte >= 'a' && byte <= 'z') return -1;
   }
-  return caseOK ? 1 : -1;
+  return 1;
 }
 
 /* Like asciiToLower, but with upper/lower swapped. */
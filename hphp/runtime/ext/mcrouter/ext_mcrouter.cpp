@@ -8,6 +8,8 @@
 #include "hphp/runtime/ext/asio/asio-external-thread-event.h"
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include <folly/Memory.h>
 #include <folly/Range.h>
@@ -28,6 +30,7 @@ namespace HPHP {
 /////////////////////////////////////////////////////////////////////////////
 
 struct MCRouterResult;
+struct MCRouterMultiResult;
 
 const StaticString
   s_MCRouter("MCRouter"),
@@ -184,6 +187,10 @@ struct MCRouter {
   template <class Request>
   void send(std::unique_ptr<const Request> request, MCRouterResult* res);
 
+  template <class Request>
+  void sendMulti(std::unique_ptr<const Request> request,
+                 MCRouterMultiResult* res, uint32_t index);
+
   void init(const Array& options, const String& pid) {
     mc::McrouterOptions opts;
     parseOptions(opts, options);
@@ -388,6 +395,152 @@ struct MCRouterResult : AsioExternalThreadEvent {
   std::string m_exception, m_key;
 };
 
+/* A single awaitable covering a whole batch of homogeneous operations.
+ *
+ * Every sub-request is handed to libmcrouter before control returns to the
+ * scheduler, so the client pipelines them onto its shared connections and the
+ * batch costs one network round trip instead of one per key. Replies are
+ * marshaled into per-index slots as they arrive; the last reply publishes the
+ * event back to the request thread through the external thread event queue.
+ */
+struct MCRouterMultiResult : AsioExternalThreadEvent {
+  // Multi-get: one McGetRequest per key
+  MCRouterMultiResult(MCRouter* router, std::vector<std::string>&& keys)
+    : m_keys(std::move(keys)), m_wantValues(true) {
+    m_values.resize(m_keys.size());
+    m_hits.resize(m_keys.size(), 0);
+    m_pending.store(m_keys.size(), std::memory_order_relaxed);
+    if (m_keys.empty()) {
+      markAsFinished();
+      return;
+    }
+    for (uint32_t i = 0; i < m_keys.size(); ++i) {
+      router->sendMulti(
+          std::make_unique<const mc::McGetRequest>(
+              folly::StringPiece(m_keys[i])),
+          this, i);
+    }
+  }
+
+  // Multi-set: one McSetRequest per pair, sharing flags and expiration
+  MCRouterMultiResult(MCRouter* router,
+                      std::vector<std::pair<std::string, std::string>>&& kvs,
+                      int64_t flags, int64_t expiration)
+    : m_wantValues(false) {
+    m_pending.store(kvs.size(), std::memory_order_relaxed);
+    if (kvs.empty()) {
+      markAsFinished();
+      return;
+    }
+    for (uint32_t i = 0; i < kvs.size(); ++i) {
+      auto request = std::make_unique<mc::McSetRequest>(
+          folly::StringPiece(kvs[i].first));
+      request->value_ref() = folly::IOBuf(
+          folly::IOBuf::COPY_BUFFER, folly::StringPiece(kvs[i].second));
+      request->flags_ref() = flags;
+      request->exptime_ref() = expiration;
+      router->sendMulti<mc::McSetRequest>(std::move(request), this, i);
+    }
+  }
+
+  /**
+   * As with MCRouterResult, allocation of request-local data has to wait
+   * until we are back in the request thread.
+   */
+  void unserialize(TypedValue& c) override {
+    if (m_failed.load(std::memory_order_acquire)) {
+      mcr_throwException(m_exception, m_op, m_replyCode, m_key);
+    }
+    if (!m_wantValues) {
+      c = make_tv<KindOfNull>();
+      return;
+    }
+    DictInit ret{m_keys.size()};
+    for (size_t i = 0; i < m_keys.size(); ++i) {
+      if (!m_hits[i]) continue;
+      ret.set(String(m_keys[i].c_str(), m_keys[i].size(), CopyString),
+              String(m_values[i].c_str(), m_values[i].size(), CopyString));
+    }
+    c = make_array_like_tv(ret.toArray().detach());
+  }
+
+  /* Reply to one lookup in a multi-get batch. We're in a worker thread,
+   * so stash the value in a std::string slot until unserialize(). A miss
+   * simply leaves its slot empty rather than failing the batch.
+   */
+  void result(uint32_t index, const mc::McGetRequest& request,
+              mc::McGetReply&& reply) {
+    if (*reply.result_ref() == compatibility::mc_res_unknown) {
+      // McrouterClient has signaled this sub-request is cancelled
+      m_cancelled.store(true, std::memory_order_relaxed);
+    } else if (mc::isErrorResult(*reply.result_ref())) {
+      setBatchException(request, reply);
+    } else if (!mc::isMissResult(*reply.result_ref())) {
+      m_values[index] = carbon::valueRangeSlow(reply).str();
+      m_hits[index] = 1;
+    }
+    finishOne();
+  }
+
+  // Reply to one store in a multi-set batch
+  void result(uint32_t /*index*/, const mc::McSetRequest& request,
+              mc::McSetReply&& reply) {
+    if (*reply.result_ref() == compatibility::mc_res_unknown) {
+      m_cancelled.store(true, std::memory_order_relaxed);
+    } else if (!mc::isStoredResult(*reply.result_ref())) {
+      setBatchException(request, reply);
+    }
+    finishOne();
+  }
+
+ private:
+  // Sub-replies may fail on different router threads; the first failure
+  // claims m_failed and is reported for the whole batch.
+  template <class Request>
+  void setBatchException(const Request& request,
+                         const mc::ReplyT<Request>& reply) {
+    bool expected = false;
+    if (!m_failed.compare_exchange_strong(expected, true)) return;
+    m_op = mc::OpFromType<Request, mc::RequestOpMapping>::value;
+    m_replyCode = *reply.result_ref();
+    m_exception  = mc_op_to_string(m_op);
+    m_exception += " failed with result ";
+    m_exception += compatibility::carbonResultToString(m_replyCode);
+    if (!reply.message_ref()->empty()) {
+      m_exception += ": ";
+      m_exception += *reply.message_ref();
+    }
+    m_key = request.key_ref()->fullKey().str();
+  }
+
+  // The last sub-reply to arrive hands the event back to the request thread
+  void finishOne() {
+    if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      if (m_cancelled.load(std::memory_order_relaxed)) {
+        cancel();
+      } else {
+        markAsFinished();
+      }
+    }
+  }
+
+  // Per-key slots; indices are stable, so router threads fill them in
+  // concurrently without locking
+  std::vector<std::string> m_keys;
+  std::vector<std::string> m_values;
+  std::vector<uint8_t> m_hits;
+  bool m_wantValues;
+
+  std::atomic<uint32_t> m_pending{0};
+  std::atomic<bool> m_cancelled{false};
+
+  // Deferred exception data
+  std::atomic<bool> m_failed{false};
+  mc_op_t m_op;
+  carbon::Result m_replyCode;
+  std::string m_exception, m_key;
+};
+
 template <class Request>
 void MCRouter::send(std::unique_ptr<const Request> request,
                     MCRouterResult* res) {
@@ -405,6 +558,18 @@ void MCRouter::send(std::unique_ptr<const Request> request,
       });
 }
 
+template <class Request>
+void MCRouter::sendMulti(std::unique_ptr<const Request> request,
+                         MCRouterMultiResult* res, uint32_t index) {
+  auto requestPtr = request.get();
+  m_client->send(
+      *requestPtr,
+      [res, index, request = std::move(request)](const Request& req,
+                                                 mc::ReplyT<Request>&& reply) {
+        res->result(index, req, std::move(reply));
+      });
+}
+
 template <class Request>
 Object MCRouter::issue(std::unique_ptr<const Request> request) {
   auto ev = new MCRouterResult(this, std::move(request));
@@ -479,6 +644,46 @@ static Object mcr_version(ObjectData* this_) {
       std::make_unique<const mc::McVersionRequest>("unused"));
 }
 
+static Object HHVM_METHOD(MCRouter, getMulti, const Array& keys) {
+  // Copy the keys up front: the router threads may outlive this request
+  std::vector<std::string> copies;
+  copies.reserve(keys.size());
+  for (ArrayIter iter(keys); iter; ++iter) {
+    copies.emplace_back(iter.second().toString().toCppString());
+  }
+
+  auto ev = new MCRouterMultiResult(Native::data<MCRouter>(this_),
+                                    std::move(copies));
+  try {
+    return Object{ev->getWaitHandle()};
+  } catch (...) {
+    assertx(false);
+    ev->abandon();
+    throw;
+  }
+}
+
+static Object HHVM_METHOD(MCRouter, setMulti,
+                          const Array& kvs,
+                          int64_t flags, int64_t expiration) {
+  std::vector<std::pair<std::string, std::string>> copies;
+  copies.reserve(kvs.size());
+  for (ArrayIter iter(kvs); iter; ++iter) {
+    copies.emplace_back(iter.first().toString().toCppString(),
+                        iter.second().toString().toCppString());
+  }
+
+  auto ev = new MCRouterMultiResult(Native::data<MCRouter>(this_),
+                                    std::move(copies), flags, expiration);
+  try {
+    return Object{ev->getWaitHandle()};
+  } catch (...) {
+    assertx(false);
+    ev->abandon();
+    throw;
+  }
+}
+
 static Object HHVM_METHOD(MCRouter, cas,
                           int64_t cas,
                           const String& key,
@@ -528,6 +733,8 @@ struct MCRouterExtension : Extension {
 
     HHVM_NAMED_ME(MCRouter, get,  mcr_str<mc::McGetRequest>);
     HHVM_NAMED_ME(MCRouter, gets, mcr_str<mc::McGetsRequest>);
+    HHVM_ME(MCRouter, getMulti);
+    HHVM_ME(MCRouter, setMulti);
 
     HHVM_NAMED_ME(MCRouter, add, mcr_set<mc::McAddRequest>);
     HHVM_NAMED_ME(MCRouter, set, mcr_set<mc::McSetRequest>);
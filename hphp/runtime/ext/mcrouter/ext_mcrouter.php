@@ -238,6 +238,40 @@ class MCRouter {
   <<__Native>>
   public function gets(string $key): Awaitable<darray>;
 
+  /**
+   * Retreive several values in a single pipelined batch
+   *
+   * All lookups are handed to mcrouter at once, so the batch shares
+   * network round trips instead of paying one per key. Unlike get(),
+   * a cache miss does not throw; missing keys are simply absent from
+   * the result.
+   *
+   * @param varray<string> $keys - Names of the keys to retreive
+   *
+   * @return darray - Mapping of found key => value
+   * @throws On failure (e.g. remote error on any of the keys)
+   */
+  <<__Native>>
+  public function getMulti(
+    varray<string> $keys,
+  ): Awaitable<darray<string,string>>;
+
+  /**
+   * Store several values in a single pipelined batch
+   *
+   * @param darray<string,string> $kvs - Mapping of key => value to store
+   * @param int $flags
+   * @param int $expiration
+   *
+   * @throws On the first store that fails
+   */
+  <<__Native>>
+  public function setMulti(
+    darray<string,string> $kvs,
+    int $flags = 0,
+    int $expiration = 0,
+  ): Awaitable<void>;
+
   /**
    * Get the remote server's current version
    *
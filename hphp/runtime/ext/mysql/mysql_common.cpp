@@ -27,6 +27,7 @@
 #include <folly/String.h>
 #include <folly/portability/Sockets.h>
 
+#include "hphp/util/fast_strtoll_base10.h"
 #include "hphp/util/network.h"
 #include "hphp/util/rds-local.h"
 #include "hphp/util/text-util.h"
@@ -44,6 +45,7 @@
 #include "hphp/runtime/base/tv-refcount.h"
 #include "hphp/runtime/vm/jit/translator-inline.h"
 #include "hphp/runtime/vm/native-data.h"
+#include "hphp/zend/zend-strtod.h"
 
 #include "hphp/runtime/ext/mysql/ext_mysql.h"
 #include "hphp/runtime/ext/mysql/mysql_stats.h"
@@ -1196,6 +1198,74 @@ Variant mysql_makevalue(const String& data, enum_field_types field_type) {
   return data;
 }
 
+namespace {
+
+// Longest value a numeric column can produce in the text protocol: DECIMAL
+// tops out at 65 digits, plus sign and decimal point. Anything longer is not
+// numeric data and takes the generic String path.
+constexpr size_t kMaxNumericLen = 67;
+
+// Copy the field into a NUL-terminated stack buffer so the libc-style
+// parsers can be used without materializing a StringData. The caller has
+// checked data.size() <= kMaxNumericLen.
+template <typename F>
+auto with_terminated(folly::StringPiece data, F parse) {
+  char buf[kMaxNumericLen + 1];
+  if (!data.empty()) memcpy(buf, data.data(), data.size());
+  buf[data.size()] = '\0';
+  return parse(buf);
+}
+
+int64_t slice_to_int64(folly::StringPiece data) {
+  // fast_strtoll_base10() matches strtoll() except that it wraps instead of
+  // clamping on overflow, so only use it when the length rules overflow out
+  // (18 digits always fit in an int64).
+  if (data.size() <= 18) {
+    return with_terminated(data, fast_strtoll_base10);
+  }
+  return with_terminated(data, [](const char* p) {
+    return strtoll(p, nullptr, 10);
+  });
+}
+
+double slice_to_double(folly::StringPiece data) {
+  return with_terminated(data, [](const char* p) {
+    return zend_strtod(p, nullptr);
+  });
+}
+
+}
+
+// Same conversion as mysql_makevalue(), but straight off the wire: numeric
+// fields are parsed from the row buffer without allocating a request-heap
+// String that is immediately thrown away. Only textual fields pay for a
+// StringData.
+Variant mysql_makevalue_slice(folly::StringPiece data,
+                              enum_field_types field_type) {
+  if (field_type == MYSQL_TYPE_NULL) {
+    return init_null();
+  } else if (mysqlExtension::TypedResults &&
+             data.size() <= kMaxNumericLen) {
+    switch (field_type) {
+    case MYSQL_TYPE_DECIMAL:
+    case MYSQL_TYPE_TINY:
+    case MYSQL_TYPE_SHORT:
+    case MYSQL_TYPE_LONG:
+    case MYSQL_TYPE_LONGLONG:
+    case MYSQL_TYPE_INT24:
+    case MYSQL_TYPE_YEAR:
+      return slice_to_int64(data);
+    case MYSQL_TYPE_FLOAT:
+    case MYSQL_TYPE_DOUBLE:
+      return slice_to_double(data);
+    default:
+      break;
+    }
+  }
+  if (data.empty()) return empty_string_variant();
+  return String(data.data(), data.size(), CopyString);
+}
+
 MySQLQueryReturn php_mysql_do_query(const String& query, const Variant& link_id) {
   SYNC_VM_REGS_SCOPED();
   if (mysqlExtension::ReadOnly &&
@@ -1405,8 +1475,9 @@ Variant php_mysql_fetch_hash(const Resource& result, int result_type) {
        mysql_field = mysql_fetch_field(mysql_result), i++) {
     Variant data;
     if (mysql_row[i]) {
-      data = mysql_makevalue(String(mysql_row[i], mysql_row_lengths[i],
-                                    CopyString), mysql_field);
+      data = mysql_makevalue_slice(
+        folly::StringPiece(mysql_row[i], mysql_row_lengths[i]),
+        mysql_field->type);
     }
     if (result_type & PHP_MYSQL_NUM) {
       ret.set(i, data);
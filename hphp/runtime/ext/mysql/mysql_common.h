@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <folly/Range.h>
+
 #include "hphp/runtime/base/req-list.h"
 #include "hphp/runtime/base/req-optional.h"
 #include "hphp/runtime/base/req-vector.h"
@@ -465,6 +467,8 @@ Variant php_mysql_fetch_hash(const Resource& result, int result_type);
 
 Variant mysql_makevalue(const String& data, MYSQL_FIELD *mysql_field);
 Variant mysql_makevalue(const String& data, enum_field_types field_type);
+Variant mysql_makevalue_slice(folly::StringPiece data,
+                              enum_field_types field_type);
 const char *php_mysql_get_field_name(int field_type);
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -69,7 +69,11 @@ const StaticString
   s_paths("paths"),
   s_bytes("bytes"),
   s_bytes_rel("bytes_normalized"),
-  s_instances("instances");
+  s_instances("instances"),
+  s_objects("objects"),
+  s_next("next"),
+  s_roots("roots"),
+  s_sampled("sampled");
 
 struct ObjprofObjectReferral {
   uint64_t refs{0};
@@ -1023,6 +1027,85 @@ Array HHVM_FUNCTION(objprof_get_data,
   return objs.toArray();
 }
 
+/*
+ * Sampled, sliceable variant of objprof_get_data(), cheap enough to run on
+ * live traffic. Instances are counted exactly for every root in the slice,
+ * but the expensive recursive size walk runs only for one out of every
+ * sample_rate roots, and its contribution is scaled by the rate, so the byte
+ * totals are statistical estimates. slice_objects bounds how many heap
+ * objects are visited per call (0 means the whole heap); cursor resumes a
+ * sliced walk, and the returned 'next' value is the cursor for the following
+ * slice (0 once the census is complete). The caller merges the per-slice
+ * histograms.
+ */
+Array HHVM_FUNCTION(objprof_get_data_sampled,
+  int64_t sample_rate,
+  int64_t slice_objects /* = 0 */,
+  int64_t cursor /* = 0 */,
+  int64_t flags /* = ObjprofFlags::DEFAULT */,
+  const Array& exclude_list /* = Array() */
+) {
+  if (sample_rate < 1) sample_rate = 1;
+  if (slice_objects < 0) slice_objects = 0;
+  if (cursor < 0) cursor = 0;
+  if ((flags & ObjprofFlags::PER_PROPERTY) != 0) {
+    raise_warning("objprof_get_data_sampled: per-property attribution is "
+                  "not supported in sampled mode; ignoring the flag");
+    flags &= ~ObjprofFlags::PER_PROPERTY;
+  }
+
+  std::unordered_map<ClassProp, ObjprofMetrics> histogram;
+  std::unordered_set<std::string> exclude_classes;
+  for (ArrayIter iter(exclude_list); iter; ++iter) {
+    exclude_classes.insert(iter.second().toString().data());
+  }
+
+  int64_t roots = 0;
+  int64_t sampled = 0;
+  auto const next = tl_heap->forEachObjectSlice(
+    cursor, slice_objects,
+    [&](const ObjectData* obj) {
+      if (!isObjprofRoot(obj, (ObjprofFlags)flags, exclude_classes)) return;
+      if (obj->hasZeroRefs()) return;
+      auto& metrics = histogram[std::make_pair(obj->getVMClass(), "")];
+      metrics.instances += 1;
+      if (roots++ % sample_rate != 0) return;
+      sampled++;
+      std::vector<const void*> val_stack;
+      auto objsizePair = getObjSize(
+        obj,
+        nullptr, /* source */
+        nullptr, /* stack */
+        nullptr, /* paths */
+        &val_stack,
+        exclude_classes,
+        nullptr, /* histogram */
+        (ObjprofFlags)flags
+      );
+      metrics.bytes += objsizePair.first * sample_rate;
+      metrics.bytes_rel += objsizePair.second * sample_rate;
+    });
+
+  DictInit objs(histogram.size());
+  for (auto const& it : histogram) {
+    auto const key = it.first.first->name()->toCppString();
+    auto metrics_val = make_dict_array(
+      s_instances, Variant(it.second.instances),
+      s_bytes, Variant(it.second.bytes),
+      s_bytes_rel, it.second.bytes_rel,
+      s_paths, init_null()
+    );
+    objs.set(StrNR(key), Variant(metrics_val));
+  }
+
+  return make_dict_array(
+    s_objects, objs.toArray(),
+    s_next, Variant((int64_t)next),
+    s_roots, Variant(roots),
+    s_sampled, Variant(sampled)
+  );
+}
+
 Array HHVM_FUNCTION(objprof_get_paths,
   int flags = ObjprofFlags::DEFAULT,
   const Array& exclude_list = Array()
@@ -1247,6 +1330,7 @@ struct objprofExtension final : Extension {
 
   void moduleInit() override {
     HHVM_FALIAS(HH\\objprof_get_data, objprof_get_data);
+    HHVM_FALIAS(HH\\objprof_get_data_sampled, objprof_get_data_sampled);
     HHVM_FALIAS(HH\\objprof_get_strings, objprof_get_strings);
     HHVM_FALIAS(HH\\objprof_get_paths, objprof_get_paths);
     HHVM_FALIAS(HH\\thread_memory_stats, thread_memory_stats);
@@ -34,6 +34,24 @@ function objprof_get_data(
   varray<string> $exclude_list = varray[],
 ): darray<string, ObjprofObjectStats>;
 
+/**
+ * Sampled, sliceable variant of objprof_get_data(), cheap enough for live
+ * traffic. Instance counts are exact for the objects visited; byte totals
+ * are statistical estimates taken from one out of every $sample_rate roots
+ * and scaled up. $slice_objects bounds how many heap objects are visited per
+ * call (0 means the whole heap); pass the returned 'next' value back as
+ * $cursor to continue a sliced walk ('next' is 0 once the census is done),
+ * and merge the per-slice 'objects' histograms.
+ */
+<<__Native>>
+function objprof_get_data_sampled(
+  int $sample_rate,
+  int $slice_objects = 0,
+  int $cursor = 0,
+  int $flags = \OBJPROF_FLAGS_DEFAULT,
+  varray<string> $exclude_list = varray[],
+): darray<string, mixed>;
+
 <<__Native>>
 function objprof_get_paths(
   int $flags = \OBJPROF_FLAGS_DEFAULT,
@@ -3,4 +3,6 @@ HHVM_DEFINE_EXTENSION("password"
     ext_password.cpp
   SYSTEMLIB
     ext_password.php
+  DEPENDS
+    libFolly
 )
@@ -16,16 +16,83 @@
  */
 
 #include "hphp/runtime/ext/extension.h"
+#include "hphp/runtime/ext/asio/asio-external-thread-event.h"
 #include "hphp/runtime/vm/native-data.h"
+#include "hphp/util/process.h"
+#include "hphp/zend/zend-string.h"
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <folly/executors/thread_factory/PriorityThreadFactory.h>
 
 namespace HPHP {
 
+namespace {
+
+/*
+ * Dedicated low-priority pool for password hashing, so login-heavy traffic
+ * burns these threads instead of request workers. The work is pure CPU with
+ * no request-local state, so the threads skip HPHP thread initialization.
+ */
+folly::CPUThreadPoolExecutor& getPasswordHashExecutor() {
+  static folly::CPUThreadPoolExecutor e{
+    std::max(1, Process::GetCPUCount() / 2),
+    std::make_shared<folly::PriorityThreadFactory>(
+      std::make_shared<folly::NamedThreadFactory>("PasswordHashPool"),
+      10 /* nice value, so request threads win when CPU is scarce */)
+  };
+  return e;
+}
+
+/*
+ * Runs one crypt() computation on the hashing pool and wakes the awaiting
+ * request when it completes.
+ */
+struct PasswordCryptEvent final : AsioExternalThreadEvent {
+  PasswordCryptEvent(const String& password, const String& salt)
+    : m_password(password.toCppString())
+    , m_salt(salt.toCppString()) {
+    getPasswordHashExecutor().add([this] { crypt(); });
+  }
+
+ protected:
+  void unserialize(TypedValue& result) override {
+    result = make_tv<KindOfString>(
+      StringData::Make(m_output.data(), m_output.size(), CopyString));
+  }
+
+ private:
+  void crypt() {
+    // string_crypt() always returns a malloc'd string; failures come back as
+    // the usual "*0"/"*1" markers, which the caller rejects by length.
+    char* res = string_crypt(m_password.c_str(), m_salt.c_str());
+    m_output = res;
+    free(res);
+    markAsFinished();
+  }
+
+  std::string m_password;
+  std::string m_salt;
+  std::string m_output;
+};
+
+Object HHVM_FUNCTION(__password_crypt_await,
+                     const String& password,
+                     const String& salt) {
+  auto ev = new PasswordCryptEvent(password, salt);
+  return Object{ev->getWaitHandle()};
+}
+
+} // namespace
+
 struct PasswordExtension final : Extension {
   PasswordExtension() : Extension("password") {}
   void moduleInit() override {
     HHVM_RC_INT(PASSWORD_BCRYPT, 1);
     HHVM_RC_INT(PASSWORD_DEFAULT, 1 /* PASSWORD_BCRYPT */);
 
+    HHVM_FE(__password_crypt_await);
+
     loadSystemlib();
   }
 } s_password_extension;
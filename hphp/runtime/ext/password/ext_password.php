@@ -22,6 +22,58 @@
 function password_hash(?string $password,
                        int $algo,
                        darray $options = darray[]) : mixed {
+  $hash = __password_hash_prepare($password, $algo, $options);
+  if ($hash === null) {
+    return null;
+  }
+
+  $ret = crypt($password, $hash);
+
+  if (!is_string($ret) || strlen($ret) <= 13) {
+    return false;
+  }
+
+  return $ret;
+}
+
+/**
+* Async variant of password_hash(). The crypt() work is dispatched to a
+* dedicated low-priority thread pool instead of running on the request
+* thread, so login-heavy traffic doesn't occupy request workers for the
+* duration of the hash computation.
+*
+* Takes the same arguments and returns the same values as password_hash().
+*/
+async function password_hash_async(?string $password,
+                                   int $algo,
+                                   darray $options = darray[])
+                                   : Awaitable<mixed> {
+  $hash = __password_hash_prepare($password, $algo, $options);
+  if ($hash === null) {
+    return null;
+  }
+
+  $ret = await __password_crypt_await((string)$password, $hash);
+
+  if (!is_string($ret) || strlen($ret) <= 13) {
+    return false;
+  }
+
+  return $ret;
+}
+
+<<__Native>>
+function __password_crypt_await(string $password,
+                                string $salt): Awaitable<string>;
+
+/**
+* Shared validation and salt preparation for password_hash() and
+* password_hash_async(). Returns the crypt() format-and-salt string, or null
+* (after raising a warning) when the arguments are invalid.
+*/
+function __password_hash_prepare(?string $password,
+                                 int $algo,
+                                 darray $options) : ?string {
   if (!function_exists('crypt')) {
     trigger_error("Crypt must be loaded for password_hash to function",
                   E_WARNING);
@@ -144,15 +196,7 @@ function password_hash(?string $password,
   }
   $salt = substr($salt, 0, $required_salt_len);
 
-  $hash = $hash_format . $salt;
-
-  $ret = crypt($password, $hash);
-
-  if (!is_string($ret) || strlen($ret) <= 13) {
-    return false;
-  }
-
-  return $ret;
+  return $hash_format . $salt;
 }
 
 /**
@@ -126,6 +126,16 @@ TypedValue HHVM_FUNCTION(preg_match_all_with_matches_and_error,
                                  &matches, flags, offset));
 }
 
+TypedValue HHVM_FUNCTION(preg_match_set,
+                         const Variant& patterns, StringArg subject) {
+  if (!isContainer(patterns)) {
+    raise_warning("patterns passed to preg_match_set must be an array "
+                  "or collection");
+    return tvReturn(init_null());
+  }
+  return tvReturn(preg_match_set(patterns.toArray(), String{subject.get()}));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 
@@ -421,6 +431,7 @@ struct PcreExtension final : Extension {
     HHVM_FE(preg_match_all_with_error);
     HHVM_FE(preg_match_all_with_matches);
     HHVM_FE(preg_match_all_with_matches_and_error);
+    HHVM_FE(preg_match_set);
     HHVM_FE(preg_replace);
     HHVM_FE(preg_replace_with_error);
     HHVM_FE(preg_replace_with_count);
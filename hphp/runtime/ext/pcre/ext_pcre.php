@@ -132,6 +132,26 @@ function preg_match_all_with_matches_and_error(
   int $offset = 0,
 )[]: mixed;
 
+/**
+ * Match a set of patterns against one subject in a single pass.
+ *
+ * The set is compiled once into a combined matcher with a literal
+ * prefilter and cached, so running hundreds of patterns (e.g. request
+ * filtering rules) against an input costs one scan plus a full match for
+ * the few candidate patterns, instead of one preg_match per pattern.
+ *
+ * @param array $patterns - The patterns to search for, as a varray of
+ *   strings. Every element must be a valid preg pattern.
+ * @param string $subject - The input string.
+ *
+ * @return mixed - Returns a vec containing the indices (into $patterns)
+ *   of the patterns that match $subject, in pattern order, or FALSE if
+ *   any member of the set is not a valid pattern or an error occurred.
+ */
+<<__Native>>
+function preg_match_set(varray_or_darray $patterns,
+                        string $subject)[]: mixed;
+
 /**
  * Perform a regular expression match
  *
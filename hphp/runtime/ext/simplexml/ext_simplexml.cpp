@@ -723,14 +723,7 @@ static bool sxe_prop_dim_exists(SimpleXMLElement* sxe, const Variant& member,
 
 static inline String sxe_xmlNodeListGetString(xmlDocPtr doc, xmlNodePtr list,
                                               bool inLine) {
-  xmlChar* tmp = xmlNodeListGetString(doc, list, inLine);
-  if (tmp) {
-    String ret = String((char*)tmp);
-    xmlFree(tmp);
-    return ret;
-  } else {
-    return empty_string();
-  }
+  return libxml_node_list_text(doc, list, inLine);
 }
 
 static Variant _get_base_node_value(SimpleXMLElement* sxe_ref,
@@ -739,12 +732,7 @@ static Variant _get_base_node_value(SimpleXMLElement* sxe_ref,
   if (node->children &&
       node->children->type == XML_TEXT_NODE &&
       !xmlIsBlankNode(node->children)) {
-    xmlChar* contents = xmlNodeListGetString(node->doc, node->children, 1);
-    if (contents) {
-      String obj = String((char*)contents);
-      xmlFree(contents);
-      return obj;
-    }
+    return libxml_node_list_text(node->doc, node->children, true);
   } else {
     auto sxeRefObj = Native::object<SimpleXMLElement>(sxe_ref);
     Object obj = create_object(sxeRefObj->getClassName(), Array(), false);
@@ -794,8 +782,13 @@ static void sxe_get_prop_hash(SimpleXMLElement* sxe, bool is_debug,
     }
     if (!node || node->type != XML_ENTITY_DECL) {
       xmlAttrPtr attr = node ? (xmlAttrPtr)node->properties : nullptr;
-      Array zattr = Array::CreateDict();
       bool test = sxe->iter.name && sxe->iter.type == SXE_ITER_ATTRLIST;
+      // Size the dict up front so it doesn't grow through rehashes; the
+      // count is an upper bound when attributes are being filtered.
+      uint32_t nattr = 0;
+      for (auto a = attr; a; a = a->next) ++nattr;
+      DictInit zattr{nattr};
+      uint32_t added = 0;
       while (attr) {
         if ((!test || !xmlStrcmp(attr->name, sxe->iter.name)) &&
             match_ns(sxe, (xmlNodePtr)attr, sxe->iter.nsprefix,
@@ -805,11 +798,12 @@ static void sxe_get_prop_hash(SimpleXMLElement* sxe, bool is_debug,
                       sxe->docp(),
                       attr->children,
                       1));
+          ++added;
         }
         attr = attr->next;
       }
-      if (zattr.size()) {
-        rv.set(s_atAttributes, zattr);
+      if (added) {
+        rv.set(s_atAttributes, zattr.toArray());
       }
     }
   }
@@ -906,11 +900,11 @@ Variant SimpleXMLElement_objectCast(const ObjectData* obj, DataType type) {
     return properties.size() != 0;
   }
 
-  xmlChar* contents = nullptr;
+  String ret = empty_string();
   if (sxe->iter.type != SXE_ITER_NONE) {
     xmlNodePtr node = php_sxe_get_first_node(sxe, nullptr);
     if (node) {
-      contents = xmlNodeListGetString(sxe->docp(), node->children, 1);
+      ret = libxml_node_list_text(sxe->docp(), node->children, true);
     }
   } else {
     xmlDocPtr doc = sxe->docp();
@@ -922,16 +916,11 @@ Variant SimpleXMLElement_objectCast(const ObjectData* obj, DataType type) {
 
     if (sxe->nodep()) {
       if (sxe->nodep()->children) {
-        contents = xmlNodeListGetString(doc, sxe->nodep()->children, 1);
+        ret = libxml_node_list_text(doc, sxe->nodep()->children, true);
       }
     }
   }
 
-  String ret = String((char*)contents);
-  if (contents) {
-    xmlFree(contents);
-  }
-
   switch (type) {
     case KindOfString: return ret;
     case KindOfInt64:  return ret.toInt64();
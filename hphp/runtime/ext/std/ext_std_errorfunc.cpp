@@ -70,8 +70,17 @@ Array HHVM_FUNCTION(debug_backtrace, int64_t options /* = 1 */,
                          .setLimit(limit));
 }
 
-ArrayData* debug_backtrace_jit(int64_t options) {
-  return HHVM_FN(debug_backtrace)(options).detach();
+TypedValue debug_backtrace_jit(int64_t options) {
+  auto const args = BacktraceArgs()
+    .withThis(options & k_DEBUG_BACKTRACE_PROVIDE_OBJECT)
+    .withMetadata(options & k_DEBUG_BACKTRACE_PROVIDE_METADATA)
+    .ignoreArgs(options & k_DEBUG_BACKTRACE_IGNORE_ARGS);
+  if (args.isCompact()) {
+    // Defer symbolization: hand back the raw frame record and let the
+    // consumer extract it if and when the trace is actually inspected.
+    return make_tv<KindOfResource>(createCompactBacktrace().detach()->hdr());
+  }
+  return make_array_like_tv(createBacktrace(args).detach());
 }
 
 /**
@@ -296,5 +296,5 @@ namespace __SystemLib {
    * @return array - the backtrace extracted from $trace
    */
   <<__Native>>
-  function extract_trace(resource $trace): \HH\varray;
+  function extract_trace(resource $trace)[]: \HH\varray;
 }
@@ -51,6 +51,10 @@
 #include <folly/Unicode.h>
 #include <locale.h>
 
+#ifdef __x86_64__
+#include <emmintrin.h>
+#endif
+
 namespace HPHP {
 
 static Mutex s_mutex;
@@ -181,29 +185,68 @@ String HHVM_FUNCTION(stripcslashes,
     });
 }
 
+// Length of the prefix of [src, src + len) with no byte addslashes escapes
+// ('\0', '\'', '"' or '\\'); lets the loop below bulk-append clean runs.
+static size_t addslashes_clean_span(const char* src, size_t len) {
+  size_t i = 0;
+#ifdef __x86_64__
+  while (i + 16 <= len) {
+    auto const chunk =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    auto const special = _mm_or_si128(
+      _mm_or_si128(
+        _mm_cmpeq_epi8(chunk, _mm_setzero_si128()),
+        _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))
+      ),
+      _mm_or_si128(
+        _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\'')),
+        _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\"'))
+      )
+    );
+    auto const mask = _mm_movemask_epi8(special);
+    if (mask) return i + __builtin_ctz(mask);
+    i += 16;
+  }
+#endif
+  for (; i < len; ++i) {
+    auto const c = src[i];
+    if (c == '\0' || c == '\\' || c == '\"' || c == '\'') break;
+  }
+  return i;
+}
+
 String HHVM_FUNCTION(addslashes,
                      const String& str) {
   if (str.empty()) {
     return str;
   }
 
-  return stringForEachBuffered(
-    str.size(), str,
-    [&](StringBuffer& ret, const char* src, const char* /*end*/) {
-      switch (*src) {
-        case '\0':
-          ret.append('\\');
-          ret.append('0');
-          break;
-        case '\\':
-        case '\"':
-        case '\'':
-          ret.append('\\');
-        /* fall through */
-        default:
-          ret.append(*src);
-      }
-    });
+  StringBuffer ret(str.size());
+  const char* src = str.data();
+  const char* end = src + str.size();
+
+  while (src < end) {
+    auto const span = addslashes_clean_span(src, end - src);
+    if (span) {
+      ret.append(src, span);
+      src += span;
+      if (src == end) break;
+    }
+    switch (*src) {
+      case '\0':
+        ret.append('\\');
+        ret.append('0');
+        break;
+      case '\\':
+      case '\"':
+      case '\'':
+        ret.append('\\');
+        ret.append(*src);
+        break;
+    }
+    ++src;
+  }
+  return ret.detach();
 }
 
 String HHVM_FUNCTION(stripslashes,
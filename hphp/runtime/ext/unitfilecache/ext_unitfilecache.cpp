@@ -34,28 +34,56 @@ namespace HPHP {
 
 namespace {
 
+// Hot builds hit the cache for nearly every unit and parse with many
+// threads, so each thread gets its own connection (WAL mode lets readers
+// run concurrently with a writer) instead of funneling every lookup
+// through one shared connection and lock.
 struct State {
   explicit State(const std::string&);
 
-  static SQLite connect(const std::string&);
+  struct Connection {
+    explicit Connection(const std::string& path)
+      : m_db{connect(path)}
+      , m_find{m_db.prepare("SELECT data FROM units WHERE hash = @hash")}
+      , m_insert{m_db.prepare("INSERT OR IGNORE INTO units (hash, data) "
+                              "VALUES (@hash, @data)")}
+    {}
+
+    SQLite m_db;
+    SQLiteStmt m_find;
+    SQLiteStmt m_insert;
+  };
+
+  Connection* connection() {
+    thread_local std::unique_ptr<Connection> conn;
+    thread_local bool failed = false;
+    if (!conn && !failed) {
+      try {
+        conn = std::make_unique<Connection>(m_path);
+      } catch (const SQLiteExc& exn) {
+        // Don't retry on every unit; this thread just parses everything.
+        failed = true;
+        Logger::FError("Unable to connect to unit file cache at {}: {}",
+                       m_path, exn.what());
+      }
+    }
+    return conn.get();
+  }
 
-  SQLite m_db;
-  SQLiteStmt m_find;
-  SQLiteStmt m_insert;
+  static SQLite connect(const std::string&);
 
-  std::mutex m_lock;
+  std::string m_path;
 };
 
 std::unique_ptr<State> s_state;
 
 ///////////////////////////////////////////////////////////////////////////////
 
-State::State(const std::string& path)
-  : m_db{connect(path)}
-  , m_find{m_db.prepare("SELECT data FROM units WHERE hash = @hash")}
-  , m_insert{m_db.prepare("INSERT OR IGNORE INTO units (hash, data) "
-                          "VALUES (@hash, @data)")}
-{}
+State::State(const std::string& path) : m_path{path} {
+  // Connect once up front to create the table (and fail early if the
+  // path is unusable); per-thread connections are made lazily.
+  connect(path);
+}
 
 SQLite State::connect(const std::string& path) {
   SQLite db{SQLite::connect(path)};
@@ -97,11 +125,13 @@ std::unique_ptr<UnitEmitter> cache_hook(
 
   auto const hashStr = sha1.toString();
 
+  auto const conn = s_state->connection();
+  if (!conn) return compile(true);
+
   auto ue = [&] () -> std::unique_ptr<UnitEmitter> {
-    std::lock_guard<std::mutex> _{s_state->m_lock};
     try {
-      auto txn = s_state->m_db.begin();
-      auto query = txn.query(s_state->m_find);
+      auto txn = conn->m_db.begin();
+      auto query = txn.query(conn->m_find);
       query.bindString("@hash", hashStr);
       query.step();
       if (!query.row()) return nullptr;
@@ -134,10 +164,9 @@ std::unique_ptr<UnitEmitter> cache_hook(
     BlobEncoder encoder{false};
     ue->serde(encoder, false);
 
-    std::lock_guard<std::mutex> _{s_state->m_lock};
     try {
-      auto txn = s_state->m_db.begin();
-      auto insert = txn.query(s_state->m_insert);
+      auto txn = conn->m_db.begin();
+      auto insert = txn.query(conn->m_insert);
       insert.bindString("@hash", hashStr);
       insert.bindBlob("@data", encoder.data(), encoder.size());
       insert.step();
@@ -313,7 +313,11 @@ void XenonRequestLocalData::log(Xenon::SampleType t,
                              .skipInlined(t == Xenon::EnterSample)
                              .fromWaitHandle(wh)
                              .withMetadata()
-                             .ignoreArgs());
+                             .ignoreArgs()
+                             // Bound the walk of deep (async) stacks; the
+                             // asio dependency chain can be long for heavily
+                             // blocked requests.
+                             .setLimit(RuntimeOption::XenonStackWalkLimit));
   m_stackSnapshots.append(make_dict_array(
     s_time, now,
     s_time_ns, now_ns,
@@ -359,8 +363,11 @@ bool XenonRequestLocalData::getIsProfiledRequest() {
 // gathered via surprise flags.
 
 Array HHVM_FUNCTION(xenon_get_data, void) {
+  // Samples may also exist without the periodic timer when snapshots were
+  // requested on demand (e.g. via the xenon-snap admin command).
   if (RuntimeOption::XenonForceAlwaysOn ||
-      RuntimeOption::XenonPeriodSeconds > 0) {
+      RuntimeOption::XenonPeriodSeconds > 0 ||
+      !s_xenonData->m_stackSnapshots.empty()) {
     TRACE(1, "xenon_get_data\n");
     return s_xenonData->createResponse();
   }
@@ -369,7 +376,8 @@ Array HHVM_FUNCTION(xenon_get_data, void) {
 
 Array HHVM_FUNCTION(xenon_get_and_clear_samples, void) {
   if (RuntimeOption::XenonForceAlwaysOn ||
-      RuntimeOption::XenonPeriodSeconds > 0) {
+      RuntimeOption::XenonPeriodSeconds > 0 ||
+      !s_xenonData->m_stackSnapshots.empty()) {
     TRACE(1, "xenon_get_and_clear_samples\n");
     Array ret = s_xenonData->createResponse();
     s_xenonData->m_stackSnapshots.reset();
@@ -182,6 +182,38 @@ void AccessLog::clearThreadLog() {
   threadLog = nullptr;
 }
 
+LogWriter::~LogWriter() {
+  stopWriteThread();
+}
+
+bool LogWriter::enqueueLine(std::string&& line) {
+  if (!m_lineQueue || line.empty()) return false;
+  return m_lineQueue->write(std::move(line));
+}
+
+void LogWriter::startWriteThread() {
+  auto const size = RuntimeOption::AccessLogAsyncWriteQueueSize;
+  if (size <= 0) return;
+  m_lineQueue = std::make_unique<folly::MPMCQueue<std::string>>(size);
+  m_writeThread = std::thread([this] {
+    std::string line;
+    while (true) {
+      m_lineQueue->blockingRead(line);
+      // Formatted lines always end in a newline; an empty line is the
+      // shutdown sentinel.
+      if (line.empty()) return;
+      writeLine(line);
+    }
+  });
+}
+
+void LogWriter::stopWriteThread() {
+  if (!m_writeThread.joinable()) return;
+  m_lineQueue->blockingWrite(std::string());
+  m_writeThread.join();
+  m_lineQueue.reset();
+}
+
 FILE* LogWriter::getOutputFile() const {
   FILE* outfile = nullptr;
   switch (m_channel) {
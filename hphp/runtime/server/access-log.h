@@ -15,6 +15,10 @@
 */
 #pragma once
 
+#include <thread>
+
+#include <folly/MPMCQueue.h>
+
 #include "hphp/runtime/ext/extension.h"
 #include "hphp/runtime/server/transport.h"
 #include "hphp/runtime/server/virtual-host.h"
@@ -92,7 +96,7 @@ struct LogWriter {
   explicit LogWriter(LogChannel chan)
     : m_channel(chan)
   {}
-  virtual ~LogWriter() {};
+  virtual ~LogWriter();
   virtual void init(const std::string& username,
                     AccessLog::GetThreadDataFunc fn) = 0;
   virtual void write(Transport* transport, const VirtualHost* vhost) = 0;
@@ -106,6 +110,25 @@ protected:
 protected:
   FILE* getOutputFile() const;
   void recordWriteAndMaybeDropCaches(FILE* out, int bytes);
+
+  /*
+   * Asynchronous writing: when Log.AccessLogAsyncWriteQueueSize is set,
+   * formatted lines go into a bounded ring buffer drained by a dedicated
+   * write thread, so request threads never touch the output file or its
+   * lock. Subclasses opt in by calling startWriteThread() at the end of
+   * init() and stopWriteThread() in their destructor before tearing down
+   * the output, and implement writeLine() as the sink. enqueueLine()
+   * returns false when async writing is off or the buffer is full; the
+   * caller then writes synchronously.
+   */
+  bool asyncEnabled() const { return m_lineQueue != nullptr; }
+  bool enqueueLine(std::string&& line);
+  void startWriteThread();
+  void stopWriteThread();
+  virtual void writeLine(const std::string& /*line*/) {}
+private:
+  std::unique_ptr<folly::MPMCQueue<std::string>> m_lineQueue;
+  std::thread m_writeThread;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
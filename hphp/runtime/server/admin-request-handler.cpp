@@ -34,6 +34,7 @@
 #include "hphp/runtime/base/unit-cache.h"
 
 #include "hphp/runtime/vm/debug/debug.h"
+#include "hphp/runtime/vm/instance-bits.h"
 #include "hphp/runtime/vm/jit/cg-meta.h"
 #include "hphp/runtime/vm/jit/fixup.h"
 #include "hphp/runtime/vm/jit/mcgen.h"
@@ -42,6 +43,8 @@
 #include "hphp/runtime/vm/jit/relocation.h"
 #include "hphp/runtime/vm/jit/tc-record.h"
 #include "hphp/runtime/vm/jit/tc.h"
+#include "hphp/runtime/vm/jit/trans-db.h"
+#include "hphp/runtime/vm/memo-cache.h"
 #include "hphp/runtime/vm/named-entity.h"
 #include "hphp/runtime/vm/treadmill.h"
 #include "hphp/runtime/vm/type-profile.h"
@@ -50,6 +53,7 @@
 #include "hphp/runtime/ext/json/ext_json.h"
 #include "hphp/runtime/ext/xenon/ext_xenon.h"
 
+#include "hphp/runtime/server/compression.h"
 #include "hphp/runtime/server/http-request-handler.h"
 #include "hphp/runtime/server/http-server.h"
 #include "hphp/runtime/server/memory-stats.h"
@@ -59,6 +63,7 @@
 
 #include "hphp/util/alloc.h"
 #include "hphp/util/build-info.h"
+#include "hphp/util/hardware-counter.h"
 #include "hphp/util/hphp-config.h"
 #include "hphp/util/hugetlb.h"
 #include "hphp/util/logger.h"
@@ -76,6 +81,7 @@
 
 #include <folly/Conv.h>
 #include <folly/File.h>
+#include <folly/json.h>
 #include <folly/FileUtil.h>
 #include <folly/Random.h>
 #include <folly/portability/Unistd.h>
@@ -298,6 +304,8 @@ void AdminRequestHandler::handleRequest(Transport *transport) {
         "/prepare-to-stop: ask the server to prepare for stopping\n"
         "/flush-profile:   flush profiling counters (in -fprofile-gen builds)\n"
         "/flush-logs:      trigger batching log-writers to flush all content\n"
+        "/reload-zstd-dictionary: re-read the trained zstd response\n"
+        "                  compression dictionary from disk\n"
         "/translate:       translate hex encoded stacktrace in 'stack' param\n"
         "    stack         required, stack trace to translate\n"
         "    build-id      optional, if specified, build ID has to match\n"
@@ -357,6 +365,13 @@ void AdminRequestHandler::handleRequest(Transport *transport) {
         "/xenon-snap:      generate a Xenon snapshot, which is logged later\n"
         "/hugepage:        show stats about hugepage usage\n"
         "/jit-des-info:    show information about deserialized profile data\n"
+        "/jit-trans-index: summary of the translation index as JSON;\n"
+        "                  requires -vEval.JitTransIndex=1\n"
+        "    func          optional, list that function's translations\n"
+
+        "/hw-counters:     show per-endpoint hardware counter aggregates as\n"
+        "                  JSON; requires -vEval.ProfileHWPerEndpoint=1\n"
+        "/hw-counters-clear: reset per-endpoint hardware counter aggregates\n"
 
         "/static-strings:  get number of static strings\n"
         "/static-strings-rds: ... that correspond to defined constants\n"
@@ -381,6 +396,11 @@ void AdminRequestHandler::handleRequest(Transport *transport) {
 
         "/invalidate-units: remove specified files from the unit cache\n"
         "    path           absolute path of files to invalidate\n"
+        "/clear-persistent-memo: drop the process-wide memo cache tier\n"
+        "/instance-bits-profile: resume profiling instanceof checks so a\n"
+        "                  later refresh can assign the unused instance bits\n"
+        "/instance-bits-refresh: assign unused instance bits to the classes\n"
+        "                  hottest in the profile collected since warmup\n"
 
         "/start-stacktrace-profiler: set enable_stacktrace_profiler to true\n"
         "/relocate:        relocate translations\n"
@@ -602,6 +622,12 @@ void AdminRequestHandler::handleRequest(Transport *transport) {
       RPCRequestHandler::GetAccessLog().flushAllWriters();
       break;
     }
+    if (cmd == "reload-zstd-dictionary") {
+      transport->sendString(reloadZstdCompressionDictionary()
+                              ? "OK\n"
+                              : "Failed to reload zstd dictionary\n");
+      break;
+    }
     if (cmd == "set-log-level") {
       string result("OK\n");
       string level = transport->getParam("level");
@@ -695,6 +721,23 @@ void AdminRequestHandler::handleRequest(Transport *transport) {
         handleInvalidateUnitRequest(cmd, transport)) {
       break;
     }
+    if (cmd == "clear-persistent-memo") {
+      memoCachePersistentClear();
+      transport->sendString("OK\n", 200);
+      break;
+    }
+    if (cmd == "instance-bits-profile") {
+      InstanceBits::resumeProfiling();
+      transport->sendString(InstanceBits::profiling() ? "OK\n" : "no-op\n",
+                            200);
+      break;
+    }
+    if (cmd == "instance-bits-refresh") {
+      auto const assigned = InstanceBits::refresh();
+      transport->sendString(folly::sformat("{} new bits assigned\n", assigned),
+                            200);
+      break;
+    }
     if (strncmp(cmd.c_str(), "xenon-snap", 10) == 0) {
       static int64_t s_lastSampleTime = 0;
       auto const current = TimeStamp::Current();
@@ -731,6 +774,30 @@ void AdminRequestHandler::handleRequest(Transport *transport) {
                                 jit::ProfData::buildTime());
       transport->sendString(msg, 200);
     }
+    if (cmd == "jit-trans-index") {
+      folly::dynamic res = folly::dynamic::object;
+      auto const func = transport->getParam("func");
+      if (func.empty()) {
+        res["enabled"] = jit::transdb::indexEnabled();
+        res["entries"] = static_cast<int64_t>(jit::transdb::indexSize());
+        res["truncated"] = jit::transdb::indexTruncated();
+      } else {
+        folly::dynamic list = folly::dynamic::array;
+        for (auto const& e : jit::transdb::indexForFunc(func)) {
+          list.push_back(folly::dynamic::object
+            ("id", static_cast<int64_t>(e.id))
+            ("kind", jit::show(e.kind))
+            ("src", showShort(e.src))
+            ("main_bytes", e.aLen)
+            ("cold_bytes", e.acoldLen)
+            ("frozen_bytes", e.afrozenLen)
+            ("prof_weight", e.profWeight));
+        }
+        res[func] = list;
+      }
+      transport->sendString(folly::toJson(res) + "\n");
+      break;
+    }
 
     if (strncmp(cmd.c_str(), "static-strings", 14) == 0 &&
         handleStaticStringsRequest(cmd, transport)) {
@@ -763,6 +830,29 @@ void AdminRequestHandler::handleRequest(Transport *transport) {
       break;
     }
 
+    if (cmd == "hw-counters") {
+      folly::dynamic res = folly::dynamic::object;
+      HardwareCounter::GetEndpointEvents(
+        [](const std::string& endpoint, const std::string& event,
+           int64_t sum, int64_t samples, void* data) {
+          auto& out = *static_cast<folly::dynamic*>(data);
+          if (out.get_ptr(endpoint) == nullptr) {
+            out[endpoint] = folly::dynamic::object;
+          }
+          out[endpoint][event] =
+            folly::dynamic::object("sum", sum)("samples", samples);
+        },
+        &res);
+      transport->sendString(folly::toJson(res) + "\n");
+      break;
+    }
+
+    if (cmd == "hw-counters-clear") {
+      HardwareCounter::ClearEndpointEvents();
+      transport->sendString("OK\n");
+      break;
+    }
+
     if (cmd == "pcre-cache-size") {
       std::ostringstream size;
       size << preg_pcre_cache_size() << endl;
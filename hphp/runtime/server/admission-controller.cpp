@@ -0,0 +1,149 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010-present Facebook, Inc. (http://www.facebook.com)  |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include "hphp/runtime/server/admission-controller.h"
+
+#include <algorithm>
+
+#include <folly/system/ThreadName.h>
+
+#include "hphp/runtime/base/runtime-option.h"
+#include "hphp/runtime/server/server.h"
+#include "hphp/util/assertions.h"
+#include "hphp/util/health-monitor-types.h"
+#include "hphp/util/logger.h"
+#include "hphp/util/service-data.h"
+
+namespace HPHP {
+
+namespace {
+
+// Every worker thread bumps these once per request, so they are sharded.
+ServiceData::ExportedShardedCounter* queueDelayCounter() {
+  static auto counter =
+    ServiceData::createShardedCounter("admission.queue_delay_us");
+  return counter;
+}
+
+ServiceData::ExportedShardedCounter* queueDelaySampleCounter() {
+  static auto counter =
+    ServiceData::createShardedCounter("admission.queue_delay_samples");
+  return counter;
+}
+
+}
+
+std::atomic<bool> AdmissionController::s_shedding{false};
+
+AdmissionController::AdmissionController(Server* server)
+  : m_server(server)
+  , m_maxWorkers(RuntimeOption::ServerThreadCount)
+  , m_minWorkers(std::max(1, RuntimeOption::ServerThreadCount / 4)) {
+  assertx(m_server != nullptr);
+  auto const dt = RuntimeOption::ServerAdmissionUpdatePeriodMs / 1000.0;
+  // The error term is in milliseconds of queueing delay; gains are scaled by
+  // the pool size so behavior is comparable across differently sized boxes.
+  // Deliberately conservative: a sustained 100ms error moves the limit by
+  // roughly a fifth of the pool per proportional term.
+  auto const kP = m_maxWorkers * 0.002;
+  auto const kI = m_maxWorkers * 0.0005;
+  auto const kD = 0.0;
+  m_pid = PIDController(dt, m_maxWorkers, m_minWorkers, kP, kI, kD);
+  m_pid.setStartingOutput(m_maxWorkers);
+}
+
+void AdmissionController::RecordQueueDelay(int64_t usec) {
+  queueDelayCounter()->addValue(usec);
+  queueDelaySampleCounter()->increment();
+}
+
+void AdmissionController::start() {
+  if (!RuntimeOption::ServerAdmissionControlEnable) return;
+  if (!m_stopped.exchange(false, std::memory_order_acq_rel)) return;
+  m_thread = std::make_unique<std::thread>([this] {
+    folly::setThreadName("AdmissionCtrl");
+    run();
+  });
+}
+
+void AdmissionController::stop() {
+  if (m_stopped.exchange(true, std::memory_order_acq_rel)) return;
+  {
+    std::unique_lock<std::mutex> guard(m_condvar_lock);
+    m_condition.notify_one();
+  }
+  if (m_thread) {
+    m_thread->join();
+    m_thread.reset();
+  }
+  // Let shutdown drain at full concurrency.
+  s_shedding.store(false, std::memory_order_release);
+  m_server->updateMaxActiveWorkers(m_maxWorkers);
+}
+
+void AdmissionController::run() {
+  Logger::Info("Admission controller starts working.");
+  std::unique_lock<std::mutex> guard(m_condvar_lock);
+  std::chrono::milliseconds dura(RuntimeOption::ServerAdmissionUpdatePeriodMs);
+  while (!m_stopped.load(std::memory_order_acquire)) {
+    m_condition.wait_for(guard, dura, [this] { return shouldWakeup(); });
+    if (m_stopped.load(std::memory_order_acquire)) break;
+    tick();
+  }
+  Logger::Info("Admission controller exits.");
+}
+
+void AdmissionController::tick() {
+  auto const delayUsec = queueDelayCounter()->getValue();
+  auto const samples = queueDelaySampleCounter()->getValue();
+  double avgDelayMs = 0.0;
+  if (samples > m_lastSamples) {
+    avgDelayMs = (delayUsec - m_lastDelayUsec) /
+      (1000.0 * (samples - m_lastSamples));
+  }
+  m_lastDelayUsec = delayUsec;
+  m_lastSamples = samples;
+
+  // When delay is above the target the error is negative and the controller
+  // lowers the number of workers allowed to run at once (and vice versa);
+  // oversubscribed workers only make each other slower.
+  auto allowed = static_cast<int>(
+    m_pid.determineOutput(RuntimeOption::ServerAdmissionTargetQueueDelayMs,
+                          avgDelayMs));
+
+  // Cap concurrency by host health, one step per level below Bold.
+  auto const level = m_server->getHealthLevel();
+  auto const numLevels = static_cast<int>(HealthLevel::NumLevels);
+  auto const ceiling = static_cast<int>(
+    m_maxWorkers * (numLevels - healthLevelToInt(level)) / numLevels);
+  allowed = std::min(allowed, std::max(ceiling, m_minWorkers));
+  allowed = std::max(allowed, m_minWorkers);
+  m_server->updateMaxActiveWorkers(allowed);
+  ServiceData::createCounter("admission.allowed_workers")->setValue(allowed);
+
+  auto const shed =
+    avgDelayMs >= RuntimeOption::ServerAdmissionShedQueueDelayMs ||
+    level >= HealthLevel::BackOff;
+  if (shed != s_shedding.load(std::memory_order_acquire)) {
+    Logger::Warning("Admission controller %s shedding load "
+                    "(avg queueing delay %.1fms, health level %d).",
+                    shed ? "started" : "stopped",
+                    avgDelayMs, healthLevelToInt(level));
+    s_shedding.store(shed, std::memory_order_release);
+  }
+}
+
+}
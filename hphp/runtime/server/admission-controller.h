@@ -0,0 +1,94 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010-present Facebook, Inc. (http://www.facebook.com)  |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "hphp/util/pidcontroller.h"
+
+namespace HPHP {
+
+struct Server;
+
+/*
+ * Adaptive admission control for the page server.
+ *
+ * A background thread periodically measures the average time requests spent
+ * in the dispatcher queue (fed by RecordQueueDelay() from the worker side)
+ * and runs a PID controller on the number of workers allowed to be active at
+ * once, so that queueing delay converges on
+ * Server.Admission.TargetQueueDelayMs instead of growing without bound when
+ * the box is oversubscribed.  The allowed concurrency is further capped
+ * based on the host health level the page server already receives from
+ * HostHealthMonitor: the less healthy the host, the lower the ceiling.
+ *
+ * When the measured delay exceeds Server.Admission.ShedQueueDelayMs (or the
+ * host reaches BackOff), ShouldShed() starts returning true and
+ * HttpRequestHandler rejects new requests with a cheap 429 before doing any
+ * real work, which costs far less than letting them age out of the queue
+ * into a 503.
+ *
+ * Disabled unless Server.Admission.Enable is set.
+ */
+struct AdmissionController {
+  explicit AdmissionController(Server* server);
+
+  void start();
+  void stop();
+
+  // Record how long a request sat in the dispatcher queue before a worker
+  // picked it up.  Called once per request on worker threads.
+  static void RecordQueueDelay(int64_t usec);
+
+  // Whether new requests should be rejected early with a 429.
+  static bool ShouldShed() {
+    return s_shedding.load(std::memory_order_acquire);
+  }
+
+ private:
+  void run();
+  void tick();
+  // true if the controller thread should wake up immediately, used with the
+  // condition variable.
+  bool shouldWakeup() const {
+    return m_stopped.load(std::memory_order_acquire);
+  }
+
+  Server* m_server;
+  PIDController m_pid;
+  int m_maxWorkers;
+  int m_minWorkers;
+
+  // Snapshots of the queue-delay counters at the last tick, so each tick
+  // only looks at the delta.
+  int64_t m_lastDelayUsec{0};
+  int64_t m_lastSamples{0};
+
+  static std::atomic<bool> s_shedding;
+
+  std::mutex m_condvar_lock;
+  std::condition_variable m_condition;
+  std::atomic_bool m_stopped{true};
+  std::unique_ptr<std::thread> m_thread;
+};
+
+}
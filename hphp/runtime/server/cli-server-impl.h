@@ -50,4 +50,7 @@ void cli_read(int afdt_fd, Args&&... args) {
 int cli_read_fd(int afdt_fd);
 void cli_write_fd(int afdt_fd, int fd);
 
+void cli_read_fds(int afdt_fd, int* fds, size_t count);
+void cli_write_fds(int afdt_fd, const int* fds, size_t count);
+
 }
@@ -65,9 +65,11 @@ side logic to extract the startup parameters from the client, manipulate the
 ExecutionContext, and ultimately start the request via hphp_invoke.
 
 Before beginning execution the doJob routine reads information from the client
-over its unix socket. Most importantly it receives the client's stdin, stdout,
-and stderr file-descriptors, a file-descriptor to communicate with the client's
-light process pool, the command line arguments, and a JSON blob of INI settings.
+over its unix socket. The setup arrives as two messages: a single batched
+message containing the cwd, a JSON blob of INI settings, the command line
+arguments, and the environment, followed by a single ancillary message
+carrying the client's stdin, stdout, and stderr file-descriptors along with a
+file-descriptor to communicate with the client's light process pool.
 
 The setup performed in doJob resembles normal command line execution. Notably,
 however, the PHP_INI_USER options are read from the client as a JSON string and
@@ -190,7 +192,7 @@ namespace {
  *
  * ===== WARNING ===== WARNING ===== WARNING ===== WARNING ===== WARNING =====
  */
-const uint32_t CLI_SERVER_API_BASE_VERSION = 6;
+const uint32_t CLI_SERVER_API_BASE_VERSION = 7;
 std::atomic<uint64_t> s_cliServerComputedVersion(0);
 
 const StaticString s_hphp_cli_server_api_version("hphp.cli_server_api_version");
@@ -278,6 +280,22 @@ void cli_write_fd(int afdt_fd, int fd) {
   }
 }
 
+void cli_read_fds(int afdt_fd, int* fds, size_t count) {
+  FTRACE(4, "cli_read_fds({}, count={})\n", afdt_fd, count);
+  if (!afdt::recv_fds(afdt_fd, fds, count)) {
+    throw Exception("Failed in afdt::recv_fds: %s",
+                    folly::errnoStr(errno).c_str());
+  }
+}
+
+void cli_write_fds(int afdt_fd, const int* fds, size_t count) {
+  FTRACE(4, "cli_write_fds({}, count={})\n", afdt_fd, count);
+  if (!afdt::send_fds(afdt_fd, fds, count)) {
+    throw Exception("Failed in afdt::send_fds: %s",
+                    folly::errnoStr(errno).c_str());
+  }
+}
+
 namespace {
 
 #ifdef SCM_CREDENTIALS
@@ -824,8 +842,8 @@ Array init_cli_globals(int argc, char** argv, int xhprof, Array& ini,
 }
 
 struct RemoteFile final {
-  explicit RemoteFile(int client, const char* name, const char* mode) {
-    fd =  cli_read_fd(client);
+  RemoteFile(int client, int remote_fd, const char* name, const char* mode) {
+    fd = remote_fd;
     file = fdopen(fd, mode);
     FTRACE(2, "CLIWorker::doJob({}): {} = {}\n", client, name, fd);
   }
@@ -914,29 +932,30 @@ void CLIWorker::doJob(int client) {
     // Throw if the client is not authorized to access the CLI server
     check_cli_server_access(uc);
 
+    // The entire invocation setup arrives as a single batched message
+    // followed by one SCM_RIGHTS transfer carrying all four descriptors.
     std::string magic;
-    cli_read(client, magic);
+    std::string cwd;
+    std::string iniSettings;
+    int xhprofFlags;
+    std::vector<std::string> args;
+    std::vector<std::string> env;
+    cli_read(client, magic, cwd, iniSettings, xhprofFlags, args, env);
+
     FTRACE(2, "CLIWorker::doJob({}): magic = {}\n", client, magic);
     if (magic != "hello_server") {
       throw Exception("Got bad magic from client: %s", magic.c_str());
     }
 
-    std::string cwd;
-    cli_read(client, cwd);
     FTRACE(1, "CLIWorker::doJob({}): cwd = {}\n", client, cwd);
 
-    std::string iniSettings;
-    cli_read(client, iniSettings);
-
-    RemoteFile cli_in(client, "stdin", "r");
-    RemoteFile cli_out(client, "stdout", "w");
-    RemoteFile cli_err(client, "stderr", "w");
-    RemoteFile cli_afdt(client, "afdt", "rw");
+    int fds[4];
+    cli_read_fds(client, fds, 4);
 
-    int xhprofFlags;
-    std::vector<std::string> args;
-    std::vector<std::string> env;
-    cli_read(client, xhprofFlags, args, env);
+    RemoteFile cli_in(client, fds[0], "stdin", "r");
+    RemoteFile cli_out(client, fds[1], "stdout", "w");
+    RemoteFile cli_err(client, fds[2], "stderr", "w");
+    RemoteFile cli_afdt(client, fds[3], "afdt", "rw");
 
     FTRACE(2, "CLIWorker::doJob({}): xhprofFlags = {}\n", client, xhprofFlags);
     FTRACE(2, "CLIWorker::doJob({}): args = \n", client);
@@ -1631,11 +1650,9 @@ Optional<int> run_client(const char* sock_path,
 
   try {
     cli_write_ucred(fd);
-    cli_write(fd, "hello_server");
 
     char cwd[PATH_MAX];
     getcwd(cwd, PATH_MAX);
-    cli_write(fd, cwd);
 
     zend_get_bigint_data();
     tl_heap.getCheck()->init();
@@ -1646,17 +1663,16 @@ Optional<int> run_client(const char* sock_path,
     ExtensionRegistry::cliClientInit();
 
     auto settings = IniSetting::GetAllAsJSON();
-    cli_write(fd, settings);
 
-    FTRACE(2, "run_command_on_cli_server(): sending fds...\n", fd);
+    // Batch the whole invocation setup into a single message, followed by
+    // one ancillary message carrying all of our descriptors, rather than
+    // paying a syscall (and a server-side wakeup) per field.
+    FTRACE(2, "run_command_on_cli_server(): sending setup...\n", fd);
+    cli_write(fd, "hello_server", cwd, settings, 0, args, env_vec);
 
-    cli_write_fd(fd, fileno(stdin));
-    cli_write_fd(fd, fileno(stdout));
-    cli_write_fd(fd, fileno(stderr));
-    cli_write_fd(fd, delegate);
+    int fds[] = { fileno(stdin), fileno(stdout), fileno(stderr), delegate };
+    cli_write_fds(fd, fds, 4);
 
-    FTRACE(2, "run_command_on_cli_server(): file/args...\n", fd);
-    cli_write(fd, 0, args, env_vec);
     return cli_process_command_loop(fd);
   } catch (const Exception& ex) {
     Logger::Error(
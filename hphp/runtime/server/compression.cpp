@@ -18,7 +18,11 @@
 
 #include <strings.h>
 
+#include <mutex>
+
+#include <folly/FileUtil.h>
 #include <folly/Random.h>
+#include <folly/Synchronized.h>
 
 #include "hphp/runtime/base/runtime-option.h"
 #include "hphp/runtime/base/ini-setting.h"
@@ -342,6 +346,40 @@ StringHolder BrotliResponseCompressor::compressResponse(
   return compressedData;
 }
 
+/*******************
+ * Zstd Dictionary *
+ *******************/
+
+namespace {
+folly::Synchronized<std::shared_ptr<const std::string>> s_zstdDictionary;
+}
+
+bool reloadZstdCompressionDictionary() {
+  auto const& path = RuntimeOption::ZstdCompressionDictionaryPath;
+  if (path.empty()) {
+    *s_zstdDictionary.wlock() = nullptr;
+    return true;
+  }
+  std::string contents;
+  if (!folly::readFile(path.c_str(), contents)) {
+    Logger::Error("Failed to read zstd dictionary from %s", path.c_str());
+    return false;
+  }
+  *s_zstdDictionary.wlock() =
+    std::make_shared<const std::string>(std::move(contents));
+  return true;
+}
+
+std::shared_ptr<const std::string> getZstdCompressionDictionary() {
+  static std::once_flag s_loadOnce;
+  std::call_once(s_loadOnce, [] {
+    if (!RuntimeOption::ZstdCompressionDictionaryPath.empty()) {
+      reloadZstdCompressionDictionary();
+    }
+  });
+  return s_zstdDictionary.copy();
+}
+
 /*************
  * Zstd Impl *
  *************/
@@ -368,6 +406,18 @@ ZstdCompressor* ZstdResponseCompressor::getCompressor() {
     IniSetting::Get(s_zstdCL, quality);
     auto compression_level = quality.asInt64Val();
 
+    // Per-route effort: longest configured URL prefix wins.
+    if (!RuntimeOption::ZstdCompressionLevelUrls.empty()) {
+      folly::StringPiece url(m_headers->getUrl());
+      size_t bestLen = 0;
+      for (auto const& kv : RuntimeOption::ZstdCompressionLevelUrls) {
+        if (kv.first.size() >= bestLen && url.startsWith(kv.first)) {
+          bestLen = kv.first.size();
+          compression_level = kv.second;
+        }
+      }
+    }
+
     Variant checksumRate;
     IniSetting::Get(s_zstdCR, checksumRate);
     auto checksum_rate = checksumRate.asInt64Val();
@@ -377,7 +427,8 @@ ZstdCompressor* ZstdResponseCompressor::getCompressor() {
     auto window_log = windowLog.asInt64Val();
 
     m_compressor = std::make_unique<ZstdCompressor>(
-        compression_level, folly::Random::oneIn(checksum_rate), window_log);
+        compression_level, folly::Random::oneIn(checksum_rate), window_log,
+        getZstdCompressionDictionary());
   }
 
   return m_compressor.get();
@@ -60,6 +60,21 @@ std::vector<CompressionEncodingParam> parseParams(const std::string& allParams);
  */
 bool acceptsEncoding(ITransportHeaders *headers, const char *encoding);
 
+/*
+ * Trained zstd dictionary shared by all zstd response compressors, loaded
+ * lazily from Server.ZstdCompressionDictionaryPath. Returns null when no
+ * dictionary is configured or loading failed.
+ */
+std::shared_ptr<const std::string> getZstdCompressionDictionary();
+
+/*
+ * Re-read the dictionary from disk so a retrained one can be picked up
+ * without a restart (admin: /reload-zstd-dictionary). In-flight streams
+ * keep the dictionary they started with. Returns false if the configured
+ * file could not be read; the previous dictionary stays in effect.
+ */
+bool reloadZstdCompressionDictionary();
+
 /**
  * The ResponseCompressor interface is an abstraction that different compression
  * schemes can implement to interface with the transport layer.
@@ -18,13 +18,16 @@
 #include <string>
 
 #include <folly/Conv.h>
+#include <folly/concurrency/ConcurrentHashMap.h>
 #include <folly/portability/SysTime.h>
 
 #include "hphp/util/arch.h"
 #include "hphp/util/logger.h"
 #include "hphp/util/stack-trace.h"
+#include "hphp/util/struct-log.h"
 #include "hphp/util/text-util.h"
 
+#include "hphp/runtime/base/array-data.h"
 #include "hphp/runtime/base/array-init.h"
 #include "hphp/runtime/base/array-iterator.h"
 #include "hphp/runtime/base/builtin-functions.h"
@@ -33,6 +36,7 @@
 #include "hphp/runtime/base/program-functions.h"
 #include "hphp/runtime/base/request-injection-data.h"
 #include "hphp/runtime/base/runtime-option.h"
+#include "hphp/runtime/base/static-string-table.h"
 #include "hphp/runtime/base/string-util.h"
 #include "hphp/runtime/base/zend-string.h"
 #include "hphp/runtime/base/zend-url.h"
@@ -153,8 +157,8 @@ const StaticString
   s_HTTP_("HTTP_"),
   s_forwardslash("/");
 
-static void PrepareEnv(Array& env, Transport *transport) {
-  // $_ENV
+static Array PrepareBaseEnv() {
+  auto env = empty_dict_array();
   process_env_variables(env);
   env.set(s_HPHP, 1);
   env.set(s_HHVM, 1);
@@ -169,6 +173,21 @@ static void PrepareEnv(Array& env, Transport *transport) {
     env.set(s_HHVM_ARCH, "arm");
     break;
   }
+  return env;
+}
+
+static void PrepareEnv(Array& env, Transport *transport) {
+  // $_ENV
+  if (RuntimeOption::ServerExecutionMode()) {
+    // The process environment doesn't change while the server is up, so
+    // build that portion once and share it copy-on-write; each request only
+    // pays for its own additions.
+    static ArrayData* baseEnv =
+      ArrayData::GetScalarArray(PrepareBaseEnv());
+    env = Array(baseEnv);
+  } else {
+    env = PrepareBaseEnv();
+  }
 
   bool isServer =
     RuntimeOption::ServerExecutionMode() && !is_cli_server_mode();
@@ -324,19 +343,31 @@ void HttpProtocol::PrepareRequestVariables(Array& request,
                                            const Array& post,
                                            const Array& cookie,
                                            const std::string& requestOrder) {
+  // When only one source array contributes (the common case), share it
+  // copy-on-write instead of copying per key; source keys were already
+  // normalized when those arrays were built.
+  auto const copyInto = [&](const Array& src) {
+    if (src.empty()) return;
+    if (request.empty()) {
+      request = src;
+      return;
+    }
+    CopyParams(request, src);
+  };
+
   for (const char& c : requestOrder) {
     switch(c) {
       case 'g':
       case 'G':
-        CopyParams(request, get);
+        copyInto(get);
         break;
       case 'p':
       case 'P':
-        CopyParams(request, post);
+        copyInto(post);
         break;
       case 'c':
       case 'C':
-        CopyParams(request, cookie);
+        copyInto(cookie);
         break;
     }
   }
@@ -473,6 +504,31 @@ bool HttpProtocol::PrepareCookieVariable(Array& cookie,
   }
 }
 
+/*
+ * Header names recur across requests, so intern the CGI-style HTTP_FOO_BAR
+ * key for each one instead of re-deriving it per request. The cache is
+ * capped so untrusted header names can't grow the static string table
+ * without bound; past the cap the key is computed the old way.
+ */
+static String NormalizedHeaderKey(const std::string& key) {
+  static folly::ConcurrentHashMap<std::string, StringData*> s_cache;
+  constexpr size_t kMaxCachedHeaderKeys = 1024;
+
+  auto const it = s_cache.find(key);
+  if (it != s_cache.cend()) {
+    return String(it->second);
+  }
+  auto normalizedKey = s_HTTP_ +
+                       string_replace(HHVM_FN(strtoupper)(key), s_dash,
+                                      s_underscore);
+  if (s_cache.size() < kMaxCachedHeaderKeys) {
+    auto const sd = makeStaticString(normalizedKey.get());
+    s_cache.insert(key, sd);
+    return String(sd);
+  }
+  return normalizedKey;
+}
+
 static void CopyHeaderVariables(Array& server,
                                 const HeaderMap& headers) {
   static std::atomic<int> badRequests(-1);
@@ -481,9 +537,7 @@ static void CopyHeaderVariables(Array& server,
   for (auto const& header : headers) {
     auto const& key = header.first;
     auto const& values = header.second;
-    auto normalizedKey = s_HTTP_ +
-                         string_replace(HHVM_FN(strtoupper)(key), s_dash,
-                                        s_underscore);
+    auto normalizedKey = NormalizedHeaderKey(key);
 
     // Detect suspicious headers.  We are about to modify header names for
     // the SERVER variable.  This means that it is possible to deliberately
@@ -807,6 +861,26 @@ std::string HttpProtocol::RecordRequest(Transport *transport) {
     Logger::Info("request recorded in %s", tmpfile);
     return tmpfile;
   }
+  // Sample live traffic into a replayable warmup corpus (see
+  // Server.WarmupCorpusDir). These recordings are kept regardless of how
+  // the request finishes, so they are not returned for ClearRecord().
+  if (RuntimeOption::ServerRequestRecordSampleRate > 0 &&
+      !RuntimeOption::ServerRequestRecordDir.empty() &&
+      StructuredLog::coinflip(RuntimeOption::ServerRequestRecordSampleRate)) {
+    auto const path =
+      RuntimeOption::ServerRequestRecordDir + "/request_XXXXXX.hdf";
+    if (path.size() <= PATH_MAX) {
+      strcpy(tmpfile, path.c_str());
+      // Keep the .hdf suffix: the warmup player only picks up .hdf files.
+      auto const fd = mkstemps(tmpfile, 4);
+      if (fd >= 0) {
+        close(fd);
+        ReplayTransport rt;
+        rt.recordInput(transport, tmpfile);
+        Logger::Verbose("request sampled into %s", tmpfile);
+      }
+    }
+  }
   return "";
 }
 
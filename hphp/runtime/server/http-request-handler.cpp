@@ -31,6 +31,7 @@
 #include "hphp/runtime/ext/server/ext_server.h"
 #include "hphp/runtime/ext/std/ext_std_function.h"
 #include "hphp/runtime/server/access-log.h"
+#include "hphp/runtime/server/admission-controller.h"
 #include "hphp/runtime/server/files-match.h"
 #include "hphp/runtime/server/http-protocol.h"
 #include "hphp/runtime/server/request-uri.h"
@@ -39,6 +40,7 @@
 #include "hphp/runtime/server/static-content-cache.h"
 #include "hphp/runtime/vm/debugger-hook.h"
 #include "hphp/runtime/vm/treadmill.h"
+#include "hphp/runtime/vm/workload-stats.h"
 
 #include "hphp/util/alloc.h"
 #include "hphp/util/hardware-counter.h"
@@ -129,10 +131,13 @@ HttpRequestHandler::HttpRequestHandler(int timeout)
     : RequestHandler(timeout), m_pathTranslation(true)
     , m_requestTimedOutOnQueue(ServiceData::createTimeSeries(
                                  "requests_timed_out_on_queue",
-                                 {ServiceData::StatsType::COUNT})) { }
+                                 {ServiceData::StatsType::COUNT}))
+    , m_requestShedOnQueue(ServiceData::createTimeSeries(
+                             "requests_shed_on_queue",
+                             {ServiceData::StatsType::COUNT})) { }
 
 void HttpRequestHandler::sendStaticContent(Transport *transport,
-                                           const char *data, int len,
+                                           StringHolder&& body,
                                            time_t mtime,
                                            bool compressed,
                                            const std::string &cmd,
@@ -190,7 +195,7 @@ void HttpRequestHandler::sendStaticContent(Transport *transport,
   // should not attempt to compress it.
   transport->disableCompression();
 
-  transport->sendRaw(data, len, 200, compressed);
+  transport->sendRaw(std::move(body), 200, compressed);
   transport->onSendEnd();
 }
 
@@ -261,21 +266,30 @@ void HttpRequestHandler::handleRequest(Transport *transport) {
     return;
   }
 
+  timespec now;
+  Timer::GetMonotonicTime(now);
+  auto const queuedUsec = gettime_diff_us(transport->getQueueTime(), now);
+  AdmissionController::RecordQueueDelay(queuedUsec);
+
   // don't serve the request if it's been sitting in queue for longer than our
   // allowed request timeout.
   int requestTimeoutSeconds =
     vhost->getRequestTimeoutSeconds(getDefaultTimeout());
-  if (requestTimeoutSeconds > 0) {
-    timespec now;
-    Timer::GetMonotonicTime(now);
-    const timespec& queueTime = transport->getQueueTime();
-
-    if (gettime_diff_us(queueTime, now) > requestTimeoutSeconds * 1000000LL) {
-      transport->sendString("Service Unavailable", 503);
-      transport->onSendEnd();
-      m_requestTimedOutOnQueue->addValue(1);
-      return;
-    }
+  if (requestTimeoutSeconds > 0 &&
+      queuedUsec > requestTimeoutSeconds * 1000000LL) {
+    transport->sendString("Service Unavailable", 503);
+    transport->onSendEnd();
+    m_requestTimedOutOnQueue->addValue(1);
+    return;
+  }
+
+  // Shed load early with a cheap 429 when the admission controller has
+  // decided the box is falling behind; see admission-controller.h.
+  if (AdmissionController::ShouldShed()) {
+    transport->sendString("Too Many Requests", 429);
+    transport->onSendEnd();
+    m_requestShedOnQueue->addValue(1);
+    return;
   }
 
   ServerStats::StartRequest(transport->getCommand().c_str(),
@@ -330,20 +344,20 @@ void HttpRequestHandler::handleRequest(Transport *transport) {
     bool compressed = acceptsPrecompressed;
     // check against static content cache
     if (StaticContentCache::TheCache.find(path, data, len, compressed)) {
-      ScopedMem decompressed_data;
+      // The cache only hands back a gzipped variant to clients that can
+      // use it, unless decompression failed outright.
+      if (compressed && !acceptsPrecompressed) {
+        raise_fatal_error("cannot unzip compressed data");
+      }
       // (qigao) not calling stat at this point because the timestamp of
       // local cache file is not valuable, maybe misleading. This way
       // the Last-Modified header will not show in response.
       // stat(RuntimeOption::FileCache.c_str(), &st);
-      if (!acceptsPrecompressed && compressed) {
-        data = gzdecode(data, len);
-        if (data == nullptr) {
-          raise_fatal_error("cannot unzip compressed data");
-        }
-        decompressed_data = const_cast<char*>(data);
-        compressed = false;
-      }
-      sendStaticContent(transport, data, len, 0, compressed, path, ext);
+      // Cache entries live for the rest of the process, so the response
+      // path may reference them directly without copying.
+      sendStaticContent(transport,
+                        StringHolder(data, len, FreeType::Persistent),
+                        0, compressed, path, ext);
       ServerStats::LogPage(path, 200);
       return;
     }
@@ -551,6 +565,12 @@ bool HttpRequestHandler::executePHPRequest(Transport *transport,
                                      transport->getWallTime(),
                                      entry,
                                      false /*psp*/);
+  if (RuntimeOption::EvalProfileHWPerEndpoint) {
+    HardwareCounter::RecordEndpointEvents(transport->getCommand());
+  }
+  if (RuntimeOption::EvalProfileWorkloadPerEndpoint) {
+    WorkloadStats::SetEndpoint(transport->getCommand());
+  }
   if (entry) {
     StructuredLog::log("hhvm_request_perf", *entry);
     transport->resetStructuredLogEntry();
@@ -622,8 +642,9 @@ bool HttpRequestHandler::handleFileRequest(Transport* transport,
       }
       ::close(fd);
       buffer[len] = 0;
-      sendStaticContent(transport, buffer, len, stat_buf.st_mtime,
-                        false, path, ext);
+      sendStaticContent(transport,
+                        StringHolder(buffer, len, FreeType::Free),
+                        stat_buf.st_mtime, false, path, ext);
       ServerStats::LogPage(path, 200);
       return true;
     }
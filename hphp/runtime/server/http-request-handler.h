@@ -21,6 +21,7 @@
 #include "hphp/runtime/server/access-log.h"
 #include "hphp/runtime/server/server.h"
 #include "hphp/runtime/server/source-root-info.h"
+#include "hphp/util/string-holder.h"
 
 namespace HPHP {
 
@@ -58,12 +59,13 @@ public:
 private:
   bool m_pathTranslation;
   ServiceData::ExportedTimeSeries* m_requestTimedOutOnQueue;
+  ServiceData::ExportedTimeSeries* m_requestShedOnQueue;
   Optional<SourceRootInfo> m_sourceRootInfo;
 
   bool handleFileRequest(Transport *transport, const String& translated,
                          const std::string& path, const char* ext);
   bool handleProxyRequest(Transport *transport, bool force);
-  void sendStaticContent(Transport *transport, const char *data, int len,
+  void sendStaticContent(Transport *transport, StringHolder&& body,
                          time_t mtime, bool compressed,
                          const std::string &cmd,
                          const char *ext);
@@ -28,6 +28,7 @@
 #include "hphp/runtime/ext/apc/ext_apc.h"
 #include "hphp/runtime/ext/server/ext_server.h"
 #include "hphp/runtime/server/admin-request-handler.h"
+#include "hphp/runtime/server/admission-controller.h"
 #include "hphp/runtime/server/http-request-handler.h"
 #include "hphp/runtime/server/memory-stats.h"
 #include "hphp/runtime/server/replay-transport.h"
@@ -152,6 +153,11 @@ HttpServer::HttpServer() {
       RuntimeOption::RequestTimeoutSeconds);
   }
 
+  if (RuntimeOption::ServerAdmissionControlEnable) {
+    m_admissionController =
+      std::make_unique<AdmissionController>(m_pageServer.get());
+  }
+
   if (RuntimeOption::EnableSSL) {
     assertx(SSLInit::IsInited());
     m_pageServer->enableSSL(RuntimeOption::SSLPort);
@@ -229,6 +235,10 @@ void HttpServer::onServerShutdown() {
   static std::atomic_flag flag = ATOMIC_FLAG_INIT;
   if (flag.test_and_set()) return;
 
+  // Stop adjusting worker limits; the remaining requests drain at full
+  // concurrency.
+  if (m_admissionController) m_admissionController->stop();
+
   SparseHeap::PrepareToStop();
 #ifdef USE_JEMALLOC
   shutdown_slab_managers();
@@ -361,6 +371,21 @@ void HttpServer::runOrExitProcess() {
 
   block_sync_signals_and_start_handler_thread();
 
+  // Replay a corpus of recorded production requests across a worker pool
+  // before the port opens, so JIT profiling and APC are primed by the time
+  // the box takes traffic. The corpus is typically captured on live boxes
+  // via Server.RequestRecordSampleRate.
+  if (!RuntimeOption::ServerWarmupCorpusDir.empty()) {
+    BootStats::Block timer("corpus warmup", true);
+    Logger::Info("replaying warmup corpus %s",
+                 RuntimeOption::ServerWarmupCorpusDir.c_str());
+    auto const threadCount =
+      std::max(RuntimeOption::ServerWarmupThreadCount,
+               RuntimeOption::ServerThreadCount);
+    InternalWarmupRequestPlayer{threadCount, true}
+      .runAfterDelay({RuntimeOption::ServerWarmupCorpusDir});
+  }
+
   ServerStats::Clear();                 // Clear stats from warmup requests
 
   if (RuntimeOption::ServerPort) {
@@ -369,6 +394,7 @@ void HttpServer::runOrExitProcess() {
       not_reached();
     }
     Logger::Info("page server started");
+    if (m_admissionController) m_admissionController->start();
   }
 
   StartTime = time(nullptr);
@@ -29,6 +29,8 @@
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
 
+struct AdmissionController;
+
 struct HttpServer : Synchronizable, TakeoverListener,
                     Server::ServerEventListener {
  public:
@@ -141,6 +143,7 @@ private:
 
   ServerPtr m_pageServer;
   ServerPtr m_adminServer;
+  std::unique_ptr<AdmissionController> m_admissionController;
   std::vector<std::unique_ptr<SatelliteServer>> m_satellites;
   ServiceData::CounterCallback m_counterCallback;
 };
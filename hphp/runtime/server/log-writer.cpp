@@ -52,6 +52,9 @@ std::string FieldGenerator::escapeData(const char* s, int len) {
 }
 
 ClassicWriter::~ClassicWriter() {
+  // Drain and join the async write thread, if any, before closing the
+  // output file underneath it.
+  stopWriteThread();
   if (m_channel == LogChannel::REGULAR) {
     if (m_logdata.file[0] == '|') {
       pclose(m_filelog);
@@ -91,11 +94,13 @@ void ClassicWriter::init(const std::string& username,
       Logger::Error("Couldn't open access log file %s", m_logdata.file.c_str());
     }
   }
+  // The THREADLOCAL channel writes to per-thread files that only the
+  // owning request thread can reach, so it always stays synchronous.
+  if (m_channel != LogChannel::THREADLOCAL) startWriteThread();
 }
 
 void ClassicWriter::write(Transport* transport, const VirtualHost* vhost) {
-  auto outfile = getOutputFile();
-  if (!outfile) return;
+  if (!asyncEnabled() && !getOutputFile()) return;
   char c;
   std::ostringstream out;
   const auto* format = m_logdata.format.c_str();
@@ -126,6 +131,15 @@ void ClassicWriter::write(Transport* transport, const VirtualHost* vhost) {
   out << std::endl;
 
   auto str = out.str();
+  // Hand the line to the write thread; fall back to writing it here if
+  // async logging is off or the buffer is full.
+  if (enqueueLine(std::move(str))) return;
+  writeLine(str);
+}
+
+void ClassicWriter::writeLine(const std::string& str) {
+  auto outfile = getOutputFile();
+  if (!outfile) return;
   int nbytes = fwrite(str.data(), 1, str.size(), outfile);
   fflush(outfile);
 
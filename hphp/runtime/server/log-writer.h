@@ -47,6 +47,7 @@ struct ClassicWriter final : LogWriter {
   void write(Transport* transport, const VirtualHost* vhost) override;
   const static std::string handle;
 private:
+  void writeLine(const std::string& line) override;
   const AccessLogFileData m_logdata;
   static bool parseConditions(const char*& fmt, int code);
   static std::string parseArgument(const char*& fmt);
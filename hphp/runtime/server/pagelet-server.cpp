@@ -132,11 +132,19 @@ void PageletTransport::removeHeaderImpl(const char *name) {
 }
 
 void PageletTransport::sendImpl(const void* data, int size, int code,
-                                bool /*chunked*/, bool eom) {
-  m_response.append((const char*)data, size);
+                                bool chunked, bool eom) {
   if (code) {
     m_code = code;
   }
+  if (chunked && !eom && size > 0) {
+    // An intermediate flush (e.g. ob_flush in the pagelet). Hand the chunk
+    // to the waiting parent as a pipeline result right away - waking it and
+    // signaling its asio event - instead of buffering the whole response
+    // until the pagelet finishes.
+    addToPipeline(std::string((const char*)data, size));
+    return;
+  }
+  m_response.append((const char*)data, size);
   if (eom) {
     onSendEndImpl();
   }
@@ -17,6 +17,7 @@
 #include "hphp/runtime/server/proxygen/proxygen-server.h"
 #include <algorithm>
 #include <exception>
+#include <fnmatch.h>
 #include <memory>
 #include <thread>
 #include "hphp/runtime/server/fake-transport.h"
@@ -226,9 +227,18 @@ ProxygenServer::ProxygenServer(
                    options.m_initThreads,
                    options.m_hugeStackKb,
                    options.m_extraKb,
-                   options.m_legacyBehavior) {
+                   options.m_legacyBehavior,
+                   RuntimeOption::ServerThreadJobAgingMilliSeconds) {
   always_assert_flog(RuntimeOption::ServerIOThreadCount > 0,
                      "Proxygen must have at least 1 thread to function.");
+  if (RuntimeOption::ServerNormalPriorityMaxActiveRequests > 0) {
+    // Keep workers available for high-priority endpoints even when slow
+    // normal-priority requests saturate the pool; high-priority work can
+    // still spill over into every worker.
+    m_dispatcher.setMaxActiveForPriority(
+      PRIORITY_NORMAL,
+      RuntimeOption::ServerNormalPriorityMaxActiveRequests);
+  }
   for (int i = 0; i < RuntimeOption::ServerIOThreadCount; i++) {
     m_workers.emplace_back(
       std::make_unique<HPHPWorkerThread>(&m_eventBaseManager, this));
@@ -971,11 +981,18 @@ void ProxygenServer::decrementEnqueuedCount() {
 ProxygenServer::RequestPriority ProxygenServer::getRequestPriority(
   const char *uri) {
   auto const command = URL::getCommand(URL::getServerObject(uri));
-  if (RuntimeOption::ServerHighPriorityEndPoints.find(command) ==
+  if (RuntimeOption::ServerHighPriorityEndPoints.find(command) !=
       RuntimeOption::ServerHighPriorityEndPoints.end()) {
-    return PRIORITY_NORMAL;
+    return PRIORITY_HIGH;
+  }
+  // This runs on the IO threads, so the patterns are shell-style wildcards
+  // matched with fnmatch() rather than pcre.
+  for (auto const& pattern : RuntimeOption::ServerHighPriorityEndPointPatterns) {
+    if (fnmatch(pattern.c_str(), command.c_str(), 0) == 0) {
+      return PRIORITY_HIGH;
+    }
   }
-  return PRIORITY_HIGH;
+  return PRIORITY_NORMAL;
 }
 
 void ProxygenServer::onRequestError(Transport* transport) {
@@ -714,6 +714,45 @@ void ProxygenTransport::messageAvailable(ResponseMessage&& message) noexcept {
 void ProxygenTransport::sendImpl(const void *data, int size, int code,
                                  bool chunked, bool eom) {
   assertx(data);
+  sendImpl(
+    size > 0 ? folly::IOBuf::copyBuffer(data, size) : nullptr,
+    size, code, chunked, eom
+  );
+}
+
+void ProxygenTransport::sendImpl(StringHolder&& data, int code,
+                                 bool chunked, bool eom) {
+  // Only holders that own their buffer may be chained into the output
+  // queue: the response is sent from another thread, so borrowed memory
+  // could be reused by the request thread while proxygen still reads it.
+  // Persistent buffers (e.g. static content cache entries) outlive the
+  // process and can be referenced directly, with no copy and no free.
+  if (data.persistent() && data.size() > 0) {
+    auto const size = data.size();
+    sendImpl(folly::IOBuf::wrapBuffer(data.data(), size),
+             size, code, chunked, eom);
+    return;
+  }
+  if (data.owns() && data.size() > 0) {
+    auto const size = data.size();
+    auto holder = std::make_unique<StringHolder>(std::move(data));
+    auto chunk = folly::IOBuf::takeOwnership(
+      const_cast<char*>(holder->data()),
+      size,
+      [] (void* /*buf*/, void* userData) {
+        delete static_cast<StringHolder*>(userData);
+      },
+      holder.get()
+    );
+    holder.release();
+    sendImpl(std::move(chunk), size, code, chunked, eom);
+    return;
+  }
+  Transport::sendImpl(std::move(data), code, chunked, eom);
+}
+
+void ProxygenTransport::sendImpl(std::unique_ptr<folly::IOBuf> chunk,
+                                 int size, int code, bool chunked, bool eom) {
   assertx(!m_sendStarted || chunked);
   if (m_sendEnded) {
     // This should never happen, but when it does we have to bail out,
@@ -748,14 +787,14 @@ void ProxygenTransport::sendImpl(const void *data, int size, int code,
     m_response.dumpMessage(4);
     m_worker->putResponseMessage(
       ResponseMessage(shared_from_this(),
-                      ResponseMessage::Type::HEADERS, 0,
-                      chunked, data, size, eom));
+                      ResponseMessage::Type::HEADERS, std::move(chunk),
+                      chunked, eom));
     m_sendStarted = true;
   } else {
     m_worker->putResponseMessage(
       ResponseMessage(shared_from_this(),
-                      ResponseMessage::Type::BODY, 0,
-                      chunked, data, size, eom));
+                      ResponseMessage::Type::BODY, std::move(chunk),
+                      chunked, eom));
   }
 
   if (eom) {
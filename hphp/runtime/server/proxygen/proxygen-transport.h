@@ -56,11 +56,23 @@ struct ResponseMessage {
       m_chunked(chunked),
       m_eom(eom) {
     if (size > 0 && (m_type == Type::BODY || m_type == Type::HEADERS)) {
-        // sad panda copy.  TODO (t4362832): change sendImpl to take IOBuf
+        // sad panda copy.  Callers with an owned buffer should use the
+        // IOBuf constructor below instead.
         m_chunk = folly::IOBuf::copyBuffer(data, size);
       }
     };
 
+  // Takes a pre-built chunk (possibly wrapping caller-owned memory) without
+  // copying it.
+  explicit ResponseMessage(std::shared_ptr<ProxygenTransport> transport,
+                           Type t, std::unique_ptr<folly::IOBuf> chunk,
+                           bool chunked, bool eom)
+    : m_transport(transport),
+      m_type(t),
+      m_chunked(chunked),
+      m_chunk(std::move(chunk)),
+      m_eom(eom) {};
+
   ResponseMessage(ResponseMessage&& m) noexcept
   : m_transport(std::move(m.m_transport)),
     m_type(m.m_type),
@@ -185,6 +197,19 @@ struct ProxygenTransport final
   void sendImpl(const void *data, int size, int code,
                 bool chunked, bool eom) override;
 
+  /**
+   * Ownership-transfer variant: response buffers that own their memory are
+   * chained into the output queue without the copy above.
+   */
+  void sendImpl(StringHolder&& data, int code, bool chunked,
+                bool eom) override;
+
+  /**
+   * Common implementation for both sendImpl() flavors.
+   */
+  void sendImpl(std::unique_ptr<folly::IOBuf> chunk, int size, int code,
+                bool chunked, bool eom);
+
   /**
    * Override to implement more send end logic.
    */
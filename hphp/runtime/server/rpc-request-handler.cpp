@@ -384,6 +384,7 @@ bool RPCRequestHandler::executePHPFunction(Transport *transport,
     }
     if (ret) {
       bool serializeFailed = false;
+      bool sentLocally = false;
       String response;
       switch (output) {
         case 0: {
@@ -396,7 +397,12 @@ bool RPCRequestHandler::executePHPFunction(Transport *transport,
                 response = f_serialize(funcRet);
                 break;
               case ReturnEncodeType::Internal:
-                response = internal_serialize(funcRet);
+                // An in-process transport (xbox) may take the value itself
+                // and skip the serialize/unserialize round trip.
+                sentLocally = transport->sendLocalValue(funcRet);
+                if (!sentLocally) {
+                  response = internal_serialize(funcRet);
+                }
                 break;
             }
           } catch (...) {
@@ -422,6 +428,8 @@ bool RPCRequestHandler::executePHPFunction(Transport *transport,
         transport->sendString(
             "Serialization of the return value failed", 500);
         m_reset = true;
+      } else if (sentLocally) {
+        code = 200;
       } else {
         transport->sendRaw(response.data(), response.size());
         code = transport->getResponseCode();
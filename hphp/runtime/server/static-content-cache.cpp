@@ -16,9 +16,14 @@
 
 #include "hphp/runtime/server/static-content-cache.h"
 
+#include <utility>
+
+#include <folly/concurrency/ConcurrentHashMap.h>
+
 #include "hphp/runtime/base/runtime-option.h"
 #include "hphp/runtime/server/compression.h"
 #include "hphp/util/boot-stats.h"
+#include "hphp/util/gzip.h"
 #include "hphp/util/logger.h"
 #include "hphp/util/process.h"
 
@@ -28,6 +33,33 @@ namespace HPHP {
 StaticContentCache StaticContentCache::TheCache;
 std::shared_ptr<FileCache> StaticContentCache::TheFileCache;
 
+namespace {
+
+/*
+ * Alternate encodings of cached entries, produced at most once per file and
+ * keyed by name. Buffers are kept for the life of the process, so callers
+ * may reference them indefinitely (and the transport can send them without
+ * copying). A null buffer records that no useful variant exists, so we
+ * don't retry the conversion per response.
+ */
+using VariantMap =
+  folly::ConcurrentHashMap<std::string, std::pair<const char*, int>>;
+VariantMap s_decompressed;
+VariantMap s_recompressed;
+
+const std::pair<const char*, int>* insertVariant(VariantMap& map,
+                                                 const std::string& name,
+                                                 char* data, int len) {
+  auto const res = map.insert(name, std::make_pair(data, len));
+  if (!res.second && data) {
+    // Another thread produced the variant first; keep theirs.
+    free(data);
+  }
+  return &res.first->second;
+}
+
+}
+
 void StaticContentCache::load() {
   BootStats::Block timer("loading static content",
                          RuntimeOption::ServerExecutionMode());
@@ -44,10 +76,57 @@ void StaticContentCache::load() {
 
 bool StaticContentCache::find(const std::string &name, const char *&data,
                               int &len, bool &compressed) const {
-  if (TheFileCache) {
-    return (data = TheFileCache->read(name.c_str(), len, compressed));
+  if (!TheFileCache) {
+    return false;
+  }
+
+  bool const acceptsGzip = compressed;
+  if (!(data = TheFileCache->read(name.c_str(), len, compressed))) {
+    return false;
+  }
+  if (compressed == acceptsGzip) {
+    return true;
+  }
+
+  if (compressed) {
+    // The archive only holds a gzipped variant, but the client can't use
+    // it. Inflate once and remember the result rather than paying for the
+    // decompression on every response.
+    auto it = s_decompressed.find(name);
+    auto variant = it != s_decompressed.cend() ? &it->second : nullptr;
+    if (!variant) {
+      int plainLen = len;
+      auto const plain = gzdecode(data, plainLen);
+      variant = insertVariant(s_decompressed, name, plain, plainLen);
+    }
+    if (variant->first) {
+      data = variant->first;
+      len = variant->second;
+      compressed = false;
+    }
+    return true;
+  }
+
+  // The archive holds plain bytes and the client accepts gzip. Compress
+  // once and remember the result when it actually shrinks the payload.
+  auto it = s_recompressed.find(name);
+  auto variant = it != s_recompressed.cend() ? &it->second : nullptr;
+  if (!variant) {
+    int gzLen = len;
+    auto gz = gzencode(data, gzLen, RuntimeOption::GzipCompressionLevel,
+                       CODING_GZIP);
+    if (gz && gzLen >= len) {
+      free(gz);
+      gz = nullptr;
+    }
+    variant = insertVariant(s_recompressed, name, gz, gz ? gzLen : 0);
+  }
+  if (variant->first) {
+    data = variant->first;
+    len = variant->second;
+    compressed = true;
   }
-  return false;
+  return true;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -35,7 +35,11 @@ public:
   void load();
 
   /**
-   * Find a file from cache.
+   * Find a file from cache. On entry, "compressed" says whether the caller
+   * can use a gzipped variant; on return, whether the returned bytes are
+   * gzipped. Alternate encodings are produced at most once per file and
+   * kept for the life of the process, so the returned buffer may be
+   * referenced indefinitely.
    */
   bool find(const std::string &name, const char *&data, int &len,
             bool &compressed) const;
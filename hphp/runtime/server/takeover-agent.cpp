@@ -16,9 +16,16 @@
 
 #include "hphp/runtime/server/takeover-agent.h"
 #include "hphp/util/logger.h"
+#include "hphp/runtime/base/runtime-option.h"
 #include "hphp/runtime/base/string-util.h"
 #include "hphp/runtime/ext/string/ext_string.h"
+#include "hphp/runtime/vm/jit/prof-data.h"
+#include "hphp/runtime/vm/jit/prof-data-serialize.h"
+#include <folly/FileUtil.h>
+#include <folly/ScopeGuard.h>
 #include <folly/String.h>
+#include <fcntl.h>
+#include <unistd.h>
 #ifndef _MSC_VER
 #include <afdt.h>
 #endif
@@ -53,6 +60,9 @@
 #define C_TERM_OK  "\x05"
 #define C_TERM_BAD "\x06"
 #define C_UNKNOWN  "\x07"
+#define C_PROF_REQ  "\x08"
+#define C_PROF_RESP "\x09"
+#define C_PROF_BAD  "\x0a"
 
 namespace HPHP {
 
@@ -94,7 +104,8 @@ TakeoverAgent::TakeoverAgent(const std::string &fname)
 const StaticString
   s_ver_C_FD_REQ(P_VERSION C_FD_REQ),
   s_ver_C_TERM_REQ(P_VERSION C_TERM_REQ),
-  s_ver_C_TERM_OK(P_VERSION C_TERM_OK);
+  s_ver_C_TERM_OK(P_VERSION C_TERM_OK),
+  s_ver_C_PROF_REQ(P_VERSION C_PROF_REQ);
 
 int TakeoverAgent::afdtRequest(String request, String* response) {
 #ifdef _MSC_VER
@@ -132,6 +143,41 @@ int TakeoverAgent::afdtRequest(String request, String* response) {
     }
     Logger::Info("takeover: notification complete");
     return -1;
+  } else if (request == s_ver_C_PROF_REQ) {
+    Logger::Info("takeover: request is a jit profile request");
+    *response = P_VERSION C_PROF_BAD;
+    if (!RuntimeOption::ServerTakeoverProfileHandoff) {
+      Logger::Info("takeover: profile handoff is disabled");
+      return -1;
+    }
+    if (m_prof_fd >= 0) {
+      close(m_prof_fd);
+      m_prof_fd = -1;
+    }
+    if (jit::profData() != nullptr) {
+      // Serialize the current profile. This blocks the takeover event loop
+      // for a while, but the new binary is waiting on it during the push
+      // overlap window. The file is unlinked right away; the open fd is
+      // what travels to the new server.
+      auto const path = m_transfer_fname + ".profdata";
+      auto const errMsg = jit::serializeProfData(path);
+      if (errMsg.empty()) {
+        m_prof_fd = ::open(path.c_str(), O_RDONLY);
+      } else {
+        Logger::FError("takeover: serializeProfData failed: {}", errMsg);
+      }
+      unlink(path.c_str());
+    } else if (!RuntimeOption::EvalJitSerdesFile.empty()) {
+      // The profile was already discarded (e.g. after retranslateAll), so
+      // fall back to the serialized profile this server booted from.
+      m_prof_fd = ::open(RuntimeOption::EvalJitSerdesFile.c_str(), O_RDONLY);
+    }
+    if (m_prof_fd < 0) {
+      Logger::Warning("takeover: no jit profile available to hand over");
+      return -1;
+    }
+    *response = P_VERSION C_PROF_RESP;
+    return m_prof_fd;
   } else {
     Logger::Error("takeover: request is unrecognized");
     *response = P_VERSION C_UNKNOWN;
@@ -212,6 +258,75 @@ int TakeoverAgent::takeover(std::chrono::seconds timeoutSec) {
 #endif
 }
 
+bool TakeoverAgent::fetchJitProfile(const std::string& transferFname,
+                                    const std::string& destPath,
+                                    std::chrono::seconds timeoutSec) {
+#ifdef _MSC_VER
+  return false;
+#else
+  Logger::Info("takeover: requesting jit profile from old server");
+  uint8_t prof_request[3] = P_VERSION C_PROF_REQ;
+  uint8_t prof_response[3] = {0,0,0};
+  uint32_t response_len = sizeof(prof_response);
+  int fd = -1;
+  afdt_error_t err = AFDT_ERROR_T_INIT;
+  struct timeval timeout = { timeoutSec.count(), 0 };
+  int ret = afdt_sync_client(transferFname.c_str(),
+                             prof_request,
+                             sizeof(prof_request) - 1,
+                             prof_response,
+                             &response_len,
+                             &fd,
+                             &timeout,
+                             &err);
+  if (ret < 0) {
+    // No old server (or an old binary that doesn't speak this request);
+    // the caller falls back to whatever profile is on disk.
+    fd_transfer_error_handler(&err, nullptr);
+    return false;
+  }
+  if (fd < 0) {
+    String resp((const char*)prof_response, response_len, CopyString);
+    Logger::FInfo("takeover: old server has no jit profile to hand over "
+                  "(response = '{}')",
+                  HHVM_FN(addcslashes)(resp, null_string).data());
+    return false;
+  }
+  SCOPE_EXIT { close(fd); };
+
+  // Write the received profile next to its final name, then rename it into
+  // place so the deserialization path never sees a partial file.
+  auto const tmpPath = destPath + ".takeover";
+  int out = ::open(tmpPath.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0600);
+  if (out < 0) {
+    Logger::FError("takeover: unable to open {}: {}",
+                   tmpPath, folly::errnoStr(errno));
+    return false;
+  }
+  lseek(fd, 0, SEEK_SET);
+  bool ok = true;
+  char buf[64 << 10];
+  ssize_t nread;
+  while ((nread = folly::readNoInt(fd, buf, sizeof(buf))) > 0) {
+    if (folly::writeFull(out, buf, nread) != nread) {
+      ok = false;
+      break;
+    }
+  }
+  if (nread < 0) ok = false;
+  ok = (close(out) == 0) && ok;
+  if (ok) ok = (rename(tmpPath.c_str(), destPath.c_str()) == 0);
+  if (!ok) {
+    Logger::FError("takeover: failed writing jit profile to {}: {}",
+                   destPath, folly::errnoStr(errno));
+    unlink(tmpPath.c_str());
+    return false;
+  }
+  Logger::FInfo("takeover: received jit profile into {}", destPath);
+  return true;
+#endif
+}
+
 void TakeoverAgent::requestShutdown() {
 #ifndef _MSC_VER
   if (m_took_over) {
@@ -259,6 +374,11 @@ void TakeoverAgent::stop() {
     afdt_close_server(m_delete_handle);
   }
 
+  if (m_prof_fd >= 0) {
+    close(m_prof_fd);
+    m_prof_fd = -1;
+  }
+
   // If we're doing takeover, we don't want to gracefully close the
   // socket. If the takeover was fully completed the socket should
   // already be closed. On the other hand if the takeover was started,
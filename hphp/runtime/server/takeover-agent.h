@@ -63,6 +63,14 @@ struct TakeoverAgent {
   // execute a takeover and return the fd.  -1 if an fd could not be acquired
   int takeover(std::chrono::seconds timeout = std::chrono::seconds(2));
 
+  // From a newly started process, ask the old server listening on
+  // 'transferFname' to hand over its serialized JIT profile, and write the
+  // received contents to 'destPath' (atomically, via rename). Returns true
+  // on success. Requires Server.TakeoverProfileHandoff on the old server.
+  static bool fetchJitProfile(const std::string& transferFname,
+                              const std::string& destPath,
+                              std::chrono::seconds timeout);
+
   // instruct the old server to shutdown
   void requestShutdown();
 
@@ -107,6 +115,10 @@ protected:
   // Target socket
   int m_sock{-1};
 
+  // Serialized JIT profile handed over to a new server; afdt does not close
+  // fds it sends, so we keep it here and close it ourselves.
+  int m_prof_fd{-1};
+
   // User callback for events
   Callback *m_callback{nullptr};
 };
@@ -728,7 +728,7 @@ bool Transport::isCompressionEnabled() {
   return getCompressor().isEnabled();
 }
 
-void Transport::sendRaw(const char *data, int size, int code /* = 200 */,
+void Transport::sendRaw(StringHolder&& data, int code /* = 200 */,
                         bool precompressed /* = false */,
                         bool chunked /* = false */,
                         const char *codeInfo /* = nullptr */
@@ -746,7 +746,7 @@ void Transport::sendRaw(const char *data, int size, int code /* = 200 */,
 
   // I don't think there is any need to send an empty chunk, other than sending
   // out headers earlier, which seems to be a useless feature.
-  if (size == 0 && (chunked || m_chunkedEncoding)) {
+  if (data.size() == 0 && (chunked || m_chunkedEncoding)) {
     return;
   }
 
@@ -757,14 +757,16 @@ void Transport::sendRaw(const char *data, int size, int code /* = 200 */,
     assertx(!precompressed);
   }
 
-  sendRawInternal(data, size, code, precompressed, codeInfo);
+  sendRawInternal(std::move(data), code, precompressed, codeInfo);
 }
 
-void Transport::sendRawInternal(const char *data, int size,
+void Transport::sendRawInternal(StringHolder&& holder,
                                 int code /* = 200 */,
                                 bool precompressed /* = false */,
                                 const char *codeInfo /* = nullptr */
                                ) {
+  auto const data = holder.data();
+  auto const size = static_cast<int>(holder.size());
 
   bool chunked = m_chunkedEncoding;
 
@@ -791,6 +793,11 @@ void Transport::sendRawInternal(const char *data, int size,
     disableCompression();
   }
   StringHolder response = compressResponse(data, size, !chunked);
+  if (response.data() == data) {
+    // The compressor passed the body through untouched; keep the original
+    // holder so its ownership (or persistence) travels with the response.
+    response = std::move(holder);
+  }
 
   if (m_responseCode < 0) {
     setResponse(code, codeInfo);
@@ -805,7 +812,7 @@ void Transport::sendRawInternal(const char *data, int size,
 
   m_responseSize += response.size();
   ServerStats::SetThreadMode(ServerStats::ThreadMode::Writing);
-  sendImpl(response.data(), response.size(), m_responseCode, chunked, false);
+  sendImpl(std::move(response), m_responseCode, chunked, false);
   ServerStats::SetThreadMode(ServerStats::ThreadMode::Processing);
 
   ServerStats::LogBytes(size);
@@ -820,10 +827,10 @@ void Transport::onSendEnd() {
   if (m_chunkedEncoding) {
     assertx(m_headerSent);
     StringHolder response = compressResponse("", 0, true);
-    sendImpl(response.data(), response.size(), m_responseCode, true, true);
+    sendImpl(std::move(response), m_responseCode, true, true);
     eomSent = true;
   } else if (!m_headerSent) {
-    sendRawInternal("", 0);
+    sendRawInternal(StringHolder("", 0, FreeType::NoFree));
   }
   auto httpResponseStats = ServiceData::createTimeSeries(
     folly::to<std::string>(HTTP_RESPONSE_STATS_PREFIX, getResponseCode()),
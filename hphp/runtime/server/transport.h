@@ -276,6 +276,19 @@ public:
   virtual void sendImpl(const void *data, int size, int code,
                         bool chunked, bool eom) = 0;
 
+  /**
+   * Variant of sendImpl() that offers the transport ownership of the
+   * response buffer. Transports able to chain the buffer into their output
+   * queue override this to avoid copying large payloads; the default just
+   * sends and lets the holder free it. Only holders that own their buffer
+   * can be used in place -- a non-owning holder borrows memory whose
+   * lifetime ends when the caller moves on.
+   */
+  virtual void sendImpl(StringHolder&& data, int code,
+                        bool chunked, bool eom) {
+    sendImpl(data.data(), data.size(), code, chunked, eom);
+  }
+
   /**
    * Override to implement more send end logic.
    */
@@ -399,10 +412,28 @@ public:
   const std::string &getResponseInfo() const { return m_responseCodeInfo; }
   bool headersSent() { return m_headerSent;}
   void sendRaw(const char *data, int size, int code = 200,
+               bool precompressed = false, bool chunked = false,
+               const char *codeInfo = nullptr) {
+    sendRaw(StringHolder(data, size, FreeType::NoFree), code, precompressed,
+            chunked, codeInfo);
+  }
+  // Variant that passes the body's ownership along: owned and persistent
+  // buffers can be sent without copying.
+  void sendRaw(StringHolder&& data, int code = 200,
                bool precompressed = false, bool chunked = false,
                const char *codeInfo = nullptr);
+
+  /**
+   * In-process transports (e.g. xbox) may accept the response value itself
+   * in lieu of a response body, sparing both sides a serialization round
+   * trip. Returns false if the transport has no in-process consumer or the
+   * value contains something that can't leave the request heap (objects,
+   * resources, circular data); the caller then sends the serialized
+   * response as usual.
+   */
+  virtual bool sendLocalValue(const Variant& /*value*/) { return false; }
 private:
-  void sendRawInternal(const char *data, int size, int code = 200,
+  void sendRawInternal(StringHolder&& data, int code = 200,
                        bool precompressed = false,
                        const char *codeInfo = nullptr);
 public:
@@ -17,7 +17,10 @@
 #include "hphp/runtime/server/xbox-server.h"
 #include "hphp/runtime/base/builtin-functions.h"
 #include "hphp/runtime/base/comparisons.h"
+#include "hphp/runtime/base/data-walker.h"
 #include "hphp/runtime/base/runtime-option.h"
+#include "hphp/runtime/base/tv-uncounted.h"
+#include "hphp/runtime/vm/treadmill.h"
 #include "hphp/runtime/server/rpc-request-handler.h"
 #include "hphp/runtime/server/satellite-server.h"
 #include "hphp/runtime/server/job-queue-vm-stack.h"
@@ -43,6 +46,15 @@ XboxTransport::XboxTransport(const folly::StringPiece message,
   disableCompression(); // so we don't have to decompress during sendImpl()
 }
 
+XboxTransport::~XboxTransport() {
+  if (m_hasLocalValue) {
+    // The consuming request holds the value without a refcount, so defer the
+    // release past every request that could still see it.
+    auto const tv = m_localValue;
+    Treadmill::enqueue([tv] { DecRefUncounted(tv); });
+  }
+}
+
 const char *XboxTransport::getUrl() {
   if (!m_reqInitDoc.empty()) {
     return "xbox_process_call_message";
@@ -67,6 +79,32 @@ void XboxTransport::sendImpl(const void* data, int size, int code,
   }
 }
 
+bool XboxTransport::sendLocalValue(const Variant& value) {
+  assertx(!m_hasLocalValue);
+
+  // Only hand over value shapes the uncounted machinery can represent:
+  // scalars, strings and arrays thereof. Objects, resources, pointers to
+  // request-local runtime structures and circular data fall back to the
+  // serialized response.
+  if (!value.isNull() && !value.isBoolean() && !value.isInteger() &&
+      !value.isDouble() && !value.isString() && !value.isArray()) {
+    return false;
+  }
+  if (value.isArray()) {
+    DataWalker walker(DataWalker::LookupFeature::DetectNonPersistable);
+    auto const features = walker.traverseData(value.getArrayData());
+    if (features.isCircular || features.hasNonPersistable) return false;
+  }
+
+  auto tv = *value.asTypedValue();
+  MakeUncountedEnv env{nullptr};
+  ConvertTvToUncounted(&tv, env);
+  m_localValue = tv;
+  m_hasLocalValue = true;
+  m_code = 200;
+  return true;
+}
+
 void XboxTransport::onSendEndImpl() {
   Lock lock(this);
   if (m_done) {
@@ -310,8 +348,16 @@ int XboxServer::TaskResult(XboxTransport *job, int timeout_ms, Variant *ret) {
   String response = job->getResults(code, timeout_ms);
   if (ret) {
     if (code == 200) {
-      *ret =
-        unserialize_from_string(response, VariableUnserializer::Type::Internal);
+      TypedValue local;
+      if (job->getLocalValue(local)) {
+        // Uncounted values need no refcounting from this request; the
+        // transport keeps them alive until it is destroyed, and release is
+        // treadmill-deferred past us.
+        *ret = Variant::wrap(local);
+      } else {
+        *ret = unserialize_from_string(response,
+                                       VariableUnserializer::Type::Internal);
+      }
     } else {
       *ret = response;
     }
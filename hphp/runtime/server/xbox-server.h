@@ -18,6 +18,7 @@
 
 #include "hphp/runtime/base/runtime-option.h"
 #include "hphp/runtime/base/type-string.h"
+#include "hphp/runtime/base/typed-value.h"
 #include "hphp/runtime/server/satellite-server.h"
 #include "hphp/runtime/server/server-task-event.h"
 #include "hphp/runtime/server/transport.h"
@@ -83,6 +84,7 @@ struct XboxTransport final : Transport, Synchronizable {
   explicit XboxTransport(
     const folly::StringPiece message,
     const folly::StringPiece reqInitDoc = "");
+  ~XboxTransport() override;
 
   timespec getStartTimer() const { return m_queueTime; }
 
@@ -120,6 +122,7 @@ struct XboxTransport final : Transport, Synchronizable {
   void sendImpl(const void *data, int size, int code, bool chunked, bool eom)
        override;
   void onSendEndImpl() override;
+  bool sendLocalValue(const Variant& value) override;
 
   /**
    * Get a description of the type of transport.
@@ -134,6 +137,18 @@ struct XboxTransport final : Transport, Synchronizable {
   bool isDone() { return m_done; }
   String getResults(int &code, int timeout_ms = 0);
 
+  /*
+   * Retrieve the response value handed over by sendLocalValue(), if any.
+   * Only meaningful after getResults() reported completion. The value is
+   * uncounted and stays valid until the transport is destroyed, which is
+   * treadmill-deferred past every request that can still see it.
+   */
+  bool getLocalValue(TypedValue& value) {
+    if (!m_hasLocalValue) return false;
+    value = m_localValue;
+    return true;
+  }
+
   void setHost(const std::string &host) { m_host = host;}
   void setAsioEvent(ServerTaskEvent<XboxServer, XboxTransport> *event) {
     m_event = event;
@@ -157,6 +172,10 @@ private:
 
   bool m_done;
   std::string m_response;
+  // Response value handed over in-process instead of through m_response;
+  // uncounted, owned by this transport.
+  TypedValue m_localValue;
+  bool m_hasLocalValue{false};
   int m_code;
   std::string m_host;
   std::string m_reqInitDoc;
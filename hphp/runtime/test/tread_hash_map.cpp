@@ -47,4 +47,30 @@ TEST(TreadHashMap, Iteration) {
   }
 }
 
+TEST(TreadHashMap, IncrementalGrowth) {
+  TreadHashMap<int64_t,int64_t,int64_hash> thm(8);
+
+  // Growth is incremental, so at any point some keys may still live in a
+  // partially drained older table; all of them must stay findable.
+  constexpr int kCount = 5000;
+  for (int i = 1; i <= kCount; ++i) {
+    thm.insert(i, -i);
+    EXPECT_EQ(*thm.find(i), -i);
+    EXPECT_EQ(*thm.find(1 + i / 2), -(1 + i / 2));
+  }
+  EXPECT_EQ(thm.size(), size_t(kCount));
+
+  thm.filter_keys([](int64_t key) { return key % 2 == 0; });
+  for (int i = 1; i <= kCount; ++i) {
+    auto const val = thm.find(i);
+    if (i % 2) {
+      ASSERT_NE(val, nullptr);
+      EXPECT_EQ(*val, -i);
+    } else {
+      EXPECT_EQ(val, nullptr);
+    }
+  }
+  EXPECT_EQ(thm.size(), size_t(kCount / 2));
+}
+
 }
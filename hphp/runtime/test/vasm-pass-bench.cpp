@@ -0,0 +1,159 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010-present Facebook, Inc. (http://www.facebook.com)  |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include "hphp/runtime/vm/jit/abi-x64.h"
+#include "hphp/runtime/vm/jit/containers.h"
+#include "hphp/runtime/vm/jit/vasm.h"
+#include "hphp/runtime/vm/jit/vasm-gen.h"
+#include "hphp/runtime/vm/jit/vasm-instr.h"
+#include "hphp/runtime/vm/jit/vasm-unit.h"
+
+#include <folly/portability/GTest.h>
+
+#include <chrono>
+#include <cstdlib>
+
+/*
+ * Compile-time benchmark for individual vasm passes.
+ *
+ * Each pass runs over synthetic units built from a repeated diamond
+ * pattern---straight-line arithmetic feeding a two-way branch that rejoins
+ * through a phi---which exercises the CFG walks, use-def chains, and phi
+ * handling that dominate pass runtimes on real translations. Per-pass wall
+ * times are printed on every run so compile-time can be tracked alongside
+ * runtime perf; setting VASM_BENCH_BUDGET_US additionally turns each
+ * measurement into a hard assertion for bisecting regressions.
+ */
+
+namespace HPHP { namespace jit {
+
+namespace {
+
+constexpr size_t kInstsPerBlock = 8;
+
+Vunit makeBenchUnit(size_t numDiamonds) {
+  Vunit unit;
+  unit.entry = unit.makeBlock(AreaIndex::Main, 1);
+  Vout v(unit, unit.entry);
+
+  auto val = v.cns(1);
+  for (size_t i = 0; i < numDiamonds; ++i) {
+    // Straight-line arithmetic with redundant copies for the copy and
+    // simplification passes to chew on.
+    for (size_t j = 0; j < kInstsPerBlock; ++j) {
+      auto const t1 = v.makeReg();
+      auto const t2 = v.makeReg();
+      v << copy{val, t1};
+      v << addq{t1, v.cns(i + j + 1), t2, v.makeReg()};
+      val = t2;
+    }
+
+    auto const next  = unit.makeBlock(AreaIndex::Main, 1);
+    auto const taken = unit.makeBlock(AreaIndex::Cold, 1);
+    auto const join  = unit.makeBlock(AreaIndex::Main, 1);
+
+    auto const sf = v.makeReg();
+    v << cmpqi{0, val, sf};
+    v << jcc{CC_L, sf, {next, taken}};
+
+    Vout vn(unit, next);
+    auto const nval = vn.makeReg();
+    vn << copy{val, nval};
+    vn << phijmp{join, unit.makeTuple({nval})};
+
+    Vout vt(unit, taken);
+    auto const tval = vt.makeReg();
+    vt << addqi{1, val, tval, vt.makeReg()};
+    vt << phijmp{join, unit.makeTuple({tval})};
+
+    v = join;
+    auto const jval = v.makeReg();
+    v << phidef{unit.makeTuple({jval})};
+    val = jval;
+  }
+  v << ret{RegSet{}};
+  return unit;
+}
+
+template<typename Pass>
+void benchPass(const char* name, size_t numDiamonds, Pass pass) {
+  auto unit = makeBenchUnit(numDiamonds);
+  EXPECT_TRUE(check(unit));
+
+  auto const start = std::chrono::steady_clock::now();
+  pass(unit);
+  auto const elapsed = std::chrono::steady_clock::now() - start;
+
+  // Passes must leave the unit well-formed no matter what they did to it.
+  EXPECT_TRUE(check(unit));
+
+  auto const us =
+    std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+  printf("  %-24s %5zu diamonds  %8ld us\n", name, numDiamonds, long(us));
+
+  if (auto const budget = getenv("VASM_BENCH_BUDGET_US")) {
+    EXPECT_LE(us, atoll(budget)) << name << " blew its compile-time budget";
+  }
+}
+
+template<typename Pass>
+void benchSizes(const char* name, Pass pass) {
+  for (auto const numDiamonds : {size_t{16}, size_t{128}, size_t{512}}) {
+    benchPass(name, numDiamonds, pass);
+  }
+}
+
+}
+
+TEST(VasmBench, Simplify) {
+  benchSizes("simplify", [] (Vunit& u) { simplify(u); });
+}
+
+TEST(VasmBench, FuseBranches) {
+  benchSizes("fuseBranches", [] (Vunit& u) { fuseBranches(u); });
+}
+
+TEST(VasmBench, OptimizePhis) {
+  benchSizes("optimizePhis", [] (Vunit& u) { optimizePhis(u); });
+}
+
+TEST(VasmBench, OptimizeJmps) {
+  benchSizes("optimizeJmps", [] (Vunit& u) { optimizeJmps(u, false); });
+}
+
+TEST(VasmBench, RemoveDeadCode) {
+  benchSizes("removeDeadCode", [] (Vunit& u) { removeDeadCode(u); });
+}
+
+TEST(VasmBench, OptimizeCopies) {
+  benchSizes("optimizeCopies", [] (Vunit& u) {
+    optimizeCopies(u, x64::abi());
+  });
+}
+
+TEST(VasmBench, RegAllocXLS) {
+  benchSizes("allocateRegistersWithXLS", [] (Vunit& u) {
+    allocateRegistersWithXLS(u, x64::abi());
+  });
+}
+
+TEST(VasmBench, RegAllocGraphColor) {
+  benchSizes("allocateRegistersWithGraphColor", [] (Vunit& u) {
+    allocateRegistersWithGraphColor(u, x64::abi());
+  });
+}
+
+}}
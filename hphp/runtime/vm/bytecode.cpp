@@ -1642,7 +1642,8 @@ ArrayData* resolveAndVerifyTypeStructureHelper(
     }
   }
   return jit::resolveTypeStructHelper(n, values, declaringCls,
-                                      calledCls, suppress, isOrAsOp);
+                                      calledCls, suppress, isOrAsOp,
+                                      rds::kUninitHandle);
 }
 
 ALWAYS_INLINE Array maybeResolveAndErrorOnTypeStructure(
@@ -2715,6 +2716,13 @@ inline void checkThis(ActRec* fp) {
   }
 }
 
+// Whether this memoize wrapper may use the process-wide memo cache tier.
+ALWAYS_INLINE bool usePersistentMemoCache(const Func* func) {
+  assertx(func->isMemoizeWrapper());
+  return UNLIKELY(!!(func->attrs() & AttrPersistentMemoize)) &&
+         RuntimeOption::EvalPersistentMemoCache;
+}
+
 OPTBLD_INLINE const TypedValue* memoGetImpl(LocalRange keys) {
   auto const fp = vmfp();
   auto const func = fp->func();
@@ -2736,22 +2744,38 @@ OPTBLD_INLINE const TypedValue* memoGetImpl(LocalRange keys) {
         auto cache =
           lsbCls ? rds::bindLSBMemoCache(lsbCls, func)
                  : rds::bindStaticMemoCache(func);
-        if (!cache.isInit()) return nullptr;
         auto const keysBegin = frame_local(fp, keys.first + keys.count - 1);
-        if (auto getter = memoCacheGetForKeyCount(keys.count)) {
-          return getter(*cache, keysBegin);
+        if (cache.isInit()) {
+          auto const c = [&]() -> const TypedValue* {
+            if (auto getter = memoCacheGetForKeyCount(keys.count)) {
+              return getter(*cache, keysBegin);
+            }
+            return memoCacheGetGeneric(
+              *cache,
+              GenericMemoId{func->getFuncId(), keys.count}.asParam(),
+              keysBegin
+            );
+          }();
+          if (c) return c;
         }
-        return memoCacheGetGeneric(
-          *cache,
-          GenericMemoId{func->getFuncId(), keys.count}.asParam(),
-          keysBegin
-        );
+        if (usePersistentMemoCache(func)) {
+          assertx(!lsbCls);
+          return memoCacheGetPersistent(
+            func->getFuncId(), keysBegin, keys.count
+          );
+        }
+        return nullptr;
       }
 
       auto cache =
         lsbCls ? rds::bindLSBMemoValue(lsbCls, func)
                : rds::bindStaticMemoValue(func);
-      return cache.isInit() ? cache.get() : nullptr;
+      if (cache.isInit()) return cache.get();
+      if (usePersistentMemoCache(func)) {
+        assertx(!lsbCls);
+        return memoCacheGetPersistent(func->getFuncId(), nullptr, 0);
+      }
+      return nullptr;
     }
 
     checkThis(fp);
@@ -2862,14 +2886,20 @@ OPTBLD_INLINE void memoSetImpl(LocalRange keys, TypedValue val) {
       if (!cache.isInit()) cache.initWith(nullptr);
       auto const keysBegin = frame_local(fp, keys.first + keys.count - 1);
       if (auto setter = memoCacheSetForKeyCount(keys.count)) {
-        return setter(*cache, keysBegin, val);
+        setter(*cache, keysBegin, val);
+      } else {
+        memoCacheSetGeneric(
+          *cache,
+          GenericMemoId{func->getFuncId(), keys.count}.asParam(),
+          keysBegin,
+          val
+        );
       }
-      return memoCacheSetGeneric(
-        *cache,
-        GenericMemoId{func->getFuncId(), keys.count}.asParam(),
-        keysBegin,
-        val
-      );
+      if (usePersistentMemoCache(func)) {
+        assertx(!lsbCls);
+        memoCacheSetPersistent(func->getFuncId(), keysBegin, keys.count, val);
+      }
+      return;
     }
 
     auto cache =
@@ -2881,6 +2911,10 @@ OPTBLD_INLINE void memoSetImpl(LocalRange keys, TypedValue val) {
     }
 
     tvSetWithAux(val, *cache);
+    if (usePersistentMemoCache(func)) {
+      assertx(!lsbCls);
+      memoCacheSetPersistent(func->getFuncId(), nullptr, 0, val);
+    }
     return;
   }
 
@@ -5820,6 +5854,36 @@ PcPair run(TCA* returnaddr, ExecMode modes, rds::Header* tl, PC nextpc, PC pc,
   // return ip to jump to, caller will do jmp(rax)
   return lookup_cti(vmfp()->func(), pc);
 }
+
+// Execute two adjacent simple opcodes with one dispatch, then skip the
+// second opcode's callsite by bumping the return address. The second
+// callsite is still emitted by compile_cti(), so branches that enter
+// the pair in the middle (and lookup_cti's size interpolation) behave
+// exactly as if the pair were not fused.
+template<Op opA, Op opB, class IopA, class IopB>
+PcPair runFused(TCA* returnaddr, ExecMode modes, rds::Header* tl,
+                PC nextpc, PC pc, IopA iopA, IopB iopB) {
+  static_assert(isSimple(opA) && isSimple(opB),
+                "only simple opcodes can be fused");
+  assert(vmpc() == pc);
+  assert(peek_op(pc) == opA);
+  FTRACE(1, "dispatch: {}: {}\n", pcOff(),
+         instrToString(pc, vmfp()->func()));
+  pc += encoded_op_size(opA);
+  DEBUG_ONLY auto const retA = iopA(pc);
+  vmpc() = pc;
+  assert(!retA);
+  assert(peek_op(pc) == opB);
+  FTRACE(1, "dispatch: {}: {}\n", pcOff(),
+         instrToString(pc, vmfp()->func()));
+  pc += encoded_op_size(opB);
+  DEBUG_ONLY auto const retB = iopB(pc);
+  vmpc() = pc;
+  assert(!retB);
+  // caller ignores rax return value; resume past opB's callsite
+  *returnaddr += kCtiSimpleCallSize;
+  return {nullptr, pc};
+}
 }
 
 // register assignments inbetween calls to cti opcodes
@@ -5866,6 +5930,30 @@ PcPair d##opcode(PC nextpc, TCA*, PC pc) {\
 }
 OPCODES
 #undef O
+
+// The hottest pairs of adjacent simple opcodes in interpreted code,
+// by warmup-phase profile: argument setup for calls, loading operand
+// pairs, and type checks on a freshly loaded cell. compile_cti() emits
+// one call to the fused handler for the pair instead of two dispatches.
+#define CTI_FUSED_PAIRS\
+  X(NullUninit, NullUninit)\
+  X(CGetL,      CGetL)\
+  X(CGetL,      IsTypeC)
+
+// generate cti::opA_opB fused function for each hot pair (repo-auth only)
+#define X(opA, opB)\
+PcPair opA##_##opB(PC nextpc, TCA*, PC pc) {\
+  DECLARE_FIXED(tl, modes, returnaddr);\
+  return runFused<Op::opA,Op::opB>(returnaddr, modes, tl, nextpc, pc,\
+      [](PC& pc) {\
+    return iopWrap##opA<false>(pc);\
+  },\
+      [](PC& pc) {\
+    return iopWrap##opB<false>(pc);\
+  });\
+}
+CTI_FUSED_PAIRS
+#undef X
 }
 
 // generate table of opcode handler addresses, used by call-threaded emitter
@@ -5880,4 +5968,13 @@ const CodeAddress ctid_ops[] = {
   #undef O
 };
 
+CodeAddress cti_fused(Op a, Op b) {
+  #define X(opA, opB)\
+  if (a == Op::opA && b == Op::opB) return (CodeAddress)&cti::opA##_##opB;
+  CTI_FUSED_PAIRS
+  #undef X
+  return nullptr;
+}
+#undef CTI_FUSED_PAIRS
+
 }
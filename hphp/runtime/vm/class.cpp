@@ -1782,6 +1782,12 @@ void Class::setInstanceBitsImpl() {
   m_instanceBits = bits;
 }
 
+void Class::setInstanceBit(unsigned int bit) {
+  assertx(bit > 0 && bit < m_instanceBits.size());
+  assertx(m_instanceBits.test(0));
+  m_instanceBits.set(bit);
+}
+
 namespace {
 const ReifiedGenericsInfo k_defaultReifiedGenericsInfo{0, false, 0, {}};
 } // namespace
@@ -1312,6 +1312,13 @@ public:
   void setInstanceBitsAndParents();
   bool checkInstanceBit(unsigned int bit) const;
 
+  /*
+   * Set a single instance bit on this class, after the bits have already been
+   * published. Only for use by InstanceBits::refresh(), which assigns spare
+   * bits to classes that became hot after warmup.
+   */
+  void setInstanceBit(unsigned int bit);
+
   /*
    * Get the underlying enum base type if this is an enum.
    *
@@ -33,6 +33,7 @@ namespace {
 
 std::mutex g_mutex;
 size_t bc_total;
+size_t fused_total;
 thread_local std::vector<PcPair> tl_cti_cache;
 __thread size_t cc_lookups, cc_misses;
 
@@ -164,6 +165,21 @@ Offset compile_cti(Func* func, PC unitpc) {
         a.storeq(pc_arg, r12[rds::kVmpcOff]);
       }
     } else if (isSimple(op) || isThrow(op)) {
+      // If this opcode starts one of the hot fused pairs, call the fused
+      // handler instead; it executes both opcodes, then skips over the
+      // successor's callsite, which is still emitted below so that jump
+      // targets and lookup_cti() are unaffected by fusion.
+      if (RuntimeOption::RepoAuthoritative && !instrs.empty()) {
+        auto const nextop = peek_op(instrs.front());
+        if (!isNop(nextop)) {
+          if (auto const fused = cti_fused(op, nextop)) {
+            assert(!g_cti_sizes[(int)nextop] ||
+                   g_cti_sizes[(int)nextop] == kCtiSimpleCallSize);
+            cti = fused;
+            fused_total++;
+          }
+        }
+      }
       a.  call  (cti);
     } else if (isBranch(op)) {
       a.  lea   (pc_arg[instrLen(pc)], next_reg);
@@ -213,7 +229,8 @@ Offset compile_cti(Func* func, PC unitpc) {
         func->entry(),
         func->bclen(), cti_size,
         bc_total, a.used());
-  TRACE(2, "cti lookups %lu misses %lu\n", cc_lookups, cc_misses);
+  TRACE(2, "cti lookups %lu misses %lu fused %lu\n",
+        cc_lookups, cc_misses, fused_total);
   return cti_base - cti_code().base();
 }
 
@@ -82,6 +82,10 @@ inline bool cti_enabled() {
   return jit::CodeCache::ABytecodeSize != 0;
 }
 
+// handler for the fused opcode pair (a,b), or nullptr if that pair
+// has no fused handler. Only used in RepoAuthoritative mode.
+CodeAddress cti_fused(Op a, Op b);
+
 // global data
 extern EntryStub g_enterCti;
 extern CodeAddress g_exitCti;
@@ -89,6 +93,7 @@ extern const CodeAddress cti_ops[];
 extern const CodeAddress ctid_ops[];
 
 constexpr auto kCtiIndirectJmpSize = 2;
+constexpr auto kCtiSimpleCallSize = 5; // direct call with rel32 target
 
 }
 #endif
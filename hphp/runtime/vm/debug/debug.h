@@ -56,6 +56,8 @@ struct DebugInfo {
   int perfJitDumpTrace(const void* startAddr,
                        const unsigned int size,
                        const char* symName);
+  int perfJitDumpUnwindingInfo(const void* startAddr,
+                               const unsigned int size);
 
   /* maintain separate dwarf info for a and acold, so that we
    * don't emit dwarf info for the two in the same ELF file.
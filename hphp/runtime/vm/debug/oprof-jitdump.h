@@ -60,6 +60,7 @@ enum class JitRecordType : uint32_t {
   JIT_CODE_MOVE,
   JIT_CODE_DEBUG_INFO,
   JIT_CODE_CLOSE,
+  JIT_CODE_UNWINDING_INFO,
   JIT_CODE_MAX,
 };
 
@@ -112,11 +113,22 @@ struct JitRecCodeDebugInfo {
   DebugEntry entries[0];
 };
 
+/* describes the unwinding data (eh_frame_hdr followed by eh_frame) that
+ * applies to the next JIT_CODE_LOAD record; the raw table immediately
+ * follows this struct */
+struct JitRecCodeUnwindingInfo {
+  JitRecPrefix p;
+  uint64_t unwinding_size;
+  uint64_t eh_frame_hdr_size;
+  uint64_t mapped_size;
+};
+
 union JitRecEntry {
   JitRecCodeDebugInfo info;
   JitRecCodeClose close;
   JitRecCodeLoad load;
   JitRecCodeMove move;
+  JitRecCodeUnwindingInfo unwinding;
   JitRecPrefix prefix;
 };
 
@@ -25,6 +25,7 @@
 #include "hphp/runtime/vm/debug/debug.h"
 #include "hphp/runtime/base/runtime-option.h"
 #include "hphp/runtime/vm/debug/oprof-jitdump.h"
+#include "hphp/runtime/vm/jit/unwind-itanium.h"
 #include "hphp/util/logger.h"
 #include "hphp/util/cycles.h"
 
@@ -231,6 +232,10 @@ int DebugInfo::perfJitDumpTrace(const void* startAddr,
 
   if (!startAddr || !size) return -1;
 
+  /* the unwinding info record applies to the next JIT_CODE_LOAD record,
+   * so it has to be written out first */
+  perfJitDumpUnwindingInfo(startAddr, size);
+
   static int code_generation = 1;
   JitRecCodeLoad rec;
   size_t padding_count;
@@ -268,5 +273,47 @@ int DebugInfo::perfJitDumpTrace(const void* startAddr,
   return 0;
 }
 
+/*
+ * Write a JIT_CODE_UNWINDING_INFO record describing the frame layout of the
+ * code covered by the next JIT_CODE_LOAD record, so that perf inject --jit
+ * can unwind through TC frames.  All TC frames share the uniform layout
+ * described by the CFI in unwind-itanium.cpp; we emit the same .eh_frame
+ * image here, scoped to the tracelet.  Like perfJitDumpTrace(), callers hold
+ * the write lease, so no locking is needed.
+ */
+int DebugInfo::perfJitDumpUnwindingInfo(const void* startAddr,
+                                        const unsigned int size)  {
+
+  if (!startAddr || !size) return -1;
+
+  auto const frame = jit::tc_unwinding_info(
+    reinterpret_cast<jit::TCA>(const_cast<void*>(startAddr)), size);
+  if (frame.empty()) return -1;
+
+  JitRecCodeUnwindingInfo rec;
+  size_t padding_count;
+
+  rec.p.id          = JitRecordType::JIT_CODE_UNWINDING_INFO;
+  rec.p.total_size  = sizeof(rec) + frame.size();
+  padding_count     = PADDING_8ALIGNED(rec.p.total_size);
+  rec.p.total_size += padding_count;
+  rec.p.timestamp   = perfGetTimestamp();
+
+  rec.unwinding_size = frame.size();
+  /* no eh_frame_hdr; perf rebuilds the lookup table itself */
+  rec.eh_frame_hdr_size = 0;
+  rec.mapped_size = 0;
+
+  fwrite(&rec, sizeof(rec), 1, m_perfJitDump);
+  fwrite(frame.data(), frame.size(), 1, m_perfJitDump);
+
+  /* write padding '\0' if necessary */
+  if (padding_count) {
+    fwrite(padding_bytes, padding_count, 1, m_perfJitDump);
+  }
+
+  return 0;
+}
+
 } // namespace Debug
 } // namespace HPHP
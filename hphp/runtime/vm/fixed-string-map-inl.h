@@ -119,13 +119,14 @@ void FixedStringMap<V,E>::add(const StringData* sd, const V& v) {
 template<class V, class E>
 template<class Iter>
 NEVER_INLINE
-void FixedStringMap<V,E>::addFrom(Iter begin, Iter end) {
+void FixedStringMap<V,E>::addFrom(Iter begin, Iter end,
+                                  uint32_t numExtraBytes) {
   uint32_t capacity = this->capacity();
   uint32_t mask = this->mask();
   assertx(folly::isPowTwo(capacity));
 
   boost::dynamic_bitset<> bitset(capacity);
-  auto const isPerfectHashFunction = [&](uint32_t consts) {
+  auto const isPerfectHashFunction = [&](uint32_t consts, uint32_t mask) {
     bitset.reset();
     for (auto it = begin; it != end; ++it) {
       auto const hash = FSM::hash(it->first, consts, kHashConstSize) & mask;
@@ -134,23 +135,55 @@ void FixedStringMap<V,E>::addFrom(Iter begin, Iter end) {
     }
     return true;
   };
+  // Try to find a perfect hash function; returns 0 if there isn't one.
+  auto const findPerfectConsts = [&](uint32_t mask) -> uint32_t {
+    auto const limit = 1 << (kNumHashConsts * kHashConstSize);
+    for (uint32_t consts = 1; consts < limit; ++consts) {
+      if (isPerfectHashFunction(consts, mask)) return consts;
+    }
+    return 0;
+  };
 
   // If the capacity is too high, dont even try to find perfect hash
   if (capacity < (1 << kMaskSizePerfect)) {
-    // Try to find a perfect hash function
-    uint32_t consts = 0;
-    auto const limit = 1 << (kNumHashConsts * kHashConstSize);
-    while (consts < limit - 1) {
-      consts++;
-      if (!isPerfectHashFunction(consts)) continue;
+    if (auto const consts = findPerfectConsts(mask)) {
       setMaskAndConsts(mask, consts);
-      break;
+    } else if (capacity <= kPerfectRetryMaxCapacity) {
+      // No perfect hash function exists at this load. Retry once at double
+      // capacity: halving the load makes a collision-free assignment far more
+      // likely, and one extra power of two is a modest price for single-probe
+      // lookups in a table that is probed for the rest of the process.
+      bitset.resize(capacity * 2);
+      if (auto const consts = findPerfectConsts(mask * 2 + 1)) {
+        grow(capacity * 2, numExtraBytes);
+        setMaskAndConsts(mask * 2 + 1, consts);
+      }
     }
   }
 
   for (auto it = begin; it != end; ++it) add(it->first, it->second);
 }
 
+template<class V, class E>
+NEVER_INLINE
+void FixedStringMap<V,E>::grow(uint32_t newCapac, uint32_t numExtraBytes) {
+  auto const oldCapac = capacity();
+  assertx(folly::isPowTwo(newCapac) && newCapac > oldCapac);
+  assertx(m_table && m_table != (Elm*)&FSM::null_key + 1);
+  TRACE_MOD(Trace::runtime, 4, "FixedStringMap::grow: %u -> %u\n",
+            oldCapac, newCapac);
+  auto const allocSize = newCapac * sizeof(Elm) + numExtraBytes;
+  auto ptr = vm_malloc(allocSize);
+  std::memset(ptr, 0, allocSize);
+  auto const newTable = (Elm*)ptr + newCapac;
+  // Preserve the data our users keep past the end of the Elm array (see
+  // extraData()); the Elm slots themselves are repopulated by addFrom.
+  std::memcpy(newTable, m_table, numExtraBytes);
+  vm_free(m_table - oldCapac);
+  m_table = newTable;
+  setMaskAndConsts(newCapac - 1);
+}
+
 template<class V, class E>
 NEVER_INLINE
 V* FixedStringMap<V,E>::find(const StringData* sd) const {
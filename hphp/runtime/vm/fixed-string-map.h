@@ -42,8 +42,13 @@ struct FixedStringMap {
   void init(int num, uint32_t numExtraBytes = 0);
   V* find(const StringData* s) const;
 
+  /*
+   * Populate the map from [begin, end). If the table has to be reallocated to
+   * find a perfect hash function, numExtraBytes of data past the end of the
+   * Elm array are preserved (see extraData() below).
+   */
   template<class Iter>
-  void addFrom(Iter begin, Iter end);
+  void addFrom(Iter begin, Iter end, uint32_t numExtraBytes = 0);
 
   void* extraData() { return m_table; }
   const void* extraData() const { return m_table; }
@@ -64,6 +69,7 @@ struct FixedStringMap {
 
 private:
   void add(const StringData* s, const V& v);
+  void grow(uint32_t newCapac, uint32_t numExtraBytes);
 
 private:
   static constexpr uint32_t kHashConstSize = 5;
@@ -71,6 +77,11 @@ private:
   static constexpr uint32_t kMaskSize = 31;
   static constexpr uint32_t kMaskSizePerfect =
     kMaskSize - kNumHashConsts * kHashConstSize;
+  // Only retry the perfect hash search at doubled capacity for tables at most
+  // this big. With 2^10 - 1 candidate hash functions a collision-free
+  // assignment is only plausible for a few dozen keys, so retrying on larger
+  // tables just doubles the cost of a search that is going to fail anyway.
+  static constexpr uint32_t kPerfectRetryMaxCapacity = 128;
 
   bool isPerfectHash() const { return m_maskAndConst >> kMaskSize; }
   uint32_t mask() const {
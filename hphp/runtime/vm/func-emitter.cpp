@@ -38,6 +38,8 @@
 
 #include "hphp/system/systemlib.h"
 
+#include "hphp/zend/zend-string.h"
+
 #include "hphp/util/atomic-vector.h"
 #include "hphp/util/file.h"
 #include "hphp/util/trace.h"
@@ -724,6 +726,12 @@ void FuncEmitter::serdeMetaData(SerDe& sd) {
 template void FuncEmitter::serdeMetaData<>(BlobDecoder&);
 template void FuncEmitter::serdeMetaData<>(BlobEncoder&);
 
+namespace {
+// Sentinel in the serialized bytecode stream meaning "the bytes
+// follow inline" rather than referencing an earlier identical body.
+constexpr uint64_t kInvalidBcToken = std::numeric_limits<uint64_t>::max();
+}
+
 template<class SerDe>
 void FuncEmitter::serde(SerDe& sd, bool lazy) {
   assertx(IMPLIES(lazy, RO::RepoAuthoritative));
@@ -769,17 +777,41 @@ void FuncEmitter::serde(SerDe& sd, bool lazy) {
     sd(RO::RepoDebugInfo ? m_sourceLocTab : decltype(m_sourceLocTab){});
   }
 
-  // Bytecode
+  // Bytecode. Byte-identical bodies are common (codegen'd accessors,
+  // trait-flattened methods), so if this unit already serialized a
+  // function with the same bytecode, record the offset of that copy
+  // instead of writing the bytes out again. kInvalidBcToken means the
+  // bytes follow inline.
   if constexpr (SerDe::deserializing) {
-    assertx(sd.remaining() >= m_bclen);
-    if (lazy) {
-      setBcToken(sd.advanced(), m_bclen);
+    uint64_t sharedOff;
+    sd(sharedOff);
+    if (sharedOff != kInvalidBcToken) {
+      if (lazy) {
+        setBcToken(sharedOff, m_bclen);
+      } else {
+        setBc(sd.data() - sd.advanced() + sharedOff, m_bclen);
+      }
     } else {
-      setBc(sd.data(), m_bclen);
+      assertx(sd.remaining() >= m_bclen);
+      if (lazy) {
+        setBcToken(sd.advanced(), m_bclen);
+      } else {
+        setBc(sd.data(), m_bclen);
+      }
+      sd.advance(m_bclen);
     }
-    sd.advance(m_bclen);
   } else {
-    sd.writeRaw((const char*)m_bc.ptr(), m_bclen);
+    auto const sha1 = SHA1{string_sha1(
+      folly::StringPiece{(const char*)m_bc.ptr(), m_bclen}
+    )};
+    auto const it = ue().m_bcDedup.find(sha1);
+    if (it != ue().m_bcDedup.end()) {
+      sd(it->second);
+    } else {
+      sd(kInvalidBcToken);
+      ue().m_bcDedup.emplace(sha1, (uint64_t)sd.size());
+      sd.writeRaw((const char*)m_bc.ptr(), m_bclen);
+    }
   }
 }
 
@@ -1040,6 +1040,73 @@ int Func::getLineNumber(Offset offset) const {
   }
 }
 
+const EHEnt* Func::findEHCached(Offset o) const {
+  assertx(o >= 0 && o < bclen());
+  auto const& ehtab = shared()->m_ehtab;
+  if (ehtab.empty()) return nullptr;
+
+  auto const find = [&] () -> std::pair<const EHEnt*, bool> {
+    // ehMap is an atomically acquired bitwise copy of m_ehMap, with no
+    // destructor. A built map covers all of [0, bclen()), so an empty map
+    // means it hasn't been built yet.
+    auto ehMap(shared()->m_ehMap.get());
+    if (ehMap->empty()) return {nullptr, false};
+    auto const it = std::upper_bound(
+      ehMap->begin(), ehMap->end(),
+      o,
+      [] (Offset o, const EHInfo& info) { return o < info.m_past; }
+    );
+    assertx(it != ehMap->end() && it->m_base <= o);
+    return {it->m_ent, true};
+  };
+
+  auto const fast = find();
+  if (fast.second) return fast.first;
+
+  shared()->m_ehMap.lock_for_update();
+  try {
+    auto const slow = find();
+    if (slow.second) {
+      shared()->m_ehMap.unlock();
+      return slow.first;
+    }
+
+    // Flatten the EH table into sorted, non-overlapping regions covering
+    // [0, bclen()), each annotated with the innermost entry applying to it
+    // (or nullptr where no handler applies). Region boundaries can only
+    // occur where some entry begins or ends.
+    std::vector<Offset> bounds;
+    bounds.reserve(2 * ehtab.size() + 2);
+    bounds.push_back(0);
+    bounds.push_back(bclen());
+    for (auto const& eh : ehtab) {
+      bounds.push_back(eh.m_base);
+      bounds.push_back(eh.m_past);
+    }
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+    VMCompactVector<EHInfo> map;
+    const EHEnt* result = nullptr;
+    for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+      auto const ent = findEH(ehtab, bounds[i]);
+      if (!map.empty() && map.back().m_ent == ent) {
+        map.back().m_past = bounds[i + 1];
+      } else {
+        map.push_back(EHInfo { bounds[i], bounds[i + 1], ent });
+      }
+      if (bounds[i] <= o && o < bounds[i + 1]) result = ent;
+    }
+
+    auto old = shared()->m_ehMap.update_and_unlock(std::move(map));
+    Treadmill::enqueue([old = std::move(old)] () mutable { old.clear(); });
+    return result;
+  } catch (...) {
+    shared()->m_ehMap.unlock();
+    throw;
+  }
+}
+
 bool Func::getSourceLoc(Offset offset, SourceLoc& sLoc) const {
   auto const& sourceLocTable = getLocTable();
   return SourceLocation::getLoc(sourceLocTable, offset, sLoc);
@@ -94,6 +94,19 @@ struct EHEnt {
   template<class SerDe> void serde(SerDe& sd);
 };
 
+/*
+ * Entry in the flattened exception handler lookup table built lazily by
+ * Func::findEHCached(): the innermost EH table entry (or nullptr if none)
+ * covering bytecode offsets in [m_base, m_past).  Entries are sorted and
+ * non-overlapping, so a handler lookup is a binary search rather than a
+ * scan of the full EH table.
+ */
+struct EHInfo {
+  Offset m_base;
+  Offset m_past;
+  const EHEnt* m_ent;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 template <typename T, size_t Expected, size_t Actual = sizeof(T)>
@@ -1014,6 +1027,13 @@ public:
   static const typename Container::value_type*
   findEH(const Container& ehtab, Offset o);
 
+  /*
+   * Same as findEH(), but backed by the flattened lookup table cached in
+   * SharedData, built on first use.  Meant for the unwinder, which tends
+   * to resolve handlers in the same functions over and over.
+   */
+  const EHEnt* findEHCached(Offset o) const;
+
   bool shouldSampleJit() const { return m_shouldSampleJit; }
 
   /////////////////////////////////////////////////////////////////////////////
@@ -1355,8 +1375,9 @@ private:
 
     mutable LockFreePtrWrapper<VMCompactVector<LineInfo>> m_lineMap;
     mutable LockFreePtrWrapper<LineTablePtr> m_lineTable;
+    mutable LockFreePtrWrapper<VMCompactVector<EHInfo>> m_ehMap;
   };
-  static_assert(CheckSize<SharedData, use_lowptr ? 152 : 176>(), "");
+  static_assert(CheckSize<SharedData, use_lowptr ? 160 : 184>(), "");
 
   /*
    * If this Func represents a native function or is exceptionally large
@@ -1389,7 +1410,7 @@ private:
     int64_t m_dynCallSampleRate;
     LowStringPtr m_docComment;
   };
-  static_assert(CheckSize<ExtendedSharedData, use_lowptr ? 280 : 304>(), "");
+  static_assert(CheckSize<ExtendedSharedData, use_lowptr ? 288 : 312>(), "");
 
   /*
    * SharedData accessors for internal use.
@@ -72,7 +72,7 @@ struct IndexedStringMap {
     }
 
     std::copy(b.m_list.begin(), b.m_list.end(), mutableAccessList());
-    m_map.addFrom(b.begin(), b.end());
+    m_map.addFrom(b.begin(), b.end(), byteSize());
   }
 
   const T* accessList() const {
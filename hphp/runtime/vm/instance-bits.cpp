@@ -52,6 +52,11 @@ InstanceCounts s_instanceCounts;
 folly::SharedMutex s_instanceCountsLock;
 InstanceBitsMap s_instanceBitsMap;
 
+// Guards s_instanceBitsMap once refresh() can append to it after init. The
+// initial population doesn't take it: that happens under s_initLock, and
+// lookup() asserts that pre-init reads are confined to the init thread.
+folly::SharedMutex s_instanceBitsMapLock;
+
 Mutex s_initLock(RankInstanceBitsInit);
 
 constexpr size_t kNumInstanceBits = sizeof(BitSet) * CHAR_BIT;
@@ -216,11 +221,100 @@ bool initted() {
   return g_initFlag.load(std::memory_order_acquire);
 }
 
+bool profiling() {
+  return !g_profileDoneFlag.load(std::memory_order_acquire) &&
+         RuntimeOption::RepoAuthoritative;
+}
+
+void resumeProfiling() {
+  if (!g_initFlag.load(std::memory_order_acquire) ||
+      !RuntimeOption::RepoAuthoritative) {
+    return;
+  }
+  {
+    // No point collecting counts if there's nothing left to hand out.
+    SharedMutex::ReadHolder l(s_instanceBitsMapLock);
+    if (s_instanceBitsMap.size() + 1 >= kNumInstanceBits) return;
+  }
+  g_profileDoneFlag.store(false, std::memory_order_release);
+}
+
+unsigned refresh() {
+  if (!g_initFlag.load(std::memory_order_acquire) ||
+      !RuntimeOption::RepoAuthoritative) {
+    return 0;
+  }
+
+  Lock l(s_initLock);
+
+  // Close the profiling window before touching the instance-counts lock, for
+  // the same starvation reasons described in initImpl().
+  g_profileDoneFlag.store(true, std::memory_order_release);
+
+  typedef std::pair<const StringData*, unsigned> Count;
+  std::vector<Count> counts;
+  {
+    SharedMutex::WriteHolder cl(s_instanceCountsLock);
+    for (auto& pair : s_instanceCounts) counts.push_back(pair);
+  }
+  std::sort(counts.begin(),
+            counts.end(),
+            [&](const Count& a, const Count& b) {
+              return a.second > b.second;
+            });
+
+  // Pick the hottest names that don't have a bit yet. Published assignments
+  // are never revoked or renumbered -- translations have burned their
+  // offset/mask pairs into the TC -- so all we can do is hand out the bits
+  // init() left unused.
+  std::vector<std::pair<Class*, unsigned>> pending;
+  {
+    SharedMutex::ReadHolder ml(s_instanceBitsMapLock);
+    auto nextBit = s_instanceBitsMap.size() + 1;
+    for (auto& item : counts) {
+      if (nextBit >= kNumInstanceBits) break;
+      if (s_instanceBitsMap.count(item.first)) continue;
+      auto const cls = Class::lookupUniqueInContext(
+        item.first, nullptr, nullptr);
+      if (!cls) continue;
+      assertx(cls->attrs() & AttrUnique);
+      pending.emplace_back(cls, nextBit++);
+    }
+  }
+  if (pending.empty()) return 0;
+
+  // Republish: first set the new bits on every existing Class (blocking
+  // creation of new ones, as in initImpl()), then expose the assignments to
+  // lookup(). The order matters: a translation may burn a bit into the TC as
+  // soon as lookup() returns it, so every class mask must already be up to
+  // date by then. Old bits are untouched, so code reading a mask concurrently
+  // with the sweep can't observe any change in the bits it tests.
+  SharedMutex::WriteHolder clsLocker(g_clsInitLock);
+  NamedEntity::foreach_class([&](Class* cls) {
+    for (auto const& p : pending) {
+      if (cls->classof(p.first)) cls->setInstanceBit(p.second);
+    }
+  });
+  {
+    SharedMutex::WriteHolder ml(s_instanceBitsMapLock);
+    for (auto const& p : pending) {
+      s_instanceBitsMap[p.first->name()] = p.second;
+    }
+  }
+
+  if (Trace::moduleEnabledRelease(Trace::instancebits, 1)) {
+    Trace::traceRelease("%s: %zu new bits assigned, %zu in use\n",
+                        __FUNCTION__, pending.size(), s_instanceBitsMap.size());
+  }
+  return pending.size();
+}
+
 unsigned lookup(const StringData* name) {
   assertx(g_initFlag.load(std::memory_order_acquire) ||
          pthread_equal(s_initThread.load(std::memory_order_acquire),
                        pthread_self()));
 
+  SharedMutex::ReadHolder l(s_instanceBitsMapLock);
   if (auto const ptr = folly::get_ptr(s_instanceBitsMap, name)) {
     assertx(*ptr >= 1 && *ptr < kNumInstanceBits);
     return *ptr;
@@ -243,6 +337,7 @@ bool getMask(const StringData* name, int& offset, uint8_t& mask) {
 void serialize(jit::ProfDataSerializer& ser) {
   assertx(g_initFlag.load(std::memory_order_acquire));
 
+  SharedMutex::ReadHolder l(s_instanceBitsMapLock);
   write_raw(ser, s_instanceBitsMap.size());
   for (auto const& elm : s_instanceBitsMap) {
     write_string(ser, elm.first);
@@ -91,6 +91,29 @@ void profile(const StringData* name);
 bool initted();
 void init();
 
+/*
+ * Whether instanceof checks should currently be recorded via profile(). True
+ * before init() runs, and again after resumeProfiling() reopens the window.
+ */
+bool profiling();
+
+/*
+ * Support for folding post-warmup traffic into the bit assignments.
+ *
+ * resumeProfiling() reopens the profiling window after init(), so that new
+ * Profile translations record instanceof checks again. refresh() closes the
+ * window and assigns any bits init() left unused to the hottest classes that
+ * lack one, republishing the per-class masks before the new assignments
+ * become visible to lookup().
+ *
+ * Assignments are append-only: a published bit keeps its meaning forever,
+ * since translations burn the offset/mask pairs into the TC and cannot be
+ * revoked. Returns the number of newly assigned bits. Both functions are
+ * no-ops until init() has completed.
+ */
+void resumeProfiling();
+unsigned refresh();
+
 /*
  * Returns: the instance bit for the class or interface `name', or 0 if there
  * is no allocated bit.
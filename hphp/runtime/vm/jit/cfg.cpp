@@ -276,12 +276,12 @@ bool dominates(const Block* b1, const Block* b2, const IdomVector& idoms) {
 }
 
 EdgeSet findRetreatingEdges(const IRUnit& unit) {
-  auto v = jit::vector<Edge*>{};
+  auto v = jit::small_vector<Edge*>{};
   visit_retreating_edges(unit, [&] (Edge* edge) {
     v.push_back(edge);
     return true;
   });
-  return EdgeSet(begin(v), end(v));
+  return EdgeSet(v.begin(), v.end());
 }
 
 bool cfgHasLoop(const IRUnit& unit) {
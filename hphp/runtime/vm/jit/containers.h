@@ -32,6 +32,7 @@
 #include <boost/version.hpp>
 #include <folly/container/F14Map.h>
 #include <folly/container/F14Set.h>
+#include <folly/small_vector.h>
 
 #include "hphp/util/sparse-id-containers.h"
 
@@ -77,6 +78,14 @@ using array = std::array<T, N>;
 template<class T>
 using vector = std::vector<T>;
 
+// small_vector keeps up to N elements in situ and only spills to the heap
+// past that. Prefer it over vector for the many sequences built per
+// translation that almost always hold a handful of elements (predecessor
+// lists, phi inputs, return values), to cut allocator traffic during
+// retranslateAll.
+template<class T, std::size_t N = 4>
+using small_vector = folly::small_vector<T, N>;
+
 template<class T>
 using deque = std::deque<T>;
 
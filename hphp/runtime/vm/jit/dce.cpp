@@ -103,6 +103,8 @@ bool canDCE(IRInstruction* inst) {
   case SameStr:
   case NSameStr:
   case CmpStr:
+  case StrHasPrefix:
+  case StrHasSuffix:
   case GtBool:
   case GteBool:
   case LtBool:
@@ -39,6 +39,13 @@ void DecRefProfile::reduce(DecRefProfile& a, const DecRefProfile& b) {
     a.released    += b.released;
     a.decremented += b.decremented;
   }
+  if (b.datatype != kExtraInvalidDataType) {
+    if (a.datatype == kExtraInvalidDataType) {
+      a.datatype = b.datatype;
+    } else if (a.datatype != b.datatype) {
+      a.datatype = kInvalidDataType;
+    }
+  }
 }
 
 void DecRefProfile::update(TypedValue tv) {
@@ -48,6 +55,11 @@ void DecRefProfile::update(TypedValue tv) {
   total++;
   if (!isRefcountedType(tv.type())) return;
   refcounted++;
+  if (datatype == kExtraInvalidDataType) {
+    datatype = tv.type();
+  } else if (datatype != tv.type()) {
+    datatype = kInvalidDataType;
+  }
   auto const countable = tv.val().pcnt;
   if (countable->decWillRelease()) {
     released++;
@@ -71,18 +83,20 @@ folly::dynamic DecRefProfile::toDynamic() const {
                                ("percentDestroyed", percent(destroyed()))
                                ("survived", survived())
                                ("percentSurvived", percent(survived()))
+                               ("datatype", tname(datatype))
                                ("profileType", "DecRefProfile");
 }
 
 std::string DecRefProfile::toString() const {
   return folly::sformat(
     "total: {:4}\n uncounted: {:4} ({:.1f}%),\n persistent: {:4} ({:.1f}%),\n"
-    " destroyed: {:4} ({:.1f}%),\n survived: {:4} ({:.1f}%)",
+    " destroyed: {:4} ({:.1f}%),\n survived: {:4} ({:.1f}%),\n datatype: {}",
     total,
     uncounted(),  percent(uncounted()),
     persistent(), percent(persistent()),
     destroyed(),  percent(destroyed()),
-    survived(),   percent(survived())
+    survived(),   percent(survived()),
+    tname(datatype)
   );
 }
 
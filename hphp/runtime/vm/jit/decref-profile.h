@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include "hphp/runtime/base/datatype.h"
+
 #include "hphp/runtime/vm/jit/ir-instruction.h"
 #include "hphp/runtime/vm/jit/target-profile.h"
 
@@ -60,6 +62,14 @@ struct DecRefProfile {
     return decremented;
   }
 
+  /*
+   * The unique refcounted DataType seen by this DecRef, or kInvalidDataType
+   * if it saw none, or more than one.
+   */
+  DataType uniqueRefcountedType() const {
+    return isRefcountedType(datatype) ? datatype : kInvalidDataType;
+  }
+
   float percent(uint32_t value) const {
     return total ? 100.0 * value / total : 0.0;
   }
@@ -93,6 +103,13 @@ struct DecRefProfile {
    * got a non-persistent, refcounted value with count > 1).
    */
   uint32_t decremented;
+  /*
+   * The DataType of the refcounted values seen by this DecRef. It is
+   * kExtraInvalidDataType (i.e. zero, matching RDS initialization) until the
+   * first refcounted value is seen, and kInvalidDataType once values of two
+   * different types have shown up.
+   */
+  DataType datatype;
 };
 
 const StringData* decRefProfileKey(const IRInstruction* inst);
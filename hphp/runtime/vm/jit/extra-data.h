@@ -166,42 +166,49 @@ struct ResolveTypeStructData : IRExtraData {
     bool suppress,
     IRSPRelOffset offset,
     uint32_t size,
-    bool isOrAsOp
+    bool isOrAsOp,
+    rds::Handle handle = rds::kUninitHandle
   )
     : cls(cls)
     , suppress(suppress)
     , offset(offset)
     , size(size)
     , isOrAsOp(isOrAsOp)
+    , handle(handle)
   {}
 
   std::string show() const {
-    return folly::sformat("{},{},{},{},{}",
+    return folly::sformat("{},{},{},{},{},{}",
                           cls ? cls->name()->data() : "nullptr",
                           suppress ? "suppress" : "no-suppress",
                           offset.offset,
                           size,
-                          isOrAsOp);
+                          isOrAsOp,
+                          handle);
   }
 
   bool equals(const ResolveTypeStructData& o) const {
     return cls == o.cls && suppress == o.suppress &&
-           offset == o.offset && size == o.size && isOrAsOp == o.isOrAsOp;
+           offset == o.offset && size == o.size && isOrAsOp == o.isOrAsOp &&
+           handle == o.handle;
   }
 
   size_t hash() const {
     return (pointer_hash<Class>()(cls)
             + std::hash<int32_t>()(offset.offset)
-            + std::hash<uint32_t>()(size))
+            + std::hash<uint32_t>()(size)
+            + std::hash<uint32_t>()(handle))
            ^ ((int64_t)(suppress ? -1 : 0) << 32 | (isOrAsOp ? -1 : 0));
   }
 
   size_t stableHash() const {
+    auto const sym = rds::reverseLink(handle);
     return folly::hash::hash_combine(
       cls ? cls->stableHash() : 0,
       std::hash<int32_t>()(offset.offset),
       std::hash<uint32_t>()(size),
-      std::hash<uint8_t>()(suppress << 1 | isOrAsOp)
+      std::hash<uint8_t>()(suppress << 1 | isOrAsOp),
+      sym ? rds::symbol_stable_hash(*sym) : 0
     );
   }
 
@@ -210,6 +217,9 @@ struct ResolveTypeStructData : IRExtraData {
   IRSPRelOffset offset;
   uint32_t size;
   bool isOrAsOp;
+  // Cache probed by the resolution helper when the structure is a constant
+  // but resolution depends on the called class (kUninitHandle if not).
+  rds::Handle handle;
 };
 
 /*
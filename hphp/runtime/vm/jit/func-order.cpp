@@ -24,6 +24,7 @@
 #include "hphp/runtime/vm/jit/prof-data-serialize.h"
 #include "hphp/runtime/vm/jit/trans-rec.h"
 #include "hphp/runtime/vm/jit/types.h"
+#include "hphp/runtime/vm/workload-stats.h"
 
 #include "hphp/util/assertions.h"
 #include "hphp/util/boot-stats.h"
@@ -31,8 +32,11 @@
 #include "hphp/util/logger.h"
 #include "hphp/util/trace.h"
 
+#include <folly/lang/Bits.h>
+
 #include <tbb/concurrent_hash_map.h>
 
+#include <numeric>
 #include <vector>
 
 TRACE_SET_MOD(funcorder);
@@ -60,6 +64,35 @@ CallCounters s_callCounters;
 using FuncSizes = tbb::concurrent_hash_map<FuncId::Int,uint32_t>;
 FuncSizes s_funcSizes;
 
+// Per-function endpoint reachability (Eval.JitPGOPartitionByEndpoint). Each
+// distinct endpoint observed by the opt-code call-graph instrumentation gets
+// a small class id, and each called function accumulates a bitmask of the
+// classes that reached it. Endpoints beyond the cap, and requests with no
+// endpoint tagged, record no bit and end up in the shared group.
+constexpr uint32_t kMaxEndpointClasses = 32;
+using EndpointClasses = tbb::concurrent_hash_map<std::string,uint32_t>;
+EndpointClasses s_endpointClasses;
+std::atomic<uint32_t> s_numEndpointClasses{0};
+
+using FuncEndpoints = tbb::concurrent_hash_map<FuncId::Int,uint32_t>;
+FuncEndpoints s_funcEndpoints;
+
+uint32_t currentEndpointClassBit() {
+  auto const& endpoint = WorkloadStats::GetEndpoint();
+  if (endpoint.empty()) return 0;
+  {
+    EndpointClasses::const_accessor acc;
+    if (s_endpointClasses.find(acc, endpoint)) {
+      return acc->second < kMaxEndpointClasses ? 1u << acc->second : 0;
+    }
+  }
+  EndpointClasses::accessor acc;
+  if (s_endpointClasses.insert(acc, endpoint)) {
+    acc->second = s_numEndpointClasses.fetch_add(1, std::memory_order_relaxed);
+  }
+  return acc->second < kMaxEndpointClasses ? 1u << acc->second : 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 uint32_t getFuncSize(FuncId funcId) {
@@ -225,6 +258,46 @@ void print(const char* fileName,
   fclose(outfile);
 }
 
+// Group clusters by the endpoint class that reaches them, so that each
+// traffic class's translations land contiguously in the TC. Clusters
+// reached from several classes (or with no endpoint data, e.g. on the
+// first retranslateAll before the opt-code instrumentation has run) are
+// shared and stay in front; each single-class group follows. Within a
+// group the density/hfsort order is preserved.
+void partitionClustersByEndpoint(
+    std::vector<hfsort::Cluster>& clusters,
+    jit::hash_map<hfsort::TargetId, FuncId>& target2FuncId) {
+  if (s_funcEndpoints.empty()) return;
+
+  auto const clusterKey = [&] (const hfsort::Cluster& cluster) -> uint32_t {
+    uint32_t mask = 0;
+    for (auto const tid : cluster.targets) {
+      auto const fid = target2FuncId[tid];
+      if (!Func::isFuncIdValid(fid)) continue;
+      FuncEndpoints::const_accessor acc;
+      if (s_funcEndpoints.find(acc, fid.toInt())) mask |= acc->second;
+    }
+    // Exactly one bit set sorts the cluster into that class's group
+    // (1-based, after the shared group at 0).
+    if (mask == 0 || (mask & (mask - 1))) return 0;
+    return folly::findFirstSet(mask);
+  };
+
+  std::vector<uint32_t> keys;
+  keys.reserve(clusters.size());
+  for (auto const& cluster : clusters) keys.push_back(clusterKey(cluster));
+
+  std::vector<size_t> order(clusters.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::stable_sort(order.begin(), order.end(),
+                   [&] (size_t a, size_t b) { return keys[a] < keys[b]; });
+
+  std::vector<hfsort::Cluster> sorted;
+  sorted.reserve(clusters.size());
+  for (auto const i : order) sorted.emplace_back(std::move(clusters[i]));
+  clusters = std::move(sorted);
+}
+
 std::pair<std::vector<FuncId>, uint64_t> hfsortFuncs() {
   // Return ordered function id, as well as the base profile count used by
   // inlining.
@@ -249,16 +322,29 @@ std::pair<std::vector<FuncId>, uint64_t> hfsortFuncs() {
   }
 
   std::vector<hfsort::Cluster> clusters;
-  if (RuntimeOption::EvalJitPGOHFSortPlus) {
-    clusters = hfsort::hfsortPlus(cg);
-  } else {
-    clusters = hfsort::clusterize(cg);
-    sort(clusters.begin(), clusters.end(), hfsort::compareClustersDensity);
+  {
+    BootStats::Block timer("RTA_hfsort", serverMode);
+    if (RuntimeOption::EvalJitPGOHFSortPlus) {
+      clusters = hfsort::hfsortPlus(cg);
+    } else {
+      clusters = hfsort::clusterize(cg);
+      sort(clusters.begin(), clusters.end(), hfsort::compareClustersDensity);
+    }
   }
   if (serverMode) {
     Logger::Info("retranslateAll: finished clusterizing the functions");
   }
 
+  if (RuntimeOption::EvalJitPGOPartitionByEndpoint) {
+    partitionClustersByEndpoint(clusters, target2FuncId);
+    if (serverMode) {
+      Logger::FInfo("retranslateAll: partitioned {} clusters across {} "
+                    "endpoint classes",
+                    clusters.size(),
+                    s_numEndpointClasses.load(std::memory_order_relaxed));
+    }
+  }
+
   if (RuntimeOption::EvalJitPGODumpCallGraph) {
     Treadmill::Session ts(Treadmill::SessionKind::Retranslate);
 
@@ -381,6 +467,19 @@ void incCount(const ActRec* fp) {
       acc->second++;
     }
   }
+
+  if (RuntimeOption::EvalJitPGOPartitionByEndpoint) {
+    if (auto const bit = currentEndpointClassBit()) {
+      auto const record = [&] (FuncId::Int fid) {
+        FuncEndpoints::accessor acc;
+        if (!s_funcEndpoints.insert(acc, FuncEndpoints::value_type(fid, bit))) {
+          acc->second |= bit;
+        }
+      };
+      record(callee.toInt());
+      record(caller.toInt());
+    }
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -16,6 +16,8 @@
 
 #include "hphp/runtime/vm/jit/guard-type-profile.h"
 
+#include "hphp/runtime/base/runtime-option.h"
+
 #include "hphp/runtime/vm/jit/abi.h"
 #include "hphp/runtime/vm/jit/code-gen-cf.h"
 #include "hphp/runtime/vm/jit/code-gen-helpers.h"
@@ -25,29 +27,43 @@
 
 #include <folly/AtomicHashMap.h>
 
+#include <atomic>
+#include <map>
+#include <utility>
+
 namespace HPHP { namespace jit {
 
 namespace {
-folly::AtomicHashMap<const StringData*, rds::Link<int64_t, rds::Mode::Normal>>
-  s_map{20};
+using ProfileMap =
+  folly::AtomicHashMap<const StringData*, rds::Link<int64_t, rds::Mode::Normal>>;
+
+ProfileMap s_passedMap{20};
+ProfileMap s_failedMap{20};
+
+// Process-wide totals, folded in from the request-local counters as each
+// request's profile is logged.
+folly::AtomicHashMap<const StringData*, std::atomic<int64_t>> s_totalPassed{20};
+folly::AtomicHashMap<const StringData*, std::atomic<int64_t>> s_totalFailed{20};
 
-rds::Handle guardProfileHandle(Type t) {
-  auto const name = makeStaticString(
+const StringData* guardProfileKey(Type t) {
+  return makeStaticString(
     t.unspecialize().toString() + (t.isSpecialized() ? "<specialized>" : "")
   );
-  auto const pair = s_map.emplace(name);
+}
+
+rds::Handle guardProfileHandle(ProfileMap& map, const StringData* name,
+                               const char* linkName) {
+  auto const pair = map.emplace(name);
   if (pair.second) {
     pair.first->second.bind(
       rds::Mode::Normal,
-      rds::LinkName{"ProfileGuardType", pair.first->first}
+      rds::LinkName{linkName, pair.first->first}
     );
   }
   return pair.first->second.handle();
 }
-}
 
-void emitProfileGuardType(Vout& v, Type t) {
-  auto const handle = guardProfileHandle(t);
+void emitGuardCount(Vout& v, rds::Handle handle) {
   auto const sf = checkRDSHandleInitialized(v, handle);
   ifThen(v, CC_NE, sf, [&](Vout& v) {
     v << storeqi{0, rvmtl()[handle]};
@@ -56,20 +72,75 @@ void emitProfileGuardType(Vout& v, Type t) {
   v << incqm{rvmtl()[handle], v.makeReg()};
 }
 
+int64_t readLink(rds::Link<int64_t, rds::Mode::Normal>& link,
+                 const StringData* name, const char* linkName) {
+  // It's possible to see the Link after insertion but before it's bound, so
+  // make sure it's bound before trying to read from it.
+  link.bind(rds::Mode::Normal, rds::LinkName{linkName, name});
+  return link.isInit() ? *link : 0;
+}
+
+int64_t accumulate(folly::AtomicHashMap<const StringData*,
+                                        std::atomic<int64_t>>& totals,
+                   const StringData* name, int64_t count) {
+  auto const pair = totals.emplace(name, 0);
+  return pair.first->second.fetch_add(count, std::memory_order_relaxed) + count;
+}
+
+bool guardCountersSettled(const StringData* name) {
+  auto const minPassed = RuntimeOption::EvalJitProfileGuardTypesSettleCount;
+  if (minPassed == 0) return false;
+  auto const failed = s_totalFailed.find(name);
+  if (failed != s_totalFailed.end() &&
+      failed->second.load(std::memory_order_relaxed) > 0) {
+    return false;
+  }
+  auto const passed = s_totalPassed.find(name);
+  return passed != s_totalPassed.end() &&
+         passed->second.load(std::memory_order_relaxed) >=
+           static_cast<int64_t>(minPassed);
+}
+}
+
+void emitProfileGuardType(Vout& v, Type t) {
+  auto const name = guardProfileKey(t);
+  // Once a guard type's verdict is in--lots of executions, no failures--stop
+  // paying for the count on the hot path. Failure counts are still emitted so
+  // a later regression shows up in the logs.
+  if (guardCountersSettled(name)) return;
+  emitGuardCount(v, guardProfileHandle(s_passedMap, name, "ProfileGuardType"));
+}
+
+void emitProfileGuardFailure(Vout& v, Type t) {
+  auto const name = guardProfileKey(t);
+  emitGuardCount(
+    v, guardProfileHandle(s_failedMap, name, "ProfileGuardTypeFailed")
+  );
+}
+
 void logGuardProfileData() {
-  for (auto& pair : s_map) {
-    auto& link = pair.second;
-    // It's possible to see the Link after insertion but before it's bound, so
-    // make sure it's bound before trying to read from it.
-    link.bind(
-      rds::Mode::Normal,
-      rds::LinkName{"ProfileGuardType", pair.first}
-    );
-    if (!link.isInit() || *link == 0) continue;
+  std::map<const StringData*, std::pair<int64_t, int64_t>> counts;
+  for (auto& pair : s_passedMap) {
+    auto const n = readLink(pair.second, pair.first, "ProfileGuardType");
+    if (n) counts[pair.first].first = n;
+  }
+  for (auto& pair : s_failedMap) {
+    auto const n = readLink(pair.second, pair.first, "ProfileGuardTypeFailed");
+    if (n) counts[pair.first].second = n;
+  }
+
+  for (auto& pair : counts) {
+    auto const passed = accumulate(s_totalPassed, pair.first,
+                                   pair.second.first);
+    auto const failed = accumulate(s_totalFailed, pair.first,
+                                   pair.second.second);
 
     StructuredLogEntry log;
     log.setStr("guard_type", pair.first->slice());
-    log.setInt("guard_count", *link);
+    log.setInt("guard_count", pair.second.first);
+    log.setInt("guard_failed", pair.second.second);
+    log.setInt("guard_count_total", passed);
+    log.setInt("guard_failed_total", failed);
     StructuredLog::log("hhvm_guard_types", log);
   }
 }
@@ -29,11 +29,22 @@ struct Vout;
  * Emit code to increment the RDS profiling count for type t. If t is
  * specialized, it will be logged as "Foo<specialized>", rather than the actual
  * specialization.
+ *
+ * Once a type has accumulated Eval.JitProfileGuardTypesSettleCount passes in
+ * this process without a single failure, this becomes a no-op: the verdict is
+ * in, and newly-emitted checks on that type no longer pay for the count.
  */
 void emitProfileGuardType(Vout& v, Type t);
 
 /*
- * Log guard type profile counts for the current request with StructLog.
+ * Emit code to increment the failure count for a guard on type t. Emitted on
+ * the side-exit edge of the check, so it stays off the fall-through path.
+ */
+void emitProfileGuardFailure(Vout& v, Type t);
+
+/*
+ * Log guard type profile counts for the current request with StructLog, along
+ * with the process-wide running totals.
  */
 void logGuardProfileData();
 
@@ -287,6 +287,8 @@ bool supportsGVN(const IRInstruction* inst) {
   case LdVecElemAddr:
   case OrdStr:
   case ChrInt:
+  case StrHasPrefix:
+  case StrHasSuffix:
   case CheckRange:
   case CountVec:
   case CountDict:
@@ -388,14 +388,33 @@ int computeTranslationCost(SrcKey at,
   return cost;
 }
 
+/*
+ * Return the budget multiplier for the translation `env' belongs to.
+ *
+ * Translations rooted in one of the functions listed in
+ * Eval.JitInliningHotEndpoints---typically the entry points of
+ * latency-critical requests---get their inlining budgets scaled by
+ * Eval.HHIRInliningHotEndpointFactor, so they can be tuned for deeper
+ * inlining than the long tail without raising the global thresholds.
+ */
+double hotEndpointFactor(const irgen::IRGS& env) {
+  auto const& endpoints = RuntimeOption::EvalJitInliningHotEndpoints;
+  if (endpoints.empty()) return 1.0;
+
+  auto const root = env.context.initSrcKey.func();
+  if (!root || !endpoints.count(root->fullName()->data())) return 1.0;
+  return RuntimeOption::EvalHHIRInliningHotEndpointFactor;
+}
+
 uint64_t adjustedMaxVasmCost(const irgen::IRGS& env,
                              const RegionDesc& calleeRegion,
                              uint32_t depth) {
   auto const maxDepth = RuntimeOption::EvalHHIRInliningMaxDepth;
   if (depth >= maxDepth) return 0;
   const auto baseVasmCost = RuntimeOption::EvalHHIRInliningVasmCostLimit;
+  const auto endpointFactor = hotEndpointFactor(env);
   const auto baseProfCount = s_baseProfCount.load();
-  if (baseProfCount == 0) return baseVasmCost;
+  if (baseProfCount == 0) return baseVasmCost * endpointFactor;
   auto const callerProfCount = irgen::curProfCount(env);
   auto adjustedCost = baseVasmCost *
     std::pow((double)callerProfCount / baseProfCount,
@@ -413,6 +432,14 @@ uint64_t adjustedMaxVasmCost(const irgen::IRGS& env,
   if (adjustedCost > RuntimeOption::EvalHHIRInliningMaxVasmCostLimit) {
     adjustedCost = RuntimeOption::EvalHHIRInliningMaxVasmCostLimit;
   }
+  // The endpoint bias applies after clamping, so hot endpoints can be tuned
+  // past the global limits.
+  if (endpointFactor != 1.0) {
+    adjustedCost *= endpointFactor;
+    FTRACE(3, "adjustedMaxVasmCost: scaled by hot-endpoint factor ({}) "
+           "for root {}\n",
+           endpointFactor, env.context.initSrcKey.func()->fullName()->data());
+  }
   if (calleeProfCount) {
     FTRACE(3, "adjustedMaxVasmCost: adjustedCost ({}) = baseVasmCost ({}) * "
            "(callerProfCount ({}) / baseProfCount ({})) ^ {} * "
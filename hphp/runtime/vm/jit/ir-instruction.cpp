@@ -796,8 +796,6 @@ bool IRInstruction::maySyncVMRegsWithSources() const {
       return true;
 
     // Likely fixable
-    case EqStr:
-    case NeqStr:
     case IsTypeStruct:
     case StructDictSet:
     case StructDictUnset:
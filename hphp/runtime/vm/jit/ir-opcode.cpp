@@ -901,6 +901,8 @@ bool opcodeMayRaise(Opcode opc) {
   case StMBase:
   case StMem:
   case StOutValue:
+  case StrHasPrefix:
+  case StrHasSuffix:
   case StrictlyIntegerConv:
   case StringIsset:
   case StructDictGetWithColor:
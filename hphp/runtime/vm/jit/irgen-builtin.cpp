@@ -357,6 +357,45 @@ SSATmp* opt_strlen(IRGS& env, const ParamPrep& params) {
   return nullptr;
 }
 
+// The HSL string natives take an optional locale as their last parameter and
+// dispatch to locale-sensitive implementations when it's non-null.  When the
+// locale is statically null they use plain byte semantics, which we can
+// implement directly in HHIR.
+bool hsl_str_uses_byte_ops(const ParamPrep& params) {
+  return params[params.size() - 1].value->type() <= TInitNull;
+}
+
+SSATmp* opt_hsl_str_strlen(IRGS& env, const ParamPrep& params) {
+  if (params.size() != 2 || !hsl_str_uses_byte_ops(params)) return nullptr;
+
+  auto const str = params[0].value;
+  if (str->type() <= TStr) {
+    return gen(env, LdStrLen, str);
+  }
+
+  return nullptr;
+}
+
+SSATmp* impl_opt_hsl_str_fix(IRGS& env, const ParamPrep& params, Opcode op) {
+  if (params.size() != 3 || !hsl_str_uses_byte_ops(params)) return nullptr;
+
+  auto const str = params[0].value;
+  auto const fix = params[1].value;
+  if (str->type() <= TStr && fix->type() <= TStr) {
+    return gen(env, op, str, fix);
+  }
+
+  return nullptr;
+}
+
+SSATmp* opt_hsl_str_starts_with(IRGS& env, const ParamPrep& params) {
+  return impl_opt_hsl_str_fix(env, params, StrHasPrefix);
+}
+
+SSATmp* opt_hsl_str_ends_with(IRGS& env, const ParamPrep& params) {
+  return impl_opt_hsl_str_fix(env, params, StrHasSuffix);
+}
+
 SSATmp* opt_clock_gettime_ns(IRGS& env, const ParamPrep& params) {
   if (params.size() != 1) return nullptr;
 
@@ -1095,6 +1134,9 @@ const hphp_fast_string_imap<OptEmitFn> s_opt_emit_fns{
   {"HH\\Lib\\_Private\\Native\\last", opt_container_last},
   {"HH\\Lib\\_Private\\Native\\first_key", opt_container_first_key},
   {"HH\\Lib\\_Private\\Native\\last_key", opt_container_last_key},
+  {"HH\\Lib\\_Private\\_Str\\strlen_l", opt_hsl_str_strlen},
+  {"HH\\Lib\\_Private\\_Str\\starts_with_l", opt_hsl_str_starts_with},
+  {"HH\\Lib\\_Private\\_Str\\ends_with_l", opt_hsl_str_ends_with},
   {"HH\\fun_get_function", opt_fun_get_function},
   {"HH\\class_meth_get_class", opt_class_meth_get_class},
   {"HH\\class_meth_get_method", opt_class_meth_get_method},
@@ -28,6 +28,7 @@
 #include "hphp/runtime/vm/jit/translate-region.h"
 #include "hphp/runtime/vm/jit/type.h"
 #include "hphp/runtime/vm/jit/type-array-elem.h"
+#include "hphp/runtime/vm/jit/type-profile.h"
 
 #include "hphp/runtime/vm/jit/irgen-basic.h"
 #include "hphp/runtime/vm/jit/irgen-builtin.h"
@@ -259,9 +260,65 @@ SSATmp* callImpl(IRGS& env, SSATmp* callee, const FCallArgs& fca,
   );
 }
 
+/*
+ * Profile the type of the value returned at this call site and, when
+ * profiling observed a stable type that is more precise than what HHBBC
+ * proved, check for it in optimized translations so the refined type flows
+ * into the rest of the region.  This pairs with callProfiledFunc(): even when
+ * the dominant callee is known, its repo return type is often too imprecise
+ * to elide the generic handling of the returned value.  The check has to
+ * stay on the caller side -- the callee may be entered from the interpreter
+ * or from a profiling translation, so its optimized translation alone can't
+ * guarantee a return type.  If the check fails dynamically, we side exit to
+ * the next bytecode instruction.
+ */
+SSATmp* profiledCallReturn(IRGS& env, const FCallArgs& fca, SSATmp* retVal) {
+  if (!RuntimeOption::EvalJitPGOCallReturnTypes) return retVal;
+  if (fca.numRets != 1) return retVal;
+  if (retVal->type().isKnownDataType()) return retVal;
+
+  static const StaticString s_CallReturnProfile{"CallReturnProfile"};
+  TargetProfile<TypeProfile> prof(env.context, env.irb->curMarker(),
+                                  s_CallReturnProfile.get());
+
+  if (prof.profiling()) {
+    gen(env, ProfileType, RDSHandleData { prof.handle() }, retVal);
+  }
+  if (!prof.optimizing()) return retVal;
+
+  auto const observed = prof.data().type;
+  if (observed == TBottom) return retVal;
+
+  auto const typeToCheck = relaxToGuardable(observed);
+
+  // Avoid the check if it is going to always succeed or fail.
+  if (retVal->type() <= typeToCheck || !retVal->type().maybe(typeToCheck)) {
+    return retVal;
+  }
+
+  SSATmp* checked{nullptr};
+  ifThen(
+    env,
+    [&] (Block* taken) {
+      checked = gen(env, CheckType, typeToCheck, taken, retVal);
+    },
+    [&] {
+      hint(env, Block::Hint::Unlikely);
+      auto const takenType = negativeCheckType(retVal->type(), typeToCheck);
+      if (takenType < retVal->type()) {
+        gen(env, AssertType, takenType, retVal);
+      }
+      push(env, retVal);
+      gen(env, Jmp, makeExit(env, nextSrcKey(env)));
+    }
+  );
+  return checked;
+}
+
 void handleCallReturn(IRGS& env, const Func* callee, const FCallArgs& fca,
                       SSATmp* retVal, bool asyncEagerReturn, bool unlikely) {
   if (!asyncEagerReturn) {
+    if (!unlikely) retVal = profiledCallReturn(env, fca, retVal);
     push(env, retVal);
     if (unlikely) gen(env, Jmp, makeExit(env, nextSrcKey(env)));
     return;
@@ -917,6 +974,54 @@ void optimizeProfiledCallMethod(IRGS& env,
     return;
   }
 
+  // The site is polymorphic, but if only a few receiver classes showed up
+  // during profiling, emit a chain of exact class checks dispatching to each
+  // profiled method, with the generic lookup as the final link. The chain is
+  // rebuilt from fresh counts on each retranslation, so it tracks shifts in
+  // the receiver distribution.
+  if (auto const maxLen = RuntimeOption::EvalJitPGOPolyMethodChainMax) {
+    auto const polys = data.polyMethods();
+    auto const usable = [&] {
+      if (polys.size() < 2 || polys.size() > maxLen) return false;
+      uint64_t covered = 0;
+      for (auto const& entry : polys) {
+        if (!entry.meth->name()->isame(methodName)) return false;
+        covered += entry.count;
+      }
+      // Don't bother if the tracked classes cover too little of the site.
+      return covered >= 8 * data.polyUntracked();
+    }();
+    if (usable) {
+      auto const emitChain = [&] (auto const& self, size_t idx) -> void {
+        if (idx == polys.size()) {
+          fallback();
+          return;
+        }
+        auto const& entry = polys[idx];
+        ifThen(
+          env,
+          [&] (Block* sideExit) {
+            auto const ty = isStaticCall
+              ? Type::ExactCls(entry.cls) : Type::ExactObj(entry.cls);
+            auto const refined = gen(env, CheckType, ty, sideExit, objOrCls);
+            env.irb->constrainValue(refined, GuardConstraint(entry.cls));
+            auto const ctx = getCtx(entry.meth, refined, entry.cls);
+            discard(env, numExtraInputs);
+            prepareAndCallKnown(env, entry.meth, fca, ctx,
+                                dynamicCall, suppressDynCallCheck);
+          },
+          [&] {
+            updateMarker(env);
+            env.irb->exceptionStackBoundary();
+            self(self, idx + 1);
+          }
+        );
+      };
+      emitChain(emitChain, 0);
+      return;
+    }
+  }
+
   emitFCall();
 }
 
@@ -269,6 +269,7 @@ void emitCalleeCoeffectChecks(IRGS& env, const Func* callee,
 
   // If ambient coeffects are directly provided use them, otherwise extract
   // them from callFlags
+  auto const providedFromFlags = !providedCoeffects;
   if (!providedCoeffects) {
     providedCoeffects =
       gen(env, Lshr, callFlags, cns(env, CallFlags::CoeffectsStart));
@@ -283,9 +284,40 @@ void emitCalleeCoeffectChecks(IRGS& env, const Func* callee,
     return;
   }
 
+  if (!callee->hasCoeffectRules()) {
+    // The required coeffects are a translation-time constant, so fold the
+    // check here rather than emitting the generic flip-and-test.
+    auto const required = callee->requiredCoeffects().value();
+    assertx(!callee->hasCoeffectsLocal());
+
+    // Every context satisfies a callee with no required coeffects.
+    if (required == 0) return;
+
+    ifThen(
+      env,
+      [&] (Block* taken) {
+        // provided satisfies required iff provided & required == required.
+        // When provided lives in callFlags, test it in place with the
+        // required mask pre-shifted, saving the extract on the hot path.
+        auto const src = providedFromFlags ? callFlags : providedCoeffects;
+        auto const mask = providedFromFlags
+          ? static_cast<uint64_t>(required) << CallFlags::CoeffectsStart
+          : static_cast<uint64_t>(required);
+        auto const masked = gen(env, AndInt, src, cns(env, mask));
+        auto const ok = gen(env, EqInt, masked, cns(env, mask));
+        gen(env, JmpZero, taken, ok);
+      },
+      [&] {
+        hint(env, Block::Hint::Unlikely);
+        gen(env, RaiseCoeffectsCallViolation, FuncData{callee},
+            providedCoeffects, cns(env, required));
+      }
+    );
+    return;
+  }
+
   auto const requiredCoeffects = [&] {
     auto required = cns(env, callee->requiredCoeffects().value());
-    if (!callee->hasCoeffectRules()) return required;
     for (auto const& rule : callee->getCoeffectRules()) {
       if (auto const coeffect = rule.emitJit(env, callee, argc, prologueCtx,
                                              providedCoeffects)) {
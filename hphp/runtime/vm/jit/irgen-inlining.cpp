@@ -292,7 +292,7 @@ void beginInlining(IRGS& env,
     target->numParams()
     + (target->hasReifiedGenerics() ? 1U : 0U)
     + (target->hasCoeffectsLocal() ? 1U : 0U);
-  jit::vector<SSATmp*> inputs{numTotalInputs};
+  jit::small_vector<SSATmp*, 8> inputs(numTotalInputs);
   for (auto i = 0; i < numTotalInputs; ++i) {
     inputs[numTotalInputs - i - 1] = popCU(env);
   }
@@ -526,7 +526,7 @@ void implReturnBlock(IRGS& env, const RegionDesc& calleeRegion) {
     return;
   }
 
-  jit::vector<SSATmp*> retVals{nret, nullptr};
+  jit::small_vector<SSATmp*> retVals(nret, nullptr);
   for (auto& v : retVals) v = pop(env, DataTypeGeneric);
 
   implInlineReturn(env, false);
@@ -24,6 +24,7 @@
 
 #include "hphp/runtime/vm/jit/is-type-struct-profile.h"
 #include "hphp/runtime/vm/jit/guard-constraint.h"
+#include "hphp/runtime/vm/jit/target-cache.h"
 #include "hphp/runtime/vm/jit/target-profile.h"
 #include "hphp/runtime/vm/jit/type.h"
 
@@ -127,6 +128,11 @@ SSATmp* implInstanceCheck(IRGS& env, SSATmp* src, const StringData* className,
     if (InstanceBits::lookup(className) != 0) {
       return gen(env, InstanceOfBitmask, objClass, ssaClassName);
     }
+    // A refresh window may be open (see InstanceBits::resumeProfiling()):
+    // keep recording the checks which still take the slow path.
+    if (env.context.kind == TransKind::Profile && InstanceBits::profiling()) {
+      gen(env, ProfileInstanceCheck, cns(env, className));
+    }
   }
 
   // If the class is an interface, we can just hit the class's vtable or
@@ -357,7 +363,41 @@ void verifyTypeImpl(IRGS& env,
     return;
   }
 
-  verifyCls(val, gen(env, LdObjClass, val), checkCls);
+  // The slow helper resolves the named constraint and walks the class
+  // hierarchy, and its verdict for a given class is stable for the rest of
+  // the request: named entities cache their class or type alias once
+  // resolved, and the helper doesn't modify an object value. Remember the
+  // last class it accepted in a per-site RDS slot and skip the call when the
+  // same class shows up again. Falling through the helper only means the
+  // check passed when a failure is guaranteed to throw, so don't cache for
+  // soft constraints (where the helper warns and returns, and a cache hit
+  // would swallow repeat warnings).
+  auto const slowCheckThrows = RuntimeOption::RepoAuthoritative
+    && !tc.isSoft()
+    && (!tc.isUpperBound() || RuntimeOption::EvalEnforceGenericsUB >= 2)
+    && (!propCls || RuntimeOption::EvalCheckPropTypeHints >= 3);
+  if (!slowCheckThrows) {
+    verifyCls(val, gen(env, LdObjClass, val), checkCls);
+    return;
+  }
+
+  auto const objClass = gen(env, LdObjClass, val);
+  auto const handle = RDSHandleData { rds::alloc<TypedValue>().handle() };
+  auto const addr = gen(env, LdRDSAddr, handle, TCls.ptr(Ptr::Other));
+  ifThen(
+    env,
+    [&] (Block* taken) {
+      gen(env, CheckRDSInitialized, taken, handle);
+      auto const cached = gen(env, LdMem, TCls, addr);
+      gen(env, JmpZero, taken, gen(env, EqCls, cached, objClass));
+    },
+    [&] {
+      hint(env, Block::Hint::Unlikely);
+      verifyCls(val, objClass, checkCls);
+      gen(env, StMem, addr, objClass);
+      gen(env, MarkRDSInitialized, handle);
+    }
+  );
 }
 
 Type typeOpToType(IsTypeOp op) {
@@ -648,6 +688,18 @@ SSATmp* resolveTypeStructImpl(
     declaringCls && typeStructureCouldBeNonStatic
       ? ldCtxCls(env)
       : cns(env, nullptr);
+  // A constant type structure resolves the same way every time this site is
+  // reached with the same called class. If the called class is statically
+  // known too, the result is fully determined by the site, so the structure
+  // can use the same per-site RDS cache as static structures. Otherwise hand
+  // the helper a per-site (class, result) cache to probe before resolving.
+  auto const constantTS = n == 1 && topC(env)->hasConstVal(TDict);
+  auto const siteDetermined =
+    !typeStructureCouldBeNonStatic ||
+    (constantTS && calledCls->hasConstVal(TCls));
+  auto const cacheHandle = !siteDetermined && constantTS
+    ? rds::alloc<TSResolveCache>().handle()
+    : rds::kUninitHandle;
   auto const result = resolveTypeStructureAndCacheInRDS(
     env,
     [&] {
@@ -659,13 +711,14 @@ SSATmp* resolveTypeStructImpl(
           suppress,
           spOffBCFromIRSP(env),
           static_cast<uint32_t>(n),
-          isOrAsOp
+          isOrAsOp,
+          cacheHandle
         },
         sp(env),
         calledCls
       );
     },
-    typeStructureCouldBeNonStatic
+    !siteDetermined
   );
   popC(env);
   discard(env, n - 1);
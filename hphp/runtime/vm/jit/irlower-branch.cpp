@@ -17,6 +17,7 @@
 #include "hphp/runtime/vm/jit/irlower-internal.h"
 
 #include "hphp/runtime/base/runtime-option.h"
+#include "hphp/runtime/base/string-data.h"
 #include "hphp/runtime/base/tv-comparisons.h"
 #include "hphp/runtime/base/tv-mutate.h"
 #include "hphp/runtime/base/tv-variant.h"
@@ -41,8 +42,11 @@
 #include "hphp/runtime/vm/resumable.h"
 
 #include "hphp/util/asm-x64.h"
+#include "hphp/util/hash.h"
 #include "hphp/util/trace.h"
 
+#include <folly/lang/Bits.h>
+
 namespace HPHP { namespace jit { namespace irlower {
 
 TRACE_SET_MOD(irlower);
@@ -333,6 +337,37 @@ TCA sswitchHelper(const StringData* val,
   return dest ? *dest : *def;
 }
 
+/*
+ * An open-addressed table slot for the inline fast path of a string switch:
+ * the interned case string (nullptr for an empty slot) and its target.
+ */
+struct SSwitchTableEntry {
+  const StringData* str;
+  TCA target;
+};
+
+/*
+ * Find a power-of-two table size, at most kMaxSSwitchTableSize, for which the
+ * masked hashes of all the case strings land in distinct slots, i.e. a
+ * collision-free (perfect) hash table. Returns 0 if there is none, e.g. when
+ * two case strings have equal hashes.
+ */
+size_t findSSwitchTableSize(const LdSSwitchData* extra) {
+  constexpr size_t kMaxSSwitchTableSize = 1024;
+  auto const minSize = folly::nextPowTwo(uint64_t{2} * extra->numCases);
+  for (auto size = minSize; size <= kMaxSSwitchTableSize; size <<= 1) {
+    std::vector<bool> taken(size, false);
+    auto ok = true;
+    for (int64_t i = 0; i < extra->numCases && ok; ++i) {
+      auto const slot = extra->cases[i].str->hash() & (size - 1);
+      if (taken[slot]) ok = false;
+      taken[slot] = true;
+    }
+    if (ok) return size;
+  }
+  return 0;
+}
+
 }
 
 void cgLdSSwitchDest(IRLS& env, const IRInstruction* inst) {
@@ -365,13 +400,86 @@ void cgLdSSwitchDest(IRLS& env, const IRInstruction* inst) {
   auto const def = v.allocData<TCA>();
   v << bindaddr{def, extra->defaultSk, extra->bcSPOff};
 
-  auto const args = argGroup(env, inst)
-    .ssa(0)
-    .dataPtr(table)
-    .dataPtr(def);
+  auto const minCases = RuntimeOption::EvalJitSSwitchTableMinCases;
+  auto const tableSize = minCases && extra->numCases >= minCases
+    ? findSSwitchTableSize(extra)
+    : 0;
+
+  if (!tableSize) {
+    auto const args = argGroup(env, inst)
+      .ssa(0)
+      .dataPtr(table)
+      .dataPtr(def);
+
+    cgCallHelper(v, env, CallSpec::direct(sswitchHelper),
+                 callDest(env, inst), SyncOptions::None, args);
+    return;
+  }
+
+  // Switches with many arms get an inline probe of a collision-free hash
+  // table keyed on the case strings' hashes. The probe hits only when the
+  // subject is the interned case string itself, which makes pointer equality
+  // sufficient; on a miss (cold subject, uncached hash, or a content-equal
+  // non-interned string) we fall back to sswitchHelper, which is always
+  // correct. Empty slots keep nullptr keys and so also miss to the helper.
+  auto const jmpTable = v.allocData<SSwitchTableEntry>(tableSize);
+  for (size_t i = 0; i < tableSize; ++i) {
+    jmpTable[i] = SSwitchTableEntry { nullptr, nullptr };
+  }
+  for (int64_t i = 0; i < extra->numCases; ++i) {
+    auto const slot = extra->cases[i].str->hash() & (tableSize - 1);
+    jmpTable[slot].str = extra->cases[i].str;
+    v << bindaddr{&jmpTable[slot].target, extra->cases[i].dest, extra->bcSPOff};
+  }
+
+  auto const doHelper = [&] (Vout& v) {
+    auto const ret = v.makeReg();
+    auto const args = argGroup(env, inst)
+      .ssa(0)
+      .dataPtr(table)
+      .dataPtr(def);
+    cgCallHelper(v, env, CallSpec::direct(sswitchHelper),
+                 callDest(ret), SyncOptions::None, args);
+    return ret;
+  };
+
+  auto const subject = srcLoc(env, inst, 0).reg();
+  auto const dst = dstLoc(env, inst, 0).reg();
+
+  auto const rawHash = v.makeReg();
+  auto const hash = v.makeReg();
+  auto const sfHash = v.makeReg();
+  v << loadzlq{subject[StringData::hashOff()], rawHash};
+  v << andqi{STRHASH_MASK, rawHash, hash, v.makeReg()};
+  v << testq{hash, hash, sfHash};
 
-  cgCallHelper(v, env, CallSpec::direct(sswitchHelper),
-               callDest(env, inst), SyncOptions::None, args);
+  unlikelyCond(
+    v, vcold(env), CC_Z, sfHash, dst,
+    doHelper,
+    [&] (Vout& v) {
+      static_assert(sizeof(SSwitchTableEntry) == 16, "");
+      auto const idx = v.makeReg();
+      auto const idx2 = v.makeReg();
+      auto const base = v.makeReg();
+      auto const hit = v.makeReg();
+      auto const sfEq = v.makeReg();
+      v << andqi{safe_cast<int>(tableSize - 1), hash, idx, v.makeReg()};
+      // Scale the index by sizeof(SSwitchTableEntry), via idx2 = 2 * idx.
+      v << lea{idx[idx], idx2};
+      v << lead{jmpTable, base};
+      v << load{base[idx2 * 8], hit};
+      v << cmpq{hit, subject, sfEq};
+      return unlikelyCond(
+        v, vcold(env), CC_NE, sfEq, v.makeReg(),
+        doHelper,
+        [&] (Vout& v) {
+          auto const target = v.makeReg();
+          v << load{base[idx2 * 8 + 8], target};
+          return target;
+        }
+      );
+    }
+  );
 }
 
 
@@ -296,6 +296,18 @@ void emitTypeCheck(Vout& v, IRLS& env, Type type,
                    Loc typeSrc, Loc dataSrc, Block* taken) {
   emitTypeTest(v, env, type, typeSrc, dataSrc, v.makeReg(),
     [&] (ConditionCode cc, Vreg sf) {
+      if (RuntimeOption::EvalJitProfileGuardTypes) {
+        // Count the failure on the side-exit edge, so the fall-through path
+        // doesn't grow.
+        auto const fail = v.makeBlock();
+        auto const next = v.makeBlock();
+        v << jcc{ccNegate(cc), sf, {next, fail}};
+        v = fail;
+        emitProfileGuardFailure(v, type);
+        v << jmp{label(env, taken)};
+        v = next;
+        return;
+      }
       fwdJcc(v, env, ccNegate(cc), sf, taken);
     }
   );
@@ -408,8 +408,44 @@ void implDecRef(Vout& v, IRLS& env,
   auto const base = srcLoc(env, inst, 0).reg(0);
 
   auto const destroy = [&] (Vout& v) {
+    auto const loc = srcLoc(env, inst, 0);
+
+    // If profiling saw exactly one refcounted type here but lowering can't
+    // prove it, test for that type and call its release function directly,
+    // keeping the generic table dispatch as the cold fallback. This only
+    // applies where makeDtorCall would otherwise emit the indirect dispatch.
+    auto const profiledType = profile.optimizing()
+      ? profile.data().uniqueRefcountedType()
+      : kInvalidDataType;
+    if (RuntimeOption::EvalJitPGOTypedDecRefDtor &&
+        profiledType != kInvalidDataType &&
+        !ty.isKnownDataType() && !(ty <= TObj) &&
+        !(ty <= TArrLike && allowBespokeArrayLikes())) {
+      FTRACE(3, "irlower-refcount: direct dtor for {} in {}\n",
+             tname(profiledType), *inst);
+      auto const sf = v.makeReg();
+      emitCmpTVType(v, sf, profiledType, loc.reg(1));
+      ifThenElse(
+        v, vcold(env), CC_NE, sf,
+        [&] (Vout& v) {
+          auto args = argGroup(env, inst).reg(base);
+          cgCallHelper(v, env, CallSpec::destruct(loc.reg(1)), kVoidDest,
+                       SyncOptions::None, args);
+        },
+        [&] (Vout& v) {
+          auto args = argGroup(env, inst).reg(base);
+          cgCallHelper(v, env,
+                       CallSpec::direct(destructorForType(profiledType)),
+                       kVoidDest, SyncOptions::None, args);
+        },
+        true /* unlikely */,
+        tag_from_string("decref-profiled-type")
+      );
+      return;
+    }
+
     auto args = argGroup(env, inst).reg(base);
-    auto const dtor = makeDtorCall(v, ty, srcLoc(env, inst, 0), args);
+    auto const dtor = makeDtorCall(v, ty, loc, args);
     cgCallHelper(v, env, dtor, kVoidDest, SyncOptions::None, args);
   };
 
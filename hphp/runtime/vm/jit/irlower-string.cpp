@@ -131,6 +131,9 @@ IMPL_OPCODE_CALL(ConcatStr4);
 
 IMPL_OPCODE_CALL(StringGet)
 
+IMPL_OPCODE_CALL(StrHasPrefix)
+IMPL_OPCODE_CALL(StrHasSuffix)
+
 ///////////////////////////////////////////////////////////////////////////////
 
 }}}
@@ -270,7 +270,8 @@ void cgResolveTypeStruct(IRLS& env, const IRInstruction* inst) {
     .imm(extra->cls)       // declaring cls
     .ssa(1)                // called cls
     .imm(extra->suppress)  // suppress
-    .imm(extra->isOrAsOp); // isOrAsOp
+    .imm(extra->isOrAsOp)  // isOrAsOp
+    .imm(extra->handle);   // resolution cache (kUninitHandle if none)
 
   cgCallHelper(v, env, CallSpec::direct(resolveTypeStructHelper),
                callDest(env, inst), SyncOptions::Sync, args);
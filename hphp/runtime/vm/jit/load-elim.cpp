@@ -765,7 +765,7 @@ Flags analyze_inst(Local& env, const IRInstruction& inst) {
  * edges.
  */
 void prepare_predecessors_for_phi(Global& env, Block* block) {
-  auto preds = jit::vector<Block*>{};
+  auto preds = jit::small_vector<Block*>{};
   block->forEachPred([&] (Block* b) { preds.push_back(b); });
 
   for (auto& pred : preds) {
@@ -0,0 +1,304 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010-present Facebook, Inc. (http://www.facebook.com)  |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include "hphp/runtime/vm/jit/opt.h"
+
+#include "hphp/runtime/base/runtime-option.h"
+
+#include "hphp/runtime/vm/jit/block.h"
+#include "hphp/runtime/vm/jit/cfg.h"
+#include "hphp/runtime/vm/jit/containers.h"
+#include "hphp/runtime/vm/jit/ir-unit.h"
+#include "hphp/runtime/vm/jit/mutation.h"
+#include "hphp/runtime/vm/jit/pass-tracer.h"
+#include "hphp/runtime/vm/jit/timer.h"
+
+#include "hphp/util/optional.h"
+#include "hphp/util/trace.h"
+
+namespace HPHP { namespace jit {
+
+TRACE_SET_MOD(hhir_loop);
+
+namespace {
+
+//////////////////////////////////////////////////////////////////////
+
+/*
+ * A loop we intend to peel.
+ *
+ * `blocks' is the loop's natural loop, grown to include any trailing blocks
+ * (e.g., side exits) which are only reachable from within it.  The resulting
+ * region can only be entered at `header', via `entries'.
+ */
+struct PeelCandidate {
+  Block* header;
+  jit::flat_set<Block*> blocks;
+  jit::vector<Edge*> entries;
+  uint64_t numInsts{0};
+};
+
+/*
+ * Build a PeelCandidate for the loop at `header', or return std::nullopt if
+ * the loop fails any of our profitability or legality checks.
+ *
+ * `backSrcs' are the sources of the loop's back edges.
+ */
+Optional<PeelCandidate> buildCandidate(const IRUnit& unit,
+                                       const BlockList& rpo,
+                                       Block* header,
+                                       const jit::vector<Block*>& backSrcs) {
+  auto cand = PeelCandidate{};
+  cand.header = header;
+  auto& region = cand.blocks;
+
+  // Collect the natural loop: everything which reaches a back edge source
+  // without passing through the header.
+  region.insert(header);
+  auto wl = backSrcs;
+  while (!wl.empty()) {
+    auto const b = wl.back();
+    wl.pop_back();
+    if (!region.insert(b).second) continue;
+    for (auto const& e : b->preds()) {
+      if (!region.count(e.from())) wl.push_back(e.from());
+    }
+  }
+
+  // Grow the region with successor blocks all of whose predecessors are
+  // already inside it---typically side exits off the loop.  This lets us peel
+  // loops whose values escape only into such exits, since the peeled copies
+  // of the exits will use the peeled values.
+  auto grew = true;
+  while (grew) {
+    grew = false;
+    jit::vector<Block*> adds;
+    for (auto const b : region) {
+      auto const consider = [&] (Block* t) {
+        if (!t || t == unit.entry() || region.count(t)) return;
+        for (auto const& e : t->preds()) {
+          if (!region.count(e.from())) return;
+        }
+        adds.push_back(t);
+      };
+      consider(b->next());
+      consider(b->taken());
+    }
+    for (auto const t : adds) grew |= region.insert(t).second;
+  }
+
+  for (auto const b : region) {
+    cand.numInsts += b->instrs().size();
+  }
+  if (cand.numInsts > RuntimeOption::EvalHHIRLoopPeelingMaxInsts) {
+    FTRACE(2, "  reject B{}: too large ({} insts)\n",
+           header->id(), cand.numInsts);
+    return std::nullopt;
+  }
+
+  // Only peel loops which the profile says iterate: the header should be
+  // substantially hotter than the blocks entering the loop.
+  auto entryCount = uint64_t{0};
+  for (auto& e : header->preds()) {
+    if (region.count(e.from())) continue;
+    cand.entries.push_back(&e);
+    entryCount += e.from()->profCount();
+  }
+  if (cand.entries.empty()) return std::nullopt;
+
+  auto const minTrips = RuntimeOption::EvalHHIRLoopPeelingMinTripCount;
+  if (header->profCount() < entryCount * minTrips) {
+    FTRACE(2, "  reject B{}: cold (header {} vs entry {})\n",
+           header->id(), header->profCount(), entryCount);
+    return std::nullopt;
+  }
+
+  // Any tmp defined in the region must only be used inside of it.  (Values
+  // may still escape into a join point's DefLabel, since the Jmps providing
+  // them are themselves part of the region.)
+  for (auto const b : rpo) {
+    if (region.count(b)) continue;
+    for (auto const& inst : *b) {
+      for (auto const src : inst.srcs()) {
+        auto const def = src->inst()->block();
+        if (def && region.count(def)) {
+          FTRACE(2, "  reject B{}: {} escapes to B{}\n",
+                 header->id(), src->toString(), b->id());
+          return std::nullopt;
+        }
+      }
+    }
+  }
+
+  return cand;
+}
+
+/*
+ * Find a peelable loop in `unit', ignoring loops whose headers are in
+ * `peeled'.
+ */
+Optional<PeelCandidate> findCandidate(const IRUnit& unit,
+                                      const jit::flat_set<Block*>& peeled) {
+  auto const rpo = rpoSortCfg(unit);
+  auto const ids = numberBlocks(unit, rpo);
+  auto const idoms = findDominators(unit, rpo, ids);
+
+  // Group natural back edges by their loop header.  Irreducible loops are
+  // skipped, as are any retreating edges created by prior peels.
+  jit::hash_map<Block*, jit::vector<Block*>> backSrcs;
+  for (auto const e : findRetreatingEdges(unit)) {
+    if (dominates(e->to(), e->from(), idoms)) {
+      backSrcs[e->to()].push_back(e->from());
+    }
+  }
+
+  for (auto const header : rpo) {
+    auto const it = backSrcs.find(header);
+    if (it == backSrcs.end()) continue;
+    if (header == unit.entry() || peeled.count(header)) continue;
+
+    if (auto cand = buildCandidate(unit, rpo, header, it->second)) {
+      return cand;
+    }
+  }
+  return std::nullopt;
+}
+
+/*
+ * Peel one iteration off of `cand', by cloning the whole region and sending
+ * the loop's entries into the clone.  The clone's back edges target the
+ * original loop, whose header then joins only values that went around the
+ * loop---so its DefLabel types (and everything derived from them) can be
+ * refined without regard for the values live on loop entry.
+ */
+void peel(IRUnit& unit, const PeelCandidate& cand) {
+  auto const header = cand.header;
+
+  // Order the region in RPO, so that each tmp is cloned before its uses.
+  jit::vector<Block*> order;
+  for (auto const b : rpoSortCfg(unit)) {
+    if (cand.blocks.count(b)) order.push_back(b);
+  }
+  assertx(!order.empty() && order.front() == header);
+
+  jit::hash_map<Block*, Block*> blockMap;
+  jit::hash_map<SSATmp*, SSATmp*> tmpMap;
+
+  for (auto const b : order) {
+    blockMap[b] = unit.defBlock(b->profCount(), b->hint());
+  }
+
+  auto const mapTmp = [&] (SSATmp* t) {
+    auto const it = tmpMap.find(t);
+    return it != tmpMap.end() ? it->second : t;
+  };
+  auto const mapTarget = [&] (Block* t) -> Block* {
+    // Back edges in the clone continue to target the original header.
+    if (!t || t == header) return t;
+    auto const it = blockMap.find(t);
+    return it != blockMap.end() ? it->second : t;
+  };
+
+  for (auto const b : order) {
+    auto const nb = blockMap[b];
+
+    for (auto& inst : *b) {
+      if (inst.is(DefLabel)) {
+        auto const label = unit.defLabel(inst.numDsts(), nb, inst.bcctx());
+        for (unsigned i = 0; i < inst.numDsts(); ++i) {
+          tmpMap[inst.dst(i)] = label->dst(i);
+        }
+        continue;
+      }
+
+      auto const ninst = unit.clone(&inst);
+      for (uint32_t i = 0; i < ninst->numSrcs(); ++i) {
+        ninst->setSrc(i, mapTmp(ninst->src(i)));
+      }
+      for (uint32_t i = 0; i < inst.numDsts(); ++i) {
+        tmpMap[inst.dst(i)] = ninst->dst(i);
+      }
+      nb->push_back(ninst);
+      if (ninst->hasEdges()) {
+        ninst->setNext(mapTarget(ninst->next()));
+        ninst->setTaken(mapTarget(ninst->taken()));
+      }
+    }
+  }
+
+  // Send the loop's entries into the peeled copy.
+  auto const peeledHeader = blockMap[header];
+  for (auto const e : cand.entries) {
+    auto const inst = e->inst();
+    if (e == inst->takenEdge()) {
+      inst->setTaken(peeledHeader);
+    } else {
+      assertx(e == inst->nextEdge());
+      inst->setNext(peeledHeader);
+    }
+  }
+
+  // The peeled copy executes once per loop entry, so scale its profCounts
+  // down accordingly.
+  auto entryCount = uint64_t{0};
+  for (auto& e : peeledHeader->preds()) {
+    entryCount += e.from()->profCount();
+  }
+  auto const headerCount = std::max<uint64_t>(header->profCount(), 1);
+  for (auto const b : order) {
+    auto const scaled = static_cast<uint64_t>(
+      b->profCount() * (static_cast<double>(entryCount) / headerCount)
+    );
+    blockMap[b]->setProfCount(std::max<uint64_t>(scaled, 1));
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+
+}
+
+/*
+ * Peel one iteration off of each sufficiently hot, sufficiently small loop.
+ *
+ * We don't unroll loop bodies beyond the first iteration: without the peel,
+ * the values live on loop entry are merged into the loop's phis, so every
+ * loop-invariant guard and type check is pinned by the unknown first
+ * iteration.  Peeling moves that first iteration out of the loop, and leaves
+ * the simplifier, GVN, and the memory optimizations to clean up both copies.
+ */
+void peelHotLoops(IRUnit& unit) {
+  PassTracer tracer{&unit, Trace::hhir_loop, "peelHotLoops"};
+  Timer t(Timer::optimize_peelHotLoops, unit.logEntry().get_pointer());
+
+  constexpr auto kMaxPeelsPerUnit = 4;
+
+  jit::flat_set<Block*> peeled;
+  while (peeled.size() < kMaxPeelsPerUnit) {
+    auto const cand = findCandidate(unit, peeled);
+    if (!cand) break;
+
+    FTRACE(1, "peeling loop at B{}: {} blocks, {} insts\n",
+           cand->header->id(), cand->blocks.size(), cand->numInsts);
+    peel(unit, *cand);
+    peeled.insert(cand->header);
+  }
+
+  if (!peeled.empty()) reflowTypes(unit);
+}
+
+//////////////////////////////////////////////////////////////////////
+
+}}
@@ -476,6 +476,7 @@ void retranslateAll(bool skipSerialize) {
   // This will enable live translations to happen again.
   s_retranslateAllComplete.store(true, std::memory_order_release);
   tc::reportJitMaturity();
+  tc::hugifyHotCode();
 
   if (serverMode && !transdb::enabled() && !serializeOpt) {
     ProfData::Session pds;
@@ -566,7 +567,10 @@ TranslationResult retranslate(TransArgs args, const RegionContext& ctx) {
 bool retranslateOpt(FuncId funcId) {
   VMProtect _;
 
-  if (isDebuggerAttachedProcess()) return false;
+  // Only suppress optimized retranslation for the request being debugged;
+  // a debugger attached to another request shouldn't block publishing
+  // optimized code for everyone else.
+  if (isDebuggerAttached()) return false;
 
   auto const func = const_cast<Func*>(Func::fromFuncId(funcId));
   if (profData() == nullptr) return false;
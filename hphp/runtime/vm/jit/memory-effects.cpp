@@ -1112,8 +1112,17 @@ MemEffects memory_effects_impl(const IRInstruction& inst) {
     auto const key = inst.src(1);
     return PureLoad { AElemS { base, key->strVal() } };
   }
-  case StructDictGetWithColor:
-    return PureLoad { AElemSAny };
+  case StructDictGetWithColor: {
+    // The struct layout may be abstract, in which case the simplifier keeps
+    // this op even for constant keys; such a key still names a single field,
+    // so report the precise element class and let load-elim forward the value
+    // across stores to other fields of the same dict.
+    auto const base = inst.src(0);
+    auto const key = inst.src(1);
+    return PureLoad {
+      key->hasConstVal() ? AElemS { base, key->strVal() } : AElemSAny
+    };
+  }
 
   case DictGetK:
   case KeysetGetK:
@@ -1514,6 +1523,12 @@ MemEffects memory_effects_impl(const IRInstruction& inst) {
       extra->offset,
       extra->offset + static_cast<int32_t>(extra->size)
     );
+    if (extra->handle != rds::kUninitHandle) {
+      // The helper probes and fills a per-site resolution cache.
+      auto const cache = AliasClass(ARds { extra->handle });
+      return may_load_store(AliasClass(stack_in)|AHeapAny|cache,
+                            AHeapAny|cache);
+    }
     return may_load_store(AliasClass(stack_in)|AHeapAny, AHeapAny);
   }
 
@@ -1773,6 +1788,8 @@ MemEffects memory_effects_impl(const IRInstruction& inst) {
   case SameStr:
   case NSameStr:
   case CmpStr:
+  case StrHasPrefix:
+  case StrHasSuffix:
   case GtRes:
   case GteRes:
   case LtRes:
@@ -24,13 +24,55 @@
 
 #include <folly/Format.h>
 
+#include <algorithm>
 #include <string>
 
 namespace HPHP { namespace jit {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void MethProfile::addPolyCount(const Class* cls, const Func* meth,
+                               uint32_t count) {
+  assertx(cls);
+  for (auto i = 0u; i < kMaxPolyClasses; ++i) {
+    if (m_polyClasses[i].get() == cls) {
+      m_polyCounts[i].fetch_add(count, std::memory_order_relaxed);
+      return;
+    }
+    if (!m_polyClasses[i].get()) {
+      // Publish the class last: see the comment on m_polyClasses.
+      m_polyMeths[i] = meth;
+      m_polyCounts[i].store(count, std::memory_order_relaxed);
+      m_polyClasses[i] = cls;
+      return;
+    }
+  }
+  m_untracked.fetch_add(count, std::memory_order_relaxed);
+}
+
+std::vector<MethProfile::PolyEntry> MethProfile::polyMethods() const {
+  std::vector<PolyEntry> ret;
+  for (auto i = 0u; i < kMaxPolyClasses; ++i) {
+    auto const cls = m_polyClasses[i].get();
+    if (!cls) break;
+    auto const meth = m_polyMeths[i].get();
+    auto const count = m_polyCounts[i].load(std::memory_order_relaxed);
+    if (!meth || !count) continue;
+    ret.push_back(PolyEntry { cls, meth, count });
+  }
+  std::sort(ret.begin(), ret.end(),
+            [] (const PolyEntry& a, const PolyEntry& b) {
+              return a.count > b.count;
+            });
+  return ret;
+}
+
 void MethProfile::reportMeth(const Class* cls, const Func* meth) {
+  if (cls) addPolyCount(cls, meth, 1);
+  reportMethImpl(cls, meth);
+}
+
+void MethProfile::reportMethImpl(const Class* cls, const Func* meth) {
   auto val = methValue();
   if (!val) {
     assertx(cls);
@@ -79,6 +121,19 @@ void MethProfile::reportMeth(const Class* cls, const Func* meth) {
 }
 
 void MethProfile::reduce(MethProfile& a, const MethProfile& b) {
+  // Merge the per-class tables first: they matter most for the sites the tag
+  // machinery below gives up on. Slots are published class-last, so a
+  // non-null class implies a consistent method; counts may lag, in which
+  // case polyMethods() drops the entry.
+  for (auto i = 0u; i < kMaxPolyClasses; ++i) {
+    auto const cls = b.m_polyClasses[i].get();
+    if (!cls) break;
+    auto const meth = b.m_polyMeths[i].get();
+    auto const count = b.m_polyCounts[i].load(std::memory_order_relaxed);
+    if (meth && count) a.addPolyCount(cls, meth, count);
+  }
+  a.m_untracked.fetch_add(b.polyUntracked(), std::memory_order_relaxed);
+
   if (a.curTag() == Tag::Invalid) return;
 
   uintptr_t bMethVal;
@@ -93,7 +148,7 @@ void MethProfile::reduce(MethProfile& a, const MethProfile& b) {
       continue;
     }
     assertx(cls);
-    a.reportMeth(cls, fromValue(bMethVal));
+    a.reportMethImpl(cls, fromValue(bMethVal));
     return;
   }
 
@@ -114,7 +169,7 @@ void MethProfile::reduce(MethProfile& a, const MethProfile& b) {
     return;
   }
 
-  a.reportMeth(nullptr, meth);
+  a.reportMethImpl(nullptr, meth);
   if (a.curTag() == Tag::UniqueMeth && toTag(bMethVal) == Tag::BaseMeth) {
     a.setMeth(meth, Tag::BaseMeth);
   }
@@ -161,6 +216,13 @@ void MethProfile::serialize(ProfDataSerializer& ser) const {
   write_raw(ser, curTag());
   write_func(ser, rawMeth());
   write_class(ser, rawClass());
+  for (auto i = 0u; i < kMaxPolyClasses; ++i) {
+    auto const cls = m_polyClasses[i].get();
+    write_class(ser, cls);
+    write_func(ser, cls ? m_polyMeths[i].get() : nullptr);
+    write_raw(ser, m_polyCounts[i].load(std::memory_order_relaxed));
+  }
+  write_raw(ser, polyUntracked());
 }
 
 void MethProfile::deserialize(ProfDataDeserializer& ser) {
@@ -168,6 +230,12 @@ void MethProfile::deserialize(ProfDataDeserializer& ser) {
   auto const func = read_func(ser);
   setMeth(func, tag);
   m_curClass = read_class(ser);
+  for (auto i = 0u; i < kMaxPolyClasses; ++i) {
+    m_polyClasses[i] = read_class(ser);
+    m_polyMeths[i] = read_func(ser);
+    m_polyCounts[i].store(read_raw<uint32_t>(ser), std::memory_order_relaxed);
+  }
+  m_untracked.store(read_raw<uint32_t>(ser), std::memory_order_relaxed);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -18,6 +18,9 @@
 
 #include <folly/dynamic.h>
 
+#include <atomic>
+#include <vector>
+
 #include "hphp/runtime/base/object-data.h"
 #include "hphp/runtime/vm/act-rec.h"
 #include "hphp/runtime/vm/func.h"
@@ -48,12 +51,28 @@ struct MethProfile {
 
   /////////////////////////////////////////////////////////////////////////////
 
-  MethProfile() : m_curMeth(nullptr), m_curClass(nullptr) {}
+  MethProfile() : m_curMeth(nullptr), m_curClass(nullptr) {
+    for (auto i = 0u; i < kMaxPolyClasses; ++i) {
+      m_polyClasses[i] = nullptr;
+      m_polyMeths[i] = nullptr;
+      m_polyCounts[i].store(0, std::memory_order_relaxed);
+    }
+  }
 
   MethProfile(const MethProfile& other)
     : m_curMeth(other.m_curMeth)
     , m_curClass(other.m_curClass)
-  {}
+  {
+    for (auto i = 0u; i < kMaxPolyClasses; ++i) {
+      m_polyClasses[i] = other.m_polyClasses[i].get();
+      m_polyMeths[i] = other.m_polyMeths[i].get();
+      m_polyCounts[i].store(
+        other.m_polyCounts[i].load(std::memory_order_relaxed),
+        std::memory_order_relaxed
+      );
+    }
+    m_untracked.store(other.polyUntracked(), std::memory_order_relaxed);
+  }
 
   std::string toString() const;
   folly::dynamic toDynamic() const;
@@ -75,6 +94,32 @@ struct MethProfile {
     return curTag() == Tag::InterfaceMeth ? rawMeth() : nullptr;
   }
 
+  /*
+   * Per-receiver-class counts, tracked independently of the tag machinery
+   * above so that sites it writes off as Invalid can still be devirtualized
+   * with a chain of exact class checks when only a few classes show up.
+   */
+  static constexpr uint32_t kMaxPolyClasses = 4;
+
+  struct PolyEntry {
+    const Class* cls;
+    const Func* meth;
+    uint32_t count;
+  };
+
+  /*
+   * The receiver classes seen at this site, hottest first. Entries whose
+   * class or method raced away are dropped.
+   */
+  std::vector<PolyEntry> polyMethods() const;
+
+  /*
+   * Calls whose receiver class didn't fit in the table.
+   */
+  uint32_t polyUntracked() const {
+    return m_untracked.load(std::memory_order_relaxed);
+  }
+
   /*
    * Register a call to the callee frame `ar'.
    *
@@ -117,11 +162,30 @@ private:
     m_curMeth = encoded_meth;
   }
 
+  void addPolyCount(const Class* cls, const Func* meth, uint32_t count);
+
+  /*
+   * The tag-transition logic of reportMeth, without the per-class counting;
+   * reduce() uses this to avoid double counting merged tables.
+   */
+  void reportMethImpl(const Class* cls, const Func* meth);
+
 private:
   AtomicLowPtr<const Func,
                std::memory_order_acquire, std::memory_order_release> m_curMeth;
   AtomicLowPtr<const Class,
                std::memory_order_acquire, std::memory_order_release> m_curClass;
+
+  // The class is the last field published for a slot, so a reader that sees
+  // it non-null also sees the slot's method and initial count.
+  AtomicLowPtr<const Class,
+               std::memory_order_acquire,
+               std::memory_order_release> m_polyClasses[kMaxPolyClasses];
+  AtomicLowPtr<const Func,
+               std::memory_order_acquire,
+               std::memory_order_release> m_polyMeths[kMaxPolyClasses];
+  std::atomic<uint32_t> m_polyCounts[kMaxPolyClasses];
+  std::atomic<uint32_t> m_untracked{0};
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -199,7 +199,7 @@ static CallMap s_callMap {
                            {{extra(&ClassData::cls)}}},
     {InitSProps,         &Class::initSProps, DNone, SSync,
                            {{extra(&ClassData::cls)}}},
-    {DebugBacktrace,     debug_backtrace_jit, DSSA, SSync, {{SSA, 0}}},
+    {DebugBacktrace,     debug_backtrace_jit, DTV, SSync, {{SSA, 0}}},
     {InitThrowableFileAndLine,
                          throwable_init_file_and_line_from_builtin,
                            DNone, debug ? SSync : SNone, {{SSA, 0}}},
@@ -310,9 +310,9 @@ static CallMap s_callMap {
                           {{SSA, 0}, {SSA, 1}}},
     {LteStr,             static_cast<StrCmpFn>(lessEqual), DSSA, SNone,
                           {{SSA, 0}, {SSA, 1}}},
-    {EqStr,              static_cast<StrCmpFn>(equal), DSSA, SSync,
+    {EqStr,              static_cast<StrCmpFn>(equal), DSSA, SNone,
                           {{SSA, 0}, {SSA, 1}}},
-    {NeqStr,             static_cast<StrCmpFn>(nequal), DSSA, SSync,
+    {NeqStr,             static_cast<StrCmpFn>(nequal), DSSA, SNone,
                           {{SSA, 0}, {SSA, 1}}},
     {SameStr,            static_cast<StrCmpFn>(same), DSSA, SNone,
                           {{SSA, 0}, {SSA, 1}}},
@@ -320,6 +320,10 @@ static CallMap s_callMap {
                           {{SSA, 0}, {SSA, 1}}},
     {CmpStr,             static_cast<StrCmpFnInt>(compare), DSSA, SNone,
                           {{SSA, 0}, {SSA, 1}}},
+    {StrHasPrefix,       strHasPrefixHelper, DSSA, SNone,
+                          {{SSA, 0}, {SSA, 1}}},
+    {StrHasSuffix,       strHasSuffixHelper, DSSA, SNone,
+                          {{SSA, 0}, {SSA, 1}}},
     {GtObj,              static_cast<ObjCmpFn>(more), DSSA, SSync,
                           {{SSA, 0}, {SSA, 1}}},
     {GteObj,             static_cast<ObjCmpFn>(moreEqual), DSSA, SSync,
@@ -209,6 +209,12 @@ void optimize(IRUnit& unit, TransKind kind) {
     doPass(unit, gvn, DCE::Full);
   }
 
+  if (kind == TransKind::Optimize && RuntimeOption::EvalHHIRLoopPeeling) {
+    rqtrace::EventGuard trace{"OPT_PEEL"};
+    doPass(unit, peelHotLoops, DCE::Full);
+    printUnit(6, unit, " after peelHotLoops ");
+  }
+
   auto inline_returns = count_inline_returns(unit);
   while (true) {
     if (kind != TransKind::Profile && RuntimeOption::EvalHHIRMemoryOpts) {
@@ -39,6 +39,7 @@ void optimizeStores(IRUnit&);
 void optimizeVanillaChecks(IRUnit&);
 void cleanCfg(IRUnit&);
 bool optimizePhis(IRUnit&);
+void peelHotLoops(IRUnit&);
 
 /*
  * For debugging, we can run this pass, which inserts various sanity checking
@@ -71,8 +71,14 @@
 #include "hphp/util/service-data.h"
 
 #include <folly/portability/Unistd.h>
+#include <folly/hash/Hash.h>
 #include <folly/String.h>
 
+#include <algorithm>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 namespace HPHP { namespace jit {
 //////////////////////////////////////////////////////////////////////
 
@@ -1020,6 +1026,298 @@ std::string mangleFilenameForAppendInProgress(const std::string& name) {
   return name + ".part3";
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Delta-encoded profile dumps (Eval.JitSerdesDeltaBase).
+ *
+ * Consecutive builds share most of their profile content, so instead of
+ * shipping the full dump on every deploy we can ship its delta against a base
+ * snapshot. The delta is an rsync-style block diff of the serialized byte
+ * stream: the base is indexed in kDeltaBlockSize blocks, the new dump is
+ * scanned with a rolling checksum, and the output is a sequence of
+ * copy-from-base and literal ops. Since it operates below the record format,
+ * it needs no knowledge of the stream's contents and tolerates insertions
+ * and deletions at arbitrary offsets.
+ *
+ * On load, the full stream is reconstructed up front from the mmapped base,
+ * so the shared bulk is copied page-by-page rather than re-read and the
+ * deserializer then serves reads from memory.
+ */
+constexpr uint32_t kDeltaMagic = 0x444d5648;
+constexpr uint32_t kDeltaVersion = 1;
+constexpr size_t kDeltaBlockSize = 4096;
+constexpr uint8_t kDeltaOpCopy = 0;
+constexpr uint8_t kDeltaOpLiteral = 1;
+
+struct MappedFile {
+  explicit MappedFile(const std::string& path) {
+    auto const fd = open(path.c_str(), O_CLOEXEC | O_RDONLY);
+    if (fd == -1) return;
+    SCOPE_EXIT { close(fd); };
+    struct stat st;
+    if (fstat(fd, &st) == -1 || st.st_size == 0) return;
+    auto const addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) return;
+    data = static_cast<const char*>(addr);
+    size = st.st_size;
+  }
+  ~MappedFile() {
+    if (data) munmap(const_cast<char*>(data), size);
+  }
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const char* data{nullptr};
+  size_t size{0};
+};
+
+uint64_t deltaStrongHash(const char* data, size_t sz) {
+  return folly::hash::fnv64_buf(data, sz);
+}
+
+/*
+ * Adler-style weak checksum that can slide over the stream a byte at a time.
+ * Sums wrap mod 2^32, which preserves the low 16 bits we combine in value().
+ */
+struct RollingChecksum {
+  void init(const char* p, size_t n) {
+    a = b = 0;
+    for (size_t i = 0; i < n; ++i) {
+      a += static_cast<uint8_t>(p[i]);
+      b += a;
+    }
+  }
+  void roll(uint8_t out, uint8_t in, size_t n) {
+    a += in - out;
+    b += a - n * out;
+  }
+  uint32_t value() const { return (b << 16) | (a & 0xffff); }
+
+  uint32_t a{0};
+  uint32_t b{0};
+};
+
+/*
+ * Write fullPath's delta against basePath to fullPath + ".delta". A failure
+ * here only costs us the smaller artifact, so it's logged rather than thrown.
+ */
+void writeProfDeltaFile(const std::string& basePath,
+                        const std::string& fullPath) {
+  MappedFile base{basePath};
+  MappedFile full{fullPath};
+  if (!base.data || !full.data) {
+    Logger::FInfo("Not writing profile delta: unable to map {}",
+                  base.data ? fullPath : basePath);
+    return;
+  }
+
+  auto const deltaPath = fullPath + ".delta";
+  auto const tmpPath = deltaPath + ".part";
+  auto fd = open(tmpPath.c_str(),
+                 O_CLOEXEC | O_CREAT | O_TRUNC | O_WRONLY, 0644);
+  if (fd == -1) {
+    Logger::FInfo("Not writing profile delta: failed to create {}, {}",
+                  tmpPath, folly::errnoStr(errno));
+    return;
+  }
+
+  try {
+    SCOPE_FAIL {
+      if (fd != -1) close(fd);
+      unlink(tmpPath.c_str());
+    };
+
+    auto const put = [&] (const void* p, size_t n) {
+      if (::write(fd, p, n) != n) {
+        throw std::runtime_error("Failed to write profile delta");
+      }
+    };
+
+    // Index the base blocks by weak checksum; candidates are confirmed with a
+    // strong hash and a final memcmp before we emit a copy.
+    jit::fast_map<uint32_t, std::vector<std::pair<uint64_t, size_t>>> blocks;
+    RollingChecksum weak;
+    for (size_t off = 0;
+         off + kDeltaBlockSize <= base.size;
+         off += kDeltaBlockSize) {
+      weak.init(base.data + off, kDeltaBlockSize);
+      blocks[weak.value()].emplace_back(
+        deltaStrongHash(base.data + off, kDeltaBlockSize), off);
+    }
+
+    put(&kDeltaMagic, sizeof(kDeltaMagic));
+    put(&kDeltaVersion, sizeof(kDeltaVersion));
+    uint64_t const baseSize = base.size;
+    uint64_t const baseHash = deltaStrongHash(base.data, base.size);
+    uint64_t const fullSize = full.size;
+    put(&baseSize, sizeof(baseSize));
+    put(&baseHash, sizeof(baseHash));
+    put(&fullSize, sizeof(fullSize));
+
+    size_t lit = 0; // start of the pending literal run
+    size_t pos = 0;
+    auto const emitLiteral = [&] (size_t end) {
+      if (end == lit) return;
+      put(&kDeltaOpLiteral, sizeof(kDeltaOpLiteral));
+      uint64_t const len = end - lit;
+      put(&len, sizeof(len));
+      put(full.data + lit, len);
+    };
+
+    auto rolling = false;
+    while (pos + kDeltaBlockSize <= full.size) {
+      if (!rolling) {
+        weak.init(full.data + pos, kDeltaBlockSize);
+        rolling = true;
+      }
+      auto matched = false;
+      size_t baseOff = 0;
+      auto const it = blocks.find(weak.value());
+      if (it != blocks.end()) {
+        auto const strong = deltaStrongHash(full.data + pos, kDeltaBlockSize);
+        for (auto const& cand : it->second) {
+          if (cand.first == strong &&
+              !memcmp(base.data + cand.second, full.data + pos,
+                      kDeltaBlockSize)) {
+            matched = true;
+            baseOff = cand.second;
+            break;
+          }
+        }
+      }
+      if (matched) {
+        emitLiteral(pos);
+        // Extend the match greedily so runs of unchanged blocks collapse into
+        // a single copy op.
+        size_t len = kDeltaBlockSize;
+        while (pos + len < full.size && baseOff + len < base.size &&
+               full.data[pos + len] == base.data[baseOff + len]) {
+          ++len;
+        }
+        put(&kDeltaOpCopy, sizeof(kDeltaOpCopy));
+        uint64_t const off64 = baseOff;
+        uint64_t const len64 = len;
+        put(&off64, sizeof(off64));
+        put(&len64, sizeof(len64));
+        pos += len;
+        lit = pos;
+        rolling = false;
+      } else {
+        if (pos + kDeltaBlockSize == full.size) break;
+        weak.roll(full.data[pos], full.data[pos + kDeltaBlockSize],
+                  kDeltaBlockSize);
+        ++pos;
+      }
+    }
+    emitLiteral(full.size);
+
+    auto const written = lseek(fd, 0, SEEK_CUR);
+    close(fd);
+    fd = -1;
+    renameFile(tmpPath, deltaPath);
+    Logger::FInfo("Wrote profile delta {} ({} bytes, full dump {} bytes)",
+                  deltaPath, written, full.size);
+  } catch (std::runtime_error& err) {
+    Logger::FInfo("Not writing profile delta: {}", err.what());
+  }
+}
+
+/*
+ * Expand a delta dump into an anonymous mapping using the base snapshot named
+ * by Eval.JitSerdesDeltaBase. Throws on any mismatch or corruption; callers
+ * treat that like any other failure to load profile data.
+ */
+std::pair<char*, size_t> expandProfDelta(const std::string& deltaPath) {
+  auto const& basePath = RuntimeOption::EvalJitSerdesDeltaBase;
+  if (basePath.empty()) {
+    throw std::runtime_error(
+      "Delta profile dump, but Eval.JitSerdesDeltaBase is unset");
+  }
+  MappedFile delta{deltaPath};
+  MappedFile base{basePath};
+  if (!delta.data) {
+    throw std::runtime_error("Failed to map profile delta: " + deltaPath);
+  }
+  if (!base.data) {
+    throw std::runtime_error("Failed to map base snapshot: " + basePath);
+  }
+
+  auto p = delta.data;
+  auto const end = delta.data + delta.size;
+  auto const get = [&] (void* out, size_t n) {
+    if (n > static_cast<size_t>(end - p)) {
+      throw std::runtime_error("Truncated profile delta");
+    }
+    memcpy(out, p, n);
+    p += n;
+  };
+
+  uint32_t magic;
+  uint32_t version;
+  uint64_t baseSize;
+  uint64_t baseHash;
+  uint64_t fullSize;
+  get(&magic, sizeof(magic));
+  get(&version, sizeof(version));
+  get(&baseSize, sizeof(baseSize));
+  get(&baseHash, sizeof(baseHash));
+  get(&fullSize, sizeof(fullSize));
+  if (magic != kDeltaMagic || version != kDeltaVersion) {
+    throw std::runtime_error("Unsupported profile delta format");
+  }
+  if (baseSize != base.size ||
+      baseHash != deltaStrongHash(base.data, base.size)) {
+    throw std::runtime_error(
+      "Base snapshot doesn't match the one this delta was made against: " +
+      basePath);
+  }
+  if (!fullSize) throw std::runtime_error("Empty profile delta");
+
+  auto const mem = mmap(nullptr, fullSize, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mem == MAP_FAILED) {
+    throw std::runtime_error("Failed to allocate profile delta expansion");
+  }
+  auto const out = static_cast<char*>(mem);
+
+  try {
+    size_t outPos = 0;
+    while (p < end) {
+      uint8_t tag;
+      get(&tag, sizeof(tag));
+      if (tag == kDeltaOpCopy) {
+        uint64_t off;
+        uint64_t len;
+        get(&off, sizeof(off));
+        get(&len, sizeof(len));
+        if (off + len > base.size || len > fullSize - outPos) {
+          throw std::runtime_error("Corrupt profile delta");
+        }
+        memcpy(out + outPos, base.data + off, len);
+        outPos += len;
+      } else if (tag == kDeltaOpLiteral) {
+        uint64_t len;
+        get(&len, sizeof(len));
+        if (len > fullSize - outPos) {
+          throw std::runtime_error("Corrupt profile delta");
+        }
+        get(out + outPos, len);
+        outPos += len;
+      } else {
+        throw std::runtime_error("Corrupt profile delta");
+      }
+    }
+    if (outPos != fullSize) {
+      throw std::runtime_error("Truncated profile delta");
+    }
+  } catch (...) {
+    munmap(mem, fullSize);
+    throw;
+  }
+  return {out, fullSize};
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 }
 
@@ -1074,6 +1372,9 @@ void ProfDataSerializer::finalize() {
   } else {
     FTRACE(1, "Finished serializing all profile data to {}\n", fileName);
     renameFile(fileName, baseFileName);
+    if (!RuntimeOption::EvalJitSerdesDeltaBase.empty()) {
+      writeProfDeltaFile(RuntimeOption::EvalJitSerdesDeltaBase, baseFileName);
+    }
   }
 }
 
@@ -1087,21 +1388,55 @@ ProfDataSerializer::~ProfDataSerializer() {
   }
 }
 
-ProfDataDeserializer::ProfDataDeserializer(const std::string& name) {
+ProfDataDeserializer::ProfDataDeserializer(const std::string& name,
+                                           uint64_t windowOffset,
+                                           uint64_t windowSize) {
   fd = open(name.c_str(), O_CLOEXEC | O_RDONLY);
   if (fd == -1) throw std::runtime_error("Failed to open: " + name);
+
+  // Delta dumps are expanded from the mmapped base snapshot up front, and
+  // reads are then served from the reconstructed stream.  A delta dump
+  // can't live inside a container window, since expansion reads the whole
+  // file by name.
+  uint32_t magic;
+  if (::pread(fd, &magic, sizeof(magic), windowOffset) == sizeof(magic) &&
+      magic == kDeltaMagic) {
+    close(fd);
+    fd = -1;
+    if (windowOffset != 0 || windowSize != 0) {
+      throw std::runtime_error("Delta profile dump not supported in " + name);
+    }
+    auto const expanded = expandProfDelta(name);
+    fullData = expanded.first;
+    fullSize = expanded.second;
+    return;
+  }
+
+  filePos = windowOffset;
+  if (windowSize) {
+    fileEnd = windowOffset + windowSize;
+  } else {
+    auto const end = ::lseek(fd, 0, SEEK_END);
+    if (end < 0) throw std::runtime_error("Failed to size: " + name);
+    fileEnd = end;
+  }
+  if (::lseek(fd, filePos, SEEK_SET) != static_cast<off_t>(filePos)) {
+    throw std::runtime_error("Failed to seek: " + name);
+  }
 }
 
 ProfDataDeserializer::~ProfDataDeserializer() {
+  if (fullData) {
+    munmap(fullData, fullSize);
+    return;
+  }
   assertx(fd != -1);
   close(fd);
 }
 
 bool ProfDataDeserializer::done() {
-  auto const pos = lseek(fd, 0, SEEK_CUR);
-  auto const end = lseek(fd, 0, SEEK_END);
-  lseek(fd, pos, SEEK_SET); // go back to original position
-  return offset == buffer_size && pos == end;
+  if (fullData) return fullPos == fullSize;
+  return offset == buffer_size && filePos == fileEnd;
 }
 
 ProfDataSerializer::Mappers ProfDataDeserializer::getMappers() const {
@@ -1150,6 +1485,14 @@ void write_raw(ProfDataSerializer& ser, const void* data, size_t sz) {
 }
 
 void read_raw(ProfDataDeserializer& ser, void* data, size_t sz) {
+  if (ser.fullData) {
+    if (sz > ser.fullSize - ser.fullPos) {
+      throw std::runtime_error("Failed to read serialized data");
+    }
+    memcpy(data, ser.fullData + ser.fullPos, sz);
+    ser.fullPos += sz;
+    return;
+  }
   if (ser.offset + sz <= ProfDataDeserializer::buffer_size) {
     memcpy(data, ser.buffer + ser.offset, sz);
     ser.offset += sz;
@@ -1162,19 +1505,26 @@ void read_raw(ProfDataDeserializer& ser, void* data, size_t sz) {
     ser.offset = ProfDataDeserializer::buffer_size;
   }
   if (sz >= ProfDataDeserializer::buffer_size) {
+    if (sz > ser.fileEnd - ser.filePos) {
+      throw std::runtime_error("Failed to read serialized data");
+    }
     auto const bytes_read = ::read(ser.fd, data, sz);
     if (bytes_read < 0 || bytes_read < sz) {
       throw std::runtime_error("Failed to read serialized data");
     }
+    ser.filePos += bytes_read;
     return;
   }
 
-  auto const bytes_read = ::read(ser.fd,
-                                 ser.buffer,
-                                 ProfDataDeserializer::buffer_size);
+  // Never read past the end of the stream's window; the file may contain
+  // unrelated data beyond it (eg other jumpstart bundle sections).
+  auto const want = std::min<uint64_t>(ProfDataDeserializer::buffer_size,
+                                       ser.fileEnd - ser.filePos);
+  auto const bytes_read = ::read(ser.fd, ser.buffer, want);
   if (bytes_read < 0 || bytes_read < sz) {
     throw std::runtime_error("Failed to read serialized data");
   }
+  ser.filePos += bytes_read;
   ser.offset = ProfDataDeserializer::buffer_size - bytes_read;
   if (ser.offset) {
     memmove(ser.buffer + ser.offset, ser.buffer, bytes_read);
@@ -1850,11 +2200,13 @@ std::string serializeOptProfData(const std::string& filename) {
 
 std::string deserializeProfData(const std::string& filename,
                                 int numWorkers,
-                                bool rds) {
+                                bool rds,
+                                uint64_t windowOffset,
+                                uint64_t windowSize) {
   try {
     if (!rds) ProfData::setTriedDeserialization();
 
-    ProfDataDeserializer ser{filename};
+    ProfDataDeserializer ser{filename, windowOffset, windowSize};
 
     if (read_raw<decltype(kMagic)>(ser) != kMagic) {
       throw std::runtime_error("Not a profile-data dump");
@@ -119,7 +119,12 @@ private:
 };
 
 struct ProfDataDeserializer {
-  explicit ProfDataDeserializer(const std::string& name);
+  // A non-zero windowOffset/windowSize reads the serialized profile from
+  // that window of the file instead of the whole thing, for profiles
+  // embedded in a container such as a jumpstart bundle.
+  explicit ProfDataDeserializer(const std::string& name,
+                                uint64_t windowOffset = 0,
+                                uint64_t windowSize = 0);
   ~ProfDataDeserializer();
 
   friend void read_raw(ProfDataDeserializer& ser, void* data, size_t sz);
@@ -152,6 +157,18 @@ struct ProfDataDeserializer {
   uint32_t offset{buffer_size};
   char buffer[buffer_size];
 
+  // Current position and exclusive end of the underlying stream, in file
+  // coordinates; reads never cross fileEnd.
+  uint64_t filePos{0};
+  uint64_t fileEnd{0};
+
+  // When the input is a delta dump (Eval.JitSerdesDeltaBase), the full stream
+  // is reconstructed up front from the mmapped base snapshot and reads are
+  // served from here instead of the fd.
+  char* fullData{nullptr};
+  size_t fullSize{0};
+  size_t fullPos{0};
+
   template <typename T>
   struct RevMapper {
     std::vector<T> map;
@@ -180,7 +197,8 @@ struct ProfDataDeserializer {
   RevMapper<const RepoAuthType::Array*> ratMap;
   RevMapper<FuncId::Int> funcIdMap;
 
-  friend std::string deserializeProfData(const std::string&, int, bool);
+  friend std::string deserializeProfData(const std::string&, int, bool,
+                                         uint64_t, uint64_t);
 };
 
 void write_raw(ProfDataSerializer& ser, const void* data, size_t sz);
@@ -253,10 +271,13 @@ FuncId read_func_id(ProfDataDeserializer& des);
 std::string serializeProfData(const std::string& filename);
 std::string serializeOptProfData(const std::string& filename);
 // If loadRDS is true, only the RDS ordering information will be
-// loaded.
+// loaded.  A non-zero windowOffset/windowSize reads the profile from that
+// window of the file (see ProfDataDeserializer).
 std::string deserializeProfData(const std::string& filename,
                                 int numWorkers,
-                                bool loadRDS);
+                                bool loadRDS,
+                                uint64_t windowOffset = 0,
+                                uint64_t windowSize = 0);
 
 bool tryDeserializePartialProfData(const std::string& filename,
                                    int numWorkers,
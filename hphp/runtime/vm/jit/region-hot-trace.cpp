@@ -87,8 +87,10 @@ RegionDescPtr selectHotTrace(HotTransContext& ctx) {
       break;
     }
 
-    // If the debugger is attached, only allow single-block regions.
-    if (prevId != kInvalidTransID && isDebuggerAttachedProcess()) {
+    // If the debugger is attached to this request, only allow single-block
+    // regions. Requests without a debugger keep forming full hot traces even
+    // while another request on the box is being debugged.
+    if (prevId != kInvalidTransID && isDebuggerAttached()) {
       FTRACE(2, "selectHotTrace: breaking region at Translation {} "
              "because of debugger is attached\n", tid);
       break;
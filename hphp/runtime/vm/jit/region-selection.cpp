@@ -26,6 +26,7 @@
 #include <folly/Memory.h>
 #include <folly/Conv.h>
 #include <folly/String.h>
+#include <folly/hash/Hash.h>
 
 #include "hphp/util/assertions.h"
 #include "hphp/runtime/base/runtime-option.h"
@@ -1195,6 +1196,41 @@ bool check(const RegionDesc& region, std::string& error) {
   return true;
 }
 
+uint64_t canonicalHash(const RegionDesc& region) {
+  // Number the blocks by their position in the block list so the hash is
+  // independent of the BlockIds assigned during selection.
+  hphp_hash_map<RegionDesc::BlockId, uint32_t> blockPos;
+  uint32_t pos = 0;
+  for (auto const& b : region.blocks()) {
+    blockPos[b->id()] = pos++;
+  }
+
+  uint64_t hash = 0;
+  auto const accum = [&] (uint64_t val) {
+    hash = folly::hash::hash_128_to_64(hash, val);
+  };
+
+  for (auto const& b : region.blocks()) {
+    accum(b->length());
+    auto sk = b->start();
+    for (int i = 0; i < b->length(); ++i, sk.advance(b->func())) {
+      accum(static_cast<uint64_t>(sk.op()));
+    }
+    for (auto const& guard : b->typePreConditions()) {
+      accum(Location::Hash{}(guard.location));
+      accum(guard.type.hash());
+      accum(static_cast<uint64_t>(guard.category));
+    }
+  }
+
+  region.forEachArc([&] (RegionDesc::BlockId src, RegionDesc::BlockId dst) {
+    accum(blockPos[src]);
+    accum(blockPos[dst]);
+  });
+
+  return hash;
+}
+
 //////////////////////////////////////////////////////////////////////
 
 std::string show(RegionDesc::TypedLocation ta) {
@@ -554,6 +554,16 @@ TransID getTransID(RegionDesc::BlockId blockId);
  */
 bool check(const RegionDesc& region, std::string& error);
 
+/*
+ * Computes a structural hash of `region': the per-block opcode sequences and
+ * type preconditions, plus the arc structure over block positions.  BlockIds,
+ * funcs, and bytecode offsets are abstracted away, so regions that perform
+ * the same work against the same guard types -- e.g. a framework bootstrap
+ * sequence replicated across endpoints -- hash equal regardless of which
+ * function they were selected from.
+ */
+uint64_t canonicalHash(const RegionDesc& region);
+
 /*
  * Debug stringification for various things.
  */
@@ -25,6 +25,7 @@
 #include "hphp/runtime/vm/jit/service-requests.h"
 #include "hphp/runtime/vm/jit/smashable-instr.h"
 #include "hphp/runtime/vm/jit/tc.h"
+#include "hphp/runtime/vm/jit/tc-record.h"
 #include "hphp/runtime/vm/jit/translator-inline.h"
 #include "hphp/runtime/vm/jit/unwind-itanium.h"
 #include "hphp/runtime/vm/jit/write-lease.h"
@@ -239,6 +240,7 @@ TCA handleTranslate(Offset bcOff, SBInvOffset spOff) noexcept {
   FTRACE(1, "handleTranslate {}\n", vmfp()->func()->fullName()->data());
 
   auto const sk = SrcKey { liveFunc(), bcOff, liveResumeMode() };
+  tc::touchFunc(sk.func());
   return resume(sk, getTranslation(sk));
 }
 
@@ -254,6 +256,7 @@ TCA handleRetranslate(Offset bcOff, SBInvOffset spOff) noexcept {
 
   INC_TPC(retranslate);
   auto const sk = SrcKey { liveFunc(), bcOff, liveResumeMode() };
+  tc::touchFunc(sk.func());
   auto const context = getContext(sk, tc::profileFunc(sk.func()));
   auto const transResult = mcgen::retranslate(TransArgs{sk}, context);
   SKTRACE(2, sk, "retranslated @%p\n", transResult.addr());
@@ -315,6 +318,7 @@ TCA handlePostInterpRet(uint32_t callOffAndFlags) noexcept {
 
 TCA handleBindCall(TCA toSmash, Func* func, int32_t numArgs) {
   TRACE(2, "bindCall %s, numArgs %d\n", func->fullName()->data(), numArgs);
+  tc::touchFunc(func);
   auto const trans = mcgen::getFuncPrologue(func, numArgs);
   TRACE(2, "bindCall immutably %s -> %p\n",
         func->fullName()->data(), trans.addr());
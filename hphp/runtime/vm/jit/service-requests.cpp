@@ -165,6 +165,10 @@ TCA getOrEmitStub(StubType type, SrcKey sk, SBInvOffset spOff) {
   return stub;
 }
 
+void clearStubSpaceLatch() {
+  s_fullForStub.store(false, std::memory_order_relaxed);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 TCA emit_interp_no_translate_stub(SBInvOffset spOff, SrcKey sk) {
@@ -67,6 +67,14 @@ enum class StubType : uint8_t {
  */
 TCA getOrEmitStub(StubType type, SrcKey sk, SBInvOffset spOff);
 
+/*
+ * Stub emission latches itself off the first time the TC runs out of space,
+ * so later requests fail fast instead of retaking the code lock. When
+ * reusable-TC reclamation returns memory to the code blocks' free lists,
+ * clearing the latch lets emission try again.
+ */
+void clearStubSpaceLatch();
+
 ///////////////////////////////////////////////////////////////////////////////
 // Emitters.
 
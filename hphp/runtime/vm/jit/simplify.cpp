@@ -3586,6 +3586,32 @@ SSATmp* simplifyOrdStr(State& env, const IRInstruction* inst) {
   return nullptr;
 }
 
+SSATmp* simplifyStrHasPrefix(State& env, const IRInstruction* inst) {
+  auto const str = inst->src(0);
+  auto const prefix = inst->src(1);
+  if (prefix->hasConstVal(TStr) && prefix->strVal()->empty()) {
+    return cns(env, true);
+  }
+  if (str->hasConstVal(TStr) && prefix->hasConstVal(TStr)) {
+    return cns(env, str->strVal()->slice().startsWith(
+                      prefix->strVal()->slice()));
+  }
+  return nullptr;
+}
+
+SSATmp* simplifyStrHasSuffix(State& env, const IRInstruction* inst) {
+  auto const str = inst->src(0);
+  auto const suffix = inst->src(1);
+  if (suffix->hasConstVal(TStr) && suffix->strVal()->empty()) {
+    return cns(env, true);
+  }
+  if (str->hasConstVal(TStr) && suffix->hasConstVal(TStr)) {
+    return cns(env, str->strVal()->slice().endsWith(
+                      suffix->strVal()->slice()));
+  }
+  return nullptr;
+}
+
 SSATmp* simplifyJmpSwitchDest(State& env, const IRInstruction* inst) {
   auto const index = inst->src(0);
   if (!index->hasConstVal(TInt)) return nullptr;
@@ -3950,6 +3976,8 @@ SSATmp* simplifyWork(State& env, const IRInstruction* inst) {
       X(AKExistsKeyset)
       X(OrdStr)
       X(ChrInt)
+      X(StrHasPrefix)
+      X(StrHasSuffix)
       X(JmpSwitchDest)
       X(CheckRange)
       X(GetMemoKey)
@@ -152,15 +152,28 @@ void SrcRec::chainFrom(IncomingBranch br, TCA stub) {
 void SrcRec::newTranslation(TransLoc loc,
                             GrowableVector<IncomingBranch>& tailBranches) {
   auto srLock = writelock();
+  auto const old = m_translations.load(std::memory_order_relaxed);
+  auto const oldSize = old ? old->size : 0;
+
   // When translation punts due to hitting limit, will generate one
   // more translation that will call the interpreter.
-  assertx(m_translations.size() <=
+  assertx(oldSize <=
           std::max(RuntimeOption::EvalJitMaxProfileTranslations,
                    RuntimeOption::EvalJitMaxTranslations));
 
   TRACE(1, "SrcRec(%p)::newTranslation @%p, ", this, loc.entry());
 
-  m_translations.push_back(loc);
+  // Publish a fresh copy of the translation array with the new translation
+  // appended. Readers may still hold the old snapshot, so it can only be
+  // freed once they have all drained off the Treadmill.
+  auto const locs = static_cast<TransLocs*>(
+    malloc(offsetof(TransLocs, locs) + (oldSize + 1) * sizeof(TransLoc))
+  );
+  if (old) std::copy(old->locs, old->locs + oldSize, locs->locs);
+  locs->locs[oldSize] = loc;
+  locs->size = oldSize + 1;
+  m_translations.store(locs, std::memory_order_release);
+  if (old) Treadmill::enqueue([old] { free(old); });
   if (!m_topTranslation.get()) {
     m_topTranslation = loc.entry();
     patchIncomingBranches(loc.entry());
@@ -244,21 +257,26 @@ void SrcRec::replaceOldTranslations(TCA transStub) {
 
   // Everyone needs to give up on old translations; send them to the provided
   // translate stub.
-  auto translations = std::move(m_translations);
+  auto const old = m_translations.exchange(nullptr, std::memory_order_acq_rel);
   m_tailFallbackJumps.clear();
   m_topTranslation = nullptr;
   assertx(!RuntimeOption::RepoAuthoritative || RuntimeOption::EvalJitPGO);
   patchIncomingBranches(transStub);
 
+  if (!old) return;
+
   // Now that we've smashed all the IBs for these translations they should be
   // unreachable-- to prevent a race we treadmill here and then reclaim their
   // associated TC space
   if (RuntimeOption::EvalEnableReusableTC) {
+    GrowableVector<TransLoc> translations;
+    for (uint32_t i = 0; i < old->size; ++i) {
+      translations.push_back(old->locs[i]);
+    }
     tc::reclaimTranslations(std::move(translations));
-    return;
   }
 
-  translations.clear();
+  Treadmill::enqueue([old] { free(old); });
 }
 
 } } // HPHP::jit
@@ -18,6 +18,8 @@
 #include <algorithm>
 #include <atomic>
 
+#include <folly/Range.h>
+
 #include "hphp/util/alloc.h"
 #include "hphp/util/asm-x64.h"
 #include "hphp/util/growable-vector.h"
@@ -178,6 +180,24 @@ struct SrcRec final {
     return m_topTranslation.get();
   }
 
+  /*
+   * The list of translations for this source location, as an immutable
+   * snapshot. Like getTopTranslation(), this can be safely called without
+   * holding the lock for this SrcRec: writers publish a fresh array and
+   * retire the old one on the Treadmill, so a snapshot obtained here stays
+   * valid for the duration of the request.
+   */
+  folly::Range<const TransLoc*> translations() const {
+    auto const locs = m_translations.load(std::memory_order_acquire);
+    if (!locs) return {};
+    return {locs->locs, locs->size};
+  }
+
+  size_t numTrans() const {
+    auto const locs = m_translations.load(std::memory_order_acquire);
+    return locs ? locs->size : 0;
+  }
+
   //////////////////////////////////////////////////////////////////////////////
 
   /*
@@ -190,10 +210,6 @@ struct SrcRec final {
     return m_incomingBranches;
   }
 
-  const GrowableVector<TransLoc>& translations() const {
-    return m_translations;
-  }
-
   const GrowableVector<IncomingBranch>& tailFallbackJumps() const {
     return m_tailFallbackJumps;
   }
@@ -209,10 +225,6 @@ struct SrcRec final {
                       GrowableVector<IncomingBranch>& inProgressTailBranches);
   void smashFallbacksToStub(TCA stub);
   void replaceOldTranslations(TCA transStub);
-  size_t numTrans() const {
-    auto srLock = readlock();
-    return translations().size();
-  }
 
   //////////////////////////////////////////////////////////////////////////////
 
@@ -225,14 +237,28 @@ struct SrcRec final {
   }
 
 private:
+  /*
+   * Immutable array of translations. Writers replace the whole array while
+   * holding m_lock and free the retired copy on the Treadmill, so readers
+   * never contend with them.
+   */
+  struct TransLocs {
+    uint32_t size;
+    /* Actually variable length. */
+    TransLoc locs[1];
+  };
+
   void patchIncomingBranches(TCA newStart);
 
 private:
   // This either points to the most recent translation in the
-  // translations vector, or if hasDebuggerGuard() it points to the
+  // translations array, or if hasDebuggerGuard() it points to the
   // debug guard.
   AtomicLowTCA m_topTranslation{nullptr};
 
+  // Written under m_lock; read lock-free with acquire semantics.
+  std::atomic<TransLocs*> m_translations{nullptr};
+
   /*
    * The following members are all protected by the m_lock SharedMutex.
    * They can only be read or written when the lock is held.
@@ -243,7 +269,6 @@ private:
   // can rewire them to new ones.
   GrowableVector<IncomingBranch> m_tailFallbackJumps;
 
-  GrowableVector<TransLoc> m_translations;
   GrowableVector<IncomingBranch> m_incomingBranches;
 
   mutable folly::SharedMutex m_lock;
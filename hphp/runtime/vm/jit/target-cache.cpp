@@ -202,6 +202,39 @@ LowPtr<const Class> TSClassCache::write(rds::Handle handle, ArrayData* ad) {
   return c;
 }
 
+//////////////////////////////////////////////////////////////////////
+// TSResolveCache
+
+ArrayData* TSResolveCache::lookup(rds::Handle handle, const Class* cls) {
+  auto const thiz = rds::handleToPtr<TSResolveCache, rds::Mode::Normal>(handle);
+  if (!rds::isHandleInit(handle, rds::NormalTag{})) {
+    thiz->m_cls = nullptr;
+    thiz->m_ts = nullptr;
+    rds::initHandle(handle);
+    return nullptr;
+  }
+  if (thiz->m_ts && thiz->m_cls == cls) {
+    FTRACE(1, "TSResolveCache hit: {} -> {}\n",
+           cls ? cls->name()->data() : "nullptr", thiz->m_ts);
+    return thiz->m_ts;
+  }
+  FTRACE(1, "TSResolveCache miss: {}\n",
+         cls ? cls->name()->data() : "nullptr");
+  return nullptr;
+}
+
+void TSResolveCache::insert(rds::Handle handle, const Class* cls,
+                            ArrayData* ts) {
+  assertx(rds::isHandleInit(handle, rds::NormalTag{}));
+  auto const thiz = rds::handleToPtr<TSResolveCache, rds::Mode::Normal>(handle);
+  if (thiz->m_ts) decRefArr(thiz->m_ts);
+  ts->incRefCount();
+  thiz->m_cls = cls;
+  thiz->m_ts = ts;
+  FTRACE(1, "TSResolveCache caching: {} -> {}\n",
+         cls ? cls->name()->data() : "nullptr", ts);
+}
+
 //=============================================================================
 // MethodCache
 
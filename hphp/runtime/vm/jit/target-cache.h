@@ -96,6 +96,23 @@ struct TSClassCache {
   Pair m_pairs[kNumLines];
 };
 
+//////////////////////////////////////////////////////////////////////
+
+/*
+ * Per-callsite cache for non-static type structure resolution. A site whose
+ * (constant) type structure mentions `this` or class generics resolves to the
+ * same flattened structure every time it's reached with the same called
+ * class, so remember the last (class, result) pair. The cache owns a
+ * reference to the stored array; since the cache is request-local, that
+ * reference is reclaimed with the request heap.
+ */
+struct TSResolveCache {
+  static ArrayData* lookup(rds::Handle, const Class*);
+  static void insert(rds::Handle, const Class*, ArrayData*);
+
+  LowPtr<const Class> m_cls;
+  ArrayData* m_ts;
+};
 
 //////////////////////////////////////////////////////////////////////
 
@@ -45,13 +45,21 @@
 #include "hphp/runtime/vm/jit/write-lease.h"
 
 #include "hphp/util/disasm.h"
+#include "hphp/util/hugetlb.h"
 #include "hphp/util/logger.h"
 #include "hphp/util/mutex.h"
 #include "hphp/util/rds-local.h"
+#include "hphp/util/service-data.h"
 #include "hphp/util/trace.h"
 
+#include <folly/String.h>
+
 #include <tbb/concurrent_hash_map.h>
 
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
 #include <atomic>
 
 extern "C" _Unwind_Reason_Code
@@ -366,6 +374,37 @@ void processExit() {
   recycleStop();
 }
 
+void hugifyHotCode() {
+  auto const maxPages = RuntimeOption::EvalJitHugifyOptCodePages;
+  if (maxPages == 0) return;
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  // relocatePublishSortedOptFuncs() lays optimized code into code.main in
+  // FuncOrder's hotness order, so the hottest extent of the TC is the used
+  // prefix of that block. Advise it onto transparent huge pages; unlike the
+  // hugetlb remapping done when the TC was created, madvise doesn't wipe the
+  // pages, so it's safe on code that's already running.
+  auto codeLock = lockCode();
+  auto const& main = code().main();
+  auto const base = reinterpret_cast<uintptr_t>(main.base());
+  assertx((base & (size2m - 1)) == 0);
+  auto extent = std::min((main.used() + size2m - 1) & ~(size2m - 1),
+                         size_t(maxPages) * size2m);
+  extent = std::min(extent, main.size());
+  if (extent == 0) return;
+
+  if (madvise(reinterpret_cast<void*>(base), extent, MADV_HUGEPAGE) == -1) {
+    Logger::FWarning("hugifyHotCode: madvise(MADV_HUGEPAGE) failed: {}",
+                     folly::errnoStr(errno));
+    return;
+  }
+  ServiceData::createCounter("jit.hugify-hot-code-bytes")->setValue(extent);
+  if (RuntimeOption::ServerExecutionMode()) {
+    Logger::FInfo("hugifyHotCode: advised {} bytes of code.main onto "
+                  "huge pages", extent);
+  }
+#endif
+}
+
 bool isValidCodeAddress(TCA addr) {
   return g_code->isValidCodeAddress(addr);
 }
@@ -29,6 +29,7 @@
 #include "hphp/runtime/vm/jit/mcgen-translate.h"
 #include "hphp/runtime/vm/jit/prof-data.h"
 #include "hphp/runtime/vm/jit/prof-data-serialize.h"
+#include "hphp/runtime/vm/jit/region-selection.h"
 #include "hphp/runtime/vm/jit/relocation.h"
 #include "hphp/runtime/vm/jit/smashable-instr.h"
 #include "hphp/runtime/vm/jit/srcdb.h"
@@ -36,6 +37,7 @@
 #include "hphp/runtime/vm/jit/trans-rec.h"
 
 #include "hphp/util/data-block.h"
+#include "hphp/util/hash-map.h"
 #include "hphp/util/service-data.h"
 #include "hphp/util/struct-log.h"
 #include "hphp/util/timer.h"
@@ -44,6 +46,8 @@
 #include <folly/gen/Base.h>
 #include <folly/json.h>
 
+#include <mutex>
+
 TRACE_SET_MOD(mcg);
 
 namespace HPHP { namespace jit { namespace tc {
@@ -184,6 +188,32 @@ void recordTranslationSizes(const TransRec& tr) {
   trans_counter[iFrozen].fetch_add(tr.afrozenLen, std::memory_order_relaxed);
 }
 
+void recordRegionDuplication(const RegionDesc& region, const TransLoc& loc) {
+  static auto const dupTransCounter =
+    ServiceData::createCounter("jit.region_dup_translations");
+  static auto const dupBytesCounter =
+    ServiceData::createCounter("jit.region_dup_bytes");
+  static std::mutex s_firstCopyLock;
+  static hphp_fast_map<uint64_t, SrcKey> s_firstCopy;
+
+  auto const hash = canonicalHash(region);
+  auto const entry = region.start();
+
+  std::lock_guard<std::mutex> guard(s_firstCopyLock);
+  auto const pair = s_firstCopy.emplace(hash, entry);
+  // Retranslations at the entry that first published this body aren't
+  // duplication; a structurally identical body at any other entry is.
+  if (pair.second || pair.first->second == entry) return;
+
+  auto const bytes =
+    loc.mainSize() + loc.coldCodeSize() + loc.frozenCodeSize();
+  dupTransCounter->increment();
+  dupBytesCounter->addValue(bytes);
+  FTRACE(2, "duplicate region body at {}: first published at {} "
+         "({} bytes)\n",
+         showShort(entry), showShort(pair.first->second), bytes);
+}
+
 void updateCodeSizeCounters() {
   assertOwnsCodeLock();
 
@@ -440,6 +470,8 @@ void logTranslation(const Translator* trans, const TransRange& range) {
     for (auto& blk : trans->vunit->blocks) max_vinstr += blk.code.size();
     cols.setInt("max_vinstr", max_vinstr);
     cols.setInt("num_vconst", trans->vunit->constToReg.size());
+    cols.setInt("regalloc_micros", trans->vunit->regAllocMicros);
+    cols.setInt("regalloc_graph_color", trans->vunit->usedGraphColor);
     auto vblocks = sortBlocks(*trans->vunit);
     size_t num_vinstr[kNumAreas] = {0, 0, 0};
     size_t num_vblocks[kNumAreas] = {0, 0, 0};
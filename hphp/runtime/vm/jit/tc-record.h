@@ -33,6 +33,7 @@ namespace jit {
 struct CGMeta;
 struct CodeCache;
 struct ProfTransRec;
+struct RegionDesc;
 struct TransEnv;
 
 namespace tc {
@@ -58,6 +59,16 @@ void reportJitMaturity();
  */
 void recordTranslationSizes(const TransRec& tr);
 
+/*
+ * Track structurally identical region bodies published at distinct region
+ * entries.  When a translation's canonical region hash has already been
+ * published at another SrcKey, bump the jit.region_dup_translations and
+ * jit.region_dup_bytes counters, quantifying how much of the TC is copies of
+ * the same logical body (typically framework bootstrap sequences replicated
+ * across endpoints).
+ */
+void recordRegionDuplication(const RegionDesc& region, const TransLoc& loc);
+
 /*
  * Update the jit.code.*.used ServiceData counters to reflect the
  * current usage of the TC. Call this whenever a new translation is
@@ -100,7 +111,8 @@ void recordFuncCaller(const Func* func, TCA toSmash, ProfTransRec* rec);
  * keep a table of associated SrcRecs to be reclaimed as it will be impossible
  * to walk the bytecode stream to search the SrcDB.
  */
-void recordFuncSrcRec(const Func* func, SrcRec* rec);
+void recordFuncSrcRec(const Func* func, SrcRec* rec, SrcKey sk,
+                      SBInvOffset spOff);
 
 /*
  * Record a prologue associated with a function so that it may be reclaimed
@@ -108,6 +120,14 @@ void recordFuncSrcRec(const Func* func, SrcRec* rec);
  */
 void recordFuncPrologue(const Func* func, TransLoc loc);
 
+/*
+ * Note JIT activity for a function so that proactive TC recycling
+ * (Eval.JitTCRecycleIdleSecs) doesn't tear down its code. Called from the
+ * translate/retranslate and call-bind slow paths; a no-op unless proactive
+ * recycling is enabled.
+ */
+void touchFunc(const Func* func);
+
 /*
  * This function is like a request-agnostic version of
  * server_warmup_status().
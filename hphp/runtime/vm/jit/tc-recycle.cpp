@@ -17,6 +17,8 @@
 #include "hphp/runtime/vm/jit/tc.h"
 #include "hphp/runtime/vm/jit/tc-internal.h"
 
+#include "hphp/runtime/base/perf-warning.h"
+
 #include "hphp/runtime/vm/func.h"
 #include "hphp/runtime/vm/treadmill.h"
 
@@ -34,11 +36,17 @@
 #include "hphp/util/asm-x64.h"
 #include "hphp/util/match.h"
 #include "hphp/util/rds-local.h"
+#include "hphp/util/service-data.h"
+#include "hphp/util/struct-log.h"
 #include "hphp/util/trace.h"
 
 #include "hphp/vixl/a64/instructions-a64.h"
 
+#include <folly/Format.h>
+
+#include <chrono>
 #include <condition_variable>
+#include <map>
 
 /*
  * This module implements garbage collection for the translation cache so that
@@ -86,14 +94,27 @@ namespace HPHP { namespace jit { namespace tc {
 TRACE_SET_MOD(reusetc);
 
 namespace {
+struct FuncSrcRec {
+  SrcRec* rec;
+  // Needed to locate the translate stub when proactively recycling the
+  // SrcRec's translations while the function is still callable.
+  SrcKey sk;
+  SBInvOffset spOff;
+};
+
 struct FuncInfo {
   FuncInfo() = default;
   FuncInfo(FuncInfo&&) = default;
   FuncInfo& operator=(FuncInfo&&) = default;
 
   std::vector<TransLoc> prologues;
-  std::vector<SrcRec*>  srcRecs;
+  std::vector<FuncSrcRec> srcRecs;
   jit::fast_set<TCA> callers;
+
+  // Last time the JIT observed activity for this function: new translations
+  // or prologues, bound callers, or translate/retranslate requests. Used by
+  // Eval.JitTCRecycleIdleSecs.
+  std::chrono::steady_clock::time_point lastActive{};
 };
 
 struct SmashedCall {
@@ -121,13 +142,84 @@ struct FuncJob {
   FuncId fid;
 };
 
-using Job = boost::variant<FuncJob, const SrcRec*, TransLoc>;
+// Proactive recycling of a still-live function (Eval.JitTCRecycleIdleSecs).
+struct IdleFuncJob {
+  FuncId fid;
+};
+
+using Job = boost::variant<FuncJob, const SrcRec*, TransLoc, IdleFuncJob>;
 std::atomic<bool> s_running{false};
 std::queue<Job> s_jobq;
 std::condition_variable s_qcv;
 std::mutex s_qlock;
 std::thread s_reaper;
 
+/*
+ * Fragmentation monitor (Eval.JitTCFragmentationMonitorSecs). True compaction
+ * would require relocating live, possibly-executing translations, which we
+ * have no way to do safely; instead this thread keeps the reclaimed TC
+ * healthy by sampling each code block's free lists, publishing the results as
+ * counters, unsticking stub emission once reclamation has freed space, and
+ * warning when free space is too fragmented for new translations to reuse.
+ */
+std::thread s_monitor;
+std::atomic<bool> s_monitorRunning{false};
+std::condition_variable s_mcv;
+std::mutex s_mlock;
+
+std::mutex s_fragStatLock;
+std::map<std::string, int64_t> s_fragStats;
+
+ServiceData::CounterCallback s_fragCounters(
+  [](std::map<std::string, int64_t>& counters) {
+    std::lock_guard<std::mutex> g{s_fragStatLock};
+    counters.insert(s_fragStats.begin(), s_fragStats.end());
+  }
+);
+
+// Warn when at least an eighth of the code emitted so far has been freed, as
+// new translations are unlikely to pack well into holes that fragmented.
+constexpr size_t kFragWarnDenom = 8;
+
+void monitorFragmentation() {
+  size_t bytesFree = 0;
+  size_t blocksFree = 0;
+  size_t bytesUsed = 0;
+  {
+    auto codeLock = lockCode();
+    code().forEachBlock([&] (const char* name, const CodeBlock& blk) {
+      auto const free = blk.bytesFree();
+      auto const blocks = blk.blocksFree();
+      {
+        std::lock_guard<std::mutex> g{s_fragStatLock};
+        s_fragStats[folly::sformat("jit.code.{}.bytes-free", name)] = free;
+        s_fragStats[folly::sformat("jit.code.{}.blocks-free", name)] = blocks;
+      }
+      bytesFree += free;
+      blocksFree += blocks;
+      bytesUsed += blk.used();
+    });
+  }
+
+  FTRACE(1, "monitorFragmentation: {} bytes free in {} blocks ({} used)\n",
+         bytesFree, blocksFree, bytesUsed);
+
+  // Stub emission latches itself off when the TC fills up. If reclamation has
+  // freed memory since the last sample the next attempt may succeed, so let
+  // it retry.
+  static size_t s_lastBytesFree = 0;
+  if (bytesFree > s_lastBytesFree) svcreq::clearStubSpaceLatch();
+  s_lastBytesFree = bytesFree;
+
+  if (bytesUsed && bytesFree > bytesUsed / kFragWarnDenom) {
+    logPerfWarning("tc_fragmentation", 1, [&] (StructuredLogEntry& e) {
+      e.setInt("bytes_free", bytesFree);
+      e.setInt("blocks_free", blocksFree);
+      e.setInt("bytes_used", bytesUsed);
+    });
+  }
+}
+
 void enqueueJob(Job j) {
   std::unique_lock<std::mutex> l{s_qlock};
   s_jobq.emplace(j);
@@ -392,11 +484,118 @@ void reclaimFunctionSync(const StringData* fname, FuncId fid) {
       }
     }
 
-    for (auto* rec : data.srcRecs) {
-      reclaimSrcRec(rec);
+    for (auto const& sri : data.srcRecs) {
+      reclaimSrcRec(sri.rec);
+    }
+  });
+}
+
+/*
+ * Proactively recycle the code of a still-live function that has shown no
+ * JIT activity for Eval.JitTCRecycleIdleSecs. Unlike reclaimFunctionSync,
+ * the function remains callable: its entry points are reset to
+ * fcallHelper/translate stubs so the next call simply re-translates, and its
+ * SrcRecs stay registered in case the function is later treadmilled.
+ */
+void recycleIdleFuncSync(FuncId fid) {
+  // The function may have been treadmilled since the sweep; the queued
+  // FuncJob will do the teardown in that case.
+  if (!Func::isFuncIdValid(fid)) return;
+  auto const func = const_cast<Func*>(Func::fromFuncId(fid));
+
+  ITRACE(1, "Recycling idle func {} (id={})\n",
+         func->fullName()->data(), fid);
+  Trace::Indent _i;
+
+  jit::fast_set<TCA> callers;
+  std::vector<TransLoc> prologues;
+  std::vector<FuncSrcRec> srcRecs;
+  {
+    auto dataLock = lockData();
+    auto const it = s_funcTCData.find(fid);
+    if (it == s_funcTCData.end()) return;
+    callers = it->second.callers;
+    prologues = std::move(it->second.prologues);
+    it->second.prologues.clear();
+    srcRecs = it->second.srcRecs;
+    // Don't re-sweep until the function has been idle for a full period
+    // again.
+    it->second.lastActive = std::chrono::steady_clock::now();
+  }
+
+  // Emit any translate stubs we'll need before taking the TC locks, as stub
+  // emission acquires them itself.
+  std::vector<std::pair<SrcRec*, TCA>> stubs;
+  for (auto const& sri : srcRecs) {
+    auto const stub = svcreq::getOrEmitStub(
+      svcreq::StubType::Translate, sri.sk, sri.spOff);
+    // Out of stub space; leave this SrcRec's translations in place.
+    if (!stub) continue;
+    stubs.emplace_back(sri.rec, stub);
+  }
+
+  auto codeLock = lockCode();
+  auto metaLock = lockMetadata();
+  auto& us = ustubs();
+
+  for (auto const caller : callers) {
+    ITRACE(1, "Unsmashing call @ {}\n", caller);
+    if (auto const scall = eraseSmashedCall(caller)) {
+      clearProfCaller(caller, scall->rec);
+    }
+    smashCall(caller, us.immutableBindCallStub);
+  }
+
+  // Send new direct entries back through fcallHelper.
+  func->resetFuncBody();
+  auto const numPrologues = func->numPrologues();
+  for (int i = 0; i < numPrologues; ++i) {
+    func->resetPrologue(i);
+  }
+
+  // replaceOldTranslations() treadmills the freed translations itself when
+  // the reusable TC is enabled.
+  for (auto const& [rec, stub] : stubs) {
+    rec->replaceOldTranslations(stub);
+  }
+
+  // The prologues are unreachable now that the callers are smashed and the
+  // prologue table reset; free them once concurrent callers drain.
+  Treadmill::enqueue([prologues = std::move(prologues)] {
+    for (auto const& loc : prologues) {
+      reclaimTranslation(loc);
     }
   });
 }
+
+/*
+ * Scan for functions with no JIT activity since the last
+ * Eval.JitTCRecycleIdleSecs window and queue them for recycling on the
+ * reaper thread.
+ */
+void sweepIdleFuncs() {
+  auto const idleSecs = RuntimeOption::EvalJitTCRecycleIdleSecs;
+  if (idleSecs == 0) return;
+  auto const cutoff =
+    std::chrono::steady_clock::now() - std::chrono::seconds(idleSecs);
+
+  std::vector<FuncId> idle;
+  {
+    auto dataLock = lockData();
+    for (auto const& kv : s_funcTCData) {
+      auto const& data = kv.second;
+      // Skip entries that predate activity tracking.
+      if (data.lastActive == std::chrono::steady_clock::time_point{}) continue;
+      if (data.lastActive < cutoff) idle.emplace_back(kv.first);
+    }
+  }
+
+  FTRACE(1, "sweepIdleFuncs: queueing {} idle funcs for recycling\n",
+         idle.size());
+  for (auto const fid : idle) {
+    enqueueJob(IdleFuncJob{fid});
+  }
+}
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -413,16 +612,21 @@ void recordFuncCaller(const Func* func, TCA toSmash, ProfTransRec* rec) {
   FTRACE(1, "Recording smashed call @ {} to func {} (id = {})\n",
          toSmash, func->fullName()->data(), func->getFuncId());
 
-  s_funcTCData[func->getFuncId()].callers.emplace(toSmash);
+  auto& data = s_funcTCData[func->getFuncId()];
+  data.callers.emplace(toSmash);
+  data.lastActive = std::chrono::steady_clock::now();
   s_smashedCalls[toSmash] = SmashedCall{func->getFuncId(), rec};
 }
 
-void recordFuncSrcRec(const Func* func, SrcRec* rec) {
+void recordFuncSrcRec(const Func* func, SrcRec* rec, SrcKey sk,
+                      SBInvOffset spOff) {
   auto dataLock = lockData();
 
   FTRACE(1, "Recording SrcRec for func {} (id = {}) addr = {}\n",
          func->fullName()->data(), func->getFuncId(), (void*)rec);
-  s_funcTCData[func->getFuncId()].srcRecs.emplace_back(rec);
+  auto& data = s_funcTCData[func->getFuncId()];
+  data.srcRecs.emplace_back(FuncSrcRec{rec, sk, spOff});
+  data.lastActive = std::chrono::steady_clock::now();
 }
 
 void recordFuncPrologue(const Func* func, TransLoc loc) {
@@ -430,7 +634,22 @@ void recordFuncPrologue(const Func* func, TransLoc loc) {
 
   FTRACE(1, "Recording Prologue for func {} (id = {}) main={}\n",
          func->fullName()->data(), func->getFuncId(), loc.entry());
-  s_funcTCData[func->getFuncId()].prologues.emplace_back(loc);
+  auto& data = s_funcTCData[func->getFuncId()];
+  data.prologues.emplace_back(loc);
+  data.lastActive = std::chrono::steady_clock::now();
+}
+
+void touchFunc(const Func* func) {
+  if (!RuntimeOption::EvalEnableReusableTC ||
+      RuntimeOption::EvalJitTCRecycleIdleSecs == 0) {
+    return;
+  }
+
+  auto dataLock = lockData();
+  auto const it = s_funcTCData.find(func->getFuncId());
+  if (it != s_funcTCData.end()) {
+    it->second.lastActive = std::chrono::steady_clock::now();
+  }
 }
 
 void recordJump(TCA toSmash, SrcRec* sr) {
@@ -469,10 +688,35 @@ void recycleInit() {
         *j,
         [] (TransLoc loc) { reclaimTranslationSync(loc); },
         [] (const SrcRec* sr) { reclaimSrcRecSync(sr); },
-        [] (FuncJob j) { reclaimFunctionSync(j.fname, j.fid); }
+        [] (FuncJob j) { reclaimFunctionSync(j.fname, j.fid); },
+        [] (IdleFuncJob j) { recycleIdleFuncSync(j.fid); }
       );
     }
   });
+
+  auto const monitorSecs = RuntimeOption::EvalJitTCFragmentationMonitorSecs;
+  auto const recycleSecs = RuntimeOption::EvalJitTCRecycleIdleSecs;
+  if (monitorSecs > 0 || recycleSecs > 0) {
+    s_monitorRunning.store(true, std::memory_order_release);
+    s_monitor = std::thread([monitorSecs, recycleSecs] {
+      rds::local::init();
+      SCOPE_EXIT { rds::local::fini(); };
+      // Tick at the shorter of the two cadences; the idle sweep is cheap and
+      // cutoff-based, so running it more often than its period is harmless.
+      auto const interval = std::chrono::seconds(
+        monitorSecs > 0 && (recycleSecs == 0 || monitorSecs < recycleSecs)
+          ? monitorSecs
+          : recycleSecs
+      );
+      std::unique_lock<std::mutex> l{s_mlock};
+      while (s_monitorRunning.load(std::memory_order_acquire)) {
+        s_mcv.wait_for(l, interval);
+        if (!s_monitorRunning.load(std::memory_order_acquire)) break;
+        if (monitorSecs > 0) monitorFragmentation();
+        if (recycleSecs > 0) sweepIdleFuncs();
+      }
+    });
+  }
 }
 
 void recycleStop() {
@@ -480,6 +724,12 @@ void recycleStop() {
   s_running.store(false, std::memory_order_release);
   s_qcv.notify_all();
   s_reaper.join();
+
+  if (s_monitorRunning.load(std::memory_order_acquire)) {
+    s_monitorRunning.store(false, std::memory_order_release);
+    s_mcv.notify_all();
+    s_monitor.join();
+  }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
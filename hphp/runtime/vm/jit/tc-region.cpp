@@ -47,6 +47,8 @@
 #include "hphp/runtime/vm/resumable.h"
 #include "hphp/runtime/vm/treadmill.h"
 
+#include <thread>
+
 #include "hphp/util/boot-stats.h"
 #include "hphp/util/service-data.h"
 #include "hphp/util/struct-log.h"
@@ -389,8 +391,8 @@ void smashOptSortedOptFuncs(std::vector<FuncMetaInfo>& infos,
                             const SrcKeyTransMap& srcKeyTrans) {
   BootStats::Block timer("RTA_smash_opt_funcs",
                          RuntimeOption::ServerExecutionMode());
-  for (auto& finfo : infos) {
-    if (!Func::isFuncIdValid(finfo.fid)) continue;
+  auto const smashFunc = [&] (FuncMetaInfo& finfo) {
+    if (!Func::isFuncIdValid(finfo.fid)) return;
 
     for (auto& translator : finfo.translators) {
       // Skip if the translation wasn't relocated (e.g. ran out of TC space).
@@ -404,7 +406,31 @@ void smashOptSortedOptFuncs(std::vector<FuncMetaInfo>& infos,
         smashOptBinds(translator->meta(), translator->entry(), srcKeyTrans);
       }
     }
+  };
+
+  // Every relocated address is final at this point, the target maps are
+  // read-only, and each translator only patches sites inside its own
+  // relocated code (none of it reachable yet), so distinct functions can
+  // be smashed in parallel.  smashJmp's split write is serialized
+  // internally.
+  auto const nWorkers = std::min(
+    static_cast<size_t>(std::max(1, RuntimeOption::EvalJitWorkerThreads)),
+    infos.size()
+  );
+  if (nWorkers <= 1) {
+    for (auto& finfo : infos) smashFunc(finfo);
+    return;
+  }
+  std::vector<std::thread> workers;
+  workers.reserve(nWorkers);
+  for (size_t t = 0; t < nWorkers; ++t) {
+    workers.emplace_back([&, t] {
+      for (auto i = t; i < infos.size(); i += nWorkers) {
+        smashFunc(infos[i]);
+      }
+    });
   }
+  for (auto& worker : workers) worker.join();
 }
 
 void invalidateFuncsProfSrcKeys() {
@@ -509,7 +535,7 @@ SrcRec* createSrcRec(SrcKey sk, SBInvOffset spOff) {
 
   auto const sr = srcDB().insert(sk);
   if (RuntimeOption::EvalEnableReusableTC) {
-    recordFuncSrcRec(sk.func(), sr);
+    recordFuncSrcRec(sk.func(), sr, sk, spOff);
   }
 
   return sr;
@@ -743,6 +769,9 @@ void RegionTranslator::publishMetaImpl() {
     reportTraceletToVtune(sk.unit(), sk.func(), tr);
   }
   recordTranslationSizes(tr);
+  // Profile translations get reclaimed wholesale, so only account for
+  // duplicated bodies among the translations that stay in the TC.
+  if (region && !isProfiling(kind)) recordRegionDuplication(*region, loc);
 
   fixups.process(&tailBranches);
 }
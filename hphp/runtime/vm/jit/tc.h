@@ -363,6 +363,16 @@ void processInit();
  */
 void processExit();
 
+/*
+ * Advise the hottest extent of the TC onto transparent huge pages, up to
+ * Eval.JitHugifyOptCodePages 2MB pages.
+ *
+ * Meant to run after retranslateAll, once optimized code has been relocated
+ * into code.main in hotness order, so the hot extent is just the used prefix
+ * of that block.
+ */
+void hugifyHotCode();
+
 ////////////////////////////////////////////////////////////////////////////////
 
 /*
@@ -35,6 +35,7 @@
   TIMER_NAME(optimize_gvn)                      \
   TIMER_NAME(optimize_phis)                     \
   TIMER_NAME(optimize_licm)                     \
+  TIMER_NAME(optimize_peelHotLoops)             \
   TIMER_NAME(hoist_type_checks)                 \
   TIMER_NAME(regionizeFunc)                     \
   TIMER_NAME(selectTracelet)                    \
@@ -17,11 +17,14 @@
 #include "hphp/runtime/vm/jit/trans-db.h"
 
 #include "hphp/runtime/vm/jit/mcgen.h"
+#include "hphp/runtime/vm/jit/prof-data.h"
 #include "hphp/runtime/vm/jit/tc.h"
 #include "hphp/runtime/vm/jit/translator.h"
 
 #include "hphp/runtime/base/runtime-option.h"
+#include "hphp/runtime/base/static-string-table.h"
 
+#include "hphp/util/hash-map.h"
 #include "hphp/util/timer.h"
 
 #include <folly/SharedMutex.h>
@@ -34,6 +37,55 @@ namespace HPHP { namespace jit { namespace transdb { namespace {
 std::map<TCA, TransID> s_transDB;
 std::vector<std::unique_ptr<TransRec>> s_translations;
 folly::SharedMutex s_lock;
+
+// Translation index state.  Entries are compact summaries; the maps hold
+// indices into s_indexEntries, which is append-only and capped by
+// Eval.JitTransIndexMaxEntries.
+std::vector<TransIndexEntry> s_indexEntries;
+hphp_hash_map<const StringData*, std::vector<uint32_t>,
+              pointer_hash<StringData>> s_indexByFunc;
+hphp_hash_map<SrcKey, std::vector<uint32_t>,
+              SrcKey::Hasher> s_indexBySrc;
+folly::SharedMutex s_indexLock;
+bool s_indexTruncated = false;
+
+void recordIndexEntry(const TransRec& rec) {
+  auto const name = makeStaticString(rec.funcName);
+
+  folly::SharedMutex::WriteHolder guard(s_indexLock);
+  if (s_indexEntries.size() >= RuntimeOption::EvalJitTransIndexMaxEntries) {
+    s_indexTruncated = true;
+    return;
+  }
+  auto const idx = static_cast<uint32_t>(s_indexEntries.size());
+
+  TransIndexEntry entry;
+  entry.src = rec.src;
+  entry.aStart = rec.aStart;
+  entry.id = rec.id;
+  entry.kind = rec.kind;
+  entry.aLen = rec.aLen;
+  entry.acoldLen = rec.acoldLen;
+  entry.afrozenLen = rec.afrozenLen;
+  entry.profWeight = 0;
+
+  s_indexEntries.push_back(entry);
+  s_indexByFunc[name].push_back(idx);
+  s_indexBySrc[rec.src].push_back(idx);
+}
+
+// Fill in profWeight from ProfData's counters.  Profile translations carry
+// their profTransID as `id', so the counter lookup is valid as long as the
+// profile data hasn't been freed.
+void fillProfWeights(std::vector<TransIndexEntry>& entries) {
+  auto const pd = profData();
+  if (!pd) return;
+  for (auto& e : entries) {
+    if (!isProfiling(e.kind)) continue;
+    if (e.id == kInvalidTransID || e.id >= pd->numTransRecs()) continue;
+    e.profWeight = pd->transCounter(e.id);
+  }
+}
 }
 
 bool enabled() {
@@ -82,6 +134,8 @@ void addTranslation(const TransRec& transRec) {
       static_cast<int>(transRec.kind));
   }
 
+  if (indexEnabled()) recordIndexEntry(transRec);
+
   if (!enabled()) return;
   tc::assertOwnsCodeLock();
 
@@ -114,4 +168,47 @@ void addTranslation(const TransRec& transRec) {
   s_translations[id] = std::move(transRecPtr);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+bool indexEnabled() {
+  return RuntimeOption::EvalJitTransIndex;
+}
+
+std::vector<TransIndexEntry> indexForFunc(const std::string& funcName) {
+  std::vector<TransIndexEntry> ret;
+  auto const name = makeStaticString(funcName);
+  {
+    folly::SharedMutex::ReadHolder guard(s_indexLock);
+    auto const it = s_indexByFunc.find(name);
+    if (it == s_indexByFunc.end()) return ret;
+    ret.reserve(it->second.size());
+    for (auto const idx : it->second) ret.push_back(s_indexEntries[idx]);
+  }
+  fillProfWeights(ret);
+  return ret;
+}
+
+std::vector<TransIndexEntry> indexForSrcKey(SrcKey sk) {
+  std::vector<TransIndexEntry> ret;
+  {
+    folly::SharedMutex::ReadHolder guard(s_indexLock);
+    auto const it = s_indexBySrc.find(sk);
+    if (it == s_indexBySrc.end()) return ret;
+    ret.reserve(it->second.size());
+    for (auto const idx : it->second) ret.push_back(s_indexEntries[idx]);
+  }
+  fillProfWeights(ret);
+  return ret;
+}
+
+size_t indexSize() {
+  folly::SharedMutex::ReadHolder guard(s_indexLock);
+  return s_indexEntries.size();
+}
+
+bool indexTruncated() {
+  folly::SharedMutex::ReadHolder guard(s_indexLock);
+  return s_indexTruncated;
+}
+
 }}}
@@ -60,5 +60,48 @@ void addTranslation(const TransRec& transRec);
  */
 size_t getNumTranslations();
 
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Translation index.
+ *
+ * Unlike the full TransDB, the index retains only a compact summary of each
+ * translation (srckey, kind, and code sizes), bounded in size by
+ * Eval.JitTransIndexMaxEntries, so it is safe to enable in production
+ * (Eval.JitTransIndex).  It is keyed by both srckey and function name, and
+ * queryable via the admin port (/jit-trans-index).
+ */
+struct TransIndexEntry {
+  SrcKey src;
+  TCA aStart;
+  TransID id;
+  TransKind kind;
+  uint32_t aLen;
+  uint32_t acoldLen;
+  uint32_t afrozenLen;
+  // The absolute execution count of profile translations, filled in at query
+  // time from ProfData; 0 for other kinds or once counters are gone.
+  int64_t profWeight;
+};
+
+/*
+ * Whether the translation index should be maintained.
+ */
+bool indexEnabled();
+
+/*
+ * Get the summaries of all translations of a function or srckey, in order of
+ * creation.  Return an empty vector if the index is not enabled.
+ */
+std::vector<TransIndexEntry> indexForFunc(const std::string& funcName);
+std::vector<TransIndexEntry> indexForSrcKey(SrcKey sk);
+
+/*
+ * The number of indexed translations, and whether any were dropped after
+ * hitting Eval.JitTransIndexMaxEntries.
+ */
+size_t indexSize();
+bool indexTruncated();
+
 }}}
 
@@ -356,6 +356,13 @@ static bool needsSurpriseCheck(Op op) {
   return op == Op::JmpZ || op == Op::JmpNZ || op == Op::Jmp;
 }
 
+/*
+ * Ops cheap enough that a surprise check scheduled for the block may be
+ * hoisted above them, so the whole trailing run of a loop body shares one
+ * check emitted while the eval stack is still in a simple state.  They may
+ * raise notices or decref values, but they never transfer control, and any
+ * VM reentry they can cause performs its own surprise checks.
+ */
 static bool isSimpleOp(Op op) {
   return op == Op::Not ||
       op == Op::Same ||
@@ -379,8 +386,24 @@ static bool isSimpleOp(Op op) {
       op == Op::BitOr ||
       op == Op::BitXor ||
       op == Op::BitNot ||
+      op == Op::Shl ||
+      op == Op::Shr ||
       op == Op::CastBool ||
-      op == Op::CastInt;
+      op == Op::CastInt ||
+      op == Op::CastDouble ||
+      op == Op::CGetL ||
+      op == Op::CGetQuietL ||
+      op == Op::CGetL2 ||
+      op == Op::PushL ||
+      op == Op::SetL ||
+      op == Op::PopL ||
+      op == Op::PopC ||
+      op == Op::IncDecL ||
+      op == Op::Int ||
+      op == Op::Double ||
+      op == Op::True ||
+      op == Op::False ||
+      op == Op::Null;
 }
 
 Optional<unsigned> scheduleSurprise(const RegionDesc::Block& block) {
@@ -180,6 +180,14 @@ StringData* convObjToStrHelper(ObjectData* o) {
   return o->invokeToString().detach();
 }
 
+bool strHasPrefixHelper(const StringData* str, const StringData* prefix) {
+  return str->slice().startsWith(prefix->slice());
+}
+
+bool strHasSuffixHelper(const StringData* str, const StringData* suffix) {
+  return str->slice().endsWith(suffix->slice());
+}
+
 void throwUndefPropException(ObjectData* base, const StringData* name) {
   base->throwUndefPropException(name);
 }
@@ -515,12 +523,21 @@ ArrayData* resolveTypeStructHelper(
   const Class* declaringCls,
   const Class* calledCls,
   bool suppress,
-  bool isOrAsOp
+  bool isOrAsOp,
+  rds::Handle handle
 ) {
   assertx(n != 0);
   auto const v = *values;
   isValidTSType(v, true);
   auto const ts = v.m_data.parr;
+  if (handle != rds::kUninitHandle) {
+    // The JIT only hands us a cache when the type structure is a constant and
+    // n is 1, so the resolution is determined by the called class alone.
+    assertx(n == 1);
+    if (auto const cached = TSResolveCache::lookup(handle, calledCls)) {
+      return Array{cached}.detach();
+    }
+  }
   req::vector<Array> tsList;
   for (int i = 0; i < n - 1; ++i) {
     auto const a = values[n - i - 1];
@@ -535,6 +552,9 @@ ArrayData* resolveTypeStructHelper(
     return resolveAndVerifyTypeStructure<false>(
              ArrNR(ts), declaringCls, calledCls, tsList, suppress);
   }();
+  if (handle != rds::kUninitHandle) {
+    TSResolveCache::insert(handle, calledCls, resolved.get());
+  }
   return resolved.detach();
 }
 
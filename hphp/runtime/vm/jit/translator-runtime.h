@@ -72,6 +72,9 @@ StringData* convDblToStrHelper(double i);
 StringData* convIntToStrHelper(int64_t i);
 StringData* convObjToStrHelper(ObjectData* o);
 
+bool strHasPrefixHelper(const StringData* str, const StringData* prefix);
+bool strHasSuffixHelper(const StringData* str, const StringData* suffix);
+
 void throwUndefPropException(ObjectData* base, const StringData* name);
 void throwUndefVariable(StringData* nm);
 void VerifyParamTypeSlow(ObjectData* obj,
@@ -165,7 +168,8 @@ ArrayData* resolveTypeStructHelper(
   const Class* declaringCls,
   const Class* calledCls,
   bool suppress,
-  bool isOrAsOp
+  bool isOrAsOp,
+  rds::Handle handle
 );
 bool isTypeStructHelper(ArrayData*, TypedValue, rds::Handle);
 void profileIsTypeStructHelper(ArrayData*, IsTypeStructProfile*);
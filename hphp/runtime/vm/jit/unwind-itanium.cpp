@@ -433,6 +433,17 @@ void initUnwinder(TCA base, size_t size, PersonalityFunc personality) {
   s_ehFrames.push_back(ehfw.register_and_release());
 }
 
+std::vector<uint8_t> tc_unwinding_info(TCA base, size_t size) {
+  EHFrameWriter ehfw;
+  write_tc_cie(ehfw, tc_unwind_personality);
+  ehfw.begin_fde(base);
+  ehfw.end_fde(size);
+  ehfw.null_fde();
+
+  auto buf = ehfw.release_raw();
+  return std::move(*buf);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 }}
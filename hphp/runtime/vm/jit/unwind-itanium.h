@@ -27,6 +27,8 @@
 #include "hphp/util/either.h"
 
 #include <cstddef>
+#include <cstdint>
+#include <vector>
 
 #ifndef _MSC_VER
 #include <unwind.h>
@@ -127,6 +129,16 @@ TCUnwindInfo tc_unwind_resume_stublogue(ActRec* fp, TCA savedRip);
  */
 void initUnwinder(TCA base, size_t size, PersonalityFunc fn);
 
+/*
+ * Build (but do not register) an .eh_frame image describing the uniform TC
+ * frame layout over [base, base + size), using the same CFI we register with
+ * the in-process unwinder.
+ *
+ * Used by the perf jitdump writer to emit JIT_CODE_UNWINDING_INFO records, so
+ * that external tooling (perf inject --jit) can unwind through TC frames.
+ */
+std::vector<uint8_t> tc_unwinding_info(TCA base, size_t size);
+
 ///////////////////////////////////////////////////////////////////////////////
 
 }}
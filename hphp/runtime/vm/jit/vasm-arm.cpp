@@ -474,17 +474,35 @@ void Vgen::emitVeneers(Venv& env) {
       notEmitted.push_back(veneer);
       continue;
     }
-    auto const vaddr = cb->frontier();
+    // Veneers only execute when the smashable branch actually takes the far
+    // path, so hoist them into the coldest area the direct branch can still
+    // reach instead of packing them in line with the source's area. Fall
+    // back to the source's area when the coldest frontier is out of B/BL
+    // range or full (or when this unit only has one area).
+    auto const vb = [&] {
+      auto& coldest = env.text.areas().back().code;
+      // Leave room for the conditional-branch appendix below.
+      constexpr int64_t kVeneerSlack = 8 * kInstructionSize;
+      auto const offset =
+        static_cast<int64_t>(coldest.frontier() - veneer.source);
+      if (coldest.canEmit(kVeneerSlack) &&
+          is_int28(offset < 0 ? offset - kVeneerSlack
+                              : offset + kVeneerSlack)) {
+        return &coldest;
+      }
+      return cb;
+    }();
+    auto const vaddr = vb->frontier();
 
     FTRACE(1, "emitVeneers: source = {}, target = {}, veneer at {}\n",
            veneer.source, veneer.target, vaddr);
 
     // Emit the veneer code: LDR + BR.
     meta.veneerAddrs.insert(vaddr);
-    MacroAssembler av{*cb};
+    MacroAssembler av{*vb};
     vixl::Label target_data;
     meta.addressImmediates.insert(vaddr);
-    poolLiteral(*cb, meta, (uint64_t)makeTarget32(veneer.target), 32, true);
+    poolLiteral(*vb, meta, (uint64_t)makeTarget32(veneer.target), 32, true);
     av.bind(&target_data);
     av.Ldr(rAsm_w, &target_data);
     av.Br(rAsm);
@@ -532,7 +550,7 @@ void Vgen::emitVeneers(Venv& env) {
         at.b(offset >> kInstructionSizeLog2);
 
         // Emit appendix.
-        auto const appendix = cb->frontier();
+        auto const appendix = vb->frontier();
         av.b(-2 /* veneer starts 2 instructions before the appendix */, cond);
         const int64_t nextOffset = (veneer.source + kInstructionSize) - // NEXT
           (vaddr + 3 * kInstructionSize); // addr of "B NEXT"
@@ -1956,14 +1974,7 @@ void optimizeARM(Vunit& unit, const Abi& abi, bool regalloc) {
     if (regalloc) {
       splitCriticalEdges(unit);
 
-      if (RuntimeOption::EvalUseGraphColor &&
-          unit.context &&
-          (unit.context->kind == TransKind::Optimize ||
-           unit.context->kind == TransKind::OptPrologue)) {
-        allocateRegistersWithGraphColor(unit, abi);
-      } else {
-        allocateRegistersWithXLS(unit, abi);
-      }
+      allocateRegisters(unit, abi);
     }
   }
 
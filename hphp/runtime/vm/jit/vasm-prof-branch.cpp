@@ -31,8 +31,10 @@
 #include "hphp/runtime/vm/jit/code-gen-cf.h"
 #include "hphp/runtime/vm/jit/ir-instruction.h"
 #include "hphp/runtime/vm/jit/ir-opcode.h"
+#include "hphp/runtime/vm/jit/mcgen.h"
 #include "hphp/runtime/vm/jit/phys-reg.h"
 #include "hphp/runtime/vm/jit/reg-alloc.h"
+#include "hphp/runtime/vm/jit/tc.h"
 #include "hphp/runtime/vm/jit/types.h"
 #include "hphp/runtime/vm/jit/unique-stubs.h"
 #include "hphp/runtime/vm/jit/vasm.h"
@@ -44,11 +46,15 @@
 #include "hphp/runtime/vm/jit/vasm-visit.h"
 
 #include "hphp/util/dataflow-worklist.h"
+#include "hphp/util/hash-map.h"
+#include "hphp/util/perf-event.h"
 #include "hphp/util/struct-log.h"
 
 #include <boost/dynamic_bitset.hpp>
 #include <boost/range/adaptor/reversed.hpp>
 
+#include <folly/Hash.h>
+
 #include <string>
 #include <vector>
 
@@ -496,4 +502,83 @@ void profile_branches(Vunit& unit) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+/*
+ * Version number for the sampled branch entries.
+ */
+constexpr auto kSampleVersion = 1;
+
+/*
+ * A taken branch edge within the TC.
+ */
+struct TCEdge {
+  TCA from;
+  TCA to;
+
+  bool operator==(const TCEdge& o) const {
+    return from == o.from && to == o.to;
+  }
+};
+
+struct TCEdgeHash {
+  size_t operator()(const TCEdge& e) const {
+    return folly::hash::hash_combine(e.from, e.to);
+  }
+};
+
+struct TCEdgeCounts {
+  uint64_t hits{0};
+  uint64_t mispredicts{0};
+};
+
+/*
+ * Per-thread aggregation of sampled LBR edges within the TC.
+ *
+ * Sampling is per-thread (see hphp/util/perf-event.h), so no synchronization
+ * is needed here.
+ */
+thread_local hphp_fast_map<TCEdge, TCEdgeCounts, TCEdgeHash> tl_sampled_edges;
+
+}
+
+void record_perf_branch_sample(const perf_event_sample* sample) {
+  if (!mcgen::initialized()) return;
+
+  auto const& code = tc::code();
+
+  for (auto i = uint64_t{0}; i < sample->nr; ++i) {
+    auto const& entry = sample->branches()[i];
+    auto const from = reinterpret_cast<TCA>(entry.from);
+    auto const to = reinterpret_cast<TCA>(entry.to);
+
+    // We only care about branches within the TC; calls into the runtime and
+    // branches in native code are someone else's problem.
+    if (!code.isValidCodeAddress(from) ||
+        !code.isValidCodeAddress(to)) {
+      continue;
+    }
+    auto& counts = tl_sampled_edges[TCEdge{from, to}];
+    ++counts.hits;
+    if (entry.mispredicted()) ++counts.mispredicts;
+  }
+}
+
+void log_perf_branch_profile() {
+  for (auto const& kv : tl_sampled_edges) {
+    auto record = StructuredLogEntry{};
+    record.setInt("version", kSampleVersion);
+    record.setInt("from", reinterpret_cast<uintptr_t>(kv.first.from));
+    record.setInt("to", reinterpret_cast<uintptr_t>(kv.first.to));
+    record.setInt("hits", kv.second.hits);
+    record.setInt("mispredicts", kv.second.mispredicts);
+
+    FTRACE(1, "prof-branch-sample: {}\n", show(record).c_str());
+    StructuredLog::log("hhvm_tc_lbr_branches", record);
+  }
+  tl_sampled_edges.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 }}
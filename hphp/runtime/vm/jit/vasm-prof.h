@@ -16,7 +16,11 @@
 
 #pragma once
 
-namespace HPHP { namespace jit {
+namespace HPHP {
+
+struct perf_event_sample;
+
+namespace jit {
 
 struct Vunit;
 
@@ -27,6 +31,20 @@ struct Vunit;
  */
 void profile_branches(Vunit& unit);
 
+/*
+ * Record a sampled last-branch-record stack (see hphp/util/perf-event.h).
+ *
+ * Aggregates the TC-internal edges from `sample' into a per-thread table of
+ * branch-hit counts.
+ */
+void record_perf_branch_sample(const perf_event_sample* sample);
+
+/*
+ * Log the branch edges aggregated by record_perf_branch_sample() on this
+ * thread, and clear the table.
+ */
+void log_perf_branch_profile();
+
 ///////////////////////////////////////////////////////////////////////////////
 
 }}
@@ -282,6 +282,9 @@ struct Vunit {
   bool profiling{false};
   Optional<TransContext> context;
   StructuredLogEntry* log_entry{nullptr};
+  // Set by allocateRegisters(): the allocator chosen and time spent in it.
+  bool usedGraphColor{false};
+  int64_t regAllocMicros{0};
   Annotations annotations;
 };
 
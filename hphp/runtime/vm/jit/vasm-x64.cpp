@@ -1278,16 +1278,7 @@ void optimizeX64(Vunit& unit, const Abi& abi, bool regalloc) {
 
       doPass("VOPT_BLOCK_WEIGHTS", VasmBlockCounters::profileGuidedUpdate);
 
-      if (RuntimeOption::EvalUseGraphColor &&
-          unit.context &&
-          (unit.context->kind == TransKind::Optimize ||
-           unit.context->kind == TransKind::OptPrologue)) {
-        rqtrace::EventGuard trace{"VOPT_GRAPH_COLOR"};
-        allocateRegistersWithGraphColor(unit, abi);
-      } else {
-        rqtrace::EventGuard trace{"VOPT_XLS"};
-        allocateRegistersWithXLS(unit, abi);
-      }
+      allocateRegisters(unit, abi);
       doPass("VOPT_SF_PEEPHOLES", [&] (Vunit& u) { sfPeepholes(u, abi); });
       doPass("VOPT_POST_RA_SIMPLIFY", postRASimplify);
     }
@@ -16,13 +16,19 @@
 
 #include "hphp/runtime/vm/jit/vasm.h"
 
+#include "hphp/runtime/base/request-tracing.h"
+#include "hphp/runtime/base/runtime-option.h"
+
 #include "hphp/runtime/vm/jit/abi.h"
 #include "hphp/runtime/vm/jit/containers.h"
+#include "hphp/runtime/vm/jit/prof-data.h"
 #include "hphp/runtime/vm/jit/vasm-instr.h"
 #include "hphp/runtime/vm/jit/vasm-unit.h"
 #include "hphp/runtime/vm/jit/vasm-visit.h"
 #include "hphp/runtime/vm/jit/vasm-print.h"
 
+#include "hphp/util/timer.h"
+
 #include <boost/dynamic_bitset.hpp>
 
 #include <algorithm>
@@ -259,4 +265,76 @@ jit::vector<Vlabel> sortBlocks(const Vunit& unit) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+/*
+ * Profile weight of the hottest profiling translation that fed `ctx'.
+ */
+int64_t unitProfWeight(const TransContext& ctx) {
+  auto const pd = profData();
+  if (!pd) return 0;
+  int64_t weight = 0;
+  for (auto const tid : ctx.transIDs) {
+    if (tid >= pd->numTransRecs() || !pd->transRec(tid)) continue;
+    weight = std::max(weight, pd->transCounter(tid));
+  }
+  return weight;
+}
+
+/*
+ * The profile weight at Eval.JitGraphColorHotPercentile across all profiling
+ * translations. Computed once, at the first optimized translation; profiling
+ * has quiesced by then, so the counters are stable.
+ */
+int64_t graphColorWeightThreshold() {
+  static int64_t const threshold = [] () -> int64_t {
+    auto const pd = profData();
+    if (!pd) return 0;
+    std::vector<int64_t> weights;
+    auto const n = pd->numTransRecs();
+    weights.reserve(n);
+    for (TransID tid = 0; tid < n; ++tid) {
+      if (!pd->transRec(tid)) continue;
+      weights.push_back(pd->transCounter(tid));
+    }
+    if (weights.empty()) return 0;
+    auto const pct =
+      std::min(RuntimeOption::EvalJitGraphColorHotPercentile, 100u);
+    auto const idx = std::min(weights.size() * pct / 100, weights.size() - 1);
+    std::nth_element(weights.begin(), weights.begin() + idx, weights.end());
+    return weights[idx];
+  }();
+  return threshold;
+}
+
+bool shouldUseGraphColor(const Vunit& unit) {
+  if (!RuntimeOption::EvalUseGraphColor) return false;
+  if (!unit.context) return false;
+  auto const kind = unit.context->kind;
+  if (kind != TransKind::Optimize && kind != TransKind::OptPrologue) {
+    return false;
+  }
+  auto const pct = RuntimeOption::EvalJitGraphColorHotPercentile;
+  if (pct == 0) return true;
+  return unitProfWeight(*unit.context) >= graphColorWeightThreshold();
+}
+
+}
+
+void allocateRegisters(Vunit& unit, const Abi& abi) {
+  auto const useGraphColor = shouldUseGraphColor(unit);
+  auto const start = Timer::GetThreadCPUTimeNanos();
+  if (useGraphColor) {
+    rqtrace::EventGuard trace{"VOPT_GRAPH_COLOR"};
+    allocateRegistersWithGraphColor(unit, abi);
+  } else {
+    rqtrace::EventGuard trace{"VOPT_XLS"};
+    allocateRegistersWithXLS(unit, abi);
+  }
+  unit.usedGraphColor = useGraphColor;
+  unit.regAllocMicros = (Timer::GetThreadCPUTimeNanos() - start) / 1000;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 }}
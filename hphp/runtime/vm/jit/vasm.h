@@ -126,6 +126,14 @@ bool checkNoCriticalEdges(const Vunit& unit);
 /*
  * Passes.
  */
+
+/*
+ * Allocate registers for `unit', picking the allocator by tier: optimized
+ * translations whose profile weight clears Eval.JitGraphColorHotPercentile
+ * get graph coloring, everything else the cheaper linear scan. Records the
+ * choice and the time spent on the unit for logTranslation.
+ */
+void allocateRegisters(Vunit&, const Abi&);
 void allocateRegistersWithXLS(Vunit&, const Abi&);
 void allocateRegistersWithGraphColor(Vunit&, const Abi&);
 void annotateSFUses(Vunit&);
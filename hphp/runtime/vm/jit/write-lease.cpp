@@ -20,6 +20,7 @@
 #include "hphp/runtime/vm/treadmill.h"
 
 #include "hphp/util/atomic-vector.h"
+#include "hphp/util/lock-contention.h"
 #include "hphp/util/process.h"
 #include "hphp/util/struct-log.h"
 #include "hphp/util/timer.h"
@@ -106,8 +107,19 @@ bool Lease::acquire(bool blocking /* = false */ ) {
   }
 
   checkRank(RankWriteLease);
-  auto const locked = blocking ? pthread_mutex_lock(&m_lock)
-                               : pthread_mutex_trylock(&m_lock);
+  auto locked = pthread_mutex_trylock(&m_lock);
+  if (locked != 0 && blocking) {
+    // Contended blocking acquire; sample the wait so lease contention shows
+    // up in the lock.wait_us.jit_write_lease histogram.
+    if (UNLIKELY(LockContention::sample())) {
+      auto const start = Timer::GetCurrentTimeMicros();
+      locked = pthread_mutex_lock(&m_lock);
+      LockContention::record("jit_write_lease",
+                             Timer::GetCurrentTimeMicros() - start);
+    } else {
+      locked = pthread_mutex_lock(&m_lock);
+    }
+  }
   if (locked == 0) {
     if (debug) pushRank(RankWriteLease);
 
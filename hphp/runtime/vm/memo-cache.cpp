@@ -18,9 +18,14 @@
 
 #include "hphp/runtime/base/string-data.h"
 #include "hphp/runtime/base/tv-refcount.h"
+#include "hphp/runtime/base/tv-uncounted.h"
+#include "hphp/runtime/vm/treadmill.h"
+
+#include "hphp/util/hash-map.h"
 
 #include <bitset>
 #include <type_traits>
+#include <vector>
 #include <folly/container/F14Map.h>
 
 namespace HPHP {
@@ -1038,4 +1043,172 @@ SharedMemoCacheSetter sharedMemoCacheSetForKeyCount(size_t count) {
   return MemoCacheSetSharedBuilder<kMemoCacheMaxSpecializedKeys>::get(count);
 }
 
+////////////////////////////////////////////////////////////
+
+namespace {
+
+// The process-wide cache tier. Keys pair a FuncId with the key values; both
+// the stored keys and the stored values are uncounted, so entries may be read
+// from any request. Values live in their own uncounted allocations, so a
+// lookup can hand out a stable pointer; the allocations are only freed via
+// the Treadmill (see memoCachePersistentClear()).
+
+struct PersistentKey {
+  FuncId::Int funcId;
+  std::vector<TypedValue> keys;
+};
+
+struct PersistentKeyHasher {
+  size_t operator()(const PersistentKey& k) const {
+    auto hash = combineHashes(k.funcId, k.keys.size());
+    for (auto const& elem : k.keys) {
+      assertx(isIntType(elem.m_type) || isStringType(elem.m_type));
+      hash = combineHashes(
+        hash,
+        isIntType(elem.m_type) ? elem.m_data.num : elem.m_data.pstr->hash()
+      );
+    }
+    return hash;
+  }
+};
+
+struct PersistentKeyEquals {
+  bool operator()(const PersistentKey& k1, const PersistentKey& k2) const {
+    if (k1.funcId != k2.funcId || k1.keys.size() != k2.keys.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < k1.keys.size(); ++i) {
+      auto const& e1 = k1.keys[i];
+      auto const& e2 = k2.keys[i];
+      if (isIntType(e1.m_type)) {
+        if (!isIntType(e2.m_type) || e1.m_data.num != e2.m_data.num) {
+          return false;
+        }
+      } else if (!isStringType(e2.m_type) ||
+                 !e1.m_data.pstr->same(e2.m_data.pstr)) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+using PersistentMemoCache = folly_concurrent_hash_map_simd<
+  PersistentKey,
+  const TypedValue*,
+  PersistentKeyHasher,
+  PersistentKeyEquals
+>;
+
+PersistentMemoCache& persistentMemoCache() {
+  static PersistentMemoCache cache;
+  return cache;
+}
+
+// Whether a value may be stored in the process-wide tier. Anything containing
+// an object (or other request-local data) cannot be made uncounted.
+bool isPersistableMemoValue(TypedValue val) {
+  switch (val.m_type) {
+    case KindOfNull:
+    case KindOfBoolean:
+    case KindOfInt64:
+    case KindOfDouble:
+    case KindOfPersistentString:
+    case KindOfString:
+      return true;
+    case KindOfPersistentVec:
+    case KindOfVec:
+    case KindOfPersistentDict:
+    case KindOfDict:
+    case KindOfPersistentKeyset:
+    case KindOfKeyset: {
+      auto const features =
+        DataWalker{DataWalker::LookupFeature::DetectNonPersistable}
+          .traverseData(val.m_data.parr);
+      return !features.isCircular && !features.hasNonPersistable;
+    }
+    default:
+      return false;
+  }
+}
+
+void freePersistentEntry(const PersistentKey& key, const TypedValue* val) {
+  for (auto const& elem : key.keys) DecRefUncounted(elem);
+  DecRefUncounted(*val);
+  FreeUncounted(const_cast<TypedValue*>(val), sizeof(TypedValue));
+}
+
+}
+
+const TypedValue* memoCacheGetPersistent(FuncId funcId,
+                                         const TypedValue* keys,
+                                         uint32_t keyCount) {
+  auto const& cache = persistentMemoCache();
+  // The probe key just borrows the request-local keys; hashing and equality
+  // only look at the key contents.
+  PersistentKey probe{funcId.toInt(), {keys, keys + keyCount}};
+  auto const it = cache.find(probe);
+  if (it == cache.cend()) return nullptr;
+  assertx(tvIsPlausible(*it->second));
+  assertx(it->second->m_type != KindOfUninit);
+  return it->second;
+}
+
+void memoCacheSetPersistent(FuncId funcId,
+                            const TypedValue* keys,
+                            uint32_t keyCount,
+                            TypedValue val) {
+  assertx(tvIsPlausible(val));
+  assertx(val.m_type != KindOfUninit);
+  if (!isPersistableMemoValue(val)) return;
+
+  MakeUncountedEnv env{nullptr};
+  PersistentKey key;
+  key.funcId = funcId.toInt();
+  key.keys.reserve(keyCount);
+  for (uint32_t i = 0; i < keyCount; ++i) {
+    assertx(isIntType(keys[i].m_type) || isStringType(keys[i].m_type));
+    auto elem = keys[i];
+    if (isStringType(elem.m_type)) {
+      elem.m_data.pstr = MakeUncountedString(elem.m_data.pstr, env);
+      elem.m_type = KindOfPersistentString;
+    }
+    key.keys.push_back(elem);
+  }
+
+  auto const stored =
+    static_cast<TypedValue*>(AllocUncounted(sizeof(TypedValue)));
+  *stored = val;
+  ConvertTvToUncounted(stored, env);
+
+  // The wrapper computes its value from its arguments alone, so if we lost an
+  // insertion race the existing value is as good as ours. Our copy was never
+  // published, so it can be freed without waiting for the Treadmill.
+  auto const inserted = persistentMemoCache().insert(key, stored).second;
+  if (!inserted) freePersistentEntry(key, stored);
+}
+
+void memoCachePersistentClear() {
+  auto& cache = persistentMemoCache();
+  std::vector<std::pair<PersistentKey, const TypedValue*>> entries;
+  for (auto const& kv : cache) entries.emplace_back(kv.first, kv.second);
+  if (entries.empty()) return;
+  // Erase the snapshotted keys individually rather than calling clear(): an
+  // entry inserted between the snapshot and a clear() would be removed
+  // without ever reaching freePersistentEntry() and leak its uncounted data.
+  // Entries that race in stay cached -- the clear is best-effort -- and we
+  // only free what we actually erased, in case of a concurrent clear.
+  std::vector<std::pair<PersistentKey, const TypedValue*>> erased;
+  erased.reserve(entries.size());
+  for (auto& kv : entries) {
+    if (cache.erase(kv.first)) erased.emplace_back(std::move(kv));
+  }
+  if (erased.empty()) return;
+  // Another request may be holding pointers into these entries, so only free
+  // them once every request that may have observed them has finished.
+  Treadmill::enqueue([erased = std::move(erased)] {
+    for (auto const& kv : erased) freePersistentEntry(kv.first, kv.second);
+  });
+}
+
 }
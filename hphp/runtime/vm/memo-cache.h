@@ -199,6 +199,34 @@ void memoCacheSetSharedOnly(MemoCacheBase*& base,
 
 ////////////////////////////////////////////////////////////
 
+/*
+ * Process-wide cache tier
+ *
+ * Memoize wrappers which HHBBC marked AttrPersistentMemoize compute their
+ * values from their arguments alone, so those values can be shared across
+ * requests. This tier sits above the per-request caches: it is consulted on a
+ * per-request miss and written on a per-request store. Values (and any string
+ * keys) are stored in uncounted form, so the returned TypedValue requires no
+ * ref-count manipulation and stays valid for at least the duration of the
+ * current request; the entries are only freed via the Treadmill, once every
+ * request which may have observed them has finished. Values which cannot be
+ * made uncounted (e.g. anything containing an object) are silently not
+ * stored.
+ */
+const TypedValue* memoCacheGetPersistent(FuncId funcId,
+                                         const TypedValue* keys,
+                                         uint32_t keyCount);
+void memoCacheSetPersistent(FuncId funcId,
+                            const TypedValue* keys,
+                            uint32_t keyCount,
+                            TypedValue val);
+
+// Drop every entry in the process-wide tier. The backing values are freed via
+// the Treadmill.
+void memoCachePersistentClear();
+
+////////////////////////////////////////////////////////////
+
 // We only have key-count specialized caches for key-counts up to and including
 // this. Most of the time you don't need to check this and instead using the
 // getter/setter lookup functions defined above.
@@ -28,7 +28,10 @@
 #include "hphp/runtime/vm/type-alias.h"
 #include "hphp/runtime/vm/unit-util.h"
 
+#include "hphp/util/bloom-filter.h"
+
 #include <folly/AtomicHashMap.h>
+#include <folly/hash/Hash.h>
 
 #include <atomic>
 
@@ -126,6 +129,25 @@ namespace {
  */
 NamedEntity::Map* s_namedDataMap;
 
+/*
+ * Blocked bloom filter over the names in s_namedDataMap, so lookups that
+ * can't create (autoload and dynamic-resolution probes for symbols that
+ * genuinely don't exist yet) answer with a single cache-line probe instead
+ * of a table lookup.  Sized by Eval.NamedEntityFilterSize; stays disabled
+ * (and answers "maybe") when that's 0.
+ */
+BlockedBloomFilter s_nameFilter;
+
+/*
+ * The table compares names with isame(), so hash with the matching
+ * case-insensitive string hash.  The filter wants all 64 bits to be
+ * well-mixed (the top half picks the block), so spread the 32-bit string
+ * hash with a full-width mixer.
+ */
+uint64_t filterHash(const StringData* str) {
+  return folly::hash::twang_mix64(static_cast<uint32_t>(str->hash()));
+}
+
 /*
  * Initialize the NamedEntity table.
  */
@@ -135,6 +157,9 @@ void initializeNamedDataMap() {
   config.growthFactor = 1;
   config.entryCountThreadCacheSize = 10;
 
+  if (auto const size = RuntimeOption::EvalNamedEntityFilterSize) {
+    s_nameFilter.init(size);
+  }
   s_namedDataMap = new (vm_malloc(sizeof(NamedEntity::Map)))
     NamedEntity::Map(RuntimeOption::EvalInitialNamedEntityTableSize, config);
 }
@@ -147,6 +172,9 @@ NamedEntity* insertNamedEntity(const StringData* str) {
   if (!str->isStatic()) {
     str = makeStaticString(str);
   }
+  // Record the name before publishing the entry, so a probe that sees the
+  // entry also sees the filter bits.
+  s_nameFilter.insert(filterHash(str));
   auto res = s_namedDataMap->insert(str, NamedEntity());
   static std::atomic<bool> signaled{false};
   checkAHMSubMaps(*s_namedDataMap, "named entity table", signaled);
@@ -172,6 +200,16 @@ NamedEntity* NamedEntity::get(const StringData* str,
     initializeNamedDataMap();
   }
 
+  // A definite filter miss means the name was never inserted, so a
+  // non-creating lookup can skip the table entirely.  Names needing
+  // namespace normalization still take the slow path below, since the
+  // normalized form may well be present.
+  if (!allowCreate &&
+      !s_nameFilter.mayContain(filterHash(str)) &&
+      !needsNSNormalization(str)) {
+    return nullptr;
+  }
+
   auto const result = [&]() -> NamedEntity* {
     auto it = s_namedDataMap->find(str);
     if (LIKELY(it != s_namedDataMap->end())) {
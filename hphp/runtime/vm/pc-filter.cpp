@@ -25,103 +25,90 @@ TRACE_SET_MOD(debuggerflow);
 
 //////////////////////////////////////////////////////////////////////////
 
-void PCFilter::PtrMapNode::clearImpl(unsigned short bits) {
-  static_assert(sizeof(PCFilter::PtrMapNode) == sizeof(PCFilter::PtrMap) &&
-                sizeof(PCFilter::PtrMapNode) == sizeof(void*),
-                "PtrMapNode and PtrMap must hold a single pointer");
-
-  // clear all the sub levels and mark all slots NULL
-  if (bits <= PTRMAP_LEVEL_BITS) {
-    assertx(bits == PTRMAP_LEVEL_BITS);
-    return;
-  }
-  for (int i = 0; i < PTRMAP_LEVEL_ENTRIES; i++) {
-    if (m_entries[i].m_entries) {
-      m_entries[i].clearImpl(bits - PTRMAP_LEVEL_BITS);
-      free(m_entries[i].m_entries);
-      m_entries[i].m_entries = nullptr;
+// Insert [start, end), merging with any intervals it overlaps or abuts.
+void PCFilter::addInterval(const unsigned char* start,
+                           const unsigned char* end) {
+  if (start >= end) return;
+
+  auto it = m_intervals.upper_bound(start);
+  if (it != m_intervals.begin()) {
+    auto const prev = std::prev(it);
+    if (prev->second >= start) {
+      if (prev->second >= end) return;
+      start = prev->first;
+      end = std::max(end, prev->second);
+      it = m_intervals.erase(prev);
     }
   }
-}
-
-auto PCFilter::PtrMap::makeNode() -> PtrMapNode {
-  return {
-    static_cast<PtrMapNode*>(
-      calloc(PCFilter::PTRMAP_LEVEL_ENTRIES, sizeof(PtrMapNode))
-    )
-  };
-}
-
-void* PCFilter::PtrMap::getPointerImpl(void* ptr) const {
-  auto current = &m_root;
-  assertx(current->m_entries);
-  unsigned short cursor = PTRMAP_PTR_SIZE;
-  do {
-    cursor -= PTRMAP_LEVEL_BITS;
-    unsigned long index = ((PTRMAP_LEVEL_MASK << cursor) & (unsigned long)ptr)
-                          >> cursor;
-    assertx(index < PTRMAP_LEVEL_ENTRIES);
-    current = &current->m_entries[index];
-    if (!cursor) return current->m_value;
-  } while (current->m_entries);
-  return nullptr;
-}
-
-void PCFilter::PtrMap::setPointer(void* ptr, void* val) {
-  if (!m_root.m_entries) {
-    if (!val) return;
-    m_root = makeNode();
+  while (it != m_intervals.end() && it->first <= end) {
+    end = std::max(end, it->second);
+    it = m_intervals.erase(it);
   }
+  m_intervals.emplace(start, end);
+}
 
-  auto current = &m_root;
-  unsigned short cursor = PTRMAP_PTR_SIZE;
-  while (true) {
-    cursor -= PTRMAP_LEVEL_BITS;
-    unsigned long index = ((PTRMAP_LEVEL_MASK << cursor) & (unsigned long)ptr)
-                          >> cursor;
-    assertx(index < PTRMAP_LEVEL_ENTRIES);
-    if (!cursor) {
-      current->m_entries[index].m_value = val;
-      break;
-    }
-    if (!current->m_entries[index].m_entries)  {
-      current->m_entries[index] = makeNode();
+// Remove [start, end), splitting any interval that extends past either side.
+void PCFilter::removeInterval(const unsigned char* start,
+                              const unsigned char* end) {
+  if (start >= end) return;
+
+  auto it = m_intervals.upper_bound(start);
+  if (it != m_intervals.begin()) {
+    auto const prev = std::prev(it);
+    if (prev->second > start) {
+      auto const prevEnd = prev->second;
+      if (prev->first < start) {
+        prev->second = start;
+      } else {
+        it = m_intervals.erase(prev);
+      }
+      if (prevEnd > end) {
+        m_intervals.emplace(end, prevEnd);
+        return;
+      }
     }
-    current = &current->m_entries[index];
   }
-}
-
-void PCFilter::PtrMap::clear() {
-  if (m_root.m_entries) {
-    m_root.clearImpl(PTRMAP_PTR_SIZE);
-    free(m_root.m_entries);
-    m_root.m_entries = nullptr;
+  while (it != m_intervals.end() && it->first < end) {
+    if (it->second > end) {
+      auto const tailEnd = it->second;
+      m_intervals.erase(it);
+      m_intervals.emplace(end, tailEnd);
+      return;
+    }
+    it = m_intervals.erase(it);
   }
 }
 
 // Adds a range of PCs to the filter given a collection of offset ranges.
 // Omit PCs which have opcodes that don't pass the given opcode filter.
+// Contiguous runs of allowed instructions are inserted as one interval.
 void PCFilter::addRanges(const OffsetFuncRangeVec& funcOffsets,
                          OpcodeFilter isOpcodeAllowed) {
   for (auto offsets : funcOffsets) {
     auto func = offsets.first;
     for (auto range = offsets.second.cbegin(); range != offsets.second.cend(); ++range) {
       TRACE(3, "\toffsets [%d, %d)\n", range->base, range->past);
+      PC runStart = nullptr;
       for (PC pc = func->at(range->base); pc < func->at(range->past);
           pc += instrLen(pc)) {
         if (isOpcodeAllowed(peek_op(pc))) {
           TRACE(3, "\t\tpc %p\n", pc);
-          addPC(pc);
+          if (!runStart) runStart = pc;
         } else {
           TRACE(3, "\t\tpc %p -- skipping (offset %d)\n", pc,
                 func->offsetOf(pc));
+          if (runStart) {
+            addInterval(runStart, pc);
+            runStart = nullptr;
+          }
         }
       }
+      if (runStart) addInterval(runStart, func->at(range->past));
     }
   }
 }
 
-// Removes a range of PCs to the filter given a collection of offset ranges.
+// Removes a range of PCs from the filter given a collection of offset ranges.
 // Omit PCs which have opcodes that don't pass the given opcode filter.
 void PCFilter::removeRanges(const OffsetFuncRangeVec& funcOffsets,
                             OpcodeFilter isOpcodeAllowed) {
@@ -129,16 +116,22 @@ void PCFilter::removeRanges(const OffsetFuncRangeVec& funcOffsets,
     auto func = offsets.first;
     for (auto range = offsets.second.cbegin(); range != offsets.second.cend(); ++range) {
       TRACE(3, "\toffsets [%d, %d) (remove)\n", range->base, range->past);
+      PC runStart = nullptr;
       for (PC pc = func->at(range->base); pc < func->at(range->past);
           pc += instrLen(pc)) {
         if (isOpcodeAllowed(peek_op(pc))) {
           TRACE(3, "\t\tpc %p (remove)\n", pc);
-          removePC(pc);
+          if (!runStart) runStart = pc;
         } else {
           TRACE(3, "\t\tpc %p -- skipping (offset %d) (remove)\n", pc,
                 func->offsetOf(pc));
+          if (runStart) {
+            removeInterval(runStart, pc);
+            runStart = nullptr;
+          }
         }
       }
+      if (runStart) removeInterval(runStart, func->at(range->past));
     }
   }
 }
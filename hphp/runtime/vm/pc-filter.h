@@ -19,54 +19,31 @@
 
 #include "hphp/runtime/vm/func.h"
 
+#include <map>
+
 namespace HPHP {
 ////////////////////////////////////////////////////////////////////////////////
 
-// Map which holds a set of PCs and supports reasonably fast addition and
-// lookup. Used to decide if a given PC falls within an interesting area, e.g.,
-// for breakpoints and stepping.
+// Set of PCs which supports fast addition and lookup. Used to decide if a
+// given PC falls within an interesting area, e.g., for breakpoints and
+// stepping.
+//
+// Internally the set is kept as sorted, non-overlapping [start, end)
+// intervals over PC addresses. Containment is a single ordered-map probe,
+// and a range of bytecode inserts one interval per contiguous run of
+// instructions rather than one entry per instruction. Queries must always
+// be instruction boundaries; intervals make no attempt to distinguish PCs
+// in the interior of an instruction.
 struct PCFilter {
-  static constexpr auto PTRMAP_PTR_SIZE = sizeof(void*) * 8;
-  static constexpr auto PTRMAP_LEVEL_BITS = 8LL;
-  static constexpr auto PTRMAP_LEVEL_ENTRIES = 1LL << PTRMAP_LEVEL_BITS;
-  static constexpr auto PTRMAP_LEVEL_MASK = PTRMAP_LEVEL_ENTRIES - 1LL;
 private:
-  // Radix-tree implementation of pointer map
-  struct PtrMapNode {
-    union {
-      PtrMapNode* m_entries;
-      void* m_value;
-    };
-    void clearImpl(unsigned short bits);
-  };
-  struct PtrMap {
-    PtrMap() {
-      static_assert(PTRMAP_PTR_SIZE % PTRMAP_LEVEL_BITS == 0,
-                    "PTRMAP_PTR_SIZE must be a multiple of PTRMAP_LEVEL_BITS");
-      m_root.m_entries = nullptr;
-    }
-    ~PtrMap() { clear(); }
-    PtrMap(const PtrMap&) = delete;
-    PtrMap& operator=(const PtrMap&) = delete;
+  using IntervalMap = std::map<const unsigned char*, const unsigned char*>;
 
-    static PtrMapNode makeNode();
-    void setPointer(void* ptr, void* val);
-    void* getPointer(void* ptr) const {
-      if (!m_root.m_entries) return nullptr;
-      return getPointerImpl(ptr);
-    }
-    void clear();
-    void swap(PtrMap& other) {
-      std::swap(m_root, other.m_root);
-    }
-    bool isNull() { return m_root.m_entries == nullptr; }
-  private:
-    void* getPointerImpl(void* ptr) const;
-    PtrMapNode m_root;
-    TYPE_SCAN_IGNORE_FIELD(m_root); // points to a malloc'd radix tree node
-  };
+  // Keys and values point into bytecode, not at scanned heap objects.
+  IntervalMap m_intervals;
+  TYPE_SCAN_IGNORE_FIELD(m_intervals);
 
-  PtrMap m_map;
+  void addInterval(const unsigned char* start, const unsigned char* end);
+  void removeInterval(const unsigned char* start, const unsigned char* end);
 
 public:
   PCFilter() {}
@@ -84,26 +61,27 @@ public:
 
   // Add/remove/check explicit PCs.
   void addPC(const unsigned char* pc) {
-    m_map.setPointer((void*)pc, (void*)pc);
+    addInterval(pc, pc + 1);
   }
   void removePC(const unsigned char* pc) {
-    m_map.setPointer((void*)pc, nullptr);
+    removeInterval(pc, pc + 1);
   }
-  bool checkPC(const unsigned char* pc) {
-    return m_map.getPointer((void*)pc) == (void*)pc;
+  bool checkPC(const unsigned char* pc) const {
+    auto const it = m_intervals.upper_bound(pc);
+    if (it == m_intervals.begin()) return false;
+    return pc < std::prev(it)->second;
   }
 
-  bool isNull() { return m_map.isNull(); }
+  bool isNull() const { return m_intervals.empty(); }
 
   void swap(PCFilter& other) {
-    m_map.swap(other.m_map);
+    m_intervals.swap(other.m_intervals);
   }
 
   void clear() {
-    m_map.clear();
+    m_intervals.clear();
   }
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 }
-
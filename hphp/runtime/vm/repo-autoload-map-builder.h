@@ -53,22 +53,45 @@ struct RepoAutoloadMapBuilder {
 private:
   template<typename Compare>
   static void serdeMap(BlobEncoder& sd, const Map<Compare>& map) {
-    sd(map.size());
-    for (auto const& kv : map) sd(kv.first)(kv.second);
+    // The symbol set is closed once the repo is built, so emit a
+    // minimal perfect hash table over it, serialized in slot order so
+    // the loader doesn't have to build any hashtable.
+    using Perfect = RepoSymbolMap<Compare>;
+    std::vector<typename Perfect::Entry> entries;
+    entries.reserve(map.size());
+    for (auto const& kv : map) entries.emplace_back(kv.first, kv.second);
+    auto const perfect = Perfect::build(std::move(entries));
+
+    sd(perfect.seed);
+    sd(perfect.entries.size());
+    for (auto const& e : perfect.entries) sd(e.first)(e.second);
+    for (auto const& d : perfect.displacements) sd(d.first)(d.second);
   }
 
   template<typename Map>
   static Map serdeMap(BlobDecoder& sd) {
+    Map map;
+    sd(map.seed);
     size_t size;
     sd(size);
-    Map map(size);
+    map.entries.reserve(size);
     for (size_t i = 0; i < size; i++) {
       const StringData* str;
       int64_t unitSn;
       sd(str)
         (unitSn)
         ;
-      map[str] = unitSn;
+      map.entries.emplace_back(str, unitSn);
+    }
+    // There are as many displacement pairs as entries.
+    map.displacements.reserve(size);
+    for (size_t i = 0; i < size; i++) {
+      uint32_t d1;
+      uint32_t d2;
+      sd(d1)
+        (d2)
+        ;
+      map.displacements.emplace_back(d1, d2);
     }
     return map;
   }
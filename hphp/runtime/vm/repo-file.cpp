@@ -33,6 +33,9 @@
 #include <folly/FileUtil.h>
 #include <folly/String.h>
 
+#include <map>
+
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -44,10 +47,14 @@ namespace HPHP {
 namespace {
 
 // Wrapper around file descriptor for automatic closing and wrapping
-// operations in a nicer interface.
+// operations in a nicer interface. A non-zero base offset makes all reads
+// and seeks relative to that position, so a repo embedded in a larger
+// container (eg a jumpstart bundle) reads exactly like a standalone file.
 struct FD {
   FD() : m_fd{-1} {}
-  FD(const std::string& path, int flags) : m_path{path}
+  FD(const std::string& path, int flags, size_t base = 0)
+    : m_path{path}
+    , m_base{base}
   {
     auto fd = folly::openNoInt(m_path.c_str(), flags, 0644);
     if (fd < 0) {
@@ -58,11 +65,14 @@ struct FD {
       );
     }
     m_fd = fd;
+    if (m_base) seek(0);
   }
   ~FD() { if (isOpen()) ::close(m_fd); }
 
   bool isOpen() const { return m_fd >= 0; }
 
+  int fd() const { return m_fd; }
+
   void write(const void* data, size_t size) const {
     auto const written = folly::writeFull(m_fd, data, size);
     if (written == size) return;
@@ -100,7 +110,7 @@ struct FD {
   }
 
   void pread(void* data, size_t size, size_t offset) const {
-    auto const read = folly::preadFull(m_fd, data, size, offset);
+    auto const read = folly::preadFull(m_fd, data, size, offset + m_base);
     if (read == size) return;
     if (read < 0) {
       auto const error = folly::errnoStr(errno);
@@ -118,8 +128,8 @@ struct FD {
   }
 
   void seek(size_t offset) const {
-    auto const actualOffset = ::lseek(m_fd, offset, SEEK_SET);
-    if (actualOffset == offset) return;
+    auto const actualOffset = ::lseek(m_fd, offset + m_base, SEEK_SET);
+    if (actualOffset == offset + m_base) return;
     if (actualOffset < 0) {
       auto const error = folly::errnoStr(errno);
       always_assert_flog(
@@ -135,9 +145,11 @@ struct FD {
     );
   }
 
+  size_t base() const { return m_base; }
+
   uint64_t fileSize() const {
     auto const size = ::lseek(m_fd, 0, SEEK_END);
-    if (size >= 0) return size;
+    if (size >= 0) return size - m_base;
     auto const error = folly::errnoStr(errno);
     always_assert_flog(
       false,
@@ -152,6 +164,7 @@ struct FD {
   FD(FD&& o) noexcept
     : m_fd{o.m_fd}
     , m_path{std::move(o.m_path)}
+    , m_base{o.m_base}
   {
     o.m_fd = -1;
   }
@@ -159,11 +172,13 @@ struct FD {
   FD& operator=(FD&& o) {
     std::swap(m_fd, o.m_fd);
     std::swap(m_path, o.m_path);
+    std::swap(m_base, o.m_base);
     return *this;
   }
 private:
   int m_fd;
   std::string m_path;
+  size_t m_base{0};
 };
 
 uint8_t  hostToFile(uint8_t v)  { return v; }
@@ -297,6 +312,13 @@ struct RepoFileBuilder::Data {
     size_t offset;
   };
   std::vector<UnitEmitterIndex> unitEmittersIndex;
+
+  // The emit workers can finish encoding units in any order, but we
+  // write them out in SN order so the file contents are deterministic
+  // for a given input. SNs are assigned densely, so we just buffer any
+  // unit which arrives early until its predecessors have been written.
+  int64_t nextSN = 0;
+  std::map<int64_t, EncodedUE> pendingUnits;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -331,28 +353,53 @@ RepoFileBuilder::RepoFileBuilder(const std::string& path)
 RepoFileBuilder::~RepoFileBuilder() {
 }
 
-void RepoFileBuilder::add(const EncodedUE& ue) {
+void RepoFileBuilder::add(EncodedUE ue) {
   assertx(m_data);
   assertx(ue.path->isStatic());
   assertx(ue.sn >= 0);
 
-  m_data->unitEmittersIndex.emplace_back(
-    RepoFileBuilder::Data::UnitEmitterIndex{
-      ue.path,
-      ue.sn,
-      m_data->sizes.unitEmittersSize
-    }
-  );
+  auto const write = [&] (const EncodedUE& e) {
+    m_data->unitEmittersIndex.emplace_back(
+      RepoFileBuilder::Data::UnitEmitterIndex{
+        e.path,
+        e.sn,
+        m_data->sizes.unitEmittersSize
+      }
+    );
+
+    auto const size = e.blob.size();
+    always_assert(size <= kUnitEmitterSizeLimit);
+    m_data->fd.write(e.blob.data(), size);
+    m_data->sizes.unitEmittersSize += size;
+  };
+
+  // Not this unit's turn yet; stash it until the units before it have
+  // been written.
+  if (ue.sn != m_data->nextSN) {
+    auto const DEBUG_ONLY inserted =
+      m_data->pendingUnits.emplace(ue.sn, std::move(ue)).second;
+    assertx(inserted);
+    return;
+  }
 
-  auto const size = ue.blob.size();
-  always_assert(size <= kUnitEmitterSizeLimit);
-  m_data->fd.write(ue.blob.data(), size);
-  m_data->sizes.unitEmittersSize += size;
+  write(ue);
+  ++m_data->nextSN;
+
+  // Flush any buffered units which are now consecutive.
+  auto it = m_data->pendingUnits.begin();
+  while (it != m_data->pendingUnits.end() && it->first == m_data->nextSN) {
+    write(it->second);
+    ++m_data->nextSN;
+    it = m_data->pendingUnits.erase(it);
+  }
 }
 
 void RepoFileBuilder::finish(const RepoGlobalData& global,
                              const RepoAutoloadMapBuilder& autoloadMap) {
   assertx(m_data);
+  // SNs are dense, so by the time everything has been added there
+  // should be no buffered units left.
+  always_assert(m_data->pendingUnits.empty());
 
   // Unit emitter indices (which lets us find a particular
   // UnitEmitter).
@@ -524,6 +571,10 @@ struct RepoFileData {
   FD fd;
 
   std::string path;
+  // Non-zero when the repo lives inside a larger container file (eg a
+  // jumpstart bundle); preserved so postfork() can re-open the same window.
+  uint64_t containerOffset = 0;
+  uint64_t containerSize = 0;
 
   SizeHeader sizes;
   uint64_t fileSize = 0;
@@ -544,13 +595,60 @@ struct RepoFileData {
   std::vector<Bounds> literals;
   std::vector<Bounds> arrays;
 
+  // Read-only shared mapping of the literal string table section, if we
+  // managed to create one. Literal loads decode straight out of the mapping
+  // instead of pread-ing into a transient heap buffer, and the pages are
+  // clean page-cache pages shared across any processes using this repo.
+  char* litstrMapBase = nullptr;
+  size_t litstrMapLength = 0;
+  size_t litstrMapAdjust = 0;
+
   std::atomic<bool> loadedLitstrTable{false};
   std::atomic<bool> loadedLitarrayTable{false};
   std::atomic<bool> loadedUnitEmitterIndices{false};
+
+  ~RepoFileData() {
+    if (litstrMapBase) ::munmap(litstrMapBase, litstrMapLength);
+  }
 };
 
 std::unique_ptr<RepoFileData> s_repoFileData{};
 
+// Map the literal string table section read-only. On any failure just leave
+// the mapping empty; literal loads fall back to pread.
+void mapLiteralTable(RepoFileData& data) {
+  assertx(!data.litstrMapBase);
+  auto const size = data.sizes.literalTableSize;
+  if (size == 0) return;
+  auto const pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  // mmap offsets are absolute within the underlying file, so add the fd's
+  // base offset before aligning.
+  auto const absOffset = data.literalTableOffset + data.fd.base();
+  auto const mapStart = absOffset & ~(pageSize - 1);
+  auto const adjust = absOffset - mapStart;
+  auto const base = ::mmap(
+    nullptr, size + adjust, PROT_READ, MAP_SHARED, data.fd.fd(), mapStart
+  );
+  if (base == MAP_FAILED) return;
+  data.litstrMapBase = static_cast<char*>(base);
+  data.litstrMapLength = size + adjust;
+  data.litstrMapAdjust = adjust;
+}
+
+// Obtain a decoder for `size' bytes at `offset' within the literal string
+// table section, decoding in place when the section is mapped.
+Blob literalBlob(const RepoFileData& data, size_t offset, size_t size) {
+  if (data.litstrMapBase) {
+    BlobDecoder decoder{
+      data.litstrMapBase + data.litstrMapAdjust + offset,
+      size,
+      false
+    };
+    return Blob{nullptr, std::move(decoder)};
+  }
+  return loadBlob(data.fd, data.literalTableOffset + offset, size, false);
+}
+
 // Lazily load the unit's path
 const StringData* UnitInfo::getPath(const RepoFileData& data) {
   assertx(valid());
@@ -623,13 +721,17 @@ const StringData* UnitInfo::getPath(const RepoFileData& data) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void RepoFile::init(const std::string& path) {
+void RepoFile::init(const std::string& path,
+                    uint64_t offset,
+                    uint64_t size) {
   assertx(!s_repoFileData);
   s_repoFileData = std::make_unique<RepoFileData>();
   s_repoFileData->path = path;
+  s_repoFileData->containerOffset = offset;
+  s_repoFileData->containerSize = size;
 
   auto& data = *s_repoFileData;
-  data.fd = FD{path, O_CLOEXEC | O_RDONLY};
+  data.fd = FD{path, O_CLOEXEC | O_RDONLY, offset};
 
   {
     std::remove_cv_t<decltype(kMagic)> magic;
@@ -665,7 +767,7 @@ void RepoFile::init(const std::string& path) {
 
   {
     data.sizes.read(data.fd);
-    data.fileSize = data.fd.fileSize();
+    data.fileSize = size ? size : data.fd.fileSize();
 
     auto offset =
       sizeof(kMagic) + sizeof(kCurrentVersion) +
@@ -746,10 +848,12 @@ void RepoFile::destroy() {
 
 void RepoFile::postfork() {
   if (!s_repoFileData) return;
-  // Save the file path, then destroy and re-init state.
+  // Save the file location, then destroy and re-init state.
   auto const path = s_repoFileData->path;
+  auto const offset = s_repoFileData->containerOffset;
+  auto const size = s_repoFileData->containerSize;
   RepoFile::destroy();
-  RepoFile::init(path);
+  RepoFile::init(path, offset, size);
 }
 
 const RepoGlobalData& RepoFile::globalData() {
@@ -768,12 +872,8 @@ void RepoFile::loadGlobalTables(bool lazyLiterals) {
   // Literal strings. We need to do this first because other sections
   // might want to use literals.
   {
-    auto blob = loadBlob(
-      data.fd,
-      data.literalTableOffset,
-      data.sizes.literalTableSize,
-      false
-    );
+    mapLiteralTable(data);
+    auto blob = literalBlob(data, 0, data.sizes.literalTableSize);
 
     auto& table = LitstrTable::get();
     assertx(table.numLitstrs() == 0);
@@ -966,12 +1066,7 @@ StringData* RepoFile::loadLitstr(size_t id) {
   if (id == 0 || id > data.literals.size()) return nullptr;
 
   auto const& index = data.literals[id - 1];
-  auto blob = loadBlob(
-    data.fd,
-    data.literalTableOffset + index.offset,
-    index.size,
-    false
-  );
+  auto blob = literalBlob(data, index.offset, index.size);
   const StringData* litstr;
   blob.decoder(litstr);
   blob.decoder.assertDone();
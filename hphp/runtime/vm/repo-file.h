@@ -78,9 +78,12 @@ struct RepoFileBuilder {
   };
 
   // Add the given UnitEmitter to the repo file. This will encode it
-  // and then write it to disk. This can only be called before
-  // finish() is called.
-  void add(const EncodedUE& ue);
+  // and then write it to disk. Units may be added in any order (the
+  // emit workers finish out of order); they are buffered as needed and
+  // written in unit-sn order, so the resulting file is deterministic
+  // for a given input. This can only be called before finish() is
+  // called.
+  void add(EncodedUE ue);
   void add(const UnitEmitter& ue) { add(EncodedUE{ue}); }
 
   // "Finish" the repo file by writing RepoGlobalData, the
@@ -122,8 +125,12 @@ struct RepoFile {
   // Initialize the repo file at the given path. This opens the file
   // and loads some indexing information. No other functions on
   // RepoFile can be called until the repo is initialized. This
-  // function cannot be called concurrently.
-  static void init(const std::string& path);
+  // function cannot be called concurrently. A non-zero offset/size
+  // reads the repo from that window of the file instead, for repos
+  // embedded in a container such as a jumpstart bundle.
+  static void init(const std::string& path,
+                   uint64_t offset = 0,
+                   uint64_t size = 0);
   // "Destroys" the repo file. This releases any open file descriptors
   // on the file and destroys any indexing information. If the repo
   // file hasn't been initialized, this does nothing. This function
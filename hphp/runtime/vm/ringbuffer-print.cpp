@@ -15,6 +15,7 @@
 */
 #include "hphp/runtime/vm/ringbuffer-print.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include <folly/Format.h>
@@ -132,4 +133,23 @@ void dumpRingBuffer(int numEntries, uint32_t threadId) {
   dumpRingBufferMasked(numEntries, -1u, threadId);
 }
 
+KEEP_SECTION
+void dumpFlightRecorder(int numEntriesPerThread) {
+  for (auto rec = g_flightRecorders.load(std::memory_order_acquire);
+       rec != nullptr;
+       rec = rec->next) {
+    std::cerr << folly::format("Thread {:#x} flight recorder:\n",
+                               rec->threadId);
+    auto const idx = rec->idx;
+    auto const total = std::min(idx, kFlightRecorderEntries);
+    auto const n = std::min(uint32_t(numEntriesPerThread), total);
+    // The oldest surviving entry is at idx % kFlightRecorderEntries once the
+    // ring has wrapped; dump the newest n in chronological order.
+    for (uint32_t i = total - n; i < total; i++) {
+      auto const slot = (idx - total + i) % kFlightRecorderEntries;
+      dumpEntry(&rec->entries[slot]);
+    }
+  }
+}
+
 } }
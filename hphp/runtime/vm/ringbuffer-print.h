@@ -21,5 +21,11 @@ namespace HPHP { namespace Trace {
 
 void dumpRingBuffer(int numEntries, uint32_t threadId);
 
+/*
+ * Dump the last `numEntriesPerThread' flight recorder entries of every
+ * registered thread.  Safe to call from the crash handler.
+ */
+void dumpFlightRecorder(int numEntriesPerThread);
+
 } }
 
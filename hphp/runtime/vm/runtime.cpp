@@ -68,7 +68,12 @@ void print_boolean(bool val) {
 StringData* concat_ss(StringData* v1, StringData* v2) {
   if (v1->cowCheck()) {
     FOLLY_SDT(hhvm, hhvm_cow_concat, v1->size(), v2->size());
-    StringData* ret = StringData::Make(v1, v2);
+    // Give the copy append()-style headroom: a shared LHS is typically the
+    // head of a concat chain (.= in a loop), and an exact-size copy would
+    // be reallocated by the very next in-place append.
+    auto const len = size_t(v1->size()) + size_t(v2->size());
+    auto const cap = std::min(len + (len >> 2), size_t(StringData::MaxSize));
+    auto const ret = StringData::Make(cap)->append(v1->slice(), v2->slice());
     // Because v1 was shared, we know this won't release the string.
     v1->decRefCount();
     return ret;
@@ -107,7 +112,10 @@ StringData* concat_si(StringData* v1, int64_t v2) {
   if (v1->cowCheck()) {
     auto const s1 = v1->slice();
     FOLLY_SDT(hhvm, hhvm_cow_concat, s1.size(), s2.size());
-    auto const ret = StringData::Make(s1, s2);
+    // As in concat_ss, leave headroom for the rest of the concat chain.
+    auto const len = s1.size() + s2.size();
+    auto const cap = std::min(len + (len >> 2), size_t(StringData::MaxSize));
+    auto const ret = StringData::Make(cap)->append(s1, s2);
     // Because v1 was shared, we know this won't release it.
     v1->decRefCount();
     return ret;
@@ -18,7 +18,7 @@
 namespace HPHP {
 
 // Static empty table header for all TreadHashMap instances. It is can be casted
-// as a Table with zero capacity and zero size.
-uint64_t g_emptyTable{0};
+// as a Table with zero capacity and zero size (and a null prev pointer).
+uint64_t g_emptyTable[3]{0, 0, 0};
 
 }
@@ -15,6 +15,7 @@
 */
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <type_traits>
 
@@ -27,7 +28,7 @@
 
 namespace HPHP {
 
-extern uint64_t g_emptyTable;
+extern uint64_t g_emptyTable[3];
 
 /*
  * A hashtable safe for multiple concurrent readers, even while writes are
@@ -39,19 +40,25 @@ extern uint64_t g_emptyTable;
  * Key must be an atomically loadable/storable type.  The Value must be a
  * trivially copyable and assignable type, and it must be legal to copy from it
  * without synchronization (this table may do this during a rehash).  Also,
- * assumes Key == 0 is invalid (i.e. the empty key).
+ * assumes Key == 0 is invalid (i.e. the empty key).  HashFunc must be
+ * stateless and default-constructible.
  *
  * Insertions must be unique.  It is an error to insert the same key more than
  * once.
  *
+ * Growth is incremental: when the table fills up, a larger table is
+ * published immediately and each subsequent insert migrates a bounded
+ * number of slots from the old table, so no single insert pays for a full
+ * rehash.  Until the old table is drained, readers that miss in the new
+ * table probe the old one, keeping reads wait-free throughout.
+ *
  * Uses the treadmill to collect garbage.
  */
 
 template<class Key, class Val,
          class HashFunc = std::hash<Key>,
          class Alloc = std::allocator<char>>
-struct TreadHashMap : private HashFunc,
-                      private Alloc::template rebind<char>::other {
+struct TreadHashMap : private Alloc::template rebind<char>::other {
   using Allocator = typename Alloc::template rebind<char>::other;
   using value_type = std::pair<std::atomic<Key>,Val>;
   static_assert(
@@ -64,36 +71,62 @@ private:
   struct Table {
     uint32_t capac;
     uint32_t size;
+    // Older, smaller table we're still migrating out of, or nullptr.  Only
+    // the head table ever has a non-null prev, so chains have length at
+    // most two.
+    std::atomic<Table*> prev;
+    // Migration cursor: slots of prev below this index have been copied
+    // into this table.  Written only by the writer thread.
+    uint32_t scan;
     value_type entries[0];
   };
 
+  // Number of slots of the previous table each insert migrates.  Has to be
+  // at least two so migration outpaces the fresh inserts that will
+  // eventually fill this table; higher values drain the old table sooner
+  // at a small per-insert cost.
+  static constexpr uint32_t kMigrateSlotsPerInsert = 8;
+
   Table* staticEmptyTable() {
     static_assert(sizeof(Table) == sizeof(g_emptyTable), "");
-    return reinterpret_cast<Table*>(&g_emptyTable);
+    return reinterpret_cast<Table*>(&g_emptyTable[0]);
   }
 
 public:
   explicit TreadHashMap(uint32_t initialCapacity)
     : m_table(staticEmptyTable())
-    , m_initialSize(folly::nextPowTwo(initialCapacity))
+      // Keep the smallest table comfortably larger than one migration
+      // step so the occupancy headroom check below stays meaningful.
+    , m_initialSize(folly::nextPowTwo(
+        std::max(initialCapacity, 4 * kMigrateSlotsPerInsert)))
   {}
 
   ~TreadHashMap() {
     auto t = m_table.load(std::memory_order_acquire);
-    if (t != staticEmptyTable()) {
+    while (t != nullptr && t != staticEmptyTable()) {
+      auto const prev = t->prev.load(std::memory_order_acquire);
       freeTable(t);
+      t = prev;
     }
   }
 
   TreadHashMap(const TreadHashMap&) = delete;
   TreadHashMap& operator=(const TreadHashMap&) = delete;
 
+  /*
+   * Iteration visits the old table (if a migration is still in flight)
+   * before the head table, and skips head entries that also exist in the
+   * old table so migrated keys are reported exactly once.  The old table
+   * is never written to once it stops being the head, so the duplicate
+   * check races with nothing.
+   */
   template<class IterVal>
   struct thm_iterator
     : boost::iterator_facade<thm_iterator<IterVal>,IterVal,
                              boost::forward_traversal_tag>
   {
-    explicit thm_iterator() : m_table(nullptr) {}
+    explicit thm_iterator() : m_head(nullptr), m_prev(nullptr),
+                              m_table(nullptr) {}
 
     // Conversion constructor for interoperability between iterator
     // and const_iterator.  The enable_if<> magic prevents the
@@ -104,17 +137,28 @@ public:
                  typename std::enable_if<
                    std::is_convertible<OtherVal*,IterVal*>::value
                  >::type* = 0)
-      : m_table(o.m_table)
+      : m_head(o.m_head)
+      , m_prev(o.m_prev)
+      , m_table(o.m_table)
       , m_offset(o.m_offset)
     {}
 
-    explicit thm_iterator(Table* tab, size_t offset)
-      : m_table(tab)
-      , m_offset(offset)
+    explicit thm_iterator(Table* head, Table* prev)
+      : m_head(head)
+      , m_prev(prev)
+      , m_table(prev ? prev : head)
+      , m_offset(0)
     {
       advancePastEmpty();
     }
 
+    explicit thm_iterator(Table* head, size_t offset)
+      : m_head(head)
+      , m_prev(nullptr)
+      , m_table(head)
+      , m_offset(offset)
+    {}
+
   private:
     friend struct TreadHashMap;
     friend class boost::iterator_core_access;
@@ -134,13 +178,27 @@ public:
 
   private:
     void advancePastEmpty() {
-      while (m_offset < m_table->capac &&
-        m_table->entries[m_offset].first.load(std::memory_order_acquire) == 0) {
+      for (;;) {
+        if (m_offset >= m_table->capac) {
+          if (m_table == m_head) return; // end
+          m_table = m_head;
+          m_offset = 0;
+          continue;
+        }
+        auto const key =
+          m_table->entries[m_offset].first.load(std::memory_order_acquire);
+        if (key != 0 &&
+            !(m_table == m_head && m_prev &&
+              TreadHashMap::findInTable(m_prev, key))) {
+          return;
+        }
         ++m_offset;
       }
     }
 
   private:
+    Table* m_head;
+    Table* m_prev;
     Table* m_table;
     size_t m_offset;
   };
@@ -149,16 +207,17 @@ public:
   typedef thm_iterator<const value_type> const_iterator;
 
   size_t size() const {
-    return m_table.load(std::memory_order_acquire)->size;
+    return m_size.load(std::memory_order_acquire);
   }
 
   iterator begin() {
-    return iterator(m_table.load(std::memory_order_acquire), 0);
+    auto const head = m_table.load(std::memory_order_acquire);
+    return iterator(head, head->prev.load(std::memory_order_acquire));
   }
 
   iterator end() {
     auto tab = m_table.load(std::memory_order_acquire);
-    return iterator(tab, tab->capac);
+    return iterator(tab, size_t{tab->capac});
   }
 
   const_iterator begin() const {
@@ -170,29 +229,33 @@ public:
 
   Val* insert(Key key, Val val) {
     assertx(key != 0);
-    return insertImpl(acquireAndGrowIfNeeded(), key, val);
+    auto const tab = acquireAndGrowIfNeeded();
+    auto const ret = insertImpl(tab, key, val);
+    m_size.fetch_add(1, std::memory_order_release);
+    migrateSome(tab);
+    return ret;
   }
 
   Val* find(Key key) const {
     assertx(key != 0);
 
+    // A miss in the head table falls through to the older table a pending
+    // migration is draining, so keys stay visible throughout a grow.
     auto tab = m_table.load(std::memory_order_acquire);
-    if (tab->size == 0) return nullptr; // empty
-    assertx(tab->capac > tab->size);
-    auto idx = project(tab, key);
-    for (;;) {
-      auto& entry = tab->entries[idx];
-      Key currentProbe = entry.first.load(std::memory_order_acquire);
-      if (currentProbe == key) return &entry.second;
-      if (currentProbe == 0) return nullptr;
-      if (++idx == tab->capac) idx = 0;
+    while (tab != nullptr) {
+      if (auto const val = findInTable(tab, key)) return val;
+      tab = tab->prev.load(std::memory_order_acquire);
     }
+    return nullptr;
   }
 
   template<typename F> void filter_keys(F fn) {
     auto const old = m_table.load(std::memory_order_acquire);
     if (UNLIKELY(old == staticEmptyTable())) return;
 
+    // Finish any in-flight migration so we only have one table to rewrite.
+    while (old->prev.load(std::memory_order_acquire)) migrateSome(old);
+
     Table* newTable = allocTable(old->capac);
     for (auto i = uint32_t{}; i < old->capac; ++i) {
       auto const ent = &old->entries[i];
@@ -200,10 +263,51 @@ public:
       if (key && !fn(key)) insertImpl(newTable, key, ent->second);
     }
     Treadmill::enqueue([this, old] { freeTable(old); });
+    m_size.store(newTable->size, std::memory_order_release);
     m_table.store(newTable, std::memory_order_release);
   }
 
 private:
+  static Val* findInTable(Table* tab, Key key) {
+    if (tab->size == 0) return nullptr; // empty (or the static empty table)
+    assertx(tab->capac > tab->size);
+    auto idx = project(tab, key);
+    for (;;) {
+      auto& entry = tab->entries[idx];
+      Key currentProbe = entry.first.load(std::memory_order_acquire);
+      if (currentProbe == key) return &entry.second;
+      if (currentProbe == 0) return nullptr;
+      if (++idx == tab->capac) idx = 0;
+    }
+  }
+
+  /*
+   * Copy a bounded number of slots from the table head->prev is draining
+   * into head, detaching and treadmilling it once the cursor reaches the
+   * end.  Entries stay in place in the old table until it's freed; readers
+   * probe the head first, so they see the migrated copy as soon as it's
+   * published and the old copy until then.
+   */
+  void migrateSome(Table* head) {
+    auto const prev = head->prev.load(std::memory_order_acquire);
+    if (LIKELY(prev == nullptr)) return;
+
+    auto i = head->scan;
+    auto const limit =
+      std::min(i + kMigrateSlotsPerInsert, prev->capac);
+    for (; i < limit; ++i) {
+      auto const ent = &prev->entries[i];
+      auto const key = ent->first.load(std::memory_order_acquire);
+      if (key) insertImpl(head, key, ent->second);
+    }
+    head->scan = i;
+
+    if (i == prev->capac) {
+      head->prev.store(nullptr, std::memory_order_release);
+      Treadmill::enqueue([this, prev] { freeTable(prev); });
+    }
+  }
+
   Val* insertImpl(Table* const tab, Key newKey, Val newValue) {
     auto probe = &tab->entries[project(tab, newKey)];
     assertx(size_t(probe - tab->entries) < tab->capac);
@@ -232,8 +336,9 @@ private:
   Table* acquireAndGrowIfNeeded() {
     auto old = m_table.load(std::memory_order_acquire);
 
-    // 50% occupancy, avoiding the FPU.
-    if (LIKELY((old->size) < (old->capac / 2))) {
+    // 50% occupancy, avoiding the FPU.  The headroom covers this insert
+    // plus one migration step, so occupancy never exceeds the target.
+    if (LIKELY((old->size + kMigrateSlotsPerInsert) < (old->capac / 2))) {
       return old;
     }
 
@@ -241,22 +346,22 @@ private:
     if (UNLIKELY(old == staticEmptyTable())) {
       newTable = allocTable(m_initialSize);
     } else {
+      // In steady state migration drains the previous table long before
+      // the head fills up; finish it off here in case it hasn't, so
+      // chains never exceed two tables.
+      while (old->prev.load(std::memory_order_acquire)) migrateSome(old);
       newTable = allocTable(old->capac * 2);
-      for (uint32_t i = 0; i < old->capac; ++i) {
-        auto const ent = old->entries + i;
-        auto const key = ent->first.load(std::memory_order_acquire);
-        if (key) insertImpl(newTable, key, ent->second);
-      }
-      Treadmill::enqueue([this, old] { freeTable(old); });
+      // Don't copy old's entries; publish the new head with old chained
+      // behind it and let subsequent inserts migrate them incrementally.
+      newTable->prev.store(old, std::memory_order_relaxed);
     }
-    assertx(newTable->size == old->size); // only one writer thread
     m_table.store(newTable, std::memory_order_release);
     return newTable;
   }
 
-  size_t project(Table* tab, Key key) const {
+  static size_t project(Table* tab, Key key) {
     assertx(folly::isPowTwo(tab->capac));
-    return HashFunc::operator()(key) & (tab->capac - 1);
+    return HashFunc{}(key) & (tab->capac - 1);
   }
 
   constexpr size_t allocSize(uint32_t cap) {
@@ -279,6 +384,9 @@ private:
 private:
   std::atomic<Table*> m_table;
   uint32_t m_initialSize;
+  // Logical entry count.  Table::size counts slots in use in one table,
+  // which transiently double-counts keys during a migration; this doesn't.
+  std::atomic<uint32_t> m_size{0};
 };
 
 //////////////////////////////////////////////////////////////////////
@@ -18,6 +18,11 @@
 
 #include <list>
 #include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
 #include <vector>
 #include <memory>
 #include <algorithm>
@@ -27,6 +32,7 @@
 #include <signal.h>
 
 #include <folly/portability/SysTime.h>
+#include <folly/system/ThreadName.h>
 
 #include "hphp/runtime/base/runtime-option.h"
 #include "hphp/runtime/base/request-info.h"
@@ -66,6 +72,10 @@ struct TreadmillRequestInfo {
 
 pthread_mutex_t s_genLock = PTHREAD_MUTEX_INITIALIZER;
 std::vector<TreadmillRequestInfo> s_inflightRequests;
+// The start times of all requests in flight, kept in order so retiring a
+// request finds the new oldest in O(log n) instead of scanning every
+// request slot. Guarded by s_genLock, like s_inflightRequests.
+std::multiset<GenCount> s_inflightStartTimes;
 GenCount s_latestCount = 0;
 std::atomic<GenCount> s_oldestRequestInFlight(0);
 
@@ -181,6 +191,70 @@ struct PendingTriggers : std::list<std::unique_ptr<WorkItem>> {
 
 static PendingTriggers s_tq;
 bool PendingTriggers::s_destroyed = false;
+
+namespace {
+
+/*
+ * Retired work items are drained by a dedicated thread rather than by the
+ * request thread that happened to finish the oldest generation: after a
+ * deploy the treadmill can hold a huge batch of deferred frees, and running
+ * them inline made one unlucky request absorb the whole thing. The drain
+ * thread runs items in generation order, releasing its lock every
+ * kDrainSliceSize items so enqueuers never wait on item execution.
+ */
+constexpr size_t kDrainSliceSize = 128;
+
+struct WorkItemDrainer {
+  std::mutex lock;
+  std::condition_variable cv;
+  std::deque<std::unique_ptr<WorkItem>> queue;
+};
+
+WorkItemDrainer& drainer() {
+  // Leaked on purpose: the detached drain thread may touch it after static
+  // destruction has begun.
+  static WorkItemDrainer* d = new WorkItemDrainer();
+  return *d;
+}
+
+void drainLoop() {
+  auto& d = drainer();
+  while (true) {
+    std::vector<std::unique_ptr<WorkItem>> slice;
+    {
+      std::unique_lock<std::mutex> guard(d.lock);
+      d.cv.wait(guard, [&] { return !d.queue.empty(); });
+      auto const n = std::min(d.queue.size(), kDrainSliceSize);
+      slice.reserve(n);
+      for (size_t i = 0; i < n; ++i) {
+        slice.emplace_back(std::move(d.queue.front()));
+        d.queue.pop_front();
+      }
+    }
+    for (auto& item : slice) item->run();
+  }
+}
+
+void scheduleToDrain(std::vector<std::unique_ptr<WorkItem>>&& items) {
+  if (items.empty()) return;
+  static std::once_flag s_started;
+  std::call_once(s_started, [] {
+    std::thread([] {
+      folly::setThreadName("treadmill-drain");
+      drainLoop();
+    }).detach();
+  });
+  auto& d = drainer();
+  {
+    std::lock_guard<std::mutex> guard(d.lock);
+    for (auto& item : items) d.queue.emplace_back(std::move(item));
+  }
+  d.cv.notify_one();
+  items.clear();
+}
+
+}
+
 void enqueueInternal(std::unique_ptr<WorkItem> gt) {
   if (PendingTriggers::s_destroyed) {
     return;
@@ -208,6 +282,7 @@ void startRequest(SessionKind session_kind) {
       assertx(s_inflightRequests[requestIdx].startTime == kIdleGenCount);
     }
     s_inflightRequests[requestIdx].startTime = correctTime(startTime);
+    s_inflightStartTimes.insert(s_inflightRequests[requestIdx].startTime);
     s_inflightRequests[requestIdx].pthreadId = Process::GetThreadId();
     s_inflightRequests[requestIdx].requestId = Logger::GetRequestId();
     s_inflightRequests[requestIdx].sessionKind = session_kind;
@@ -234,6 +309,9 @@ void finishRequest() {
     assertx(s_inflightRequests[requestIdx].startTime != kIdleGenCount);
     GenCount finishedRequest = s_inflightRequests[requestIdx].startTime;
     s_inflightRequests[requestIdx].startTime = kIdleGenCount;
+    auto const it = s_inflightStartTimes.find(finishedRequest);
+    assertx(it != s_inflightStartTimes.end());
+    s_inflightStartTimes.erase(it);
 
     // After finishing a request, check to see if we've allowed any triggers
     // to fire and update the time of the oldest request in flight.
@@ -241,12 +319,9 @@ void finishRequest() {
     // don't need to check anything as there cannot be any WorkItem to run.
     if (s_oldestRequestInFlight.load(std::memory_order_relaxed) ==
         finishedRequest) {
-      GenCount limit = s_latestCount + 1;
-      for (auto& val : s_inflightRequests) {
-        if (val.startTime != kIdleGenCount && val.startTime < limit) {
-          limit = val.startTime;
-        }
-      }
+      GenCount limit = s_inflightStartTimes.empty()
+        ? s_latestCount + 1
+        : *s_inflightStartTimes.begin();
       // update "oldest in flight" or kill it if there are no running requests
       s_oldestRequestInFlight = limit == s_latestCount + 1 ? 0 : limit;
 
@@ -291,9 +366,7 @@ void finishRequest() {
       }
     }
   }
-  for (unsigned i = 0; i < toFire.size(); ++i) {
-    toFire[i]->run();
-  }
+  scheduleToDrain(std::move(toFire));
 }
 
 int64_t getOldestRequestGenCount() {
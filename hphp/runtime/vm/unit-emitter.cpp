@@ -356,10 +356,9 @@ std::unique_ptr<Unit> UnitEmitter::create() const {
         )->create();
       }
     }
-    if (!isSystemLib && RuntimeOption::EvalVerifyOnly) {
-      std::fflush(stdout);
-      _Exit(0);
-    }
+    // NB: a successful verification deliberately falls through and
+    // builds the Unit even with Eval.VerifyOnly set; "hhvm -m verify"
+    // may have more units to check in this process.
   }
 
   std::unique_ptr<Unit> u {
@@ -484,6 +483,10 @@ template <typename SerDe>
 void UnitEmitter::serde(SerDe& sd, bool lazy) {
   MemoryManager::SuppressOOM so(*tl_heap);
 
+  // The bytecode dedup map is scoped to a single encoding of this
+  // unit; offsets from a previous encoding would be meaningless.
+  if constexpr (!SerDe::deserializing) m_bcDedup.clear();
+
   serdeMetaData(sd);
   // These are not touched by serdeMetaData:
   sd(m_ICE);
@@ -548,6 +551,10 @@ void UnitEmitter::serde(SerDe& sd, bool lazy) {
   // HHBBC array types
   sd(m_arrayTypeTable);
 
+  // Each func and class record is encoded with an explicit size
+  // prefix, so a record can be skipped without decoding it. Nothing
+  // skips them yet: this is groundwork for materializing FuncEmitters
+  // on first touch instead of decoding every one at unit load.
   auto serdeFuncEmitters = [&](auto& funcs, auto create) {
     seq(
       funcs,
@@ -558,14 +565,14 @@ void UnitEmitter::serde(SerDe& sd, bool lazy) {
         sd(name);
 
         auto fe = create(name, sn, i);
-        fe->serde(sd, lazy);
+        sd.withSize([&] { fe->serde(sd, lazy); });
         fe->setEHTabIsSorted();
         fe->finish();
       },
       [&] (auto& sd, auto& fe) {
         sd(fe->sn());
         sd(fe->name);
-        fe->serde(sd, false);
+        sd.withSize([&] { fe->serde(sd, false); });
       }
     );
   };
@@ -594,14 +601,22 @@ void UnitEmitter::serde(SerDe& sd, bool lazy) {
       std::string name;
       sd(name);
       auto pce = newPreClassEmitter(name);
-      pce->serdeMetaData(sd);
-      assertx(pce->id() == i);
-      serdeMethods(pce);
+      sd.withSize(
+        [&] {
+          pce->serdeMetaData(sd);
+          assertx(pce->id() == i);
+          serdeMethods(pce);
+        }
+      );
     },
     [&] (auto& sd, PreClassEmitter* pce) {
       sd(pce->name()->toCppString());
-      pce->serdeMetaData(sd);
-      serdeMethods(pce);
+      sd.withSize(
+        [&] {
+          pce->serdeMetaData(sd);
+          serdeMethods(pce);
+        }
+      );
     }
   );
 
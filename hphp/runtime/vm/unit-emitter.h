@@ -265,6 +265,18 @@ public:
   FatalOp m_fatalOp;
   std::string m_fatalMsg;
 
+  /*
+   * Map from the SHA1 of a function body to the offset at which its
+   * bytecode was written in the blob currently being encoded. Only
+   * used while serializing this unit, to alias byte-identical
+   * function bodies (common with codegen'd accessors and
+   * trait-flattened methods) instead of writing them out repeatedly.
+   */
+  struct SHA1Hasher {
+    size_t operator()(const SHA1& s) const { return s.hash(); }
+  };
+  hphp_fast_map<SHA1, uint64_t, SHA1Hasher> m_bcDedup;
+
 private:
   SHA1 m_sha1;
   SHA1 m_bcSha1;
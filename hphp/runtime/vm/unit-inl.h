@@ -45,6 +45,11 @@ inline SymbolRefs* Unit::claimSymbolRefsForPrefetch() {
   return &extended->m_symbolRefsForPrefetch;
 }
 
+inline bool Unit::claimHierarchyPrefetch() {
+  if (!m_extended) return false;
+  return !getExtended()->m_hierarchyPrefetched.test_and_set();
+}
+
 inline const UnitExtended* Unit::getExtended() const {
   assertx(m_extended);
   return static_cast<const UnitExtended*>(this);
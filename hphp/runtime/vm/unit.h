@@ -501,6 +501,13 @@ public:
    */
   SymbolRefs* claimSymbolRefsForPrefetch();
 
+  /*
+   * Atomically claim the right to prefetch this Unit's class
+   * hierarchy (see Eval.UnitPrefetchClassHierarchy). Returns true
+   * exactly once per Unit.
+   */
+  bool claimHierarchyPrefetch();
+
   // Total number of Units ever created
   static size_t createdUnitCount() { return s_createdUnits; }
 
@@ -570,6 +577,7 @@ struct UnitExtended : Unit {
   // Used by Unit prefetcher:
   SymbolRefs m_symbolRefsForPrefetch;
   std::atomic_flag m_symbolRefsPrefetched;
+  std::atomic_flag m_hierarchyPrefetched;
 
   std::atomic<int64_t> m_cacheRefCount{0};
 
@@ -272,7 +272,7 @@ const StaticString s_hphpd_break("hphpd_break");
 }
 
 Offset findCatchHandler(const Func* func, Offset raiseOffset) {
-  auto const eh = func->findEH(raiseOffset);
+  auto const eh = func->findEHCached(raiseOffset);
   if (eh == nullptr) return kInvalidOffset;
   return eh->m_handler;
 }
@@ -392,7 +392,7 @@ UnwinderResult unwindVM(Either<ObjectData*, Exception*> exception,
     if (RequestInfo::s_requestInfo->m_pendingException == nullptr &&
         phpException && !UNLIKELY(fp->localsDecRefd())) {
 
-      const EHEnt* eh = func->findEH(func->offsetOf(pc));
+      const EHEnt* eh = func->findEHCached(func->offsetOf(pc));
       if (eh != nullptr) {
         // Found exception handler. Push the exception on top of the
         // stack and resume VM.
@@ -19,11 +19,16 @@
 #include "hphp/runtime/base/init-fini-node.h"
 
 #include "hphp/util/compilation-flags.h"
+#include "hphp/util/cycles.h"
 #include "hphp/util/service-data.h"
 #include "hphp/util/thread-local.h"
 #include "hphp/util/timer.h"
 
+#include <folly/Format.h>
+
+#include <atomic>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace HPHP {
@@ -55,6 +60,76 @@ void end(DeltaCounter& dc) {
   if (debug) dc.start = kInvalidCounter;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+// Per-endpoint workload accounting (Eval.ProfileWorkloadPerEndpoint).  Each
+// endpoint gets a set of ServiceData counters, created lazily and cached here
+// so the hot path is a map lookup plus atomic adds; the maps are sharded by
+// endpoint hash to keep request shutdown from serializing on one lock.
+struct EndpointCounters {
+  ServiceData::ExportedCounter* requests;
+  ServiceData::ExportedCounter* phpNanos;
+  ServiceData::ExportedCounter* interpNanos;
+  ServiceData::ExportedCounter* cycles;
+  ServiceData::ExportedCounter* trans;
+  ServiceData::ExportedCounter* interps;
+};
+
+constexpr size_t kEndpointShards = 16;
+constexpr size_t kMaxWorkloadEndpoints = 1000;
+
+struct EndpointShard {
+  std::mutex lock;
+  std::unordered_map<std::string, EndpointCounters> map;
+};
+EndpointShard s_endpointShards[kEndpointShards];
+std::atomic<size_t> s_numEndpoints{0};
+
+void accumulateEndpoint(const std::string& endpoint,
+                        int64_t phpNanos, int64_t interpNanos,
+                        int64_t cycles, int64_t trans, int64_t interps) {
+  // Endpoints beyond the cap fold into a catch-all, so URL-shaped traffic
+  // can't grow the maps (or the counter namespace) without bound.
+  static const std::string kOther("(other)");
+
+  auto key = &endpoint;
+  for (;;) {
+    auto& shard = s_endpointShards[
+      std::hash<std::string>{}(*key) % kEndpointShards];
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto it = shard.map.find(*key);
+    if (it == shard.map.end()) {
+      if (key != &kOther &&
+          s_numEndpoints.load(std::memory_order_relaxed) >=
+            kMaxWorkloadEndpoints) {
+        key = &kOther;
+        continue;
+      }
+      s_numEndpoints.fetch_add(1, std::memory_order_relaxed);
+      auto const make = [&] (const char* metric) {
+        return ServiceData::createCounter(
+          folly::sformat("vm.endpoint.{}.{}", *key, metric));
+      };
+      EndpointCounters counters;
+      counters.requests = make("requests");
+      counters.phpNanos = make("nanos_php");
+      counters.interpNanos = make("nanos_interp");
+      counters.cycles = make("cpu_cycles");
+      counters.trans = make("enter_trans");
+      counters.interps = make("enter_interp");
+      it = shard.map.emplace(*key, counters).first;
+    }
+    auto const& counters = it->second;
+    counters.requests->increment();
+    counters.phpNanos->addValue(phpNanos);
+    counters.interpNanos->addValue(interpNanos);
+    counters.cycles->addValue(cycles);
+    counters.trans->addValue(trans);
+    counters.interps->addValue(interps);
+    return;
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 }
 
@@ -72,6 +147,9 @@ struct RequestWorkloadStats final {
   void enter(State to);
   void leave();
 
+  void setEndpoint(const std::string& endpoint) { m_endpoint = endpoint; }
+  const std::string& endpoint() const { return m_endpoint; }
+
 private:
   // PHP time is time in a request not spent JITing.
   // Interp time is time spent interpreting PHP.  This discounts time spent
@@ -81,6 +159,11 @@ private:
   DeltaCounter m_php;
   DeltaCounter m_interp;
 
+  // Endpoint to attribute this request's totals to, and the request's
+  // starting cycle count; empty unless SetEndpoint() was called.
+  std::string m_endpoint;
+  uint64_t m_startCycles{0};
+
   uint64_t m_transitionCounts[3] = {};
 
   std::vector<State> m_s;
@@ -142,6 +225,8 @@ void RequestWorkloadStats::requestInit() {
   assertx(m_s.empty());
   m_php.acc = 0;
   m_interp.acc = 0;
+  m_endpoint.clear();
+  m_startCycles = cpuCycles();
   m_s.emplace_back(State::InRequest);
   start(m_php);
 
@@ -177,6 +262,13 @@ void RequestWorkloadStats::requestShutdown() {
   // Log state change counts.
   s_trans->addValue(m_transitionCounts[State::InTrans]);
   s_interps->addValue(m_transitionCounts[State::InInterp]);
+
+  if (!m_endpoint.empty()) {
+    accumulateEndpoint(m_endpoint, php, interp,
+                       cpuCycles() - m_startCycles,
+                       m_transitionCounts[State::InTrans],
+                       m_transitionCounts[State::InInterp]);
+  }
 }
 
 ALWAYS_INLINE void RequestWorkloadStats::transition(State from, State to) {
@@ -265,5 +357,13 @@ void WorkloadStats::EnsureInit() {
   s_request_workload_stats.getCheck();
 }
 
+void WorkloadStats::SetEndpoint(const std::string& endpoint) {
+  s_request_workload_stats->setEndpoint(endpoint);
+}
+
+const std::string& WorkloadStats::GetEndpoint() {
+  return s_request_workload_stats->endpoint();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 }
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <cstdint>
+#include <string>
 
 namespace HPHP {
 
@@ -56,6 +57,16 @@ struct WorkloadStats final {
 
   static int64_t GetAndResetAvgRelativeInterp();
   static void EnsureInit();
+
+  // Attribute the current request's workload counters to a logical endpoint.
+  // The totals (request/interp nanos, cpu cycles, and transition counts) are
+  // folded into sharded per-endpoint ServiceData counters at request
+  // shutdown.  See Eval.ProfileWorkloadPerEndpoint.
+  static void SetEndpoint(const std::string& endpoint);
+
+  // The endpoint set for the current request, or an empty string if
+  // SetEndpoint() hasn't been called (or no request is active).
+  static const std::string& GetEndpoint();
 };
 
 }
@@ -101,6 +101,10 @@ trait BaseException {
    * @return     mixed   Returns the Exception stack trace as an array.
    */
   final public function getTrace()[] {
+    if (\is_resource($this->trace)) {
+      // Compactly captured traces are only symbolized when inspected.
+      return \__SystemLib\extract_trace($this->trace);
+    }
     return $this->trace;
   }
 
@@ -111,7 +115,7 @@ trait BaseException {
   final protected function __prependTrace(
     \HH\Container $trace,
   )[write_props]: void {
-    $this->trace = vec(\array_merge(\array_values($trace), $this->trace));
+    $this->trace = vec(\array_merge(\array_values($trace), $this->getTrace()));
   }
 
   // This doc comment block generated by idl/sysdoc.php
@@ -125,7 +129,7 @@ trait BaseException {
   final public function getTraceAsString()[] {
     $i = 0;
     $s = "";
-    foreach ($this->trace as $frame) {
+    foreach ($this->getTrace() as $frame) {
       if (!\HH\is_any_array($frame)) continue;
       $s .= "#$i " .
         ($frame['file'] ?? "") . "(" .
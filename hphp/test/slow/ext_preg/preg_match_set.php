@@ -0,0 +1,48 @@
+<?hh
+
+// preg_match_set must agree with per-member preg_match: the literal
+// prefilter may only skip members that cannot match, never drop one
+// that would have.
+function expected(varray<string> $patterns, string $subject): varray<int> {
+  $exp = vec[];
+  foreach ($patterns as $i => $pattern) {
+    if (preg_match($pattern, $subject) === 1) $exp[] = $i;
+  }
+  return $exp;
+}
+
+<<__EntryPoint>>
+function main_preg_match_set(): void {
+  $cases = vec[
+    // Mix of prefiltered and non-prefilterable members
+    tuple(vec['/banana/', '/^a+b/', '/\d{4}-\d{2}/', '/cherry|lime/'],
+          'a 2024-06 banana aab'),
+    tuple(vec['/banana/', '/^a+b/', '/\d{4}-\d{2}/', '/cherry|lime/'],
+          'grape'),
+    // Inline flags: the subject matches without containing the literal
+    // a naive byte-exact extraction would have produced
+    tuple(vec['/(?i)FOO/', '/FOO/'], 'foo'),
+    tuple(vec['/(?i)FOO/', '/FOO/'], 'FOO'),
+    tuple(vec['/(?x)a b c/'], 'abc'),
+    // \Q...\E quoting: a quantifier after \E applies to the last quoted
+    // character, so "ab" is not a required literal of either pattern
+    tuple(vec['/\Qab\E*/', '/ab\E*/'], 'a'),
+    tuple(vec['/\Qab\E*/', '/ab\E*/'], 'abbb'),
+    // Trailing modifiers on an otherwise extractable body
+    tuple(vec['/FOO/i', '/a b/x'], 'foo ab'),
+    // Empty set
+    tuple(vec[], 'anything'),
+  ];
+  foreach ($cases as list($patterns, $subject)) {
+    $got = preg_match_set($patterns, $subject);
+    $exp = expected($patterns, $subject);
+    if ($got === $exp) {
+      echo "OK\n";
+    } else {
+      echo "MISMATCH subject='$subject' got=";
+      var_dump($got);
+      echo " exp=";
+      var_dump($exp);
+    }
+  }
+}
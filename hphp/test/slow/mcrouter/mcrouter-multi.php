@@ -0,0 +1,58 @@
+<?hh
+
+const PREFIX = 'HPHP_TEST_MCROUTER|';
+
+async function set_get_multi(MCRouter $mcr): Awaitable<string> {
+  $kvs = darray[
+    PREFIX . 'multi-a' => 'apple',
+    PREFIX . 'multi-b' => 'banana',
+    PREFIX . 'multi-c' => 'cherry',
+  ];
+  await $mcr->setMulti($kvs);
+
+  $keys = varray(array_keys($kvs));
+  $keys[] = PREFIX . 'multi-missing';
+  $out = await $mcr->getMulti($keys);
+  foreach ($kvs as $key => $in) {
+    if (!array_key_exists($key, $out)) {
+      return "Missing stored key '$key'";
+    }
+    if ($out[$key] !== $in) {
+      return "Got different value '{$out[$key]}' than stored '$in'";
+    }
+  }
+  if (array_key_exists(PREFIX . 'multi-missing', $out)) {
+    return "Got value for key that was never stored";
+  }
+  if (count($out) !== count($kvs)) {
+    return "Expected " . count($kvs) . " results, got " . count($out);
+  }
+
+  foreach (array_keys($kvs) as $key) {
+    await $mcr->del($key);
+  }
+
+  return "Success";
+}
+
+async function empty_multi(MCRouter $mcr): Awaitable<string> {
+  await $mcr->setMulti(darray[]);
+  $out = await $mcr->getMulti(varray[]);
+  if (count($out) !== 0) {
+    return "Expected empty result from empty multi-get";
+  }
+
+  return "Success";
+}
+<<__EntryPoint>> function main(): void {
+$servers = Vector { getenv('HPHP_TEST_MCROUTER') };
+$mcr = MCRouter::createSimple($servers);
+$wh = Vector {
+  set_get_multi($mcr),
+  empty_multi($mcr),
+};
+$results = HH\Asio\join(HH\Asio\v($wh));
+foreach ($results as $result) {
+  var_dump($result);
+}
+}
@@ -0,0 +1,84 @@
+<?hh
+
+/*
+ * Measures sort() over the value distributions we care about when tuning
+ * the runtime's sort paths: nearly-sorted logs, random ids, and
+ * low-cardinality enums, for int, double and string elements.
+ * Run it via './hhmeasure sort'.
+ */
+
+function nearly_sorted_ints(int $n): varray<int> {
+  $v = varray[];
+  for ($i = 0; $i < $n; $i++) {
+    $v[] = $i + (($i % 97 === 0) ? mt_rand(-50, 50) : 0);
+  }
+  return $v;
+}
+
+function random_ids(int $n): varray<int> {
+  $v = varray[];
+  for ($i = 0; $i < $n; $i++) {
+    $v[] = mt_rand();
+  }
+  return $v;
+}
+
+function low_cardinality_enums(int $n): varray<int> {
+  $v = varray[];
+  for ($i = 0; $i < $n; $i++) {
+    $v[] = mt_rand(0, 7);
+  }
+  return $v;
+}
+
+function random_doubles(int $n): varray<float> {
+  $v = varray[];
+  for ($i = 0; $i < $n; $i++) {
+    $v[] = mt_rand() / 7.0;
+  }
+  return $v;
+}
+
+function random_strings(int $n): varray<string> {
+  $v = varray[];
+  for ($i = 0; $i < $n; $i++) {
+    $v[] = md5((string)mt_rand());
+  }
+  return $v;
+}
+
+function time_sort(string $name, varray<arraykey> $input): void {
+  $run_count = 10;
+  $times = varray[];
+  for ($iter = 0; $iter < $run_count; $iter++) {
+    $copy = $input;
+    $start_time = microtime(true);
+    sort(inout $copy);
+    $end_time = microtime(true);
+    $times[] = ($end_time - $start_time) * 1000;
+  }
+  sort(inout $times);
+  $median = $times[(int)(count($times) / 2)];
+  $min = $times[0];
+  echo sprintf(
+    "%-40s median %10.3f ms   min %10.3f ms\n",
+    $name,
+    $median,
+    $min,
+  );
+}
+
+<<__EntryPoint>>
+function main_sort_ops(): void {
+  mt_srand(12345);
+  echo "sort() cost by distribution (lower is better)\n";
+  echo "---------------------------------------------\n";
+  foreach (varray[10000, 1000000] as $n) {
+    time_sort("nearly_sorted_ints($n)", nearly_sorted_ints($n));
+    time_sort("random_ids($n)", random_ids($n));
+    time_sort("low_cardinality_enums($n)", low_cardinality_enums($n));
+    time_sort("random_doubles($n)", random_doubles($n));
+    time_sort("random_strings($n)", random_strings($n));
+    echo "\n";
+  }
+}
@@ -127,22 +127,27 @@ def thread_local_get(tl):
     return tl['m_node']['m_p']
 
 
-def atomic_vector_at(av, idx, hasher=None):
+def atomic_growable_vector_elm(av, idx):
     size = av['m_size']
 
     if idx < size:
-        return atomic_get(rawptr(av['m_vals'])[idx])
-    else:
-        return atomic_vector_at(atomic_get(av['m_next']), idx - size)
+        return rawptr(av['m_vals'])[idx]
 
+    # Segment s holds m_segBase << s elements, preceded by
+    # m_segBase * (2^s - 1) elements; see atomic-vector-inl.h.
+    base = int(av['m_segBase'])
+    j = int(idx - size)
+    s = (j // base + 1).bit_length() - 1
+    seg = atomic_get(av['m_segments'][s])
+    return seg[j - ((base << s) - base)]
 
-def atomic_low_ptr_vector_at(av, idx, hasher=None):
-    size = av['m_size']
 
-    if idx < size:
-        return rawptr(rawptr(av['m_vals'])[idx])
-    else:
-        return atomic_low_ptr_vector_at(atomic_get(av['m_next']), idx - size)
+def atomic_vector_at(av, idx, hasher=None):
+    return atomic_get(atomic_growable_vector_elm(av, idx))
+
+
+def atomic_low_ptr_vector_at(av, idx, hasher=None):
+    return rawptr(atomic_growable_vector_elm(av, idx))
 
 
 def fixed_vector_at(fv, idx, hasher=None):
@@ -18,6 +18,7 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <limits.h>
+#include <unistd.h>
 #include <system_error>
 
 #include "hphp/util/assertions.h"
@@ -126,5 +127,75 @@ int recv_fd(int afdt_fd) {
   return fd;
 }
 
+bool send_fds(int afdt_fd, const int* fds, size_t count) {
+  assert(count > 0);
+
+  // SCM_RIGHTS requires at least one byte of regular data.
+  char token = 0;
+  iovec iov;
+  iov.iov_base = &token;
+  iov.iov_len = sizeof(token);
+
+  std::vector<char> control(CMSG_SPACE(count * sizeof(int)));
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = &control[0];
+  msg.msg_controllen = control.size();
+
+  auto cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(count * sizeof(int));
+  memcpy(CMSG_DATA(cmsg), fds, count * sizeof(int));
+
+  return sendmsg(afdt_fd, &msg, 0) == sizeof(token);
+}
+
+bool recv_fds(int afdt_fd, int* fds, size_t count) {
+  assert(count > 0);
+
+  char token = 0;
+  iovec iov;
+  iov.iov_base = &token;
+  iov.iov_len = sizeof(token);
+
+  std::vector<char> control(CMSG_SPACE(count * sizeof(int)));
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = &control[0];
+  msg.msg_controllen = control.size();
+
+  if (recvmsg(afdt_fd, &msg, MSG_WAITALL) != sizeof(token)) return false;
+
+  auto cmsg = CMSG_FIRSTHDR(&msg);
+  if (!cmsg ||
+      cmsg->cmsg_level != SOL_SOCKET ||
+      cmsg->cmsg_type != SCM_RIGHTS ||
+      cmsg->cmsg_len != CMSG_LEN(count * sizeof(int))) {
+    // Close anything the kernel did deliver so the descriptors don't leak.
+    if (cmsg &&
+        cmsg->cmsg_level == SOL_SOCKET &&
+        cmsg->cmsg_type == SCM_RIGHTS) {
+      auto const ndelivered =
+        (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+      if (ndelivered > 0) {
+        std::vector<int> delivered(ndelivered);
+        memcpy(&delivered[0], CMSG_DATA(cmsg), ndelivered * sizeof(int));
+        for (auto fd : delivered) close(fd);
+      }
+    }
+    return false;
+  }
+
+  memcpy(fds, CMSG_DATA(cmsg), count * sizeof(int));
+  return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 }}
@@ -236,6 +236,14 @@ int recvRaw(int afdt_fd, Head& h, Tail&... args) {
 bool send_fd(int afdt_fd, int fd);
 int recv_fd(int afdt_fd);
 
+/*
+ * Transfer several descriptors in a single SCM_RIGHTS message. The receiver
+ * must ask for exactly the count the sender transmitted. On failure recv_fds
+ * closes any descriptors it did receive and returns false.
+ */
+bool send_fds(int afdt_fd, const int* fds, size_t count);
+bool recv_fds(int afdt_fd, int* fds, size_t count);
+
 ///////////////////////////////////////////////////////////////////////////////
 }
 }
@@ -35,6 +35,7 @@
 #include "hphp/util/hugetlb.h"
 #include "hphp/util/kernel-version.h"
 #include "hphp/util/managed-arena.h"
+#include "hphp/util/maphuge.h"
 #include "hphp/util/numa.h"
 #include "hphp/util/slab-manager.h"
 
@@ -647,6 +648,43 @@ SlabManager* get_local_slab_manager(uint32_t node) {
   return s_slab_managers[node];
 }
 
+bool grow_local_slab_pool(uint32_t node, unsigned nSlabs, bool hugePages) {
+  if (node >= s_slab_managers.size()) return false;
+  auto const manager = s_slab_managers[node];
+  if (!manager || nSlabs == 0) return false;
+  if (hugePages) {
+    // A slab is exactly one 2M hugetlb page; grab pages one at a time until
+    // the kernel runs out, then fall through for the remainder.
+    static_assert(kSlabSize == size2m, "");
+    while (nSlabs > 0) {
+      auto const page = mmap_2m(node);
+      if (!page) break;
+      manager->addRange(page, kSlabSize);
+      --nSlabs;
+    }
+    if (nSlabs == 0) return true;
+  }
+  // Over-map so we can hand out slab-aligned memory, then trim the ends.
+  auto const size = nSlabs * kSlabSize;
+  auto const ret = mmap(nullptr, size + kSlabAlign, PROT_READ | PROT_WRITE,
+                        MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+  if (ret == MAP_FAILED) return false;
+  auto const base = reinterpret_cast<uintptr_t>(ret);
+  auto const aligned = (base + kSlabAlign - 1) & ~(kSlabAlign - 1);
+  if (aligned != base) {
+    munmap(reinterpret_cast<void*>(base), aligned - base);
+  }
+  auto const extra = base + kSlabAlign - aligned;
+  if (extra) {
+    munmap(reinterpret_cast<void*>(aligned + size), extra);
+  }
+  auto const addr = reinterpret_cast<void*>(aligned);
+  numa_bind_to(addr, size, node);
+  hintHuge(addr, size);
+  manager->addRange(addr, size);
+  return true;
+}
+
 void shutdown_slab_managers() {
   for (auto slab_manager : s_slab_managers) {
     if (slab_manager) slab_manager->shutdown();
@@ -119,6 +119,13 @@ struct PageSpec {
 void setup_local_arenas(PageSpec, unsigned slabs);
 unsigned get_local_arena(uint32_t node);
 SlabManager* get_local_slab_manager(uint32_t node);
+// Grow a node's slab pool with freshly mapped, node-bound memory, when the
+// range reserved at startup has been exhausted. With `hugePages`, slabs are
+// carved from 2M hugetlb pages while the kernel has them, then from normal
+// (THP-hinted) pages. Returns false if the node has no pool or the mapping
+// failed.
+bool grow_local_slab_pool(uint32_t node, unsigned nSlabs,
+                          bool hugePages = false);
 void shutdown_slab_managers();
 
 void setup_arena0(PageSpec);
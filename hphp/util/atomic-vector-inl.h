@@ -16,6 +16,7 @@
 
 #include <folly/Demangle.h>
 #include <folly/String.h>
+#include <folly/lang/Bits.h>
 
 namespace HPHP {
 
@@ -34,7 +35,7 @@ std::string type_name() {
 template<typename T, typename D>
 AtomicGrowableVector<T,D>::AtomicGrowableVector(size_t size, const D& def)
   : m_size(size)
-  , m_next(nullptr)
+  , m_segBase(std::max(size, size_t{1}))
   , m_default(def)
   , m_vals(new T[size])
 {
@@ -44,6 +45,9 @@ AtomicGrowableVector<T,D>::AtomicGrowableVector(size_t size, const D& def)
   for (size_t i = 0; i < size; ++i) {
     new (&m_vals[i]) T(def);
   }
+  for (auto& seg : m_segments) {
+    seg.store(nullptr, std::memory_order_relaxed);
+  }
 }
 
 template<typename T, typename D>
@@ -51,13 +55,34 @@ AtomicGrowableVector<T,D>::~AtomicGrowableVector() {
   FTRACE(1, "{} {} destructing\n",
          type_name<T>(), this);
 
-  delete m_next.load(std::memory_order_relaxed);
+  for (auto& seg : m_segments) {
+    delete[] seg.load(std::memory_order_relaxed);
+  }
+}
+
+template<typename T, typename D>
+size_t AtomicGrowableVector<T,D>::segCapacity(size_t seg) const {
+  return m_segBase << seg;
+}
+
+template<typename T, typename D>
+T* AtomicGrowableVector<T,D>::allocSegment(size_t cap) const {
+  auto const seg = new T[cap];
+  for (size_t i = 0; i < cap; ++i) {
+    new (&seg[i]) T(m_default);
+  }
+  return seg;
 }
 
 template<typename T, typename D>
 size_t AtomicGrowableVector<T,D>::size() const {
-  auto const next = this->next();
-  return m_size + (next ? next->size() : 0);
+  // Segments are always published in order, so the first null terminates.
+  auto size = m_size;
+  for (size_t s = 0; s < kMaxSegments; ++s) {
+    if (!m_segments[s].load(std::memory_order_acquire)) break;
+    size += segCapacity(s);
+  }
+  return size;
 }
 
 template<typename T, typename D>
@@ -67,50 +92,63 @@ void AtomicGrowableVector<T,D>::ensureSize(size_t size) {
 
   if (m_size >= size) return;
 
-  auto next = this->next();
-  if (!next) {
-    next = new AtomicGrowableVector(
-      std::max(m_size * 2, size_t{1}),
-      m_default
-    );
-    AtomicGrowableVector* expected = nullptr;
-    FTRACE(2, "attempting to use {}...", next);
-    if (!m_next.compare_exchange_strong(expected, next,
-                                        std::memory_order_acq_rel)) {
-      FTRACE(2, "lost race to {}\n", expected);
-      delete next;
-      next = expected;
-    } else {
-      FTRACE(2, "success\n");
+  // Publish segments in order until capacity covers `size'.  Losing a
+  // CAS means another thread published the same segment; its capacity
+  // still counts towards ours.
+  auto remaining = size - m_size;
+  for (size_t s = 0; remaining > 0; ++s) {
+    assertx(s < kMaxSegments);
+    auto const cap = segCapacity(s);
+    if (!m_segments[s].load(std::memory_order_acquire)) {
+      auto const seg = allocSegment(cap);
+      T* expected = nullptr;
+      FTRACE(2, "attempting to publish segment {} at {}...", s, seg);
+      if (!m_segments[s].compare_exchange_strong(expected, seg,
+                                                 std::memory_order_acq_rel)) {
+        FTRACE(2, "lost race to {}\n", expected);
+        delete[] seg;
+      } else {
+        FTRACE(2, "success\n");
+      }
     }
+    remaining = remaining > cap ? remaining - cap : 0;
   }
-  next->ensureSize(size - m_size);
+}
+
+template<typename T, typename D>
+T& AtomicGrowableVector<T,D>::elementAt(size_t i) const {
+  if (i < m_size) return m_vals[i];
+
+  // Segment s holds m_segBase << s elements, so m_segBase * (2^s - 1)
+  // elements precede it and the segment for `j' is found with findLastSet.
+  auto const j = i - m_size;
+  auto const s = folly::findLastSet(j / m_segBase + 1) - 1;
+  auto const seg = m_segments[s].load(std::memory_order_acquire);
+  assertx(seg != nullptr);
+  return seg[j - ((m_segBase << s) - m_segBase)];
 }
 
 template<typename T, typename D>
 T& AtomicGrowableVector<T,D>::operator[](size_t i) {
-  return i < m_size ? m_vals[i] : (*next())[i - m_size];
+  return elementAt(i);
 }
 
 template<typename T, typename D>
 const T& AtomicGrowableVector<T,D>::operator[](size_t i) const {
-  return i < m_size ? m_vals[i] : (*next())[i - m_size];
+  return elementAt(i);
 }
 
 template<typename T, typename D>
 template<typename F>
 void AtomicGrowableVector<T,D>::foreach(F fun) const {
-  auto const size = m_size;
-
-  for (auto i = 0; i < size; i++) fun(m_vals[i]);
+  for (size_t i = 0; i < m_size; i++) fun(m_vals[i]);
 
-  auto const next = this->next();
-  if (next) next->foreach(fun);
-}
-
-template<typename T, typename D>
-AtomicGrowableVector<T,D>* AtomicGrowableVector<T,D>::next() const {
-  return m_next.load(std::memory_order_acquire);
+  for (size_t s = 0; s < kMaxSegments; ++s) {
+    auto const seg = m_segments[s].load(std::memory_order_acquire);
+    if (!seg) break;
+    auto const cap = segCapacity(s);
+    for (size_t i = 0; i < cap; i++) fun(seg[i]);
+  }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -34,10 +34,11 @@ namespace HPHP {
  *
  * The only way to increase the size of an AtomicGrowableVector is with the
  * ensureSize() method.  It does not reallocate the internal storage to grow;
- * instead it allocates a new AtomicGrowableVector and chains to that for
- * increased capacity.  This means that if the initial size is too low, reading
- * and modifying elements at high indexes will be increasingly slower as the
- * chain of AtomicGrowableVectors is walked to find the right element.
+ * instead it appends geometrically-sized segments to a flat two-level index,
+ * so every access is a single atomic segment-pointer load plus some index
+ * arithmetic regardless of how often the vector has grown.  Segment s (for
+ * s >= 0) holds max(initial size, 1) << s elements, so index -> segment is a
+ * findLastSet away.
  *
  * An AtomicGrowableVector cannot shrink, and will only reclaim memory when
  * destructed.
@@ -76,13 +77,20 @@ struct AtomicGrowableVector {
   template <typename F> void foreach(F fun) const;
 
 protected:
-  const size_t m_size;
-  std::atomic<AtomicGrowableVector*> m_next;
+  // With a segment base of at least 1 and doubling capacities, 64 segments
+  // cover any address space we'll ever see.
+  static constexpr size_t kMaxSegments = 64;
+
+  const size_t m_size;     // capacity of the initial storage (m_vals)
+  const size_t m_segBase;  // capacity of segment 0: max(m_size, 1)
   const D m_default;
   std::unique_ptr<T[]> m_vals;
+  std::atomic<T*> m_segments[kMaxSegments];
 
 private:
-  AtomicGrowableVector<T,D>* next() const;
+  size_t segCapacity(size_t seg) const;
+  T* allocSegment(size_t cap) const;
+  T& elementAt(size_t i) const;
 
   TRACE_SET_MOD(atomicvector);
 };
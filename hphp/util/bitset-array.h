@@ -18,6 +18,10 @@
 
 #include <hphp/util/assertions.h>
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 namespace HPHP {
 
 struct BitsetArray;
@@ -32,14 +36,22 @@ struct BitsetRef {
   size_t size() const { return (e - s) * bits_per_word; }
 
   friend bool operator==(const BitsetRef& o1, const BitsetRef& o2) {
-    auto p1 = o1.s;
-    auto p2 = o2.s;
-    while (p1 != o1.e) {
-      if (*p1 != *p2) return false;
-      ++p1;
-      ++p2;
+    auto const n = o1.words();
+    assert(n == o2.words());
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= n; i += 4) {
+      auto const v1 = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(o1.s + i));
+      auto const v2 = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(o2.s + i));
+      auto const diff = _mm256_xor_si256(v1, v2);
+      if (!_mm256_testz_si256(diff, diff)) return false;
+    }
+#endif
+    for (; i < n; ++i) {
+      if (o1.s[i] != o2.s[i]) return false;
     }
-    assert(p2 == o2.e);
     return true;
   }
 
@@ -52,53 +64,39 @@ struct BitsetRef {
   friend BitsetWrapper operator-(const BitsetRef& o1, const BitsetRef& o2);
 
   BitsetRef& operator|=(const BitsetRef& o) {
-    perform(o,
-            [](uint64_t* dst, const uint64_t *src) {
-              *dst |= *src;
-            });
+    assert(words() == o.words());
+    bulk<BulkOp::Or>(s, s, o.s, words());
     return *this;
   }
   BitsetRef& operator&=(const BitsetRef& o) {
-    perform(o,
-            [](uint64_t* dst, const uint64_t *src) {
-              *dst &= *src;
-            });
+    assert(words() == o.words());
+    bulk<BulkOp::And>(s, s, o.s, words());
     return *this;
   }
   BitsetRef& operator-=(const BitsetRef& o) {
-    perform(o,
-            [](uint64_t* dst, const uint64_t *src) {
-              *dst &= ~*src;
-            });
+    assert(words() == o.words());
+    bulk<BulkOp::AndNot>(s, s, o.s, words());
     return *this;
   }
 
   void assign(const BitsetRef& o) {
-    perform(o,
-            [](uint64_t* dst, const uint64_t *src) {
-              *dst = *src;
-            });
+    assert(words() == o.words());
+    bulk<BulkOp::Copy>(s, o.s, o.s, words());
   }
 
   void assign_add(const BitsetRef& o1, const BitsetRef& o2) {
-    perform(o1, o2,
-            [](uint64_t* dst, const uint64_t *src1, const uint64_t *src2) {
-              *dst = *src1 | *src2;
-            });
+    assert(words() == o1.words() && words() == o2.words());
+    bulk<BulkOp::Or>(s, o1.s, o2.s, words());
   }
 
   void assign_sub(const BitsetRef& o1, const BitsetRef& o2) {
-    perform(o1, o2,
-            [](uint64_t* dst, const uint64_t *src1, const uint64_t *src2) {
-              *dst = *src1 & ~*src2;
-            });
+    assert(words() == o1.words() && words() == o2.words());
+    bulk<BulkOp::AndNot>(s, o1.s, o2.s, words());
   }
 
   void assign_and(const BitsetRef& o1, const BitsetRef& o2) {
-    perform(o1, o2,
-            [](uint64_t* dst, const uint64_t *src1, const uint64_t *src2) {
-              *dst = *src1 & *src2;
-            });
+    assert(words() == o1.words() && words() == o2.words());
+    bulk<BulkOp::And>(s, o1.s, o2.s, words());
   }
 
   BitsetRef next(int n = 1) const {
@@ -143,7 +141,16 @@ struct BitsetRef {
   }
 
   bool any() const {
-    for (auto p = s; p != e; ++p) if (*p) return true;
+    auto const n = words();
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= n; i += 4) {
+      auto const v = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(s + i));
+      if (!_mm256_testz_si256(v, v)) return true;
+    }
+#endif
+    for (; i < n; ++i) if (s[i]) return true;
     return false;
   }
 
@@ -155,31 +162,41 @@ private:
   BitsetRef(ElemType* s, ElemType* e) : s{s}, e{e} {}
   size_t words() const { return e - s; }
 
-  template <typename F>
-  void perform(const BitsetRef& o, F&& f) {
-    auto dst = s;
-    auto src = o.s;
-    while (dst != e) {
-      f(dst, src);
-      ++dst;
-      ++src;
+  enum class BulkOp { Or, And, AndNot, Copy };
+
+  // dst[i] = src1[i] op src2[i], four words at a time where we can. The
+  // in-place operators pass dst as src1; assign() passes the source twice.
+  template <BulkOp op>
+  static void bulk(ElemType* dst, const ElemType* src1,
+                   const ElemType* src2, size_t n) {
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= n; i += 4) {
+      auto const v1 = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(src1 + i));
+      auto const v2 = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(src2 + i));
+      auto const r = [&] {
+        if (op == BulkOp::Or) return _mm256_or_si256(v1, v2);
+        if (op == BulkOp::And) return _mm256_and_si256(v1, v2);
+        // andnot computes ~first & second
+        if (op == BulkOp::AndNot) return _mm256_andnot_si256(v2, v1);
+        return v1;
+      }();
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), r);
     }
-    assert(src == o.e);
-  }
-
-  template <typename F>
-  void perform(const BitsetRef& o1, const BitsetRef& o2, F&& f) {
-    auto dst = s;
-    auto src1 = o1.s;
-    auto src2 = o2.s;
-    while (dst != e) {
-      f(dst, src1, src2);
-      ++dst;
-      ++src1;
-      ++src2;
+#endif
+    for (; i < n; ++i) {
+      if (op == BulkOp::Or) {
+        dst[i] = src1[i] | src2[i];
+      } else if (op == BulkOp::And) {
+        dst[i] = src1[i] & src2[i];
+      } else if (op == BulkOp::AndNot) {
+        dst[i] = src1[i] & ~src2[i];
+      } else {
+        dst[i] = src1[i];
+      }
     }
-    assert(src1 == o1.e);
-    assert(src2 == o2.e);
   }
 
   ElemType *s;
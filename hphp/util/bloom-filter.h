@@ -18,6 +18,18 @@
 
 #include <boost/dynamic_bitset.hpp>
 
+#include <folly/lang/Bits.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "hphp/util/assertions.h"
 #include "hphp/util/hash.h"
 
 namespace HPHP {
@@ -42,6 +54,104 @@ template<size_t NBITS> struct BloomFilter {
   private:
   boost::dynamic_bitset<> bits_;
 };
+
+/*
+ * Cache-line-blocked bloom filter with word-parallel probes.
+ *
+ * Each key hashes to a single 32-byte block and sets one bit in each of the
+ * block's eight 32-bit lanes (the split-block design used by Impala and
+ * Parquet), so insert() and mayContain() touch exactly one cache line.  With
+ * AVX2 the probe is a handful of vector instructions; the scalar fallback is
+ * an eight-word loop.
+ *
+ * Concurrent inserts and probes are safe: lanes only ever gain bits, so
+ * mayContain() never reports a false negative for a key whose insert()
+ * completed before the probe began.  The filter cannot be resized or
+ * cleared; overfilling it only raises the false-positive rate.
+ */
+struct BlockedBloomFilter {
+  /*
+   * Size the filter for roughly `capacity' keys (8 keys per 32-byte block,
+   * rounded up to a power of two blocks).  Must be called once, before any
+   * insert; until then mayContain() conservatively answers true.
+   */
+  void init(size_t capacity) {
+    assertx(!m_blocks);
+    auto const nBlocks =
+      folly::nextPowTwo(std::max(capacity / 8, size_t{1}));
+    std::unique_ptr<Block[]> blocks{new Block[nBlocks]};
+    for (size_t b = 0; b < nBlocks; ++b) {
+      for (auto& lane : blocks[b].lanes) {
+        lane.store(0, std::memory_order_relaxed);
+      }
+    }
+    m_mask = nBlocks - 1;
+    m_blocks = std::move(blocks);
+  }
+
+  bool enabled() const { return m_blocks != nullptr; }
+
+  void insert(uint64_t h) {
+    if (!m_blocks) return;
+    auto& block = m_blocks[(h >> 32) & m_mask];
+    auto const lo = static_cast<uint32_t>(h);
+    for (size_t i = 0; i < kLanes; ++i) {
+      block.lanes[i].fetch_or(laneBit(lo, i), std::memory_order_relaxed);
+    }
+  }
+
+  /*
+   * A false return means the key was definitely never inserted.
+   */
+  bool mayContain(uint64_t h) const {
+    if (!m_blocks) return true;
+    auto const& block = m_blocks[(h >> 32) & m_mask];
+    auto const lo = static_cast<uint32_t>(h);
+#ifdef __AVX2__
+    auto const mult = _mm256_setr_epi32(
+      static_cast<int>(kOdd[0]), static_cast<int>(kOdd[1]),
+      static_cast<int>(kOdd[2]), static_cast<int>(kOdd[3]),
+      static_cast<int>(kOdd[4]), static_cast<int>(kOdd[5]),
+      static_cast<int>(kOdd[6]), static_cast<int>(kOdd[7])
+    );
+    auto const mask = _mm256_sllv_epi32(
+      _mm256_set1_epi32(1),
+      _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(lo), mult), 27)
+    );
+    auto const data =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&block));
+    return _mm256_testc_si256(data, mask);
+#else
+    for (size_t i = 0; i < kLanes; ++i) {
+      auto const lane = block.lanes[i].load(std::memory_order_relaxed);
+      if (!(lane & laneBit(lo, i))) return false;
+    }
+    return true;
+#endif
+  }
+
+private:
+  static constexpr size_t kLanes = 8;
+
+  struct alignas(32) Block {
+    std::atomic<uint32_t> lanes[kLanes];
+  };
+
+  // Odd multipliers for the per-lane multiply-shift hashes, from the
+  // split-block bloom filter literature.
+  static constexpr uint32_t kOdd[kLanes] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+  };
+
+  static uint32_t laneBit(uint32_t h, size_t lane) {
+    return uint32_t{1} << ((h * kOdd[lane]) >> 27);
+  }
+
+  std::unique_ptr<Block[]> m_blocks;
+  size_t m_mask{0};
+};
+
 }
 
 #endif // HPHP_BLOOM_FILTER_H
@@ -40,6 +40,7 @@
 namespace HPHP {
 
 bool g_useTHPUponHugeTLBFailure = false;
+bool g_lowArenaMergeable = false;
 
 namespace alloc {
 
@@ -172,6 +173,13 @@ bool BumpNormalMapper<D>::addMappingImpl() {
     mbind(newPages, size, MPOL_INTERLEAVE,
           &mask, 32 /* max node */, 0 /* flag */);
   }
+#endif
+#ifdef MADV_MERGEABLE
+  if (g_lowArenaMergeable && newPageStart < kLowArenaMaxAddr) {
+    // Let KSM deduplicate the metadata in the low ranges against the other
+    // server processes on the box; see g_lowArenaMergeable.
+    madvise(newPages, size, MADV_MERGEABLE);
+  }
 #endif
   if (D == Direction::LowToHigh) {
     m_state.low_map.store(newPageStart + size, std::memory_order_release);
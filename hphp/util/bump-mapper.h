@@ -28,6 +28,15 @@ namespace HPHP {
 
 extern bool g_useTHPUponHugeTLBFailure;
 
+// When set, normal pages mapped into the low ranges are marked
+// MADV_MERGEABLE. Static strings and persistent VM metadata live there and
+// are byte-identical across the server processes on a box (and across a
+// restart, while old and new processes overlap), so KSM can deduplicate the
+// backing pages and cut per-process RSS. Explicit huge pages are left alone:
+// KSM cannot merge hugetlb mappings, and splitting them would defeat their
+// purpose.
+extern bool g_lowArenaMergeable;
+
 namespace alloc {
 
 // Interface for all mappers. It also includes data about page limit (for huge
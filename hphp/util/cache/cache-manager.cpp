@@ -41,6 +41,10 @@ namespace HPHP {
 
 std::function<void(bool, const std::string&)> CacheManager::s_logger;
 
+// Large enough for the hot set of embedded assets without letting every
+// process grow an uncompressed copy of the whole cache.
+uint64_t CacheManager::s_decompressed_cache_capacity = 32 << 20;
+
 CacheManager::CacheManager() {}
 CacheManager::~CacheManager() {}
 
@@ -69,8 +73,46 @@ bool CacheManager::getDecompressed(const std::string& name,
     return false;
   }
 
+  {
+    std::lock_guard<std::mutex> guard(m_lru_lock);
+    const auto lru_it = m_lru_index.find(name);
+
+    if (lru_it != m_lru_index.end()) {
+      m_lru.splice(m_lru.begin(), m_lru, lru_it->second);
+      *data = lru_it->second->second;
+      return true;
+    }
+  }
+
+  // Decompress outside the lock; inflating can be slow and concurrent
+  // fetches of different entries shouldn't serialize on it.
   const CacheData& cd = *it->second;
-  return cd.getDecompressedData(data);
+  std::string temp;
+
+  if (!cd.getDecompressedData(&temp)) {
+    return false;
+  }
+
+  if (temp.length() <= s_decompressed_cache_capacity) {
+    std::lock_guard<std::mutex> guard(m_lru_lock);
+
+    // Some other thread may have raced us here; don't double-add.
+    if (!m_lru_index.count(name)) {
+      m_lru_bytes += temp.length();
+      m_lru.emplace_front(name, temp);
+      m_lru_index[name] = m_lru.begin();
+
+      while (m_lru_bytes > s_decompressed_cache_capacity) {
+        const auto& victim = m_lru.back();
+        m_lru_bytes -= victim.second.length();
+        m_lru_index.erase(victim.first);
+        m_lru.pop_back();
+      }
+    }
+  }
+
+  *data = std::move(temp);
+  return true;
 }
 
 bool CacheManager::isCompressed(const std::string& name) const {
@@ -29,8 +29,10 @@
 #pragma once
 
 #include <cstdint>
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <vector>
@@ -68,6 +70,9 @@ struct CacheManager {
   //
   // Only works for files which are compressed (returns false otherwise).
   //
+  // Hot entries are kept decompressed in a bounded LRU so repeated
+  // fetches don't inflate the same contents over and over.
+  //
   // Returns true on success and populates data.
   bool getDecompressed(const std::string& name, std::string* data) const;
 
@@ -123,6 +128,14 @@ struct CacheManager {
       std::function<void(bool, const std::string&)>&& logger) {
     s_logger = std::move(logger);
   }
+
+  // Bound (in decompressed bytes) on the LRU used by getDecompressed.
+  // Zero disables the LRU entirely.  Set this before serving traffic;
+  // shrinking it does not evict already-cached entries.
+  static void setDecompressedCacheCapacity(uint64_t bytes) {
+    s_decompressed_cache_capacity = bytes;
+  }
+
  private:
   using CacheMap = std::map<std::string, std::unique_ptr<CacheData>>;
 
@@ -136,7 +149,16 @@ struct CacheManager {
 
   CacheMap m_cache_map;
 
+  // LRU of decompressed contents, most recent first.  The index maps
+  // entry names to their position in the list.
+  using LruList = std::list<std::pair<std::string, std::string>>;
+  mutable std::mutex m_lru_lock;
+  mutable LruList m_lru;
+  mutable std::map<std::string, LruList::iterator> m_lru_index;
+  mutable uint64_t m_lru_bytes{ 0 };
+
   static std::function<void(bool, const std::string&)> s_logger;
+  static uint64_t s_decompressed_cache_capacity;
 };
 
 }  // namespace HPHP
@@ -19,11 +19,13 @@
 #include <sys/types.h>
 
 #include <cstdint>
+#include <map>
 #include <string>
 #include <vector>
 
 #include <folly/FileUtil.h>
 #include <folly/Format.h>
+#include <folly/Range.h>
 #include <folly/portability/SysStat.h>
 #include <folly/portability/Unistd.h>
 #include "hphp/util/cache/magic-numbers.h"
@@ -125,9 +127,23 @@ bool CacheSaver::endDirectory(uint64_t directory_end_magic) {
 bool CacheSaver::writeFiles() {
   CHECK(initialized_) << ": call CacheSaver::init";
 
+  // Identical contents are written only once; every dirent with the same
+  // contents shares a single data offset (content addressing).  Readers
+  // just follow the offsets, so deduplicated files need no special
+  // handling on load.
+  std::map<folly::StringPiece, uint64_t> content_offsets;
+
   for (auto& it : file_pointers_) {
     FilePointer& fp = it;
 
+    folly::StringPiece contents(fp.data_ptr, fp.data_len);
+    const auto prior = content_offsets.find(contents);
+
+    if (prior != content_offsets.end()) {
+      fp.data_ofs = prior->second;
+      continue;
+    }
+
     // Remember where this file data is going.
     fp.data_ofs = getOfs();
 
@@ -137,6 +153,8 @@ bool CacheSaver::writeFiles() {
       Logger::Error("Failed during write of file contents");
       return false;
     }
+
+    content_offsets.emplace(contents, fp.data_ofs);
   }
 
   return true;
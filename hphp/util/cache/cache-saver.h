@@ -45,7 +45,9 @@
 //
 // file-data: [char*]
 //            note: no terminating \0 - do not use C strxxx() functions!
-//            files occur in same order as dirents.
+//            files occur in same order as dirents, except that identical
+//            contents are stored once and shared: several dirents may
+//            carry the same data offset.
 //
 
 // --- Writing technique:
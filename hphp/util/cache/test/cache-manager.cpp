@@ -334,4 +334,112 @@ TEST_F(TestCacheManager, NoLeadingSlash) {
   EXPECT_TRUE(cm.entryExists("foo/bar/test.php"));
 }
 
+TEST_F(TestCacheManager, DedupedContents) {
+  CacheManager cm;
+
+  // Two entries with identical contents, one with different contents.
+
+  string test_data = "let's hope this won't compress too terribly well.";
+  string other_data = "some dissimilar contents for the third entry here";
+
+  string data_fn_1;
+  string data_fn_2;
+  string data_fn_3;
+  ASSERT_TRUE(makeTempFile(test_data, &data_fn_1));
+  ASSERT_TRUE(makeTempFile(test_data, &data_fn_2));
+  ASSERT_TRUE(makeTempFile(other_data, &data_fn_3));
+
+  string name_1 = "/test/copy_one";
+  string name_2 = "/test/copy_two";
+  string name_3 = "/test/different";
+
+  ASSERT_TRUE(cm.addFileContents(name_1, data_fn_1));
+  ASSERT_TRUE(cm.addFileContents(name_2, data_fn_2));
+  ASSERT_TRUE(cm.addFileContents(name_3, data_fn_3));
+
+  ASSERT_EQ(unlink(data_fn_1.c_str()), 0);
+  ASSERT_EQ(unlink(data_fn_2.c_str()), 0);
+  ASSERT_EQ(unlink(data_fn_3.c_str()), 0);
+
+  string temp_dir;
+  ASSERT_TRUE(makeTempDir(&temp_dir));
+
+  string save_path(temp_dir);
+  save_path.append("/cm.save");
+
+  ASSERT_TRUE(cm.saveCache(save_path));
+
+  CacheManager cm2;
+  ASSERT_TRUE(cm2.loadCache(save_path));
+
+  const char* data_1;
+  const char* data_2;
+  const char* data_3;
+  uint64_t data_len_1;
+  uint64_t data_len_2;
+  uint64_t data_len_3;
+  bool compressed_1;
+  bool compressed_2;
+  bool compressed_3;
+
+  ASSERT_TRUE(cm2.getFileContents(name_1, &data_1, &data_len_1,
+                                  &compressed_1));
+  ASSERT_TRUE(cm2.getFileContents(name_2, &data_2, &data_len_2,
+                                  &compressed_2));
+  ASSERT_TRUE(cm2.getFileContents(name_3, &data_3, &data_len_3,
+                                  &compressed_3));
+
+  // The identical entries share a single copy in the mmapped file.
+  EXPECT_EQ(data_1, data_2);
+  EXPECT_NE(data_1, data_3);
+
+  ASSERT_EQ(data_len_1, test_data.length());
+  ASSERT_EQ(memcmp(test_data.c_str(), data_1, data_len_1), 0);
+  ASSERT_EQ(data_len_3, other_data.length());
+  ASSERT_EQ(memcmp(other_data.c_str(), data_3, data_len_3), 0);
+
+  ASSERT_EQ(unlink(save_path.c_str()), 0);
+}
+
+TEST_F(TestCacheManager, DecompressedLru) {
+  CacheManager cm;
+
+  string test_data;
+  for (int i = 0; i < 1024; ++i) {
+    test_data.append("123456789012345678901234567890");
+  }
+
+  string data_fn;
+  ASSERT_TRUE(makeTempFile(test_data, &data_fn));
+
+  string name = "/test/name";
+  ASSERT_TRUE(cm.addFileContents(name, data_fn));
+  ASSERT_EQ(unlink(data_fn.c_str()), 0);
+
+  ASSERT_TRUE(cm.isCompressed(name));
+
+  // First fetch inflates and populates the LRU; second is served from it.
+  string first;
+  ASSERT_TRUE(cm.getDecompressed(name, &first));
+  ASSERT_EQ(test_data, first);
+
+  string second;
+  ASSERT_TRUE(cm.getDecompressed(name, &second));
+  ASSERT_EQ(test_data, second);
+
+  // With the LRU disabled the data still comes back correctly.
+  CacheManager::setDecompressedCacheCapacity(0);
+  CacheManager cm2;
+
+  ASSERT_TRUE(makeTempFile(test_data, &data_fn));
+  ASSERT_TRUE(cm2.addFileContents(name, data_fn));
+  ASSERT_EQ(unlink(data_fn.c_str()), 0);
+
+  string third;
+  ASSERT_TRUE(cm2.getDecompressed(name, &third));
+  ASSERT_EQ(test_data, third);
+
+  CacheManager::setDecompressedCacheCapacity(32 << 20);
+}
+
 }  // namespace HPHP
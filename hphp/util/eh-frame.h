@@ -127,6 +127,17 @@ struct EHFrameWriter {
    */
   EHFrameDesc register_and_release();
 
+  /*
+   * Release the buffer without registering any FDEs.
+   *
+   * For consumers that want the raw .eh_frame image (e.g., to embed it in a
+   * perf jitdump) rather than to install it with the in-process unwinder.
+   */
+  std::unique_ptr<std::vector<uint8_t>> release_raw() {
+    assertx(m_fde == kInvalidIdx);
+    return std::move(m_buf);
+  }
+
   /////////////////////////////////////////////////////////////////////////////
 
   /*
@@ -182,6 +182,38 @@ bool is_compressible_file(const char *filename) {
 ///////////////////////////////////////////////////////////////////////////////
 // GzipCompressor
 
+GzipCompressor::RawContextPool GzipCompressor::s_rawCtxPool{};
+GzipCompressor::ZlibContextPool GzipCompressor::s_zlibCtxPool{};
+
+z_stream* GzipCompressor::allocate_stream(int windowBits, int memLevel) {
+  auto const ctx = static_cast<z_stream*>(calloc(1, sizeof(z_stream)));
+  if (!ctx) return nullptr;
+  ctx->zalloc = Z_NULL;
+  ctx->zfree = Z_NULL;
+  ctx->opaque = Z_NULL;
+  if (deflateInit2(ctx, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits,
+                   memLevel, Z_DEFAULT_STRATEGY) != Z_OK) {
+    free(ctx);
+    return nullptr;
+  }
+  return ctx;
+}
+
+z_stream* GzipCompressor::create_raw_ctx() {
+  /* windowBits is passed < 0 to suppress zlib header & trailer; the gzip
+     framing is written by compress() itself */
+  return allocate_stream(-MAX_WBITS, MAX_MEM_LEVEL);
+}
+
+z_stream* GzipCompressor::create_zlib_ctx() {
+  return allocate_stream(MAX_WBITS, 8 /* deflateInit()'s DEF_MEM_LEVEL */);
+}
+
+void GzipCompressor::deflate_ctx_deleter(z_stream* ctx) {
+  deflateEnd(ctx);
+  free(ctx);
+}
+
 GzipCompressor::GzipCompressor(int level, int encoding_mode, bool header)
   : m_encoding(encoding_mode), m_header(header),
     m_ended(false) {
@@ -192,33 +224,52 @@ GzipCompressor::GzipCompressor(int level, int encoding_mode, bool header)
     throw Exception("encoding mode must be FORCE_GZIP or FORCE_DEFLATE");
   }
 
-  if (s_useLocalArena) {
-    m_stream.zalloc = local_zalloc;
-    m_stream.zfree = local_zfree;
-  } else {
-    m_stream.zalloc = Z_NULL;
-    m_stream.zfree = Z_NULL;
+  m_crc = crc32(0L, Z_NULL, 0);
+
+  if (!s_useLocalArena) {
+    // Take a pre-initialized context from the shared pool: deflateReset()
+    // keeps the window and state allocations that deflateInit2() would
+    // otherwise redo for every response, and deflateParams() applies this
+    // response's level to the recycled context.
+    if (encoding_mode == CODING_GZIP) {
+      m_pooledRaw = s_rawCtxPool.get();
+      m_stream = m_pooledRaw.get();
+    } else {
+      m_pooledZlib = s_zlibCtxPool.get();
+      m_stream = m_pooledZlib.get();
+    }
+    int status;
+    if ((status = deflateReset(m_stream)) != Z_OK ||
+        (status = deflateParams(m_stream, level,
+                                Z_DEFAULT_STRATEGY)) != Z_OK) {
+      throw Exception("%s", zError(status));
+    }
+    return;
   }
-  m_stream.opaque = Z_NULL;
-  m_stream.total_in = 0;
-  m_stream.next_in = Z_NULL;
-  m_stream.avail_in = 0;
-  m_stream.avail_out = 0;
-  m_stream.next_out = Z_NULL;
 
-  m_crc = crc32(0L, Z_NULL, 0);
+  // Request-arena state can't outlive the request, so local-arena contexts
+  // stay per-compressor.
+  m_stream = &m_localStream;
+  m_stream->zalloc = local_zalloc;
+  m_stream->zfree = local_zfree;
+  m_stream->opaque = Z_NULL;
+  m_stream->total_in = 0;
+  m_stream->next_in = Z_NULL;
+  m_stream->avail_in = 0;
+  m_stream->avail_out = 0;
+  m_stream->next_out = Z_NULL;
 
   int status;
   switch (encoding_mode) {
   case CODING_GZIP:
     /* windowBits is passed < 0 to suppress zlib header & trailer */
-    if ((status = deflateInit2(&m_stream, level, Z_DEFLATED, -MAX_WBITS,
+    if ((status = deflateInit2(m_stream, level, Z_DEFLATED, -MAX_WBITS,
                                MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY)) != Z_OK) {
       throw Exception("%s", zError(status));
     }
     break;
   case CODING_DEFLATE:
-    if ((status = deflateInit(&m_stream, level)) != Z_OK) {
+    if ((status = deflateInit(m_stream, level)) != Z_OK) {
       throw Exception("%s", zError(status));
     }
     break;
@@ -226,8 +277,11 @@ GzipCompressor::GzipCompressor(int level, int encoding_mode, bool header)
 }
 
 GzipCompressor::~GzipCompressor() {
-  if (!m_ended) {
-    deflateEnd(&m_stream);
+  // Pooled contexts go back to their pool through the Ref deleters and get
+  // deflateReset() by the next user; only local-arena streams are torn down
+  // here.
+  if (m_stream == &m_localStream && !m_ended) {
+    deflateEnd(m_stream);
   }
 }
 
@@ -236,14 +290,14 @@ GzipCompressor::compress(const char *data, int &len, bool trailer) {
   // middle chunks should never be zero size
   assert(len || trailer);
 
-  m_stream.next_in = (Bytef *)data;
-  m_stream.avail_in = len;
-  m_stream.total_out = 0;
+  m_stream->next_in = (Bytef *)data;
+  m_stream->avail_in = len;
+  m_stream->total_out = 0;
 
-  m_stream.avail_out = m_stream.avail_in +
-    (m_stream.avail_in / PHP_ZLIB_MODIFIER) + 15 + 1; /* room for \0 */
+  m_stream->avail_out = m_stream->avail_in +
+    (m_stream->avail_in / PHP_ZLIB_MODIFIER) + 15 + 1; /* room for \0 */
   char *s2;
-  auto const allocSize = m_stream.avail_out + GZIP_HEADER_LENGTH +
+  auto const allocSize = m_stream->avail_out + GZIP_HEADER_LENGTH +
     ((trailer && m_encoding == CODING_GZIP) ? GZIP_FOOTER_LENGTH : 0);
   if (s_useLocalArena) {
     s2 = (char *)local_malloc(allocSize);
@@ -259,22 +313,29 @@ GzipCompressor::compress(const char *data, int &len, bool trailer) {
     s2[2] = Z_DEFLATED;
     s2[3] = s2[4] = s2[5] = s2[6] = s2[7] = s2[8] = 0; /* time set to 0 */
     s2[9] = 0x03; // OS_CODE
-    m_stream.next_out = (Bytef*)&(s2[GZIP_HEADER_LENGTH]);
+    m_stream->next_out = (Bytef*)&(s2[GZIP_HEADER_LENGTH]);
     m_header = false; // only the 1st chunnk got it
   } else {
-    m_stream.next_out = (Bytef*)s2;
+    m_stream->next_out = (Bytef*)s2;
   }
 
-  int status = deflate(&m_stream, trailer ? Z_FINISH : Z_SYNC_FLUSH);
+  int status = deflate(m_stream, trailer ? Z_FINISH : Z_SYNC_FLUSH);
   if (status == Z_BUF_ERROR || status == Z_STREAM_END) {
-    status = deflateEnd(&m_stream);
+    if (m_stream == &m_localStream) {
+      status = deflateEnd(m_stream);
+    } else {
+      // Don't tear pooled contexts down mid-stream; the next user's
+      // deflateReset() reclaims any leftover state. Mirror deflateEnd()'s
+      // result so callers see the same success/error as before.
+      status = status == Z_STREAM_END ? Z_OK : Z_DATA_ERROR;
+    }
     m_ended = true;
   }
   if (status == Z_OK) {
     if (len) {
       m_crc = crc32(m_crc, (const Bytef *)data, len);
     }
-    int new_len = m_stream.total_out + (header ? GZIP_HEADER_LENGTH : 0);
+    int new_len = m_stream->total_out + (header ? GZIP_HEADER_LENGTH : 0);
     len = new_len;
     if (trailer && m_encoding == CODING_GZIP) {
       len += GZIP_FOOTER_LENGTH;
@@ -285,10 +346,10 @@ GzipCompressor::compress(const char *data, int &len, bool trailer) {
       strailer[1] = (char) (m_crc >> 8) & 0xFF;
       strailer[2] = (char) (m_crc >> 16) & 0xFF;
       strailer[3] = (char) (m_crc >> 24) & 0xFF;
-      strailer[4] = (char) m_stream.total_in & 0xFF;
-      strailer[5] = (char) (m_stream.total_in >> 8) & 0xFF;
-      strailer[6] = (char) (m_stream.total_in >> 16) & 0xFF;
-      strailer[7] = (char) (m_stream.total_in >> 24) & 0xFF;
+      strailer[4] = (char) m_stream->total_in & 0xFF;
+      strailer[5] = (char) (m_stream->total_in >> 8) & 0xFF;
+      strailer[6] = (char) (m_stream->total_in >> 16) & 0xFF;
+      strailer[7] = (char) (m_stream->total_in >> 24) & 0xFF;
       strailer[8] = '\0';
     } else {
       s2[len] = '\0';
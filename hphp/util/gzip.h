@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "hphp/util/compression-ctx-pool.h"
 #include "hphp/util/string-holder.h"
 #include <zlib.h>
 
@@ -49,9 +50,30 @@ struct GzipCompressor {
   static bool s_useLocalArena;
 
  private:
+  static z_stream* allocate_stream(int windowBits, int memLevel);
+  static z_stream* create_raw_ctx();
+  static z_stream* create_zlib_ctx();
+  static void deflate_ctx_deleter(z_stream* ctx);
+
+  // Pools of deflateInit2()-ed contexts, reused across responses via
+  // deflateReset(); the window and state allocations survive pool round
+  // trips. One pool per framing since windowBits is fixed at init time.
+  using RawContextPool =
+      CompressionContextPool<z_stream, create_raw_ctx, deflate_ctx_deleter>;
+  using ZlibContextPool =
+      CompressionContextPool<z_stream, create_zlib_ctx, deflate_ctx_deleter>;
+  static RawContextPool s_rawCtxPool;
+  static ZlibContextPool s_zlibCtxPool;
+
   int m_encoding;
   bool m_header;
-  z_stream m_stream;
+  // Exactly one of the pooled refs is engaged, unless s_useLocalArena put
+  // the deflate state in the request arena, in which case m_localStream is
+  // used; m_stream points at whichever is active.
+  RawContextPool::Ref m_pooledRaw;
+  ZlibContextPool::Ref m_pooledZlib;
+  z_stream m_localStream;
+  z_stream* m_stream;
   uLong m_crc;
   bool m_ended;
 };
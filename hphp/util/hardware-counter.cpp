@@ -38,6 +38,11 @@
 #include <sys/prctl.h>
 #include <linux/perf_event.h>
 
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
 #include <folly/String.h>
 #include <folly/Memory.h>
 #include <folly/portability/SysMman.h>
@@ -710,6 +715,71 @@ void HardwareCounter::getPerfEvents(PerfEventCallback f, void* data) {
   });
 }
 
+/*
+ * Process-wide per-endpoint counter aggregates. Written once per request
+ * (from the request thread, which owns the counters being read), read and
+ * cleared from the admin server, so a plain mutex around ordered maps is
+ * plenty; ordered maps also keep the export stable. The endpoint set is
+ * capped so a URL-space explosion can't grow the table without bound —
+ * late-arriving endpoints fold into a catch-all bucket.
+ */
+namespace {
+
+struct EndpointEventTotals {
+  int64_t sum{0};
+  int64_t samples{0};
+};
+
+constexpr size_t kMaxTrackedEndpoints = 1000;
+
+std::mutex s_endpointMutex;
+std::map<std::string, std::map<std::string, EndpointEventTotals>>
+  s_endpointEvents;
+
+}
+
+void HardwareCounter::recordEndpointEvents(const std::string& endpoint) {
+  if (!useCounters()) return;
+  // Read the counters outside the lock; reads may touch the perf fds.
+  std::vector<std::pair<std::string, int64_t>> values;
+  forEachCounter([&values](HardwareCounterImpl& counter) {
+    values.emplace_back(counter.m_desc, counter.read());
+  });
+
+  std::lock_guard<std::mutex> guard(s_endpointMutex);
+  auto key = &endpoint;
+  if (s_endpointEvents.size() >= kMaxTrackedEndpoints &&
+      !s_endpointEvents.count(endpoint)) {
+    static const std::string s_other{"(other)"};
+    key = &s_other;
+  }
+  auto& byEvent = s_endpointEvents[*key];
+  for (auto const& value : values) {
+    auto& totals = byEvent[value.first];
+    totals.sum += value.second;
+    totals.samples++;
+  }
+}
+
+void HardwareCounter::RecordEndpointEvents(const std::string& endpoint) {
+  s_counter->recordEndpointEvents(endpoint);
+}
+
+void HardwareCounter::GetEndpointEvents(EndpointEventCallback f, void* data) {
+  std::lock_guard<std::mutex> guard(s_endpointMutex);
+  for (auto const& endpoint : s_endpointEvents) {
+    for (auto const& event : endpoint.second) {
+      f(endpoint.first, event.first,
+        event.second.sum, event.second.samples, data);
+    }
+  }
+}
+
+void HardwareCounter::ClearEndpointEvents() {
+  std::lock_guard<std::mutex> guard(s_endpointMutex);
+  s_endpointEvents.clear();
+}
+
 template<typename F>
 void HardwareCounter::forEachCounter(F func) {
   func(*m_instructionCounter);
@@ -54,6 +54,21 @@ struct HardwareCounter {
   typedef void (*PerfEventCallback)(const std::string&, int64_t, void*);
   static void GetPerfEvents(PerfEventCallback f, void* data);
   static void ClearPerfEvents();
+  /*
+   * Per-endpoint aggregation of the thread's counters. Call at the end of a
+   * request (before Reset) to fold the current counter values into a
+   * process-wide table keyed by endpoint. Events beyond the number of
+   * hardware slots are time-multiplexed by the kernel and scaled on read, so
+   * a group like cycles,cache-misses,branch-misses,dTLB-load-misses can be
+   * attributed per endpoint without dedicating a PMU slot to each.
+   */
+  static void RecordEndpointEvents(const std::string& endpoint);
+  typedef void (*EndpointEventCallback)(const std::string& endpoint,
+                                        const std::string& event,
+                                        int64_t sum, int64_t samples,
+                                        void* data);
+  static void GetEndpointEvents(EndpointEventCallback f, void* data);
+  static void ClearEndpointEvents();
   static void UpdateServiceData(const timespec& cpu_begin,
                                 const timespec& wall_begin,
                                 StructuredLogEntry* entry,
@@ -77,6 +92,7 @@ private:
   bool addPerfEvent(const char* event);
   bool setPerfEvents(folly::StringPiece events);
   void getPerfEvents(PerfEventCallback f, void* data);
+  void recordEndpointEvents(const std::string& endpoint);
   template<typename F>
   void forEachCounter(F func);
   void clearPerfEvents();
@@ -112,6 +128,13 @@ struct HardwareCounter {
   typedef void (*PerfEventCallback)(const std::string&, int64_t, void*);
   static void GetPerfEvents(PerfEventCallback f, void* data) { }
   static void ClearPerfEvents() { }
+  static void RecordEndpointEvents(const std::string& endpoint) { }
+  typedef void (*EndpointEventCallback)(const std::string& endpoint,
+                                        const std::string& event,
+                                        int64_t sum, int64_t samples,
+                                        void* data);
+  static void GetEndpointEvents(EndpointEventCallback f, void* data) { }
+  static void ClearEndpointEvents() { }
   static void UpdateServiceData(const timespec& cpu_begin,
                                 const timespec& wall_begin,
                                 StructuredLogEntry* entry,
@@ -88,6 +88,24 @@ namespace HPHP {
  * newest requests.
  *
  * You can configure a LIFO ordered queue by setting lifoSwitchThreshold to 0.
+ *
+ * Concurrency budgets
+ * ===================
+ * setMaxActiveForPriority() caps how many jobs of a given priority may
+ * execute at once. Workers skip over queues whose budget is exhausted, so a
+ * flood of slow low-priority jobs cannot occupy the whole pool: the workers
+ * the budget holds back stay available for higher-priority tiers. Scheduling
+ * stays work-conserving for the unbudgeted tiers, which may spill over into
+ * the entire pool. Budgets require workers that count active jobs.
+ *
+ * Priority aging
+ * ==============
+ * With multiple priorities, workers always service the highest-priority
+ * non-empty queue first, so a steady stream of high-priority work can starve
+ * the lower queues indefinitely. Setting 'queueAgingMs' bounds the starvation:
+ * once the oldest job in any queue has waited longer than the threshold,
+ * workers service aged jobs ahead of fresher higher-priority work, oldest job
+ * first, regardless of any LIFO switch. Aging is off by default.
  */
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -113,16 +131,20 @@ public:
   JobQueue(int maxQueueCount, int dropCacheTimeout,
            bool dropStack, int lifoSwitchThreshold = INT_MAX,
            int maxJobQueuingMs = -1, int numPriorities = 1,
-           bool legacyBehavior = true)
+           bool legacyBehavior = true, int queueAgingMs = -1)
       : SynchronizableMulti(maxQueueCount + 1) // reaper added
       , m_dropCacheTimeout(dropCacheTimeout)
       , m_dropStack(dropStack)
       , m_lifoSwitchThreshold(lifoSwitchThreshold)
       , m_maxJobQueuingMs(maxJobQueuingMs)
+      , m_queueAgingMs(queueAgingMs)
       , m_jobReaperId(maxQueueCount)
       , m_legacyBehavior(legacyBehavior) {
     assertx(maxQueueCount > 0);
     m_jobQueues.resize(numPriorities);
+    m_activePerPrio.resize(numPriorities, 0);
+    m_maxActivePerPrio.resize(numPriorities, INT_MAX);
+    m_activePrioOfWorker.resize(maxQueueCount + 1, -1);
   }
 
   /**
@@ -177,13 +199,41 @@ public:
   void waitEmpty() {}
   void signalEmpty() {}
 
+  /**
+   * Cap the number of priority-'priority' jobs that may execute
+   * concurrently. Pass a non-positive value to remove the cap. Only
+   * effective with workers that count active jobs.
+   */
+  void setMaxActiveForPriority(int priority, int maxActive) {
+    Lock lock(this);
+    assertx(priority >= 0 && priority < (int)m_jobQueues.size());
+    m_maxActivePerPrio[priority] = maxActive > 0 ? maxActive : INT_MAX;
+    bool hasBudgets = false;
+    for (auto const max : m_maxActivePerPrio) {
+      if (max != INT_MAX) hasBudgets = true;
+    }
+    m_hasPrioBudgets.store(hasBudgets, std::memory_order_release);
+  }
+
   /**
    * Keeps track of how many active workers are working on the queue.
    */
   void incActiveWorker() {
     ++m_workerCount;
   }
-  int decActiveWorker() {
+  int decActiveWorker(int id) {
+    if (m_hasPrioBudgets.load(std::memory_order_acquire)) {
+      Lock lock(this);
+      auto const prio = m_activePrioOfWorker[id];
+      if (prio >= 0) {
+        m_activePrioOfWorker[id] = -1;
+        if (--m_activePerPrio[prio] < m_maxActivePerPrio[prio] &&
+            m_jobCount > 0) {
+          // A budget slot freed up; some queued job may be eligible now.
+          notify();
+        }
+      }
+    }
     return --m_workerCount;
   }
   int getActiveWorker() {
@@ -226,6 +276,7 @@ public:
 
  private:
   friend class JobQueue_Expiration_Test;
+  friend class JobQueue_PriorityAging_Test;
   TJob dequeueMaybeExpiredImpl(int id, int q, bool inc, const timespec& now,
                                bool* expired, bool highPri = false,
                                bool* workerStop = nullptr) {
@@ -235,9 +286,10 @@ public:
 
     bool ableToDequeue = getActiveWorker() <
                          m_maxActiveWorkers.load(std::memory_order_acquire);
-    while (m_jobCount == 0 || !ableToDequeue) {
+    while (m_jobCount == 0 || !ableToDequeue || !hasEligibleJob()) {
       uint32_t kNumPriority = m_jobQueues.size();
-      if (m_jobQueues[kNumPriority - 1].size() > 0) {
+      if (m_jobQueues[kNumPriority - 1].size() > 0 &&
+          withinBudget(kNumPriority - 1)) {
         break;
       }
 
@@ -285,9 +337,42 @@ public:
     if (inc) incActiveWorker();
     --m_jobCount;
 
+    // Priority aging: once the oldest job of some queue has waited longer
+    // than m_queueAgingMs, service aged jobs oldest-first ahead of fresher
+    // higher-priority work, so that a steady stream of high-priority jobs
+    // cannot starve the lower queues.
+    if (m_queueAgingMs > 0) {
+      int agedPrio = -1;
+      int64_t maxWaitUs = int64_t{m_queueAgingMs} * 1000;
+      for (int p = (int)m_jobQueues.size() - 1; p >= 0; --p) {
+        auto& jobs = m_jobQueues[p];
+        if (jobs.empty() || !withinBudget(p)) {
+          continue;
+        }
+        auto const waitUs = gettime_diff_us(jobs.front().second, now);
+        if (waitUs > maxWaitUs) {
+          agedPrio = p;
+          maxWaitUs = waitUs;
+        }
+      }
+      if (agedPrio >= 0) {
+        auto& aged = m_jobQueues[agedPrio];
+        if (m_maxJobQueuingMs > 0 &&
+            gettime_diff_us(aged.front().second, now) >
+            m_maxJobQueuingMs * 1000) {
+          *expired = true;
+        }
+        TJob job = aged.front().first;
+        aged.pop_front();
+        takeJob(id, agedPrio, inc);
+        return job;
+      }
+    }
+
     // look across all our queues from highest priority to lowest.
-    for (auto& jobs : boost::adaptors::reverse(m_jobQueues)) {
-      if (jobs.empty()) {
+    for (int p = (int)m_jobQueues.size() - 1; p >= 0; --p) {
+      auto& jobs = m_jobQueues[p];
+      if (jobs.empty() || !withinBudget(p)) {
         continue;
       }
 
@@ -299,21 +384,51 @@ public:
         *expired = true;
         TJob job = jobs.front().first;
         jobs.pop_front();
+        takeJob(id, p, inc);
         return job;
       }
 
       if (m_jobCount >= m_lifoSwitchThreshold) {
         TJob job = jobs.back().first;
         jobs.pop_back();
+        takeJob(id, p, inc);
         return job;
       }
       TJob job = jobs.front().first;
       jobs.pop_front();
+      takeJob(id, p, inc);
       return job;
     }
     not_reached();
   }
 
+  // The following helpers assume the lock is held.
+  bool withinBudget(int priority) const {
+    return !m_hasPrioBudgets.load(std::memory_order_acquire) ||
+           m_activePerPrio[priority] < m_maxActivePerPrio[priority];
+  }
+
+  bool hasEligibleJob() const {
+    if (!m_hasPrioBudgets.load(std::memory_order_acquire)) {
+      return m_jobCount > 0;
+    }
+    for (int p = (int)m_jobQueues.size() - 1; p >= 0; --p) {
+      if (!m_jobQueues[p].empty() && withinBudget(p)) return true;
+    }
+    return false;
+  }
+
+  // Charge the dequeued job against its priority's budget; the worker
+  // releases the slot in decActiveWorker(). Workers that don't count
+  // active jobs never call decActiveWorker(), so don't charge for them.
+  void takeJob(int id, int priority, bool inc) {
+    if (inc && m_hasPrioBudgets.load(std::memory_order_acquire)) {
+      assertx(m_activePrioOfWorker[id] == -1);
+      m_activePrioOfWorker[id] = priority;
+      ++m_activePerPrio[priority];
+    }
+  }
+
   /*
    * One worker can be designated as the job reaper. The id of the job reaper
    * equals maxQueueCount of the dispatcher. The job reaper checks if the
@@ -365,11 +480,17 @@ public:
   folly::small_vector<std::deque<std::pair<TJob, timespec>>, 2> m_jobQueues;
   bool m_stopped{false};
   std::atomic<int> m_workerCount{0};
+  // Concurrency budgets, all guarded by the queue lock except the flag.
+  folly::small_vector<int, 2> m_activePerPrio;
+  folly::small_vector<int, 2> m_maxActivePerPrio;
+  folly::small_vector<int8_t, 8> m_activePrioOfWorker;
+  std::atomic<bool> m_hasPrioBudgets{false};
   std::atomic<int> m_maxActiveWorkers{INT_MAX};
   const int m_dropCacheTimeout;
   const bool m_dropStack;
   const int m_lifoSwitchThreshold;
   const int m_maxJobQueuingMs;
+  const int m_queueAgingMs;
   const int m_jobReaperId;              // equals max worker thread count
   const bool m_legacyBehavior;
 };
@@ -379,14 +500,15 @@ struct JobQueue<TJob,true,Policy> : JobQueue<TJob,false,Policy> {
   JobQueue(int threadCount, int dropCacheTimeout,
            bool dropStack, int lifoSwitchThreshold=INT_MAX,
            int maxJobQueuingMs = -1, int numPriorities = 1,
-           bool legacyBehavior = true) :
+           bool legacyBehavior = true, int queueAgingMs = -1) :
     JobQueue<TJob,false,Policy>(threadCount,
                                 dropCacheTimeout,
                                 dropStack,
                                 lifoSwitchThreshold,
                                 maxJobQueuingMs,
                                 numPriorities,
-                                legacyBehavior) {
+                                legacyBehavior,
+                                queueAgingMs) {
     pthread_cond_init(&m_cond, nullptr);
   }
   ~JobQueue() override {
@@ -473,7 +595,7 @@ struct JobQueueWorker {
           doJob(job);
         }
         if (countActive) {
-          if (!m_queue->decActiveWorker() && waitable) {
+          if (!m_queue->decActiveWorker(m_id) && waitable) {
             Lock lock(m_queue);
             if (!m_queue->getActiveWorker() &&
                 !m_queue->getQueuedJobs()) {
@@ -529,7 +651,8 @@ struct JobQueueDispatcher : IHostHealthObserver {
                      int initThreadCount = -1,
                      unsigned hugeStackKb = 0,
                      unsigned extraKb = 0,
-                     bool legacyBehavior = true)
+                     bool legacyBehavior = true,
+                     int queueAgingMs = -1)
       : m_startReaperThread(maxJobQueuingMs > 0)
       , m_context(context)
       , m_maxThreadCount(maxThreadCount)
@@ -541,7 +664,7 @@ struct JobQueueDispatcher : IHostHealthObserver {
       , m_legacyBehavior(legacyBehavior)
       , m_queue(m_maxQueueCount, dropCacheTimeout, dropStack,
                 lifoSwitchThreshold, maxJobQueuingMs, numPriorities,
-                legacyBehavior) {
+                legacyBehavior, queueAgingMs) {
     assertx(maxThreadCount >= 1);
     assertx(m_maxQueueCount >= maxThreadCount);
     if (maxQueueCountConfig < maxThreadCount) {
@@ -766,6 +889,10 @@ struct JobQueueDispatcher : IHostHealthObserver {
     m_queue.updateMaxActiveWorkers(num);
   }
 
+  void setMaxActiveForPriority(int priority, int maxActive) {
+    m_queue.setMaxActiveForPriority(priority, maxActive);
+  }
+
   /*
    * Change the maximum thread count.
    *
@@ -0,0 +1,64 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010-present Facebook, Inc. (http://www.facebook.com)  |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include "hphp/util/lock-contention.h"
+
+#include "hphp/util/service-data.h"
+
+#include <folly/Format.h>
+
+#include <mutex>
+#include <unordered_map>
+
+namespace HPHP {
+namespace LockContention {
+
+namespace detail {
+std::atomic<uint32_t> g_sampleRate{0};
+std::atomic<uint64_t> g_counter{0};
+}
+
+void setSampleRate(uint32_t rate) {
+  detail::g_sampleRate.store(rate, std::memory_order_relaxed);
+}
+
+void record(const char* name, int64_t waitUs) {
+  // Records are rare by construction (contended and sampled), so a single
+  // lock around the name -> histogram cache is fine.
+  static std::mutex s_lock;
+  static std::unordered_map<const char*, ServiceData::ExportedHistogram*>
+    s_histograms;
+
+  ServiceData::ExportedHistogram* histogram;
+  {
+    std::lock_guard<std::mutex> guard(s_lock);
+    auto& cached = s_histograms[name];
+    if (!cached) {
+      // 100us buckets up to 100ms; waits beyond that saturate the top
+      // bucket, which is already pager territory.
+      cached = ServiceData::createHistogram(
+        folly::sformat("lock.wait_us.{}", name),
+        100, 0, 100000,
+        {0.5, 0.9, 0.99}
+      );
+    }
+    histogram = cached;
+  }
+  histogram->addValue(waitUs);
+}
+
+}
+}
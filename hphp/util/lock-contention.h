@@ -0,0 +1,71 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010-present Facebook, Inc. (http://www.facebook.com)  |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#pragma once
+
+#include "hphp/util/portability.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace HPHP {
+
+/*
+ * Sampled wait-time recording for contended lock acquisitions.
+ *
+ * The lock wrappers in mutex.h first try a non-blocking acquire; only when
+ * that fails (i.e. the lock is actually contended) do they consult this
+ * facility, so an uncontended lock costs one trylock and nothing else.  On
+ * a contended acquire that passes the 1/N sample check, the wait is timed
+ * and fed into a per-lock-name ServiceData histogram
+ * (lock.wait_us.<name>), so contention shows up on dashboards rather than
+ * in incident retrospectives.
+ *
+ * Locks are identified by a static name; wrappers without a name record
+ * under "unnamed".
+ */
+namespace LockContention {
+
+namespace detail {
+extern std::atomic<uint32_t> g_sampleRate;
+extern std::atomic<uint64_t> g_counter;
+}
+
+/*
+ * Sample 1/`rate' contended acquisitions; 0 disables the facility.
+ * Set from Eval.LockContentionSampleRate once options are parsed.
+ */
+void setSampleRate(uint32_t rate);
+
+/*
+ * Record a sampled wait of `waitUs' microseconds for the lock named
+ * `name' (which must be a static string).
+ */
+void record(const char* name, int64_t waitUs);
+
+/*
+ * Whether this contended acquisition should be timed.
+ */
+inline bool sample() {
+  auto const rate = detail::g_sampleRate.load(std::memory_order_relaxed);
+  if (LIKELY(rate == 0)) return false;
+  return detail::g_counter.fetch_add(1, std::memory_order_relaxed) %
+    rate == 0;
+}
+
+}
+
+}
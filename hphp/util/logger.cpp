@@ -67,14 +67,14 @@ std::string Logger::ExtraHeader;
 int Logger::MaxMessagesPerRequest = -1;
 bool Logger::Escape = true;
 pid_t Logger::s_pid;
-ServiceData::ExportedCounter* Logger::s_errorLines =
-    ServiceData::createCounter("errorlog_lines");
+ServiceData::ExportedShardedCounter* Logger::s_errorLines =
+    ServiceData::createShardedCounter("errorlog_lines");
 // ideally this should be "errorlog_serialized_bytes" but this was
 // added long ago and many tools rely on it.
-ServiceData::ExportedCounter* Logger::s_errorSerializedBytes =
-    ServiceData::createCounter("errorlog_bytes");
-ServiceData::ExportedCounter* Logger::s_errorCompressedBytes =
-    ServiceData::createCounter("errorlog_bytes_compressed");
+ServiceData::ExportedShardedCounter* Logger::s_errorSerializedBytes =
+    ServiceData::createShardedCounter("errorlog_bytes");
+ServiceData::ExportedShardedCounter* Logger::s_errorCompressedBytes =
+    ServiceData::createShardedCounter("errorlog_bytes_compressed");
 THREAD_LOCAL(Logger::ThreadData, Logger::s_threadData);
 
 std::map<std::string, Logger*> Logger::s_loggers = {
@@ -198,10 +198,11 @@ protected:
   Cronolog m_cronOutput;
   LogFileFlusher m_flusher;
   static std::map<std::string, Logger*> s_loggers;
-  // serialized/compressed bytes and lines the DEFAULT logger has written
-  static ServiceData::ExportedCounter* s_errorLines;
-  static ServiceData::ExportedCounter* s_errorSerializedBytes;
-  static ServiceData::ExportedCounter* s_errorCompressedBytes;
+  // serialized/compressed bytes and lines the DEFAULT logger has written;
+  // sharded since every worker thread bumps them on each line logged
+  static ServiceData::ExportedShardedCounter* s_errorLines;
+  static ServiceData::ExportedShardedCounter* s_errorSerializedBytes;
+  static ServiceData::ExportedShardedCounter* s_errorCompressedBytes;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
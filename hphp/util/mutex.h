@@ -18,12 +18,14 @@
 
 #include <pthread.h>
 #include <time.h>
+#include <chrono>
 #include <thread>
 
 #include <tbb/concurrent_hash_map.h>
 
 #include "hphp/util/portability.h"
 #include "hphp/util/assertions.h"
+#include "hphp/util/lock-contention.h"
 #include "hphp/util/rank.h"
 
 namespace HPHP {
@@ -145,13 +147,22 @@ public:
     assert(m_magic == kMagic);
     checkRank(m_rank);
 #endif
-    UNUSED int ret = pthread_mutex_lock(&m_mutex);
-    assert(ret == 0);
+    // Uncontended locks (and recursive reacquisitions) succeed on the
+    // trylock, so they pay nothing for the contention instrumentation.
+    if (UNLIKELY(pthread_mutex_trylock(&m_mutex) != 0)) {
+      lockContended();
+    }
 
     recordAcquisition();
     assertOwnedBySelf();
   }
 
+  /*
+   * Identify this mutex in the lock.wait_us.* contention histograms.
+   * `name' must be a static string.
+   */
+  void setContentionName(const char* name) { m_name = name; }
+
   void unlock() {
 #ifndef NDEBUG
     assert(m_magic == kMagic);
@@ -161,6 +172,23 @@ public:
     assert(ret == 0);
   }
 
+private:
+  NEVER_INLINE void lockContended() {
+    if (UNLIKELY(LockContention::sample())) {
+      auto const start = std::chrono::steady_clock::now();
+      UNUSED int ret = pthread_mutex_lock(&m_mutex);
+      assert(ret == 0);
+      auto const waitUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+      LockContention::record(m_name ? m_name : "unnamed", waitUs);
+    } else {
+      UNUSED int ret = pthread_mutex_lock(&m_mutex);
+      assert(ret == 0);
+    }
+  }
+
+  const char* m_name{nullptr};
+
 protected:
   pthread_mutexattr_t m_mutexattr;
   pthread_mutex_t     m_mutex;
@@ -254,7 +282,9 @@ private:
      */
     assertNotWriteOwner();
     pushRank(m_rank);
-    pthread_rwlock_rdlock(&m_rwlock);
+    if (UNLIKELY(pthread_rwlock_tryrdlock(&m_rwlock) != 0)) {
+      acquireContended(false);
+    }
     /*
      * Again, see task #528421.
      */
@@ -264,11 +294,19 @@ private:
   void acquireWrite() {
     assertNotWriteOwner();
     pushRank(m_rank);
-    pthread_rwlock_wrlock(&m_rwlock);
+    if (UNLIKELY(pthread_rwlock_trywrlock(&m_rwlock) != 0)) {
+      acquireContended(true);
+    }
     assertNotWriteOwned();
     recordWriteAcquire();
   }
 
+  /*
+   * Identify this lock in the lock.wait_us.* contention histograms.
+   * `name' must be a static string.
+   */
+  void setContentionName(const char* name) { m_name = name; }
+
   bool attemptRead() { return !pthread_rwlock_tryrdlock(&m_rwlock); }
   bool attemptWrite() { return !pthread_rwlock_trywrlock(&m_rwlock); }
   void release() {
@@ -282,6 +320,24 @@ private:
   }
 
 private:
+  NEVER_INLINE void acquireContended(bool write) {
+    auto const acquire = [&] {
+      return write ? pthread_rwlock_wrlock(&m_rwlock)
+                   : pthread_rwlock_rdlock(&m_rwlock);
+    };
+    if (UNLIKELY(LockContention::sample())) {
+      auto const start = std::chrono::steady_clock::now();
+      acquire();
+      auto const waitUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+      LockContention::record(m_name ? m_name : "unnamed", waitUs);
+    } else {
+      acquire();
+    }
+  }
+
+  const char* m_name{nullptr};
+
   pthread_rwlock_t m_rwlock;
 };
 
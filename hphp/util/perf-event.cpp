@@ -107,6 +107,7 @@ struct perf_event_handle {
 thread_local struct {
   perf_event_handle loads;
   perf_event_handle stores;
+  perf_event_handle branches;
   perf_event_signal_fn_t signal;
 } tl_perf_event = {};
 
@@ -174,8 +175,9 @@ void signal_event(int sig, siginfo_t* info, void* /*context*/) {
   if (tl_perf_event.signal == nullptr) return;
 
   auto const type = [&]() -> Optional<PerfEvent> {
-    if (info->si_fd == tl_perf_event.loads.fd)  return PerfEvent::Load;
-    if (info->si_fd == tl_perf_event.stores.fd) return PerfEvent::Store;
+    if (info->si_fd == tl_perf_event.loads.fd)    return PerfEvent::Load;
+    if (info->si_fd == tl_perf_event.stores.fd)   return PerfEvent::Store;
+    if (info->si_fd == tl_perf_event.branches.fd) return PerfEvent::Branch;
     return std::nullopt;
   }();
   if (!type) return;
@@ -266,27 +268,16 @@ void close_event(const perf_event_handle& pe) {
 }
 
 /*
- * Open a file descriptor for perf events with `event_name', mmap it, and set
+ * Open a file descriptor for the mostly-set-up `attr', mmap it, and set
  * things up so that the calling thread receives SIGIO signals from it.
  *
+ * The caller is responsible for the event selection members of `attr'; we
+ * fill in the sampling parameters.
+ *
  * Returns the perf_event_handle on success, else std::nullopt.
  */
-Optional<perf_event_handle> enable_event(const char* event_name,
-                                                uint64_t sample_freq) {
-  struct perf_event_attr attr = {};
-  pfm_perf_encode_arg_t arg = {};
-  arg.attr = &attr;
-  arg.size = sizeof(arg);
-
-  // Populate the `type', `config', and `exclude_*' members on `attr'.
-  auto const pfmr = pfm_get_os_event_encoding(event_name, PFM_PLM3,
-                                              PFM_OS_PERF_EVENT, &arg);
-  if (pfmr != PFM_SUCCESS) {
-    Logger::Warning("perf_event: failed to get encoding for %s: %s",
-                    event_name, pfm_strerror(pfmr));
-    return std::nullopt;
-  }
-
+Optional<perf_event_handle> open_event(struct perf_event_attr& attr,
+                                       uint64_t sample_freq) {
   // Finish setting up `attr' and open the event.
   attr.size = sizeof(attr);
   attr.disabled = 1;
@@ -296,13 +287,6 @@ Optional<perf_event_handle> enable_event(const char* event_name,
   attr.wakeup_events = 1;
   attr.precise_ip = 2;  // request zero skid
 
-  attr.sample_type = PERF_SAMPLE_IP
-                   | PERF_SAMPLE_TID
-                   | PERF_SAMPLE_ADDR
-                   | PERF_SAMPLE_CALLCHAIN
-                   | PERF_SAMPLE_DATA_SRC
-                   ;
-
   auto const ret = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
   if (ret < 0) {
     // Some machines might not have PEBS support (needed for precise_ip > 0),
@@ -372,6 +356,62 @@ Optional<perf_event_handle> enable_event(const char* event_name,
   return pe;
 }
 
+/*
+ * Open a perf event for memory access sampling with `event_name'.
+ */
+Optional<perf_event_handle> enable_event(const char* event_name,
+                                         uint64_t sample_freq) {
+  struct perf_event_attr attr = {};
+  pfm_perf_encode_arg_t arg = {};
+  arg.attr = &attr;
+  arg.size = sizeof(arg);
+
+  // Populate the `type', `config', and `exclude_*' members on `attr'.
+  auto const pfmr = pfm_get_os_event_encoding(event_name, PFM_PLM3,
+                                              PFM_OS_PERF_EVENT, &arg);
+  if (pfmr != PFM_SUCCESS) {
+    Logger::Warning("perf_event: failed to get encoding for %s: %s",
+                    event_name, pfm_strerror(pfmr));
+    return std::nullopt;
+  }
+
+  attr.sample_type = PERF_SAMPLE_IP
+                   | PERF_SAMPLE_TID
+                   | PERF_SAMPLE_ADDR
+                   | PERF_SAMPLE_CALLCHAIN
+                   | PERF_SAMPLE_DATA_SRC
+                   ;
+
+  return open_event(attr, sample_freq);
+}
+
+/*
+ * Open a perf event for sampling retired branch instructions, with the
+ * last-branch-record stack attached to each sample.
+ */
+Optional<perf_event_handle> enable_branch_event(uint64_t sample_freq) {
+  struct perf_event_attr attr = {};
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = PERF_COUNT_HW_BRANCH_INSTRUCTIONS;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+
+  // This layout matches perf_event_sample, with the branch stack playing the
+  // role of the callchain (and with no tail).  Note that we must not request
+  // PERF_SAMPLE_BRANCH_HW_INDEX, which would insert an extra word between the
+  // record count and the records themselves.
+  attr.sample_type = PERF_SAMPLE_IP
+                   | PERF_SAMPLE_TID
+                   | PERF_SAMPLE_ADDR
+                   | PERF_SAMPLE_BRANCH_STACK
+                   ;
+  attr.branch_sample_type = PERF_SAMPLE_BRANCH_USER
+                          | PERF_SAMPLE_BRANCH_ANY
+                          ;
+
+  return open_event(attr, sample_freq);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 /*
@@ -427,11 +467,19 @@ void consume_events(PerfEvent kind, perf_event_handle& pe,
     if (header->type == PERF_RECORD_SAMPLE) {
       auto const sample = reinterpret_cast<perf_event_sample*>(header + 1);
 
-      assertx(header->size == sizeof(struct perf_event_header) +
-                              sizeof(perf_event_sample) +
-                              sample->nr * sizeof(*sample->ips) +
-                              sizeof(perf_event_sample_tail));
-      assertx((char*)(sample->tail() + 1) == (char*)header + header->size);
+      if (kind == PerfEvent::Branch) {
+        // Branch samples have LBR records in place of the callchain, and no
+        // tail.
+        assertx(header->size == sizeof(struct perf_event_header) +
+                                sizeof(perf_event_sample) +
+                                sample->nr * sizeof(*sample->branches()));
+      } else {
+        assertx(header->size == sizeof(struct perf_event_header) +
+                                sizeof(perf_event_sample) +
+                                sample->nr * sizeof(*sample->ips) +
+                                sizeof(perf_event_sample_tail));
+        assertx((char*)(sample->tail() + 1) == (char*)header + header->size);
+      }
       consume(kind, sample);
     }
   }
@@ -458,6 +506,9 @@ perf_event_data_src(PerfEvent kind, uint64_t data_src) {
     case PerfEvent::Store:
       assertx(mem_op & PERF_MEM_OP_STORE);
       break;
+    case PerfEvent::Branch:
+      // Branch samples have no meaningful data_src.
+      not_reached();
   }
 
   auto const mem_lvl = data_src >> PERF_MEM_LVL_SHIFT;
@@ -560,8 +611,8 @@ perf_event_data_src(PerfEvent kind, uint64_t data_src) {
 bool perf_event_enable(uint64_t sample_freq, perf_event_signal_fn_t signal_fn) {
   if (!perf_event_init()) return false;
 
-  // If `tl_perf_event' has already been initialized, we're done.
-  if (tl_perf_event.signal != nullptr) return true;
+  // If the memory events have already been initialized, we're done.
+  if (tl_perf_event.loads.fd != -1) return true;
 
   if (!install_sigio_handler()) return false;
 
@@ -585,31 +636,60 @@ bool perf_event_enable(uint64_t sample_freq, perf_event_signal_fn_t signal_fn) {
   return true;
 }
 
+bool perf_event_enable_branches(uint64_t sample_freq,
+                                perf_event_signal_fn_t signal_fn) {
+  if (!perf_event_init()) return false;
+
+  // If the branch event has already been initialized, we're done.
+  if (tl_perf_event.branches.fd != -1) return true;
+
+  if (!install_sigio_handler()) return false;
+
+  auto const br_pe = enable_branch_event(sample_freq);
+  if (!br_pe) return false;
+
+  tl_perf_event.branches = *br_pe;
+  asm volatile("" : : : "memory");
+  tl_perf_event.signal = signal_fn;
+
+  return true;
+}
+
 void perf_event_pause() {
   if (tl_perf_event.signal == nullptr) return;
-  pause_event(tl_perf_event.loads);
-  pause_event(tl_perf_event.stores);
+  if (tl_perf_event.loads.fd != -1)    pause_event(tl_perf_event.loads);
+  if (tl_perf_event.stores.fd != -1)   pause_event(tl_perf_event.stores);
+  if (tl_perf_event.branches.fd != -1) pause_event(tl_perf_event.branches);
 }
 
 void perf_event_resume() {
   if (tl_perf_event.signal == nullptr) return;
-  resume_event(tl_perf_event.loads);
-  resume_event(tl_perf_event.stores);
+  if (tl_perf_event.loads.fd != -1)    resume_event(tl_perf_event.loads);
+  if (tl_perf_event.stores.fd != -1)   resume_event(tl_perf_event.stores);
+  if (tl_perf_event.branches.fd != -1) resume_event(tl_perf_event.branches);
 }
 
 void perf_event_disable() {
   if (tl_perf_event.signal == nullptr) return;
 
-  close_event(tl_perf_event.loads);
-  close_event(tl_perf_event.stores);
+  if (tl_perf_event.loads.fd != -1)    close_event(tl_perf_event.loads);
+  if (tl_perf_event.stores.fd != -1)   close_event(tl_perf_event.stores);
+  if (tl_perf_event.branches.fd != -1) close_event(tl_perf_event.branches);
   tl_perf_event = {};
 }
 
 void perf_event_consume(perf_event_consume_fn_t consume) {
   if (tl_perf_event.signal == nullptr) return;
 
-  consume_events(PerfEvent::Load,  tl_perf_event.loads,  consume);
-  consume_events(PerfEvent::Store, tl_perf_event.stores, consume);
+  if (tl_perf_event.loads.fd != -1) {
+    consume_events(PerfEvent::Load, tl_perf_event.loads, consume);
+  }
+  if (tl_perf_event.stores.fd != -1) {
+    consume_events(PerfEvent::Store, tl_perf_event.stores, consume);
+  }
+  if (tl_perf_event.branches.fd != -1) {
+    consume_events(PerfEvent::Branch, tl_perf_event.branches, consume);
+  }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -626,6 +706,9 @@ perf_event_data_src(PerfEvent kind, uint64_t data_src) {
 }
 
 bool perf_event_enable(uint64_t, perf_event_signal_fn_t) { return false; }
+bool perf_event_enable_branches(uint64_t, perf_event_signal_fn_t) {
+  return false;
+}
 void perf_event_disable() {}
 void perf_event_pause() {}
 void perf_event_resume() {}
@@ -22,10 +22,23 @@ namespace HPHP {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-enum class PerfEvent { Load, Store };
+enum class PerfEvent { Load, Store, Branch };
 
 struct perf_event_sample_tail;
 
+/*
+ * A single taken branch from the CPU's last-branch-record (LBR) stack.
+ *
+ * This mirrors the layout of the kernel's struct perf_branch_entry.
+ */
+struct perf_event_branch_entry {
+  uintptr_t from;   // address of the branch instruction
+  uintptr_t to;     // target of the branch
+  uint64_t flags;   // bit 0: mispredicted; bit 1: predicted; others reserved
+
+  bool mispredicted() const { return flags & 0x1; }
+};
+
 /*
  * Raw data from a sampled perf event.
  *
@@ -50,6 +63,17 @@ struct perf_event_sample {
       const_cast<const perf_event_sample*>(this)->tail()
     );
   }
+
+  /*
+   * Branch-stack records for a PerfEvent::Branch sample.
+   *
+   * Branch samples carry no callchain and no tail; instead, `nr' counts LBR
+   * records, which occupy the same trailing array that the callchain does for
+   * memory events.
+   */
+  const perf_event_branch_entry* branches() const {
+    return reinterpret_cast<const perf_event_branch_entry*>(this + 1);
+  }
 };
 
 struct perf_event_sample_tail {
@@ -100,7 +124,18 @@ using perf_event_consume_fn_t = void (*)(PerfEvent, const perf_event_sample*);
 bool perf_event_enable(uint64_t sample_freq, perf_event_signal_fn_t signal_fn);
 
 /*
- * Disable perf memory event sampling on this thread.
+ * Enable sampling of retired taken branches on this thread, with the CPU's
+ * last-branch-record stack attached to each sample.
+ *
+ * This behaves like perf_event_enable(), and may be used alongside it; the
+ * two share a single `signal_fn', with the most recent one winning.  Fails
+ * silently on hardware without LBR support.
+ */
+bool perf_event_enable_branches(uint64_t sample_freq,
+                                perf_event_signal_fn_t signal_fn);
+
+/*
+ * Disable perf event sampling on this thread.
  *
  * All unconsumed samples will be lost, even if sampling is later reenabled.
  */
@@ -17,7 +17,13 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 #include "hphp/util/assertions.h"
 #include "hphp/util/portability.h"
 
@@ -25,6 +31,13 @@ namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
 
 // information about heap objects, indexed by valid object starts.
+//
+// Lookups are the conservative scanner's hottest operation, so prepare()
+// builds a radix bucket index over the sorted region starts: the span is
+// split into power-of-two buckets averaging under one region each, and
+// region() resolves a pointer with one bucket load plus a short scan of
+// the (dense) starts array, vectorized where available, instead of a
+// full binary search per candidate.
 template<class T> struct PtrMap {
   using Region = std::pair<T, std::size_t>;
 
@@ -38,18 +51,24 @@ template<class T> struct PtrMap {
     if (uintptr_t(p) - uintptr_t(span_.first) >= span_.second) {
       return nullptr;
     }
-    // Find the first region which begins beyond p.
-    auto it = std::upper_bound(regions_.begin(), regions_.end(), p,
-      [](const void* p, const Region& region) {
-        return p < region.first;
-      });
-    // If it == first region, p is before any region, which we already
-    // checked above.
-    assert(it != regions_.begin());
-    --it; // backup to the previous region.
-    // p can only potentially point within this previous region, so check that.
-    return uintptr_t(p) - uintptr_t(it->first) < it->second ? &*it :
-           nullptr;
+    // Find the first region which begins beyond p. The bucket index
+    // brackets the search to [bucket_[b], bucket_[b+1]); the span check
+    // above guarantees b is in range and that at least starts_[0] <= p.
+    auto const b = bucketOf(p);
+    auto const it = scanStarts(bucket_[b], bucket_[b + 1], uintptr_t(p));
+    // If it == 0, p is before any region, which we already checked above.
+    assert(it != 0);
+    // p can only potentially point within the previous region, so check that.
+    auto const r = &regions_[it - 1];
+    return uintptr_t(p) - uintptr_t(r->first) < r->second ? r : nullptr;
+  }
+
+  // Hint that region(p) is about to be called, so its bucket entry is in
+  // cache by the time it is.
+  void prefetch(const void* p) const {
+    if (uintptr_t(p) - uintptr_t(span_.first) < span_.second) {
+      __builtin_prefetch(&bucket_[bucketOf(p)]);
+    }
   }
 
   T start(const void* p) const {
@@ -85,6 +104,7 @@ template<class T> struct PtrMap {
         (const char*)back.first + back.second - (const char*)front.first
       };
     }
+    buildIndex();
     assert(sanityCheck());
   }
 
@@ -103,6 +123,51 @@ template<class T> struct PtrMap {
   }
 
 private:
+  size_t bucketOf(const void* p) const {
+    return (uintptr_t(p) - uintptr_t(span_.first)) >> lgBucket_;
+  }
+
+  // Return the first index in [lo,hi) with starts_[i] > p, or hi.
+  size_t scanStarts(size_t lo, size_t hi, uintptr_t p) const {
+#ifdef __AVX2__
+    // Region starts are userspace addresses (and the scanner masks
+    // candidates to 48 bits), so a signed 64-bit compare is safe.
+    auto const pv = _mm256_set1_epi64x(static_cast<int64_t>(p));
+    for (; lo + 4 <= hi; lo += 4) {
+      auto const starts = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(&starts_[lo]));
+      auto const gt = _mm256_movemask_pd(
+        _mm256_castsi256_pd(_mm256_cmpgt_epi64(starts, pv)));
+      if (gt) return lo + __builtin_ctz(gt);
+    }
+#endif
+    while (lo < hi && starts_[lo] <= p) ++lo;
+    return lo;
+  }
+
+  void buildIndex() {
+    auto const n = regions_.size();
+    starts_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      starts_[i] = uintptr_t(regions_[i].first);
+    }
+    // Aim for no more than ~2 regions per bucket on average; widen the
+    // buckets until the table is at most ~2n entries.
+    auto const maxBuckets = std::max(size_t{2} * n, size_t{1});
+    lgBucket_ = 0;
+    while ((span_.second >> lgBucket_) + 1 > maxBuckets) ++lgBucket_;
+    auto const nBuckets = (span_.second >> lgBucket_) + 2;
+    bucket_.resize(nBuckets);
+    // bucket_[b] = number of regions starting below the bucket's base.
+    auto const base = uintptr_t(span_.first);
+    size_t i = 0;
+    for (size_t b = 0; b < nBuckets; ++b) {
+      auto const bucketBase = base + (uintptr_t(b) << lgBucket_);
+      while (i < n && starts_[i] < bucketBase) ++i;
+      bucket_[b] = i;
+    }
+  }
+
   bool sanityCheck() const {
     // Verify that all the regions are in increasing and non-overlapping order.
     DEBUG_ONLY void* last = nullptr;
@@ -115,6 +180,9 @@ private:
 
   Region span_{nullptr, 0};
   std::vector<Region> regions_;
+  std::vector<uintptr_t> starts_;
+  std::vector<size_t> bucket_;
+  size_t lgBucket_{0};
   bool sorted_{true};
 };
 
@@ -86,6 +86,36 @@ RingBufferEntry* g_ring_ptr;
 std::atomic<int> g_ringIdx(0);
 std::atomic<uint32_t> g_seqnum(0);
 
+std::atomic<FlightRecorder*> g_flightRecorders{nullptr};
+static bool g_flightRecorderEnabled = false;
+static __thread FlightRecorder* tl_recorder;
+
+void enableFlightRecorder(bool enable) {
+  g_flightRecorderEnabled = enable;
+}
+
+// Reserve the thread's next flight recorder slot, or nullptr if recording is
+// disabled.  Lazily allocates the recorder and links it into the registry;
+// recorders are leaked so crash-time readers never chase a freed pointer.
+static RingBufferEntry* allocFlightEntry(RingBufferType t) {
+  if (LIKELY(!g_flightRecorderEnabled)) return nullptr;
+  if (UNLIKELY(!tl_recorder)) {
+    tl_recorder = new FlightRecorder();
+    tl_recorder->threadId = (uint32_t)((int64_t)pthread_self() & 0xFFFFFFFF);
+    auto head = g_flightRecorders.load(std::memory_order_relaxed);
+    do {
+      tl_recorder->next = head;
+    } while (!g_flightRecorders.compare_exchange_weak(
+               head, tl_recorder, std::memory_order_acq_rel));
+  }
+  auto& rec = *tl_recorder;
+  auto const e = &rec.entries[rec.idx++ % kFlightRecorderEntries];
+  e->seq = rec.idx - 1;
+  e->type = t;
+  e->threadId = rec.threadId;
+  return e;
+}
+
 RingBufferEntry* allocEntry(RingBufferType t) {
   assert(folly::isPowTwo(kMaxRBEntries));
   RingBufferEntry* rb;
@@ -113,18 +143,27 @@ RingBufferEntry* allocEntry(RingBufferType t) {
 
 void
 ringbufferMsg(const char* msg, size_t msgLen, RingBufferType t) {
-  auto& info = allocEntry(t)->msg;
-  info.msg = msg;
-  info.len = msgLen;
-  info.truncatedRip = static_cast<uint32_t>(
+  auto const rip = static_cast<uint32_t>(
     reinterpret_cast<uintptr_t>(__builtin_return_address(0)));
+  auto const fill = [&] (RingBufferEntry* e) {
+    auto& info = e->msg;
+    info.msg = msg;
+    info.len = msgLen;
+    info.truncatedRip = rip;
+  };
+  fill(allocEntry(t));
+  if (auto const e = allocFlightEntry(t)) fill(e);
 }
 
 void
 ringbufferEntry(RingBufferType t, uint64_t sk, uint64_t data) {
-  auto& info = allocEntry(t)->vmPoint;
-  info.sk = sk;
-  info.data = data;
+  auto const fill = [&] (RingBufferEntry* e) {
+    auto& info = e->vmPoint;
+    info.sk = sk;
+    info.data = data;
+  };
+  fill(allocEntry(t));
+  if (auto const e = allocFlightEntry(t)) fill(e);
 }
 
 void
@@ -134,21 +173,33 @@ ringbufferEntryRip(RingBufferType t, uint64_t sk) {
 }
 
 void ringbufferAPCEnqueue(void* handle, void* value) {
-  auto& info = allocEntry(RBTypeAPCHandleEnqueue)->apcHandleInfo;
-  info.handle = handle;
-  info.value = value;
+  auto const fill = [&] (RingBufferEntry* e) {
+    auto& info = e->apcHandleInfo;
+    info.handle = handle;
+    info.value = value;
+  };
+  fill(allocEntry(RBTypeAPCHandleEnqueue));
+  if (auto const e = allocFlightEntry(RBTypeAPCHandleEnqueue)) fill(e);
 }
 
 void ringbufferAPCDelete(void* handle, void* value) {
-  auto& info = allocEntry(RBTypeAPCHandleDelete)->apcHandleInfo;
-  info.handle = handle;
-  info.value = value;
+  auto const fill = [&] (RingBufferEntry* e) {
+    auto& info = e->apcHandleInfo;
+    info.handle = handle;
+    info.value = value;
+  };
+  fill(allocEntry(RBTypeAPCHandleDelete));
+  if (auto const e = allocFlightEntry(RBTypeAPCHandleDelete)) fill(e);
 }
 
 void ringbufferGeneric(const char* name, uint64_t data) {
-  auto& info = allocEntry(RBTypeGeneric)->generic;
-  info.name = name;
-  info.data = data;
+  auto const fill = [&] (RingBufferEntry* e) {
+    auto& info = e->generic;
+    info.name = name;
+    info.data = data;
+  };
+  fill(allocEntry(RBTypeGeneric));
+  if (auto const e = allocFlightEntry(RBTypeGeneric)) fill(e);
 }
 
 void ringbufferGeneric(const char* name, const void* data) {
@@ -102,6 +102,36 @@ constexpr unsigned kMaxRBEntries = (1 << 20); // Must exceed number of threads
 extern RingBufferEntry* g_ring_ptr;
 extern std::atomic<int> g_ringIdx;
 
+/*
+ * Per-thread flight recorder.
+ *
+ * The global ring is shared by every thread, so by the time a crash handler
+ * runs, a few busy threads have usually overwritten everyone else's recent
+ * history.  When enabled, each ringbuffer write is also mirrored into a
+ * small per-thread ring, and all threads' recorders are chained into a
+ * global registry so the crash handler can dump the last few entries of
+ * every thread, not just the noisiest ones.
+ *
+ * Recorders are leaked at thread exit; the registry (and the crash handler)
+ * may be walking them at any time.
+ */
+constexpr unsigned kFlightRecorderEntries = (1 << 12); // per thread
+
+struct FlightRecorder {
+  RingBufferEntry entries[kFlightRecorderEntries];
+  uint32_t idx{0};  // monotonic; slot = idx % kFlightRecorderEntries
+  uint32_t threadId{0};
+  FlightRecorder* next{nullptr};  // registry chain
+};
+
+extern std::atomic<FlightRecorder*> g_flightRecorders;
+
+/*
+ * Turn flight recording on or off.  Call before threads start writing to the
+ * ringbuffer; entries logged while disabled are only in the global ring.
+ */
+void enableFlightRecorder(bool enable);
+
 const char* ringbufferName(RingBufferType t);
 void vtraceRingbuffer(ATTRIBUTE_PRINTF_STRING const char* fmt, va_list ap)
   ATTRIBUTE_PRINTF(1,0);
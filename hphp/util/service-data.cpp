@@ -24,9 +24,11 @@
 #include <folly/Conv.h>
 #include <folly/MapUtil.h>
 #include <folly/Random.h>
+#include <folly/lang/Bits.h>
 #include <folly/stats/Histogram.h>
 
 #include "hphp/util/portability.h"
+#include "hphp/util/process.h"
 
 namespace HPHP {
 
@@ -34,6 +36,28 @@ namespace HPHP {
 
 namespace ServiceData {
 
+namespace detail {
+
+size_t numShards() {
+  static const size_t shards = [] {
+    auto const cpus = Process::GetCPUCount();
+    return folly::nextPowTwo(std::max(cpus, 1));
+  }();
+  return shards;
+}
+
+size_t shardIndex(size_t numShards) {
+  // Round-robin threads onto shards; worker threads are long lived, so this
+  // spreads writers evenly without hashing thread ids.
+  static std::atomic<size_t> nextShard{0};
+  static thread_local size_t shard =
+    nextShard.fetch_add(1, std::memory_order_relaxed);
+  assertx(folly::isPowTwo(numShards));
+  return shard & (numShards - 1);
+}
+
+} // namespace detail
+
 ExportedTimeSeries::ExportedTimeSeries(
   int numBuckets,
   const std::vector<std::chrono::seconds>& durations,
@@ -152,6 +176,46 @@ void ExportedHistogram::exportAll(const std::string& prefix,
   }
 }
 
+ExportedShardedHistogram::ExportedShardedHistogram(
+  int64_t bucketSize,
+  int64_t min,
+  int64_t max,
+  const std::vector<double>& exportPercentiles)
+    : m_exportPercentiles(exportPercentiles) {
+  folly::Histogram<int64_t> hist(bucketSize, min, max);
+  m_shards.reserve(detail::numShards());
+  for (size_t i = 0; i < detail::numShards(); ++i) {
+    m_shards.push_back(std::make_unique<Shard>(hist));
+  }
+}
+
+void ExportedShardedHistogram::addValue(int64_t value) {
+  m_shards[detail::shardIndex(m_shards.size())]
+    ->histogram.lock()->addValue(value);
+}
+
+void ExportedShardedHistogram::removeValue(int64_t value) {
+  m_shards[detail::shardIndex(m_shards.size())]
+    ->histogram.lock()->removeValue(value);
+}
+
+void ExportedShardedHistogram::exportAll(
+    const std::string& prefix,
+    std::map<std::string, int64_t>& statsMap) {
+  auto merged = m_shards[0]->histogram.copy();
+  for (size_t i = 1; i < m_shards.size(); ++i) {
+    auto shard = m_shards[i]->histogram.copy();
+    merged.merge(shard);
+  }
+  for (double percentile : m_exportPercentiles) {
+    statsMap.insert(
+      std::make_pair(
+        folly::to<std::string>(
+          prefix, ".hist.p", folly::to<int32_t>(percentile * 100)),
+        merged.getPercentileEstimate(percentile)));
+  }
+}
+
 namespace detail {
 template <class ClassWithPrivateDestructor>
 struct FriendDeleter {
@@ -232,6 +296,10 @@ struct Impl {
     return getOrCreateWithArgs(m_counterMap, name);
   }
 
+  ExportedShardedCounter* createShardedCounter(const std::string& name) {
+    return getOrCreateWithArgs(m_shardedCounterMap, name);
+  }
+
   CounterHandle registerCounterCallback(CounterFunc func) {
     auto handle = folly::Random::rand32();
     SYNCHRONIZED(m_counterFuncs) {
@@ -267,12 +335,27 @@ struct Impl {
       m_histogramMap, name, bucketSize, min, max, exportPercentiles);
   }
 
+  ExportedShardedHistogram* createShardedHistogram(
+      const std::string& name,
+      int64_t bucketSize,
+      int64_t min,
+      int64_t max,
+      const std::vector<double>& exportPercentiles) {
+    return getOrCreateWithArgs(
+      m_shardedHistogramMap, name, bucketSize, min, max, exportPercentiles);
+  }
+
   void exportAll(std::map<std::string, int64_t>& statsMap) {
     for (auto& counter : m_counterMap) {
       statsMap.insert(std::make_pair(counter.first,
                                      counter.second->getValue()));
     }
 
+    for (auto& counter : m_shardedCounterMap) {
+      statsMap.insert(std::make_pair(counter.first,
+                                     counter.second->getValue()));
+    }
+
     for (auto& ts : m_timeseriesMap) {
       ts.second->exportAll(ts.first, statsMap);
     }
@@ -281,6 +364,10 @@ struct Impl {
       histogram.second->exportAll(histogram.first, statsMap);
     }
 
+    for (auto& histogram : m_shardedHistogramMap) {
+      histogram.second->exportAll(histogram.first, statsMap);
+    }
+
     SYNCHRONIZED_CONST(m_counterFuncs) {
       for (auto& pair : m_counterFuncs) {
         pair.second(statsMap);
@@ -294,6 +381,10 @@ struct Impl {
     if (counterIter != m_counterMap.end()) {
       return counterIter->second->getValue();
     }
+    auto const shardedIter = m_shardedCounterMap.find(key);
+    if (shardedIter != m_shardedCounterMap.end()) {
+      return shardedIter->second->getValue();
+    }
     // Check callbacks
     std::map<std::string, int64_t> statsMap;
     SYNCHRONIZED_CONST(m_counterFuncs) {
@@ -367,16 +458,22 @@ struct Impl {
 
   typedef tbb::concurrent_unordered_map<std::string, ExportedCounter*>
     ExportedCounterMap;
+  typedef tbb::concurrent_unordered_map<std::string, ExportedShardedCounter*>
+    ExportedShardedCounterMap;
   typedef std::unordered_map<CounterHandle, CounterFunc> CounterFuncMap;
   typedef tbb::concurrent_unordered_map<std::string, ExportedTimeSeries*>
     ExportedTimeSeriesMap;
   typedef tbb::concurrent_unordered_map<std::string, ExportedHistogram*>
     ExportedHistogramMap;
+  typedef tbb::concurrent_unordered_map<std::string, ExportedShardedHistogram*>
+    ExportedShardedHistogramMap;
 
   ExportedCounterMap m_counterMap;
+  ExportedShardedCounterMap m_shardedCounterMap;
   folly::Synchronized<CounterFuncMap> m_counterFuncs;
   ExportedTimeSeriesMap m_timeseriesMap;
   ExportedHistogramMap m_histogramMap;
+  ExportedShardedHistogramMap m_shardedHistogramMap;
 };
 
 // Implementation note:
@@ -415,6 +512,10 @@ ExportedCounter* createCounter(const std::string& name) {
   return getServiceDataInstance().createCounter(name);
 }
 
+ExportedShardedCounter* createShardedCounter(const std::string& name) {
+  return getServiceDataInstance().createShardedCounter(name);
+}
+
 CounterHandle registerCounterCallback(CounterFunc func) {
   return getServiceDataInstance().registerCounterCallback(std::move(func));
 }
@@ -442,6 +543,16 @@ ExportedHistogram* createHistogram(
     name, bucketSize, min, max, exportPercentile);
 }
 
+ExportedShardedHistogram* createShardedHistogram(
+    const std::string& name,
+    int64_t bucketSize,
+    int64_t min,
+    int64_t max,
+    const std::vector<double>& exportPercentile) {
+  return getServiceDataInstance().createShardedHistogram(
+    name, bucketSize, min, max, exportPercentile);
+}
+
 void exportAll(std::map<std::string, int64_t>& statsMap) {
   return getServiceDataInstance().exportAll(statsMap);
 }
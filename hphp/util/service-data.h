@@ -19,6 +19,7 @@
 #include <atomic>
 #include <chrono>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -96,11 +97,18 @@ namespace ServiceData {
 
 struct ExportedCounter;
 struct ExportedHistogram;
+struct ExportedShardedCounter;
+struct ExportedShardedHistogram;
 struct ExportedTimeSeries;
 
 namespace detail {
 template <class ClassWithPrivateDestructor>
 struct FriendDeleter;
+
+// Shard count (a power of two derived from the core count) and the calling
+// thread's shard, used by the sharded counter and histogram types below.
+size_t numShards();
+size_t shardIndex(size_t numShards);
 };
 
 enum class StatsType { AVG, SUM, RATE, COUNT, PCT };
@@ -111,6 +119,20 @@ enum class StatsType { AVG, SUM, RATE, COUNT, PCT };
  */
 ExportedCounter* createCounter(const std::string& name);
 
+/*
+ * Create a sharded flat counter named 'name'. Return an existing one if it
+ * has already been created.
+ *
+ * A sharded counter spreads its value across several cache lines; each
+ * thread adds to its own shard and reads sum all the shards. Prefer it over
+ * createCounter() for counters that are updated constantly from many worker
+ * threads and read rarely (e.g. only when stats are exported), where the
+ * cache line holding a plain counter would bounce between cores. Reads are
+ * proportionally more expensive, and setValue() is not atomic with respect
+ * to concurrent writers.
+ */
+ExportedShardedCounter* createShardedCounter(const std::string& name);
+
 /*
  * Callback-based counters
  *
@@ -221,6 +243,22 @@ ExportedHistogram* createHistogram(
   int64_t max,
   const std::vector<double>& exportPercentile);
 
+/*
+ * Create a sharded histogram named 'name'. Return an existing one if it has
+ * already been created.
+ *
+ * Takes the same parameters as createHistogram(). Like a sharded counter,
+ * each thread records values into its own shard and the shards are merged
+ * when percentiles are exported, so addValue() never contends with other
+ * writers on a shared lock.
+ */
+ExportedShardedHistogram* createShardedHistogram(
+  const std::string& name,
+  int64_t bucketSize,
+  int64_t min,
+  int64_t max,
+  const std::vector<double>& exportPercentile);
+
 /*
  * Export all the statistics as simple key, value pairs.
  */
@@ -251,6 +289,40 @@ struct ExportedCounter {
   std::atomic_int_fast64_t m_value;
 };
 
+// Interface for a sharded flat counter. All methods are thread safe; see
+// createShardedCounter() for the setValue() caveat.
+struct ExportedShardedCounter {
+  ExportedShardedCounter() : m_shards(detail::numShards()) {}
+  void increment() { addValue(1); }
+  void decrement() { addValue(-1); }
+  void addValue(int64_t value) {
+    m_shards[detail::shardIndex(m_shards.size())].value.fetch_add(
+      value, std::memory_order_relaxed);
+  }
+  void setValue(int64_t value) {
+    m_shards[0].value.store(value, std::memory_order_relaxed);
+    for (size_t i = 1; i < m_shards.size(); ++i) {
+      m_shards[i].value.store(0, std::memory_order_relaxed);
+    }
+  }
+  int64_t getValue() const {
+    int64_t sum = 0;
+    for (auto& shard : m_shards) {
+      sum += shard.value.load(std::memory_order_relaxed);
+    }
+    return sum;
+  }
+
+ private:
+  friend struct detail::FriendDeleter<ExportedShardedCounter>;
+  ~ExportedShardedCounter() {}
+
+  struct alignas(64) Shard {
+    std::atomic_int_fast64_t value{0};
+  };
+  std::vector<Shard> m_shards;
+};
+
 // Interface for timeseries data. All methods are thread safe.
 struct ExportedTimeSeries {
   ExportedTimeSeries(int numBuckets,
@@ -294,6 +366,30 @@ struct ExportedHistogram {
   const std::vector<double> m_exportPercentiles;
 };
 
+// Interface for sharded histogram data. All methods are thread safe.
+struct ExportedShardedHistogram {
+  ExportedShardedHistogram(int64_t bucketSize, int64_t min, int64_t max,
+                           const std::vector<double>& exportPercentiles);
+  void addValue(int64_t value);
+  void removeValue(int64_t value);
+  void exportAll(const std::string& prefix,
+                 std::map<std::string, int64_t>& statsMap);
+
+ private:
+  friend struct detail::FriendDeleter<ExportedShardedHistogram>;
+  ~ExportedShardedHistogram() {}
+
+  // Each shard gets its own lock and cache line, so a thread adding a value
+  // only ever contends with readers merging the shards for export.
+  struct alignas(64) Shard {
+    explicit Shard(const folly::Histogram<int64_t>& hist)
+      : histogram(hist) {}
+    folly::Synchronized<folly::Histogram<int64_t>> histogram;
+  };
+  std::vector<std::unique_ptr<Shard>> m_shards;
+  const std::vector<double> m_exportPercentiles;
+};
+
 };  // namespace ServiceData
 
 ///////////////////////////////////////////////////////////////////////////////
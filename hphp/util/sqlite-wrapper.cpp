@@ -26,6 +26,43 @@ namespace HPHP {
 
 namespace {
 
+// SQLITE_MAX_VARIABLE_NUMBER defaults to 999; cap multi-row inserts to
+// that many bound parameters per statement.
+constexpr size_t kMaxInsertParams = 999;
+
+std::string multiRowInsertSql(const std::string_view insertClause,
+                              size_t numCols, size_t numRows) {
+  std::string sql{insertClause};
+  sql += " VALUES ";
+  for (size_t r = 0; r < numRows; ++r) {
+    sql += r ? ",(" : "(";
+    for (size_t c = 0; c < numCols; ++c) {
+      sql += c ? ",?" : "?";
+    }
+    sql += ")";
+  }
+  return sql;
+}
+
+void bindValue(sqlite3_stmt* stmt, int param, const SQLite::Value& val) {
+  int UNUSED rc = [&] {
+    if (std::get_if<std::nullptr_t>(&val)) {
+      return sqlite3_bind_null(stmt, param);
+    }
+    if (auto const i = std::get_if<int64_t>(&val)) {
+      return sqlite3_bind_int64(stmt, param, *i);
+    }
+    if (auto const d = std::get_if<double>(&val)) {
+      return sqlite3_bind_double(stmt, param, *d);
+    }
+    auto const& s = std::get<std::string>(val);
+    // The row data outlives the step, so SQLite needn't copy it.
+    return sqlite3_bind_text(stmt, param, s.data(), int(s.size()),
+                             SQLITE_STATIC);
+  }();
+  assertx(rc == SQLITE_OK);
+}
+
 std::string_view journalModeName(
   SQLite::JournalMode mode) noexcept {
   switch (mode) {
@@ -51,7 +88,8 @@ SQLite::SQLite(SQLite&& old) noexcept
     : m_dbc{old.m_dbc},
       m_beginStmt{std::move(old.m_beginStmt)},
       m_rollbackStmt{std::move(old.m_rollbackStmt)},
-      m_commitStmt{std::move(old.m_commitStmt)} {
+      m_commitStmt{std::move(old.m_commitStmt)},
+      m_stmtCache{std::move(old.m_stmtCache)} {
   old.m_dbc = nullptr;
 
   // No outstanding transactions
@@ -78,6 +116,7 @@ SQLite& SQLite::operator=(SQLite&& old) noexcept {
   m_beginStmt = std::move(old.m_beginStmt);
   m_rollbackStmt = std::move(old.m_rollbackStmt);
   m_commitStmt = std::move(old.m_commitStmt);
+  m_stmtCache = std::move(old.m_stmtCache);
 
   return *this;
 }
@@ -129,6 +168,38 @@ SQLiteStmt SQLite::prepare(const std::string_view sql) {
   return {*this, sql};
 }
 
+SQLiteStmt& SQLite::prepareCached(const std::string_view sql) {
+  std::string key{sql};
+  auto it = m_stmtCache.find(key);
+  if (it == m_stmtCache.end()) {
+    it = m_stmtCache.emplace(std::move(key), SQLiteStmt{*this, sql}).first;
+  }
+  return it->second;
+}
+
+void SQLite::insertMany(const std::string_view insertClause, size_t numCols,
+                        const std::vector<std::vector<Value>>& rows) {
+  always_assert(numCols > 0 && numCols <= kMaxInsertParams);
+  auto const chunk = kMaxInsertParams / numCols;
+  size_t i = 0;
+  while (i < rows.size()) {
+    // Full chunks first, then the remainder one row at a time, so each
+    // insert clause caches at most two statements.
+    auto const n = rows.size() - i >= chunk ? chunk : 1;
+    auto& stmt = prepareCached(multiRowInsertSql(insertClause, numCols, n));
+    SQLiteQuery query{stmt.query()};
+    int param = 1;
+    for (size_t r = i; r < i + n; ++r) {
+      always_assert(rows[r].size() == numCols);
+      for (auto const& val : rows[r]) {
+        bindValue(stmt.m_stmt, param++, val);
+      }
+    }
+    query.step();
+    i += n;
+  }
+}
+
 SQLiteTxn SQLite::begin() { return SQLiteTxn{*this}; }
 
 void SQLite::setBusyTimeout(int ms) noexcept {
@@ -148,6 +219,21 @@ void SQLite::setSynchronousLevel(SynchronousLevel lvl) {
   stmt.query().step();
 }
 
+void SQLite::setWalAutoCheckpoint(int frames) {
+  int rc = sqlite3_wal_autocheckpoint(m_dbc, frames);
+  if (rc != SQLITE_OK) {
+    throw SQLiteExc{rc, "PRAGMA wal_autocheckpoint"};
+  }
+}
+
+void SQLite::walCheckpoint(CheckpointMode mode) {
+  int rc = sqlite3_wal_checkpoint_v2(
+      m_dbc, nullptr, static_cast<int>(mode), nullptr, nullptr);
+  if (rc != SQLITE_OK) {
+    throw SQLiteExc{rc, "PRAGMA wal_checkpoint"};
+  }
+}
+
 bool SQLite::isReadOnly() const {
   return isReadOnly("main");
 }
@@ -259,8 +345,7 @@ SQLiteQuery SQLiteTxn::query(SQLiteStmt& stmt) noexcept { return stmt.query(); }
 
 void SQLiteTxn::exec(std::string_view sql) {
   assertx(m_db != nullptr);
-  SQLiteStmt stmt{m_db->prepare(sql)};
-  SQLiteQuery query{stmt.query()};
+  SQLiteQuery query{m_db->prepareCached(sql).query()};
   query.step();
 }
 
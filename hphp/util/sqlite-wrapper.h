@@ -17,6 +17,9 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
 
 #include "hphp/util/sqlite-wrapper-helpers.h"
 
@@ -85,6 +88,35 @@ struct SQLite {
    */
   SQLiteStmt prepare(const std::string_view sql);  // throws(SQLiteExc)
 
+  /**
+   * Like prepare(), but keyed by query text and owned by the connection:
+   * preparing the same SQL again returns the same statement instead of
+   * recompiling it.  The reference stays valid for the lifetime of the
+   * connection.  As with any statement, only one query may exist on it at
+   * a time.
+   */
+  SQLiteStmt& prepareCached(const std::string_view sql);  // throws(SQLiteExc)
+
+  /**
+   * A single value of an insertMany() row.
+   */
+  using Value = std::variant<std::nullptr_t, int64_t, double, std::string>;
+
+  /**
+   * Insert many rows using multi-row INSERT statements.
+   *
+   * `insertClause` is everything up to the VALUES keyword, e.g.
+   * "INSERT OR REPLACE INTO path_sha1sum (path, sha1sum)", and each row
+   * must hold exactly `numCols` values.  Rows are written in chunks sized
+   * to SQLite's bound-parameter limit, with the chunk statements cached
+   * via prepareCached(), so write bursts pay per-statement overhead once
+   * per chunk rather than once per row.  Wrap the call in a transaction
+   * if the insert must be atomic across chunks.
+   */
+  void insertMany(const std::string_view insertClause, size_t numCols,
+                  const std::vector<std::vector<Value>>& rows);
+                                                       // throws(SQLiteExc)
+
   /**
    * Begin a SQLite transaction to run queries within.
    */
@@ -160,6 +192,37 @@ struct SQLite {
    */
   void setSynchronousLevel(SynchronousLevel lvl);
 
+  /**
+   * In WAL mode, checkpoint automatically once the log reaches the given
+   * number of frames (SQLite's default is 1000); 0 or less disables
+   * automatic checkpointing.
+   *
+   * https://www.sqlite.org/c3ref/wal_autocheckpoint.html
+   */
+  void setWalAutoCheckpoint(int frames);
+
+  enum class CheckpointMode {
+    // Checkpoint as many frames as possible without waiting for readers
+    // or writers.
+    PASSIVE = 0,
+
+    // Wait for writers and readers, then checkpoint all frames.
+    FULL = 1,
+
+    // Like FULL, but also wait until no reader is using the log.
+    RESTART = 2,
+
+    // Like RESTART, and additionally truncate the log to zero bytes.
+    TRUNCATE = 3,
+  };
+
+  /**
+   * Explicitly checkpoint the write-ahead log, e.g. after a write burst.
+   *
+   * https://www.sqlite.org/c3ref/wal_checkpoint_v2.html
+   */
+  void walCheckpoint(CheckpointMode mode = CheckpointMode::PASSIVE);
+
   /**
    * True iff this wrapper points to a valid SQLite connection.
    *
@@ -210,6 +273,10 @@ struct SQLite {
   SQLiteStmt m_beginStmt;
   SQLiteStmt m_rollbackStmt;
   SQLiteStmt m_commitStmt;
+
+  // Statements from prepareCached(), keyed by their SQL. Node-based so
+  // the references we hand out stay valid as the cache grows.
+  std::unordered_map<std::string, SQLiteStmt> m_stmtCache;
 };
 
 }  // namespace HPHP
@@ -30,6 +30,10 @@ enum struct FreeType {
   NoFree,
   Free,
   LocalFree,
+  // Not owned, but guaranteed valid for the rest of the process lifetime
+  // (e.g. static content cache entries), so it may be referenced
+  // indefinitely without copying.
+  Persistent,
 };
 
 /*
@@ -63,6 +67,15 @@ struct StringHolder {
 
   const char* data() const { return m_data; }
 
+  // Whether this holder owns (and will eventually free) the buffer, as
+  // opposed to borrowing memory whose lifetime is the caller's business.
+  bool owns() const {
+    return m_type != FreeType::NoFree && m_type != FreeType::Persistent;
+  }
+
+  // Whether the buffer outlives any conceivable reference to it.
+  bool persistent() const { return m_type == FreeType::Persistent; }
+
   operator bool() const { return data() != nullptr; }
 
 private:
@@ -180,6 +180,31 @@ TEST(JobQueue, Expiration) {
   }
 }
 
+TEST(JobQueue, PriorityAging) {
+  timespec timeOk;
+  clock_gettime(CLOCK_MONOTONIC, &timeOk);
+
+  JobQueue<int> job_queue(1, 0, false, INT_MAX, -1, 2, true, 30000);
+  job_queue.enqueue(1, 0);
+  job_queue.enqueue(2, 1);
+  job_queue.enqueue(3, 1);
+
+  // Nothing has aged past the threshold yet, so strict priority applies.
+  bool expired = false;
+  EXPECT_EQ(2, job_queue.dequeueMaybeExpiredImpl(0, 0, true,
+                                                 timeOk, &expired));
+  EXPECT_FALSE(expired);
+
+  // Age the low-priority job past the threshold. It now jumps the queue.
+  job_queue.m_jobQueues[0][0].second.tv_sec -= 31;
+  EXPECT_EQ(1, job_queue.dequeueMaybeExpiredImpl(0, 0, true,
+                                                 timeOk, &expired));
+  EXPECT_FALSE(expired);
+  EXPECT_EQ(3, job_queue.dequeueMaybeExpiredImpl(0, 0, true,
+                                                 timeOk, &expired));
+  EXPECT_FALSE(expired);
+}
+
 TEST(JobQueue, Priority) {
   JobQueue<int> fifo_queue(1, 0, false, INT_MAX, 30, 3);
   fifo_queue.enqueue(1);
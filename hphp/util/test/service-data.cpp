@@ -15,6 +15,8 @@
 */
 
 #include <atomic>
+#include <thread>
+#include <vector>
 #include "hphp/util/service-data.h"
 #include <gtest/gtest.h>
 namespace HPHP {
@@ -103,6 +105,60 @@ TEST(ServiceDataTest, TimeSeriesTest) {
   }
 }
 
+TEST(ServiceDataTest, ShardedCounterTest) {
+  auto counter = ServiceData::createShardedCounter("sc1");
+  counter->increment();
+  counter->addValue(4);
+  counter->decrement();
+  {
+    std::map<std::string, int64_t> values;
+    ServiceData::exportAll(values);
+    EXPECT_EQ(4, values["sc1"]);
+  }
+  EXPECT_EQ(4, ServiceData::exportCounterByKey("sc1").value_or(-1));
+
+  // Values written from other threads land in other shards but are summed
+  // on read.
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([&] { counter->addValue(2); });
+  }
+  for (auto& t : threads) t.join();
+  EXPECT_EQ(20, counter->getValue());
+
+  counter->setValue(7);
+  EXPECT_EQ(7, counter->getValue());
+
+  // Same name returns the same underlying counter.
+  ServiceData::createShardedCounter("sc1")->increment();
+  EXPECT_EQ(8, counter->getValue());
+}
+
+TEST(ServiceDataTest, ShardedHistogram) {
+  auto hist = ServiceData::createShardedHistogram(
+    "shard_hist", 1, 0, 100,
+    {0.05, 0.5, 0.75, 0.95});
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = t * 25; i < (t + 1) * 25; ++i) {
+        hist->addValue(i);
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+
+  {
+    std::map<std::string, int64_t> values;
+    ServiceData::exportAll(values);
+    EXPECT_EQ(5, values["shard_hist.hist.p5"]);
+    EXPECT_EQ(50, values["shard_hist.hist.p50"]);
+    EXPECT_EQ(75, values["shard_hist.hist.p75"]);
+    EXPECT_EQ(95, values["shard_hist.hist.p95"]);
+  }
+}
+
 TEST(ServiceDataTest, Histogram) {
   auto hist = ServiceData::createHistogram(
     "foo", 1, 0, 100,
@@ -115,6 +115,102 @@ TEST(SQLiteWrapperTest, MoveConstructor) {
   }
 }
 
+TEST(SQLiteWrapperTest, PreparedStatementCache) {
+  SQLite db = SQLite::connect(":memory:");
+
+  SQLiteTxn txn = db.begin();
+  txn.exec("CREATE TABLE foo (bar)");
+
+  SQLiteStmt& insertStmt = db.prepareCached("INSERT INTO foo VALUES (@v)");
+  SQLiteStmt& insertStmt2 = db.prepareCached("INSERT INTO foo VALUES (@v)");
+  EXPECT_EQ(&insertStmt, &insertStmt2);
+
+  for (auto i = 0; i < 10; i++) {
+    SQLiteQuery query = txn.query(insertStmt);
+
+    query.bindInt("@v", i);
+    query.step();
+  }
+
+  SQLiteQuery query = txn.query(db.prepareCached("SELECT bar FROM foo"));
+  for (auto i = 0; i < 10; i++) {
+    ASSERT_FALSE(query.done());
+    query.step();
+    ASSERT_TRUE(query.row());
+    EXPECT_EQ(query.getInt(0), i);
+  }
+}
+
+TEST(SQLiteWrapperTest, InsertMany) {
+  SQLite db = SQLite::connect(":memory:");
+
+  // 600 rows of 2 columns: one full 499-row chunk, then single-row
+  // statements for the remainder.
+  std::vector<std::vector<SQLite::Value>> rows;
+  for (int64_t i = 0; i < 600; i++) {
+    rows.push_back({i, "value" + std::to_string(i)});
+  }
+  rows[42][1] = nullptr;
+
+  {
+    SQLiteTxn txn = db.begin();
+    txn.exec("CREATE TABLE foo (bar, baz)");
+    db.insertMany("INSERT INTO foo (bar, baz)", 2, rows);
+    txn.commit();
+  }
+
+  SQLiteTxn txn = db.begin();
+  SQLiteStmt selectStmt = db.prepare("SELECT bar, baz FROM foo ORDER BY bar");
+  SQLiteQuery query = txn.query(selectStmt);
+  for (int64_t i = 0; i < 600; i++) {
+    ASSERT_FALSE(query.done());
+    query.step();
+    ASSERT_TRUE(query.row());
+    EXPECT_EQ(query.getInt64(0), i);
+    if (i == 42) {
+      EXPECT_FALSE(query.getNullableString(1).has_value());
+    } else {
+      EXPECT_EQ(query.getString(1), "value" + std::to_string(i));
+    }
+  }
+  query.step();
+  EXPECT_TRUE(query.done());
+}
+
+TEST(SQLiteWrapperTest, WalCheckpoint) {
+  folly::test::TemporaryDirectory m_tmpdir{"sqlite-wrapper-wal"};
+  auto dbPath = m_tmpdir.path() / "db.sql3";
+
+  SQLite db = SQLite::connect(dbPath.native());
+  db.setJournalMode(SQLite::JournalMode::WAL);
+  db.setWalAutoCheckpoint(0);
+
+  {
+    SQLiteTxn txn = db.begin();
+    txn.exec("CREATE TABLE foo (bar)");
+    SQLiteStmt insertStmt = db.prepare("INSERT INTO foo VALUES (@v)");
+    for (auto i = 0; i < 10; i++) {
+      SQLiteQuery query = txn.query(insertStmt);
+
+      query.bindInt("@v", i);
+      query.step();
+    }
+    txn.commit();
+  }
+
+  db.walCheckpoint(SQLite::CheckpointMode::TRUNCATE);
+
+  SQLiteTxn txn = db.begin();
+  SQLiteStmt selectStmt = db.prepare("SELECT bar FROM foo");
+  SQLiteQuery query = txn.query(selectStmt);
+  for (auto i = 0; i < 10; i++) {
+    ASSERT_FALSE(query.done());
+    query.step();
+    ASSERT_TRUE(query.row());
+    EXPECT_EQ(query.getInt(0), i);
+  }
+}
+
 TEST(SQLiteWrapperTest, ReadOnlyDB) {
   folly::test::TemporaryDirectory m_tmpdir{"sqlite-wrapper-readonly"};
   auto dbPath = m_tmpdir.path() / "db.sql3";
@@ -183,6 +183,23 @@ inline void memcpy16_inline(void* dst, const void* src, size_t len) {
 
 //////////////////////////////////////////////////////////////////////
 
+#if defined(__x86_64__)
+/*
+ * Out-of-line AVX-512BW variant of wordsame() for long buffers, defined in
+ * wordsame-avx512.cpp.  It is compiled with function-level target attributes
+ * so the rest of the tree keeps its baseline ISA; only call it when
+ * use_wordsame_avx512 is set.
+ */
+bool wordsame_avx512(const void* mem1, const void* mem2, uint32_t lenBytes);
+
+/*
+ * Set during static initialization if the host supports AVX-512F/BW.  It is
+ * zero before its initializer runs, so wordsame() calls that race with static
+ * initialization safely take the scalar path.
+ */
+extern const bool use_wordsame_avx512;
+#endif
+
 /*
  * Word at a time comparison for two strings of length `lenBytes'.  Returns
  * true if the regions are the same. This should be invoked only when we know
@@ -206,6 +223,14 @@ bool wordsame(const void* mem1, const void* mem2, uint32_t lenBytes) {
 // ASan is less precise than valgrind and believes this function overruns reads
 #if !FOLLY_SANITIZE
 
+#if defined(__x86_64__)
+  // Long compares go out of line to the AVX-512 kernel when the host has one;
+  // below 64 bytes the masked tail compare alone doesn't beat the word loop.
+  if (lenBytes >= 64 && use_wordsame_avx512) {
+    return wordsame_avx512(mem1, mem2, lenBytes);
+  }
+#endif
+
   // For speed, we count up towards 0 from -lenBytes * 8 in units of a word of
   // bits. When we reach a value >= 0, that is the number of bits we need to
   // ignore in the last compare. Since we're on a little-endian architecture,
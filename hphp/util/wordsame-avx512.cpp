@@ -0,0 +1,61 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010-present Facebook, Inc. (http://www.facebook.com)  |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+#include "hphp/util/word-mem.h"
+
+#if defined(__x86_64__)
+
+#include <immintrin.h>
+
+namespace HPHP {
+
+namespace {
+
+__attribute__((__target__("avx512f,avx512bw")))
+bool wordsame_avx512_impl(const void* mem1, const void* mem2,
+                          uint32_t lenBytes) {
+  auto p1 = static_cast<const char*>(mem1);
+  auto p2 = static_cast<const char*>(mem2);
+
+  while (lenBytes >= 64) {
+    auto const a = _mm512_loadu_si512(p1);
+    auto const b = _mm512_loadu_si512(p2);
+    if (_mm512_cmpneq_epi8_mask(a, b)) return false;
+    p1 += 64;
+    p2 += 64;
+    lenBytes -= 64;
+  }
+  if (lenBytes == 0) return true;
+
+  // Masked loads only touch the bytes selected by the mask, so the tail can
+  // be compared in one shot without reading past either buffer.
+  auto const mask = (uint64_t{1} << lenBytes) - 1;
+  auto const a = _mm512_maskz_loadu_epi8(mask, p1);
+  auto const b = _mm512_maskz_loadu_epi8(mask, p2);
+  return !_mm512_cmpneq_epi8_mask(a, b);
+}
+
+}
+
+bool wordsame_avx512(const void* mem1, const void* mem2, uint32_t lenBytes) {
+  return wordsame_avx512_impl(mem1, mem2, lenBytes);
+}
+
+const bool use_wordsame_avx512 =
+  __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+
+}
+
+#endif
@@ -47,8 +47,11 @@ void ZstdCompressor::zstd_cctx_deleter(ZSTD_CCtx* ctx) {
   throwIfZstdError(error, "Error freeing ZSTD_CCtx! ");
 }
 
-ZstdCompressor::ZstdCompressor(int compression_level, bool should_checksum, int window_log)
-    : compression_level_(compression_level), should_checksum_(should_checksum), window_log_(window_log) {
+ZstdCompressor::ZstdCompressor(int compression_level, bool should_checksum,
+                               int window_log,
+                               std::shared_ptr<const std::string> dictionary)
+    : compression_level_(compression_level), should_checksum_(should_checksum),
+      window_log_(window_log), dictionary_(std::move(dictionary)) {
 }
 
 void ZstdCompressor::setChecksum(bool should_checksum) {
@@ -95,6 +98,14 @@ StringHolder ZstdCompressor::compress(const void* data,
           ctx_.get(), ZSTD_c_windowLog, window_log_),
           "ZSTD_CCtx_setParameter() Setting window log failed! ");
     }
+    if (dictionary_ && !dictionary_->empty()) {
+      // Load (copy) rather than reference the dictionary: the context goes
+      // back to a shared pool, which must not keep pointers into memory the
+      // dictionary owner may release.
+      throwIfZstdError(ZSTD_CCtx_loadDictionary(
+          ctx_.get(), dictionary_->data(), dictionary_->size()),
+          "ZSTD_CCtx_loadDictionary() Loading dictionary failed! ");
+    }
   }
 
   ZSTD_inBuffer inBuf = {data, len, 0};
@@ -18,6 +18,7 @@
 
 #include <cstddef>
 #include <memory>
+#include <string>
 
 #include <zstd.h>
 
@@ -29,7 +30,13 @@ namespace HPHP {
 
 struct ZstdCompressor {
  public:
-  explicit ZstdCompressor(int compression_level, bool should_checksum = false, int window_log = 0);
+  // When a dictionary is supplied, each compression stream is primed with it
+  // (ZSTD_CCtx_loadDictionary); clients must decompress with the same
+  // dictionary.
+  explicit ZstdCompressor(int compression_level, bool should_checksum = false,
+                          int window_log = 0,
+                          std::shared_ptr<const std::string> dictionary =
+                            nullptr);
 
   StringHolder compress(const void* data, size_t& len, bool last);
 
@@ -57,6 +64,7 @@ struct ZstdCompressor {
   int compression_level_;
   bool should_checksum_;
   int window_log_;
+  std::shared_ptr<const std::string> dictionary_;
   ContextPool::Ref ctx_;
 };
 